@@ -46,6 +46,7 @@
 
 // utilities
 #include "Utilities/FileSystem/FileManager.h"
+#include "Utilities/FileSystem/VirtualFileSystem.h"
 #include "Utilities/Json/Json.h"
 #include "Utilities/Format/Format.h"
 
@@ -161,6 +162,11 @@ namespace MxEngine
     void Application::DrawObjects()
     {
         MAKE_SCOPE_PROFILER("Application::DrawObjects");
+        // upload streamed assets within frame budget, even if application is paused
+        AssetStreamer::OnUpdate();
+        // compact GPU heaps before render units capture mesh offsets
+        BufferAllocator::OnUpdate();
+
         this->GetRenderAdaptor().SetWindowSize({ this->GetWindow().GetWidth(), this->GetWindow().GetHeight() });
         this->GetRenderAdaptor().RenderFrame();
 
@@ -174,10 +180,7 @@ namespace MxEngine
 
     void Application::UpdateComponents()
     {
-        for (const auto& callback : this->updateCallbacks)
-        {
-            callback(this->timeDelta);
-        }
+        this->updateScheduler.Invoke(this->timeDelta);
     }
 
     void Application::InvokeUpdate()
@@ -211,8 +214,12 @@ namespace MxEngine
             {
                 MAKE_SCOPE_PROFILER("Application::UpdateComponents");
                 this->UpdateComponents();
+                RuntimeCompiler::InvokeScriptBatches(this->timeDelta);
             }
 
+            // invoke all expired timers
+            TimerScheduler::OnUpdate(this->timeDelta);
+
             // invoke update event
             UpdateEvent updateEvent(this->timeDelta);
             Event::Invoke(updateEvent);
@@ -227,12 +234,17 @@ namespace MxEngine
 
     void Application::InvokePhysics()
     {
+        auto& [currentCollisions, previousCollisions] = this->collisions;
+        currentCollisions.reserve(previousCollisions.size());
+
+        // objects moved by user are pushed to physics world, then simulated transforms of awake bodies are written back
+        RigidBody::SyncObjectStates();
         PhysicsModule::OnUpdate(this->timeDelta);
+        RigidBody::FetchActiveTransforms();
 
         // TODO: refactor, move collision logic to separate function
         MAKE_SCOPE_PROFILER("Physics::InvokeCollionsCallbacks()");
 
-        auto& [currentCollisions, previousCollisions] = this->collisions;
         std::sort(currentCollisions.begin(), currentCollisions.end());
         auto previousCollisionEntry = previousCollisions.begin();
 
@@ -275,8 +287,11 @@ namespace MxEngine
             previousCollisionEntry++;
         }
 
-        std::swap(currentCollisions, previousCollisions);
-        currentCollisions.clear();
+        // physics may not be updated next frame (i.e. if application is paused), so collisions are moved out of frame arena
+        previousCollisions.clear();
+        for (auto& collision : currentCollisions)
+            previousCollisions.push_back(std::move(collision));
+        FrameAllocator::Recycle(currentCollisions);
     }
 
     void Application::InvokeCreate()
@@ -322,6 +337,9 @@ namespace MxEngine
 
         this->InitializeConfig(this->config);
 
+        PhysicsModule::SetDeterministic(this->config.DeterministicPhysics);
+        PhysicsModule::SetWorldType(this->config.PhysicsWorld);
+
         this->GetWindow()
             .UseEventDispatcher(this->dispatcher)
             .UseCursorMode(this->config.Cursor)
@@ -373,6 +391,7 @@ namespace MxEngine
             while (this->GetWindow().IsOpen()) //-V807
             {
                 MAKE_SCOPE_PROFILER("Application::Frame()");
+                FrameAllocator::OnFrameBegin();
                 this->GetWindow().PullEvents();
                 this->UpdateTimeDelta(frameEnd, secondEnd, frameCount);
                 this->InvokeUpdate();
@@ -431,10 +450,15 @@ namespace MxEngine
 
     Application::ModuleManager::~ModuleManager()
     {
+        TimerScheduler::Destroy(); // timer callbacks may own objects, so they are destroyed before modules
         PhysicsModule::Destroy();
         GraphicModule::Destroy();
+        ThreadPool::Destroy();
         Factory<AudioBuffer>::Destroy(); // OpenAL is angry when buffers are not deleted
         AudioModule::Destroy();
+        FileManager::Destroy(); // closes project file watcher
+        VirtualFileSystem::Destroy(); // packs are unmapped after all loading threads are stopped
+        FrameAllocator::Destroy();
 
         #if defined(MXENGINE_PROFILING_ENABLED)
         Profiler::Finish();
@@ -450,7 +474,9 @@ namespace MxEngine
     void Application::DestroyRenderAdaptor(RenderAdaptor& adaptor)
     {
         adaptor = RenderAdaptor{ };
+        AssetStreamer::Destroy(); // streamed meshes hold buffer allocations
         BufferAllocator::Destroy();
+        SubmissionQueue::Destroy();
     }
 
     void Application::InitializeShaderDebug()
@@ -536,9 +562,8 @@ namespace MxEngine
             SaveJson(file, jsonConfig);
         }
         MXLOG_INFO("MxEngine::Application", "loading application config from " + ToMxString(configPath));
-        file.Open(configPath, File::READ);
-        jsonConfig = LoadJson(file);
         file.Close();
+        jsonConfig = LoadJson(MappedFile(configPath));
 
         if (!jsonConfig.empty())
         {
@@ -549,6 +574,8 @@ namespace MxEngine
             MXLOG_ERROR("MxEngine::Application", "config was not loaded properly: " + ToMxString(configPath));
         }
 
+        for (const auto& packFile : config.PackFiles)
+            VirtualFileSystem::Mount(FileManager::GetWorkingDirectory() / ToFilePath(packFile));
         FileManager::InitializeRootDirectory(FileManager::GetWorkingDirectory());
 
         #if defined(MXENGINE_SHIPPING)
@@ -590,6 +617,13 @@ namespace MxEngine
                     }
                 });
         }
+        else
+        {
+            // keep file table in sync with files which are created or removed while application is running
+            FileManager::WatchRootDirectory();
+            this->GetEventDispatcher().AddEventListener<FpsUpdateEvent>("FileManager",
+                [](auto&) { FileManager::ProcessFileChanges(); });
+        }
 
         // initialize editor and component update callbacks
         auto& editor = this->GetRuntimeEditor();
@@ -36,6 +36,9 @@
 #include "Core/Config/Config.h"
 #include "Utilities/Profiler/Profiler.h"
 #include "Platform/Window/Window.h"
+#include "Core/Application/ComponentUpdateScheduler.h"
+#include "Utilities/Memory/FrameAllocator.h"
+#include <rttr/type>
 
 GENERATE_METHOD_CHECK(OnUpdate, OnUpdate(float()));
 
@@ -51,16 +54,16 @@ namespace MxEngine
             ~ModuleManager();
         } manager;
 
-        using UpdateCallbackList = MxVector<void(*)(TimeStep)>;
-        using CollisionList = MxVector<std::pair<MxObject::Handle, MxObject::Handle>>;
-        using CollisionSwapPair = std::pair<CollisionList, CollisionList>;
+        using CollisionPair = std::pair<MxObject::Handle, MxObject::Handle>;
+        // collisions of current physics update are transient and live in frame arena, previous ones are kept until the next update
+        using CollisionSwapPair = std::pair<FrameVector<CollisionPair>, MxVector<CollisionPair>>;
     private:
         static inline Application* Current = nullptr;
         UniqueRef<Window> window;
         RenderAdaptor renderAdaptor;
         EventDispatcherImpl<EventBase>* dispatcher;
         RuntimeEditor* editor;
-        UpdateCallbackList updateCallbacks;
+        ComponentUpdateScheduler updateScheduler;
         CollisionSwapPair collisions;
         Config config;
         TimeStep timeDelta = 0.0f;
@@ -128,15 +131,7 @@ namespace MxEngine
     {
         if constexpr (has_method_OnUpdate<T>::value)
         {
-            this->updateCallbacks.push_back([](TimeStep dt)
-            {
-                MAKE_SCOPE_PROFILER(typeid(T).name());
-                auto view = ComponentFactory::GetView<T>();
-                for (auto& component : view)
-                {
-                    component.OnUpdate(dt);
-                }
-            });
+            this->updateScheduler.RegisterUpdate<T>(rttr::type::get<T>());
         }
     }
 
@@ -0,0 +1,181 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "ComponentUpdateScheduler.h"
+#include "Core/Runtime/Reflection.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+
+namespace MxEngine
+{
+    static StringId GetComponentId(const rttr::type& type)
+    {
+        auto name = type.get_name();
+        return crc32(name.data(), name.size());
+    }
+
+    ComponentAccessSet ComponentUpdateScheduler::MakeAccessSet(const rttr::type& type)
+    {
+        ComponentAccessSet access;
+
+        rttr::variant reads = type.get_metadata(UpdateInfo::READS);
+        rttr::variant writes = type.get_metadata(UpdateInfo::WRITES);
+        rttr::variant parallel = type.get_metadata(UpdateInfo::PARALLEL);
+
+        access.IsDeclared = reads.is_valid() || writes.is_valid();
+        access.IsParallel = access.IsDeclared && parallel.is_valid() && parallel.to_bool();
+
+        if (reads.is_valid())
+        {
+            for (const auto& readType : reads.get_value<ComponentTypeList>())
+                access.Reads.push_back(GetComponentId(readType));
+        }
+        if (writes.is_valid())
+        {
+            for (const auto& writeType : writes.get_value<ComponentTypeList>())
+                access.Writes.push_back(GetComponentId(writeType));
+        }
+        return access;
+    }
+
+    bool ComponentUpdateScheduler::IsMainThreadOnly(const rttr::type& type)
+    {
+        rttr::variant mainThread = type.get_metadata(UpdateInfo::MAIN_THREAD);
+        return mainThread.is_valid() && mainThread.to_bool();
+    }
+
+    bool ComponentUpdateScheduler::IsConflicting(const ComponentAccessSet& first, const ComponentAccessSet& second)
+    {
+        // undeclared updates may touch anything, so they act as barriers
+        if (!first.IsDeclared || !second.IsDeclared) return true;
+
+        // transform is plain object data and can be read concurrently. Components are accessed through handles,
+        // which modify non-atomic reference counters on copy, so even two readers of the same component type must be ordered
+        constexpr StringId SharedReadable = STRING_ID("Transform");
+
+        auto isConflictingAccess = [&second](StringId id, bool isWrite)
+        {
+            if (!second.IsAccessing(id)) return false;
+            return id != SharedReadable || isWrite || second.IsWriting(id);
+        };
+
+        if (isConflictingAccess(first.Self, true)) return true;
+        for (StringId id : first.Writes)
+            if (isConflictingAccess(id, true)) return true;
+        for (StringId id : first.Reads)
+            if (isConflictingAccess(id, false)) return true;
+        return false;
+    }
+
+    void ComponentUpdateScheduler::BuildGraph()
+    {
+        MAKE_SCOPE_PROFILER("ComponentUpdateScheduler::BuildGraph()");
+
+        // each update is placed in the first stage after all conflicting updates registered before it
+        MxVector<size_t> entryStages(this->entries.size(), 0);
+        this->stages.clear();
+
+        for (size_t i = 0; i < this->entries.size(); i++)
+        {
+            size_t stage = 0;
+            for (size_t j = 0; j < i; j++)
+            {
+                if (IsConflicting(this->entries[i].Access, this->entries[j].Access))
+                    stage = std::max(stage, entryStages[j] + 1);
+            }
+            entryStages[i] = stage;
+
+            if (this->stages.size() <= stage)
+                this->stages.resize(stage + 1);
+            this->stages[stage].push_back(i);
+        }
+        this->isGraphDirty = false;
+
+        MXLOG_DEBUG("MxEngine::ComponentUpdateScheduler", 
+            MxFormat("built update graph of {0} components with {1} stages", this->entries.size(), this->stages.size()));
+    }
+
+    void ComponentUpdateScheduler::InvokeEntry(const ComponentUpdateEntry& entry, TimeStep dt)
+    {
+        if (!entry.Access.IsParallel)
+        {
+            ComponentAccess::Scope scope(entry.Access);
+            entry.Update(dt);
+            return;
+        }
+
+        MAKE_SCOPE_PROFILER(entry.Name);
+        ThreadPool::ParallelFor(entry.GetCapacity(), ParallelGrainSize, [&entry, dt](size_t begin, size_t end)
+        {
+            ComponentAccess::Scope scope(entry.Access);
+            entry.UpdateRange(dt, begin, end);
+        });
+    }
+
+    void ComponentUpdateScheduler::Invoke(TimeStep dt)
+    {
+        if (this->isGraphDirty) this->BuildGraph();
+
+        for (const auto& stage : this->stages)
+        {
+            // updates bound to main thread are invoked on calling thread, others are sent to worker threads.
+            // If stage has no such updates, its first update is invoked on calling thread instead
+            bool hasMainThreadUpdates = std::any_of(stage.begin(), stage.end(),
+                [this](size_t index) { return this->entries[index].IsMainThreadOnly; });
+            auto isInvokedOnCallingThread = [this, &stage, hasMainThreadUpdates](size_t i)
+            {
+                return hasMainThreadUpdates ? this->entries[stage[i]].IsMainThreadOnly : i == 0;
+            };
+
+            ScratchArray<std::future<void>> tasks(stage.size());
+            size_t taskCount = 0;
+            for (size_t i = 0; i < stage.size(); i++)
+            {
+                if (isInvokedOnCallingThread(i)) continue;
+                const auto& entry = this->entries[stage[i]];
+                tasks[taskCount++] = ThreadPool::Submit([this, &entry, dt]() { this->InvokeEntry(entry, dt); });
+            }
+            for (size_t i = 0; i < stage.size(); i++)
+            {
+                if (isInvokedOnCallingThread(i))
+                    this->InvokeEntry(this->entries[stage[i]], dt);
+            }
+
+            for (size_t i = 0; i < taskCount; i++)
+                ThreadPool::Wait(tasks[i]);
+        }
+    }
+
+    size_t ComponentUpdateScheduler::GetStageCount()
+    {
+        if (this->isGraphDirty) this->BuildGraph();
+        return this->stages.size();
+    }
+}
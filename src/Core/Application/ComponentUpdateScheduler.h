@@ -0,0 +1,119 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Utilities/ECS/ComponentFactory.h"
+#include "Utilities/Time/Time.h"
+#include "Utilities/Profiler/Profiler.h"
+
+namespace rttr { class type; }
+
+namespace MxEngine
+{
+    /*!
+    single per-type component update registered in scheduler. Parallel components are also updated by pool index ranges
+    */
+    struct ComponentUpdateEntry
+    {
+        using UpdateCallback = void(*)(TimeStep);
+        using RangeUpdateCallback = void(*)(TimeStep, size_t, size_t);
+        using CapacityCallback = size_t(*)();
+
+        const char* Name = nullptr;
+        UpdateCallback Update = nullptr;
+        RangeUpdateCallback UpdateRange = nullptr;
+        CapacityCallback GetCapacity = nullptr;
+        ComponentAccessSet Access;
+        bool IsMainThreadOnly = false;
+    };
+
+    /*!
+    component update scheduler builds dependency graph of registered component updates using their declared read/write sets.
+    Updates are split into stages: updates inside one stage do not conflict with each other and are executed concurrently,
+    stages themselves are executed in order, so updates which conflict are always invoked in registration order.
+    Updates marked with UpdateInfo::MAIN_THREAD are always invoked on the thread which calls Invoke
+    */
+    class ComponentUpdateScheduler
+    {
+        using Stage = MxVector<size_t>;
+
+        MxVector<ComponentUpdateEntry> entries;
+        MxVector<Stage> stages;
+        bool isGraphDirty = false;
+
+        static ComponentAccessSet MakeAccessSet(const rttr::type& type);
+        static bool IsMainThreadOnly(const rttr::type& type);
+        static bool IsConflicting(const ComponentAccessSet& first, const ComponentAccessSet& second);
+        void BuildGraph();
+        void InvokeEntry(const ComponentUpdateEntry& entry, TimeStep dt);
+    public:
+        // minimal number of components processed by a single parallel task
+        constexpr static size_t ParallelGrainSize = 1024;
+
+        template<typename T>
+        void RegisterUpdate(const rttr::type& type);
+
+        void Invoke(TimeStep dt);
+        size_t GetStageCount();
+    };
+
+    template<typename T>
+    inline void ComponentUpdateScheduler::RegisterUpdate(const rttr::type& type)
+    {
+        ComponentUpdateEntry entry;
+        entry.Name = typeid(T).name();
+        entry.Access = MakeAccessSet(type);
+        entry.Access.Self = T::ComponentId;
+        entry.IsMainThreadOnly = IsMainThreadOnly(type);
+        entry.Access.IsParallel = entry.Access.IsParallel && !entry.IsMainThreadOnly;
+        entry.Update = [](TimeStep dt)
+        {
+            MAKE_SCOPE_PROFILER(typeid(T).name());
+            auto view = ComponentFactory::GetView<T>();
+            for (auto& component : view)
+            {
+                component.OnUpdate(dt);
+            }
+        };
+        entry.UpdateRange = [](TimeStep dt, size_t begin, size_t end)
+        {
+            auto& pool = ComponentFactory::GetPool<T>();
+            for (size_t i = begin; i < end; i++)
+            {
+                if (pool.IsAllocated(i))
+                    pool[i].value.OnUpdate(dt);
+            }
+        };
+        entry.GetCapacity = []() { return ComponentFactory::GetPool<T>().Capacity(); };
+
+        this->entries.push_back(std::move(entry));
+        this->isGraphDirty = true;
+    }
+}
@@ -33,25 +33,35 @@
 #include "Core/MxObject/MxObject.h"
 #include "Core/Resources/AssetManager.h"
 #include "Core/Resources/BufferAllocator.h"
+#include "Core/Rendering/RenderGraph/SubmissionQueue.h"
+#include "Core/Resources/AssetStreamer.h"
 #include "Core/Runtime/RuntimeCompiler.h"
 #include "Core/Serialization/SceneSerializer.h"
 #include "Utilities/FileSystem/FileManager.h"
+#include "Utilities/FileSystem/VirtualFileSystem.h"
 #include "Platform/Modules/PhysicsModule.h"
 #include "Platform/Modules/GraphicModule.h"
 #include "Platform/Modules/AudioModule.h"
 #include "Platform/PhysicsAPI.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/Memory/FrameAllocator.h"
+#include "Core/Application/TimerScheduler.h"
 
 namespace MxEngine
 {
     using GlobalContextSerializer = StaticSerializer<
         Application,
         Logger,
+        ThreadPool,
+        FrameAllocator,
         FileManager,
+        VirtualFileSystem,
         AudioModule,
         GraphicModule,
         PhysicsModule,
         UUIDGenerator,
         ComponentFactory,
+        TimerScheduler,
         Factory<Material>,
         Factory<Mesh>,
         Factory<Buffer>,
@@ -67,6 +77,8 @@ namespace MxEngine
         Factory<MxObject>,
         RuntimeCompiler,
         SceneSerializer,
-        BufferAllocator
+        SubmissionQueue,
+        BufferAllocator,
+        AssetStreamer
     >;
 }
\ No newline at end of file
@@ -28,11 +28,21 @@
 
 #include "Physics.h"
 #include "Core/MxObject/MxObject.h"
+#include "Core/Components/Physics/RigidBody.h"
 #include "Utilities/Logging/Logger.h"
 #include "Platform/Modules/PhysicsModule.h"
 #include "Platform/Bullet3/Bullet3Utils.h"
 #include "Utilities/Profiler/Profiler.h"
 #include "Core/Application/Application.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Core/Macro/Macro.h"
+
+#include <algorithm>
+
+#include <BulletCollision/NarrowPhaseCollision/btGjkPairDetector.h>
+#include <BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h>
+#include <BulletCollision/NarrowPhaseCollision/btGjkEpaPenetrationDepthSolver.h>
+#include <BulletCollision/NarrowPhaseCollision/btPointCollector.h>
 
 namespace MxEngine
 {
@@ -81,6 +91,153 @@ namespace MxEngine
         }
     };
 
+    // rays which are traversed through broadphase tree together. Node is visited if any ray of packet intersects it
+    constexpr size_t RayPacketSize = 8;
+    // number of ray packets or shape queries processed by one worker task
+    constexpr size_t QueryBatchGrainSize = 16;
+
+    struct PacketRayCastCallback : public CustomRayCastCallback
+    {
+        btVector3 InverseDirection;
+
+        PacketRayCastCallback(const btVector3& from, const btVector3& to, CollisionMask::Mask rayCastMask)
+            : CustomRayCastCallback(from, to, rayCastMask)
+        {
+            btVector3 direction = to - from;
+            // zero direction components are replaced with big value, as in btCollisionWorld::rayTest
+            this->InverseDirection.setX(direction.x() == 0.0f ? btScalar(BT_LARGE_FLOAT) : 1.0f / direction.x());
+            this->InverseDirection.setY(direction.y() == 0.0f ? btScalar(BT_LARGE_FLOAT) : 1.0f / direction.y());
+            this->InverseDirection.setZ(direction.z() == 0.0f ? btScalar(BT_LARGE_FLOAT) : 1.0f / direction.z());
+        }
+
+        bool Intersects(const btDbvtVolume& volume) const
+        {
+            btVector3 t1 = (volume.Mins() - this->m_rayFromWorld) * this->InverseDirection;
+            btVector3 t2 = (volume.Maxs() - this->m_rayFromWorld) * this->InverseDirection;
+            btVector3 tmin = t1; tmin.setMin(t2);
+            btVector3 tmax = t1; tmax.setMax(t2);
+
+            // ray is clipped by its closest hit, so nodes behind it are skipped
+            float enter = Max(tmin.x(), tmin.y(), tmin.z());
+            float exit = Min(tmax.x(), Min(tmax.y(), tmax.z()));
+            return exit >= Max(enter, 0.0f) && enter <= this->m_closestHitFraction;
+        }
+    };
+
+    static void RayCastPacket(const btDbvtNode* root, MxVector<PacketRayCastCallback>& packet, MxVector<const btDbvtNode*>& stack)
+    {
+        if (root == nullptr) return;
+
+        stack.clear();
+        stack.push_back(root);
+        while (!stack.empty())
+        {
+            const btDbvtNode* node = stack.back();
+            stack.pop_back();
+
+            bool isVisited = std::any_of(packet.begin(), packet.end(), [node](const auto& ray) { return ray.Intersects(node->volume); });
+            if (!isVisited) continue;
+
+            if (node->isinternal())
+            {
+                stack.push_back(node->childs[0]);
+                stack.push_back(node->childs[1]);
+                continue;
+            }
+
+            auto proxy = static_cast<btBroadphaseProxy*>(node->data);
+            auto collisionObject = static_cast<btCollisionObject*>(proxy->m_clientObject);
+            for (auto& ray : packet)
+            {
+                if (!ray.needsCollision(proxy) || !ray.Intersects(node->volume)) continue;
+
+                btTransform rayFrom, rayTo;
+                rayFrom.setIdentity();
+                rayFrom.setOrigin(ray.m_rayFromWorld);
+                rayTo.setIdentity();
+                rayTo.setOrigin(ray.m_rayToWorld);
+                btCollisionWorld::rayTestSingle(rayFrom, rayTo, collisionObject, collisionObject->getCollisionShape(), collisionObject->getWorldTransform(), ray);
+            }
+        }
+    }
+
+    template<typename F>
+    static void TraverseBroadphaseAABB(const btDbvtNode* root, const btDbvtVolume& volume, MxVector<const btDbvtNode*>& stack, F&& func)
+    {
+        if (root == nullptr) return;
+
+        stack.clear();
+        stack.push_back(root);
+        while (!stack.empty())
+        {
+            const btDbvtNode* node = stack.back();
+            stack.pop_back();
+
+            if (!Intersect(node->volume, volume)) continue;
+
+            if (node->isinternal())
+            {
+                stack.push_back(node->childs[0]);
+                stack.push_back(node->childs[1]);
+            }
+            else
+            {
+                func(static_cast<btBroadphaseProxy*>(node->data));
+            }
+        }
+    }
+
+    static bool IsShapeOverlapping(const btConvexShape* queryShape, const btTransform& queryTransform, const btCollisionShape* shape, const btTransform& transform)
+    {
+        if (shape->isCompound())
+        {
+            auto compound = static_cast<const btCompoundShape*>(shape);
+            for (int i = 0; i < compound->getNumChildShapes(); i++)
+            {
+                if (IsShapeOverlapping(queryShape, queryTransform, compound->getChildShape(i), transform * compound->getChildTransform(i)))
+                    return true;
+            }
+            return false;
+        }
+        // only convex shapes are tested precisely, others are considered overlapping if their bounding boxes do
+        if (!shape->isConvex()) return true;
+
+        btVoronoiSimplexSolver simplexSolver;
+        btGjkEpaPenetrationDepthSolver penetrationSolver;
+        btGjkPairDetector detector(queryShape, static_cast<const btConvexShape*>(shape), &simplexSolver, &penetrationSolver);
+
+        btGjkPairDetector::ClosestPointInput input;
+        input.m_transformA = queryTransform;
+        input.m_transformB = transform;
+
+        btPointCollector output;
+        detector.getClosestPoints(input, output, nullptr);
+        return output.m_hasResult && output.m_distance <= 0.0f;
+    }
+
+    static void OverlapShapeQuery(const btConvexShape& queryShape, const btTransform& queryTransform, CollisionMask::Mask queryMask,
+        MxVector<MxObject::Handle>& overlaps, MxVector<const btDbvtNode*>& stack)
+    {
+        btVector3 aabbMin, aabbMax;
+        queryShape.getAabb(queryTransform, aabbMin, aabbMax);
+        auto volume = btDbvtVolume::FromMM(aabbMin, aabbMax);
+
+        auto broadphase = static_cast<btDbvtBroadphase*>(WORLD->getBroadphase());
+        overlaps.clear();
+        for (const auto& tree : broadphase->m_sets)
+        {
+            TraverseBroadphaseAABB(tree.m_root, volume, stack, [&](btBroadphaseProxy* proxy)
+            {
+                if ((proxy->m_collisionFilterGroup & queryMask) == 0 || (CollisionGroup::ALL & proxy->m_collisionFilterMask) == 0)
+                    return;
+
+                auto collisionObject = static_cast<const btCollisionObject*>(proxy->m_clientObject);
+                if (IsShapeOverlapping(&queryShape, queryTransform, collisionObject->getCollisionShape(), collisionObject->getWorldTransform()))
+                    overlaps.push_back(Physics::GetRigidBodyParent(collisionObject));
+            });
+        }
+    }
+
     void Physics::AddRigidBody(void* body) //-V813
     {
         WORLD->addRigidBody((btRigidBody*)body);
@@ -143,6 +300,104 @@ namespace MxEngine
         return callback.GetResult();
     }
 
+    void Physics::RayCastBatch(ArrayView<Ray> rays, ArrayView<RayHit> hits)
+    {
+        Physics::RayCastBatch(rays, hits, CollisionMask::RAYCAST_ONLY);
+    }
+
+    void Physics::RayCastBatch(ArrayView<Ray> rays, ArrayView<RayHit> hits, CollisionMask::Mask rayCastMask)
+    {
+        MAKE_SCOPE_PROFILER("Physics::RayCastBatch()");
+        MX_ASSERT(rays.size() == hits.size());
+
+        auto broadphase = static_cast<btDbvtBroadphase*>(WORLD->getBroadphase());
+        size_t packetCount = (rays.size() + RayPacketSize - 1) / RayPacketSize;
+        ThreadPool::ParallelFor(packetCount, QueryBatchGrainSize, [&](size_t begin, size_t end)
+        {
+            MxVector<PacketRayCastCallback> packet;
+            MxVector<const btDbvtNode*> stack;
+            packet.reserve(RayPacketSize);
+
+            for (size_t i = begin; i < end; i++)
+            {
+                size_t firstRay = i * RayPacketSize;
+                size_t lastRay = Min(firstRay + RayPacketSize, rays.size());
+
+                packet.clear();
+                for (size_t j = firstRay; j < lastRay; j++)
+                    packet.emplace_back(ToBulletVector3(rays[j].From), ToBulletVector3(rays[j].To), rayCastMask);
+
+                // static and dynamic objects are stored in separate trees
+                for (const auto& tree : broadphase->m_sets)
+                    RayCastPacket(tree.m_root, packet, stack);
+
+                for (size_t j = firstRay; j < lastRay; j++)
+                {
+                    const auto& ray = packet[j - firstRay];
+                    auto& hit = hits[j];
+                    hit.Object = ray.GetResult();
+                    hit.Fraction = ray.GetRayFraction();
+                    hit.Position = ray.hasHit() ? FromBulletVector3(ray.m_hitPointWorld) : rays[j].To;
+                    hit.Normal = ray.hasHit() ? FromBulletVector3(ray.m_hitNormalWorld) : MakeVector3(0.0f);
+                }
+            }
+        });
+    }
+
+    void Physics::OverlapSphereBatch(ArrayView<BoundingSphere> spheres, ArrayView<MxVector<MxObject::Handle>> overlaps)
+    {
+        Physics::OverlapSphereBatch(spheres, overlaps, CollisionMask::RAYCAST_ONLY);
+    }
+
+    void Physics::OverlapSphereBatch(ArrayView<BoundingSphere> spheres, ArrayView<MxVector<MxObject::Handle>> overlaps, CollisionMask::Mask queryMask)
+    {
+        MAKE_SCOPE_PROFILER("Physics::OverlapSphereBatch()");
+        MX_ASSERT(spheres.size() == overlaps.size());
+
+        ThreadPool::ParallelFor(spheres.size(), QueryBatchGrainSize, [&](size_t begin, size_t end)
+        {
+            MxVector<const btDbvtNode*> stack;
+            for (size_t i = begin; i < end; i++)
+            {
+                btSphereShape shape(spheres[i].Radius);
+                btTransform transform;
+                transform.setIdentity();
+                transform.setOrigin(ToBulletVector3(spheres[i].Center));
+
+                OverlapShapeQuery(shape, transform, queryMask, overlaps[i], stack);
+            }
+        });
+    }
+
+    void Physics::OverlapBoxBatch(ArrayView<BoundingBox> boxes, ArrayView<MxVector<MxObject::Handle>> overlaps)
+    {
+        Physics::OverlapBoxBatch(boxes, overlaps, CollisionMask::RAYCAST_ONLY);
+    }
+
+    void Physics::OverlapBoxBatch(ArrayView<BoundingBox> boxes, ArrayView<MxVector<MxObject::Handle>> overlaps, CollisionMask::Mask queryMask)
+    {
+        MAKE_SCOPE_PROFILER("Physics::OverlapBoxBatch()");
+        MX_ASSERT(boxes.size() == overlaps.size());
+
+        ThreadPool::ParallelFor(boxes.size(), QueryBatchGrainSize, [&](size_t begin, size_t end)
+        {
+            MxVector<const btDbvtNode*> stack;
+            for (size_t i = begin; i < end; i++)
+            {
+                const auto& box = boxes[i];
+                btBoxShape shape(ToBulletVector3(box.Length() * 0.5f));
+
+                // box min and max may be not symmetric around its center
+                btTransform transform;
+                transform.setIdentity();
+                transform.setRotation(btQuaternion(box.Rotation.x, box.Rotation.y, box.Rotation.z, box.Rotation.w));
+                transform.setOrigin(ToBulletVector3(box.Center + box.Rotation * ((box.Min + box.Max) * 0.5f)));
+
+                OverlapShapeQuery(shape, transform, queryMask, overlaps[i], stack);
+            }
+        });
+    }
+
     Vector3 Physics::GetGravity()
     {
         return FromBulletVector3(WORLD->getGravity());
@@ -156,7 +411,9 @@ namespace MxEngine
     void Physics::PerformExtraSimulationStep(float timeDelta)
     {
         MAKE_SCOPE_PROFILER("Physics::SimulationStep()");
+        RigidBody::SyncObjectStates();
         PhysicsModule::PerformSimulationStep(timeDelta);
+        RigidBody::FetchActiveTransforms();
     }
 
     void Physics::SetSimulationStep(float timeDelta)
@@ -168,4 +425,14 @@ namespace MxEngine
     {
         return PhysicsModule::GetSimulationStep();
     }
+
+    void Physics::SetSimulationThreadCount(size_t count)
+    {
+        PhysicsModule::SetThreadCount(count);
+    }
+
+    size_t Physics::GetSimulationThreadCount()
+    {
+        return PhysicsModule::GetThreadCount();
+    }
 }
\ No newline at end of file
@@ -29,10 +29,33 @@
 #pragma once
 
 #include "Core/MxObject/MxObject.h"
+#include "Core/BoundingObjects/BoundingBox.h"
+#include "Core/BoundingObjects/BoundingSphere.h"
 #include "Platform/PhysicsAPI.h"
+#include "Utilities/Array/ArrayView.h"
 
 namespace MxEngine
 {
+    struct Ray
+    {
+        Vector3 From;
+        Vector3 To;
+    };
+
+    struct RayHit
+    {
+        /*!
+        closest object hit by ray or invalid handle if ray hit nothing
+        */
+        MxObject::Handle Object;
+        Vector3 Position;
+        Vector3 Normal;
+        /*!
+        distance to hit point relative to ray length, equals 1 if ray hit nothing
+        */
+        float Fraction;
+    };
+
     class Physics
     {
     public:
@@ -46,11 +69,34 @@ namespace MxEngine
         static MxObject::Handle RayCast(const Vector3& from, const Vector3& to);
         static MxObject::Handle RayCast(const Vector3& from, const Vector3& to, float& rayFraction);
         static MxObject::Handle RayCast(const Vector3& from, const Vector3& to, float& rayFraction, CollisionMask::Mask rayCastMask);
+        /*!
+        casts many rays at once, distributing them across worker threads. Rays are traversed in packets, so coherent rays should be placed next to each other
+        \param rays rays to cast
+        \param hits closest hit of each ray. Must be the same size as rays
+        */
+        static void RayCastBatch(ArrayView<Ray> rays, ArrayView<RayHit> hits);
+        static void RayCastBatch(ArrayView<Ray> rays, ArrayView<RayHit> hits, CollisionMask::Mask rayCastMask);
+        /*!
+        finds all objects overlapping each sphere, distributing queries across worker threads
+        \param spheres spheres in world space
+        \param overlaps objects overlapping each sphere. Must be the same size as spheres
+        */
+        static void OverlapSphereBatch(ArrayView<BoundingSphere> spheres, ArrayView<MxVector<MxObject::Handle>> overlaps);
+        static void OverlapSphereBatch(ArrayView<BoundingSphere> spheres, ArrayView<MxVector<MxObject::Handle>> overlaps, CollisionMask::Mask queryMask);
+        /*!
+        finds all objects overlapping each oriented box, distributing queries across worker threads
+        \param boxes boxes in world space
+        \param overlaps objects overlapping each box. Must be the same size as boxes
+        */
+        static void OverlapBoxBatch(ArrayView<BoundingBox> boxes, ArrayView<MxVector<MxObject::Handle>> overlaps);
+        static void OverlapBoxBatch(ArrayView<BoundingBox> boxes, ArrayView<MxVector<MxObject::Handle>> overlaps, CollisionMask::Mask queryMask);
         static Vector3 GetGravity();
 
         static void SetGravity(const Vector3& gravity);
         static void PerformExtraSimulationStep(float timeDelta);
         static void SetSimulationStep(float timeDelta);
         static float GetSimulationStep();
+        static void SetSimulationThreadCount(size_t count);
+        static size_t GetSimulationThreadCount();
     };
 }
\ No newline at end of file
@@ -29,6 +29,7 @@
 #include "Scene.h"
 #include "Utilities/FileSystem/FileManager.h"
 #include "Core/Serialization/SceneSerializer.h"
+#include "Core/Resources/BufferAllocator.h"
 
 namespace MxEngine
 {
@@ -51,14 +52,18 @@ namespace MxEngine
     void Scene::Load(StringId hash)
     {
         auto filepath = FileManager::GetFilePath(hash);
-        File f(filepath);
+        MappedFile f(filepath);
         if (!f.IsOpen())
         {
             MXLOG_ERROR("MxEngine::Scene", "cannot open scene file: " + ToMxString(filepath));
             return;
         }
         JsonFile json = LoadJson(f);
+
+        // all buffer relocations caused by scene objects are submitted once after scene is loaded
+        BufferAllocator::BeginLoadBatch();
         SceneSerializer::Deserialize(json);
+        BufferAllocator::EndLoadBatch();
     }
 
     void Scene::Save(const FilePath& filepath)
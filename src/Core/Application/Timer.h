@@ -28,8 +28,7 @@
 
 #pragma once
 
-#include "Core/Components/Behaviour.h"
-#include "Core/MxObject/MxObject.h"
+#include "Core/Application/TimerScheduler.h"
 
 namespace MxEngine
 {
@@ -37,55 +36,54 @@ namespace MxEngine
     {
     public:
         template<typename F>
-        static MxObject::Handle Schedule(F&& func, TimerMode mode = TimerMode::UPDATE_EACH_FRAME, float timeInSeconds = 0.0f)
+        static TimerHandle Schedule(F&& func, TimerMode mode = TimerMode::UPDATE_EACH_FRAME, float timeInSeconds = 0.0f)
         {
-            auto object = MxObject::Create();
-            object->IsSerialized = false;
-            object->IsDisplayedInEditor = false;
-            object->Name = "__Timer";
-            auto behaviour = object->AddComponent<Behaviour>(
-            [callback = std::forward<F>(func)](MxObject& self, float dt) mutable
-            {
-                callback();
-                // destroy object if timer was set to single update mode
-                auto& behaviour = *self.GetComponent<Behaviour>();
-                bool shouldDestroy = (behaviour.GetTimerMode() == TimerMode::UPDATE_AFTER_DELTA) &&
-                                     (behaviour.GetTimeLeft() <= 0.0f);
-
-                if(shouldDestroy) MxObject::Destroy(self);
-            });
-            behaviour->Schedule(mode, timeInSeconds);
-            return object;
+            return TimerScheduler::Schedule(std::forward<F>(func), mode, timeInSeconds);
         }
 
         template<typename F>
-        static MxObject::Handle CallEachFrame(F&& func)
+        static TimerHandle CallEachFrame(F&& func)
         {
             return Timer::Schedule(std::forward<F>(func), TimerMode::UPDATE_EACH_FRAME);
         }
 
         template<typename F>
-        static MxObject::Handle CallEachDelta(F&& func, float delta)
+        static TimerHandle CallEachDelta(F&& func, float delta)
         {
             return Timer::Schedule(std::forward<F>(func), TimerMode::UPDATE_EACH_DELTA, delta);
         }
 
         template<typename F>
-        static MxObject::Handle CallAfterDelta(F&& func, float delta)
+        static TimerHandle CallAfterDelta(F&& func, float delta)
         {
             return Timer::Schedule(std::forward<F>(func), TimerMode::UPDATE_AFTER_DELTA, delta);
         }
 
         template<typename F>
-        static MxObject::Handle Repeat(F&& func, float duration)
+        static TimerHandle Repeat(F&& func, float duration)
         {
             return Timer::Schedule(std::forward<F>(func), TimerMode::UPDATE_FOR_N_SECONDS, duration);
         }
         
         template<typename F>
-        static MxObject::Handle RepeatAfterDelta(F&& func, float delta, float duration)
+        static TimerHandle RepeatAfterDelta(F&& func, float delta, float duration)
+        {
+            return Timer::CallAfterDelta([f = std::forward<F>(func), duration]() mutable { Timer::Repeat(std::move(f), duration); }, delta);
+        }
+
+        static void Cancel(TimerHandle timer)
+        {
+            TimerScheduler::Cancel(timer);
+        }
+
+        static bool IsScheduled(TimerHandle timer)
+        {
+            return TimerScheduler::IsScheduled(timer);
+        }
+
+        static float GetTimeLeft(TimerHandle timer)
         {
-            return Timer::CallAfterDelta([f = std::forward<F>(func), duration]() { Timer::Repeat(std::move(f), duration); }, delta);
+            return TimerScheduler::GetTimeLeft(timer);
         }
     };
 }
\ No newline at end of file
@@ -0,0 +1,232 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "TimerScheduler.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Math/Math.h"
+
+#include <algorithm>
+
+namespace MxEngine
+{
+    constexpr auto HeapComparator = [](const TimerSchedulerImpl::HeapEntry& e1, const TimerSchedulerImpl::HeapEntry& e2)
+    {
+        return e1.FireTime > e2.FireTime;
+    };
+
+    TimerSchedulerImpl::TimerSlot* TimerScheduler::GetSlot(TimerHandle handle)
+    {
+        if (!handle.IsValid() || handle.Index >= impl->slots.size()) return nullptr;
+        auto& slot = impl->slots[handle.Index];
+        return (slot.IsActive && slot.Generation == handle.Generation) ? &slot : nullptr;
+    }
+
+    void TimerScheduler::PushHeap(TimerSchedulerImpl::HeapEntry entry)
+    {
+        auto& heap = impl->heap;
+        // cancelled timers are removed from heap lazily. If there are too many of them, the heap is rebuilt
+        if (heap.size() > 2 * impl->activeCount + 64)
+        {
+            auto it = std::remove_if(heap.begin(), heap.end(), [](const auto& e) { return GetSlot({ e.Index, e.Generation }) == nullptr; });
+            heap.erase(it, heap.end());
+            std::make_heap(heap.begin(), heap.end(), HeapComparator);
+        }
+        heap.push_back(entry);
+        std::push_heap(heap.begin(), heap.end(), HeapComparator);
+    }
+
+    TimerSchedulerImpl::HeapEntry TimerScheduler::PopHeap()
+    {
+        auto& heap = impl->heap;
+        std::pop_heap(heap.begin(), heap.end(), HeapComparator);
+        auto entry = heap.back();
+        heap.pop_back();
+        return entry;
+    }
+
+    void TimerScheduler::Release(TimerHandle handle)
+    {
+        auto& slot = impl->slots[handle.Index];
+        slot.Func = { };
+        slot.IsActive = false;
+        slot.Generation++;
+        impl->freeSlots.push_back(handle.Index);
+        impl->activeCount--;
+    }
+
+    bool TimerScheduler::Invoke(TimerHandle handle)
+    {
+        auto* slot = GetSlot(handle);
+        if (slot == nullptr) return false;
+
+        // callback may schedule new timers, invalidating slot reference, or cancel itself
+        auto func = std::move(slot->Func);
+        func();
+
+        slot = GetSlot(handle);
+        if (slot == nullptr) return false;
+        slot->Func = std::move(func);
+        return true;
+    }
+
+    void TimerScheduler::OnUpdate(float dt)
+    {
+        MAKE_SCOPE_PROFILER("TimerScheduler::OnUpdate()");
+        impl->currentTime += (double)dt;
+        double currentTime = impl->currentTime;
+
+        // delayed timers: only expired ones are popped, so timers scheduled by callbacks are fired no earlier than next frame
+        auto& expired = impl->expired;
+        expired.clear();
+        while (!impl->heap.empty() && impl->heap.front().FireTime <= currentTime)
+        {
+            expired.push_back(PopHeap());
+        }
+
+        for (const auto& entry : expired)
+        {
+            TimerHandle handle{ entry.Index, entry.Generation };
+            if (!Invoke(handle)) continue;
+
+            auto& slot = impl->slots[handle.Index];
+            if (slot.Mode == TimerMode::UPDATE_EACH_DELTA)
+            {
+                slot.Deadline = currentTime + slot.Period;
+                PushHeap({ slot.Deadline, handle.Index, handle.Generation });
+            }
+            else
+            {
+                Release(handle);
+            }
+        }
+
+        // per-frame timers. Timers added by callbacks are appended to the end and kept as is
+        auto& frameTimers = impl->frameTimers;
+        size_t frameTimerCount = frameTimers.size();
+        size_t keptCount = 0;
+        for (size_t i = 0; i < frameTimerCount; i++)
+        {
+            TimerHandle handle = frameTimers[i];
+            auto* slot = GetSlot(handle);
+            if (slot == nullptr) continue;
+
+            if (slot->Mode == TimerMode::UPDATE_FOR_N_SECONDS && slot->Deadline <= currentTime)
+            {
+                Release(handle);
+                continue;
+            }
+
+            if (Invoke(handle))
+                frameTimers[keptCount++] = handle;
+        }
+        frameTimers.erase(frameTimers.begin() + keptCount, frameTimers.begin() + frameTimerCount);
+    }
+
+    TimerHandle TimerScheduler::Schedule(TimerSchedulerImpl::Callback callback, TimerMode mode, float timeInSeconds)
+    {
+        TimerHandle handle;
+        if (!impl->freeSlots.empty())
+        {
+            handle.Index = impl->freeSlots.back();
+            impl->freeSlots.pop_back();
+        }
+        else
+        {
+            handle.Index = (uint32_t)impl->slots.size();
+            impl->slots.emplace_back();
+        }
+
+        auto& slot = impl->slots[handle.Index];
+        handle.Generation = slot.Generation;
+        slot.Func = std::move(callback);
+        slot.Mode = mode;
+        slot.Period = Max(timeInSeconds, 0.0f);
+        slot.Deadline = impl->currentTime + slot.Period;
+        slot.IsActive = true;
+        impl->activeCount++;
+
+        switch (mode)
+        {
+        case TimerMode::UPDATE_EACH_DELTA:
+        case TimerMode::UPDATE_AFTER_DELTA:
+            PushHeap({ slot.Deadline, handle.Index, handle.Generation });
+            break;
+        case TimerMode::UPDATE_EACH_FRAME:
+        case TimerMode::UPDATE_FOR_N_SECONDS:
+        default:
+            impl->frameTimers.push_back(handle);
+            break;
+        }
+        return handle;
+    }
+
+    void TimerScheduler::Cancel(TimerHandle handle)
+    {
+        if (GetSlot(handle) != nullptr)
+            Release(handle);
+    }
+
+    bool TimerScheduler::IsScheduled(TimerHandle handle)
+    {
+        return GetSlot(handle) != nullptr;
+    }
+
+    float TimerScheduler::GetTimeLeft(TimerHandle handle)
+    {
+        auto* slot = GetSlot(handle);
+        if (slot == nullptr || slot->Mode == TimerMode::UPDATE_EACH_FRAME) return 0.0f;
+        return (float)Max(slot->Deadline - impl->currentTime, 0.0);
+    }
+
+    size_t TimerScheduler::GetScheduledCount()
+    {
+        return impl->activeCount;
+    }
+
+    void TimerScheduler::Init()
+    {
+        impl = Alloc<TimerSchedulerImpl>();
+    }
+
+    void TimerScheduler::Destroy()
+    {
+        Free(impl);
+        impl = nullptr;
+    }
+
+    TimerSchedulerImpl* TimerScheduler::GetImpl()
+    {
+        return impl;
+    }
+
+    void TimerScheduler::Clone(TimerSchedulerImpl* other)
+    {
+        impl = other;
+    }
+}
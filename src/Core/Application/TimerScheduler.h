@@ -0,0 +1,109 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Core/Components/Behaviour.h"
+#include "Utilities/STL/MxVector.h"
+#include "Utilities/STL/MxFunction.h"
+
+namespace MxEngine
+{
+    struct TimerHandle
+    {
+        constexpr static uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+        uint32_t Index = InvalidIndex;
+        uint32_t Generation = 0;
+
+        bool IsValid() const { return this->Index != InvalidIndex; }
+    };
+
+    struct TimerSchedulerImpl
+    {
+        using Callback = MxFunction<void()>;
+
+        struct TimerSlot
+        {
+            Callback Func;
+            float Period = 0.0f;
+            double Deadline = 0.0;
+            uint32_t Generation = 0;
+            TimerMode Mode = TimerMode::UPDATE_EACH_FRAME;
+            bool IsActive = false;
+        };
+
+        struct HeapEntry
+        {
+            double FireTime;
+            uint32_t Index;
+            uint32_t Generation;
+        };
+
+        MxVector<TimerSlot> slots;
+        MxVector<uint32_t> freeSlots;
+        // min-heap by fire time for UPDATE_EACH_DELTA and UPDATE_AFTER_DELTA timers
+        MxVector<HeapEntry> heap;
+        // timers which are invoked each frame: UPDATE_EACH_FRAME and UPDATE_FOR_N_SECONDS
+        MxVector<TimerHandle> frameTimers;
+        // scratch buffer, reused between frames
+        MxVector<HeapEntry> expired;
+        // accumulated in double, so deadlines do not lose precision in long sessions
+        double currentTime = 0.0;
+        size_t activeCount = 0;
+    };
+
+    /*!
+    timer scheduler stores all callbacks created by Timer class. Delayed timers are kept in min-heap ordered by fire time,
+    so each frame only expired timers are touched. Cancelled timers are removed from heap lazily when they reach its top
+    */
+    class TimerScheduler
+    {
+        inline static TimerSchedulerImpl* impl = nullptr;
+
+        static TimerSchedulerImpl::TimerSlot* GetSlot(TimerHandle handle);
+        static void PushHeap(TimerSchedulerImpl::HeapEntry entry);
+        static TimerSchedulerImpl::HeapEntry PopHeap();
+        static void Release(TimerHandle handle);
+        static bool Invoke(TimerHandle handle);
+    public:
+        static void Init();
+        static void Destroy();
+        static void OnUpdate(float dt);
+
+        static TimerHandle Schedule(TimerSchedulerImpl::Callback callback, TimerMode mode, float timeInSeconds);
+        static void Cancel(TimerHandle handle);
+        static bool IsScheduled(TimerHandle handle);
+        static float GetTimeLeft(TimerHandle handle);
+        static size_t GetScheduledCount();
+
+        static TimerSchedulerImpl* GetImpl();
+        static void Clone(TimerSchedulerImpl* other);
+    };
+}
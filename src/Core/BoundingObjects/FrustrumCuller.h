@@ -44,6 +44,7 @@ namespace MxEngine
 
         // http://iquilezles.org/www/articles/frustumcorrect/frustumcorrect.htm
         bool IsAABBVisible(const Vector3& minp, const Vector3& maxp) const;
+        bool IsSphereVisible(const Vector3& center, float radius) const;
 
     private:
         enum Planes
@@ -86,6 +87,10 @@ namespace MxEngine
         this->planes[NEAR]   = m[3] + m[2];
         this->planes[FAR]    = m[3] - m[2];
 
+        // planes are normalized, so distances to them can be compared with sphere radius
+        for (auto& plane : this->planes)
+            plane /= Length(Vector3(plane));
+
         std::array crosses = {
             Cross(Vector3(this->planes[LEFT]),   Vector3(this->planes[RIGHT])),
             Cross(Vector3(this->planes[LEFT]),   Vector3(this->planes[BOTTOM])),
@@ -147,4 +152,14 @@ namespace MxEngine
 
         return true;
      }
+
+    inline bool FrustrumCuller::IsSphereVisible(const Vector3& center, float radius) const
+    {
+        for (const auto& plane : this->planes)
+        {
+            if (Dot(Vector3(plane), center) + plane.w < -radius)
+                return false;
+        }
+        return true;
+    }
 }
\ No newline at end of file
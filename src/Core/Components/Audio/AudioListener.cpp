@@ -116,7 +116,9 @@ namespace MxEngine
 
         rttr::registration::class_<AudioListener>("AudioListener")
             (
-                rttr::metadata(MetaInfo::FLAGS, MetaInfo::CLONE_COPY | MetaInfo::CLONE_INSTANCE)
+                rttr::metadata(MetaInfo::FLAGS, MetaInfo::CLONE_COPY | MetaInfo::CLONE_INSTANCE),
+                rttr::metadata(UpdateInfo::READS, ComponentTypes<CameraController, Transform>()),
+                rttr::metadata(UpdateInfo::MAIN_THREAD, true)
             )
             .constructor<>()
             .property("volume", &AudioListener::GetVolume, &AudioListener::SetVolume)
@@ -245,7 +245,9 @@ namespace MxEngine
     {
         rttr::registration::class_<AudioSource>("AudioSource")
             (
-                rttr::metadata(MetaInfo::FLAGS, MetaInfo::CLONE_COPY | MetaInfo::CLONE_INSTANCE)
+                rttr::metadata(MetaInfo::FLAGS, MetaInfo::CLONE_COPY | MetaInfo::CLONE_INSTANCE),
+                rttr::metadata(UpdateInfo::READS, ComponentTypes<Transform>()),
+                rttr::metadata(UpdateInfo::MAIN_THREAD, true)
             )
             .constructor<>()
             .method("replay", &AudioSource::Replay)
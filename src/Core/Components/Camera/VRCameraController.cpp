@@ -102,7 +102,8 @@ namespace MxEngine
     {
         rttr::registration::class_<VRCameraController>("VRCameraController")
             (
-                rttr::metadata(MetaInfo::FLAGS, MetaInfo::CLONE_COPY | MetaInfo::CLONE_INSTANCE)
+                rttr::metadata(MetaInfo::FLAGS, MetaInfo::CLONE_COPY | MetaInfo::CLONE_INSTANCE),
+                rttr::metadata(UpdateInfo::WRITES, ComponentTypes<CameraController, Transform>())
             )
             .constructor<>()
             .property("eye distance", &VRCameraController::EyeDistance)
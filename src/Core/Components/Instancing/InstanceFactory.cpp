@@ -77,10 +77,10 @@ namespace MxEngine
 
     void InstanceFactory::FreeInstanceAllocation()
     {
-        if (this->instanceAllocation.Size != 0)
-        {
-            BufferAllocator::DeallocateInInstanceVBO({ this->instanceAllocation.Offset * InstanceDataSize, this->instanceAllocation.Size * InstanceDataSize });
-        }
+        if (this->instanceAllocation.Handle.IsValid())
+            BufferAllocator::Deallocate(this->instanceAllocation.Handle);
+        this->instanceAllocation.Handle = BufferAllocationHandle{ };
+        this->instanceAllocation.Size = 0;
     }
 
     InstanceFactory::~InstanceFactory()
@@ -99,7 +99,7 @@ namespace MxEngine
             // BufferAllocator::GetInstanceVBO()->BufferSubData(
             //     (float*)this->instances.data(),
             //     this->instances.size() * InstanceDataSize,
-            //     this->instanceAllocation.Offset * InstanceDataSize
+            //     this->GetInstanceBufferOffset() * InstanceDataSize
             // );
         }
     }
@@ -110,9 +110,13 @@ namespace MxEngine
 
         this->FreeInstanceAllocation();
 
-        auto allocation = BufferAllocator::AllocateInInstanceVBO(count * InstanceDataSize);
-        this->instanceAllocation.Offset = allocation.Offset / InstanceDataSize;
-        this->instanceAllocation.Size = allocation.Size / InstanceDataSize;
+        this->instanceAllocation.Handle = BufferAllocator::Allocate(BufferHeap::INSTANCE, count * sizeof(InstanceData), sizeof(InstanceData));
+        this->instanceAllocation.Size = count;
+    }
+
+    size_t InstanceFactory::GetInstanceBufferOffset() const
+    {
+        return BufferAllocator::GetAllocation(this->instanceAllocation.Handle).Offset / sizeof(InstanceData);
     }
 
     bool IsInstanced(const MxObject& object)
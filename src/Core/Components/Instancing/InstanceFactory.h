@@ -165,7 +165,7 @@ namespace MxEngine
         InstancePool& GetInstancePool() { return this->pool; };
         size_t GetInstanceCount() const { return this->GetInstancePool().Allocated(); }
         size_t GetInstanceBufferSize() const { return this->instanceAllocation.Size; }
-        size_t GetInstanceBufferOffset() const { return this->instanceAllocation.Offset; }
+        size_t GetInstanceBufferOffset() const;
         auto GetInstances() const { return InstanceView{ this->pool }; }
 
         void OnUpdate(float timeDelta);
@@ -99,7 +99,9 @@ namespace MxEngine
     {
         rttr::registration::class_<DirectionalLight>("DirectionalLight")
             (
-                rttr::metadata(MetaInfo::FLAGS, MetaInfo::CLONE_COPY | MetaInfo::CLONE_INSTANCE)
+                rttr::metadata(MetaInfo::FLAGS, MetaInfo::CLONE_COPY | MetaInfo::CLONE_INSTANCE),
+                rttr::metadata(UpdateInfo::READS, ComponentTypes<CameraController>()),
+                rttr::metadata(UpdateInfo::WRITES, ComponentTypes<Transform>())
             )
             .constructor<>()
             .property("color", &DirectionalLight::GetColor, &DirectionalLight::SetColor)
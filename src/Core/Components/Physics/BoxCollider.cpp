@@ -34,7 +34,7 @@ namespace MxEngine
 {
     void BoxCollider::CreateNewShape(const BoundingBox& box)
     {
-        this->SetColliderChangedFlag(true);
+        this->MarkShapeChanged(MxObject::GetByComponent(*this));
         this->boxShape = Factory<BoxShape>::Create(box);
     }
 
@@ -34,7 +34,7 @@ namespace MxEngine
 {
     void CapsuleCollider::CreateNewShape(const Capsule& capsule)
     {
-        this->SetColliderChangedFlag(true);
+        this->MarkShapeChanged(MxObject::GetByComponent(*this));
         this->capsuleShape = Factory<CapsuleShape>::Create(capsule);
     }
 
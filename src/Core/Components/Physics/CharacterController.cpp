@@ -167,7 +167,9 @@ namespace MxEngine
     {
         rttr::registration::class_<CharacterController>("CharacterController")
             (
-                rttr::metadata(MetaInfo::FLAGS, MetaInfo::CLONE_COPY | MetaInfo::CLONE_INSTANCE)
+                rttr::metadata(MetaInfo::FLAGS, MetaInfo::CLONE_COPY | MetaInfo::CLONE_INSTANCE),
+                rttr::metadata(UpdateInfo::READS, ComponentTypes<CameraController, InputController, Transform>()),
+                rttr::metadata(UpdateInfo::WRITES, ComponentTypes<RigidBody>())
             )
             .constructor<>()
             .property_readonly("is grounded", &CharacterController::IsGrounded)
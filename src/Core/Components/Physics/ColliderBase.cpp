@@ -30,6 +30,7 @@
 #include "Core/MxObject/MxObject.h"
 #include "Core/Components/Instancing/Instance.h"
 #include "Core/Components/Rendering/MeshSource.h"
+#include "Core/Components/Physics/RigidBody.h"
 
 namespace MxEngine
 {
@@ -40,6 +41,20 @@ namespace MxEngine
         return meshSource;
     }
 
+    ColliderBase::~ColliderBase()
+    {
+        // rigid body still references shape of removed collider, so it must be detached before next simulation step
+        if (this->objectHandle != std::numeric_limits<size_t>::max())
+            RigidBody::RequestColliderUpdate(this->objectHandle);
+    }
+
+    void ColliderBase::MarkShapeChanged(MxObject& self)
+    {
+        this->colliderChangedFlag = true;
+        this->objectHandle = self.GetNativeHandle();
+        RigidBody::RequestColliderUpdate(this->objectHandle);
+    }
+
     bool ColliderBase::ShouldUpdateCollider(MxObject& self)
     {
         auto meshSource = GetCurrentlyUsedMesh(self);
@@ -30,6 +30,8 @@
 
 #include "Utilities/UUID/UUID.h"
 
+#include <limits>
+
 namespace MxEngine
 {
     class MxObject;
@@ -40,7 +42,14 @@ namespace MxEngine
     {
         UUID savedMeshState = UUIDGenerator::GetNull();
         bool colliderChangedFlag = true;
+        // handle of object which owns collider, known after first shape is created. Destroyed collider can not access its object anymore
+        size_t objectHandle = std::numeric_limits<size_t>::max();
     protected:
+        ~ColliderBase();
+        /*!
+        marks collider shape as replaced and requests rigid body of the object to reattach it on next physics synchronization
+        */
+        void MarkShapeChanged(MxObject& self);
         bool ShouldUpdateCollider(MxObject& self);
         static const AABB& GetAABB(MxObject& self);
         static const BoundingSphere& GetBoundingSphere(MxObject& self);
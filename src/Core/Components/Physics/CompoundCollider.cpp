@@ -34,7 +34,7 @@ namespace MxEngine
 {
     void CompoundCollider::CreateNewShape()
     {
-        this->SetColliderChangedFlag(true);
+        this->MarkShapeChanged(MxObject::GetByComponent(*this));
         this->compoundShape = Factory<CompoundShape>::Create();
     }
 
@@ -34,7 +34,7 @@ namespace MxEngine
 {
     void CylinderCollider::CreateNewShape(const Cylinder& cylinder)
     {
-        this->SetColliderChangedFlag(true);
+        this->MarkShapeChanged(MxObject::GetByComponent(*this));
         this->cylinderShape = Factory<CylinderShape>::Create(cylinder);
     }
 
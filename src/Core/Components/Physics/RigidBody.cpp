@@ -37,32 +37,43 @@
 #include "Platform/Bullet3/Bullet3Utils.h"
 #include "Core/Application/Physics.h"
 #include "Core/Runtime/Reflection.h"
+#include "Platform/Modules/PhysicsModule.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/Memory/FrameAllocator.h"
+#include "Utilities/Profiler/Profiler.h"
 
 namespace MxEngine
 {
     void RigidBody::UpdateTransform()
     {
         auto& self = MxObject::GetByComponent(*this);
-        auto selfScale = self.LocalTransform.GetScale();
+        // transforms written by physics engine reset the flag, so only objects moved by user are pushed back
+        if (!self.LocalTransform.HasChanged()) return;
+
+        btTransform tr;
+        ToBulletTransform(tr, self.LocalTransform);
+        auto body = this->rigidBody->GetNativeHandle();
 
         if (this->IsKinematic())
         {
             // if body is kinematic, MxObject's Transform component controls its position
-            btTransform tr;
-            ToBulletTransform(tr, self.LocalTransform);
-            this->rigidBody->GetNativeHandle()->getMotionState()->setWorldTransform(tr);
+            body->getMotionState()->setWorldTransform(tr);
         }
-        else if (this->rigidBody->HasTransformUpdate())
+        else
         {
-            // if body is not kinematic, transform is controlled by physics engine
-            FromBulletTransform(self.LocalTransform, this->rigidBody->GetNativeHandle()->getWorldTransform());
-            this->rigidBody->SetTransformUpdateFlag(false);
+            // if body is not kinematic, it is teleported to the position set by user
+            body->setWorldTransform(tr);
+            body->setInterpolationWorldTransform(tr);
+            body->getMotionState()->setWorldTransform(tr);
+            this->rigidBody->Activate();
         }
 
+        auto selfScale = self.LocalTransform.GetScale();
         if (selfScale != this->rigidBody->GetScale())
         {
             this->rigidBody->SetScale(selfScale);
         }
+        self.LocalTransform.SetChangedFlag(false);
     }
 
     NativeRigidBodyHandle RigidBody::GetNativeHandle() const
@@ -70,11 +81,6 @@ namespace MxEngine
         return this->rigidBody;
     }
 
-    void RigidBody::OnUpdate(float dt)
-    {
-        this->SyncObjectState();
-    }
-
     void RigidBody::SyncObjectState()
     {
         this->UpdateCollider();
@@ -82,15 +88,89 @@ namespace MxEngine
     }
 
     template<typename T>
-    bool TestCollider(NativeRigidBodyHandle& rigidBody, T collider)
+    void PollColliderMeshes()
+    {
+        for (auto& collider : ComponentFactory::GetView<T>())
+            collider.UpdateCollider();
+    }
+
+    void RigidBody::SyncObjectStates()
+    {
+        MAKE_SCOPE_PROFILER("RigidBody::SyncObjectStates()");
+
+        // mesh sources can be swapped without notification, so colliders which follow object mesh poll it. Colliders with new shape request body update
+        PollColliderMeshes<BoxCollider>();
+        PollColliderMeshes<SphereCollider>();
+        PollColliderMeshes<CylinderCollider>();
+        PollColliderMeshes<CapsuleCollider>();
+        PollColliderMeshes<CompoundCollider>();
+
+        auto& changedObjects = PhysicsModule::GetImpl()->ChangedColliderObjects;
+
+        auto& objects = Factory<MxObject>::GetPool();
+        for (size_t handle : changedObjects)
+        {
+            // collider may be destroyed together with its object
+            if (!objects.IsAllocated(handle)) continue;
+            auto rigidBody = objects[handle].value.GetComponent<RigidBody>();
+            if (rigidBody.IsValid()) rigidBody->UpdateCollider();
+        }
+        changedObjects.clear();
+
+        auto view = ComponentFactory::GetView<RigidBody>();
+        for (auto& rigidBody : view)
+        {
+            if (MxObject::GetByComponent(rigidBody).LocalTransform.HasChanged())
+                rigidBody.UpdateTransform();
+        }
+    }
+
+    void RigidBody::RequestColliderUpdate(size_t objectHandle)
+    {
+        // colliders of objects destroyed after physics module have no rigid body to update
+        auto data = PhysicsModule::GetImpl();
+        if (data != nullptr) data->ChangedColliderObjects.push_back(objectHandle);
+    }
+
+    void RigidBody::FetchActiveTransforms()
+    {
+        MAKE_SCOPE_PROFILER("RigidBody::FetchActiveTransforms()");
+        constexpr size_t FetchGrainSize = 256;
+
+        // sleeping bodies are not moved by simulation and kinematic bodies are controlled by their objects, so both are skipped
+        auto& bodies = PhysicsModule::GetImpl()->World->getNonStaticRigidBodies();
+        FrameVector<btRigidBody*> activeBodies;
+        for (int i = 0; i < bodies.size(); i++)
+        {
+            if (bodies[i]->isActive() && !bodies[i]->isKinematicObject())
+                activeBodies.push_back(bodies[i]);
+        }
+
+        // each body has its own object, so transforms can be written concurrently
+        ThreadPool::ParallelFor(activeBodies.size(), FetchGrainSize, [&activeBodies](size_t begin, size_t end)
+        {
+            auto& objects = Factory<MxObject>::GetPool();
+            for (size_t i = begin; i < end; i++)
+            {
+                auto handle = reinterpret_cast<MxObject::EngineHandle>(activeBodies[i]->getUserPointer());
+                auto& transform = objects[handle].value.LocalTransform;
+                FromBulletTransform(transform, activeBodies[i]->getWorldTransform());
+                transform.SetChangedFlag(false);
+            }
+        });
+    }
+
+    template<typename T>
+    bool TestCollider(NativeRigidBodyHandle& rigidBody, T collider, const Vector3& scale)
     {
         if (!collider.IsValid()) return false;
 
-        collider->UpdateCollider();
         if (collider->HasColliderChanged())
         {
             auto shape = collider->GetNativeHandle();
             rigidBody->SetCollisionShape(shape->GetNativeHandle());
+            // new shape is created with unit scale, so object scale is applied to it immediately
+            rigidBody->SetScale(scale);
             collider->SetColliderChangedFlag(false);
         }
         return true;
@@ -118,17 +198,19 @@ namespace MxEngine
         InvalidateCollider<CylinderCollider>(self);
         InvalidateCollider<CapsuleCollider>(self);
         InvalidateCollider<CompoundCollider>(self);
+        RigidBody::RequestColliderUpdate(self.GetNativeHandle());
     }
 
     void RigidBody::UpdateCollider()
     {
         auto& self = MxObject::GetByComponent(*this);
+        auto scale = self.LocalTransform.GetScale();
 
-        if(TestCollider(this->rigidBody, self.GetComponent<BoxCollider>()))      return;
-        if(TestCollider(this->rigidBody, self.GetComponent<SphereCollider>()))   return;
-        if(TestCollider(this->rigidBody, self.GetComponent<CylinderCollider>())) return;
-        if(TestCollider(this->rigidBody, self.GetComponent<CapsuleCollider>()))  return;
-        if(TestCollider(this->rigidBody, self.GetComponent<CompoundCollider>())) return;
+        if(TestCollider(this->rigidBody, self.GetComponent<BoxCollider>(), scale))      return;
+        if(TestCollider(this->rigidBody, self.GetComponent<SphereCollider>(), scale))   return;
+        if(TestCollider(this->rigidBody, self.GetComponent<CylinderCollider>(), scale)) return;
+        if(TestCollider(this->rigidBody, self.GetComponent<CapsuleCollider>(), scale))  return;
+        if(TestCollider(this->rigidBody, self.GetComponent<CompoundCollider>(), scale)) return;
 
         this->rigidBody->SetCollisionShape(nullptr); // no collider
     }
@@ -67,8 +67,23 @@ namespace MxEngine
     public:
         RigidBody() = default;
         void Init();
-        void OnUpdate(float dt);
+        /*!
+        updates collider of the body and pushes object transform to physics world if it was changed since the last synchronization
+        */
         void SyncObjectState();
+        /*!
+        synchronizes rigid bodies with their objects before simulation step. Only bodies with changed colliders or transforms are updated
+        */
+        static void SyncObjectStates();
+        /*!
+        requests rigid body of the object to reattach its collider on next synchronization. Called by colliders when their shape is replaced or removed
+        \param objectHandle native handle of object which owns collider
+        */
+        static void RequestColliderUpdate(size_t objectHandle);
+        /*!
+        writes transforms of active bodies back to their objects after simulation step. Sleeping and kinematic bodies are skipped
+        */
+        static void FetchActiveTransforms();
 
         NativeRigidBodyHandle GetNativeHandle() const;
         void InvokeOnCollisionCallback(MxObjectHandle self, MxObjectHandle object);
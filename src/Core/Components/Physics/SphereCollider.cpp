@@ -34,7 +34,7 @@ namespace MxEngine
 {
     void SphereCollider::CreateNewShape(const BoundingSphere& sphere)
     {
-        this->SetColliderChangedFlag(true);
+        this->MarkShapeChanged(MxObject::GetByComponent(*this));
         this->sphereShape = Factory<SphereShape>::Create(sphere.Radius);
     }
 
@@ -35,13 +35,15 @@ namespace MxEngine
 {
     ParticleSystem::~ParticleSystem()
     {
-        if (this->particleAllocationCount != 0)
-        {
-            BufferAllocator::DeallocateInSSBO(BufferAllocation{ 
-                this->particleAllocationOffset * sizeof(ParticleGPU), 
-                this->particleAllocationCount * sizeof(ParticleGPU)
-            });
-        }
+        this->FreeParticleAllocation();
+    }
+
+    void ParticleSystem::FreeParticleAllocation()
+    {
+        if (this->particleAllocation.IsValid())
+            BufferAllocator::Deallocate(this->particleAllocation);
+        this->particleAllocation = BufferAllocationHandle{ };
+        this->particleAllocationCount = 0;
     }
 
     void ParticleSystem::OnUpdate(float)
@@ -51,17 +53,10 @@ namespace MxEngine
             MxVector<ParticleGPU> initialState(this->GetMaxParticleCount());
             this->FillParticleData(initialState);
             
-            if (this->particleAllocationCount != 0)
-            {
-                BufferAllocator::DeallocateInSSBO(BufferAllocation{ 
-                    this->particleAllocationOffset * sizeof(ParticleGPU), 
-                    this->particleAllocationCount * sizeof(ParticleGPU)
-                });
-            }
-            auto [offset, count] = BufferAllocator::AllocateInSSBO(initialState.size() * sizeof(ParticleGPU));
-            this->particleAllocationCount = count / sizeof(ParticleGPU);
-            this->particleAllocationOffset = offset / sizeof(ParticleGPU);
-            // BufferAllocator::GetSSBO()->BufferSubData((uint8_t*)initialState.data(), count, offset);
+            this->FreeParticleAllocation();
+            this->particleAllocation = BufferAllocator::Allocate(BufferHeap::STORAGE, initialState.size() * sizeof(ParticleGPU), sizeof(ParticleGPU));
+            this->particleAllocationCount = initialState.size();
+            // BufferAllocator::GetSSBO()->BufferSubData((uint8_t*)initialState.data(), initialState.size() * sizeof(ParticleGPU), BufferAllocator::GetAllocation(this->particleAllocation).Offset);
 
             this->isDirty = false;
         }
@@ -74,7 +69,7 @@ namespace MxEngine
 
     size_t ParticleSystem::GetParticleAllocationOffset() const
     {
-        return this->particleAllocationOffset;
+        return BufferAllocator::GetAllocation(this->particleAllocation).Offset / sizeof(ParticleGPU);
     }
 
     size_t ParticleSystem::GetParticleAllocationCount() const
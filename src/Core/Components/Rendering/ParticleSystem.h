@@ -30,6 +30,7 @@
 
 #include "Utilities/ECS/Component.h"
 #include "Platform/GraphicAPI.h"
+#include "Core/Resources/BufferAllocator.h"
 
 namespace MxEngine
 {
@@ -59,7 +60,8 @@ namespace MxEngine
     private:
         MAKE_COMPONENT(ParticleSystem);
 
-        size_t particleAllocationOffset = 0;
+        // allocation may be moved by defragmentation, so its offset is resolved each time it is requested
+        BufferAllocationHandle particleAllocation;
         size_t particleAllocationCount = 0;
         size_t maxParticleCount = 1024;
         float particleLifetime = 1.0f;
@@ -76,6 +78,7 @@ namespace MxEngine
         bool isRelative = false;
 
         void FillParticleData(MxVector<ParticleGPU>& particles) const;
+        void FreeParticleAllocation();
     public:
         ParticleSystem() = default;
         ~ParticleSystem();
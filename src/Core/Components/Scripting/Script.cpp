@@ -39,11 +39,18 @@ namespace MxEngine
         auto& info = RuntimeCompiler::GetScriptInfo(className);
         this->scriptImpl = info.ScriptHandle;
         this->scriptName = MakeStringId(info.Name);
+        this->isUpdateBatched = this->scriptImpl != nullptr && this->scriptImpl->IsUpdateBatched();
+    }
+
+    Script::~Script()
+    {
+        if (this->isUpdateBatched) RuntimeCompiler::InvalidateScriptBatches();
     }
 
     void Script::OnUpdate(float dt)
     {
-        if (this->scriptImpl != nullptr)
+        // batched scripts are invoked once per frame, see RuntimeCompiler::InvokeScriptBatches
+        if (this->scriptImpl != nullptr && !this->isUpdateBatched)
         {
             RuntimeCompiler::InvokeScriptableObject(
                 this->scriptImpl, ScriptableMethod::ON_UPDATE, MxObject::GetByComponent(*this)
@@ -53,6 +60,7 @@ namespace MxEngine
 
     void Script::Init()
     {
+        if (this->isUpdateBatched) RuntimeCompiler::InvalidateScriptBatches();
         if (this->scriptImpl != nullptr)
         {
             RuntimeCompiler::InvokeScriptableObject(
@@ -69,8 +77,12 @@ namespace MxEngine
 
     void Script::SetScriptableObject(const ScriptInfo& scriptInfo)
     {
+        bool wasUpdateBatched = this->isUpdateBatched;
         this->scriptImpl = scriptInfo.ScriptHandle;
         this->scriptName = MakeStringId(scriptInfo.Name);
+        this->isUpdateBatched = this->scriptImpl != nullptr && this->scriptImpl->IsUpdateBatched();
+        if (wasUpdateBatched || this->isUpdateBatched) RuntimeCompiler::InvalidateScriptBatches();
+
         if (this->scriptImpl != nullptr)
         {
             RuntimeCompiler::InvokeScriptableObject(
@@ -89,10 +101,17 @@ namespace MxEngine
         return this->scriptImpl != nullptr;
     }
 
+    bool Script::IsUpdateBatched() const
+    {
+        return this->isUpdateBatched;
+    }
+
     void Script::RemoveScriptableObject()
     {
+        if (this->isUpdateBatched) RuntimeCompiler::InvalidateScriptBatches();
         this->scriptImpl = nullptr;
         this->scriptName = 0;
+        this->isUpdateBatched = false;
     }
 
     const MxString& Script::GetScriptName() const
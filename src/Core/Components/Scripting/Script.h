@@ -44,17 +44,20 @@ namespace MxEngine
 
         StringId scriptName = 0;
         Scriptable* scriptImpl = nullptr;
+        bool isUpdateBatched = false;
     public:
         ScriptDatabase Database;
 
         Script() = default;
         Script(const MxString& scriptName);
+        ~Script();
         void Init();
         void OnUpdate(float dt);
 
         void SetScriptableObject(const ScriptInfo& scriptInfo);
         void SetScriptableObject(const MxString& scriptName);
         bool HasScriptableObject() const;
+        bool IsUpdateBatched() const;
         void RemoveScriptableObject();
         Scriptable* GetScriptableObject();
         StringId GetHashedScriptName() const;
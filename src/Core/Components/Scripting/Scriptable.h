@@ -29,6 +29,7 @@
 #pragma once
 
 #include "Core/Application/GlobalContextSerializer.h"
+#include "Utilities/Array/ArrayView.h"
 
 #include <RuntimeObjectSystem/ObjectInterfacePerModule.h>
 #include <RuntimeObjectSystem/RuntimeProtector.h>
@@ -63,6 +64,8 @@ namespace MxEngine
         {
             ScriptableMethod Method = ScriptableMethod::ON_CREATE;
             MxObject::Handle Self;
+            ArrayView<MxObject*> Batch;
+            float TimeDelta = 0.0f;
         } CurrentState;
 
         virtual void InitializeModuleContext(void* context) 
@@ -86,6 +89,9 @@ namespace MxEngine
             case ScriptableMethod::ON_UPDATE:
                 this->OnUpdate(this->CurrentState.Self);
                 break;
+            case ScriptableMethod::ON_UPDATE_BATCH:
+                this->OnUpdateBatch(this->CurrentState.Batch, this->CurrentState.TimeDelta);
+                break;
             default:
                 break;
             }
@@ -97,6 +103,11 @@ namespace MxEngine
         virtual void OnCreate(MxObject::Handle self) { }
         virtual void OnReload(MxObject::Handle self) { }
         virtual void OnUpdate(MxObject::Handle self) { }
+
+        // script which returns true is updated once per frame with all its objects through OnUpdateBatch instead of OnUpdate.
+        // Object pointers are valid only until new objects are created or existing ones are destroyed
+        virtual bool IsUpdateBatched() const { return false; }
+        virtual void OnUpdateBatch(ArrayView<MxObject*> objects, float dt) { }
     };
 
     class Scriptable : public TInterface<SciptableInterface::ID, SciptableInterface> { };
@@ -98,6 +98,16 @@ namespace MxEngine
         return MakeQuaternion(MakeRotationMatrix(RadiansVec(this->rotation)));
     }
 
+    bool Transform::HasChanged() const
+    {
+        return this->hasChanged;
+    }
+
+    void Transform::SetChangedFlag(bool value)
+    {
+        this->hasChanged = value;
+    }
+
     Vector3 Transform::GetPosition() const
     {
         return this->position;
@@ -119,6 +129,7 @@ namespace MxEngine
     {
         this->scale = scale;
         this->needTransformUpdate = true;
+        this->hasChanged = true;
         return *this;
     }
 
@@ -131,6 +142,7 @@ namespace MxEngine
     {
         this->position = position;
         this->needTransformUpdate = true;
+        this->hasChanged = true;
         return *this;
     }
 
@@ -143,6 +155,7 @@ namespace MxEngine
     {
         this->scale *= scale;
         this->needTransformUpdate = true;
+        this->hasChanged = true;
         return *this;
     }
 
@@ -173,6 +186,7 @@ namespace MxEngine
         this->rotation.y = std::fmod(this->rotation.y + 360.0f, 360.0f);
         this->rotation.z = std::fmod(this->rotation.z + 360.0f, 360.0f);
         this->needTransformUpdate = true;
+        this->hasChanged = true;
         return *this;
     }
 
@@ -195,6 +209,7 @@ namespace MxEngine
     {
         this->position += dist;
         this->needTransformUpdate = true;
+        this->hasChanged = true;
         return *this;
     }
 
@@ -40,6 +40,8 @@ namespace MxEngine
         mutable Matrix4x4 transform{ 0.0f };
         mutable Matrix3x3 normalMatrix{ 0.0f };
         mutable bool needTransformUpdate = true;
+        // set on any modification, reset by systems which mirror transform into their own state (i.e. physics)
+        bool hasChanged = true;
     public:
         bool operator==(const Transform& other) const;
         bool operator!=(const Transform& other) const;
@@ -56,6 +58,9 @@ namespace MxEngine
 
         Quaternion GetRotationQuaternion() const;
 
+        bool HasChanged() const;
+        void SetChangedFlag(bool value);
+
         Transform& SetRotation(Quaternion q);
         Transform& SetRotation(Vector3 angles);
         Transform& SetScale(Vector3 scale);
@@ -84,7 +84,10 @@ namespace MxEngine
         FromJson(config.PointLightTextureSize,  json["renderer"],    "point-light-texture-size");
         FromJson(config.SpotLightTextureSize,   json["renderer"],    "spot-light-texture-size" );
         FromJson(config.EngineTextureSize,      json["renderer"],    "engine-texture-size"     );
+        FromJson(config.PhysicsWorld,           json["physics"    ], "world-type"              );
+        FromJson(config.DeterministicPhysics,   json["physics"    ], "deterministic"           );
         FromJson(config.IgnoredFolders,         json["filesystem" ], "ignored-folders"         );
+        FromJson(config.PackFiles,              json["filesystem" ], "pack-files"              );
         FromJson(config.CachePrimitiveModels,   json["filesystem" ], "cache-primitives"        );
         FromJson(config.ShaderSourceDirectory,  json["debug-build"], "shader-source-directory" );
         FromJson(config.ApplicationCloseKey,    json["debug-build"], "app-close-key"           );
@@ -108,7 +111,10 @@ namespace MxEngine
         json["renderer"   ]["point-light-texture-size"] = config.PointLightTextureSize;
         json["renderer"   ]["spot-light-texture-size" ] = config.SpotLightTextureSize;
         json["renderer"   ]["engine-texture-size"     ] = config.EngineTextureSize;
+        json["physics"    ]["world-type"              ] = config.PhysicsWorld;
+        json["physics"    ]["deterministic"           ] = config.DeterministicPhysics;
         json["filesystem" ]["ignored-folders"         ] = config.IgnoredFolders;
+        json["filesystem" ]["pack-files"              ] = config.PackFiles;
         json["filesystem" ]["cache-primitives"        ] = config.CachePrimitiveModels;
         json["debug-build"]["shader-source-directory" ] = config.ShaderSourceDirectory;
         json["debug-build"]["app-close-key"           ] = config.ApplicationCloseKey;
@@ -136,6 +142,20 @@ namespace MxEngine
         else
             style = EditorStyle::MXENGINE;
     }
+
+    void to_json(JsonFile& j, PhysicsWorldType type)
+    {
+        j = EnumToString(type);
+    }
+
+    void from_json(const JsonFile& j, PhysicsWorldType& type)
+    {
+        auto val = j.get<MxString>();
+        if (val == "MULTI_THREADED")
+            type = PhysicsWorldType::MULTI_THREADED;
+        else
+            type = PhysicsWorldType::SINGLE_THREADED;
+    }
 }
 
 namespace VulkanAbstractionLayer
@@ -32,6 +32,7 @@
 #include "Utilities/STL/MxString.h"
 #include "Utilities/Json/Json.h"
 #include "Core/Events/KeyEvent.h"
+#include "Platform/Modules/PhysicsModule.h"
 
 namespace MxEngine
 {
@@ -72,8 +73,13 @@ namespace MxEngine
         size_t SpotLightTextureSize = 512;
         size_t EngineTextureSize = 512;
 
+        // Physics settings
+        PhysicsWorldType PhysicsWorld = PhysicsWorldType::SINGLE_THREADED;
+        bool DeterministicPhysics = false;
+
         // Filesystem settings
         MxVector<MxString> IgnoredFolders = { "MxEngine", "out", "build", ".git", ".vs" };
+        MxVector<MxString> PackFiles = { };
 
         // Debug settings
         MxString ShaderSourceDirectory = "../../src/Platform/OpenGL/Shaders";
@@ -91,6 +97,8 @@ namespace MxEngine
 
     void to_json(JsonFile& j, EditorStyle style);
     void from_json(const JsonFile& j, EditorStyle& style);
+    void to_json(JsonFile& j, PhysicsWorldType type);
+    void from_json(const JsonFile& j, PhysicsWorldType& type);
 }
 
 namespace VulkanAbstractionLayer
@@ -101,11 +101,26 @@ namespace MxEngine
         return CFG(EngineTextureSize);
     }
 
+    PhysicsWorldType GlobalConfig::GetPhysicsWorldType()
+    {
+        return CFG(PhysicsWorld);
+    }
+
+    bool GlobalConfig::HasDeterministicPhysics()
+    {
+        return CFG(DeterministicPhysics);
+    }
+
     const MxVector<MxString>& GlobalConfig::GetIgnoredFolders()
     {
         return CFG(IgnoredFolders);
     }
 
+    const MxVector<MxString>& GlobalConfig::GetPackFiles()
+    {
+        return CFG(PackFiles);
+    }
+
     const MxString& GlobalConfig::GetShaderSourceDirectory()
     {
         return CFG(ShaderSourceDirectory);
@@ -47,7 +47,10 @@ namespace MxEngine
         static size_t GetPointLightTextureSize();
         static size_t GetSpotLightTextureSize();
         static size_t GetEngineTextureSize();
+        static PhysicsWorldType GetPhysicsWorldType();
+        static bool HasDeterministicPhysics();
         static const MxVector<MxString>& GetIgnoredFolders();
+        static const MxVector<MxString>& GetPackFiles();
         static const MxString& GetShaderSourceDirectory();
         static EditorStyle GetEditorStyle();
         static bool HasGraphicAPIDebug();
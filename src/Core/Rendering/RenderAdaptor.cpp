@@ -32,6 +32,8 @@
 #include "Library/Noise/NoiseGenerator.h"
 #include "Core/Config/GlobalConfig.h"
 #include "Core/Resources/BufferAllocator.h"
+#include "Core/Resources/AssetStreamer.h"
+#include "Core/Rendering/RenderGraph/SubmissionQueue.h"
 #include "Core/Components/Rendering/MeshSource.h"
 #include "Core/Components/Rendering/MeshRenderer.h"
 #include "Core/Components/Rendering/Skybox.h"
@@ -74,18 +76,22 @@ namespace MxEngine
         // light bounding objects
         auto pyramidInstanced = Primitives::CreatePyramid();
         pyramidInstanced.MakeStatic();
+        // offsets of light helper objects are cached by renderer, so their storage must stay in place
+        pyramidInstanced->SetBuffersMovable(false);
         this->Renderer.GetLightInformation().SpotLightsInstanced = SpotLightInstancedObject(
             pyramidInstanced->GetBaseVerteciesOffset(), pyramidInstanced->GetTotalVerteciesCount(),
             pyramidInstanced->GetBaseIndiciesOffset(),  pyramidInstanced->GetTotalIndiciesCount());
 
         auto sphereInstanced = Primitives::CreateSphere(8);
         sphereInstanced.MakeStatic();
+        sphereInstanced->SetBuffersMovable(false);
         this->Renderer.GetLightInformation().PointLightsInstanced = PointLightInstancedObject(
             sphereInstanced->GetBaseVerteciesOffset(), sphereInstanced->GetTotalVerteciesCount(),
             sphereInstanced->GetBaseIndiciesOffset(),  sphereInstanced->GetTotalIndiciesCount());
 
         auto pyramid = Primitives::CreatePyramid();
         pyramid.MakeStatic();
+        pyramid->SetBuffersMovable(false);
         this->Renderer.GetLightInformation().SpotLight = RenderHelperObject(
             pyramid->GetBaseVerteciesOffset(), pyramid->GetTotalVerteciesCount(),
             pyramid->GetBaseIndiciesOffset(), pyramid->GetTotalIndiciesCount());
@@ -93,6 +99,7 @@ namespace MxEngine
 
         auto sphere = Primitives::CreateSphere(8);
         sphere.MakeStatic();
+        sphere->SetBuffersMovable(false);
         this->Renderer.GetLightInformation().PointLight = RenderHelperObject(
             sphere->GetBaseVerteciesOffset(), sphere->GetTotalVerteciesCount(),
             sphere->GetBaseIndiciesOffset(), sphere->GetTotalIndiciesCount());
@@ -417,6 +424,11 @@ namespace MxEngine
                     mesh = meshLOD->GetMeshLOD();
                 }
 
+                // streamed meshes are prioritized by approximate screen size, and stay empty until they are uploaded
+                float radius = mesh->MeshBoundingSphere.Radius * ComponentMax(transform.GetScale());
+                AssetStreamer::OnMeshUsed(mesh, AssetStreamer::ComputeScreenPriority(transform.GetPosition(), radius, viewportPosition));
+                if (!mesh->IsLoaded()) continue;
+
                 size_t renderGroupIndex = this->Renderer.SubmitRenderGroup(*mesh, instanceOffset, instanceCount);
                 for (const auto& submesh : mesh->GetSubMeshes())
                 {
@@ -488,13 +500,25 @@ namespace MxEngine
             environment.TimeDelta = Time::Delta();
         }
 
-        this->Renderer.GetRenderStatistics().ResetAll();
+        auto& statistics = this->Renderer.GetRenderStatistics();
+        statistics.ResetAll();
+        statistics.AddEntry("frame arena used bytes", FrameAllocator::GetLastFrameUsedBytes());
+        statistics.AddEntry("frame arena high-water mark", FrameAllocator::GetHighWaterMark());
+        statistics.AddEntry("streaming uploaded bytes", AssetStreamer::GetStats().UploadedBytes);
+        statistics.AddEntry("streaming resident bytes", AssetStreamer::GetStats().ResidentBytes);
+        statistics.AddEntry("buffer relocations", BufferAllocator::GetStats().RelocationCount);
+        statistics.AddEntry("buffer relocated bytes", BufferAllocator::GetStats().RelocatedBytes);
+        statistics.AddEntry("upload bytes", SubmissionQueue::GetStats().UploadedBytes);
+        statistics.AddEntry("upload pending bytes", SubmissionQueue::GetStats().PendingBytes);
+        statistics.AddEntry("upload stalls", SubmissionQueue::GetStats().StallCount);
+        statistics.AddEntry("upload flushes", SubmissionQueue::GetStats().FlushCount);
         this->Renderer.StartPipeline();
 
         if (VulkanAbstractionLayer::GetCurrentVulkanContext().IsRenderingEnabled())
         {
             auto& commandBuffer = VulkanAbstractionLayer::GetCurrentVulkanContext().GetCurrentCommandBuffer();
             auto& presentImage = VulkanAbstractionLayer::GetCurrentVulkanContext().AcquireCurrentSwapchainImage(VulkanAbstractionLayer::ImageUsage::TRANSFER_DISTINATION);
+            SubmissionQueue::SubmitFrameUploads();
             this->RenderGraph->Execute(commandBuffer);
             this->RenderGraph->Present(commandBuffer, presentImage);
         }
@@ -48,6 +48,8 @@ namespace MxEngine
 {
     constexpr size_t MaxDirLightCount = 4;
     constexpr size_t ParticleComputeGroupSize = 64;
+    // no live draw path reads ClusterRanges yet (object drawing is still disabled), so meshlets are not culled until it is ported
+    constexpr bool EnableClusterCulling = false;
 
     void RenderController::PrepareShadowMaps()
     {
@@ -101,7 +103,7 @@ namespace MxEngine
         }
     }
     
-    void RenderController::ComputeParticles(const MxVector<ParticleSystemUnit>& particleSystems)
+    void RenderController::ComputeParticles(const FrameVector<ParticleSystemUnit>& particleSystems)
     {
         if (particleSystems.empty()) return;
         MAKE_SCOPE_PROFILER("RenderController::ComputeParticles()");
@@ -121,7 +123,7 @@ namespace MxEngine
         // }
     }
 
-    void RenderController::SortParticles(const CameraUnit& camera, MxVector<ParticleSystemUnit>& particleSystems)
+    void RenderController::SortParticles(const CameraUnit& camera, FrameVector<ParticleSystemUnit>& particleSystems)
     {
         std::sort(particleSystems.begin(), particleSystems.end(), 
             [&camera](const ParticleSystemUnit& p1, const ParticleSystemUnit& p2)
@@ -132,7 +134,7 @@ namespace MxEngine
             });
     }
 
-    // void RenderController::DrawParticles(const CameraUnit& camera, MxVector<ParticleSystemUnit>& particleSystems, const Shader& shader)
+    // void RenderController::DrawParticles(const CameraUnit& camera, FrameVector<ParticleSystemUnit>& particleSystems, const Shader& shader)
     // {
     //     if (particleSystems.empty()) return;
     //     MAKE_SCOPE_PROFILER("RenderController::DrawParticles()");
@@ -213,6 +215,9 @@ namespace MxEngine
     //     this->BindCameraInformation(camera, shader);
     //     shader.SetUniform("gamma", camera.Gamma);
     // 
+    //     // meshlet ranges are culled against main camera only, other cameras draw full index ranges
+    //     bool useClusterRanges = &camera == &this->Pipeline.Cameras[this->Pipeline.Environment.MainCameraIndex];
+    // 
     //     size_t currentUnit = 0;
     //     this->Pipeline.Environment.RenderVAO->Bind();
     //     for (const auto& group : objects.Groups)
@@ -226,12 +231,12 @@ namespace MxEngine
     //             bool isUnitVisible = isInstanced || camera.Culler.IsAABBVisible(unit.MinAABB, unit.MaxAABB);
     //             this->Pipeline.Statistics.AddEntry(isUnitVisible ? "drawn objects" : "culled objects", 1);
     // 
-    //             if (isUnitVisible) this->DrawObject(unit, group.InstanceCount, group.BaseInstance, shader);
+    //             if (isUnitVisible) this->DrawObject(unit, group.InstanceCount, group.BaseInstance, shader, useClusterRanges);
     //         }
     //     }
     // }
     // 
-    // void RenderController::DrawObject(const RenderUnit& unit, size_t instanceCount, size_t baseInstance, const Shader& shader)
+    // void RenderController::DrawObject(const RenderUnit& unit, size_t instanceCount, size_t baseInstance, const Shader& shader, bool useClusterRanges)
     // {
     //     Texture::TextureBindId textureBindIndex = 0;
     //     const auto& material = this->Pipeline.MaterialUnits[unit.MaterialIndex];
@@ -264,7 +269,18 @@ namespace MxEngine
     //     shader.SetUniform("parentNormal", unit.NormalMatrix);
     //     shader.SetUniform("parentColor", material.BaseColor);
     //     
-    //     this->DrawIndices(RenderPrimitive::TRIANGLES, unit.IndexCount, unit.IndexOffset, unit.VertexOffset, instanceCount, baseInstance);
+    //     if (!useClusterRanges)
+    //     {
+    //         this->DrawIndices(RenderPrimitive::TRIANGLES, unit.IndexCount, unit.IndexOffset, unit.VertexOffset, instanceCount, baseInstance);
+    //         return;
+    //     }
+    // 
+    //     // unit has no ranges if all its meshlets were culled
+    //     for (size_t i = 0; i < unit.ClusterRangeCount; i++)
+    //     {
+    //         const auto& range = this->Pipeline.ClusterRanges[unit.ClusterRangeOffset + i];
+    //         this->DrawIndices(RenderPrimitive::TRIANGLES, range.IndexCount, range.IndexOffset, unit.VertexOffset, instanceCount, baseInstance);
+    //     }
     // }
     // 
     // void RenderController::ComputeBloomEffect(CameraUnit& camera, const TextureHandle& output)
@@ -1215,26 +1231,28 @@ namespace MxEngine
 
     void RenderController::ResetPipeline()
     {
-        this->Pipeline.Lighting.DirectionalLights.clear();
+        // pipeline lists are stored in frame arena, which is reset two frames later, so they must be detached from it each frame
+        FrameAllocator::Recycle(this->Pipeline.Lighting.DirectionalLights);
         this->Pipeline.Lighting.PointLightsInstanced.Instances.clear();
         this->Pipeline.Lighting.SpotLightsInstanced.Instances.clear();
-        this->Pipeline.Lighting.PointLights.clear();
-        this->Pipeline.Lighting.SpotLights.clear();
-        this->Pipeline.ShadowCasters.Groups.clear();
-        this->Pipeline.ShadowCasters.UnitsIndex.clear();
-        this->Pipeline.MaskedShadowCasters.Groups.clear();
-        this->Pipeline.MaskedShadowCasters.UnitsIndex.clear();
-        this->Pipeline.TransparentObjects.Groups.clear();
-        this->Pipeline.TransparentObjects.UnitsIndex.clear();
-        this->Pipeline.MaskedObjects.Groups.clear();
-        this->Pipeline.MaskedObjects.UnitsIndex.clear();
-        this->Pipeline.OpaqueObjects.Groups.clear();
-        this->Pipeline.OpaqueObjects.UnitsIndex.clear();
-        this->Pipeline.RenderUnits.clear();
-        this->Pipeline.OpaqueParticleSystems.clear();
-        this->Pipeline.TransparentParticleSystems.clear();
-        this->Pipeline.MaterialUnits.clear();
-        this->Pipeline.Cameras.clear();
+        FrameAllocator::Recycle(this->Pipeline.Lighting.PointLights);
+        FrameAllocator::Recycle(this->Pipeline.Lighting.SpotLights);
+        FrameAllocator::Recycle(this->Pipeline.ShadowCasters.Groups);
+        FrameAllocator::Recycle(this->Pipeline.ShadowCasters.UnitsIndex);
+        FrameAllocator::Recycle(this->Pipeline.MaskedShadowCasters.Groups);
+        FrameAllocator::Recycle(this->Pipeline.MaskedShadowCasters.UnitsIndex);
+        FrameAllocator::Recycle(this->Pipeline.TransparentObjects.Groups);
+        FrameAllocator::Recycle(this->Pipeline.TransparentObjects.UnitsIndex);
+        FrameAllocator::Recycle(this->Pipeline.MaskedObjects.Groups);
+        FrameAllocator::Recycle(this->Pipeline.MaskedObjects.UnitsIndex);
+        FrameAllocator::Recycle(this->Pipeline.OpaqueObjects.Groups);
+        FrameAllocator::Recycle(this->Pipeline.OpaqueObjects.UnitsIndex);
+        FrameAllocator::Recycle(this->Pipeline.RenderUnits);
+        FrameAllocator::Recycle(this->Pipeline.ClusterRanges);
+        FrameAllocator::Recycle(this->Pipeline.OpaqueParticleSystems);
+        FrameAllocator::Recycle(this->Pipeline.TransparentParticleSystems);
+        FrameAllocator::Recycle(this->Pipeline.MaterialUnits);
+        FrameAllocator::Recycle(this->Pipeline.Cameras);
     }
 
     void RenderController::SubmitParticleSystem(const ParticleSystem& system, const Material& material, const Transform& parentTransform)
@@ -1426,6 +1444,26 @@ namespace MxEngine
         renderUnit.MinAABB = aabb.Min;
         renderUnit.MaxAABB = aabb.Max;
 
+        // with cluster culling enabled big submeshes are drawn only partially, skipping meshlets invisible from main camera. Otherwise a single full range is stored
+        auto& environment = this->Pipeline.Environment;
+        const auto& meshlets = submesh.Data.GetMeshlets();
+        bool isInstanced = this->Pipeline.OpaqueObjects.Groups[renderGroupIndex].InstanceCount > 0;
+        renderUnit.ClusterRangeOffset = this->Pipeline.ClusterRanges.size();
+        if (EnableClusterCulling && !isTransparent && !isMasked && !isInstanced && !meshlets.empty() && environment.MainCameraIndex < this->Pipeline.Cameras.size())
+        {
+            const auto& camera = this->Pipeline.Cameras[environment.MainCameraIndex];
+            size_t culledCount = ClusterCuller::Cull(meshlets, renderUnit.IndexOffset, renderUnit.ModelMatrix, camera.Culler,
+                camera.ViewportPosition, camera.IsPerspective, this->Pipeline.ClusterRanges);
+
+            this->Pipeline.Statistics.AddEntry("culled meshlets", culledCount);
+            this->Pipeline.Statistics.AddEntry("drawn meshlets", meshlets.size() - culledCount);
+        }
+        else
+        {
+            this->Pipeline.ClusterRanges.push_back(IndexRange{ renderUnit.IndexOffset, renderUnit.IndexCount });
+        }
+        renderUnit.ClusterRangeCount = this->Pipeline.ClusterRanges.size() - renderUnit.ClusterRangeOffset;
+
         if (castsShadow)
         {
             auto& groupList = isMasked ? this->Pipeline.MaskedShadowCasters : this->Pipeline.ShadowCasters;
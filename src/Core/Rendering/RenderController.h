@@ -53,12 +53,12 @@ namespace MxEngine
 
         void PrepareShadowMaps();
         void DrawSkybox(const CameraUnit& camera);
-        void ComputeParticles(const MxVector<ParticleSystemUnit>& particleSystems);
-        void SortParticles(const CameraUnit& camera, MxVector<ParticleSystemUnit>& particleSystems);
-        // void DrawParticles(const CameraUnit& camera, MxVector<ParticleSystemUnit>& particleSystems, const Shader& shader);
+        void ComputeParticles(const FrameVector<ParticleSystemUnit>& particleSystems);
+        void SortParticles(const CameraUnit& camera, FrameVector<ParticleSystemUnit>& particleSystems);
+        // void DrawParticles(const CameraUnit& camera, FrameVector<ParticleSystemUnit>& particleSystems, const Shader& shader);
         // void DrawObjects(const CameraUnit& camera, const Shader& shader, const RenderList& objects);
         void DrawDebugBuffer(const CameraUnit& camera);
-        // void DrawObject(const RenderUnit& unit, size_t instanceCount, size_t baseInstance, const Shader& shader);
+        // void DrawObject(const RenderUnit& unit, size_t instanceCount, size_t baseInstance, const Shader& shader, bool useClusterRanges);
         // void ComputeBloomEffect(CameraUnit& camera, const TextureHandle& output);
         // TextureHandle ComputeAverageWhite(CameraUnit& camera);
         void PerformPostProcessing(CameraUnit& camera);
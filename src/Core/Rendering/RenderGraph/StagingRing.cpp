@@ -0,0 +1,121 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "StagingRing.h"
+#include "Core/Macro/Macro.h"
+
+namespace MxEngine
+{
+    size_t StagingRing::GetTail() const
+    {
+        return this->blocks.empty() ? this->head : this->blocks.front().Offset;
+    }
+
+    void StagingRing::Init(size_t capacity)
+    {
+        this->capacity = capacity;
+        this->Reset();
+    }
+
+    size_t StagingRing::Allocate(size_t byteSize, size_t alignment)
+    {
+        MX_ASSERT(byteSize <= this->capacity);
+        if (this->blocks.empty()) this->head = 0;
+
+        size_t tail = this->GetTail();
+        size_t offset = (this->head + alignment - 1) / alignment * alignment;
+        if (this->blocks.empty() || this->head > tail)
+        {
+            // free space is at the end of memory and before the tail, range cannot be split between them
+            if (offset + byteSize > this->capacity)
+            {
+                if (byteSize > tail && !this->blocks.empty()) return InvalidOffset;
+                offset = 0;
+            }
+        }
+        else if (offset + byteSize > tail)
+        {
+            // head has wrapped and reached the tail
+            return InvalidOffset;
+        }
+
+        this->blocks.push_back(Block{ offset, byteSize, 0, false });
+        this->head = offset + byteSize;
+        this->usedBytes += byteSize;
+        return offset;
+    }
+
+    void StagingRing::MarkSubmitted(size_t offset, uint64_t frame)
+    {
+        for (auto& block : this->blocks)
+        {
+            if (block.Offset == offset && !block.IsSubmitted)
+            {
+                block.IsSubmitted = true;
+                block.RetireFrame = frame;
+                return;
+            }
+        }
+    }
+
+    void StagingRing::Retire(uint64_t completedFrame)
+    {
+        // ranges may be submitted out of order, so only the continuous sequence of completed ranges at the tail can be released
+        while (!this->blocks.empty())
+        {
+            const auto& block = this->blocks.front();
+            if (!block.IsSubmitted || block.RetireFrame > completedFrame) break;
+
+            this->usedBytes -= block.Size;
+            this->blocks.pop_front();
+        }
+    }
+
+    void StagingRing::Reset()
+    {
+        this->blocks.clear();
+        this->head = 0;
+        this->usedBytes = 0;
+    }
+
+    size_t StagingRing::GetCapacity() const
+    {
+        return this->capacity;
+    }
+
+    size_t StagingRing::GetUsedBytes() const
+    {
+        return this->usedBytes;
+    }
+
+    size_t StagingRing::GetAllocationCount() const
+    {
+        return this->blocks.size();
+    }
+}
@@ -0,0 +1,84 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include <deque>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+
+namespace MxEngine
+{
+    /*!
+    staging ring keeps track of ranges inside persistent upload memory. Ranges are allocated one after another and released when
+    GPU finishes the frame in which they were submitted. It does not touch memory itself, so its logic can be used without GPU device
+    */
+    class StagingRing
+    {
+        struct Block
+        {
+            size_t Offset = 0;
+            size_t Size = 0;
+            uint64_t RetireFrame = 0;
+            bool IsSubmitted = false;
+        };
+
+        std::deque<Block> blocks;
+        size_t capacity = 0;
+        size_t head = 0;
+        size_t usedBytes = 0;
+
+        size_t GetTail() const;
+    public:
+        constexpr static size_t InvalidOffset = std::numeric_limits<size_t>::max();
+
+        void Init(size_t capacity);
+        /*!
+        allocates range in ring
+        \param byteSize size of range in bytes, must not exceed ring capacity
+        \param alignment alignment of range offset
+        \returns offset of range or InvalidOffset if ring has no free space for it
+        */
+        size_t Allocate(size_t byteSize, size_t alignment);
+        /*!
+        marks range as submitted as part of frame. Range is released by Retire when that frame is completed
+        */
+        void MarkSubmitted(size_t offset, uint64_t frame);
+        /*!
+        releases all submitted ranges which frame is not greater than completedFrame
+        */
+        void Retire(uint64_t completedFrame);
+        void Reset();
+
+        size_t GetCapacity() const;
+        size_t GetUsedBytes() const;
+        size_t GetAllocationCount() const;
+    };
+}
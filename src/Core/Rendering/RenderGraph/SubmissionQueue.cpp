@@ -26,91 +26,501 @@
 // OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+
 #include "SubmissionQueue.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+#include "Utilities/Math/Math.h"
+#include "Core/Macro/Macro.h"
+
+#include <algorithm>
+#include <cstring>
 
 namespace MxEngine
 {
+    using namespace VulkanAbstractionLayer;
+
+    class VulkanStagingDevice : public StagingDevice
+    {
+        UniqueRef<Buffer> stagingBuffer;
+    public:
+        virtual uint8_t* CreateStagingMemory(size_t byteSize) override
+        {
+            this->stagingBuffer = MakeUnique<Buffer>(byteSize, BufferUsage::TRANSFER_SOURCE | BufferUsage::TRANSFER_DESTINATION, MemoryUsage::CPU_TO_GPU);
+            return this->stagingBuffer->MapMemory();
+        }
+
+        virtual size_t GetFramesInFlight() const override
+        {
+            return (size_t)GetCurrentVulkanContext().GetVirtualFrameCount();
+        }
+
+        virtual void RecordUpload(SubmissionTarget target, size_t stageOffset, const Buffer& buffer, size_t offset, size_t byteSize) override
+        {
+            auto& commandBuffer = target == SubmissionTarget::FRAME ? GetCurrentVulkanContext().GetCurrentCommandBuffer() : this->GetImmediateCommandBuffer();
+            commandBuffer.CopyBuffer(
+                BufferInfo{ *this->stagingBuffer, (uint32_t)stageOffset },
+                BufferInfo{ buffer, (uint32_t)offset },
+                byteSize
+            );
+        }
+
+        virtual void RecordReadback(SubmissionTarget target, const Buffer& buffer, size_t offset, size_t stageOffset, size_t byteSize) override
+        {
+            auto& commandBuffer = target == SubmissionTarget::FRAME ? GetCurrentVulkanContext().GetCurrentCommandBuffer() : this->GetImmediateCommandBuffer();
+            commandBuffer.CopyBuffer(
+                BufferInfo{ buffer, (uint32_t)offset },
+                BufferInfo{ *this->stagingBuffer, (uint32_t)stageOffset },
+                byteSize
+            );
+        }
+
+        virtual void RecordCopy(SubmissionTarget target, const Buffer& source, size_t sourceOffset, const Buffer& destination, size_t destinationOffset, size_t byteSize) override
+        {
+            auto& commandBuffer = target == SubmissionTarget::FRAME ? GetCurrentVulkanContext().GetCurrentCommandBuffer() : this->GetImmediateCommandBuffer();
+            commandBuffer.CopyBuffer(BufferInfo{ source, (uint32_t)sourceOffset }, BufferInfo{ destination, (uint32_t)destinationOffset }, byteSize);
+        }
+
+        virtual void RecordFrameBarrier() override
+        {
+            this->stagingBuffer->FlushMemory();
+
+            vk::MemoryBarrier barrier;
+            barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+                   .setDstAccessMask(vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite);
+            GetCurrentVulkanContext().GetCurrentCommandBuffer().GetNativeHandle().pipelineBarrier(
+                vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, { }, barrier, { }, { });
+        }
+
+        virtual void RecordFrameTransferBarrier() override
+        {
+            // moved data may be written by shaders of previous frames, for example by particle simulation
+            vk::MemoryBarrier barrier;
+            barrier.setSrcAccessMask(vk::AccessFlagBits::eMemoryWrite)
+                   .setDstAccessMask(vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite);
+            GetCurrentVulkanContext().GetCurrentCommandBuffer().GetNativeHandle().pipelineBarrier(
+                vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, { }, barrier, { }, { });
+        }
+
+        virtual void RecordImmediateBarrier() override
+        {
+            vk::MemoryBarrier barrier;
+            barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+                   .setDstAccessMask(vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite);
+            this->GetImmediateCommandBuffer().GetNativeHandle().pipelineBarrier(
+                vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, { }, barrier, { }, { });
+        }
+
+        virtual void BeginImmediate() override
+        {
+            this->GetImmediateCommandBuffer().Begin();
+        }
+
+        virtual void EndImmediate() override
+        {
+            this->GetImmediateCommandBuffer().End();
+        }
+
+        virtual void SubmitImmediate() override
+        {
+            auto& commandBuffer = this->GetImmediateCommandBuffer();
+            this->stagingBuffer->FlushMemory();
+            commandBuffer.End();
+            GetCurrentVulkanContext().SubmitCommandsImmediate(commandBuffer);
+            commandBuffer.Begin();
+        }
+
+        CommandBuffer& GetImmediateCommandBuffer()
+        {
+            return GetCurrentVulkanContext().GetImmediateCommandBuffer();
+        }
+
+        virtual ~VulkanStagingDevice()
+        {
+            if (this->stagingBuffer != nullptr)
+                this->stagingBuffer->UnmapMemory();
+        }
+    };
+
+    void SubmissionQueue::Init()
+    {
+        impl = new SubmissionQueueImpl();
+    }
+
+    void SubmissionQueue::Destroy()
+    {
+        delete impl;
+        impl = nullptr;
+    }
+
+    SubmissionQueueImpl* SubmissionQueue::GetImpl()
+    {
+        return impl;
+    }
+
+    void SubmissionQueue::Clone(SubmissionQueueImpl* other)
+    {
+        impl = other;
+    }
+
     void SubmissionQueue::StartQueue()
     {
-        SubmissionQueue::GetCommandBuffer().Begin();
+        SubmissionQueue::StartQueue(MakeUnique<VulkanStagingDevice>());
     }
 
-    void SubmissionQueue::EndQueue()
+    void SubmissionQueue::StartQueue(UniqueRef<StagingDevice> device)
     {
-        auto& commandBuffer = SubmissionQueue::GetCommandBuffer();
-        auto& stageBuffer = SubmissionQueue::GetStageBuffer();
+        impl->Device = std::move(device);
+        impl->FramesInFlight = Max(impl->Device->GetFramesInFlight(), (size_t)1);
+        impl->StagingMemory = impl->Device->CreateStagingMemory(impl->StagingCapacity);
+        impl->Ring.Init(impl->StagingCapacity);
+        impl->Device->BeginImmediate();
+    }
 
-        stageBuffer.Flush();
-        commandBuffer.End();
+    void SubmissionQueue::EndQueue()
+    {
+        SubmissionQueue::FlushQueue();
+        impl->Device->EndImmediate();
 
-        VulkanAbstractionLayer::GetCurrentVulkanContext().SubmitCommandsImmediate(commandBuffer);
+        impl->Ring.Reset();
+        impl->StagingMemory = nullptr;
+        impl->Device.reset();
     }
 
     VulkanAbstractionLayer::CommandBuffer& SubmissionQueue::GetCommandBuffer()
     {
-        return VulkanAbstractionLayer::GetCurrentVulkanContext().GetImmediateCommandBuffer();
+        return GetCurrentVulkanContext().GetImmediateCommandBuffer();
     }
 
-    VulkanAbstractionLayer::StageBuffer& SubmissionQueue::GetStageBuffer()
+    static bool IsUploadOrderedAfter(const SubmissionQueueImpl::PendingUpload& u1, const SubmissionQueueImpl::PendingUpload& u2)
     {
-        return VulkanAbstractionLayer::GetCurrentVulkanContext().GetCurrentStageBuffer();
+        // heap puts the greatest element first, so upload which must be submitted later is considered less
+        if (u1.Priority != u2.Priority) return u1.Priority > u2.Priority;
+        return u1.Sequence > u2.Sequence;
     }
 
-    void SubmissionQueue::RecordAllocation(size_t byteSize)
+    size_t SubmissionQueue::RecordUploads(SubmissionTarget target, size_t byteBudget)
     {
-        auto& stageBuffer = SubmissionQueue::GetStageBuffer();
-        if (stageBuffer.GetCurrentOffset() + byteSize > stageBuffer.GetBuffer().GetByteSize())
+        size_t recordedBytes = 0;
+        auto& pending = impl->Pending;
+        while (!pending.empty())
         {
-            SubmissionQueue::FlushQueue();
+            const auto& upload = pending.front();
+            if (upload.Priority != UploadPriority::HIGH && recordedBytes + upload.Size > byteBudget)
+            {
+                impl->Stats.DeferredUploadCount += pending.size();
+                break;
+            }
+
+            impl->Device->RecordUpload(target, upload.StageOffset, *upload.Target, upload.TargetOffset, upload.Size);
+            if (target == SubmissionTarget::FRAME)
+                impl->Ring.MarkSubmitted(upload.StageOffset, impl->FrameIndex);
+            else
+                impl->ImmediateRanges.push_back(upload.StageOffset);
+            recordedBytes += upload.Size;
+            impl->Stats.UploadedBytes += upload.Size;
+            impl->Stats.PendingBytes -= upload.Size;
+
+            std::pop_heap(pending.begin(), pending.end(), IsUploadOrderedAfter);
+            pending.pop_back();
+        }
+        return recordedBytes;
+    }
+
+    void SubmissionQueue::RecordReadbacks(SubmissionTarget target)
+    {
+        for (auto& readback : impl->Readbacks)
+        {
+            if (readback.Frame != 0 || readback.IsImmediate) continue;
+
+            impl->Device->RecordReadback(target, *readback.Source, readback.SourceOffset, readback.StageOffset, readback.Size);
+            readback.Frame = impl->FrameIndex;
+            readback.IsImmediate = target == SubmissionTarget::IMMEDIATE;
+        }
+    }
+
+    void SubmissionQueue::CompleteReadbacks()
+    {
+        auto& readbacks = impl->Readbacks;
+        for (size_t i = 0; i < readbacks.size();)
+        {
+            auto& readback = readbacks[i];
+            bool isRecorded = readback.Frame != 0 || readback.IsImmediate;
+            if (!isRecorded || (!readback.IsImmediate && readback.Frame > impl->CompletedFrame))
+            {
+                i++;
+                continue;
+            }
+
+            readback.OnComplete(impl->StagingMemory + readback.StageOffset, readback.Size);
+            impl->Ring.MarkSubmitted(readback.StageOffset, impl->CompletedFrame);
+            impl->Stats.ReadbackCount++;
+            impl->Stats.ReadbackBytes += readback.Size;
+
+            // callbacks are independent, so order of readbacks can be changed
+            std::swap(readback, readbacks.back());
+            readbacks.pop_back();
+        }
+    }
+
+    void SubmissionQueue::RecordRelocations()
+    {
+        if (impl->Relocations.empty()) return;
+
+        // source may still be written by transfers recorded earlier, and uploads recorded next must not be overwritten by copy
+        impl->Device->RecordImmediateBarrier();
+        for (const auto& relocation : impl->Relocations)
+            impl->Device->RecordCopy(SubmissionTarget::IMMEDIATE, *relocation.Source, 0, *relocation.Destination, 0, relocation.Size);
+        impl->Device->RecordImmediateBarrier();
+        impl->Relocations.clear();
+    }
+
+    static bool IsRangeOverlapped(size_t offset1, size_t size1, size_t offset2, size_t size2)
+    {
+        return offset1 < offset2 + size2 && offset2 < offset1 + size1;
+    }
+
+    static bool IsMoveDependent(const SubmissionQueueImpl::PendingMove& move, const SubmissionQueueImpl::PendingMove& previous)
+    {
+        return move.Target == previous.Target && (
+            IsRangeOverlapped(move.From, move.Size, previous.To, previous.Size) ||
+            IsRangeOverlapped(move.To, move.Size, previous.From, previous.Size) ||
+            IsRangeOverlapped(move.To, move.Size, previous.To, previous.Size));
+    }
+
+    void SubmissionQueue::RecordMoves(SubmissionTarget target)
+    {
+        if (impl->Moves.empty()) return;
+
+        auto recordBarrier = [target]()
+        {
+            if (target == SubmissionTarget::FRAME)
+                impl->Device->RecordFrameTransferBarrier();
+            else
+                impl->Device->RecordImmediateBarrier();
+        };
+
+        recordBarrier();
+        size_t barrierIndex = 0;
+        for (size_t i = 0; i < impl->Moves.size(); i++)
+        {
+            // moves of one defragmentation pass are independent, but later pass may move data into range freed by earlier one
+            const auto& move = impl->Moves[i];
+            bool isDependent = std::any_of(impl->Moves.begin() + barrierIndex, impl->Moves.begin() + i,
+                [&move](const auto& previous) { return IsMoveDependent(move, previous); });
+            if (isDependent)
+            {
+                recordBarrier();
+                barrierIndex = i;
+            }
+            impl->Device->RecordCopy(target, *move.Target, move.From, *move.Target, move.To, move.Size);
         }
+
+        // uploads recorded next may write into moved ranges, and frame commands read them
+        if (target == SubmissionTarget::FRAME)
+            impl->Device->RecordFrameBarrier();
+        else
+            impl->Device->RecordImmediateBarrier();
+        impl->Moves.clear();
+    }
+
+    void SubmissionQueue::RecordPendingUploads()
+    {
+        SubmissionQueue::RecordRelocations();
+        SubmissionQueue::RecordMoves(SubmissionTarget::IMMEDIATE);
+        SubmissionQueue::RecordUploads(SubmissionTarget::IMMEDIATE, std::numeric_limits<size_t>::max());
     }
 
     void SubmissionQueue::FlushQueue()
     {
-        auto& commandBuffer = SubmissionQueue::GetCommandBuffer();
-        auto& stageBuffer = SubmissionQueue::GetStageBuffer();
+        MAKE_SCOPE_PROFILER("SubmissionQueue::FlushQueue()");
+        SubmissionQueue::RecordPendingUploads();
+        SubmissionQueue::RecordReadbacks(SubmissionTarget::IMMEDIATE);
+        impl->Device->SubmitImmediate();
 
-        stageBuffer.Flush();
-        commandBuffer.End();
+        // immediate submission waits for all work which was submitted before it, but frame which is still recorded is not part of it
+        impl->CompletedFrame = Max(impl->CompletedFrame, impl->SubmittedFrame);
+        for (size_t stageOffset : impl->ImmediateRanges)
+            impl->Ring.MarkSubmitted(stageOffset, impl->CompletedFrame);
+        impl->ImmediateRanges.clear();
+        SubmissionQueue::CompleteReadbacks();
+        impl->Ring.Retire(impl->CompletedFrame);
+        impl->Stats.FlushCount++;
+    }
+
+    void SubmissionQueue::SubmitFrameUploads()
+    {
+        MAKE_SCOPE_PROFILER("SubmissionQueue::SubmitFrameUploads()");
+        // frame uploads may target relocated buffers, so relocations must be completed before frame command buffer is submitted.
+        // Moves must not be reordered with uploads which are already recorded into immediate command buffer
+        if (!impl->Relocations.empty() || (!impl->Moves.empty() && !impl->ImmediateRanges.empty())) SubmissionQueue::FlushQueue();
 
-        VulkanAbstractionLayer::GetCurrentVulkanContext().SubmitCommandsImmediate(commandBuffer);
+        // beginning of frame waits for the frame which used the same virtual frame resources
+        if (impl->FrameIndex > impl->FramesInFlight)
+            impl->CompletedFrame = Max(impl->CompletedFrame, impl->FrameIndex - impl->FramesInFlight);
+        SubmissionQueue::CompleteReadbacks();
+        impl->Ring.Retire(impl->CompletedFrame);
 
-        commandBuffer.Begin();
-        stageBuffer.Reset();
+        SubmissionQueue::RecordMoves(SubmissionTarget::FRAME);
+        size_t recordedBytes = SubmissionQueue::RecordUploads(SubmissionTarget::FRAME, impl->FrameUploadBudget);
+        if (recordedBytes != 0) impl->Device->RecordFrameBarrier();
+        SubmissionQueue::RecordReadbacks(SubmissionTarget::FRAME);
+        impl->FrameIndex++;
     }
 
-    void SubmissionQueue::CopyToBuffer(const uint8_t* data, size_t byteSize, const VulkanAbstractionLayer::Buffer& buffer, size_t offset)
+    void SubmissionQueue::OnFrameSubmitted()
     {
-        SubmissionQueue::RecordAllocation(byteSize);
-        auto& stageBuffer = SubmissionQueue::GetStageBuffer();
-        auto& commandBuffer = SubmissionQueue::GetCommandBuffer();
+        impl->SubmittedFrame = impl->FrameIndex - 1;
+    }
+
+    size_t SubmissionQueue::AllocateStaging(size_t byteSize)
+    {
+        constexpr size_t StagingAlignment = 16;
+        size_t offset = impl->Ring.Allocate(byteSize, StagingAlignment);
+        if (offset == StagingRing::InvalidOffset)
+        {
+            // staging memory is exhausted by frames in flight, so CPU has to wait for GPU
+            impl->Stats.StallCount++;
+            MXLOG_DEBUG("MxEngine::SubmissionQueue", MxFormat("staging memory is full, waiting for GPU ({0} bytes in use)", impl->Ring.GetUsedBytes()));
+            SubmissionQueue::FlushQueue();
+            offset = impl->Ring.Allocate(byteSize, StagingAlignment);
+        }
+        MX_ASSERT(offset != StagingRing::InvalidOffset);
+        return offset;
+    }
+
+    void SubmissionQueue::CopyToBuffer(const uint8_t* data, size_t byteSize, const VulkanAbstractionLayer::Buffer& buffer, size_t offset, UploadPriority priority)
+    {
+        // large uploads are split, so that they do not occupy the whole staging memory
+        size_t maxChunkSize = impl->Ring.GetCapacity() / 4;
+        for (size_t uploaded = 0; uploaded < byteSize; uploaded += maxChunkSize)
+        {
+            size_t chunkSize = Min(byteSize - uploaded, maxChunkSize);
+            size_t stageOffset = SubmissionQueue::AllocateStaging(chunkSize);
+            std::memcpy(impl->StagingMemory + stageOffset, data + uploaded, chunkSize);
 
-        auto stageAlloc = stageBuffer.Submit(data, byteSize);
+            impl->Pending.push_back(SubmissionQueueImpl::PendingUpload{ stageOffset, chunkSize, &buffer, offset + uploaded, impl->UploadSequence++, priority });
+            std::push_heap(impl->Pending.begin(), impl->Pending.end(), IsUploadOrderedAfter);
+            impl->Stats.PendingBytes += chunkSize;
+        }
+    }
+
+    void SubmissionQueue::CopyBuffer(const VulkanAbstractionLayer::Buffer& source, size_t sourceOffset, const VulkanAbstractionLayer::Buffer& destination, size_t destinationOffset, size_t byteSize)
+    {
+        impl->Device->RecordCopy(SubmissionTarget::IMMEDIATE, source, sourceOffset, destination, destinationOffset, byteSize);
+    }
 
-        commandBuffer.CopyBuffer(
-            VulkanAbstractionLayer::BufferInfo{ stageBuffer.GetBuffer(), stageAlloc.Offset },
-            VulkanAbstractionLayer::BufferInfo{ buffer, (uint32_t)offset }, 
-            stageAlloc.Size
-        );
+    static bool IsInsideRange(size_t offset, size_t size, size_t rangeOffset, size_t rangeSize)
+    {
+        return offset >= rangeOffset && offset + size <= rangeOffset + rangeSize;
+    }
+
+    void SubmissionQueue::MoveBufferRange(const VulkanAbstractionLayer::Buffer& buffer, size_t sourceOffset, size_t destinationOffset, size_t byteSize)
+    {
+        MX_ASSERT(sourceOffset + byteSize <= destinationOffset || destinationOffset + byteSize <= sourceOffset);
+
+        // copy is recorded before pending uploads and readbacks, so they must already use the new place of data
+        for (auto& upload : impl->Pending)
+        {
+            if (upload.Target == &buffer && IsInsideRange(upload.TargetOffset, upload.Size, sourceOffset, byteSize))
+                upload.TargetOffset = upload.TargetOffset - sourceOffset + destinationOffset;
+        }
+        for (auto& readback : impl->Readbacks)
+        {
+            if (readback.Frame == 0 && !readback.IsImmediate && readback.Source == &buffer && IsInsideRange(readback.SourceOffset, readback.Size, sourceOffset, byteSize))
+                readback.SourceOffset = readback.SourceOffset - sourceOffset + destinationOffset;
+        }
+        impl->Moves.push_back(SubmissionQueueImpl::PendingMove{ &buffer, sourceOffset, destinationOffset, byteSize });
+    }
+
+    size_t SubmissionQueue::RelocateBuffer(const VulkanAbstractionLayer::Buffer& source, const VulkanAbstractionLayer::Buffer& destination, size_t byteSize)
+    {
+        for (auto& upload : impl->Pending)
+        {
+            if (upload.Target == &source) upload.Target = &destination;
+        }
+        for (auto& readback : impl->Readbacks)
+        {
+            if (readback.Frame == 0 && !readback.IsImmediate && readback.Source == &source) readback.Source = &destination;
+        }
+
+        // moves are recorded after relocations, so they are performed inside the new storage
+        for (auto& move : impl->Moves)
+        {
+            if (move.Target == &source) move.Target = &destination;
+        }
+
+        // source was not written since previous relocation, so copying it again would only repeat the previous copy
+        for (auto& relocation : impl->Relocations)
+        {
+            if (relocation.Destination == &source)
+            {
+                relocation.Destination = &destination;
+                return 0;
+            }
+        }
+        impl->Relocations.push_back(SubmissionQueueImpl::PendingRelocation{ &source, &destination, byteSize });
+        return byteSize;
     }
 
     void SubmissionQueue::CopyFromBuffer(uint8_t* data, size_t byteSize, const VulkanAbstractionLayer::Buffer& buffer, size_t offset)
     {
-        SubmissionQueue::RecordAllocation(byteSize);
-        auto& stageBuffer = SubmissionQueue::GetStageBuffer();
-        auto& commandBuffer = SubmissionQueue::GetCommandBuffer();
+        // pending uploads to the buffer must land before it is read
+        SubmissionQueue::RecordPendingUploads();
+
+        size_t maxChunkSize = impl->Ring.GetCapacity() / 4;
+        for (size_t copied = 0; copied < byteSize; copied += maxChunkSize)
+        {
+            size_t chunkSize = Min(byteSize - copied, maxChunkSize);
+            size_t stageOffset = SubmissionQueue::AllocateStaging(chunkSize);
+            impl->Device->RecordReadback(SubmissionTarget::IMMEDIATE, buffer, offset + copied, stageOffset, chunkSize);
+            SubmissionQueue::FlushQueue();
+
+            std::memcpy(data + copied, impl->StagingMemory + stageOffset, chunkSize);
+            impl->Ring.MarkSubmitted(stageOffset, impl->CompletedFrame);
+            impl->Ring.Retire(impl->CompletedFrame);
+        }
+    }
+
+    void SubmissionQueue::CopyFromBufferAsync(size_t byteSize, const VulkanAbstractionLayer::Buffer& buffer, size_t offset, ReadbackCallback callback)
+    {
+        if (byteSize == 0)
+        {
+            callback(impl->StagingMemory, 0);
+            return;
+        }
+
+        // range which does not fit into ring chunk is read synchronously
+        if (byteSize > impl->Ring.GetCapacity() / 4)
+        {
+            MxVector<uint8_t> data(byteSize);
+            SubmissionQueue::CopyFromBuffer(data.data(), byteSize, buffer, offset);
+            callback(data.data(), byteSize);
+            return;
+        }
 
-        auto stageAlloc = stageBuffer.Submit(nullptr, byteSize);
+        size_t stageOffset = SubmissionQueue::AllocateStaging(byteSize);
+        impl->Readbacks.push_back(SubmissionQueueImpl::PendingReadback{ stageOffset, byteSize, &buffer, offset, 0, false, std::move(callback) });
+    }
 
-        commandBuffer.CopyBuffer(
-            VulkanAbstractionLayer::BufferInfo{ buffer, (uint32_t)offset },
-            VulkanAbstractionLayer::BufferInfo{ stageBuffer.GetBuffer(), stageAlloc.Offset },
-            stageAlloc.Size
-        );
+    void SubmissionQueue::SetFrameUploadBudget(size_t bytesPerFrame)
+    {
+        impl->FrameUploadBudget = bytesPerFrame;
+    }
 
-        SubmissionQueue::FlushQueue();
+    size_t SubmissionQueue::GetFrameUploadBudget()
+    {
+        return impl->FrameUploadBudget;
+    }
 
-        uint8_t* mapped = stageBuffer.GetBuffer().MapMemory();
-        std::memcpy(data, mapped, byteSize);
+    size_t SubmissionQueue::GetFramesInFlight()
+    {
+        return impl->FramesInFlight;
+    }
+
+    const SubmissionQueueStats& SubmissionQueue::GetStats()
+    {
+        return impl->Stats;
     }
-}
\ No newline at end of file
+}
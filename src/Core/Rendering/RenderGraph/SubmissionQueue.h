@@ -29,39 +29,232 @@
 #pragma once
 
 #include <VulkanAbstractionLayer/VulkanContext.h>
+#include "Core/Rendering/RenderGraph/StagingRing.h"
+#include "Utilities/Memory/Memory.h"
+#include "Utilities/STL/MxVector.h"
+#include "Utilities/STL/MxFunction.h"
 
 namespace MxEngine
 {
+    enum class UploadPriority : uint8_t
+    {
+        HIGH,
+        NORMAL,
+        LOW,
+    };
+
+    enum class SubmissionTarget : uint8_t
+    {
+        IMMEDIATE,
+        FRAME,
+    };
+
+    /*!
+    device which owns staging memory and records transfer commands for submission queue.
+    Queue logic only talks to device through this interface, so it can be replaced by a fake one which does not use GPU
+    */
+    class StagingDevice
+    {
+    public:
+        virtual ~StagingDevice() = default;
+
+        virtual uint8_t* CreateStagingMemory(size_t byteSize) = 0;
+        // number of frames GPU may process at once, frame resources are reused only after this number of frames
+        virtual size_t GetFramesInFlight() const = 0;
+        virtual void RecordUpload(SubmissionTarget target, size_t stageOffset, const VulkanAbstractionLayer::Buffer& buffer, size_t offset, size_t byteSize) = 0;
+        virtual void RecordReadback(SubmissionTarget target, const VulkanAbstractionLayer::Buffer& buffer, size_t offset, size_t stageOffset, size_t byteSize) = 0;
+        virtual void RecordCopy(SubmissionTarget target, const VulkanAbstractionLayer::Buffer& source, size_t sourceOffset, const VulkanAbstractionLayer::Buffer& destination, size_t destinationOffset, size_t byteSize) = 0;
+        // makes uploads recorded into frame command buffer visible for the rest of the frame
+        virtual void RecordFrameBarrier() = 0;
+        // makes writes of previously submitted work visible to transfers recorded next into frame command buffer
+        virtual void RecordFrameTransferBarrier() = 0;
+        // makes transfers recorded into immediate command buffer visible to the following transfer commands
+        virtual void RecordImmediateBarrier() = 0;
+        virtual void BeginImmediate() = 0;
+        virtual void EndImmediate() = 0;
+        // submits immediate commands and waits for them. All previously submitted frames are completed after it returns
+        virtual void SubmitImmediate() = 0;
+    };
+
+    struct SubmissionQueueStats
+    {
+        // number of times recording waited for GPU because staging memory was exhausted
+        size_t StallCount = 0;
+        size_t FlushCount = 0;
+        size_t UploadedBytes = 0;
+        // uploads of NORMAL and LOW priority which were moved to next frames because of upload budget
+        size_t DeferredUploadCount = 0;
+        size_t PendingBytes = 0;
+        size_t ReadbackCount = 0;
+        size_t ReadbackBytes = 0;
+    };
+
+    using ReadbackCallback = MxFunction<void(const uint8_t* data, size_t byteSize)>;
+
+    struct SubmissionQueueImpl
+    {
+        struct PendingUpload
+        {
+            size_t StageOffset;
+            size_t Size;
+            const VulkanAbstractionLayer::Buffer* Target;
+            size_t TargetOffset;
+            uint64_t Sequence;
+            UploadPriority Priority;
+        };
+
+        struct PendingRelocation
+        {
+            const VulkanAbstractionLayer::Buffer* Source;
+            const VulkanAbstractionLayer::Buffer* Destination;
+            size_t Size;
+        };
+
+        struct PendingMove
+        {
+            const VulkanAbstractionLayer::Buffer* Target;
+            size_t From;
+            size_t To;
+            size_t Size;
+        };
+
+        struct PendingReadback
+        {
+            size_t StageOffset;
+            size_t Size;
+            const VulkanAbstractionLayer::Buffer* Source;
+            size_t SourceOffset;
+            // frame in which readback was recorded, zero if it is not recorded yet
+            uint64_t Frame;
+            bool IsImmediate;
+            ReadbackCallback OnComplete;
+        };
+
+        UniqueRef<StagingDevice> Device;
+        StagingRing Ring;
+        uint8_t* StagingMemory = nullptr;
+        // pending uploads form a heap ordered by priority, uploads of the same priority keep their order
+        MxVector<PendingUpload> Pending;
+        // staging ranges recorded into immediate command buffer, they are released after it is submitted
+        MxVector<size_t> ImmediateRanges;
+        MxVector<PendingReadback> Readbacks;
+        // buffer copies which must be recorded before any pending upload
+        MxVector<PendingRelocation> Relocations;
+        // copies of ranges inside buffers, recorded before pending uploads into whichever command buffer is submitted next
+        MxVector<PendingMove> Moves;
+        uint64_t FrameIndex = 1;
+        // last frame which command buffer was submitted to GPU
+        uint64_t SubmittedFrame = 0;
+        uint64_t CompletedFrame = 0;
+        uint64_t UploadSequence = 0;
+        size_t FramesInFlight = 1;
+        size_t StagingCapacity = 64 * MB;
+        size_t FrameUploadBudget = 16 * MB;
+        SubmissionQueueStats Stats;
+    };
+
+    /*!
+    submission queue transfers data between CPU and GPU buffers. Uploads are copied into persistent staging ring and submitted as part
+    of frame command buffer, so staging memory of frame N is reused only after GPU completes it, while frame N + 1 is recorded.
+    Uploads of HIGH priority are always submitted in the frame they were recorded in. Uploads of lower priority are submitted
+    within per-frame byte budget. Uploads to the same range with different priorities are not ordered
+    */
     class SubmissionQueue
     {
+        inline static SubmissionQueueImpl* impl = nullptr;
+
+        static size_t RecordUploads(SubmissionTarget target, size_t byteBudget);
+        static size_t AllocateStaging(size_t byteSize);
+        static void RecordReadbacks(SubmissionTarget target);
+        static void RecordRelocations();
+        static void RecordMoves(SubmissionTarget target);
+        static void CompleteReadbacks();
     public:
+        static void Init();
+        static void Destroy();
+        static SubmissionQueueImpl* GetImpl();
+        static void Clone(SubmissionQueueImpl* other);
+
         static void StartQueue();
+        static void StartQueue(UniqueRef<StagingDevice> device);
         static void EndQueue();
         static VulkanAbstractionLayer::CommandBuffer& GetCommandBuffer();
-        static VulkanAbstractionLayer::StageBuffer& GetStageBuffer();
-        static void RecordAllocation(size_t byteSize);
+        /*!
+        records all pending uploads into immediate command buffer. Must be called before recording commands which depend on them
+        */
+        static void RecordPendingUploads();
+        /*!
+        records copy between GPU buffers into immediate command buffer. Copy is executed when queue is flushed
+        */
+        static void CopyBuffer(const VulkanAbstractionLayer::Buffer& source, size_t sourceOffset, const VulkanAbstractionLayer::Buffer& destination, size_t destinationOffset, size_t byteSize);
+        /*!
+        schedules copy of range to another place of the same buffer without waiting for GPU. Copy is recorded into the next frame command buffer,
+        or into immediate command buffer if queue is flushed earlier. Pending uploads and readbacks of the range are redirected to its new place
+        \param buffer buffer in which range is moved. It must stay alive until copy is submitted
+        \param sourceOffset current offset of range in bytes
+        \param destinationOffset new offset of range in bytes. New range must not overlap the current one
+        \param byteSize size of range in bytes
+        */
+        static void MoveBufferRange(const VulkanAbstractionLayer::Buffer& buffer, size_t sourceOffset, size_t destinationOffset, size_t byteSize);
+        /*!
+        submits all pending uploads and immediate commands, and waits for GPU to complete them
+        */
         static void FlushQueue();
+        /*!
+        records pending uploads into frame command buffer within upload budget and retires staging memory of completed frames.
+        Called once per frame before render graph is executed
+        */
+        static void SubmitFrameUploads();
+        /*!
+        notifies queue that frame command buffer, into which last SubmitFrameUploads recorded, was submitted to GPU
+        */
+        static void OnFrameSubmitted();
+
+        static void SetFrameUploadBudget(size_t bytesPerFrame);
+        static size_t GetFrameUploadBudget();
+        static size_t GetFramesInFlight();
+        static const SubmissionQueueStats& GetStats();
 
-        static void CopyToBuffer(const uint8_t* data, size_t byteSize, const VulkanAbstractionLayer::Buffer& buffer, size_t offset);
+        static void CopyToBuffer(const uint8_t* data, size_t byteSize, const VulkanAbstractionLayer::Buffer& buffer, size_t offset, UploadPriority priority = UploadPriority::HIGH);
 
         template<typename T>
-        static void CopyToBuffer(const T* data, const VulkanAbstractionLayer::Buffer& buffer, size_t offset)
+        static void CopyToBuffer(const T* data, const VulkanAbstractionLayer::Buffer& buffer, size_t offset, UploadPriority priority = UploadPriority::HIGH)
         {
-            SubmissionQueue::CopyToBuffer((const uint8_t*)data, sizeof(T), buffer, offset);
+            SubmissionQueue::CopyToBuffer((const uint8_t*)data, sizeof(T), buffer, offset, priority);
         }
         
         template<typename T>
-        static void CopyToBuffer(ArrayView<const T> data, const VulkanAbstractionLayer::Buffer& buffer, size_t offset)
+        static void CopyToBuffer(ArrayView<const T> data, const VulkanAbstractionLayer::Buffer& buffer, size_t offset, UploadPriority priority = UploadPriority::HIGH)
         {
-            SubmissionQueue::CopyToBuffer((const uint8_t*)data.data(), data.size() * sizeof(T), buffer, offset);
+            SubmissionQueue::CopyToBuffer((const uint8_t*)data.data(), data.size() * sizeof(T), buffer, offset, priority);
         }
 
         template<typename T>
-        static void CopyToBuffer(ArrayView<T> data, const VulkanAbstractionLayer::Buffer& buffer, size_t offset)
+        static void CopyToBuffer(ArrayView<T> data, const VulkanAbstractionLayer::Buffer& buffer, size_t offset, UploadPriority priority = UploadPriority::HIGH)
         {
-            SubmissionQueue::CopyToBuffer((const uint8_t*)data.data(), data.size() * sizeof(T), buffer, offset);
+            SubmissionQueue::CopyToBuffer((const uint8_t*)data.data(), data.size() * sizeof(T), buffer, offset, priority);
         }
 
+        /*!
+        schedules copy of buffer contents into the buffer which replaces it. Pending uploads and readbacks of source are redirected to destination,
+        and copy is recorded before them. If source is itself destination of a pending relocation, both are merged into one copy from the original buffer.
+        Pending moves inside source are redirected to destination
+        \param source replaced buffer. It must stay alive until queue is flushed
+        \param destination new buffer, at least byteSize large
+        \param byteSize size of data to copy, starting from offset 0
+        \returns number of bytes which will be copied because of this call, zero if relocation was merged
+        */
+        static size_t RelocateBuffer(const VulkanAbstractionLayer::Buffer& source, const VulkanAbstractionLayer::Buffer& destination, size_t byteSize);
+
         static void CopyFromBuffer(uint8_t* data, size_t byteSize, const VulkanAbstractionLayer::Buffer& buffer, size_t offset);
+        /*!
+        schedules copy of buffer range to CPU without waiting for GPU. Copy is recorded into the next frame, and callback is invoked
+        when GPU completes that frame. Uploads recorded before the call are visible to the readback
+        \param byteSize size of range in bytes
+        \param buffer buffer to read from. It must stay alive until callback is invoked
+        \param offset offset of range in buffer in bytes
+        \param callback function which receives data. Data pointer is valid only inside callback
+        */
+        static void CopyFromBufferAsync(size_t byteSize, const VulkanAbstractionLayer::Buffer& buffer, size_t offset, ReadbackCallback callback);
     };
-}
\ No newline at end of file
+}
@@ -487,7 +487,7 @@ namespace MxEngine
 
     void DebugBuffer::ClearBuffer()
     {
-        this->storage.clear();
+        FrameAllocator::Recycle(this->storage);
     }
 
     void DebugBuffer::SubmitBuffer()
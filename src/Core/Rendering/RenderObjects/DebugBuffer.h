@@ -27,6 +27,7 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "Platform/GraphicAPI.h"
+#include "Utilities/Memory/FrameAllocator.h"
 
 #pragma once
 
@@ -51,7 +52,7 @@ namespace MxEngine
             Vector4 color;
         };
 
-        using FrontendStorage = MxVector<Point>;
+        using FrontendStorage = FrameVector<Point>;
 
         // VertexBufferHandle VBO;
         // VertexArrayHandle VAO;
@@ -35,9 +35,11 @@
 #include "RenderObjects/PointLightInstancedObject.h"
 #include "RenderObjects/SpotLightInstancedObject.h"
 #include "RenderUtilities/RenderStatistics.h"
+#include "RenderUtilities/ClusterCuller.h"
 #include "Core/Resources/ACESCurve.h"
 #include "Core/Resources/Material.h"
 #include "Utilities/String/String.h"
+#include "Utilities/Memory/FrameAllocator.h"
 
 namespace MxEngine
 {
@@ -154,9 +156,9 @@ namespace MxEngine
 
     struct LightingSystem
     {
-        MxVector<DirectionalLightUnit> DirectionalLights;
-        MxVector<PointLightUnit> PointLights;
-        MxVector<SpotLightUnit> SpotLights;
+        FrameVector<DirectionalLightUnit> DirectionalLights;
+        FrameVector<PointLightUnit> PointLights;
+        FrameVector<SpotLightUnit> SpotLights;
         SpotLightInstancedObject SpotLightsInstanced;
         PointLightInstancedObject PointLightsInstanced;
         RenderHelperObject PointLight;
@@ -182,6 +184,9 @@ namespace MxEngine
         Matrix3x3 NormalMatrix;
 
         Vector3 MinAABB, MaxAABB;
+        // index ranges of meshlets visible from main camera, stored in pipeline ClusterRanges list
+        size_t ClusterRangeOffset;
+        size_t ClusterRangeCount;
         #if defined(MXENGINE_DEBUG)
         const char* DebugName;
         #endif
@@ -189,8 +194,8 @@ namespace MxEngine
 
     struct RenderList
     {
-        MxVector<RenderGroup> Groups;
-        MxVector<size_t> UnitsIndex;
+        FrameVector<RenderGroup> Groups;
+        FrameVector<size_t> UnitsIndex;
     };
 
     struct ParticleSystemUnit
@@ -214,12 +219,13 @@ namespace MxEngine
         RenderList TransparentObjects;
         RenderList MaskedObjects;
         RenderList OpaqueObjects;
-        MxVector<RenderUnit> RenderUnits;
+        FrameVector<RenderUnit> RenderUnits;
+        FrameVector<IndexRange> ClusterRanges;
 
-        MxVector<ParticleSystemUnit> OpaqueParticleSystems;
-        MxVector<ParticleSystemUnit> TransparentParticleSystems;
-        MxVector<Material> MaterialUnits;
-        MxVector<CameraUnit> Cameras;
+        FrameVector<ParticleSystemUnit> OpaqueParticleSystems;
+        FrameVector<ParticleSystemUnit> TransparentParticleSystems;
+        FrameVector<Material> MaterialUnits;
+        FrameVector<CameraUnit> Cameras;
         RenderStatistics Statistics;
     };
 }
\ No newline at end of file
@@ -0,0 +1,78 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "ClusterCuller.h"
+#include "Utilities/Profiler/Profiler.h"
+
+namespace MxEngine
+{
+    size_t ClusterCuller::Cull(const MxVector<Meshlet>& meshlets, size_t baseIndexOffset, const Matrix4x4& modelMatrix, const FrustrumCuller& culler,
+        const Vector3& viewPosition, bool useConeCulling, FrameVector<IndexRange>& ranges)
+    {
+        MAKE_SCOPE_PROFILER("ClusterCuller::Cull()");
+
+        Matrix3x3 rotationScale = Matrix3x3(modelMatrix);
+        Vector3 scale = MakeVector3(Length(rotationScale[0]), Length(rotationScale[1]), Length(rotationScale[2]));
+        float maxScale = ComponentMax(scale);
+
+        // angles between normals and view direction are preserved only if transform has uniform scale
+        useConeCulling = useConeCulling && maxScale - ComponentMin(scale) <= 0.01f * maxScale;
+        // mirroring transform flips triangle winding, so front faces are now on the other side
+        float axisSign = Dot(Cross(rotationScale[0], rotationScale[1]), rotationScale[2]) < 0.0f ? -1.0f : 1.0f;
+
+        const size_t firstRange = ranges.size();
+        size_t culledCount = 0;
+        for (const auto& meshlet : meshlets)
+        {
+            Vector3 center = Vector3(modelMatrix * Vector4(meshlet.Bounds.Center, 1.0f));
+            float radius = meshlet.Bounds.Radius * maxScale;
+
+            bool isVisible = culler.IsSphereVisible(center, radius);
+            if (isVisible && useConeCulling && meshlet.ConeCutoff < 1.0f)
+            {
+                Vector3 axis = (axisSign / maxScale) * (rotationScale * meshlet.ConeAxis);
+                Vector3 view = center - viewPosition;
+                isVisible = Dot(view, axis) < meshlet.ConeCutoff * Length(view) + radius;
+            }
+
+            if (!isVisible)
+            {
+                culledCount++;
+                continue;
+            }
+
+            size_t indexOffset = baseIndexOffset + meshlet.IndexOffset;
+            if (ranges.size() > firstRange && ranges.back().IndexOffset + ranges.back().IndexCount == indexOffset)
+                ranges.back().IndexCount += meshlet.IndexCount;
+            else
+                ranges.push_back(IndexRange{ indexOffset, meshlet.IndexCount });
+        }
+        return culledCount;
+    }
+}
@@ -0,0 +1,65 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Core/Resources/Meshlet.h"
+#include "Core/BoundingObjects/FrustrumCuller.h"
+#include "Utilities/Memory/FrameAllocator.h"
+
+namespace MxEngine
+{
+    /*!
+    range of index buffer which is drawn with one draw call
+    */
+    struct IndexRange
+    {
+        size_t IndexOffset;
+        size_t IndexCount;
+    };
+
+    class ClusterCuller
+    {
+    public:
+        /*!
+        culls meshlets against camera frustrum and, if enabled, their normal cones. Visible meshlets are appended to ranges list,
+        adjacent ones are merged into a single range
+        \param meshlets meshlets of mesh data
+        \param baseIndexOffset index buffer offset of mesh data, to which meshlet offsets are relative
+        \param modelMatrix transform of mesh data to world space
+        \param culler camera frustrum culler in world space
+        \param viewPosition camera position in world space
+        \param useConeCulling enables backface culling of whole meshlets. Should be disabled for double-sided materials and orthographic cameras
+        \param ranges list to append visible index ranges to
+        \returns number of culled meshlets
+        */
+        static size_t Cull(const MxVector<Meshlet>& meshlets, size_t baseIndexOffset, const Matrix4x4& modelMatrix, const FrustrumCuller& culler,
+            const Vector3& viewPosition, bool useConeCulling, FrameVector<IndexRange>& ranges);
+    };
+}
@@ -0,0 +1,415 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "AssetStreamer.h"
+#include "Core/Resources/BufferAllocator.h"
+#include "Core/Rendering/RenderGraph/SubmissionQueue.h"
+#include "Core/Components/Rendering/MeshRenderer.h"
+#include "Utilities/FileSystem/FileManager.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+
+#include <algorithm>
+
+namespace MxEngine
+{
+    template<typename T>
+    static void CopyMeshRange(const MxVector<MeshInfo>& meshes, MxVector<T> MeshInfo::* member, size_t begin, size_t end, const Buffer& buffer, size_t bufferOffset)
+    {
+        // submesh arrays are stored one after another, so byte range [begin, end) may span several of them
+        size_t cursor = 0;
+        for (const auto& meshInfo : meshes)
+        {
+            const auto& data = meshInfo.*member;
+            size_t byteSize = data.size() * sizeof(T);
+            size_t first = Max(begin, cursor);
+            size_t last = Min(end, cursor + byteSize);
+            if (first < last)
+                SubmissionQueue::CopyToBuffer((const uint8_t*)data.data() + (first - cursor), last - first, buffer, bufferOffset + first);
+
+            cursor += byteSize;
+            if (cursor >= end) break;
+        }
+    }
+
+    AssetStreamerImpl::MeshEntry* AssetStreamer::GetEntry(const MeshHandle& mesh)
+    {
+        if (!mesh.IsValid()) return nullptr;
+        auto it = impl->entryByHandle.find(mesh.GetHandle());
+        if (it == impl->entryByHandle.end()) return nullptr;
+        auto& entry = impl->meshes[it->second];
+        return entry.Target == mesh ? &entry : nullptr;
+    }
+
+    void AssetStreamer::RemoveEntry(size_t index)
+    {
+        auto& entry = impl->meshes[index];
+        if (entry.State == StreamingState::UPLOADING || entry.State == StreamingState::RESIDENT)
+            impl->stats.ResidentBytes -= entry.VertexByteSize + entry.IndexByteSize;
+
+        impl->entryByHandle.erase(entry.Target.GetHandle());
+        if (index + 1 != impl->meshes.size())
+        {
+            entry = std::move(impl->meshes.back());
+            impl->entryByHandle[entry.Target.GetHandle()] = index;
+        }
+        impl->meshes.pop_back();
+    }
+
+    void AssetStreamer::StartLoading(AssetStreamerImpl::MeshEntry& entry)
+    {
+        // materials are dumped only once, evicted meshes reload geometry only
+        bool dumpMaterials = entry.State == StreamingState::QUEUED;
+        entry.State = StreamingState::LOADING;
+        entry.Loading = ThreadPool::SubmitBackground([path = entry.Path, dumpMaterials]()
+        {
+            ObjectInfo objectInfo = ObjectLoader::Load(path);
+            if (dumpMaterials)
+            {
+                // dump all material to let user retrieve them for MeshRenderer component
+                FilePath materialLibPath = path.native() + MeshRenderer::GetMaterialFileExtenstion().native();
+                ObjectLoader::DumpMaterials(objectInfo.materials, materialLibPath);
+                // textures are cooked at import, so upload path reads compressed mip chains from cache
+                ObjectLoader::CookTextures(objectInfo.materials, objectInfo.textures);
+            }
+            // decoded images are not needed after cooking, only geometry waits for upload
+            objectInfo.textures.clear();
+            return objectInfo;
+        });
+    }
+
+    void AssetStreamer::FinishLoading(AssetStreamerImpl::MeshEntry& entry)
+    {
+        if (entry.Object.meshes.empty())
+        {
+            MXLOG_WARNING("MxEngine::AssetStreamer", "streamed mesh has no geometry: " + ToMxString(entry.Path));
+            entry.State = StreamingState::FAILED;
+            return;
+        }
+
+        size_t totalVerticies = 0;
+        size_t totalIndicies = 0;
+        for (const auto& meshInfo : entry.Object.meshes)
+        {
+            totalVerticies += meshInfo.vertecies.size();
+            totalIndicies += meshInfo.indicies.size();
+        }
+
+        // GPU storage is reserved at once, but data is copied in several frames, see UploadMeshData
+        entry.Target->ReserveData(totalVerticies, totalIndicies);
+        entry.VertexByteSize = totalVerticies * sizeof(Vertex);
+        entry.IndexByteSize = totalIndicies * sizeof(uint32_t);
+        entry.UploadedBytes = 0;
+        entry.State = StreamingState::UPLOADING;
+        impl->stats.ResidentBytes += entry.VertexByteSize + entry.IndexByteSize;
+    }
+
+    size_t AssetStreamer::UploadMeshData(AssetStreamerImpl::MeshEntry& entry, size_t byteBudget)
+    {
+        auto& mesh = *entry.Target;
+        size_t totalBytes = entry.VertexByteSize + entry.IndexByteSize;
+        size_t begin = entry.UploadedBytes;
+        size_t end = Min(begin + byteBudget, totalBytes);
+
+        // vertex data goes first, then index data
+        if (begin < entry.VertexByteSize)
+        {
+            CopyMeshRange(entry.Object.meshes, &MeshInfo::vertecies, begin, Min(end, entry.VertexByteSize),
+                *BufferAllocator::GetVBO(), mesh.GetBaseVerteciesOffset() * sizeof(Vertex));
+        }
+        if (end > entry.VertexByteSize)
+        {
+            CopyMeshRange(entry.Object.meshes, &MeshInfo::indicies, Max(begin, entry.VertexByteSize) - entry.VertexByteSize, end - entry.VertexByteSize,
+                *BufferAllocator::GetIBO(), mesh.GetBaseIndiciesOffset() * sizeof(uint32_t));
+        }
+        entry.UploadedBytes = end;
+
+        if (entry.UploadedBytes == totalBytes)
+        {
+            mesh.CreateSubMeshes(entry.Path, entry.Object);
+            entry.Object = ObjectInfo{ };
+            entry.State = StreamingState::RESIDENT;
+            MXLOG_DEBUG("MxEngine::AssetStreamer", "mesh is resident: " + ToMxString(entry.Path));
+        }
+        return end - begin;
+    }
+
+    void AssetStreamer::EvictMeshes()
+    {
+        while (impl->stats.ResidentBytes > impl->residencyBudget)
+        {
+            size_t victimIndex = AssetStreamer::SelectEvictionVictim(*impl);
+            if (victimIndex == impl->meshes.size()) break; // all resident meshes are visible, budget stays exceeded until some of them are not used
+
+            auto* victim = &impl->meshes[victimIndex];
+            victim->Target->Unload();
+            victim->State = StreamingState::EVICTED;
+            impl->stats.ResidentBytes -= victim->VertexByteSize + victim->IndexByteSize;
+            impl->stats.EvictedCount++;
+            MXLOG_DEBUG("MxEngine::AssetStreamer", "evicted mesh: " + ToMxString(victim->Path));
+        }
+    }
+
+    void AssetStreamer::OnUpdate()
+    {
+        MAKE_SCOPE_PROFILER("AssetStreamer::OnUpdate()");
+        impl->frameIndex++;
+        impl->stats.UploadedBytes = 0;
+
+        // release meshes referenced only by streamer. Loads in flight are released after they finish
+        for (size_t i = impl->meshes.size(); i > 0; i--)
+        {
+            auto& entry = impl->meshes[i - 1];
+            if (entry.State == StreamingState::LOADING) continue;
+            if (Factory<Mesh>::GetPool()[entry.Target.GetHandle()].refCount == 1)
+                RemoveEntry(i - 1);
+        }
+
+        // collect meshes which finished loading, so GPU storage for all of them is reserved at once
+        auto& order = impl->order;
+        order.clear();
+        size_t loadingCount = 0;
+        size_t loadedVertexBytes = 0;
+        size_t loadedIndexBytes = 0;
+        for (size_t i = 0; i < impl->meshes.size(); i++)
+        {
+            auto& entry = impl->meshes[i];
+            if (entry.State != StreamingState::LOADING) continue;
+            if (entry.Loading.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            {
+                entry.Object = entry.Loading.get();
+                for (const auto& meshInfo : entry.Object.meshes)
+                {
+                    loadedVertexBytes += meshInfo.vertecies.size() * sizeof(Vertex);
+                    loadedIndexBytes += meshInfo.indicies.size() * sizeof(uint32_t);
+                }
+                order.push_back(i);
+            }
+            else
+                loadingCount++;
+        }
+
+        BufferAllocator::BeginLoadBatch();
+        BufferAllocator::ReserveInVBO(loadedVertexBytes);
+        BufferAllocator::ReserveInIBO(loadedIndexBytes);
+        for (size_t index : order)
+            FinishLoading(impl->meshes[index]);
+        BufferAllocator::EndLoadBatch();
+
+        // background loads never occupy all workers, see ThreadPool::SubmitBackground
+        size_t maxLoadingCount = Min(impl->maxLoadingCount, Max(ThreadPool::GetWorkerCount(), size_t(2)) - 1);
+        for (const auto& action : AssetStreamer::PlanRequests(*impl, loadingCount, maxLoadingCount))
+        {
+            auto& entry = impl->meshes[action.EntryIndex];
+            if (action.UploadByteSize > 0)
+                impl->stats.UploadedBytes += UploadMeshData(entry, action.UploadByteSize);
+            else
+                StartLoading(entry);
+        }
+
+        EvictMeshes();
+
+        impl->stats.QueuedCount = impl->stats.LoadingCount = impl->stats.UploadingCount = impl->stats.ResidentCount = 0;
+        for (auto& entry : impl->meshes)
+        {
+            entry.Priority = entry.BasePriority;
+            impl->stats.QueuedCount += entry.State == StreamingState::QUEUED;
+            impl->stats.LoadingCount += entry.State == StreamingState::LOADING;
+            impl->stats.UploadingCount += entry.State == StreamingState::UPLOADING;
+            impl->stats.ResidentCount += entry.State == StreamingState::RESIDENT;
+        }
+    }
+
+    const MxVector<StreamingAction>& AssetStreamer::PlanRequests(AssetStreamerImpl& streamer, size_t loadingCount, size_t maxLoadingCount)
+    {
+        // serve requests from highest priority to lowest
+        auto& order = streamer.order;
+        order.clear();
+        for (size_t i = 0; i < streamer.meshes.size(); i++)
+        {
+            const auto& entry = streamer.meshes[i];
+            bool isRequested = entry.State == StreamingState::QUEUED || entry.State == StreamingState::UPLOADING;
+            bool isEvictedAndUsed = entry.State == StreamingState::EVICTED && entry.LastUsedFrame + 1 >= streamer.frameIndex;
+            if (isRequested || isEvictedAndUsed) order.push_back(i);
+        }
+        std::stable_sort(order.begin(), order.end(), [&streamer](size_t i1, size_t i2)
+        {
+            return streamer.meshes[i1].Priority > streamer.meshes[i2].Priority;
+        });
+
+        auto& actions = streamer.actions;
+        actions.clear();
+        size_t byteBudget = streamer.uploadBudget;
+        for (size_t index : order)
+        {
+            const auto& entry = streamer.meshes[index];
+            if (entry.State == StreamingState::UPLOADING && byteBudget > 0)
+            {
+                size_t pendingBytes = entry.VertexByteSize + entry.IndexByteSize - entry.UploadedBytes;
+                size_t uploadSize = Min(pendingBytes, byteBudget);
+                if (uploadSize == 0) continue;
+
+                actions.push_back(StreamingAction{ index, uploadSize });
+                byteBudget -= uploadSize;
+            }
+            else if (entry.State != StreamingState::UPLOADING && loadingCount < maxLoadingCount)
+            {
+                actions.push_back(StreamingAction{ index, 0 });
+                loadingCount++;
+            }
+        }
+        return actions;
+    }
+
+    size_t AssetStreamer::SelectEvictionVictim(const AssetStreamerImpl& streamer)
+    {
+        // least recently used mesh, which was not rendered in current and previous frames
+        size_t victim = streamer.meshes.size();
+        for (size_t i = 0; i < streamer.meshes.size(); i++)
+        {
+            const auto& entry = streamer.meshes[i];
+            if (entry.State != StreamingState::RESIDENT || entry.LastUsedFrame + 1 >= streamer.frameIndex) continue;
+            if (victim == streamer.meshes.size() || entry.LastUsedFrame < streamer.meshes[victim].LastUsedFrame) victim = i;
+        }
+        return victim;
+    }
+
+    MeshHandle AssetStreamer::StreamMesh(StringId hash, float priority)
+    {
+        return AssetStreamer::StreamMesh(FileManager::GetFilePath(hash), priority);
+    }
+
+    MeshHandle AssetStreamer::StreamMesh(const FilePath& path, float priority)
+    {
+        auto mesh = Factory<Mesh>::Create();
+        // placeholder keeps path of the mesh it is going to become, so it can be serialized before loading is finished
+        mesh->SetInternalEngineTag(ToMxString(path));
+
+        impl->entryByHandle[mesh.GetHandle()] = impl->meshes.size();
+        auto& entry = impl->meshes.emplace_back();
+        entry.Target = mesh;
+        entry.Path = std::filesystem::proximate(path);
+        entry.BasePriority = priority;
+        entry.Priority = priority;
+        entry.LastUsedFrame = impl->frameIndex;
+        return mesh;
+    }
+
+    void AssetStreamer::OnMeshUsed(const MeshHandle& mesh, float priority)
+    {
+        if (impl->meshes.empty()) return;
+
+        auto* entry = GetEntry(mesh);
+        if (entry == nullptr) return;
+
+        entry->LastUsedFrame = impl->frameIndex;
+        entry->Priority = Max(entry->Priority, priority);
+    }
+
+    float AssetStreamer::ComputeScreenPriority(const Vector3& position, float radius, const Vector3& viewPosition)
+    {
+        // approximates projected size of the object: bigger and closer objects are streamed first
+        return (radius + 1.0f) / (Length(position - viewPosition) + 1.0f);
+    }
+
+    bool AssetStreamer::IsResident(const MeshHandle& mesh)
+    {
+        return AssetStreamer::GetState(mesh) == StreamingState::RESIDENT;
+    }
+
+    StreamingState AssetStreamer::GetState(const MeshHandle& mesh)
+    {
+        auto* entry = GetEntry(mesh);
+        return entry != nullptr ? entry->State : StreamingState::RESIDENT;
+    }
+
+    void AssetStreamer::SetUploadBudget(size_t bytesPerFrame)
+    {
+        impl->uploadBudget = bytesPerFrame;
+    }
+
+    size_t AssetStreamer::GetUploadBudget()
+    {
+        return impl->uploadBudget;
+    }
+
+    void AssetStreamer::SetResidencyBudget(size_t bytes)
+    {
+        impl->residencyBudget = bytes;
+    }
+
+    size_t AssetStreamer::GetResidencyBudget()
+    {
+        return impl->residencyBudget;
+    }
+
+    void AssetStreamer::SetMaxLoadingCount(size_t count)
+    {
+        impl->maxLoadingCount = Max(count, size_t(1));
+    }
+
+    size_t AssetStreamer::GetMaxLoadingCount()
+    {
+        return impl->maxLoadingCount;
+    }
+
+    const StreamingStats& AssetStreamer::GetStats()
+    {
+        return impl->stats;
+    }
+
+    void AssetStreamer::Init()
+    {
+        impl = Alloc<AssetStreamerImpl>();
+    }
+
+    void AssetStreamer::Destroy()
+    {
+        // background tasks reference nothing from streamer, but must finish before thread pool is destroyed
+        for (auto& entry : impl->meshes)
+        {
+            if (entry.State == StreamingState::LOADING)
+                ThreadPool::Wait(entry.Loading);
+        }
+        Free(impl);
+        impl = nullptr;
+    }
+
+    AssetStreamerImpl* AssetStreamer::GetImpl()
+    {
+        return impl;
+    }
+
+    void AssetStreamer::Clone(AssetStreamerImpl* other)
+    {
+        impl = other;
+    }
+}
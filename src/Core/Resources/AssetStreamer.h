@@ -0,0 +1,162 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Core/Resources/AssetManager.h"
+#include "Utilities/ObjectLoading/ObjectLoader.h"
+#include "Utilities/STL/MxHashMap.h"
+
+#include <future>
+
+namespace MxEngine
+{
+    enum class StreamingState : uint8_t
+    {
+        QUEUED,
+        LOADING,
+        UPLOADING,
+        RESIDENT,
+        EVICTED,
+        FAILED,
+    };
+
+    struct StreamingStats
+    {
+        size_t QueuedCount = 0;
+        size_t LoadingCount = 0;
+        size_t UploadingCount = 0;
+        size_t ResidentCount = 0;
+        size_t EvictedCount = 0;
+        size_t UploadedBytes = 0;
+        size_t ResidentBytes = 0;
+    };
+
+    struct StreamingAction
+    {
+        size_t EntryIndex = 0;
+        // number of bytes to copy to GPU in current frame, zero if entry must start loading instead
+        size_t UploadByteSize = 0;
+    };
+
+    struct AssetStreamerImpl
+    {
+        struct MeshEntry
+        {
+            MeshHandle Target;
+            FilePath Path;
+            std::future<ObjectInfo> Loading;
+            ObjectInfo Object;
+            size_t VertexByteSize = 0;
+            size_t IndexByteSize = 0;
+            size_t UploadedBytes = 0;
+            size_t LastUsedFrame = 0;
+            float BasePriority = 0.0f;
+            float Priority = 0.0f;
+            StreamingState State = StreamingState::QUEUED;
+        };
+
+        MxVector<MeshEntry> meshes;
+        // maps MeshHandle index to position in meshes array
+        MxHashMap<size_t, size_t> entryByHandle;
+        // scratch buffer with entry indicies (finished loads, then requests sorted by priority), reused between frames
+        MxVector<size_t> order;
+        // scratch buffer with requests served in current frame, see PlanRequests
+        MxVector<StreamingAction> actions;
+        size_t uploadBudget = 8 * 1024 * 1024;
+        size_t residencyBudget = 512 * 1024 * 1024;
+        // upper limit of meshes loading at once, also limited by number of workers which may run background tasks
+        size_t maxLoadingCount = 4;
+        size_t frameIndex = 0;
+        StreamingStats stats;
+    };
+
+    /*!
+    asset streamer loads meshes in background and uploads them to GPU over several frames. StreamMesh returns empty placeholder mesh immediately,
+    which is filled when its data is loaded. Requests are served by priority (see OnMeshUsed), each frame at most upload budget bytes are copied to GPU buffers,
+    and least recently used meshes are unloaded when resident memory exceeds residency budget. Evicted meshes are streamed again as soon as they are used
+    */
+    class AssetStreamer
+    {
+        inline static AssetStreamerImpl* impl = nullptr;
+
+        static AssetStreamerImpl::MeshEntry* GetEntry(const MeshHandle& mesh);
+        static void RemoveEntry(size_t index);
+        static void StartLoading(AssetStreamerImpl::MeshEntry& entry);
+        static void FinishLoading(AssetStreamerImpl::MeshEntry& entry);
+        static size_t UploadMeshData(AssetStreamerImpl::MeshEntry& entry, size_t byteBudget);
+        static void EvictMeshes();
+    public:
+        static void Init();
+        static void Destroy();
+        static AssetStreamerImpl* GetImpl();
+        static void Clone(AssetStreamerImpl* other);
+
+        /*!
+        processes streaming requests: starts queued loads, uploads loaded data within frame budget and evicts unused meshes. Called once per frame by application
+        */
+        static void OnUpdate();
+
+        /*!
+        selects requests served in current frame: meshes are visited from highest priority to lowest, loaded ones receive part of upload budget,
+        others start loading while number of loads in flight is below limit. Does not modify streamer state, so it can be used without GPU
+        \param streamer streamer state to plan for
+        \param loadingCount number of meshes which are currently loading
+        \param maxLoadingCount maximal number of meshes loading at once
+        \returns actions in the order they must be executed, stored in streamer.actions
+        */
+        static const MxVector<StreamingAction>& PlanRequests(AssetStreamerImpl& streamer, size_t loadingCount, size_t maxLoadingCount);
+        /*!
+        selects mesh to evict when resident memory exceeds residency budget: least recently used one, which was not used in current or previous frame
+        \param streamer streamer state to select from
+        \returns index of mesh in streamer.meshes or streamer.meshes.size() if no mesh can be evicted
+        */
+        static size_t SelectEvictionVictim(const AssetStreamerImpl& streamer);
+
+        static MeshHandle StreamMesh(StringId hash, float priority = 0.0f);
+        static MeshHandle StreamMesh(const FilePath& path, float priority = 0.0f);
+        /*!
+        marks streamed mesh as used in current frame. Does nothing if mesh was not created by StreamMesh
+        \param mesh mesh which is going to be rendered
+        \param priority request priority for this frame, see ComputeScreenPriority
+        */
+        static void OnMeshUsed(const MeshHandle& mesh, float priority);
+        static float ComputeScreenPriority(const Vector3& position, float radius, const Vector3& viewPosition);
+
+        static bool IsResident(const MeshHandle& mesh);
+        static StreamingState GetState(const MeshHandle& mesh);
+        static void SetUploadBudget(size_t bytesPerFrame);
+        static size_t GetUploadBudget();
+        static void SetResidencyBudget(size_t bytes);
+        static size_t GetResidencyBudget();
+        static void SetMaxLoadingCount(size_t count);
+        static size_t GetMaxLoadingCount();
+        static const StreamingStats& GetStats();
+    };
+}
@@ -29,8 +29,13 @@
 #include "BufferAllocator.h"
 #include "FreeListAllocator.h"
 #include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/STL/MxHashMap.h"
 #include "Core/Rendering/RenderGraph/SubmissionQueue.h"
 
+#include <algorithm>
+
 namespace MxEngine
 {
     using namespace VulkanAbstractionLayer;
@@ -45,6 +50,29 @@ namespace MxEngine
         BufferHandle IBO;
         BufferHandle InstanceVBO;
         BufferHandle SSBO;
+        float GrowthFactor = 2.0f;
+        size_t BatchDepth = 0;
+        // old storage which is still referenced by relocations pending inside load batch
+        MxVector<BufferHandle> RetiredBuffers;
+        BufferAllocatorStats Stats;
+
+        struct AllocationRecord
+        {
+            size_t Offset = 0;
+            size_t Size = 0;
+            size_t Alignment = 1;
+            uint32_t Generation = 0;
+            BufferHeap Heap = BufferHeap::VERTEX;
+            bool IsLive = false;
+            bool IsMovable = false;
+        };
+
+        // every live allocation is recorded, so defragmentation knows where holes are
+        MxVector<AllocationRecord> Records;
+        MxVector<uint32_t> FreeRecords;
+        MxHashMap<size_t, uint32_t> RecordByOffset[4];
+        size_t DefragmentationBudget = 4 * 1024 * 1024;
+        float DefragmentationThreshold = 0.25f;
     };
 
     void BufferAllocator::Init()
@@ -72,6 +100,37 @@ namespace MxEngine
     BufferUsage::Value IndexBufferUsage = BufferUsage::TRANSFER_DESTINATION | BufferUsage::TRANSFER_SOURCE | BufferUsage::INDEX_BUFFER;
     BufferUsage::Value StorageBufferUsage = BufferUsage::TRANSFER_DESTINATION | BufferUsage::TRANSFER_SOURCE | BufferUsage::STORAGE_BUFFER;
 
+    static void GrowBuffer(BufferAllocatorImpl& allocator, BufferHandle& buffer, size_t newSize, BufferUsage::Value usage, const char* name)
+    {
+        size_t currentSize = buffer.IsValid() ? (size_t)buffer->GetByteSize() : 0;
+        if (newSize <= currentSize)
+        {
+            // storage was already grown ahead, allocator just starts using its tail
+            allocator.Stats.AbsorbedGrowthCount++;
+            return;
+        }
+
+        size_t newCapacity = BufferAllocator::GetGrowthCapacity(currentSize, newSize, allocator.GrowthFactor);
+        auto oldBuffer = buffer;
+        buffer = Factory<Buffer>::Create(newCapacity, usage, MemoryUsage::GPU_ONLY);
+        size_t copiedBytes = 0;
+        if (oldBuffer.IsValid())
+        {
+            // pending uploads to old storage are redirected to the new one. Inside batch storage which existed before the batch
+            // is copied once directly into the last storage, intermediate storages are never copied
+            copiedBytes = SubmissionQueue::RelocateBuffer(*oldBuffer, *buffer, currentSize);
+            allocator.Stats.RelocationCount++;
+            allocator.Stats.RelocatedBytes += copiedBytes;
+
+            if (allocator.BatchDepth == 0)
+                SubmissionQueue::FlushQueue();
+            else
+                allocator.RetiredBuffers.push_back(std::move(oldBuffer));
+        }
+        MXLOG_DEBUG("MxEngine::BufferAllocator", MxFormat("relocated {0} storage to new memory with size: {1} (requested {2}, copied {3} bytes)",
+            name, newCapacity, newSize, copiedBytes));
+    }
+
     void BufferAllocator::AllocateBuffers()
     {
         SubmissionQueue::StartQueue();
@@ -80,51 +139,19 @@ namespace MxEngine
 
         impl->AllocatorVBO.Init(InitialBufferSize, [](size_t newSize)
         {
-            auto oldVBO = impl->VBO;
-            impl->VBO = Factory<Buffer>::Create(newSize, VertexBufferUsage, MemoryUsage::GPU_ONLY);
-            if (oldVBO.IsValid())
-            {
-                auto& commandBuffer = SubmissionQueue::GetCommandBuffer();
-                commandBuffer.CopyBuffer(BufferInfo{ *oldVBO, 0 }, BufferInfo{ *impl->VBO, 0 }, oldVBO->GetByteSize());
-                SubmissionQueue::FlushQueue();
-            }
-            MXLOG_DEBUG("MxEngine::BufferAllocator", "relocated vertex buffer storage to new memory with size: " + ToMxString(newSize));
+            GrowBuffer(*impl, impl->VBO, newSize, VertexBufferUsage, "vertex buffer");
         });
         impl->AllocatorIBO.Init(InitialBufferSize, [](size_t newSize)
         {
-            auto oldIBO = impl->IBO;
-            impl->IBO = Factory<Buffer>::Create(newSize, IndexBufferUsage, MemoryUsage::GPU_ONLY);
-            if (oldIBO.IsValid())
-            {
-                auto& commandBuffer = SubmissionQueue::GetCommandBuffer();
-                commandBuffer.CopyBuffer(BufferInfo{ *oldIBO, 0 }, BufferInfo{ *impl->IBO, 0 }, oldIBO->GetByteSize());
-                SubmissionQueue::FlushQueue();
-            }
-            MXLOG_DEBUG("MxEngine::BufferAllocator", "relocated index buffer storage to new memory with size: " + ToMxString(newSize));
+            GrowBuffer(*impl, impl->IBO, newSize, IndexBufferUsage, "index buffer");
         });
         impl->AllocatorInstanceVBO.Init(InitialBufferSize, [](size_t newSize)
         {
-            auto oldInstanceVBO = impl->InstanceVBO;
-            impl->InstanceVBO = Factory<Buffer>::Create(newSize, VertexBufferUsage, MemoryUsage::GPU_ONLY);
-            if (oldInstanceVBO.IsValid())
-            {
-                auto& commandBuffer = SubmissionQueue::GetCommandBuffer();
-                commandBuffer.CopyBuffer(BufferInfo{ *oldInstanceVBO, 0 }, BufferInfo{ *impl->InstanceVBO, 0 }, oldInstanceVBO->GetByteSize());
-                SubmissionQueue::FlushQueue();
-            }
-            MXLOG_DEBUG("MxEngine::BufferAllocator", "relocated instance vertex buffer storage to new memory with size: " + ToMxString(newSize));
+            GrowBuffer(*impl, impl->InstanceVBO, newSize, VertexBufferUsage, "instance vertex buffer");
         });
         impl->AllocatorSSBO.Init(InitialBufferSize, [](size_t newSize)
         {
-            auto oldSSBO = impl->SSBO;
-            impl->SSBO = Factory<Buffer>::Create(newSize, StorageBufferUsage, MemoryUsage::GPU_ONLY);
-            if (oldSSBO.IsValid())
-            {
-                auto& commandBuffer = SubmissionQueue::GetCommandBuffer();
-                commandBuffer.CopyBuffer(BufferInfo{ *oldSSBO, 0 }, BufferInfo{ *impl->SSBO, 0 }, oldSSBO->GetByteSize());
-                SubmissionQueue::FlushQueue();
-            }
-            MXLOG_DEBUG("MxEngine::BufferAllocator", "relocated shader storage buffer storage to new memory with size: " + ToMxString(newSize));
+            GrowBuffer(*impl, impl->SSBO, newSize, StorageBufferUsage, "shader storage buffer");
         });
         
         struct
@@ -134,7 +161,7 @@ namespace MxEngine
             Vector3 field3{ 1.0f };
         } DefaultInstance;
 
-        auto offset = (uint32_t)impl->AllocatorInstanceVBO.Allocate(sizeof(DefaultInstance));
+        auto offset = (uint32_t)BufferAllocator::AllocateInInstanceVBO(sizeof(DefaultInstance)).Offset;
         SubmissionQueue::CopyToBuffer(&DefaultInstance, *impl->InstanceVBO, offset);
     }
 
@@ -158,47 +185,425 @@ namespace MxEngine
         return impl->SSBO;
     }
 
+    static Allocators::FreeListAllocator& GetHeapAllocator(BufferAllocatorImpl& allocator, BufferHeap heap)
+    {
+        switch (heap)
+        {
+        case BufferHeap::VERTEX:
+            return allocator.AllocatorVBO;
+        case BufferHeap::INDEX:
+            return allocator.AllocatorIBO;
+        case BufferHeap::INSTANCE:
+            return allocator.AllocatorInstanceVBO;
+        case BufferHeap::STORAGE:
+        default:
+            return allocator.AllocatorSSBO;
+        }
+    }
+
+    static BufferHandle GetHeapBuffer(BufferAllocatorImpl& allocator, BufferHeap heap)
+    {
+        switch (heap)
+        {
+        case BufferHeap::VERTEX:
+            return allocator.VBO;
+        case BufferHeap::INDEX:
+            return allocator.IBO;
+        case BufferHeap::INSTANCE:
+            return allocator.InstanceVBO;
+        case BufferHeap::STORAGE:
+        default:
+            return allocator.SSBO;
+        }
+    }
+
+    static BufferAllocationHandle AddRecord(BufferAllocatorImpl& allocator, BufferHeap heap, size_t offset, size_t size, size_t alignment, bool isMovable)
+    {
+        uint32_t index = 0;
+        if (!allocator.FreeRecords.empty())
+        {
+            index = allocator.FreeRecords.back();
+            allocator.FreeRecords.pop_back();
+        }
+        else
+        {
+            index = (uint32_t)allocator.Records.size();
+            allocator.Records.emplace_back();
+        }
+
+        auto& record = allocator.Records[index];
+        record.Offset = offset;
+        record.Size = size;
+        record.Alignment = Max(alignment, (size_t)1);
+        record.Heap = heap;
+        record.IsLive = true;
+        record.IsMovable = isMovable;
+        allocator.RecordByOffset[(size_t)heap][offset] = index;
+        return BufferAllocationHandle{ index, record.Generation };
+    }
+
+    static void RemoveRecord(BufferAllocatorImpl& allocator, uint32_t index)
+    {
+        auto& record = allocator.Records[index];
+        allocator.RecordByOffset[(size_t)record.Heap].erase(record.Offset);
+        record.IsLive = false;
+        record.Generation++;
+        allocator.FreeRecords.push_back(index);
+    }
+
+    static void RemoveRecord(BufferAllocatorImpl& allocator, BufferHeap heap, size_t offset)
+    {
+        auto& records = allocator.RecordByOffset[(size_t)heap];
+        auto it = records.find(offset);
+        if (it != records.end())
+            RemoveRecord(allocator, it->second);
+    }
+
+    static BufferAllocatorImpl::AllocationRecord* GetRecord(BufferAllocatorImpl& allocator, BufferAllocationHandle handle)
+    {
+        if (!handle.IsValid() || handle.Index >= allocator.Records.size()) return nullptr;
+        auto& record = allocator.Records[handle.Index];
+        return record.IsLive && record.Generation == handle.Generation ? &record : nullptr;
+    }
+
     BufferAllocation BufferAllocator::AllocateInVBO(size_t sizeInFloats)
     {
         size_t offset = impl->AllocatorVBO.Allocate(sizeInFloats);
+        AddRecord(*impl, BufferHeap::VERTEX, offset, sizeInFloats, 1, false);
         return BufferAllocation{ offset, sizeInFloats };
     }
 
     BufferAllocation BufferAllocator::AllocateInIBO(size_t sizeInIndices)
     {
         size_t offset = impl->AllocatorIBO.Allocate(sizeInIndices);
+        AddRecord(*impl, BufferHeap::INDEX, offset, sizeInIndices, 1, false);
         return BufferAllocation{ offset, sizeInIndices };
     }
 
     BufferAllocation BufferAllocator::AllocateInInstanceVBO(size_t sizeInInstances)
     {
         size_t offset = impl->AllocatorInstanceVBO.Allocate(sizeInInstances);
+        AddRecord(*impl, BufferHeap::INSTANCE, offset, sizeInInstances, 1, false);
         return BufferAllocation{ offset, sizeInInstances };
     }
 
     BufferAllocation BufferAllocator::AllocateInSSBO(size_t sizeInBytes)
     {
         size_t offset = impl->AllocatorSSBO.Allocate(sizeInBytes);
+        AddRecord(*impl, BufferHeap::STORAGE, offset, sizeInBytes, 1, false);
         return BufferAllocation{ offset, sizeInBytes };
     }
 
     void BufferAllocator::DeallocateInVBO(BufferAllocation allocation)
     {
+        RemoveRecord(*impl, BufferHeap::VERTEX, allocation.Offset);
         impl->AllocatorVBO.Deallocate(allocation.Offset);
     }
 
     void BufferAllocator::DeallocateInIBO(BufferAllocation allocation)
     {
+        RemoveRecord(*impl, BufferHeap::INDEX, allocation.Offset);
         impl->AllocatorIBO.Deallocate(allocation.Offset);
     }
 
     void BufferAllocator::DeallocateInInstanceVBO(BufferAllocation allocation)
     {
+        RemoveRecord(*impl, BufferHeap::INSTANCE, allocation.Offset);
         impl->AllocatorInstanceVBO.Deallocate(allocation.Offset);
     }
 
     void BufferAllocator::DeallocateInSSBO(BufferAllocation allocation)
     {
+        RemoveRecord(*impl, BufferHeap::STORAGE, allocation.Offset);
         impl->AllocatorSSBO.Deallocate(allocation.Offset);
     }
-}
\ No newline at end of file
+
+    BufferAllocationHandle BufferAllocator::Allocate(BufferHeap heap, size_t byteSize, size_t alignment)
+    {
+        size_t offset = GetHeapAllocator(*impl, heap).Allocate(byteSize);
+        MX_ASSERT(offset % Max(alignment, (size_t)1) == 0);
+        return AddRecord(*impl, heap, offset, byteSize, alignment, true);
+    }
+
+    void BufferAllocator::Deallocate(BufferAllocationHandle handle)
+    {
+        auto record = GetRecord(*impl, handle);
+        if (record == nullptr) return;
+
+        GetHeapAllocator(*impl, record->Heap).Deallocate(record->Offset);
+        RemoveRecord(*impl, handle.Index);
+    }
+
+    BufferAllocation BufferAllocator::GetAllocation(BufferAllocationHandle handle)
+    {
+        auto record = GetRecord(*impl, handle);
+        if (record == nullptr) return BufferAllocation{ 0, 0 };
+        return BufferAllocation{ record->Offset, record->Size };
+    }
+
+    void BufferAllocator::SetMovable(BufferAllocationHandle handle, bool isMovable)
+    {
+        auto record = GetRecord(*impl, handle);
+        if (record != nullptr) record->IsMovable = isMovable;
+    }
+
+    static void Reserve(Allocators::FreeListAllocator& allocator, size_t byteSize, BufferAllocatorStats& stats)
+    {
+        if (byteSize == 0) return;
+        // allocating whole reservation at once makes allocator grow only one time. After deallocation the block stays free for next allocations
+        size_t offset = allocator.Allocate(byteSize);
+        allocator.Deallocate(offset);
+        stats.ReservedBytes += byteSize;
+    }
+
+    void BufferAllocator::ReserveInVBO(size_t byteSize)
+    {
+        Reserve(impl->AllocatorVBO, byteSize, impl->Stats);
+    }
+
+    void BufferAllocator::ReserveInIBO(size_t byteSize)
+    {
+        Reserve(impl->AllocatorIBO, byteSize, impl->Stats);
+    }
+
+    void BufferAllocator::ReserveInInstanceVBO(size_t byteSize)
+    {
+        Reserve(impl->AllocatorInstanceVBO, byteSize, impl->Stats);
+    }
+
+    void BufferAllocator::ReserveInSSBO(size_t byteSize)
+    {
+        Reserve(impl->AllocatorSSBO, byteSize, impl->Stats);
+    }
+
+    void BufferAllocator::BeginLoadBatch()
+    {
+        impl->BatchDepth++;
+    }
+
+    void BufferAllocator::EndLoadBatch()
+    {
+        MX_ASSERT(impl->BatchDepth > 0);
+        impl->BatchDepth--;
+        if (impl->BatchDepth == 0 && !impl->RetiredBuffers.empty())
+        {
+            MXLOG_DEBUG("MxEngine::BufferAllocator", MxFormat("submitting {0} deferred relocations", impl->RetiredBuffers.size()));
+            SubmissionQueue::FlushQueue();
+            impl->RetiredBuffers.clear();
+        }
+    }
+
+    size_t BufferAllocator::GetGrowthCapacity(size_t currentSize, size_t requestedSize, float growthFactor)
+    {
+        return Max(requestedSize, (size_t)(currentSize * Max(growthFactor, 1.0f)));
+    }
+
+    void BufferAllocator::SetGrowthFactor(float factor)
+    {
+        impl->GrowthFactor = Max(factor, 1.0f);
+    }
+
+    float BufferAllocator::GetGrowthFactor()
+    {
+        return impl->GrowthFactor;
+    }
+
+    const BufferAllocatorStats& BufferAllocator::GetStats()
+    {
+        return impl->Stats;
+    }
+
+    static MxVector<uint32_t> GetSortedHeapRecords(BufferAllocatorImpl& allocator, BufferHeap heap)
+    {
+        MxVector<uint32_t> result;
+        result.reserve(allocator.RecordByOffset[(size_t)heap].size());
+        for (const auto& [offset, index] : allocator.RecordByOffset[(size_t)heap])
+            result.push_back(index);
+
+        std::sort(result.begin(), result.end(), [&allocator](uint32_t i1, uint32_t i2)
+        {
+            return allocator.Records[i1].Offset < allocator.Records[i2].Offset;
+        });
+        return result;
+    }
+
+    static MxVector<BufferAllocationInfo> GetHeapLayout(BufferAllocatorImpl& allocator, const MxVector<uint32_t>& sortedRecords)
+    {
+        MxVector<BufferAllocationInfo> result;
+        result.reserve(sortedRecords.size());
+        for (uint32_t index : sortedRecords)
+        {
+            const auto& record = allocator.Records[index];
+            result.push_back(BufferAllocationInfo{ record.Offset, record.Size, record.Alignment, record.IsMovable });
+        }
+        return result;
+    }
+
+    BufferFragmentation BufferAllocator::ComputeFragmentation(ArrayView<BufferAllocationInfo> allocations)
+    {
+        BufferFragmentation result;
+        for (const auto& allocation : allocations)
+        {
+            result.LiveBytes += allocation.Size;
+            result.UsedBytes = Max(result.UsedBytes, allocation.Offset + allocation.Size);
+        }
+        if (result.UsedBytes != 0)
+            result.Ratio = 1.0f - float(result.LiveBytes) / float(result.UsedBytes);
+        return result;
+    }
+
+    BufferFragmentation BufferAllocator::GetFragmentation(BufferHeap heap)
+    {
+        auto layout = GetHeapLayout(*impl, GetSortedHeapRecords(*impl, heap));
+        return BufferAllocator::ComputeFragmentation(layout);
+    }
+
+    MxVector<BufferMove> BufferAllocator::PlanDefragmentation(ArrayView<BufferAllocationInfo> allocations, size_t byteBudget)
+    {
+        // free list allocator may align and pad blocks, so hole must be a bit larger than allocation to surely fit it without growth
+        constexpr size_t AlignmentSlack = 256;
+
+        struct Hole { size_t Offset; size_t Size; };
+
+        // holes between live allocations are targets for allocations from the end of the heap
+        MxVector<Hole> holes;
+        size_t usedEnd = 0;
+        for (const auto& allocation : allocations)
+        {
+            if (allocation.Offset > usedEnd) holes.push_back(Hole{ usedEnd, allocation.Offset - usedEnd });
+            usedEnd = Max(usedEnd, allocation.Offset + allocation.Size);
+        }
+
+        MxVector<BufferMove> moves;
+        if (holes.empty()) return moves;
+
+        // holes only shrink, so allocations larger than the largest hole are skipped without search
+        auto largestHole = [&holes]()
+        {
+            return std::max_element(holes.begin(), holes.end(), [](const Hole& h1, const Hole& h2) { return h1.Size < h2.Size; })->Size;
+        };
+        size_t largestHoleSize = largestHole();
+
+        size_t movedBytes = 0;
+        for (size_t i = allocations.size(); i > 0; i--)
+        {
+            const auto& allocation = allocations[i - 1];
+            if (!allocation.IsMovable || allocation.Size == 0) continue;
+            // smaller allocations below may still fit into remaining budget
+            if (movedBytes + allocation.Size > byteBudget) continue;
+            if (allocation.Size + AlignmentSlack > largestHoleSize) continue;
+
+            // holes are sorted by offset, so search stops at the first hole which is not below allocation
+            size_t alignment = Max(allocation.Alignment, (size_t)1);
+            size_t destination = 0;
+            auto hole = holes.begin();
+            for (; hole != holes.end() && hole->Offset + hole->Size <= allocation.Offset; hole++)
+            {
+                destination = (hole->Offset + alignment - 1) / alignment * alignment;
+                if (destination + allocation.Size + AlignmentSlack <= hole->Offset + hole->Size) break;
+            }
+            if (hole == holes.end() || hole->Offset + hole->Size > allocation.Offset) continue;
+
+            moves.push_back(BufferMove{ i - 1, allocation.Offset, destination, allocation.Size });
+            movedBytes += allocation.Size;
+
+            size_t holeEnd = hole->Offset + hole->Size;
+            bool wasLargest = hole->Size == largestHoleSize;
+            hole->Offset = destination + allocation.Size + AlignmentSlack;
+            hole->Size = holeEnd - hole->Offset;
+            if (wasLargest) largestHoleSize = largestHole();
+        }
+        return moves;
+    }
+
+    size_t BufferAllocator::Defragment(BufferHeap heap, size_t byteBudget)
+    {
+        MAKE_SCOPE_PROFILER("BufferAllocator::Defragment()");
+
+        struct Move { uint32_t Record; size_t From; size_t To; size_t Size; };
+
+        auto sortedRecords = GetSortedHeapRecords(*impl, heap);
+        auto layout = GetHeapLayout(*impl, sortedRecords);
+        auto plan = BufferAllocator::PlanDefragmentation(layout, byteBudget);
+        if (plan.empty()) return 0;
+
+        auto& allocator = GetHeapAllocator(*impl, heap);
+        MxVector<Move> moves;
+        size_t movedBytes = 0;
+        for (const auto& planned : plan)
+        {
+            uint32_t recordIndex = sortedRecords[planned.Allocation];
+            const auto& record = impl->Records[recordIndex];
+
+            // source stays allocated while destinations are chosen, so moves cannot overlap each other
+            size_t newOffset = allocator.Allocate(record.Size);
+            if (newOffset >= record.Offset || newOffset % record.Alignment != 0)
+            {
+                allocator.Deallocate(newOffset);
+                break;
+            }
+            moves.push_back(Move{ recordIndex, record.Offset, newOffset, record.Size });
+            movedBytes += record.Size;
+
+            // if allocator placed block not where plan expected, plan is outdated and will be recomputed next time
+            if (newOffset != planned.To) break;
+        }
+        if (moves.empty()) return 0;
+
+        // copies are recorded with the next frame uploads, before any upload which may reuse freed source ranges. Owners resolve offsets
+        // through handles when they record draws, so the frame which performs copies already reads data from new places
+        auto buffer = GetHeapBuffer(*impl, heap);
+        auto& recordByOffset = impl->RecordByOffset[(size_t)heap];
+        for (const auto& move : moves)
+        {
+            SubmissionQueue::MoveBufferRange(*buffer, move.From, move.To, move.Size);
+            allocator.Deallocate(move.From);
+            recordByOffset.erase(move.From);
+            recordByOffset[move.To] = move.Record;
+            impl->Records[move.Record].Offset = move.To;
+        }
+
+        impl->Stats.DefragmentationMoveCount += moves.size();
+        impl->Stats.DefragmentedBytes += movedBytes;
+        MXLOG_DEBUG("MxEngine::BufferAllocator", MxFormat("defragmentation moved {0} allocations ({1} bytes)", moves.size(), movedBytes));
+        return movedBytes;
+    }
+
+    void BufferAllocator::OnUpdate()
+    {
+        MAKE_SCOPE_PROFILER("BufferAllocator::OnUpdate()");
+
+        // moving data while batch is in progress would reorder relocation copies
+        if (impl->BatchDepth != 0) return;
+
+        constexpr size_t MinWastedBytes = 1024 * 1024;
+        size_t budget = impl->DefragmentationBudget;
+        for (auto heap : { BufferHeap::VERTEX, BufferHeap::INDEX, BufferHeap::INSTANCE, BufferHeap::STORAGE })
+        {
+            if (budget == 0) break;
+            auto fragmentation = BufferAllocator::GetFragmentation(heap);
+            if (fragmentation.Ratio > impl->DefragmentationThreshold && fragmentation.UsedBytes - fragmentation.LiveBytes >= MinWastedBytes)
+                budget -= BufferAllocator::Defragment(heap, budget);
+        }
+    }
+
+    void BufferAllocator::SetDefragmentationBudget(size_t bytesPerFrame)
+    {
+        impl->DefragmentationBudget = bytesPerFrame;
+    }
+
+    size_t BufferAllocator::GetDefragmentationBudget()
+    {
+        return impl->DefragmentationBudget;
+    }
+
+    void BufferAllocator::SetDefragmentationThreshold(float ratio)
+    {
+        impl->DefragmentationThreshold = Clamp(ratio, 0.0f, 1.0f);
+    }
+
+    float BufferAllocator::GetDefragmentationThreshold()
+    {
+        return impl->DefragmentationThreshold;
+    }
+}
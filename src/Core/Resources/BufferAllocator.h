@@ -27,6 +27,9 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "Platform/GraphicAPI.h"
+#include "Utilities/Array/ArrayView.h"
+
+#include <limits>
 
 namespace MxEngine
 {
@@ -38,6 +41,78 @@ namespace MxEngine
         const size_t Size;
     };
 
+    enum class BufferHeap : uint8_t
+    {
+        VERTEX,
+        INDEX,
+        INSTANCE,
+        STORAGE,
+    };
+
+    /*!
+    handle to allocation which may be moved by defragmentation. Owners should query its offset with BufferAllocator::GetAllocation instead of caching it
+    */
+    struct BufferAllocationHandle
+    {
+        static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+        uint32_t Index = InvalidIndex;
+        uint32_t Generation = 0;
+
+        bool IsValid() const { return this->Index != InvalidIndex; }
+    };
+
+    struct BufferFragmentation
+    {
+        // total size of live allocations
+        size_t LiveBytes = 0;
+        // distance from the beginning of the heap to the end of the last live allocation
+        size_t UsedBytes = 0;
+        // part of used range which is wasted by holes between allocations
+        float Ratio = 0.0f;
+    };
+
+    /*!
+    placement of live allocation, as seen by defragmentation planner
+    */
+    struct BufferAllocationInfo
+    {
+        size_t Offset = 0;
+        size_t Size = 0;
+        size_t Alignment = 1;
+        bool IsMovable = false;
+    };
+
+    struct BufferMove
+    {
+        // index of moved allocation in planned layout
+        size_t Allocation = 0;
+        size_t From = 0;
+        size_t To = 0;
+        size_t Size = 0;
+    };
+
+    struct BufferAllocatorStats
+    {
+        // number of times GPU storage was moved to a larger buffer
+        size_t RelocationCount = 0;
+        size_t RelocatedBytes = 0;
+        // number of allocator growths which fit into storage grown ahead by growth factor or reservation
+        size_t AbsorbedGrowthCount = 0;
+        size_t ReservedBytes = 0;
+        // allocations moved by defragmentation and total size of their data
+        size_t DefragmentationMoveCount = 0;
+        size_t DefragmentedBytes = 0;
+    };
+
+    /*!
+    buffer allocator manages shared GPU buffers for vertex, index, instance and shader storage data. When free space is exhausted, storage is moved
+    to a larger buffer. Its size is multiplied by growth factor, so a sequence of allocations causes logarithmic number of relocations. Loaders
+    which know total size of their data ahead can reserve it at once, and several loads can be grouped into a batch, which defers flushing of
+    relocation copies until the batch ends.
+    Allocations made through handles can be moved to lower offsets by defragmentation, which copies limited amount of bytes each frame.
+    Allocations made by raw offset functions are never moved
+    */
     class BufferAllocator
     {
         inline static BufferAllocatorImpl* impl;
@@ -60,5 +135,74 @@ namespace MxEngine
         static void DeallocateInIBO(BufferAllocation allocation);
         static void DeallocateInInstanceVBO(BufferAllocation allocation);
         static void DeallocateInSSBO(BufferAllocation allocation);
+        /*!
+        allocates movable storage in heap
+        \param heap buffer heap to allocate in
+        \param byteSize size of allocation in bytes
+        \param alignment alignment of offset which is preserved when allocation is moved, usually size of one element
+        \returns handle which is valid until Deallocate is called
+        */
+        static BufferAllocationHandle Allocate(BufferHeap heap, size_t byteSize, size_t alignment = 1);
+        static void Deallocate(BufferAllocationHandle handle);
+        /*!
+        gets current placement of allocation. Offset may change between frames if allocation is movable
+        */
+        static BufferAllocation GetAllocation(BufferAllocationHandle handle);
+        /*!
+        forbids or allows defragmentation to move allocation. Used when allocation offset is cached outside of its owner
+        */
+        static void SetMovable(BufferAllocationHandle handle, bool isMovable);
+
+        /*!
+        grows storage so that next allocations with total size of byteSize do not cause relocations
+        \param byteSize total size of upcoming allocations in bytes
+        */
+        static void ReserveInVBO(size_t byteSize);
+        static void ReserveInIBO(size_t byteSize);
+        static void ReserveInInstanceVBO(size_t byteSize);
+        static void ReserveInSSBO(size_t byteSize);
+        /*!
+        starts load batch. Relocations inside batch are not flushed immediately, all of them are submitted at once by EndLoadBatch. Batches can be nested
+        */
+        static void BeginLoadBatch();
+        static void EndLoadBatch();
+        /*!
+        sets how much storage grows on relocation relative to its current size. Factor of 1 makes storage grow exactly to the requested size
+        */
+        static void SetGrowthFactor(float factor);
+        static float GetGrowthFactor();
+        /*!
+        computes size of storage which replaces exhausted one
+        \param currentSize size of current storage in bytes, zero if storage is not created yet
+        \param requestedSize size requested by allocator in bytes
+        \param growthFactor growth factor, values below 1 are treated as 1
+        */
+        static size_t GetGrowthCapacity(size_t currentSize, size_t requestedSize, float growthFactor);
+        static const BufferAllocatorStats& GetStats();
+
+        /*!
+        moves movable allocations of heap into holes below them. Move plan is computed on CPU, copies are submitted with the next frame
+        \param heap heap to compact
+        \param byteBudget maximum number of bytes copied
+        \returns number of bytes copied
+        */
+        static size_t Defragment(BufferHeap heap, size_t byteBudget);
+        static BufferFragmentation GetFragmentation(BufferHeap heap);
+        static BufferFragmentation ComputeFragmentation(ArrayView<BufferAllocationInfo> allocations);
+        /*!
+        plans defragmentation of heap layout. Highest movable allocations are moved first, each into the lowest hole below it which fits it
+        \param allocations live allocations of heap sorted by offset
+        \param byteBudget maximum total size of moved allocations. Allocations which do not fit into remaining budget are skipped
+        \returns moves in the order they should be performed. Destinations do not overlap each other and any allocation of original layout
+        */
+        static MxVector<BufferMove> PlanDefragmentation(ArrayView<BufferAllocationInfo> allocations, size_t byteBudget);
+        /*!
+        defragments heaps which fragmentation exceeds threshold, spending at most defragmentation budget. Called once per frame by application
+        */
+        static void OnUpdate();
+        static void SetDefragmentationBudget(size_t bytesPerFrame);
+        static size_t GetDefragmentationBudget();
+        static void SetDefragmentationThreshold(float ratio);
+        static float GetDefragmentationThreshold();
     };
 }
\ No newline at end of file
@@ -48,30 +48,11 @@ namespace MxEngine
     {
         ObjectInfo objectInfo = ObjectLoader::Load(filepath);
 
-        this->filepath = ToMxString(filepath);
-        std::replace(this->filepath.begin(), this->filepath.end(), '\\', '/');
-
-        MxVector<SubMesh::MaterialId> materialIds;
-        materialIds.reserve(objectInfo.meshes.size());
-        for (const auto& group : objectInfo.meshes)
-        {
-            if (group.useTexture && group.material != nullptr)
-            {
-                auto offset = size_t(group.material - objectInfo.materials.data());
-                materialIds.push_back(offset);
-            }
-            else
-            {
-                materialIds.push_back(std::numeric_limits<SubMesh::MaterialId>::max());
-            }
-        }
-
         // dump all material to let user retrieve them for MeshRenderer component
         FilePath materialLibPath = filepath.native() + MeshRenderer::GetMaterialFileExtenstion().native();
         ObjectLoader::DumpMaterials(objectInfo.materials, materialLibPath);
-
-        // optimize transform additions
-        this->subMeshTransforms.reserve(objectInfo.meshes.size());
+        // textures are cooked at import, so upload path reads compressed mip chains from cache
+        ObjectLoader::CookTextures(objectInfo.materials, objectInfo.textures);
 
         // precompute and allocate size for per-mesh Vertex Buffer and Index Buffer
         size_t totalVerticies = 0;
@@ -89,33 +70,69 @@ namespace MxEngine
         this->ReserveData(totalVerticies, totalIndicies);
 
         // insert all verticies and indicies into single VBO/IBO
-        for (size_t i = 0; i < objectInfo.meshes.size(); i++)
+        for (const auto& meshInfo : objectInfo.meshes)
         {
-            auto& meshInfo = objectInfo.meshes[i];
-            auto& materialId = materialIds[i];
-
-            MeshData meshData{
-                meshInfo.vertecies.size(), verticies.size() + this->vertexAllocation.Offset / sizeof(Vertex),
-                meshInfo.indicies.size(), indicies.size() + this->indexAllocation.Offset / sizeof(uint32_t)
-            };
-            meshData.UpdateBoundingGeometry(meshInfo.vertecies);
-
             indicies.insert(indicies.end(), meshInfo.indicies.begin(), meshInfo.indicies.end());
             verticies.insert(verticies.end(), meshInfo.vertecies.begin(), meshInfo.vertecies.end());
+        }
+        // load verticies and indicies to GPU
+        SubmissionQueue::CopyToBuffer(MakeView(verticies), *BufferAllocator::GetVBO(), this->GetBaseVerteciesOffset() * sizeof(Vertex));
+        SubmissionQueue::CopyToBuffer(MakeView(indicies), *BufferAllocator::GetIBO(), this->GetBaseIndiciesOffset() * sizeof(uint32_t));
+
+        this->CreateSubMeshes(filepath, objectInfo);
+    }
+
+    void Mesh::CreateSubMeshes(const FilePath& filepath, const ObjectInfo& objectInfo)
+    {
+        this->filepath = ToMxString(filepath);
+        std::replace(this->filepath.begin(), this->filepath.end(), '\\', '/');
+
+        // optimize transform additions
+        this->subMeshTransforms.reserve(objectInfo.meshes.size());
+
+        // submeshes are placed one after another inside storage reserved by ReserveData
+        size_t vertexOffset = this->GetBaseVerteciesOffset();
+        size_t indexOffset = this->GetBaseIndiciesOffset();
+        for (const auto& meshInfo : objectInfo.meshes)
+        {
+            auto materialId = std::numeric_limits<SubMesh::MaterialId>::max();
+            if (meshInfo.useTexture && meshInfo.material != nullptr)
+                materialId = size_t(meshInfo.material - objectInfo.materials.data());
+
+            MeshData meshData{ meshInfo.vertecies.size(), vertexOffset, meshInfo.indicies.size(), indexOffset };
+            meshData.UpdateBoundingGeometry(meshInfo.vertecies);
+            meshData.SetMeshlets(meshInfo.meshlets);
+            if (this->isCPUAccessible) meshData.SetCPUShadow(meshInfo.vertecies, meshInfo.indicies);
+            vertexOffset += meshInfo.vertecies.size();
+            indexOffset += meshInfo.indicies.size();
 
             this->AddSubMesh(materialId, std::move(meshData));
         }
-        // load verticies and indicies to GPU
-        SubmissionQueue::CopyToBuffer(MakeView(verticies), *BufferAllocator::GetVBO(), this->vertexAllocation.Offset);
-        SubmissionQueue::CopyToBuffer(MakeView(indicies), *BufferAllocator::GetIBO(), this->indexAllocation.Offset);
 
         this->UpdateBoundingGeometry(); // use submeshes boundings to update mesh boundings
     }
 
+    void Mesh::Unload()
+    {
+        this->FreeBuffers();
+        this->vertexAllocation = MoveOnlyAllocation{ };
+        this->indexAllocation = MoveOnlyAllocation{ };
+        this->submeshes.clear();
+        this->subMeshTransforms.clear();
+        this->UpdateBoundingGeometry();
+    }
+
+    bool Mesh::IsLoaded() const
+    {
+        return !this->submeshes.empty();
+    }
+
     void Mesh::FreeBuffers()
     {
-        if (this->vertexAllocation.Size != 0) BufferAllocator::DeallocateInVBO({ this->vertexAllocation.Offset, this->vertexAllocation.Size });
-        if (this->indexAllocation.Size != 0) BufferAllocator::DeallocateInIBO({ this->indexAllocation.Offset, this->indexAllocation.Size });
+        if (this->vertexAllocation.Handle.IsValid()) BufferAllocator::Deallocate(this->vertexAllocation.Handle);
+        if (this->indexAllocation.Handle.IsValid()) BufferAllocator::Deallocate(this->indexAllocation.Handle);
+        this->vertexAllocation.Handle = BufferAllocationHandle{ };
+        this->indexAllocation.Handle = BufferAllocationHandle{ };
     }
 
     Mesh::Mesh()
@@ -150,13 +167,10 @@ namespace MxEngine
     {
         this->FreeBuffers();
 
-        auto vbo = BufferAllocator::AllocateInVBO(vertexCount * sizeof(Vertex));
-        auto ibo = BufferAllocator::AllocateInIBO(indexCount * sizeof(uint32_t));
-
-        this->vertexAllocation.Offset = vbo.Offset;
-        this->vertexAllocation.Size = vbo.Size;
-        this->indexAllocation.Offset = ibo.Offset;
-        this->indexAllocation.Size = ibo.Size;
+        this->vertexAllocation.Handle = BufferAllocator::Allocate(BufferHeap::VERTEX, vertexCount * sizeof(Vertex), sizeof(Vertex));
+        this->indexAllocation.Handle = BufferAllocator::Allocate(BufferHeap::INDEX, indexCount * sizeof(uint32_t), sizeof(uint32_t));
+        this->vertexAllocation.Size = BufferAllocator::GetAllocation(this->vertexAllocation.Handle).Size;
+        this->indexAllocation.Size = BufferAllocator::GetAllocation(this->indexAllocation.Handle).Size;
     }
 
     void Mesh::UpdateBoundingGeometry()
@@ -196,12 +210,30 @@ namespace MxEngine
 
     size_t Mesh::GetBaseVerteciesOffset() const
     {
-        return this->vertexAllocation.Offset / sizeof(Vertex);
+        return BufferAllocator::GetAllocation(this->vertexAllocation.Handle).Offset / sizeof(Vertex);
     }
 
     size_t Mesh::GetBaseIndiciesOffset() const
     {
-        return this->indexAllocation.Offset / sizeof(uint32_t);
+        return BufferAllocator::GetAllocation(this->indexAllocation.Handle).Offset / sizeof(uint32_t);
+    }
+
+    void Mesh::SetCPUAccessible(bool value)
+    {
+        this->isCPUAccessible = value;
+        for (auto& submesh : this->submeshes)
+            submesh.Data.SetCPUAccessible(value);
+    }
+
+    bool Mesh::IsCPUAccessible() const
+    {
+        return this->isCPUAccessible;
+    }
+
+    void Mesh::SetBuffersMovable(bool isMovable)
+    {
+        BufferAllocator::SetMovable(this->vertexAllocation.Handle, isMovable);
+        BufferAllocator::SetMovable(this->indexAllocation.Handle, isMovable);
     }
 
     const MxString& Mesh::GetFilePath() const
@@ -243,6 +275,10 @@ namespace MxEngine
 
     SubMesh& Mesh::AddSubMesh(SubMesh::MaterialId materialId, MeshData data)
     {
+        // submesh follows mesh storage when it is moved by defragmentation
+        if (this->vertexAllocation.Handle.IsValid())
+            data.SetBufferAllocations(this->vertexAllocation.Handle, this->indexAllocation.Handle);
+
         auto& transform = *this->subMeshTransforms.emplace_back(MakeUnique<Transform>());
         return this->submeshes.emplace_back(materialId, transform, std::move(data));
     }
@@ -258,14 +294,14 @@ namespace MxEngine
 
     MoveOnlyAllocation::MoveOnlyAllocation(MoveOnlyAllocation&& other) noexcept
     {
-        this->Offset = other.Offset, this->Size = other.Size;
-        other.Offset = other.Size = 0;
+        this->Handle = other.Handle, this->Offset = other.Offset, this->Size = other.Size;
+        other.Handle = BufferAllocationHandle{ }, other.Offset = other.Size = 0;
     }
 
     MoveOnlyAllocation& MoveOnlyAllocation::operator=(MoveOnlyAllocation&& other) noexcept
     {
-        this->Offset = other.Offset, this->Size = other.Size;
-        other.Offset = other.Size = 0;
+        this->Handle = other.Handle, this->Offset = other.Offset, this->Size = other.Size;
+        other.Handle = BufferAllocationHandle{ }, other.Offset = other.Size = 0;
         return *this;
     }
 
@@ -30,16 +30,20 @@
 
 #include "Core/Components/Transform.h"
 #include "Utilities/String/String.h"
+#include "Utilities/FileSystem/File.h"
 #include "Utilities/Memory/Memory.h"
 #include "Platform/GraphicAPI.h"
 #include "Core/Resources/SubMesh.h"
+#include "Core/Resources/BufferAllocator.h"
 
 namespace MxEngine
 {
     class MeshRenderer;
+    struct ObjectInfo;
     
     struct MoveOnlyAllocation
     {
+        BufferAllocationHandle Handle;
         size_t Offset{ };
         size_t Size{ };
 
@@ -58,6 +62,7 @@ namespace MxEngine
         MoveOnlyAllocation vertexAllocation;
         MoveOnlyAllocation indexAllocation;
         MxVector<UniqueRef<Transform>> subMeshTransforms;
+        bool isCPUAccessible = false;
 
         template<typename FilePath>
         void LoadFromFile(const FilePath& filepath);
@@ -80,11 +85,20 @@ namespace MxEngine
         template<typename FilePath> void Load(const FilePath& filepath);
 
         void ReserveData(size_t vertexCount, size_t indexCount);
+        void CreateSubMeshes(const FilePath& filepath, const ObjectInfo& objectInfo);
+        void Unload();
+        bool IsLoaded() const;
         void UpdateBoundingGeometry();
         size_t GetTotalVerteciesCount() const;
         size_t GetTotalIndiciesCount() const;
         size_t GetBaseVerteciesOffset() const;
         size_t GetBaseIndiciesOffset() const;
+        void SetBuffersMovable(bool isMovable);
+        /*!
+        makes submeshes keep CPU copies of their data, see MeshData::SetCPUAccessible. Also applies to data loaded later
+        */
+        void SetCPUAccessible(bool value);
+        bool IsCPUAccessible() const;
         void SetSubMeshesInternal(const SubMeshList& submeshes);
         const SubMeshList& GetSubMeshes() const;
         const SubMesh& GetSubMeshByIndex(size_t index) const;
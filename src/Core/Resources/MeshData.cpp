@@ -31,10 +31,213 @@
 #include "Core/Resources/BufferAllocator.h"
 #include "Core/Rendering/RenderGraph/SubmissionQueue.h"
 
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/Profiler/Profiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MXENGINE_MESH_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX__)
+#define MXENGINE_MESH_AVX
+#include <immintrin.h>
+#endif
+
 namespace MxEngine
 {
     using namespace VulkanAbstractionLayer;
 
+    static AABB ComputeChunkBoundingBox(const Vertex* begin, const Vertex* end)
+    {
+        #if defined(MXENGINE_MESH_SSE2)
+        // position is followed by texture coordinates inside vertex, so loading four floats does not leave its memory. Fourth lane is ignored
+        static_assert(offsetof(Vertex, TexCoord) == offsetof(Vertex, Position) + sizeof(Vector3));
+        __m128 minimum = _mm_loadu_ps(&begin->Position.x);
+        __m128 maximum = minimum;
+        for (const Vertex* vertex = begin; vertex != end; vertex++)
+        {
+            __m128 position = _mm_loadu_ps(&vertex->Position.x);
+            minimum = _mm_min_ps(minimum, position);
+            maximum = _mm_max_ps(maximum, position);
+        }
+        alignas(16) float minValues[4], maxValues[4];
+        _mm_store_ps(minValues, minimum);
+        _mm_store_ps(maxValues, maximum);
+        return AABB{ MakeVector3(minValues[0], minValues[1], minValues[2]), MakeVector3(maxValues[0], maxValues[1], maxValues[2]) };
+        #else
+        AABB result{ begin->Position, begin->Position };
+        for (const Vertex* vertex = begin; vertex != end; vertex++)
+        {
+            result.Min = VectorMin(result.Min, vertex->Position);
+            result.Max = VectorMax(result.Max, vertex->Position);
+        }
+        return result;
+        #endif
+    }
+
+    // sums of normal-space vectors over a range of vertecies, stored as separate arrays of x, y and z components
+    struct VertexSpaceAccumulator
+    {
+        size_t FirstVertex = 0;
+        size_t VertexCount = 0;
+        MxVector<float> Components;
+
+        float* GetComponent(size_t vector, size_t component)
+        {
+            return this->Components.data() + (vector * 3 + component) * this->VertexCount;
+        }
+    };
+
+    static void NormalizeComponents(float* x, float* y, float* z, size_t count)
+    {
+        size_t i = 0;
+        #if defined(MXENGINE_MESH_AVX)
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 vx = _mm256_loadu_ps(x + i);
+            __m256 vy = _mm256_loadu_ps(y + i);
+            __m256 vz = _mm256_loadu_ps(z + i);
+            __m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)), _mm256_mul_ps(vz, vz)));
+            _mm256_storeu_ps(x + i, _mm256_div_ps(vx, length));
+            _mm256_storeu_ps(y + i, _mm256_div_ps(vy, length));
+            _mm256_storeu_ps(z + i, _mm256_div_ps(vz, length));
+        }
+        #endif
+        #if defined(MXENGINE_MESH_SSE2)
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 vx = _mm_loadu_ps(x + i);
+            __m128 vy = _mm_loadu_ps(y + i);
+            __m128 vz = _mm_loadu_ps(z + i);
+            __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz)));
+            _mm_storeu_ps(x + i, _mm_div_ps(vx, length));
+            _mm_storeu_ps(y + i, _mm_div_ps(vy, length));
+            _mm_storeu_ps(z + i, _mm_div_ps(vz, length));
+        }
+        #endif
+        for (; i < count; i++)
+        {
+            float length = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+            x[i] /= length, y[i] /= length, z[i] /= length;
+        }
+    }
+
+    static void AccumulateVertexSpace(const MeshData::VertexData& vertecies, const MeshData::IndexData& indicies,
+        size_t triangleBegin, size_t triangleEnd, bool regenerateNormals, VertexSpaceAccumulator& accumulator)
+    {
+        if (triangleBegin == triangleEnd) return;
+
+        // accumulator covers only vertecies referenced by its triangles, which is a small range for most meshes
+        auto [minIndex, maxIndex] = std::minmax_element(indicies.begin() + 3 * triangleBegin, indicies.begin() + 3 * triangleEnd);
+        size_t vectorCount = regenerateNormals ? 3 : 2;
+        accumulator.FirstVertex = *minIndex;
+        accumulator.VertexCount = size_t(*maxIndex - *minIndex) + 1;
+        accumulator.Components.assign(vectorCount * 3 * accumulator.VertexCount, 0.0f);
+
+        float* components[3][3];
+        for (size_t vector = 0; vector < vectorCount; vector++)
+        {
+            for (size_t component = 0; component < 3; component++)
+                components[vector][component] = accumulator.GetComponent(vector, component);
+        }
+
+        for (size_t i = triangleBegin; i < triangleEnd; i++)
+        {
+            size_t triangle[3] = { indicies[3 * i + 0], indicies[3 * i + 1], indicies[3 * i + 2] };
+            const auto& v1 = vertecies[triangle[0]];
+            const auto& v2 = vertecies[triangle[1]];
+            const auto& v3 = vertecies[triangle[2]];
+
+            Vector3 vectors[3];
+            auto tanbitan = ComputeTangentSpace(v1.Position, v2.Position, v3.Position, v1.TexCoord, v2.TexCoord, v3.TexCoord);
+            vectors[vectorCount - 2] = tanbitan[0];
+            vectors[vectorCount - 1] = tanbitan[1];
+            if (regenerateNormals) vectors[0] = ComputeNormal(v1.Position, v2.Position, v3.Position);
+
+            for (size_t j = 0; j < 3; j++)
+            {
+                // vertex which is repeated inside degenerate triangle gets its vectors only once
+                if ((j > 0 && triangle[j] == triangle[0]) || (j > 1 && triangle[j] == triangle[1])) continue;
+
+                size_t local = triangle[j] - accumulator.FirstVertex;
+                for (size_t vector = 0; vector < vectorCount; vector++)
+                {
+                    components[vector][0][local] += vectors[vector].x;
+                    components[vector][1][local] += vectors[vector].y;
+                    components[vector][2][local] += vectors[vector].z;
+                }
+            }
+        }
+    }
+
+    static void RegenerateVertexSpace(MeshData::VertexData& vertecies, const MeshData::IndexData& indicies, bool regenerateNormals)
+    {
+        constexpr size_t TriangleGrainSize = 16 * 1024;
+        constexpr size_t VertexGrainSize = 4 * 1024;
+        constexpr size_t TileSize = 256;
+
+        // first phase: every chunk of triangles sums its vectors into its own accumulator, so no synchronization is needed
+        size_t triangleCount = indicies.size() / 3;
+        size_t chunkCount = Max(Min(ThreadPool::GetWorkerCount() + 1, (triangleCount + TriangleGrainSize - 1) / TriangleGrainSize), (size_t)1);
+        size_t chunkSize = (triangleCount + chunkCount - 1) / chunkCount;
+        MxVector<VertexSpaceAccumulator> accumulators(chunkCount);
+        ThreadPool::ParallelFor(chunkCount, 1, [&](size_t begin, size_t end)
+        {
+            for (size_t chunk = begin; chunk < end; chunk++)
+            {
+                AccumulateVertexSpace(vertecies, indicies, Min(chunk * chunkSize, triangleCount), Min((chunk + 1) * chunkSize, triangleCount),
+                    regenerateNormals, accumulators[chunk]);
+            }
+        });
+
+        // second phase: accumulators are reduced tile by tile, then vectors of tile are normalized and written to vertecies
+        size_t vectorCount = regenerateNormals ? 3 : 2;
+        ThreadPool::ParallelFor(vertecies.size(), VertexGrainSize, [&](size_t begin, size_t end)
+        {
+            alignas(32) float tile[3][3][TileSize];
+            for (size_t tileBegin = begin; tileBegin < end; tileBegin += TileSize)
+            {
+                size_t tileEnd = Min(tileBegin + TileSize, end);
+                size_t tileCount = tileEnd - tileBegin;
+                std::memset(tile, 0, sizeof(tile));
+
+                for (auto& accumulator : accumulators)
+                {
+                    size_t first = Max(tileBegin, accumulator.FirstVertex);
+                    size_t last = Min(tileEnd, accumulator.FirstVertex + accumulator.VertexCount);
+                    if (first >= last) continue;
+
+                    for (size_t vector = 0; vector < vectorCount; vector++)
+                    {
+                        for (size_t component = 0; component < 3; component++)
+                        {
+                            const float* source = accumulator.GetComponent(vector, component) + (first - accumulator.FirstVertex);
+                            float* destination = tile[vector][component] + (first - tileBegin);
+                            for (size_t i = 0; i < last - first; i++)
+                                destination[i] += source[i];
+                        }
+                    }
+                }
+
+                for (size_t vector = 0; vector < vectorCount; vector++)
+                    NormalizeComponents(tile[vector][0], tile[vector][1], tile[vector][2], tileCount);
+
+                for (size_t i = 0; i < tileCount; i++)
+                {
+                    auto& vertex = vertecies[tileBegin + i];
+                    if (regenerateNormals) vertex.Normal = MakeVector3(tile[0][0][i], tile[0][1][i], tile[0][2][i]);
+                    vertex.Tangent = MakeVector3(tile[vectorCount - 2][0][i], tile[vectorCount - 2][1][i], tile[vectorCount - 2][2][i]);
+                    vertex.Bitangent = MakeVector3(tile[vectorCount - 1][0][i], tile[vectorCount - 1][1][i], tile[vectorCount - 1][2][i]);
+                }
+            }
+        });
+    }
+
     MeshData::MeshData(size_t vertexCount, size_t vertexOffset, size_t indexCount, size_t indexOffset)
         : vertexCount(vertexCount), vertexOffset(vertexOffset), indexCount(indexCount), indexOffset(indexOffset)
     {
@@ -52,14 +255,34 @@ namespace MxEngine
         return BufferAllocator::GetIBO();
     }
 
+    static size_t GetAllocationBase(BufferAllocationHandle allocation, size_t elementSize)
+    {
+        // data which is not bound to allocation keeps absolute offsets
+        return allocation.IsValid() ? BufferAllocator::GetAllocation(allocation).Offset / elementSize : 0;
+    }
+
     size_t MeshData::GetVerteciesOffset() const
     {
-        return this->vertexOffset;
+        return GetAllocationBase(this->vertexAllocation, sizeof(Vertex)) + this->vertexOffset;
     }
 
     size_t MeshData::GetIndiciesOffset() const
     {
-        return this->indexOffset;
+        return GetAllocationBase(this->indexAllocation, sizeof(uint32_t)) + this->indexOffset;
+    }
+
+    void MeshData::SetBufferAllocations(BufferAllocationHandle vertexAllocation, BufferAllocationHandle indexAllocation)
+    {
+        size_t vertexOffset = this->GetVerteciesOffset();
+        size_t indexOffset = this->GetIndiciesOffset();
+        size_t vertexBase = GetAllocationBase(vertexAllocation, sizeof(Vertex));
+        size_t indexBase = GetAllocationBase(indexAllocation, sizeof(uint32_t));
+        MX_ASSERT(vertexOffset >= vertexBase && indexOffset >= indexBase);
+
+        this->vertexAllocation = vertexAllocation;
+        this->indexAllocation = indexAllocation;
+        this->vertexOffset = vertexOffset - vertexBase;
+        this->indexOffset = indexOffset - indexBase;
     }
 
     const AABB& MeshData::GetAABB() const
@@ -85,40 +308,124 @@ namespace MxEngine
     void MeshData::BufferVertecies(const VertexData& vertecies)
     {
         MX_ASSERT(vertecies.size() == this->vertexCount);
-        SubmissionQueue::CopyToBuffer(MakeView(vertecies), *this->GetVBO(), this->vertexOffset * sizeof(Vertex));
+        SubmissionQueue::CopyToBuffer(MakeView(vertecies), *this->GetVBO(), this->GetVerteciesOffset() * sizeof(Vertex));
+        if (this->shadow != nullptr) this->shadow->Vertecies = vertecies;
+        this->RebuildMeshlets();
     }
 
     void MeshData::BufferIndicies(const IndexData& indicies)
     {
         MX_ASSERT(indicies.size() == this->indexCount);
-        SubmissionQueue::CopyToBuffer(MakeView(indicies), *this->GetIBO(), this->indexOffset * sizeof(uint32_t));
+        SubmissionQueue::CopyToBuffer(MakeView(indicies), *this->GetIBO(), this->GetIndiciesOffset() * sizeof(uint32_t));
+        if (this->shadow != nullptr) this->shadow->Indicies = indicies;
+        this->RebuildMeshlets();
     }
 
-    void MeshData::UpdateBoundingGeometry(const VertexData& vertecies)
+    void MeshData::RebuildMeshlets()
+    {
+        if (this->meshlets == nullptr) return;
+        // meshlets are shared with copies of mesh data, so they are updated in place. Without CPU copy new data is unknown, and meshlets are dropped
+        if (this->shadow != nullptr)
+            *this->meshlets = MeshletBuilder::Build(this->shadow->Vertecies, this->shadow->Indicies);
+        else
+            this->meshlets->clear();
+    }
+
+    static size_t GetBoundingChunkCount(size_t vertexCount)
     {
-        this->boundingBox = { MakeVector3(0.0f), MakeVector3(0.0f) };
-        if (vertecies.size() > 0)
+        constexpr size_t GrainSize = 16 * 1024;
+        return Min(ThreadPool::GetWorkerCount() + 1, (vertexCount + GrainSize - 1) / GrainSize);
+    }
+
+    AABB MeshData::ComputeBoundingBox(const VertexData& vertecies)
+    {
+        if (vertecies.empty()) return AABB{ MakeVector3(0.0f), MakeVector3(0.0f) };
+
+        // each chunk computes its own bounds, which are reduced after all chunks are done
+        size_t chunkCount = GetBoundingChunkCount(vertecies.size());
+        size_t chunkSize = (vertecies.size() + chunkCount - 1) / chunkCount;
+        MxVector<AABB> chunkBoxes(chunkCount);
+        ThreadPool::ParallelFor(chunkCount, 1, [&](size_t begin, size_t end)
         {
-            this->boundingBox = { vertecies[0].Position, vertecies[0].Position };
-            for (const auto& vertex : vertecies)
+            for (size_t chunk = begin; chunk < end; chunk++)
+                chunkBoxes[chunk] = ComputeChunkBoundingBox(vertecies.data() + chunk * chunkSize, vertecies.data() + Min((chunk + 1) * chunkSize, vertecies.size()));
+        });
+
+        AABB result = chunkBoxes.front();
+        for (const auto& box : chunkBoxes)
+        {
+            result.Min = VectorMin(result.Min, box.Min);
+            result.Max = VectorMax(result.Max, box.Max);
+        }
+        return result;
+    }
+
+    BoundingSphere MeshData::ComputeBoundingSphere(const VertexData& vertecies, const Vector3& center)
+    {
+        if (vertecies.empty()) return BoundingSphere(center, 0.0f);
+
+        size_t chunkCount = GetBoundingChunkCount(vertecies.size());
+        size_t chunkSize = (vertecies.size() + chunkCount - 1) / chunkCount;
+        MxVector<float> chunkRadius(chunkCount, 0.0f);
+        ThreadPool::ParallelFor(chunkCount, 1, [&](size_t begin, size_t end)
+        {
+            for (size_t chunk = begin; chunk < end; chunk++)
             {
-                this->boundingBox.Min = VectorMin(this->boundingBox.Min, vertex.Position);
-                this->boundingBox.Max = VectorMax(this->boundingBox.Max, vertex.Position);
+                float maxRadius = 0.0f;
+                for (size_t i = chunk * chunkSize; i < Min((chunk + 1) * chunkSize, vertecies.size()); i++)
+                    maxRadius = Max(maxRadius, Length2(vertecies[i].Position - center));
+                chunkRadius[chunk] = maxRadius;
             }
-        }
+        });
+        return BoundingSphere(center, std::sqrt(*std::max_element(chunkRadius.begin(), chunkRadius.end())));
+    }
 
-        auto center = this->boundingBox.GetCenter();
-        float maxRadius = 0.0f;
-        for (const auto& vertex : vertecies)
+    void MeshData::UpdateBoundingGeometry(const VertexData& vertecies)
+    {
+        MAKE_SCOPE_PROFILER("MeshData::UpdateBoundingGeometry()");
+        this->boundingBox = MeshData::ComputeBoundingBox(vertecies);
+        this->boundingSphere = MeshData::ComputeBoundingSphere(vertecies, this->boundingBox.GetCenter());
+    }
+
+    void MeshData::SetCPUAccessible(bool value)
+    {
+        if (!value)
         {
-            auto distance = vertex.Position - center;
-            maxRadius = Max(maxRadius, Length2(distance));
+            this->shadow.reset();
+            return;
         }
-        this->boundingSphere = BoundingSphere(center, std::sqrt(maxRadius));
+        if (this->shadow != nullptr) return;
+
+        this->SetCPUShadow(this->GetVerteciesFromGPU(), this->GetIndiciesFromGPU());
+    }
+
+    bool MeshData::IsCPUAccessible() const
+    {
+        return this->shadow != nullptr;
+    }
+
+    void MeshData::SetCPUShadow(VertexData vertecies, IndexData indicies)
+    {
+        MX_ASSERT(vertecies.size() == this->vertexCount && indicies.size() == this->indexCount);
+        this->shadow = MakeRef<CPUShadow>(CPUShadow{ std::move(vertecies), std::move(indicies) });
+    }
+
+    void MeshData::SetMeshlets(MxVector<Meshlet> meshlets)
+    {
+        MX_ASSERT(meshlets.empty() || meshlets.back().IndexOffset + meshlets.back().IndexCount == this->indexCount);
+        this->meshlets = meshlets.empty() ? nullptr : MakeRef<MxVector<Meshlet>>(std::move(meshlets));
+    }
+
+    const MxVector<Meshlet>& MeshData::GetMeshlets() const
+    {
+        static const MxVector<Meshlet> empty;
+        return this->meshlets != nullptr ? *this->meshlets : empty;
     }
 
     MeshData::VertexData MeshData::GetVerteciesFromGPU() const
     {
+        if (this->shadow != nullptr) return this->shadow->Vertecies;
+
         VertexData result(this->GetVerteciesCount());
         SubmissionQueue::CopyFromBuffer((uint8_t*)result.data(), result.size() * sizeof(Vertex), *this->GetVBO(), this->GetVerteciesOffset() * sizeof(Vertex));
         return result;
@@ -126,100 +433,59 @@ namespace MxEngine
 
     MeshData::IndexData MeshData::GetIndiciesFromGPU() const
     {
+        if (this->shadow != nullptr) return this->shadow->Indicies;
+
         IndexData result(this->GetIndiciesCount());
-        SubmissionQueue::CopyFromBuffer((uint8_t*)result.data(), result.size() * sizeof(uint32_t), *this->GetVBO(), this->GetIndiciesOffset() * sizeof(uint32_t));
+        SubmissionQueue::CopyFromBuffer((uint8_t*)result.data(), result.size() * sizeof(uint32_t), *this->GetIBO(), this->GetIndiciesOffset() * sizeof(uint32_t));
         return result;
     }
 
-    void MeshData::RegenerateNormals(VertexData& vertecies, const IndexData& indicies)
+    template<typename T>
+    static std::future<MxVector<T>> ReadBufferAsync(const Buffer& buffer, size_t offset, size_t count)
     {
-        // first set all normal-space vectors to 0
-        for (auto& vertex : vertecies)
+        auto promise = MakeRef<std::promise<MxVector<T>>>();
+        auto future = promise->get_future();
+        SubmissionQueue::CopyFromBufferAsync(count * sizeof(T), buffer, offset * sizeof(T), [promise](const uint8_t* data, size_t byteSize)
         {
-            vertex.Normal    = MakeVector3(0.0f);
-            vertex.Tangent   = MakeVector3(0.0f);
-            vertex.Bitangent = MakeVector3(0.0f);
-        }
-
-        // then compute normal space vectors for each triangle
-        for (size_t i = 0; i < indicies.size() / 3; i++)
-        {
-            std::array triangle = { // copy 3 vertecies
-                vertecies[indicies[3 * i + 0]],
-                vertecies[indicies[3 * i + 1]],
-                vertecies[indicies[3 * i + 2]],
-            };
-
-            auto normal = ComputeNormal(triangle[0].Position, triangle[1].Position, triangle[2].Position);
-            auto tanbitan = ComputeTangentSpace(
-                triangle[0].Position, triangle[1].Position, triangle[2].Position,
-                triangle[0].TexCoord, triangle[1].TexCoord, triangle[2].TexCoord
-            );
-
-            for (auto& vertex : triangle)
-            {
-                vertex.Normal += normal;
-                vertex.Tangent += tanbitan[0];
-                vertex.Bitangent += tanbitan[1];
-            }
-            
-            for (size_t j = 0; j < triangle.size(); j++)
-            {
-                vertecies[indicies[3 * i + j]] = triangle[j]; // reassign copied vertecies
-            }
-        }
+            MxVector<T> result(byteSize / sizeof(T));
+            if (byteSize != 0) std::memcpy((uint8_t*)result.data(), data, byteSize);
+            promise->set_value(std::move(result));
+        });
+        return future;
+    }
 
-        // at the end normalize all normal-space vectors using vertex weights
-        for (size_t i = 0; i < vertecies.size(); i++)
+    std::future<MeshData::VertexData> MeshData::GetVerteciesFromGPUAsync() const
+    {
+        if (this->shadow != nullptr)
         {
-            vertecies[i].Normal    = Normalize(vertecies[i].Normal);
-            vertecies[i].Tangent   = Normalize(vertecies[i].Tangent);
-            vertecies[i].Bitangent = Normalize(vertecies[i].Bitangent);
+            std::promise<VertexData> promise;
+            promise.set_value(this->shadow->Vertecies);
+            return promise.get_future();
         }
+        return ReadBufferAsync<Vertex>(*this->GetVBO(), this->GetVerteciesOffset(), this->vertexCount);
     }
 
-    // TODO: remove code dublication (see RegenerateNormals())
-    void MeshData::RegenerateTangentSpace(VertexData& vertecies, const IndexData& indicies)
+    std::future<MeshData::IndexData> MeshData::GetIndiciesFromGPUAsync() const
     {
-        // first set all normal-space vectors to 0
-        for (auto& vertex : vertecies)
+        if (this->shadow != nullptr)
         {
-            vertex.Tangent = MakeVector3(0.0f);
-            vertex.Bitangent = MakeVector3(0.0f);
+            std::promise<IndexData> promise;
+            promise.set_value(this->shadow->Indicies);
+            return promise.get_future();
         }
+        return ReadBufferAsync<uint32_t>(*this->GetIBO(), this->GetIndiciesOffset(), this->indexCount);
+    }
 
-        // then compute normal space vectors for each triangle
-        for (size_t i = 0; i < indicies.size() / 3; i++)
-        {
-            std::array triangle = { // copy 3 vertecies
-                vertecies[indicies[3 * i + 0]],
-                vertecies[indicies[3 * i + 1]],
-                vertecies[indicies[3 * i + 2]],
-            };
-
-            auto tanbitan = ComputeTangentSpace(
-                triangle[0].Position, triangle[1].Position, triangle[2].Position,
-                triangle[0].TexCoord, triangle[1].TexCoord, triangle[2].TexCoord
-            );
-
-            for (auto& vertex : triangle)
-            {
-                vertex.Tangent += tanbitan[0];
-                vertex.Bitangent += tanbitan[1];
-            }
-
-            for (size_t j = 0; j < triangle.size(); j++)
-            {
-                vertecies[indicies[3 * i + j]] = triangle[j]; // reassign copied vertecies
-            }
-        }
+    void MeshData::RegenerateNormals(VertexData& vertecies, const IndexData& indicies)
+    {
+        MAKE_SCOPE_PROFILER("MeshData::RegenerateNormals()");
+        RegenerateVertexSpace(vertecies, indicies, true);
+    }
 
-        // at the end normalize all normal-space vectors using vertex weights
-        for (size_t i = 0; i < vertecies.size(); i++)
-        {
-            vertecies[i].Tangent = Normalize(vertecies[i].Tangent);
-            vertecies[i].Bitangent = Normalize(vertecies[i].Bitangent);
-        }
+    void MeshData::RegenerateTangentSpace(VertexData& vertecies, const IndexData& indicies)
+    {
+        MAKE_SCOPE_PROFILER("MeshData::RegenerateTangentSpace()");
+        RegenerateVertexSpace(vertecies, indicies, false);
     }
 
     MXENGINE_REFLECT_TYPE
@@ -30,8 +30,13 @@
 
 #include "Core/Components/Transform.h"
 #include "Platform/GraphicAPI.h"
+#include "Core/Resources/BufferAllocator.h"
 #include "Core/BoundingObjects/BoundingSphere.h"
+#include "Utilities/Memory/Memory.h"
 #include "Vertex.h"
+#include "Meshlet.h"
+
+#include <future>
 
 namespace MxEngine
 {
@@ -41,11 +46,24 @@ namespace MxEngine
         using VertexData = MxVector<Vertex>;
         using IndexData = MxVector<uint32_t>;
     private:
+        struct CPUShadow
+        {
+            VertexData Vertecies;
+            IndexData Indicies;
+        };
+
         AABB boundingBox;
         BoundingSphere boundingSphere;
 
         size_t vertexCount, vertexOffset;
         size_t indexCount, indexOffset;
+        // offsets above are relative to these allocations, as defragmentation may move them at any time
+        BufferAllocationHandle vertexAllocation, indexAllocation;
+        // copies of mesh data share GPU storage, so they share its CPU copy too
+        Ref<CPUShadow> shadow;
+        Ref<MxVector<Meshlet>> meshlets;
+
+        void RebuildMeshlets();
     public:
         MeshData(size_t vertexCount, size_t vertexOffset, size_t indexCount, size_t indexOffset);
 
@@ -53,6 +71,7 @@ namespace MxEngine
         BufferHandle GetIBO() const;
         size_t GetVerteciesOffset() const;
         size_t GetIndiciesOffset() const;
+        void SetBufferAllocations(BufferAllocationHandle vertexAllocation, BufferAllocationHandle indexAllocation);
         const AABB& GetAABB() const;
         const BoundingSphere& GetBoundingSphere() const;
         
@@ -62,10 +81,41 @@ namespace MxEngine
         void BufferIndicies(const IndexData& indicies);
         void UpdateBoundingGeometry(const VertexData& vertecies);
 
+        /*!
+        makes mesh data keep CPU copy of vertecies and indicies, which is returned by GPU readback functions instead of reading GPU memory.
+        When enabled, current data is read from GPU once
+        */
+        void SetCPUAccessible(bool value);
+        bool IsCPUAccessible() const;
+        /*!
+        makes mesh data CPU-accessible, using provided data as its CPU copy. Data must be equal to the one stored in GPU buffers
+        */
+        void SetCPUShadow(VertexData vertecies, IndexData indicies);
+
+        /*!
+        sets meshlets which cover mesh data index range. Meshlets are shared between copies of mesh data, same as GPU storage.
+        Buffering new vertecies or indicies rebuilds meshlets from CPU copy, or drops them if mesh data is not CPU-accessible
+        */
+        void SetMeshlets(MxVector<Meshlet> meshlets);
+        /*!
+        \returns meshlets of mesh data or empty list if mesh data is not split into meshlets
+        */
+        const MxVector<Meshlet>& GetMeshlets() const;
+
         VertexData GetVerteciesFromGPU() const;
         IndexData GetIndiciesFromGPU() const;
+        /*!
+        reads vertecies from GPU without waiting for it. Future is completed at the end of the frame in which GPU copied the data
+        */
+        std::future<VertexData> GetVerteciesFromGPUAsync() const;
+        std::future<IndexData> GetIndiciesFromGPUAsync() const;
 
         static void RegenerateNormals(VertexData& vertecies, const IndexData& indicies);
         static void RegenerateTangentSpace(VertexData& vertecies, const IndexData& indicies);
+        /*!
+        computes bounding box of vertecies. Empty vertex list is bounded by zero-sized box at the origin
+        */
+        static AABB ComputeBoundingBox(const VertexData& vertecies);
+        static BoundingSphere ComputeBoundingSphere(const VertexData& vertecies, const Vector3& center);
     };
 }
\ No newline at end of file
@@ -0,0 +1,140 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Meshlet.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Core/Macro/Macro.h"
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace MxEngine
+{
+    MxVector<Meshlet> MeshletBuilder::Build(const MxVector<Vertex>& vertecies, const MxVector<uint32_t>& indicies)
+    {
+        MAKE_SCOPE_PROFILER("MeshletBuilder::Build()");
+
+        MxVector<Meshlet> meshlets;
+        const size_t triangleCount = indicies.size() / 3;
+        if (triangleCount == 0) return meshlets;
+
+        // stores index of last meshlet which referenced the vertex to count unique vertecies without clearing the table
+        constexpr uint32_t NoMeshlet = std::numeric_limits<uint32_t>::max();
+        MxVector<uint32_t> vertexMeshlet(vertecies.size(), NoMeshlet);
+
+        Meshlet current;
+        for (size_t i = 0; i < triangleCount; i++)
+        {
+            const uint32_t* triangle = indicies.data() + 3 * i;
+            uint32_t meshletIndex = uint32_t(meshlets.size());
+
+            uint32_t newVertexCount = 0;
+            for (size_t j = 0; j < 3; j++)
+            {
+                MX_ASSERT(triangle[j] < vertecies.size());
+                bool isRepeated = (j > 0 && triangle[j] == triangle[0]) || (j > 1 && triangle[j] == triangle[1]);
+                if (vertexMeshlet[triangle[j]] != meshletIndex && !isRepeated) newVertexCount++;
+            }
+
+            if (current.VertexCount + newVertexCount > MaxVertecies || current.IndexCount / 3 + 1 > MaxTriangles)
+            {
+                MeshletBuilder::ComputeBounds(current, vertecies, indicies);
+                meshlets.push_back(current);
+
+                current = Meshlet{ };
+                current.IndexOffset = uint32_t(3 * i);
+                meshletIndex++;
+            }
+
+            for (size_t j = 0; j < 3; j++)
+            {
+                if (vertexMeshlet[triangle[j]] != meshletIndex)
+                {
+                    vertexMeshlet[triangle[j]] = meshletIndex;
+                    current.VertexCount++;
+                }
+            }
+            current.IndexCount += 3;
+        }
+        MeshletBuilder::ComputeBounds(current, vertecies, indicies);
+        meshlets.push_back(current);
+
+        return meshlets;
+    }
+
+    void MeshletBuilder::ComputeBounds(Meshlet& meshlet, const MxVector<Vertex>& vertecies, const MxVector<uint32_t>& indicies)
+    {
+        const uint32_t* begin = indicies.data() + meshlet.IndexOffset;
+        const uint32_t* end = begin + meshlet.IndexCount;
+        if (begin == end) return;
+
+        AABB box{ vertecies[*begin].Position, vertecies[*begin].Position };
+        for (const uint32_t* index = begin; index != end; index++)
+        {
+            box.Min = VectorMin(box.Min, vertecies[*index].Position);
+            box.Max = VectorMax(box.Max, vertecies[*index].Position);
+        }
+
+        float radius2 = 0.0f;
+        Vector3 center = box.GetCenter();
+        for (const uint32_t* index = begin; index != end; index++)
+            radius2 = Max(radius2, Length2(vertecies[*index].Position - center));
+        meshlet.Bounds = BoundingSphere(center, std::sqrt(radius2));
+
+        Vector3 normalSum = MakeVector3(0.0f);
+        for (const uint32_t* index = begin; index != end; index += 3)
+        {
+            Vector3 normal = Cross(vertecies[index[1]].Position - vertecies[index[0]].Position, vertecies[index[2]].Position - vertecies[index[0]].Position);
+            float length = Length(normal);
+            if (length > 0.0f) normalSum += normal / length;
+        }
+
+        // cone is not used if there are only degenerate triangles or normals cancel each other out
+        meshlet.ConeAxis = MakeVector3(0.0f);
+        meshlet.ConeCutoff = 1.0f;
+        float axisLength = Length(normalSum);
+        if (axisLength == 0.0f) return;
+        Vector3 axis = normalSum / axisLength;
+
+        float minDot = 1.0f;
+        for (const uint32_t* index = begin; index != end; index += 3)
+        {
+            Vector3 normal = Cross(vertecies[index[1]].Position - vertecies[index[0]].Position, vertecies[index[2]].Position - vertecies[index[0]].Position);
+            float length = Length(normal);
+            if (length > 0.0f) minDot = Min(minDot, Dot(normal / length, axis));
+        }
+
+        // if normals spread over almost a hemisphere, cone test will hardly ever succeed
+        if (minDot <= 0.1f) return;
+
+        meshlet.ConeAxis = axis;
+        meshlet.ConeCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+}
@@ -0,0 +1,90 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Core/BoundingObjects/BoundingSphere.h"
+#include "Utilities/STL/MxVector.h"
+#include "Vertex.h"
+
+namespace MxEngine
+{
+    /*!
+    meshlet is a small cluster of mesh triangles, stored contiguously in mesh index buffer. Meshlets can be culled independently,
+    so big meshes are only partially drawn when most of their triangles are outside of camera frustrum or face away from it
+    */
+    struct Meshlet
+    {
+        /*!
+        first index of meshlet, relative to the beginning of its mesh data index range
+        */
+        uint32_t IndexOffset = 0;
+        uint32_t IndexCount = 0;
+        uint32_t VertexCount = 0;
+        /*!
+        bounding sphere of meshlet triangles in mesh space
+        */
+        BoundingSphere Bounds;
+        /*!
+        average normal of meshlet triangles. All triangle normals lie inside the cone around this axis
+        */
+        Vector3 ConeAxis = MakeVector3(0.0f);
+        /*!
+        cosine of maximum angle between cone axis and view direction at which all meshlet triangles face away from viewer.
+        Equals 1 if meshlet normals are spread too wide and meshlet can not be backface culled
+        */
+        float ConeCutoff = 1.0f;
+    };
+
+    /*!
+    meshlet builder splits triangle list into meshlets and computes their culling data. Triangles are grouped in index buffer order,
+    so index buffer is expected to be optimized for vertex cache locality first (see MeshOptimizer)
+    */
+    class MeshletBuilder
+    {
+    public:
+        constexpr static size_t MaxVertecies = 64;
+        constexpr static size_t MaxTriangles = 124;
+
+        /*!
+        splits triangle list into meshlets of at most MaxVertecies unique vertecies and MaxTriangles triangles
+        \param vertecies vertecies referenced by index buffer
+        \param indicies triangle list
+        \returns meshlets covering the whole index buffer in order
+        */
+        static MxVector<Meshlet> Build(const MxVector<Vertex>& vertecies, const MxVector<uint32_t>& indicies);
+        /*!
+        computes bounding sphere and normal cone of meshlet
+        \param meshlet meshlet with valid index range
+        \param vertecies vertecies referenced by index buffer
+        \param indicies triangle list which meshlet references
+        */
+        static void ComputeBounds(Meshlet& meshlet, const MxVector<Vertex>& vertecies, const MxVector<uint32_t>& indicies);
+    };
+}
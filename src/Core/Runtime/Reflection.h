@@ -68,6 +68,23 @@ namespace MxEngine
         constexpr static const char* CUSTOM_DESERIALIZE = "deserialize";
     };
 
+    struct UpdateInfo
+    {
+        constexpr static const char* READS = "update reads";
+        constexpr static const char* WRITES = "update writes";
+        constexpr static const char* PARALLEL = "update parallel";
+        // update calls APIs bound to main thread (OpenAL, window etc.), so it is never sent to worker threads
+        constexpr static const char* MAIN_THREAD = "update main thread";
+    };
+
+    using ComponentTypeList = MxVector<rttr::type>;
+
+    template<typename... Types>
+    ComponentTypeList ComponentTypes()
+    {
+        return ComponentTypeList{ rttr::type::get<Types>()... };
+    }
+
     using ConditionFunction = bool(*)(const rttr::instance&);
     using CustomViewFunction = rttr::variant(*)(rttr::instance&);
     using HandleEditorFunction = rttr::variant(*)(rttr::instance&);
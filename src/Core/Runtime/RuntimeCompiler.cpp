@@ -484,6 +484,66 @@ namespace MxEngine
     void RuntimeCompiler::UpdateScriptableObject(const MxString& scriptName, Scriptable* script)
     {
         impl->registeredScripts[MakeStringId(scriptName)].ScriptHandle = script;
+        RuntimeCompiler::InvalidateScriptBatches();
+    }
+
+    void RuntimeCompiler::InvalidateScriptBatches()
+    {
+        if (impl != nullptr) impl->areScriptBatchesDirty = true;
+    }
+
+    void RuntimeCompiler::RebuildScriptBatches()
+    {
+        MAKE_SCOPE_PROFILER("RuntimeCompiler::RebuildScriptBatches()");
+
+        // group objects by scriptable instance, as there is exactly one instance per script class
+        impl->scriptBatches.clear();
+        auto view = ComponentFactory::GetView<Script>();
+        for (auto& script : view)
+        {
+            if (!script.IsUpdateBatched()) continue;
+
+            auto scriptable = script.GetScriptableObject();
+            auto it = std::find_if(impl->scriptBatches.begin(), impl->scriptBatches.end(), 
+                [scriptable](const ScriptBatch& batch) { return batch.ScriptHandle == scriptable; });
+
+            ScriptBatch& batch = it != impl->scriptBatches.end() ? *it : impl->scriptBatches.emplace_back();
+            batch.ScriptHandle = scriptable;
+            auto object = MxObject::GetHandle(MxObject::GetByComponent(script));
+            batch.ObjectHandles.push_back(object.GetHandle());
+            batch.ObjectUUIDs.push_back(object.GetUUID());
+        }
+        impl->areScriptBatchesDirty = false;
+    }
+
+    void RuntimeCompiler::InvokeScriptBatches(float dt)
+    {
+        MAKE_SCOPE_PROFILER("RuntimeCompiler::InvokeScriptBatches()");
+        if (impl->areScriptBatchesDirty) RuntimeCompiler::RebuildScriptBatches();
+
+        for (const auto& batch : impl->scriptBatches)
+        {
+            // object pointers are resolved each frame, as object pool may be reallocated between frames.
+            // Objects destroyed by previous batches of this frame are skipped, batches are rebuilt next frame.
+            // Slot of destroyed object may already be reused by a new one, so its uuid is compared too
+            auto& pool = Factory<MxObject>::GetPool();
+            auto& objects = impl->batchObjects;
+            objects.clear();
+            for (size_t i = 0; i < batch.ObjectHandles.size(); i++)
+            {
+                size_t handle = batch.ObjectHandles[i];
+                if (pool.IsAllocated(handle) && pool[handle].uuid == batch.ObjectUUIDs[i])
+                    objects.push_back(&pool[handle].value);
+            }
+            if (objects.empty()) continue;
+
+            auto script = batch.ScriptHandle;
+            script->CurrentState.Method = ScriptableMethod::ON_UPDATE_BATCH;
+            script->CurrentState.Batch = ArrayView<MxObject*>(objects);
+            script->CurrentState.TimeDelta = dt;
+            impl->runtimeObjectSystem->TryProtectedFunction(script);
+            script->CurrentState.Batch = { };
+        }
     }
 
     RuntimeCompilerImpl* RuntimeCompiler::GetImpl()
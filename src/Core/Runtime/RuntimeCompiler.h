@@ -38,6 +38,7 @@ struct ObjectId;
 #include "Utilities/String/String.h"
 #include "Utilities/STL/MxString.h"
 #include "Utilities/STL/MxHashMap.h"
+#include "Utilities/UUID/UUID.h"
 
 #if defined(MXENGINE_SHIPPING)
 #define RCCPPOFF // turn off runtime compilation
@@ -54,6 +55,7 @@ namespace MxEngine
         ON_CREATE,
         ON_RELOAD,
         ON_UPDATE,
+        ON_UPDATE_BATCH,
     };
 
     struct ScriptInfo
@@ -66,12 +68,23 @@ namespace MxEngine
         ScriptId ScriptHandleId{ };
     };
 
+    struct ScriptBatch
+    {
+        Scriptable* ScriptHandle = nullptr;
+        MxVector<size_t> ObjectHandles;
+        // uuids of batched objects, used to detect pool slots reused by objects created after batch was built
+        MxVector<UUID> ObjectUUIDs;
+    };
+
     struct RuntimeCompilerImpl
     {
         UpdateListener* updateListener = nullptr;
         ICompilerLogger* compilerLogger = nullptr;
         RuntimeObjectSystem* runtimeObjectSystem = nullptr;
         MxHashMap<StringId, ScriptInfo> registeredScripts;
+        MxVector<ScriptBatch> scriptBatches;
+        MxVector<MxObject*> batchObjects;
+        bool areScriptBatchesDirty = true;
     };
 
     class RuntimeCompiler
@@ -80,6 +93,7 @@ namespace MxEngine
 
         static void RegisterExistingScripts();
         static void RegisterNewScript(IObjectConstructor* constructor);
+        static void RebuildScriptBatches();
     public:
         static void Init();
         static void Destroy();
@@ -103,5 +117,7 @@ namespace MxEngine
         static void InvokeScriptableObject(Scriptable* script, ScriptableMethod method, MxObject& scriptParent);
         static const MxHashMap<StringId, ScriptInfo>& GetRegisteredScripts();
         static void UpdateScriptableObject(const MxString& scriptName, Scriptable* script);
+        static void InvalidateScriptBatches();
+        static void InvokeScriptBatches(float dt);
     };
 }
\ No newline at end of file
@@ -475,8 +475,11 @@ namespace MxEngine
         {
             auto transform = GetGlobalTransform(object);
             auto parentTransform = GetGlobalTransform(GetInstanceParent(object));
-            this->DrawTransformManipulator(transform);
-            object->LocalTransform = WorldToLocal(parentTransform, transform);
+            auto manipulatedTransform = transform;
+            this->DrawTransformManipulator(manipulatedTransform);
+            // assignment raises transform changed flag, which makes physics push object back into simulation, so it is done only if gizmo moved object
+            if (manipulatedTransform != transform)
+                object->LocalTransform = WorldToLocal(parentTransform, manipulatedTransform);
         }
         // instanciate by middle button click TODO: add docs
         if (ImGui::IsMouseClicked(ImGuiMouseButton_Middle))
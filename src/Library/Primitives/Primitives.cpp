@@ -30,6 +30,7 @@
 #include "Utilities/Format/Format.h"
 #include "Utilities/FileSystem/FileManager.h"
 #include "Utilities/ObjectLoading/ObjectSaver.h"
+#include "Utilities/ObjectLoading/MeshOptimizer.h"
 #include "Core/Config/GlobalConfig.h"
 
 namespace MxEngine
@@ -51,21 +52,26 @@ namespace MxEngine
 
     MeshHandle Primitives::CreateMesh(const MeshData::VertexData& vertecies, const MeshData::IndexData& indicies, const MxString& filename)
     {
+        MeshData::VertexData optimizedVertecies = vertecies;
+        MeshData::IndexData optimizedIndicies = indicies;
+        MeshOptimizer::Optimize(optimizedVertecies, optimizedIndicies);
+
         auto mesh = Factory<Mesh>::Create();
-        mesh->ReserveData(vertecies.size(), indicies.size());
+        mesh->ReserveData(optimizedVertecies.size(), optimizedIndicies.size());
         MeshData meshData{
             mesh->GetTotalVerteciesCount(), mesh->GetBaseVerteciesOffset(),
             mesh->GetTotalIndiciesCount(), mesh->GetBaseIndiciesOffset()
         };
 
         auto& submesh = mesh->AddSubMesh((SubMesh::MaterialId)0, std::move(meshData));
-        submesh.Data.BufferVertecies(vertecies);
-        submesh.Data.BufferIndicies(indicies);
-        submesh.Data.UpdateBoundingGeometry(vertecies);
+        submesh.Data.BufferVertecies(optimizedVertecies);
+        submesh.Data.BufferIndicies(optimizedIndicies);
+        submesh.Data.UpdateBoundingGeometry(optimizedVertecies);
+        submesh.Data.SetMeshlets(MeshletBuilder::Build(optimizedVertecies, optimizedIndicies));
 
         mesh->UpdateBoundingGeometry();
 
-        MxString tag = CachePrimitiveMesh(vertecies, indicies, filename);
+        MxString tag = CachePrimitiveMesh(optimizedVertecies, optimizedIndicies, filename);
         mesh->SetInternalEngineTag(tag);
 
         return mesh;
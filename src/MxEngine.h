@@ -62,6 +62,7 @@
 #include "Utilities/Memory/Memory.h"
 #include "Utilities/Logging/Logger.h"
 #include "Utilities/FileSystem/FileManager.h"
+#include "Utilities/FileSystem/VirtualFileSystem.h"
 #include "Library/Primitives/Primitives.h"
 #include "Library/Primitives/Colors.h"
 #include "Core/Components/Scripting/Scriptable.h"
@@ -32,6 +32,7 @@
 #include "Utilities/Profiler/Profiler.h"
 #include "Utilities/ImGui/ImGuiBase.h"
 #include "Utilities/FileSystem/FileManager.h"
+#include "Core/Rendering/RenderGraph/SubmissionQueue.h"
 #include <VulkanAbstractionLayer/VulkanContext.h>
 #include <VulkanAbstractionLayer/ImGuiContext.h>
 
@@ -132,7 +133,10 @@ namespace MxEngine
     void GraphicModule::OnFrameEnd()
     {
         if (impl->Vulkan->IsRenderingEnabled())
+        {
             impl->Vulkan->EndFrame();
+            SubmissionQueue::OnFrameSubmitted();
+        }
 
         if (impl->ImGui != nullptr)
             VulkanAbstractionLayer::ImGuiVulkanContext::EndFrame();
@@ -29,36 +29,274 @@
 #include "PhysicsModule.h"
 #include "Utilities/Memory/Memory.h"
 #include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/STL/MxVector.h"
 #include "Platform/Bullet3/Bullet3Utils.h"
 
+#include <LinearMath/btThreads.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+
 namespace MxEngine
 {
     // defined in Core/Application/Physics.cpp
     void OnCollisionCallback();
 
+    const char* EnumToString(PhysicsWorldType type)
+    {
+        switch (type)
+        {
+        case PhysicsWorldType::SINGLE_THREADED:
+            return "SINGLE_THREADED";
+        case PhysicsWorldType::MULTI_THREADED:
+            return "MULTI_THREADED";
+        default:
+            return "SINGLE_THREADED";
+        }
+    }
+
+    /*!
+    bullet task scheduler which executes parallel loops on engine thread pool. Loop ranges are split into chunks of grain size,
+    so the work split does not depend on thread count, and partial sums are always added in the same order
+    */
+    class ThreadPoolTaskScheduler : public btITaskScheduler
+    {
+        int threadCount = 1;
+
+        template<typename F>
+        void ExecuteChunks(int chunkCount, F&& func)
+        {
+            int taskCount = Min(this->threadCount, chunkCount);
+            if (taskCount <= 1)
+            {
+                for (int i = 0; i < chunkCount; i++)
+                    func(i);
+                return;
+            }
+
+            // bullet avoids nested parallel loops while this counter is non-zero
+            btPushThreadsAreRunning();
+
+            int chunksPerTask = (chunkCount + taskCount - 1) / taskCount;
+            auto ExecuteTask = [&func, chunkCount, chunksPerTask](int task)
+            {
+                int end = Min((task + 1) * chunksPerTask, chunkCount);
+                for (int i = task * chunksPerTask; i < end; i++)
+                    func(i);
+            };
+
+            ScratchArray<std::future<void>> tasks(size_t(taskCount - 1));
+            for (int i = 1; i < taskCount; i++)
+                tasks[i - 1] = ThreadPool::Submit([&ExecuteTask, i]() { ExecuteTask(i); });
+            ExecuteTask(0);
+
+            for (auto& task : tasks)
+                ThreadPool::Wait(task);
+
+            btPopThreadsAreRunning();
+        }
+    public:
+        ThreadPoolTaskScheduler()
+            : btITaskScheduler("MxEngine::ThreadPool")
+        {
+            this->threadCount = this->getMaxNumThreads();
+        }
+
+        virtual int getMaxNumThreads() const override
+        {
+            return (int)Min(ThreadPool::GetWorkerCount() + 1, (size_t)BT_MAX_THREAD_COUNT);
+        }
+
+        virtual int getNumThreads() const override
+        {
+            return this->threadCount;
+        }
+
+        virtual void setNumThreads(int numThreads) override
+        {
+            this->threadCount = Clamp(numThreads, 1, this->getMaxNumThreads());
+        }
+
+        virtual void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) override
+        {
+            grainSize = Max(grainSize, 1);
+            int chunkCount = (iEnd - iBegin + grainSize - 1) / grainSize;
+            this->ExecuteChunks(chunkCount, [&body, iBegin, iEnd, grainSize](int chunk)
+            {
+                int begin = iBegin + chunk * grainSize;
+                body.forLoop(begin, Min(begin + grainSize, iEnd));
+            });
+        }
+
+        virtual btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) override
+        {
+            grainSize = Max(grainSize, 1);
+            int chunkCount = (iEnd - iBegin + grainSize - 1) / grainSize;
+            MxVector<btScalar> sums(size_t(Max(chunkCount, 0)), btScalar(0));
+            this->ExecuteChunks(chunkCount, [&body, &sums, iBegin, iEnd, grainSize](int chunk)
+            {
+                int begin = iBegin + chunk * grainSize;
+                sums[chunk] = body.sumLoop(begin, Min(begin + grainSize, iEnd));
+            });
+
+            btScalar sum = btScalar(0);
+            for (btScalar partialSum : sums)
+                sum += partialSum;
+            return sum;
+        }
+    };
+
+    static void CreateWorld(PhysicsModuleData& data)
+    {
+        if (data.WorldType == PhysicsWorldType::MULTI_THREADED)
+        {
+            btSetTaskScheduler(data.TaskScheduler);
+
+            // collision pools are shared by all threads, so they are preallocated to avoid locking on growth
+            btDefaultCollisionConstructionInfo collisionInfo;
+            collisionInfo.m_defaultMaxPersistentManifoldPoolSize = 80000;
+            collisionInfo.m_defaultMaxCollisionAlgorithmPoolSize = 80000;
+            data.CollisionConfiguration = Alloc<btDefaultCollisionConfiguration>(collisionInfo);
+
+            // order of contact manifolds created by parallel narrowphase depends on threads timing, which affects solver results
+            if (data.IsDeterministic)
+                data.Dispatcher = Alloc<btCollisionDispatcher>(data.CollisionConfiguration);
+            else
+                data.Dispatcher = Alloc<btCollisionDispatcherMt>(data.CollisionConfiguration);
+
+            data.Broadphase = Alloc<btDbvtBroadphase>();
+            auto solverPool = Alloc<btConstraintSolverPoolMt>(data.TaskScheduler->getMaxNumThreads());
+            data.Solver = solverPool;
+            data.SolverMt = Alloc<btSequentialImpulseConstraintSolverMt>();
+            data.World = Alloc<btDiscreteDynamicsWorldMt>(
+                data.Dispatcher, data.Broadphase, solverPool, data.SolverMt, data.CollisionConfiguration
+            );
+        }
+        else
+        {
+            data.CollisionConfiguration = Alloc<btDefaultCollisionConfiguration>();
+            data.Dispatcher = Alloc<btCollisionDispatcher>(data.CollisionConfiguration);
+            data.Broadphase = Alloc<btDbvtBroadphase>();
+            data.Solver = Alloc<btSequentialImpulseConstraintSolver>();
+            data.Solver->reset();
+            data.SolverMt = nullptr;
+            data.World = Alloc<btDiscreteDynamicsWorld>(
+                data.Dispatcher, data.Broadphase, data.Solver, data.CollisionConfiguration
+            );
+        }
+
+        data.World->getDispatchInfo().m_deterministicOverlappingPairs = data.IsDeterministic;
+    }
+
+    static void DestroyWorld(PhysicsModuleData& data)
+    {
+        Free(data.World);
+        if (data.SolverMt != nullptr) Free(data.SolverMt);
+        Free(data.Solver);
+        Free(data.Broadphase);
+        Free(data.Dispatcher);
+        Free(data.CollisionConfiguration);
+        data.SolverMt = nullptr;
+    }
+
+    static void RecreateWorld(PhysicsModuleData& data)
+    {
+        struct RigidBodyEntry
+        {
+            btRigidBody* Body;
+            int Group;
+            int Mask;
+        };
+
+        // bodies are removed in reverse order and added back in original one, which keeps simulation order unchanged
+        MxVector<RigidBodyEntry> bodies;
+        auto& objects = data.World->getCollisionObjectArray();
+        for (int i = objects.size() - 1; i >= 0; i--)
+        {
+            auto body = btRigidBody::upcast(objects[i]);
+            if (body == nullptr)
+            {
+                MXLOG_WARNING("MxEngine::PhysicsModule", "collision object which is not a rigid body was removed from physics world");
+                data.World->removeCollisionObject(objects[i]);
+                continue;
+            }
+
+            auto proxy = body->getBroadphaseHandle();
+            bodies.push_back(RigidBodyEntry{ body, proxy->m_collisionFilterGroup, proxy->m_collisionFilterMask });
+            data.World->removeRigidBody(body);
+        }
+
+        auto gravity = data.World->getGravity();
+        DestroyWorld(data);
+        CreateWorld(data);
+        data.World->setGravity(gravity);
+
+        for (auto it = bodies.rbegin(); it != bodies.rend(); it++)
+            data.World->addRigidBody(it->Body, it->Group, it->Mask);
+
+        MXLOG_INFO("MxEngine::PhysicsModule", MxFormat("physics world recreated: {}{}, {} rigid bodies",
+            EnumToString(data.WorldType), data.IsDeterministic ? " (deterministic)" : "", bodies.size()));
+    }
+
     void PhysicsModule::Init()
     {
         data = Alloc<PhysicsModuleData>();
-        data->CollisionConfiguration = Alloc<btDefaultCollisionConfiguration>();
-        data->Dispatcher = Alloc<btCollisionDispatcher>(data->CollisionConfiguration);
-        data->Broadphase = Alloc<btDbvtBroadphase>();
-        data->Solver = Alloc<btSequentialImpulseConstraintSolver>();
-        data->Solver->reset();
-        data->World = Alloc<btDiscreteDynamicsWorld>(
-            data->Dispatcher, data->Broadphase, data->Solver, data->CollisionConfiguration
-        );
+        data->TaskScheduler = Alloc<ThreadPoolTaskScheduler>();
+        CreateWorld(*data);
 
         data->World->setGravity(btVector3(0.0f, -9.8f, 0.0f));
     }
 
     void PhysicsModule::Destroy()
     {
-        Free(data->World);
-        Free(data->Solver);
-        Free(data->Broadphase);
-        Free(data->Dispatcher);
-        Free(data->CollisionConfiguration);
+        DestroyWorld(*data);
+        if (btGetTaskScheduler() == data->TaskScheduler)
+            btSetTaskScheduler(nullptr);
+        Free(data->TaskScheduler);
         Free(data);
+        data = nullptr;
+    }
+
+    void PhysicsModule::SetWorldType(PhysicsWorldType type)
+    {
+        if (data->WorldType == type) return;
+        data->WorldType = type;
+        RecreateWorld(*data);
+    }
+
+    PhysicsWorldType PhysicsModule::GetWorldType()
+    {
+        return data->WorldType;
+    }
+
+    void PhysicsModule::SetDeterministic(bool value)
+    {
+        if (data->IsDeterministic == value) return;
+        data->IsDeterministic = value;
+        RecreateWorld(*data);
+    }
+
+    bool PhysicsModule::IsDeterministic()
+    {
+        return data->IsDeterministic;
+    }
+
+    void PhysicsModule::SetThreadCount(size_t count)
+    {
+        data->TaskScheduler->setNumThreads((int)Min(count, PhysicsModule::GetMaxThreadCount()));
+    }
+
+    size_t PhysicsModule::GetThreadCount()
+    {
+        return (size_t)data->TaskScheduler->getNumThreads();
+    }
+
+    size_t PhysicsModule::GetMaxThreadCount()
+    {
+        return (size_t)data->TaskScheduler->getMaxNumThreads();
     }
 
     void PhysicsModule::OnUpdate(float dt)
@@ -28,23 +28,44 @@
 
 #pragma once
 
+#include "Utilities/STL/MxVector.h"
+
+#include <cstdint>
+#include <cstddef>
+
 class btCollisionConfiguration;
 class btDispatcher;
 class btBroadphaseInterface;
 class btConstraintSolver;
 class btDiscreteDynamicsWorld;
 class btRigidBody;
+class btITaskScheduler;
 
 namespace MxEngine
 {
+    enum class PhysicsWorldType : uint8_t
+    {
+        SINGLE_THREADED,
+        MULTI_THREADED,
+    };
+
+    const char* EnumToString(PhysicsWorldType type);
+
     struct PhysicsModuleData //-V730
     {
         btCollisionConfiguration* CollisionConfiguration;
         btDispatcher* Dispatcher;
         btBroadphaseInterface*  Broadphase;
         btConstraintSolver* Solver;
+        // solver for big islands, used only by multithreaded world
+        btConstraintSolver* SolverMt = nullptr;
         btDiscreteDynamicsWorld* World;
+        btITaskScheduler* TaskScheduler;
+        PhysicsWorldType WorldType = PhysicsWorldType::SINGLE_THREADED;
+        bool IsDeterministic = false;
         float simulationStep = 1.0f;
+        // handles of objects which collider was replaced or removed since last synchronization of rigid bodies
+        MxVector<size_t> ChangedColliderObjects;
     };
 
     class PhysicsModule
@@ -57,6 +78,22 @@ namespace MxEngine
         static void PerformSimulationStep(float dt);
         static void SetSimulationStep(float timedelta);
         static float GetSimulationStep();
+        /*!
+        recreates physics world of specified type. All rigid bodies are moved to the new world with their collision filters
+        */
+        static void SetWorldType(PhysicsWorldType type);
+        static PhysicsWorldType GetWorldType();
+        /*!
+        makes simulation results independent of thread count and task execution order. Narrowphase of multithreaded world runs serially in this mode
+        */
+        static void SetDeterministic(bool value);
+        static bool IsDeterministic();
+        /*!
+        limits number of threads used by multithreaded world, including calling thread
+        */
+        static void SetThreadCount(size_t count);
+        static size_t GetThreadCount();
+        static size_t GetMaxThreadCount();
 
         static PhysicsModuleData* GetImpl();
         static void Clone(PhysicsModuleData* impl);
@@ -152,35 +152,23 @@ namespace MxEngine
             Vector2 prevSize(this->width, this->height);
             if (currentSize != prevSize)
             {
-                this->dispatcher->AddEvent(MakeUnique<WindowResizeEvent>(prevSize, currentSize));
+                this->dispatcher->EmplaceEvent<WindowResizeEvent>(prevSize, currentSize);
                 this->width =  (int)currentSize.x;
                 this->height = (int)currentSize.y;
             }
 
-            auto keyEvent = MakeUnique<KeyEvent>(&this->keyHeld, &this->keyPressed, &this->keyReleased);
-            this->dispatcher->AddEvent(std::move(keyEvent));
-            auto mousePress = MakeUnique<MouseButtonEvent>(&this->mouseHeld, &this->mousePressed, &this->mouseReleased);
-            this->dispatcher->AddEvent(std::move(mousePress));
+            this->dispatcher->EmplaceEvent<KeyEvent>(&this->keyHeld, &this->keyPressed, &this->keyReleased);
+            this->dispatcher->EmplaceEvent<MouseButtonEvent>(&this->mouseHeld, &this->mousePressed, &this->mouseReleased);
 
             if (this->mousePressed.test((size_t)MouseButton::LEFT))
-            {
-                auto lbmEvent = MakeUnique<LeftMouseButtonPressedEvent>();
-                this->dispatcher->AddEvent(std::move(lbmEvent));
-            }
+                this->dispatcher->EmplaceEvent<LeftMouseButtonPressedEvent>();
             if (this->mousePressed.test((size_t)MouseButton::RIGHT))
-            {
-                auto rbmEvent = MakeUnique<RightMouseButtonPressedEvent>();
-                this->dispatcher->AddEvent(std::move(rbmEvent));
-            }
+                this->dispatcher->EmplaceEvent<RightMouseButtonPressedEvent>();
             if (this->mousePressed.test((size_t)MouseButton::MIDDLE))
-            {
-                auto mbmEvent = MakeUnique<MiddleMouseButtonPressedEvent>();
-                this->dispatcher->AddEvent(std::move(mbmEvent));
-            }
+                this->dispatcher->EmplaceEvent<MiddleMouseButtonPressedEvent>();
 
             auto cursor = this->GetCursorPosition();
-            auto mouseMoveEvent = MakeUnique<MouseMoveEvent>(cursor.x, cursor.y);
-            this->dispatcher->AddEvent(std::move(mouseMoveEvent));
+            this->dispatcher->EmplaceEvent<MouseMoveEvent>(cursor.x, cursor.y);
         }
         else // do not store key and mouse states if dispatcher is nullptr
         {
@@ -28,7 +28,7 @@
 
 #include "AudioLoader.h"
 
-#include "Utilities/FileSystem/File.h"
+#include "Utilities/FileSystem/MappedFile.h"
 #include "Utilities/Profiler/Profiler.h"
 #include "Core/Macro/Macro.h"
 
@@ -53,12 +53,15 @@ namespace MxEngine
         auto ext = path.extension();
         AudioData result;
 
+        MappedFile file(path);
+        if (!file.IsOpen()) return result;
+
         if (ext == ".wav")
         {
             unsigned int channels;
             unsigned int sampleRate;
             drwav_uint64 totalPCMFrameCount;
-            drwav_int16* sampleData = drwav_open_file_and_read_pcm_frames_s16(path.string().c_str(), &channels, &sampleRate, &totalPCMFrameCount, nullptr);
+            drwav_int16* sampleData = drwav_open_memory_and_read_pcm_frames_s16(file.GetData(), file.GetSize(), &channels, &sampleRate, &totalPCMFrameCount, nullptr);
             if (sampleData == nullptr)
                 return result;
 
@@ -72,7 +75,7 @@ namespace MxEngine
         {
             drmp3_config config;
             drmp3_uint64 totalPCMFrameCount;
-            drmp3_int16* sampleData = drmp3_open_file_and_read_pcm_frames_s16(path.string().c_str(), &config, &totalPCMFrameCount, nullptr);
+            drmp3_int16* sampleData = drmp3_open_memory_and_read_pcm_frames_s16(file.GetData(), file.GetSize(), &config, &totalPCMFrameCount, nullptr);
             if (sampleData == nullptr)
                 return result;
 
@@ -87,7 +90,7 @@ namespace MxEngine
             unsigned int channels;
             unsigned int sampleRate;
             drflac_uint64 totalPCMFrameCount;
-            drflac_int16* sampleData = drflac_open_file_and_read_pcm_frames_s16(path.string().c_str(), &channels, &sampleRate, &totalPCMFrameCount, nullptr);
+            drflac_int16* sampleData = drflac_open_memory_and_read_pcm_frames_s16(file.GetData(), file.GetSize(), &channels, &sampleRate, &totalPCMFrameCount, nullptr);
             if (sampleData == nullptr)
                 return result;
 
@@ -101,8 +104,8 @@ namespace MxEngine
         {
             int channels;
             int sampleRate;
-            short* sampleData;
-            int totalPCMFrameCount = stb_vorbis_decode_filename(path.string().c_str(), &channels, &sampleRate, &sampleData);
+            short* sampleData = nullptr;
+            int totalPCMFrameCount = stb_vorbis_decode_memory(file.GetData(), (int)file.GetSize(), &channels, &sampleRate, &sampleData);
             if (sampleData == nullptr)
                 return result;
 
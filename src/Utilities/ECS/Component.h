@@ -81,6 +81,7 @@ namespace MxEngine
         template<typename T>
         auto GetComponent() const
         {
+            ComponentAccess::Validate(T::ComponentId);
             for (const auto& component : components)
             {
                 const auto& componentRef = *reinterpret_cast<const Component*>(&component);
@@ -144,5 +145,6 @@ namespace MxEngine
                 void* UserData = (void*)std::numeric_limits<uintptr_t>::max();\
                 friend class MxObject;\
                 friend class ComponentManager; \
+                friend class ComponentUpdateScheduler; \
                 friend class ComponentFactory
 }
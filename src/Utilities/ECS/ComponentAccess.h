@@ -0,0 +1,105 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include <algorithm>
+
+#include "Utilities/STL/MxVector.h"
+#include "Utilities/String/String.h"
+#include "Core/Macro/Macro.h"
+
+namespace MxEngine
+{
+    /*!
+    set of component types which are accessed by a single component update. Filled from rttr metadata (see UpdateInfo)
+    If component type does not declare its accesses, it is considered to touch everything and is never updated concurrently
+    */
+    struct ComponentAccessSet
+    {
+        StringId Self = 0;
+        MxVector<StringId> Reads;
+        MxVector<StringId> Writes;
+        bool IsDeclared = false;
+        bool IsParallel = false;
+
+        bool IsReading(StringId id) const
+        {
+            return std::find(this->Reads.begin(), this->Reads.end(), id) != this->Reads.end();
+        }
+
+        bool IsWriting(StringId id) const
+        {
+            return id == this->Self || std::find(this->Writes.begin(), this->Writes.end(), id) != this->Writes.end();
+        }
+
+        bool IsAccessing(StringId id) const
+        {
+            return this->IsReading(id) || this->IsWriting(id);
+        }
+    };
+
+    /*!
+    tracks which component update is currently executed on this thread. In debug builds every component lookup is
+    validated against declared access set, so undeclared cross-component access is detected even if it does not lead to data race yet
+    */
+    class ComponentAccess
+    {
+        inline thread_local static const ComponentAccessSet* current = nullptr;
+    public:
+        class Scope
+        {
+            const ComponentAccessSet* previous;
+        public:
+            Scope(const ComponentAccessSet& access) : previous(current) { current = &access; }
+            ~Scope() { current = previous; }
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+        };
+
+        static const ComponentAccessSet* GetCurrent()
+        {
+            return current;
+        }
+
+        static void Validate(StringId component)
+        {
+            #if defined(MXENGINE_DEBUG)
+            MX_ASSERT(current == nullptr || !current->IsDeclared || current->IsAccessing(component));
+            #endif
+        }
+
+        static void ValidateStructuralChange()
+        {
+            #if defined(MXENGINE_DEBUG)
+            MX_ASSERT(current == nullptr || !current->IsDeclared);
+            #endif
+        }
+    };
+}
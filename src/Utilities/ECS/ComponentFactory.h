@@ -32,6 +32,7 @@
 #include "Utilities/String/String.h"
 #include "Utilities/Factory/Factory.h"
 #include "Utilities/ECS/ComponentView.h"
+#include "Utilities/ECS/ComponentAccess.h"
 
 namespace MxEngine
 {
@@ -63,6 +64,7 @@ namespace MxEngine
         template<typename T, typename... Args>
         static auto CreateComponent(Args&&... args)
         {
+            ComponentAccess::ValidateStructuralChange();
             UUID uuid = UUIDGenerator::Get();
             auto& pool = GetPool<T>();
             size_t index = pool.Allocate(uuid, std::forward<Args>(args)...);
@@ -72,6 +74,7 @@ namespace MxEngine
         template<typename T>
         static void Destroy(Resource<T, ComponentFactory>& resource)
         {
+            ComponentAccess::ValidateStructuralChange();
             GetPool<T>().Deallocate(resource.GetHandle());
         }
 
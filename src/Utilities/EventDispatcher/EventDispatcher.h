@@ -33,6 +33,7 @@
 
 #include "Utilities/Profiler/Profiler.h"
 #include "Utilities/Memory/Memory.h"
+#include "Utilities/Memory/FrameAllocator.h"
 #include "Utilities/STL/MxHashMap.h"
 #include "Utilities/STL/MxVector.h"
 
@@ -48,9 +49,14 @@ namespace MxEngine
         using CallbackBaseFunction = std::function<void(EventBase&)>;
         using NamedCallback = std::pair<MxString, CallbackBaseFunction>;
         using CallbackList = MxVector<NamedCallback>;
-        using EventList = MxVector<UniqueRef<EventBase>>;
+        using EventPointer = std::unique_ptr<EventBase, void(*)(EventBase*)>;
+        using EventList = MxVector<EventPointer>;
         using EventTypeIndex = uint32_t;
 
+        /*!
+        storage for events created by EmplaceEvent. Reset each time event queue becomes empty
+        */
+        FrameArena eventArena;
         /*!
         list of scheduled all events
         */
@@ -207,7 +213,19 @@ namespace MxEngine
         */
         void AddEvent(UniqueRef<EventBase> event)
         {
-            this->events.push_back(std::move(event));
+            this->events.emplace_back(event.release(), [](EventBase* e) { delete e; });
+        }
+
+        /*!
+        Constructs event in dispatcher memory and adds it to event queue. Prefer it over AddEvent for events created each frame
+        \param args arguments for event construction
+        */
+        template<typename Event, typename... Args>
+        void EmplaceEvent(Args&&... args)
+        {
+            auto memory = this->eventArena.RawAlloc(sizeof(Event), alignof(Event));
+            auto event = new(memory) Event(std::forward<Args>(args)...);
+            this->events.emplace_back(event, [](EventBase* e) { e->~EventBase(); });
         }
 
         /*!
@@ -222,6 +240,7 @@ namespace MxEngine
                 this->ProcessEvent(*this->events[i]);
             }
             this->events.clear();
+            this->eventArena.Reset();
         }
 
         /*!
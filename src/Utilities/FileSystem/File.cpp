@@ -27,6 +27,7 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "File.h"
+#include "VirtualFileSystem.h"
 #include "Utilities/Logging/Logger.h"
 
 #include <map>
@@ -124,17 +125,22 @@ namespace MxEngine
 
     File::FileData File::ReadAllText(const FilePath& path)
     {
+        MxVector<uint8_t> storage;
+        auto packed = VirtualFileSystem::ReadPackedFile(path, storage);
+        if (packed.data() != nullptr)
+            return FileData((const char*)packed.data(), packed.size());
+
         return File(path, FileMode::READ).ReadAllText();
     }
 
     File::FileData File::ReadAllText(const MxString& path)
     {
-        return File(path, FileMode::READ).ReadAllText();
+        return File::ReadAllText(ToFilePath(path));
     }
 
     File::FileData File::ReadAllText(const char* path)
     {
-        return File(path, FileMode::READ).ReadAllText();
+        return File::ReadAllText((FilePath)path);
     }
 
     bool File::Exists(const FilePath& path)
@@ -146,19 +146,19 @@ namespace MxEngine
         File& operator<<(T&& value);
 
         /*!
-        creates temporary File object and reads its data into string.
+        creates temporary File object and reads its data into string. Files from mounted pack files are read through VirtualFileSystem
         \param path path to a file
         \returns file contents as string. If file is not opened / not exists returns empty string
         */
         static FileData ReadAllText(const FilePath& path);
         /*!
-        creates temporary File object and reads its data into string.
+        creates temporary File object and reads its data into string. Files from mounted pack files are read through VirtualFileSystem
         \param path path to a file (absolute or relative to executable directory)
         \returns file contents as string. If file is not opened / not exists returns empty string
         */
         static FileData ReadAllText(const MxString& path);
         /*!
-        creates temporary File object and reads its data into string.
+        creates temporary File object and reads its data into string. Files from mounted pack files are read through VirtualFileSystem
         \param path path to a file (absolute or relative to executable directory)
         \returns file contents as string. If file is not opened / not exists returns empty string
         */
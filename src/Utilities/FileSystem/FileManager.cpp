@@ -27,16 +27,174 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "FileManager.h"
+#include "VirtualFileSystem.h"
 #include "Utilities/Profiler/Profiler.h"
 #include "Utilities/Memory/Memory.h"
 #include "Utilities/Format/Format.h"
 #include "Core/Config/GlobalConfig.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/STL/MxHashSet.h"
 #include <portable-file-dialogs.h>
 #undef CreateDirectory
 #undef ERROR
 
+#include <atomic>
+#include <array>
+
+#if defined(MXENGINE_LINUX)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
 namespace MxEngine
 {
+    struct DirectoryCacheHeader
+    {
+        std::array<char, 4> Magic;
+        uint32_t Version;
+        uint64_t IgnoredFoldersHash;
+        uint64_t DirectoryCount;
+    };
+
+    static constexpr std::array<char, 4> DirectoryCacheMagic = { 'M', 'X', 'F', 'T' };
+    static constexpr uint32_t DirectoryCacheVersion = 1;
+    static constexpr const char* DirectoryCacheFileName = ".mxfiletable";
+
+    using DirectoryList = MxVector<std::pair<MxString, DirectoryRecord>>;
+
+    static MxString MakeRelativePath(const MxString& directory, const MxString& name)
+    {
+        return directory.empty() ? name : directory + '/' + name;
+    }
+
+    static MxString NormalizePath(const FilePath& path)
+    {
+        auto normalized = ToMxString(path.lexically_normal());
+        std::replace(normalized.begin(), normalized.end(), '\\', '/');
+        while (!normalized.empty() && normalized.back() == '/')
+            normalized.pop_back();
+        return normalized;
+    }
+
+    static MxVector<MxString> GetIgnoredFolders()
+    {
+        MxVector<MxString> ignoredFolders;
+        for (const auto& folder : GlobalConfig::GetIgnoredFolders())
+            ignoredFolders.push_back(NormalizePath(ToFilePath(folder)));
+        return ignoredFolders;
+    }
+
+    static uint64_t HashIgnoredFolders(const MxVector<MxString>& ignoredFolders)
+    {
+        // cached directory records do not contain ignored subdirectories, so cache is invalid if ignore list changes
+        uint64_t hash = 14695981039346656037ull;
+        for (const auto& folder : ignoredFolders)
+        {
+            for (char c : folder)
+                hash = (hash ^ (uint8_t)c) * 1099511628211ull;
+            hash = (hash ^ (uint8_t)'\n') * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    static bool IsIgnoredDirectory(const MxString& directory, const MxVector<MxString>& ignoredFolders)
+    {
+        return std::find(ignoredFolders.begin(), ignoredFolders.end(), directory) != ignoredFolders.end();
+    }
+
+    /*!
+    reads single directory of the project. If cached record has the same modification time, directory is not listed again,
+    as its modification time changes each time direct children are added, removed or renamed
+    */
+    static bool ScanDirectory(const FilePath& root, const MxString& directory, const MxHashMap<MxString, DirectoryRecord>& cache,
+        const MxVector<MxString>& ignoredFolders, DirectoryRecord& record, std::atomic<size_t>& rescannedCount)
+    {
+        namespace fs = std::filesystem;
+        std::error_code error;
+        auto path = directory.empty() ? root : root / ToFilePath(directory);
+        auto modificationTime = fs::last_write_time(path, error).time_since_epoch().count();
+        if (error) return false;
+
+        auto cached = cache.find(directory);
+        if (cached != cache.end() && cached->second.ModificationTime == modificationTime)
+        {
+            record = cached->second;
+            return true;
+        }
+
+        rescannedCount++;
+        record.ModificationTime = modificationTime;
+        record.Files.clear();
+        record.Directories.clear();
+        for (auto it = fs::directory_iterator(path, fs::directory_options::skip_permission_denied, error); !error && it != fs::directory_iterator(); it.increment(error))
+        {
+            auto name = ToMxString(it->path().filename());
+            std::error_code statusError;
+            if (it->is_regular_file(statusError))
+            {
+                if (!directory.empty() || name != DirectoryCacheFileName)
+                    record.Files.push_back(std::move(name));
+            }
+            else if (it->is_directory(statusError) && !it->is_symlink(statusError))
+            {
+                if (!IsIgnoredDirectory(MakeRelativePath(directory, name), ignoredFolders))
+                    record.Directories.push_back(std::move(name));
+            }
+        }
+        return true;
+    }
+
+    static DirectoryList ScanDirectoryTree(const FilePath& root, const MxString& directory, const MxHashMap<MxString, DirectoryRecord>& cache,
+        const MxVector<MxString>& ignoredFolders, std::atomic<size_t>& rescannedCount)
+    {
+        DirectoryList result;
+        MxVector<MxString> pending = { directory };
+        while (!pending.empty())
+        {
+            MxString current = std::move(pending.back());
+            pending.pop_back();
+
+            DirectoryRecord record;
+            if (!ScanDirectory(root, current, cache, ignoredFolders, record, rescannedCount)) continue;
+
+            for (const auto& subdirectory : record.Directories)
+                pending.push_back(MakeRelativePath(current, subdirectory));
+            result.emplace_back(std::move(current), std::move(record));
+        }
+        return result;
+    }
+
+    static void WatchDirectory(FileManagerImpl& manager, const MxString& directory)
+    {
+        #if defined(MXENGINE_LINUX)
+        constexpr uint32_t WatchMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+        auto path = directory.empty() ? manager.rootDirectory : manager.rootDirectory / ToFilePath(directory);
+        int descriptor = inotify_add_watch(manager.watcher, path.c_str(), WatchMask);
+        if (descriptor != -1) manager.watchedDirectories[descriptor] = directory;
+        #endif
+    }
+
+    // computes path of directory relative to the indexed root directory. Returns false if directory is outside of the project
+    static bool GetIndexedDirectory(const FilePath& root, const FilePath& directory, FilePath& relativeDirectory)
+    {
+        if (root.empty()) return false;
+
+        std::error_code error;
+        auto absoluteDirectory = std::filesystem::absolute(directory, error).lexically_normal();
+        if (error) return false;
+
+        relativeDirectory = absoluteDirectory.lexically_relative(root);
+        return !relativeDirectory.empty() && *relativeDirectory.begin() != "..";
+    }
+
+    // converts path relative to the root directory to path inside searched directory, returns empty path if it is outside of it
+    static FilePath MakeSearchResult(const FilePath& directory, const FilePath& relativeDirectory, const FilePath& indexedPath)
+    {
+        auto result = indexedPath.lexically_relative(relativeDirectory);
+        if (result.empty() || *result.begin() == "..") return FilePath();
+        return directory / result;
+    }
+
     MxString FileManager::OpenFileDialog(const MxString& types, const MxString& description)
     {
         auto selection = pfd::open_file("Select file", FileManager::GetWorkingDirectory().string(),
@@ -54,38 +212,337 @@ namespace MxEngine
 
     void FileManager::InitializeRootDirectory(const FilePath& directory)
     {
+        MAKE_SCOPE_PROFILER("FileManager::InitializeRootDirectory()");
+        MAKE_SCOPE_TIMER("MxEngine::FileManager", "FileManager::InitializeRootDirectory()");
+
         if (!File::Exists(directory))
         {
             File::CreateDirectory(directory);
             MXLOG_DEBUG("MxEngine::FileManager", "creating directory: " + ToMxString(directory));
         }
 
-        MxVector<FilePath> ignoredEntries;
-        auto& ignoredFolders = GlobalConfig::GetIgnoredFolders();
-        for(const auto& folder : ignoredFolders)
+        auto root = std::filesystem::absolute(directory).lexically_normal();
+        if (!root.has_filename()) root = root.parent_path(); // remove trailing separator
+        manager->rootDirectory = root;
+
+        #if defined(MXENGINE_SHIPPING)
+        // shipping builds read project files from packs, so directory tree is not scanned at all
+        if (VirtualFileSystem::HasMountedPacks())
+        {
+            size_t packedCount = FileManager::AddPackedFiles();
+            MXLOG_INFO("MxEngine::FileManager", MxFormat("indexed {0} packed files, project directory scan is skipped", packedCount));
+            return;
+        }
+        #endif
+
+        auto ignoredFolders = GetIgnoredFolders();
+        auto cachePath = root / DirectoryCacheFileName;
+        MxHashMap<MxString, DirectoryRecord> cache;
+        FileManager::LoadDirectoryCache(cachePath, cache);
+
+        // root is read first, then each top-level directory is scanned by separate task
+        std::atomic<size_t> rescannedCount = 0;
+        DirectoryRecord rootRecord;
+        ScanDirectory(root, MxString(), cache, ignoredFolders, rootRecord, rescannedCount);
+
+        MxVector<std::future<DirectoryList>> tasks;
+        tasks.reserve(rootRecord.Directories.size());
+        for (const auto& subdirectory : rootRecord.Directories)
+        {
+            tasks.push_back(ThreadPool::Submit([&root, &cache, &ignoredFolders, &rescannedCount, subdirectory]()
+            {
+                return ScanDirectoryTree(root, subdirectory, cache, ignoredFolders, rescannedCount);
+            }));
+        }
+
+        manager->directories.clear();
+        manager->directories.emplace(MxString(), std::move(rootRecord));
+        for (auto& task : tasks)
         {
-             ignoredEntries.push_back(directory / ToFilePath(folder));
+            for (auto& [path, record] : ThreadPool::Wait(task))
+                manager->directories.emplace(std::move(path), std::move(record));
         }
 
-        auto InIgnoredDirectories = [&ignoredEntries](const FilePath& path)
+        size_t fileCount = 0;
+        for (const auto& [path, record] : manager->directories)
         {
-            for (const auto& directory : ignoredEntries)
-                if (FileManager::IsInDirectory(path, directory))
-                    return true;
+            for (const auto& file : record.Files)
+                FileManager::AddFile(ToFilePath(MakeRelativePath(path, file)));
+            fileCount += record.Files.size();
+        }
+
+        if (rescannedCount > 0 || cache.size() != manager->directories.size())
+            FileManager::SaveDirectoryCache(cachePath);
+
+        // loose files are already in the table, so they override packed files with the same path
+        fileCount += FileManager::AddPackedFiles();
+
+        MXLOG_INFO("MxEngine::FileManager", MxFormat("indexed {0} files in {1} directories, {2} of them were rescanned",
+            fileCount, manager->directories.size(), rescannedCount.load()));
+    }
+
+    bool FileManager::LoadDirectoryCache(const FilePath& cachePath, MxHashMap<MxString, DirectoryRecord>& directories)
+    {
+        File file(cachePath, File::READ | File::BINARY);
+        if (!file.IsOpen()) return false;
+
+        DirectoryCacheHeader header;
+        file.ReadBytes((uint8_t*)&header, sizeof(DirectoryCacheHeader));
+        if (!file.GetStream() || header.Magic != DirectoryCacheMagic || header.Version != DirectoryCacheVersion ||
+            header.IgnoredFoldersHash != HashIgnoredFolders(GetIgnoredFolders()))
+        {
+            MXLOG_DEBUG("MxEngine::FileManager", "directory cache is outdated, project directory will be rescanned");
             return false;
+        }
+
+        auto readString = [&file](MxString& value)
+        {
+            uint32_t length = 0;
+            file.ReadBytes((uint8_t*)&length, sizeof(length));
+            if (!file.GetStream() || length > 4096) return false;
+            value.resize(length);
+            file.ReadBytes((uint8_t*)value.data(), length);
+            return (bool)file.GetStream();
+        };
+        auto readList = [&file, &readString](MxVector<MxString>& list)
+        {
+            uint32_t count = 0;
+            file.ReadBytes((uint8_t*)&count, sizeof(count));
+            if (!file.GetStream()) return false;
+            list.resize(count);
+            for (auto& value : list)
+                if (!readString(value)) return false;
+            return true;
         };
 
-        auto it = std::filesystem::recursive_directory_iterator(directory, std::filesystem::directory_options::skip_permission_denied);
-        for (const auto& entry : it)
+        for (uint64_t i = 0; i < header.DirectoryCount; i++)
+        {
+            MxString path;
+            DirectoryRecord record;
+            if (!readString(path)) break;
+            file.ReadBytes((uint8_t*)&record.ModificationTime, sizeof(record.ModificationTime));
+            if (!readList(record.Files) || !readList(record.Directories)) break;
+            directories.emplace(std::move(path), std::move(record));
+        }
+
+        if (directories.size() != header.DirectoryCount)
+        {
+            MXLOG_WARNING("MxEngine::FileManager", "directory cache is corrupted: " + ToMxString(cachePath));
+            directories.clear();
+            return false;
+        }
+        return true;
+    }
+
+    void FileManager::SaveDirectoryCache(const FilePath& cachePath)
+    {
+        // file is overwritten in place, so modification time of root directory is not changed
+        File file(cachePath, File::WRITE | File::BINARY);
+        if (!file.IsOpen())
+        {
+            MXLOG_WARNING("MxEngine::FileManager", "cannot write directory cache: " + ToMxString(cachePath));
+            return;
+        }
+
+        DirectoryCacheHeader header;
+        header.Magic = DirectoryCacheMagic;
+        header.Version = DirectoryCacheVersion;
+        header.IgnoredFoldersHash = HashIgnoredFolders(GetIgnoredFolders());
+        header.DirectoryCount = (uint64_t)manager->directories.size();
+        file.WriteBytes((const uint8_t*)&header, sizeof(DirectoryCacheHeader));
+
+        auto writeString = [&file](const MxString& value)
+        {
+            uint32_t length = (uint32_t)value.size();
+            file.WriteBytes((const uint8_t*)&length, sizeof(length));
+            file.WriteBytes((const uint8_t*)value.data(), value.size());
+        };
+        auto writeList = [&file, &writeString](const MxVector<MxString>& list)
+        {
+            uint32_t count = (uint32_t)list.size();
+            file.WriteBytes((const uint8_t*)&count, sizeof(count));
+            for (const auto& value : list)
+                writeString(value);
+        };
+
+        for (const auto& [path, record] : manager->directories)
+        {
+            writeString(path);
+            file.WriteBytes((const uint8_t*)&record.ModificationTime, sizeof(record.ModificationTime));
+            writeList(record.Files);
+            writeList(record.Directories);
+        }
+    }
+
+    void FileManager::AddDirectoryTree(const MxString& directory)
+    {
+        MxHashMap<MxString, DirectoryRecord> noCache;
+        std::atomic<size_t> rescannedCount = 0;
+        auto records = ScanDirectoryTree(manager->rootDirectory, directory, noCache, GetIgnoredFolders(), rescannedCount);
+        for (auto& [path, record] : records)
+        {
+            for (const auto& file : record.Files)
+                FileManager::AddFile(ToFilePath(MakeRelativePath(path, file)));
+            if (manager->watcher != -1)
+                WatchDirectory(*manager, path);
+            manager->directories[path] = std::move(record);
+        }
+    }
+
+    void FileManager::RemoveDirectoryTree(const MxString& directory)
+    {
+        auto prefix = directory + '/';
+        for (auto it = manager->directories.begin(); it != manager->directories.end();)
+        {
+            const auto& path = it->first;
+            if (path == directory || path.compare(0, prefix.size(), prefix) == 0)
+            {
+                for (const auto& file : it->second.Files)
+                    FileManager::RemoveFile(ToFilePath(MakeRelativePath(path, file)));
+                it = manager->directories.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    void FileManager::RescanRootDirectory()
+    {
+        MAKE_SCOPE_PROFILER("FileManager::RescanRootDirectory()");
+        MxHashMap<MxString, DirectoryRecord> noCache;
+        std::atomic<size_t> rescannedCount = 0;
+        MxHashMap<MxString, DirectoryRecord> directories;
+        for (auto& [path, record] : ScanDirectoryTree(manager->rootDirectory, MxString(), noCache, GetIgnoredFolders(), rescannedCount))
+            directories.emplace(std::move(path), std::move(record));
+
+        MxHashSet<StringId> existingFiles;
+        for (const auto& [path, record] : directories)
+        {
+            for (const auto& file : record.Files)
+                existingFiles.insert(MakeStringId(MakeRelativePath(path, file)));
+        }
+
+        // events were lost, so files and directories deleted meanwhile are found by comparing old index with the new one
+        size_t removedCount = 0;
+        for (const auto& [path, record] : manager->directories)
+        {
+            for (const auto& file : record.Files)
+            {
+                auto filePath = MakeRelativePath(path, file);
+                if (existingFiles.find(MakeStringId(filePath)) != existingFiles.end()) continue;
+                FileManager::RemoveFile(ToFilePath(filePath));
+                removedCount++;
+            }
+        }
+
+        #if defined(MXENGINE_LINUX)
+        for (auto it = manager->watchedDirectories.begin(); it != manager->watchedDirectories.end();)
         {
-            if (entry.is_regular_file())
+            if (directories.find(it->second) == directories.end())
+            {
+                inotify_rm_watch(manager->watcher, it->first);
+                it = manager->watchedDirectories.erase(it);
+            }
+            else
             {
-                auto proximate = FileManager::GetProximatePath(entry, directory);
-                
-                if(!InIgnoredDirectories(entry.path()))
-                    FileManager::AddFile(proximate);
+                ++it;
             }
         }
+        #endif
+
+        for (const auto& [path, record] : directories)
+        {
+            for (const auto& file : record.Files)
+                FileManager::AddFile(ToFilePath(MakeRelativePath(path, file)));
+            if (manager->watcher != -1)
+                WatchDirectory(*manager, path);
+        }
+        manager->directories = std::move(directories);
+
+        MXLOG_INFO("MxEngine::FileManager", MxFormat("project directory rescanned, {0} deleted files removed from index", removedCount));
+    }
+
+    void FileManager::WatchRootDirectory()
+    {
+        #if defined(MXENGINE_LINUX)
+        if (manager->watcher != -1) return;
+
+        manager->watcher = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (manager->watcher == -1)
+        {
+            MXLOG_WARNING("MxEngine::FileManager", "cannot create file watcher, project files will not be tracked");
+            return;
+        }
+
+        for (const auto& [path, record] : manager->directories)
+            WatchDirectory(*manager, path);
+        MXLOG_DEBUG("MxEngine::FileManager", MxFormat("watching {0} project directories", manager->watchedDirectories.size()));
+        #else
+        MXLOG_DEBUG("MxEngine::FileManager", "file watching is not supported on this platform, project files will not be tracked");
+        #endif
+    }
+
+    void FileManager::ProcessFileChanges()
+    {
+        #if defined(MXENGINE_LINUX)
+        if (manager->watcher == -1) return;
+
+        alignas(inotify_event) char buffer[16 * 1024];
+        ssize_t length = 0;
+        while ((length = read(manager->watcher, buffer, sizeof(buffer))) > 0)
+        {
+            const inotify_event* event = nullptr;
+            for (const char* current = buffer; current < buffer + length; current += sizeof(inotify_event) + event->len)
+            {
+                event = (const inotify_event*)current;
+                if (event->mask & IN_Q_OVERFLOW)
+                {
+                    MXLOG_WARNING("MxEngine::FileManager", "file watcher queue overflowed, rescanning project directory");
+                    FileManager::RescanRootDirectory();
+                    continue;
+                }
+
+                auto watched = manager->watchedDirectories.find(event->wd);
+                if (watched == manager->watchedDirectories.end()) continue;
+                if (event->mask & IN_IGNORED)
+                {
+                    manager->watchedDirectories.erase(watched);
+                    continue;
+                }
+                if (event->len == 0) continue;
+
+                MxString directory = watched->second;
+                MxString name = event->name;
+                MxString path = MakeRelativePath(directory, name);
+                auto& record = manager->directories[directory];
+                auto& entries = (event->mask & IN_ISDIR) ? record.Directories : record.Files;
+                auto entry = std::find(entries.begin(), entries.end(), name);
+
+                if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                {
+                    bool isDirectory = event->mask & IN_ISDIR;
+                    if (isDirectory && IsIgnoredDirectory(path, GetIgnoredFolders())) continue;
+                    if (entry == entries.end()) entries.push_back(name);
+
+                    if (isDirectory)
+                        FileManager::AddDirectoryTree(path);
+                    else
+                        FileManager::AddFile(ToFilePath(path));
+                }
+                else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+                {
+                    if (entry != entries.end()) entries.erase(entry);
+
+                    if (event->mask & IN_ISDIR)
+                        FileManager::RemoveDirectoryTree(path);
+                    else
+                        FileManager::RemoveFile(ToFilePath(path));
+                }
+            }
+        }
+        #endif
     }
 
     const FilePath& FileManager::GetFilePath(StringId filename)
@@ -127,6 +584,19 @@ namespace MxEngine
     {
         namespace fs = std::filesystem;
         FilePath ext = ToFilePath(extension);
+
+        FilePath relativeDirectory;
+        if (GetIndexedDirectory(manager->rootDirectory, directory, relativeDirectory))
+        {
+            // project files are already indexed, so directory tree is walked only if nothing was found
+            for (const auto& [hash, file] : manager->filetable)
+            {
+                if (file.extension() != ext) continue;
+                auto result = MakeSearchResult(directory, relativeDirectory, file);
+                if (!result.empty() && File::Exists(result)) return result;
+            }
+        }
+
         auto it = fs::recursive_directory_iterator(directory);
         for (const auto& entry : it)
         {
@@ -147,6 +617,18 @@ namespace MxEngine
     {
         if (!File::Exists(directory)) return FilePath();
 
+        FilePath relativeDirectory;
+        if (GetIndexedDirectory(manager->rootDirectory, directory, relativeDirectory))
+        {
+            // project files are already indexed, so directory tree is walked only if nothing was found
+            for (const auto& [hash, file] : manager->filetable)
+            {
+                if (file.filename() != filename) continue;
+                auto result = MakeSearchResult(directory, relativeDirectory, file);
+                if (!result.empty() && File::Exists(result)) return result;
+            }
+        }
+
         namespace fs = std::filesystem;
         auto it = fs::recursive_directory_iterator(directory);
         for (const auto& entry : it)
@@ -163,6 +645,18 @@ namespace MxEngine
     {
         if (!File::Exists(directory)) return FilePath();
 
+        FilePath relativeDirectory;
+        if (GetIndexedDirectory(manager->rootDirectory, directory, relativeDirectory))
+        {
+            for (const auto& [path, record] : manager->directories)
+            {
+                auto indexedPath = ToFilePath(path);
+                if (indexedPath.filename() != filename) continue;
+                auto result = MakeSearchResult(directory, relativeDirectory, indexedPath);
+                if (!result.empty() && File::Exists(result)) return result;
+            }
+        }
+
         namespace fs = std::filesystem;
         auto it = fs::recursive_directory_iterator(directory);
         for (const auto& entry : it)
@@ -262,15 +756,14 @@ namespace MxEngine
 
     StringId FileManager::AddFile(const FilePath& file)
     {
-        auto filenameString = file.lexically_normal().string();
-        std::replace(filenameString.begin(), filenameString.end(), '\\', '/');
-        FilePath filename = filenameString;
+        auto filenameString = NormalizePath(file);
+        FilePath filename = ToFilePath(filenameString);
 
         auto filehash = MakeStringId(filenameString);
         auto collision = manager->filetable.find(filehash);
         if (collision != manager->filetable.end() && collision->second != filename)
         {
-            MXLOG_WARNING("MxEngine::FileManager", MxFormat("hash of file \"{0}\" conflicts with other one in the project: {1}", filenameString, manager->filetable[filehash].string()));
+            MXLOG_WARNING("MxEngine::FileManager", MxFormat("hash of file \"{0}\" conflicts with other one in the project: {1}", filenameString, ToMxString(manager->filetable[filehash])));
         }
         else if (collision == manager->filetable.end())
         {
@@ -280,6 +773,30 @@ namespace MxEngine
         return filehash;
     }
 
+    size_t FileManager::AddPackedFiles()
+    {
+        size_t packedCount = 0;
+        for (const auto& pack : VirtualFileSystem::GetMountedPacks())
+        {
+            for (const auto& entry : pack->GetEntries())
+                FileManager::AddFile(ToFilePath(pack->GetEntryPath(entry)));
+            packedCount += pack->GetEntryCount();
+        }
+        return packedCount;
+    }
+
+    void FileManager::RemoveFile(const FilePath& file)
+    {
+        auto filenameString = NormalizePath(file);
+        auto filehash = MakeStringId(filenameString);
+        auto entry = manager->filetable.find(filehash);
+        if (entry != manager->filetable.end() && entry->second == ToFilePath(filenameString))
+        {
+            MXLOG_DEBUG("MxEngine::FileManager", MxFormat("file removed from the project: {0}", filenameString));
+            manager->filetable.erase(entry);
+        }
+    }
+
     void FileManager::Init()
     {
         manager = Alloc<FileManagerImpl>();
@@ -302,6 +819,17 @@ namespace MxEngine
             File::CreateDirectory(FileManager::GetEngineModelDirectory());
     }
 
+    void FileManager::Destroy()
+    {
+        if (manager == nullptr) return;
+
+        #if defined(MXENGINE_LINUX)
+        if (manager->watcher != -1) close(manager->watcher); // closing descriptor also removes all its watches
+        #endif
+        Free(manager);
+        manager = nullptr;
+    }
+
     void FileManager::Clone(FileManagerImpl* other)
     {
         manager = other;
@@ -35,19 +35,42 @@
 namespace MxEngine
 {
 
+    struct DirectoryRecord
+    {
+        FileSystemTime::rep ModificationTime = 0;
+        // names of regular files directly inside the directory
+        MxVector<MxString> Files;
+        // names of not ignored subdirectories
+        MxVector<MxString> Directories;
+    };
+
     struct FileManagerImpl
     {
         MxHashMap<StringId, FilePath> filetable;
+        // directory tree of the project, keyed by path relative to root directory. Persisted between launches to skip unchanged directories
+        MxHashMap<MxString, DirectoryRecord> directories;
+        FilePath rootDirectory;
+        // platform-dependent file watcher state, see WatchRootDirectory
+        int watcher = -1;
+        MxHashMap<int, MxString> watchedDirectories;
     };
 
     class FileManager
     {
         inline static FileManagerImpl* manager = nullptr;
         static StringId AddFile(const FilePath& file);
+        static void RemoveFile(const FilePath& file);
+        static size_t AddPackedFiles();
+        static void AddDirectoryTree(const MxString& directory);
+        static void RemoveDirectoryTree(const MxString& directory);
+        static void RescanRootDirectory();
+        static bool LoadDirectoryCache(const FilePath& cachePath, MxHashMap<MxString, DirectoryRecord>& directories);
+        static void SaveDirectoryCache(const FilePath& cachePath);
     public:
         static MxString OpenFileDialog(const MxString& types = "", const MxString& description = "All Files");
         static MxString SaveFileDialog(const MxString& types = "", const MxString& description = "All Files");
         static void Init();
+        static void Destroy();
         static const FilePath& GetFilePath(StringId filename);
         static FilePath GetEngineRootDirectory();
         static FilePath GetEngineShaderDirectory();
@@ -65,6 +88,8 @@ namespace MxEngine
         static bool IsInDirectory(const FilePath& path, const FilePath& directory);
         static void Copy(const FilePath& from, const FilePath& to);
         static void InitializeRootDirectory(const FilePath& directory);
+        static void WatchRootDirectory();
+        static void ProcessFileChanges();
 
         static void Clone(FileManagerImpl* other);
         static FileManagerImpl* GetImpl();
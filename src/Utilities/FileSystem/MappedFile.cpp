@@ -0,0 +1,201 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "MappedFile.h"
+#include "VirtualFileSystem.h"
+#include "Utilities/Logging/Logger.h"
+
+#if defined(MXENGINE_LINUX)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace MxEngine
+{
+    MappedFile::MappedFile(const FilePath& path)
+    {
+        this->Open(path);
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this == &other) return *this;
+
+        this->Close();
+        // data may point into mapping, into pack file or into owned buffer
+        bool isBuffered = !other.buffer.empty() && other.data == other.buffer.data();
+        this->buffer = std::move(other.buffer);
+        this->filePath = std::move(other.filePath);
+        this->size = other.size;
+        this->isOpen = other.isOpen;
+        this->isMapped = other.isMapped;
+        this->data = isBuffered ? this->buffer.data() : other.data;
+
+        other.data = nullptr;
+        other.size = 0;
+        other.isOpen = false;
+        other.isMapped = false;
+        return *this;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        this->Close();
+    }
+
+    bool MappedFile::Open(const FilePath& path)
+    {
+        this->Close();
+        this->filePath = path;
+
+        // packed files are either referenced directly from pack mapping or decompressed into buffer
+        auto packed = VirtualFileSystem::ReadPackedFile(path, this->buffer);
+        if (packed.data() != nullptr)
+        {
+            this->data = packed.data();
+            this->size = packed.size();
+            this->isOpen = true;
+            return true;
+        }
+
+        #if defined(MXENGINE_LINUX)
+        int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (descriptor != -1)
+        {
+            struct stat status;
+            if (::fstat(descriptor, &status) == 0 && S_ISREG(status.st_mode))
+            {
+                this->size = (size_t)status.st_size;
+                // empty files cannot be mapped, but they are still valid
+                void* mapping = this->size != 0 ? ::mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, descriptor, 0) : nullptr;
+                if (mapping != MAP_FAILED)
+                {
+                    if (mapping != nullptr) ::madvise(mapping, this->size, MADV_SEQUENTIAL); // most assets are parsed from begin to end
+                    this->data = (const uint8_t*)mapping;
+                    this->isMapped = mapping != nullptr;
+                    this->isOpen = true;
+                }
+            }
+            ::close(descriptor); // mapping stays valid after descriptor is closed
+            if (this->isOpen) return true;
+        }
+        #endif
+
+        return this->OpenBuffered(path);
+    }
+
+    bool MappedFile::OpenBuffered(const FilePath& path)
+    {
+        this->Close();
+        this->filePath = path;
+
+        File file(path, File::READ | File::BINARY);
+        std::error_code error;
+        auto fileSize = std::filesystem::file_size(path, error);
+        if (!file.IsOpen() || error)
+        {
+            this->size = 0;
+            return false;
+        }
+
+        this->buffer.resize((size_t)fileSize);
+        file.ReadBytes(this->buffer.data(), this->buffer.size());
+        if (!file.GetStream())
+        {
+            MXLOG_ERROR("MxEngine::MappedFile", "cannot read file: " + ToMxString(path));
+            this->buffer.clear();
+            this->size = 0;
+            return false;
+        }
+
+        this->data = this->buffer.data();
+        this->size = this->buffer.size();
+        this->isOpen = true;
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        #if defined(MXENGINE_LINUX)
+        if (this->isMapped)
+            ::munmap((void*)this->data, this->size);
+        #endif
+
+        this->buffer.clear();
+        this->buffer.shrink_to_fit();
+        this->data = nullptr;
+        this->size = 0;
+        this->isOpen = false;
+        this->isMapped = false;
+    }
+
+    bool MappedFile::IsOpen() const
+    {
+        return this->isOpen;
+    }
+
+    bool MappedFile::IsMapped() const
+    {
+        return this->isMapped;
+    }
+
+    const FilePath& MappedFile::GetPath() const
+    {
+        return this->filePath;
+    }
+
+    const uint8_t* MappedFile::GetData() const
+    {
+        return this->data;
+    }
+
+    size_t MappedFile::GetSize() const
+    {
+        return this->size;
+    }
+
+    ArrayView<const uint8_t> MappedFile::GetBytes() const
+    {
+        return ArrayView<const uint8_t>(this->data, this->size);
+    }
+
+    ArrayView<const uint8_t> MappedFile::GetBytes(size_t offset, size_t byteSize) const
+    {
+        if (offset > this->size || byteSize > this->size - offset)
+            return ArrayView<const uint8_t>();
+        return ArrayView<const uint8_t>(this->data + offset, byteSize);
+    }
+}
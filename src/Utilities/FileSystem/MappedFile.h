@@ -0,0 +1,113 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "File.h"
+#include "Utilities/Array/ArrayView.h"
+
+namespace MxEngine
+{
+    /*!
+    MappedFile provides read-only access to the whole file contents without copying them into intermediate buffers.
+    On platforms which support it file is mapped into address space, pages are loaded by OS only when they are accessed.
+    If mapping fails, file is read into owned memory block, so users do not need to handle both cases separately.
+    Files from mounted pack files are resolved through VirtualFileSystem and referenced directly from the pack mapping
+    */
+    class MappedFile
+    {
+        /*!
+        pointer to the first byte of file contents. Points either to mapped memory, to pack file mapping or to buffer
+        */
+        const uint8_t* data = nullptr;
+        /*!
+        size of file contents in bytes
+        */
+        size_t size = 0;
+        /*!
+        storage of file contents if file cannot be mapped
+        */
+        MxVector<uint8_t> buffer;
+        /*!
+        file path associated with MappedFile
+        */
+        FilePath filePath;
+        bool isOpen = false;
+        bool isMapped = false;
+    public:
+        MappedFile() = default;
+        /*!
+        creates MappedFile object and maps file contents
+        \param path path to a file
+        */
+        explicit MappedFile(const FilePath& path);
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        ~MappedFile();
+
+        /*!
+        maps new file, old file associated with MappedFile is closed automatically
+        \param path path to a file
+        \returns true if file contents are accessible, false either
+        */
+        bool Open(const FilePath& path);
+        /*!
+        reads whole file into owned buffer without trying to map it. Open falls back to it when file cannot be mapped
+        \param path path to a file
+        \returns true if file contents were read, false either
+        */
+        bool OpenBuffered(const FilePath& path);
+        /*!
+        unmaps file contents or frees buffer with them
+        */
+        void Close();
+        bool IsOpen() const;
+        /*!
+        checks if file contents are mapped or were read into buffer as a fallback
+        */
+        bool IsMapped() const;
+        const FilePath& GetPath() const;
+        const uint8_t* GetData() const;
+        size_t GetSize() const;
+        /*!
+        gets view of the whole file contents
+        \returns view which is valid until file is closed
+        */
+        ArrayView<const uint8_t> GetBytes() const;
+        /*!
+        gets view of the part of file contents
+        \param offset offset of the first byte in file
+        \param byteSize number of bytes in view
+        \returns view which is valid until file is closed. If range is out of file bounds, empty view is returned
+        */
+        ArrayView<const uint8_t> GetBytes(size_t offset, size_t byteSize) const;
+    };
+}
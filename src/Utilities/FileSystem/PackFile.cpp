@@ -0,0 +1,341 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "PackFile.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+#include "Core/Macro/Macro.h"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+
+// implemented by stb_image_write, which is compiled in ImageConverter.cpp
+extern "C" unsigned char* stbi_zlib_compress(unsigned char* data, int data_len, int* out_len, int quality);
+
+namespace MxEngine
+{
+    static bool IsEntryLess(const PackFileEntry& entry, StringId id)
+    {
+        return entry.Id < id;
+    }
+
+    bool PackFile::Open(const FilePath& path)
+    {
+        MAKE_SCOPE_PROFILER("PackFile::Open");
+
+        this->entries = nullptr;
+        this->entryCount = 0;
+        this->pathTable = nullptr;
+        this->pathTableSize = 0;
+        if (!this->file.Open(path)) return false;
+
+        PackFileHeader header;
+        auto headerBytes = this->file.GetBytes(0, sizeof(PackFileHeader));
+        if (headerBytes.data() != nullptr)
+            std::memcpy(&header, headerBytes.data(), sizeof(PackFileHeader));
+
+        if (headerBytes.data() == nullptr || header.Magic != PackFileMagic || header.Version != PackFile::Version)
+        {
+            MXLOG_ERROR("MxEngine::PackFile", "invalid pack file: " + ToMxString(path));
+            this->file.Close();
+            return false;
+        }
+
+        // table of contents is used in place, so it must be properly aligned inside mapping
+        auto table = this->file.GetBytes((size_t)header.TableOffset, (size_t)header.EntryCount * sizeof(PackFileEntry));
+        auto pathTableBytes = this->file.GetBytes((size_t)header.PathTableOffset, this->file.GetSize() - std::min((size_t)header.PathTableOffset, this->file.GetSize()));
+        if (table.data() == nullptr || pathTableBytes.data() == nullptr || (uintptr_t)table.data() % alignof(PackFileEntry) != 0)
+        {
+            MXLOG_ERROR("MxEngine::PackFile", "pack file table of contents is corrupted: " + ToMxString(path));
+            this->file.Close();
+            return false;
+        }
+
+        this->entries = (const PackFileEntry*)table.data();
+        this->entryCount = (size_t)header.EntryCount;
+        this->pathTable = (const char*)pathTableBytes.data();
+        this->pathTableSize = pathTableBytes.size();
+
+        for (const auto& entry : this->GetEntries())
+        {
+            if (this->GetStoredData(entry).data() == nullptr || (size_t)entry.PathOffset + entry.PathLength > this->pathTableSize)
+            {
+                MXLOG_ERROR("MxEngine::PackFile", "pack file entry is out of file bounds: " + ToMxString(path));
+                this->file.Close();
+                this->entries = nullptr;
+                this->entryCount = 0;
+                return false;
+            }
+        }
+
+        MXLOG_INFO("MxEngine::PackFile", MxFormat("opened pack file {0} with {1} entries", ToMxString(path), this->entryCount));
+        return true;
+    }
+
+    bool PackFile::IsOpen() const
+    {
+        return this->file.IsOpen();
+    }
+
+    const FilePath& PackFile::GetPath() const
+    {
+        return this->file.GetPath();
+    }
+
+    size_t PackFile::GetEntryCount() const
+    {
+        return this->entryCount;
+    }
+
+    ArrayView<const PackFileEntry> PackFile::GetEntries() const
+    {
+        return ArrayView<const PackFileEntry>(this->entries, this->entryCount);
+    }
+
+    const PackFileEntry* PackFile::FindEntry(StringId id, const MxString& path) const
+    {
+        auto end = this->entries + this->entryCount;
+        auto it = std::lower_bound(this->entries, end, id, IsEntryLess);
+        if (it == end || it->Id != id) return nullptr;
+
+        // packer rejects conflicting hashes, but a path with the same hash may still be requested
+        if (path.size() != it->PathLength || std::memcmp(this->pathTable + it->PathOffset, path.data(), path.size()) != 0)
+            return nullptr;
+        return it;
+    }
+
+    MxString PackFile::GetEntryPath(const PackFileEntry& entry) const
+    {
+        return MxString(this->pathTable + entry.PathOffset, (size_t)entry.PathLength);
+    }
+
+    ArrayView<const uint8_t> PackFile::GetStoredData(const PackFileEntry& entry) const
+    {
+        return this->file.GetBytes((size_t)entry.Offset, (size_t)entry.StoredSize);
+    }
+
+    ArrayView<const uint8_t> PackFile::ReadEntry(const PackFileEntry& entry, MxVector<uint8_t>& storage) const
+    {
+        auto stored = this->GetStoredData(entry);
+        if (entry.Compression == PackCompression::NONE)
+            return stored;
+
+        if (entry.Compression == PackCompression::DEFLATE && entry.Size <= (uint64_t)std::numeric_limits<int>::max())
+        {
+            storage.resize((size_t)entry.Size);
+            int decodedSize = stbi_zlib_decode_buffer((char*)storage.data(), (int)storage.size(), (const char*)stored.data(), (int)stored.size());
+            if (decodedSize == (int)entry.Size)
+                return ArrayView<const uint8_t>(storage.data(), storage.size());
+        }
+
+        MXLOG_ERROR("MxEngine::PackFile", "cannot decompress pack file entry: " + this->GetEntryPath(entry));
+        storage.clear();
+        return ArrayView<const uint8_t>();
+    }
+
+    void PackFileWriter::SetAlignment(uint32_t alignment)
+    {
+        MX_ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+        this->alignment = std::max(alignment, (uint32_t)alignof(PackFileEntry));
+    }
+
+    void PackFileWriter::AddFile(const FilePath& packedPath, const FilePath& sourcePath, bool compress)
+    {
+        this->files.push_back(SourceFile{ PackFileWriter::NormalizePath(packedPath), sourcePath, compress });
+    }
+
+    void PackFileWriter::AddDirectory(const FilePath& directory, const FilePath& rootDirectory, bool compress)
+    {
+        std::error_code error;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, error))
+        {
+            if (!entry.is_regular_file(error)) continue;
+            this->AddFile(entry.path().lexically_relative(rootDirectory), entry.path(), compress);
+        }
+        if (error)
+        {
+            MXLOG_WARNING("MxEngine::PackFile", "cannot read directory " + ToMxString(directory) + ": " + ToMxString(error.message()));
+        }
+    }
+
+    size_t PackFileWriter::GetFileCount() const
+    {
+        return this->files.size();
+    }
+
+    static uint64_t AlignOffset(uint64_t offset, uint64_t alignment)
+    {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    bool PackFileWriter::Write(const FilePath& path) const
+    {
+        MAKE_SCOPE_PROFILER("PackFileWriter::Write");
+        MAKE_SCOPE_TIMER("MxEngine::PackFile", "PackFileWriter::Write()");
+
+        MxVector<PackFileEntry> entries(this->files.size());
+        MxVector<MxVector<uint8_t>> contents(this->files.size());
+        for (size_t i = 0; i < this->files.size(); i++)
+        {
+            entries[i] = PackFileEntry{ };
+            entries[i].Id = MakeStringId(this->files[i].PackedPath);
+        }
+
+        // sort entries by id, so reader can use binary search. Sorting indices keeps entries and sources in sync
+        MxVector<size_t> order(this->files.size());
+        for (size_t i = 0; i < order.size(); i++) order[i] = i;
+        std::sort(order.begin(), order.end(), [&entries](size_t i1, size_t i2) { return entries[i1].Id < entries[i2].Id; });
+        for (size_t i = 1; i < order.size(); i++)
+        {
+            if (entries[order[i - 1]].Id == entries[order[i]].Id)
+            {
+                MXLOG_ERROR("MxEngine::PackFile", MxFormat("cannot pack files with conflicting hashes: {0} and {1}",
+                    this->files[order[i - 1]].PackedPath, this->files[order[i]].PackedPath));
+                return false;
+            }
+        }
+
+        // files are read and compressed in parallel, each task owns its entry
+        std::atomic<bool> failed = false;
+        ThreadPool::ParallelFor(this->files.size(), 1, [this, &entries, &contents, &failed](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                const auto& source = this->files[i];
+                MappedFile file(source.SourcePath);
+                if (!file.IsOpen())
+                {
+                    MXLOG_ERROR("MxEngine::PackFile", "cannot read file: " + ToMxString(source.SourcePath));
+                    failed = true;
+                    continue;
+                }
+
+                auto& entry = entries[i];
+                entry.Size = (uint64_t)file.GetSize();
+                entry.Compression = PackCompression::NONE;
+                if (source.Compress && file.GetSize() > 0 && file.GetSize() <= (size_t)std::numeric_limits<int>::max())
+                {
+                    int compressedSize = 0;
+                    auto compressed = stbi_zlib_compress((unsigned char*)file.GetData(), (int)file.GetSize(), &compressedSize, 8);
+                    // already compressed formats (png, jpg, mp3) usually do not benefit from deflate
+                    if (compressed != nullptr && (size_t)compressedSize < file.GetSize() - file.GetSize() / 16)
+                    {
+                        contents[i].assign(compressed, compressed + compressedSize);
+                        entry.Compression = PackCompression::DEFLATE;
+                    }
+                    std::free(compressed);
+                }
+                if (entry.Compression == PackCompression::NONE)
+                    contents[i].assign(file.GetData(), file.GetData() + file.GetSize());
+                entry.StoredSize = (uint64_t)contents[i].size();
+            }
+        });
+        if (failed) return false;
+
+        MxString pathTable;
+        uint64_t offset = AlignOffset(sizeof(PackFileHeader), this->alignment);
+        for (size_t index : order)
+        {
+            auto& entry = entries[index];
+            entry.Offset = offset;
+            entry.PathOffset = (uint32_t)pathTable.size();
+            entry.PathLength = (uint32_t)this->files[index].PackedPath.size();
+            pathTable += this->files[index].PackedPath;
+            offset = AlignOffset(offset + entry.StoredSize, this->alignment);
+        }
+
+        PackFileHeader header;
+        header.Magic = PackFileMagic;
+        header.Version = PackFile::Version;
+        header.EntryCount = (uint32_t)entries.size();
+        header.Alignment = this->alignment;
+        header.TableOffset = AlignOffset(offset, alignof(PackFileEntry));
+        header.PathTableOffset = header.TableOffset + entries.size() * sizeof(PackFileEntry);
+
+        File file(path, File::WRITE | File::BINARY);
+        if (!file.IsOpen())
+        {
+            MXLOG_ERROR("MxEngine::PackFile", "cannot write pack file: " + ToMxString(path));
+            return false;
+        }
+
+        uint64_t written = 0;
+        const uint8_t zeros[64] = { };
+        auto writePadding = [&file, &written, &zeros](uint64_t target)
+        {
+            while (written < target)
+            {
+                auto count = std::min(target - written, (uint64_t)sizeof(zeros));
+                file.WriteBytes(zeros, (size_t)count);
+                written += count;
+            }
+        };
+
+        file.WriteBytes((const uint8_t*)&header, sizeof(PackFileHeader));
+        written += sizeof(PackFileHeader);
+        uint64_t compressedCount = 0;
+        for (size_t index : order)
+        {
+            writePadding(entries[index].Offset);
+            file.WriteBytes(contents[index].data(), contents[index].size());
+            written += contents[index].size();
+            compressedCount += entries[index].Compression != PackCompression::NONE;
+        }
+
+        writePadding(header.TableOffset);
+        for (size_t index : order)
+            file.WriteBytes((const uint8_t*)&entries[index], sizeof(PackFileEntry));
+        file.WriteBytes((const uint8_t*)pathTable.data(), pathTable.size());
+
+        if (!file.GetStream())
+        {
+            MXLOG_ERROR("MxEngine::PackFile", "cannot write pack file: " + ToMxString(path));
+            return false;
+        }
+
+        MXLOG_INFO("MxEngine::PackFile", MxFormat("packed {0} files into {1}, {2} of them are compressed",
+            entries.size(), ToMxString(path), compressedCount));
+        return true;
+    }
+
+    MxString PackFileWriter::NormalizePath(const FilePath& path)
+    {
+        auto normalized = ToMxString(path.lexically_normal());
+        std::replace(normalized.begin(), normalized.end(), '\\', '/');
+        while (!normalized.empty() && normalized.back() == '/')
+            normalized.pop_back();
+        return normalized;
+    }
+}
@@ -0,0 +1,171 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include <array>
+
+#include "MappedFile.h"
+#include "Utilities/String/String.h"
+
+namespace MxEngine
+{
+    enum class PackCompression : uint8_t
+    {
+        NONE,
+        DEFLATE,
+    };
+
+    struct PackFileHeader
+    {
+        std::array<char, 4> Magic;
+        uint32_t Version;
+        uint32_t EntryCount;
+        // every entry data begins at offset which is multiple of alignment
+        uint32_t Alignment;
+        uint64_t TableOffset;
+        uint64_t PathTableOffset;
+    };
+
+    struct PackFileEntry
+    {
+        StringId Id;
+        uint32_t PathOffset;
+        uint32_t PathLength;
+        PackCompression Compression;
+        uint8_t Padding[3];
+        uint64_t Offset;
+        // size of entry data inside pack file
+        uint64_t StoredSize;
+        // size of entry data after decompression
+        uint64_t Size;
+    };
+
+    constexpr std::array<char, 4> PackFileMagic = { 'M', 'X', 'P', 'K' };
+
+    /*!
+    pack file is a single archive which contains many project files. It is mapped into memory once and all
+    entries are read from the mapping. Table of contents is sorted by StringId of normalized file path,
+    so lookup is done with binary search and does not require any allocations
+    */
+    class PackFile
+    {
+        MappedFile file;
+        const PackFileEntry* entries = nullptr;
+        size_t entryCount = 0;
+        const char* pathTable = nullptr;
+        size_t pathTableSize = 0;
+    public:
+        static constexpr const char* PackFileExtension = ".mxpack";
+        static constexpr uint32_t Version = 1;
+
+        /*!
+        maps pack file and validates its table of contents
+        \param path path to pack file
+        \returns true if pack was opened, false otherwise
+        */
+        bool Open(const FilePath& path);
+        bool IsOpen() const;
+        const FilePath& GetPath() const;
+        size_t GetEntryCount() const;
+        ArrayView<const PackFileEntry> GetEntries() const;
+        /*!
+        searches for entry in table of contents
+        \param id StringId of normalized file path
+        \param path normalized file path, used to reject entries with the same hash
+        \returns pointer to entry or nullptr if pack does not contain file
+        */
+        const PackFileEntry* FindEntry(StringId id, const MxString& path) const;
+        /*!
+        gets normalized path of the file stored in entry
+        */
+        MxString GetEntryPath(const PackFileEntry& entry) const;
+        /*!
+        gets entry data as it is stored in pack file
+        \returns view into pack mapping, valid while pack is open
+        */
+        ArrayView<const uint8_t> GetStoredData(const PackFileEntry& entry) const;
+        /*!
+        reads entry data, decompressing it if necessary
+        \param entry entry of this pack
+        \param storage buffer for decompressed data. Not used for uncompressed entries
+        \returns view either into pack mapping or into storage. Empty view with nullptr data on failure
+        */
+        ArrayView<const uint8_t> ReadEntry(const PackFileEntry& entry, MxVector<uint8_t>& storage) const;
+    };
+
+    /*!
+    builds pack files from loose files. Used by packer tool, but can also be called from the application
+    */
+    class PackFileWriter
+    {
+        struct SourceFile
+        {
+            MxString PackedPath;
+            FilePath SourcePath;
+            bool Compress;
+        };
+
+        MxVector<SourceFile> files;
+        uint32_t alignment = 16;
+    public:
+        /*!
+        sets data alignment of entries. Larger alignment allows to map entries directly as GPU upload sources
+        \param alignment power of two alignment in bytes
+        */
+        void SetAlignment(uint32_t alignment);
+        /*!
+        adds file to the pack
+        \param packedPath path by which file is searched in the pack. Usually relative to project root directory
+        \param sourcePath path to the loose file on disk
+        \param compress should entry be compressed. Entry is stored uncompressed anyway if compression does not reduce its size
+        */
+        void AddFile(const FilePath& packedPath, const FilePath& sourcePath, bool compress = true);
+        /*!
+        adds all files inside directory and its subdirectories. Packed paths are relative to root directory
+        \param directory directory to add
+        \param rootDirectory directory which packed paths are relative to
+        \param compress should entries be compressed
+        */
+        void AddDirectory(const FilePath& directory, const FilePath& rootDirectory, bool compress = true);
+        size_t GetFileCount() const;
+        /*!
+        compresses all files and writes pack to disk
+        \param path path to resulting pack file
+        \returns true on success, false if any file cannot be read or paths have conflicting hashes
+        */
+        bool Write(const FilePath& path) const;
+
+        /*!
+        converts file path to the form in which it is stored in pack: lexically normal with forward slashes
+        \param path path relative to pack root directory
+        */
+        static MxString NormalizePath(const FilePath& path);
+    };
+}
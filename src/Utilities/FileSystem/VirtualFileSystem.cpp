@@ -0,0 +1,152 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "VirtualFileSystem.h"
+#include "Utilities/Logging/Logger.h"
+
+namespace MxEngine
+{
+    void VirtualFileSystem::Init()
+    {
+        impl = Alloc<VirtualFileSystemImpl>();
+        #if defined(MXENGINE_SHIPPING)
+        impl->preferLooseFiles = false;
+        #endif
+    }
+
+    void VirtualFileSystem::Destroy()
+    {
+        if (impl == nullptr) return;
+        Free(impl);
+        impl = nullptr;
+    }
+
+    void VirtualFileSystem::Clone(VirtualFileSystemImpl* other)
+    {
+        impl = other;
+    }
+
+    VirtualFileSystemImpl* VirtualFileSystem::GetImpl()
+    {
+        return impl;
+    }
+
+    bool VirtualFileSystem::Mount(const FilePath& path)
+    {
+        auto pack = MakeUnique<PackFile>();
+        if (!pack->Open(path))
+        {
+            MXLOG_WARNING("MxEngine::VirtualFileSystem", "cannot mount pack file: " + ToMxString(path));
+            return false;
+        }
+
+        MXLOG_INFO("MxEngine::VirtualFileSystem", "mounted pack file: " + ToMxString(path));
+        impl->packs.push_back(std::move(pack));
+        return true;
+    }
+
+    void VirtualFileSystem::UnmountAll()
+    {
+        impl->packs.clear();
+    }
+
+    bool VirtualFileSystem::HasMountedPacks()
+    {
+        return !impl->packs.empty();
+    }
+
+    ArrayView<const UniqueRef<PackFile>> VirtualFileSystem::GetMountedPacks()
+    {
+        return ArrayView<const UniqueRef<PackFile>>(impl->packs.data(), impl->packs.size());
+    }
+
+    void VirtualFileSystem::SetPreferLooseFiles(bool value)
+    {
+        impl->preferLooseFiles = value;
+    }
+
+    bool VirtualFileSystem::IsLooseFilesPreferred()
+    {
+        return impl->preferLooseFiles;
+    }
+
+    MxString VirtualFileSystem::GetPackedPath(const FilePath& path)
+    {
+        if (path.is_absolute())
+            return PackFileWriter::NormalizePath(path.lexically_proximate(std::filesystem::current_path()));
+        return PackFileWriter::NormalizePath(path);
+    }
+
+    const PackFileEntry* VirtualFileSystem::FindPackedFile(const FilePath& path, const PackFile** pack)
+    {
+        auto packedPath = VirtualFileSystem::GetPackedPath(path);
+        auto id = MakeStringId(packedPath);
+        for (auto it = impl->packs.rbegin(); it != impl->packs.rend(); it++)
+        {
+            auto entry = (*it)->FindEntry(id, packedPath);
+            if (entry != nullptr)
+            {
+                *pack = it->get();
+                return entry;
+            }
+        }
+        return nullptr;
+    }
+
+    bool VirtualFileSystem::IsPacked(const FilePath& path)
+    {
+        // avoid touching disk if there is nothing to resolve against
+        if (impl == nullptr || impl->packs.empty()) return false;
+        if (impl->preferLooseFiles && File::IsFile(path)) return false;
+
+        const PackFile* pack = nullptr;
+        return VirtualFileSystem::FindPackedFile(path, &pack) != nullptr;
+    }
+
+    bool VirtualFileSystem::Exists(const FilePath& path)
+    {
+        return File::Exists(path) || VirtualFileSystem::IsPacked(path);
+    }
+
+    bool VirtualFileSystem::IsFile(const FilePath& path)
+    {
+        return File::IsFile(path) || VirtualFileSystem::IsPacked(path);
+    }
+
+    ArrayView<const uint8_t> VirtualFileSystem::ReadPackedFile(const FilePath& path, MxVector<uint8_t>& storage)
+    {
+        if (impl == nullptr || impl->packs.empty()) return ArrayView<const uint8_t>();
+        if (impl->preferLooseFiles && File::IsFile(path)) return ArrayView<const uint8_t>();
+
+        const PackFile* pack = nullptr;
+        auto entry = VirtualFileSystem::FindPackedFile(path, &pack);
+        if (entry == nullptr) return ArrayView<const uint8_t>();
+        return pack->ReadEntry(*entry, storage);
+    }
+}
@@ -0,0 +1,98 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "PackFile.h"
+#include "Utilities/Memory/Memory.h"
+
+namespace MxEngine
+{
+    struct VirtualFileSystemImpl
+    {
+        // mounted packs in order of priority. Later mounted packs override earlier ones
+        MxVector<UniqueRef<PackFile>> packs;
+        // if set, files which exist on disk are preferred over packed ones
+        bool preferLooseFiles = true;
+    };
+
+    /*!
+    virtual file system resolves project files either from disk or from mounted pack files.
+    In development builds loose files override packed ones, so assets can be edited without repacking.
+    In shipping builds packed files are preferred and project directory is not scanned at all
+    */
+    class VirtualFileSystem
+    {
+        inline static VirtualFileSystemImpl* impl = nullptr;
+
+        static const PackFileEntry* FindPackedFile(const FilePath& path, const PackFile** pack);
+    public:
+        static void Init();
+        static void Destroy();
+        static void Clone(VirtualFileSystemImpl* other);
+        static VirtualFileSystemImpl* GetImpl();
+
+        /*!
+        maps pack file and makes its entries accessible by their paths
+        \param path path to pack file
+        \returns true if pack was mounted, false otherwise
+        */
+        static bool Mount(const FilePath& path);
+        static void UnmountAll();
+        static bool HasMountedPacks();
+        static ArrayView<const UniqueRef<PackFile>> GetMountedPacks();
+        static void SetPreferLooseFiles(bool value);
+        static bool IsLooseFilesPreferred();
+        /*!
+        converts path to the form in which it is stored in packs
+        \param path absolute path or path relative to working directory
+        */
+        static MxString GetPackedPath(const FilePath& path);
+        /*!
+        checks if file should be read from pack, considering loose file overrides
+        \param path absolute path or path relative to working directory
+        */
+        static bool IsPacked(const FilePath& path);
+        /*!
+        checks if file exists either on disk or in one of mounted packs
+        */
+        static bool Exists(const FilePath& path);
+        /*!
+        checks if path refers to a regular file either on disk or in one of mounted packs
+        */
+        static bool IsFile(const FilePath& path);
+        /*!
+        reads packed file contents
+        \param path absolute path or path relative to working directory
+        \param storage buffer for decompressed data. Not used for uncompressed entries
+        \returns view either into pack mapping or into storage. Empty view with nullptr data if file is not packed
+        */
+        static ArrayView<const uint8_t> ReadPackedFile(const FilePath& path, MxVector<uint8_t>& storage);
+    };
+}
@@ -27,6 +27,7 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "Image.h"
+#include "ImageConverter.h"
 #include "Core/Macro/Macro.h"
 #include <memory>
 #include <cstdlib>
@@ -42,7 +43,12 @@ namespace MxEngine
     ImageData::ImageData() : ImageData(nullptr, 0, 0, 0, false) { }
 
     ImageData::ImageData(uint8_t* data, size_t width, size_t height, size_t channels, bool isFloatingPoint)
-        : data(data), width(width), height(height), channels((uint8_t)channels), isFloatingPoint(isFloatingPoint)
+        : ImageData(data, width, height, channels, isFloatingPoint ? ImageFormat::FLOAT : ImageFormat::BYTE)
+    {
+    }
+
+    ImageData::ImageData(uint8_t* data, size_t width, size_t height, size_t channels, ImageFormat format)
+        : data(data), width(width), height(height), channels((uint8_t)channels), format(format)
     {
     }
 
@@ -57,9 +63,10 @@ namespace MxEngine
         this->width = other.width;
         this->height = other.height;
         this->channels = other.channels;
-        this->isFloatingPoint = other.isFloatingPoint;
+        this->format = other.format;
         other.data = nullptr;
-        other.width = other.height = other.channels = other.isFloatingPoint = 0;
+        other.width = other.height = other.channels = 0;
+        other.format = ImageFormat::BYTE;
     }
 
     ImageData& ImageData::operator=(ImageData&& other) noexcept
@@ -70,9 +77,10 @@ namespace MxEngine
         this->width = other.width;
         this->height = other.height;
         this->channels = other.channels;
-        this->isFloatingPoint = other.isFloatingPoint;
+        this->format = other.format;
         other.data = nullptr;
-        other.width = other.height = other.channels = other.isFloatingPoint = 0;
+        other.width = other.height = other.channels = 0;
+        other.format = ImageFormat::BYTE;
         return *this;
     }
 
@@ -98,7 +106,20 @@ namespace MxEngine
 
     size_t ImageData::GetChannelSize() const
     {
-        return this->isFloatingPoint ? sizeof(float) : sizeof(uint8_t);
+        return ImageData::GetChannelSize(this->format);
+    }
+
+    size_t ImageData::GetChannelSize(ImageFormat format)
+    {
+        switch (format)
+        {
+        case ImageFormat::FLOAT:
+            return sizeof(float);
+        case ImageFormat::HALF_FLOAT:
+            return sizeof(uint16_t);
+        default:
+            return sizeof(uint8_t);
+        }
     }
 
     size_t ImageData::GetPixelSize() const
@@ -111,14 +132,24 @@ namespace MxEngine
         return this->GetHeight() * this->GetWidth() * this->GetPixelSize();
     }
 
+    ImageFormat ImageData::GetFormat() const
+    {
+        return this->format;
+    }
+
     bool ImageData::IsFloatingPoint() const
     {
-        return this->isFloatingPoint;
+        return this->format == ImageFormat::FLOAT;
+    }
+
+    bool ImageData::IsHalfFloat() const
+    {
+        return this->format == ImageFormat::HALF_FLOAT;
     }
 
     void ImageData::SetPixelByte(size_t x, size_t y, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
     {
-        if (this->isFloatingPoint)
+        if (this->format != ImageFormat::BYTE)
         {
             this->SetPixelFloat(x, y, (float)r / 255.0f, (float)g / 255.0f, (float)b / 255.0f, (float)a / 255.0f);
             return;
@@ -159,7 +190,7 @@ namespace MxEngine
 
     void ImageData::SetPixelFloat(size_t x, size_t y, float r, float g, float b, float a)
     {
-        if (!this->isFloatingPoint)
+        if (this->format == ImageFormat::BYTE)
         {
             this->SetPixelByte(x, y, 
                 (uint8_t)Clamp(r * 255.0f, 0.0f, 255.0f),
@@ -171,6 +202,15 @@ namespace MxEngine
         }
 
         MX_ASSERT(x < this->width&& y < this->height);
+        if (this->format == ImageFormat::HALF_FLOAT)
+        {
+            std::array<float, 4> rgba = { r, g, b, a };
+            auto pixel = (uint16_t*)this->data + (x * this->height + y) * this->channels;
+            for (size_t i = 0; i < this->channels; i++)
+                pixel[i] = ImageConverter::FloatToHalf(rgba[i]);
+            return;
+        }
+
         switch (this->channels)
         {
         case 1:
@@ -200,7 +240,7 @@ namespace MxEngine
     std::array<uint8_t, 4> ImageData::GetPixelByte(size_t x, size_t y) const
     {
         std::array<uint8_t, 4> rgba{ 0, 0, 0, 255 };
-        if (this->isFloatingPoint)
+        if (this->format != ImageFormat::BYTE)
         {
             auto pixel = this->GetPixelFloat(x, y);
             rgba[0] = (uint8_t)Clamp(pixel[0] * 255.0f, 0.0f, 255.0f);
@@ -241,7 +281,7 @@ namespace MxEngine
     std::array<float, 4> ImageData::GetPixelFloat(size_t x, size_t y) const
     {
         std::array<float, 4> rgba{ 0.0f, 0.0f, 0.0f, 1.0f };
-        if (!this->isFloatingPoint)
+        if (this->format == ImageFormat::BYTE)
         {
             auto pixel = this->GetPixelByte(x, y);
             rgba[0] = (float)pixel[0] / 255.0f;
@@ -252,6 +292,14 @@ namespace MxEngine
         }
 
         MX_ASSERT(x < this->width && y < this->height);
+        if (this->format == ImageFormat::HALF_FLOAT)
+        {
+            auto pixel = (const uint16_t*)this->data + (x * this->height + y) * this->channels;
+            for (size_t i = 0; i < this->channels; i++)
+                rgba[i] = ImageConverter::HalfToFloat(pixel[i]);
+            return rgba;
+        }
+
         switch (this->channels)
         {
         case 1:
@@ -34,18 +34,26 @@
 
 namespace MxEngine
 {
+    enum class ImageFormat : uint8_t
+    {
+        BYTE,
+        FLOAT,
+        HALF_FLOAT,
+    };
+
     class ImageData
     {
         uint8_t* data;
         size_t width;
         size_t height;
         uint8_t channels;
-        bool isFloatingPoint;
+        ImageFormat format;
 
         void Free();
     public:
         ImageData();
         ImageData(uint8_t* data, size_t width, size_t height, size_t channels, bool isFloatingPoint);
+        ImageData(uint8_t* data, size_t width, size_t height, size_t channels, ImageFormat format);
         ~ImageData();
         ImageData(const ImageData&) = delete;
         ImageData& operator=(const ImageData&) = delete;
@@ -59,7 +67,11 @@ namespace MxEngine
         size_t GetChannelSize() const;
         size_t GetPixelSize() const;
         size_t GetTotalByteSize() const;
+        ImageFormat GetFormat() const;
         bool IsFloatingPoint() const;
+        bool IsHalfFloat() const;
+
+        static size_t GetChannelSize(ImageFormat format);
 
         void SetPixelByte(size_t x, size_t y, uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255);
         void SetPixelFloat(size_t x, size_t y, float r, float g, float b, float a = 1.0f);
@@ -28,14 +28,37 @@
 
 #include "ImageConverter.h"
 #include "Utilities/Profiler/Profiler.h"
+#include "Core/Macro/Macro.h"
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <stb_image_write.h>
 
 #include <algorithm>
+#include <mutex>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MXENGINE_IMAGE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__SSSE3__) || defined(__AVX__)
+#define MXENGINE_IMAGE_SSSE3
+#include <tmmintrin.h>
+#endif
+
+#if defined(__F16C__) || defined(__AVX2__)
+#define MXENGINE_IMAGE_F16C
+#include <immintrin.h>
+#endif
 
 namespace MxEngine
 {
+    // stb_image_write stores vertical flip flag globally, so setting it and encoding an image must not be interleaved between threads
+    static std::mutex StbWriteMutex;
+
     void CopyImageData(void* context, void* data, int size)
     {
         auto* storage = (ImageConverter::RawImageData*)(context);
@@ -51,6 +74,7 @@ namespace MxEngine
         MAKE_SCOPE_PROFILER("ImageWriter::ConvertImagePNG");
         MAKE_SCOPE_TIMER("MxEngine::ImageWriter", "ImageWriter::ConvertImagePNG()");
 
+        std::lock_guard<std::mutex> lock(StbWriteMutex);
         stbi_flip_vertically_on_write(flipOnConvert);
         stbi_write_png_to_func(CopyImageData, (void*)&data, width, height, channels, (const void*)imagedata, width * channels);
         return data;
@@ -63,6 +87,7 @@ namespace MxEngine
         MAKE_SCOPE_PROFILER("ImageWriter::ConvertImageBMP");
         MAKE_SCOPE_TIMER("MxEngine::ImageWriter", "ImageWriter::ConvertImageBMP()");
 
+        std::lock_guard<std::mutex> lock(StbWriteMutex);
         stbi_flip_vertically_on_write(flipOnConvert);
         stbi_write_bmp_to_func(CopyImageData, (void*)&data, width, height, channels, (const void*)imagedata);
         return data;
@@ -75,6 +100,7 @@ namespace MxEngine
         MAKE_SCOPE_PROFILER("ImageWriter::ConvertImageTGA");
         MAKE_SCOPE_TIMER("MxEngine::ImageWriter", "ImageWriter::ConvertImageTGA()");
 
+        std::lock_guard<std::mutex> lock(StbWriteMutex);
         stbi_flip_vertically_on_write(flipOnConvert);
         stbi_write_tga_to_func(CopyImageData, (void*)&data, width, height, channels, (const void*)imagedata);
         return data;
@@ -87,6 +113,7 @@ namespace MxEngine
         MAKE_SCOPE_PROFILER("ImageWriter::ConvertImageJPG");
         MAKE_SCOPE_TIMER("MxEngine::ImageWriter", "ImageWriter::ConvertImageJPG()");
 
+        std::lock_guard<std::mutex> lock(StbWriteMutex);
         stbi_flip_vertically_on_write(flipOnConvert);
         stbi_write_jpg_to_func(CopyImageData, (void*)&data, width, height, channels, (const void*)imagedata, quality);
         return data;
@@ -99,6 +126,7 @@ namespace MxEngine
         MAKE_SCOPE_PROFILER("ImageWriter::ConvertImageHDR");
         MAKE_SCOPE_TIMER("MxEngine::ImageWriter", "ImageWriter::ConvertImageHDR()");
 
+        std::lock_guard<std::mutex> lock(StbWriteMutex);
         stbi_flip_vertically_on_write(flipOnConvert);
         stbi_write_hdr_to_func(CopyImageData, (void*)&data, width, height, channels, (const float*)imagedata);
         return data;
@@ -106,31 +134,379 @@ namespace MxEngine
 
     ImageConverter::RawImageData ImageConverter::ConvertImagePNG(const ImageData& image, bool flipOnSave)
     {
-        if (image.IsFloatingPoint()) return { };
+        if (image.GetFormat() != ImageFormat::BYTE) return { };
         return ImageConverter::ConvertImagePNG(image.GetRawData(), (int)image.GetWidth(), (int)image.GetHeight(), (int)image.GetChannelCount(), flipOnSave);
     }
 
     ImageConverter::RawImageData ImageConverter::ConvertImageBMP(const ImageData& image, bool flipOnSave)
     {
-        if (image.IsFloatingPoint()) return { };
+        if (image.GetFormat() != ImageFormat::BYTE) return { };
         return ImageConverter::ConvertImageBMP(image.GetRawData(), (int)image.GetWidth(), (int)image.GetHeight(), (int)image.GetChannelCount(), flipOnSave);
     }
 
     ImageConverter::RawImageData ImageConverter::ConvertImageTGA(const ImageData& image, bool flipOnSave)
     {
-        if (image.IsFloatingPoint()) return { };
+        if (image.GetFormat() != ImageFormat::BYTE) return { };
         return ImageConverter::ConvertImageTGA(image.GetRawData(), (int)image.GetWidth(), (int)image.GetHeight(), (int)image.GetChannelCount(), flipOnSave);
     }
 
     ImageConverter::RawImageData ImageConverter::ConvertImageJPG(const ImageData& image, int quality, bool flipOnSave)
     {
-        if (image.IsFloatingPoint()) return { };
+        if (image.GetFormat() != ImageFormat::BYTE) return { };
         return ImageConverter::ConvertImageJPG(image.GetRawData(), (int)image.GetWidth(), (int)image.GetHeight(), (int)image.GetChannelCount(), quality, flipOnSave);
     }
 
     ImageConverter::RawImageData ImageConverter::ConvertImageHDR(const ImageData& image, bool flipOnSave)
     {
+        if (image.IsHalfFloat())
+        {
+            auto floatImage = ImageConverter::ConvertToFloat(image);
+            return ImageConverter::ConvertImageHDR(floatImage, flipOnSave);
+        }
         if (!image.IsFloatingPoint()) return { };
         return ImageConverter::ConvertImageHDR((float*)image.GetRawData(), (int)image.GetWidth(), (int)image.GetHeight(), (int)image.GetChannelCount(), flipOnSave);
     }
+
+    ImageConverter::RawImageData ImageConverter::ConvertImageRAW(const ImageData& image)
+    {
+        ImageConverter::RawImageData data;
+
+        MAKE_SCOPE_PROFILER("ImageWriter::ConvertImageRAW");
+
+        RawImageHeader header;
+        header.Magic = RawImageMagic;
+        header.Width = (uint32_t)image.GetWidth();
+        header.Height = (uint32_t)image.GetHeight();
+        header.Channels = (uint8_t)image.GetChannelCount();
+        header.Format = image.GetFormat();
+        header.Padding[0] = header.Padding[1] = 0;
+
+        // no encoding is done, so raw images are much faster to save and load than PNG at the cost of disk space
+        data.resize(sizeof(RawImageHeader) + image.GetTotalByteSize());
+        std::memcpy(data.data(), &header, sizeof(RawImageHeader));
+        if (image.GetTotalByteSize() > 0)
+            std::memcpy(data.data() + sizeof(RawImageHeader), image.GetRawData(), image.GetTotalByteSize());
+        return data;
+    }
+
+    void ImageConverter::ExtractChannel(const uint8_t* source, uint8_t* destination, size_t pixelCount, size_t channelCount, size_t channel)
+    {
+        MX_ASSERT(channel < channelCount);
+        size_t i = 0;
+
+        #if defined(MXENGINE_IMAGE_SSE2)
+        if (channelCount == 4)
+        {
+            // each 32-bit lane holds one pixel: shift required channel to the low byte and pack 16 pixels into one register
+            const __m128i mask = _mm_set1_epi32(0xFF);
+            const __m128i shift = _mm_cvtsi32_si128(int(channel * 8));
+            for (; i + 16 <= pixelCount; i += 16)
+            {
+                auto pixels = (const __m128i*)(source + i * 4);
+                __m128i p0 = _mm_and_si128(_mm_srl_epi32(_mm_loadu_si128(pixels + 0), shift), mask);
+                __m128i p1 = _mm_and_si128(_mm_srl_epi32(_mm_loadu_si128(pixels + 1), shift), mask);
+                __m128i p2 = _mm_and_si128(_mm_srl_epi32(_mm_loadu_si128(pixels + 2), shift), mask);
+                __m128i p3 = _mm_and_si128(_mm_srl_epi32(_mm_loadu_si128(pixels + 3), shift), mask);
+                __m128i low = _mm_packs_epi32(p0, p1);
+                __m128i high = _mm_packs_epi32(p2, p3);
+                _mm_storeu_si128((__m128i*)(destination + i), _mm_packus_epi16(low, high));
+            }
+        }
+        #endif
+
+        for (; i < pixelCount; i++)
+        {
+            destination[i] = source[i * channelCount + channel];
+        }
+    }
+
+    void ImageConverter::ExtractChannel(const float* source, float* destination, size_t pixelCount, size_t channelCount, size_t channel)
+    {
+        MX_ASSERT(channel < channelCount);
+        size_t i = 0;
+
+        #if defined(MXENGINE_IMAGE_SSE2)
+        if (channelCount == 4)
+        {
+            for (; i + 4 <= pixelCount; i += 4)
+            {
+                __m128 rows[4];
+                rows[0] = _mm_loadu_ps(source + i * 4 + 0);
+                rows[1] = _mm_loadu_ps(source + i * 4 + 4);
+                rows[2] = _mm_loadu_ps(source + i * 4 + 8);
+                rows[3] = _mm_loadu_ps(source + i * 4 + 12);
+                _MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+                _mm_storeu_ps(destination + i, rows[channel]);
+            }
+        }
+        #endif
+
+        for (; i < pixelCount; i++)
+        {
+            destination[i] = source[i * channelCount + channel];
+        }
+    }
+
+    void ImageConverter::SwizzleChannels(const uint8_t* source, uint8_t* destination, size_t pixelCount, const std::array<uint8_t, 4>& order)
+    {
+        MX_ASSERT(order[0] < 4 && order[1] < 4 && order[2] < 4 && order[3] < 4);
+        size_t i = 0;
+
+        #if defined(MXENGINE_IMAGE_SSSE3)
+        alignas(16) uint8_t shuffle[16];
+        for (size_t j = 0; j < 16; j++)
+        {
+            shuffle[j] = uint8_t(j & ~size_t(3)) + order[j & 3];
+        }
+        const __m128i mask = _mm_load_si128((const __m128i*)shuffle);
+        for (; i + 4 <= pixelCount; i += 4)
+        {
+            __m128i pixels = _mm_loadu_si128((const __m128i*)(source + i * 4));
+            _mm_storeu_si128((__m128i*)(destination + i * 4), _mm_shuffle_epi8(pixels, mask));
+        }
+        #endif
+
+        for (; i < pixelCount; i++)
+        {
+            const uint8_t* pixel = source + i * 4;
+            uint8_t* result = destination + i * 4;
+            uint8_t r = pixel[order[0]], g = pixel[order[1]], b = pixel[order[2]], a = pixel[order[3]];
+            result[0] = r;
+            result[1] = g;
+            result[2] = b;
+            result[3] = a;
+        }
+    }
+
+    ImageData ImageConverter::ExtractChannel(const ImageData& image, size_t channel)
+    {
+        MAKE_SCOPE_PROFILER("ImageConverter::ExtractChannel");
+        if (channel >= image.GetChannelCount() || image.IsHalfFloat()) return { };
+
+        size_t pixelCount = image.GetWidth() * image.GetHeight();
+        auto data = (uint8_t*)std::malloc(pixelCount * image.GetChannelSize());
+        if (image.IsFloatingPoint())
+            ImageConverter::ExtractChannel((const float*)image.GetRawData(), (float*)data, pixelCount, image.GetChannelCount(), channel);
+        else
+            ImageConverter::ExtractChannel(image.GetRawData(), data, pixelCount, image.GetChannelCount(), channel);
+
+        return ImageData(data, image.GetWidth(), image.GetHeight(), 1, image.IsFloatingPoint());
+    }
+
+    ImageData ImageConverter::SwizzleChannels(const ImageData& image, const std::array<uint8_t, 4>& order)
+    {
+        MAKE_SCOPE_PROFILER("ImageConverter::SwizzleChannels");
+        if (image.GetFormat() != ImageFormat::BYTE || image.GetChannelCount() != 4) return { };
+
+        size_t pixelCount = image.GetWidth() * image.GetHeight();
+        auto data = (uint8_t*)std::malloc(image.GetTotalByteSize());
+        ImageConverter::SwizzleChannels(image.GetRawData(), data, pixelCount, order);
+
+        return ImageData(data, image.GetWidth(), image.GetHeight(), image.GetChannelCount(), false);
+    }
+
+    uint16_t ImageConverter::FloatToHalf(float value)
+    {
+        // round-to-nearest-even conversion, overflowing values become infinity and NaNs stay NaNs
+        constexpr uint32_t FloatInfinity = 255u << 23;
+        constexpr uint32_t HalfMax = (127u + 16u) << 23;
+        constexpr uint32_t HalfMinNormal = (127u - 14u) << 23;
+        constexpr uint32_t SubnormalMagic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        uint32_t sign = bits & 0x80000000u;
+        bits ^= sign;
+
+        uint16_t result;
+        if (bits >= HalfMax)
+        {
+            result = bits > FloatInfinity ? 0x7E00 : 0x7C00;
+        }
+        else if (bits < HalfMinNormal)
+        {
+            // let FPU align mantissa of subnormal value by adding magic number
+            float magic, absolute;
+            std::memcpy(&magic, &SubnormalMagic, sizeof(magic));
+            std::memcpy(&absolute, &bits, sizeof(absolute));
+            absolute += magic;
+            std::memcpy(&bits, &absolute, sizeof(bits));
+            result = uint16_t(bits - SubnormalMagic);
+        }
+        else
+        {
+            uint32_t mantissaOdd = (bits >> 13) & 1u;
+            bits += 0xFFFu - ((127u - 15u) << 23);
+            bits += mantissaOdd;
+            result = uint16_t(bits >> 13);
+        }
+        return result | uint16_t(sign >> 16);
+    }
+
+    float ImageConverter::HalfToFloat(uint16_t value)
+    {
+        constexpr uint32_t ShiftedExponent = 0x7C00u << 13;
+        constexpr uint32_t SubnormalMagic = 113u << 23;
+
+        uint32_t bits = (uint32_t(value) & 0x7FFFu) << 13;
+        uint32_t exponent = bits & ShiftedExponent;
+        bits += (127u - 15u) << 23;
+
+        if (exponent == ShiftedExponent) // infinity or NaN
+        {
+            bits += (128u - 16u) << 23;
+        }
+        else if (exponent == 0) // zero or subnormal
+        {
+            float magic, result;
+            bits += 1u << 23;
+            std::memcpy(&magic, &SubnormalMagic, sizeof(magic));
+            std::memcpy(&result, &bits, sizeof(result));
+            result -= magic;
+            std::memcpy(&bits, &result, sizeof(bits));
+        }
+        bits |= (uint32_t(value) & 0x8000u) << 16;
+
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    void ImageConverter::ConvertFloatToHalf(const float* source, uint16_t* destination, size_t count)
+    {
+        size_t i = 0;
+
+        #if defined(MXENGINE_IMAGE_F16C)
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i half = _mm_cvtps_ph(_mm_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storel_epi64((__m128i*)(destination + i), half);
+        }
+        #elif defined(MXENGINE_IMAGE_SSE2)
+        // same algorithm as FloatToHalf, but branches are replaced with masks
+        const __m128i signMask = _mm_set1_epi32(int(0x80000000u));
+        const __m128i halfMax = _mm_set1_epi32((127 + 16) << 23);
+        const __m128i nanBit = _mm_set1_epi32(0x200);
+        const __m128i halfInfinity = _mm_set1_epi32(0x7C00);
+        const __m128i halfMinNormal = _mm_set1_epi32((127 - 14) << 23);
+        const __m128i subnormalMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+        const __m128i normalBias = _mm_set1_epi32(0xFFF - ((127 - 15) << 23));
+
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i packed[2];
+            for (size_t j = 0; j < 2; j++)
+            {
+                __m128 value = _mm_loadu_ps(source + i + j * 4);
+                __m128 sign = _mm_and_ps(value, _mm_castsi128_ps(signMask));
+                __m128 absolute = _mm_xor_ps(value, sign);
+                __m128i absoluteBits = _mm_castps_si128(absolute);
+
+                __m128i isNaN = _mm_castps_si128(_mm_cmpunord_ps(absolute, absolute));
+                __m128i isRegular = _mm_cmpgt_epi32(halfMax, absoluteBits);
+                __m128i infinityOrNaN = _mm_or_si128(_mm_and_si128(isNaN, nanBit), halfInfinity);
+                __m128i isSubnormal = _mm_cmpgt_epi32(halfMinNormal, absoluteBits);
+
+                __m128 subnormalSum = _mm_add_ps(absolute, _mm_castsi128_ps(subnormalMagic));
+                __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(subnormalSum), subnormalMagic);
+
+                __m128i mantissaOdd = _mm_srai_epi32(_mm_slli_epi32(absoluteBits, 31 - 13), 31);
+                __m128i rounded = _mm_sub_epi32(_mm_add_epi32(absoluteBits, normalBias), mantissaOdd);
+                __m128i normal = _mm_srli_epi32(rounded, 13);
+
+                __m128i finite = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+                __m128i joined = _mm_or_si128(_mm_and_si128(isRegular, finite), _mm_andnot_si128(isRegular, infinityOrNaN));
+                // arithmetic shift keeps result in signed 16-bit range, so it survives saturating pack below
+                packed[j] = _mm_or_si128(joined, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+            }
+            _mm_storeu_si128((__m128i*)(destination + i), _mm_packs_epi32(packed[0], packed[1]));
+        }
+        #endif
+
+        for (; i < count; i++)
+        {
+            destination[i] = ImageConverter::FloatToHalf(source[i]);
+        }
+    }
+
+    void ImageConverter::ConvertHalfToFloat(const uint16_t* source, float* destination, size_t count)
+    {
+        size_t i = 0;
+
+        #if defined(MXENGINE_IMAGE_F16C)
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i half = _mm_loadl_epi64((const __m128i*)(source + i));
+            _mm_storeu_ps(destination + i, _mm_cvtph_ps(half));
+        }
+        #endif
+
+        for (; i < count; i++)
+        {
+            destination[i] = ImageConverter::HalfToFloat(source[i]);
+        }
+    }
+
+    void ImageConverter::ConvertFloatToRGBE(const float* source, uint8_t* destination, size_t pixelCount, size_t channelCount)
+    {
+        MX_ASSERT(channelCount >= 3);
+        for (size_t i = 0; i < pixelCount; i++)
+        {
+            const float* pixel = source + i * channelCount;
+            uint8_t* result = destination + i * 4;
+            float maxComponent = std::max(pixel[0], std::max(pixel[1], pixel[2]));
+            if (maxComponent < 1e-32f)
+            {
+                result[0] = result[1] = result[2] = result[3] = 0;
+                continue;
+            }
+
+            // all components share exponent of the largest one
+            int exponent;
+            float scale = std::frexp(maxComponent, &exponent) * 256.0f / maxComponent;
+            result[0] = (uint8_t)std::max(pixel[0] * scale, 0.0f);
+            result[1] = (uint8_t)std::max(pixel[1] * scale, 0.0f);
+            result[2] = (uint8_t)std::max(pixel[2] * scale, 0.0f);
+            result[3] = (uint8_t)(exponent + 128);
+        }
+    }
+
+    void ImageConverter::ConvertRGBEToFloat(const uint8_t* source, float* destination, size_t pixelCount, size_t channelCount)
+    {
+        MX_ASSERT(channelCount >= 3);
+        for (size_t i = 0; i < pixelCount; i++)
+        {
+            const uint8_t* pixel = source + i * 4;
+            float* result = destination + i * channelCount;
+            float scale = pixel[3] == 0 ? 0.0f : std::ldexp(1.0f, int(pixel[3]) - (128 + 8));
+            result[0] = float(pixel[0]) * scale;
+            result[1] = float(pixel[1]) * scale;
+            result[2] = float(pixel[2]) * scale;
+            if (channelCount > 3) result[3] = 1.0f;
+        }
+    }
+
+    ImageData ImageConverter::ConvertToHalfFloat(const ImageData& image)
+    {
+        MAKE_SCOPE_PROFILER("ImageConverter::ConvertToHalfFloat");
+        if (!image.IsFloatingPoint()) return { };
+
+        size_t elementCount = image.GetWidth() * image.GetHeight() * image.GetChannelCount();
+        auto data = (uint8_t*)std::malloc(elementCount * sizeof(uint16_t));
+        ImageConverter::ConvertFloatToHalf((const float*)image.GetRawData(), (uint16_t*)data, elementCount);
+
+        return ImageData(data, image.GetWidth(), image.GetHeight(), image.GetChannelCount(), ImageFormat::HALF_FLOAT);
+    }
+
+    ImageData ImageConverter::ConvertToFloat(const ImageData& image)
+    {
+        MAKE_SCOPE_PROFILER("ImageConverter::ConvertToFloat");
+        if (!image.IsHalfFloat()) return { };
+
+        size_t elementCount = image.GetWidth() * image.GetHeight() * image.GetChannelCount();
+        auto data = (uint8_t*)std::malloc(elementCount * sizeof(float));
+        ImageConverter::ConvertHalfToFloat((const uint16_t*)image.GetRawData(), (float*)data, elementCount);
+
+        return ImageData(data, image.GetWidth(), image.GetHeight(), image.GetChannelCount(), ImageFormat::FLOAT);
+    }
 }
\ No newline at end of file
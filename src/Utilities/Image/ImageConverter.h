@@ -32,13 +32,32 @@
 #include "Utilities/STL/MxVector.h"
 #include "Image.h"
 
+#include <array>
+
 namespace MxEngine
 {
+    /*!
+    header of raw image container. Pixel data follows the header and is stored exactly as in ImageData (i.e. already flipped for OpenGL)
+    */
+    struct RawImageHeader
+    {
+        std::array<char, 4> Magic;
+        uint32_t Width;
+        uint32_t Height;
+        uint8_t Channels;
+        ImageFormat Format;
+        uint8_t Padding[2];
+    };
+
+    constexpr std::array<char, 4> RawImageMagic = { 'M', 'X', 'I', 'M' };
+
     class ImageConverter
     {
     public:
         using RawImageData = MxVector<uint8_t>;
 
+        static constexpr const char* RawImageExtension = ".mximage";
+
         static RawImageData ConvertImagePNG(const uint8_t* imagedata, int width, int height, int channels, bool flipOnSave = true);
         static RawImageData ConvertImageBMP(const uint8_t* imagedata, int width, int height, int channels, bool flipOnSave = true);
         static RawImageData ConvertImageTGA(const uint8_t* imagedata, int width, int height, int channels, bool flipOnSave = true);
@@ -50,5 +69,23 @@ namespace MxEngine
         static RawImageData ConvertImageTGA(const ImageData& image, bool flipOnSave = true);
         static RawImageData ConvertImageJPG(const ImageData& image, int  quality = 90, bool flipOnSave = true);
         static RawImageData ConvertImageHDR(const ImageData& image, bool flipOnSave = true);
+        static RawImageData ConvertImageRAW(const ImageData& image);
+
+        static void ExtractChannel(const uint8_t* source, uint8_t* destination, size_t pixelCount, size_t channelCount, size_t channel);
+        static void ExtractChannel(const float* source, float* destination, size_t pixelCount, size_t channelCount, size_t channel);
+        static void SwizzleChannels(const uint8_t* source, uint8_t* destination, size_t pixelCount, const std::array<uint8_t, 4>& order);
+
+        static ImageData ExtractChannel(const ImageData& image, size_t channel);
+        static ImageData SwizzleChannels(const ImageData& image, const std::array<uint8_t, 4>& order);
+
+        static uint16_t FloatToHalf(float value);
+        static float HalfToFloat(uint16_t value);
+        static void ConvertFloatToHalf(const float* source, uint16_t* destination, size_t count);
+        static void ConvertHalfToFloat(const uint16_t* source, float* destination, size_t count);
+        static void ConvertFloatToRGBE(const float* source, uint8_t* destination, size_t pixelCount, size_t channelCount);
+        static void ConvertRGBEToFloat(const uint8_t* source, float* destination, size_t pixelCount, size_t channelCount);
+
+        static ImageData ConvertToHalfFloat(const ImageData& image);
+        static ImageData ConvertToFloat(const ImageData& image);
     };
 }
\ No newline at end of file
@@ -30,12 +30,74 @@
 #include "Core/Macro/Macro.h"
 #include "Utilities/Profiler/Profiler.h"
 #include "Utilities/Math/Math.h"
+#include "Utilities/Image/ImageConverter.h"
+#include "Utilities/Image/ImageManager.h"
+#include "Utilities/FileSystem/MappedFile.h"
+#include "Utilities/Threading/ThreadPool.h"
+
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MXENGINE_IMAGE_SSE2
+#include <emmintrin.h>
+#endif
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
 namespace MxEngine
 {
+    static bool IsRawImage(const RawImageHeader& header)
+    {
+        return header.Magic == RawImageMagic && header.Channels > 0 && header.Channels <= 4 && header.Format <= ImageFormat::HALF_FLOAT;
+    }
+
+    static size_t GetRawImageByteSize(const RawImageHeader& header)
+    {
+        return (size_t)header.Width * (size_t)header.Height * (size_t)header.Channels * ImageData::GetChannelSize(header.Format);
+    }
+
+    static ImageData MakeRawImage(const RawImageHeader& header, uint8_t* data, bool flipImage)
+    {
+        ImageData image(data, (size_t)header.Width, (size_t)header.Height, (size_t)header.Channels, header.Format);
+        if (!flipImage) ImageManager::FlipImage(image); // raw images are stored already flipped
+        return image;
+    }
+
+    static bool IsRawImageData(const uint8_t* memory, size_t byteSize, RawImageHeader& header)
+    {
+        if (byteSize < sizeof(RawImageHeader)) return false;
+        std::memcpy(&header, memory, sizeof(RawImageHeader));
+        return IsRawImage(header) && byteSize >= sizeof(RawImageHeader) + GetRawImageByteSize(header);
+    }
+
+    static ImageData DecodeImage(const uint8_t* memory, size_t byteSize, bool flipImage)
+    {
+        RawImageHeader header;
+        if (IsRawImageData(memory, byteSize, header))
+        {
+            auto data = (uint8_t*)std::malloc(GetRawImageByteSize(header));
+            std::memcpy(data, memory + sizeof(RawImageHeader), GetRawImageByteSize(header));
+            return MakeRawImage(header, data, flipImage);
+        }
+
+        stbi_set_flip_vertically_on_load_thread(flipImage); // images may be loaded from several threads at once
+        int width, height, channels;
+        if (stbi_is_hdr_from_memory(memory, (int)byteSize))
+        {
+            float* data = stbi_loadf_from_memory(memory, (int)byteSize, &width, &height, &channels, STBI_rgb_alpha);
+            if (data == nullptr) { width = height = 0; }
+            channels = 4;
+            return ImageData((uint8_t*)data, (size_t)width, (size_t)height, (size_t)channels, ImageFormat::FLOAT);
+        }
+
+        uint8_t* data = stbi_load_from_memory(memory, (int)byteSize, &width, &height, &channels, STBI_rgb_alpha);
+        if (data == nullptr) { width = height = 0; }
+        channels = 4;
+        return ImageData(data, (size_t)width, (size_t)height, (size_t)channels, false);
+    }
+
     template<>
     ImageData ImageLoader::LoadImage(const std::filesystem::path& filepath, bool flipImage)
     {
@@ -43,12 +105,17 @@ namespace MxEngine
         MAKE_SCOPE_TIMER("MxEngine::ImageLoader", "ImageLoader::LoadImage()");
         MXLOG_INFO("MxEngine::ImageLoader", "loading image from file: " + ToMxString(filepath));
 
-        stbi_set_flip_vertically_on_load(flipImage);
-        int width, height, channels;
-        uint8_t* data = stbi_load(filepath.string().c_str(), &width, &height, &channels, STBI_rgb_alpha);
-        if (data == nullptr) { width = height = 0; }
-        channels = 4;
-        return ImageData(data, (size_t)width, (size_t)height, (size_t)channels, false);
+        // image is decoded directly from mapped file contents
+        MappedFile file(filepath);
+        if (!file.IsOpen()) return ImageData();
+
+        RawImageHeader header;
+        if (filepath.extension() == ImageConverter::RawImageExtension && !IsRawImageData(file.GetData(), file.GetSize(), header))
+        {
+            MXLOG_WARNING("MxEngine::ImageLoader", "invalid raw image file: " + ToMxString(filepath));
+            return ImageData();
+        }
+        return DecodeImage(file.GetData(), file.GetSize(), flipImage);
     }
 
     ImageData ImageLoader::LoadImageFromMemory(const uint8_t* memory, size_t byteSize, bool flipImage)
@@ -57,12 +124,7 @@ namespace MxEngine
         MAKE_SCOPE_TIMER("MxEngine::ImageLoader", "ImageLoader::LoadImage()");
         MXLOG_INFO("MxEngine::ImageLoader", "loading image from memory");
 
-        stbi_set_flip_vertically_on_load(flipImage);
-        int width, height, channels;
-        uint8_t* data = stbi_load_from_memory(memory, (int)byteSize, &width, &height, &channels, STBI_rgb_alpha);
-        if (data == nullptr) { width = height = 0; }
-        channels = 4;
-        return ImageData(data, (size_t)width, (size_t)height, (size_t)channels, false);
+        return DecodeImage(memory, byteSize, flipImage);
     }
 
     /*
@@ -81,8 +143,9 @@ namespace MxEngine
     */
     ImageLoader::ImageArray ImageLoader::CreateCubemap(const ImageData& image)
     {
+        MAKE_SCOPE_PROFILER("ImageLoader::CreateCubemap");
         ImageArray result;
-        size_t channels = 4; 
+        size_t pixelSize = image.GetPixelSize();
         size_t width = image.GetWidth() / 4; //-V112
         size_t height = image.GetHeight() / 3;
         if (width != height)
@@ -92,27 +155,204 @@ namespace MxEngine
         }
         for (auto& arr : result)
         {
-            arr.resize(height, width * channels, 0);
+            arr.resize(height, width * pixelSize);
         }
 
-        auto copySide = [&image, &width, &height, &channels](Array2D<unsigned char>& dst, size_t sliceX, size_t sliceY)
+        // face index for each slice of each horizontal band of the cross, NoFace marks empty slices
+        constexpr size_t NoFace = std::numeric_limits<size_t>::max();
+        constexpr size_t FaceSlices[3][4] = {
+            { NoFace, 2, NoFace, NoFace },
+            { 1,      4, 0,      5      },
+            { NoFace, 3, NoFace, NoFace },
+        };
+
+        // each source row is read once and split into spans of all faces it contains
+        const uint8_t* source = image.GetRawData();
+        size_t sourceRowSize = image.GetWidth() * pixelSize;
+        size_t faceRowSize = width * pixelSize;
+        ThreadPool::ParallelFor(3 * height, 64, [&](size_t begin, size_t end)
         {
-            for (size_t i = 0; i < height; i++)
+            for (size_t y = begin; y < end; y++)
             {
-                size_t y = i + sliceY * height;
-                size_t x = sliceX * width;
-                size_t bytesInRow = width * channels;
+                const uint8_t* row = source + y * sourceRowSize;
+                const auto& slices = FaceSlices[y / height];
+                size_t faceRow = y % height;
+                for (size_t slice = 0; slice < 4; slice++) //-V112
+                {
+                    if (slices[slice] != NoFace)
+                        std::memcpy(result[slices[slice]][faceRow].data(), row + slice * faceRowSize, faceRowSize);
+                }
+            }
+        });
+        return result;
+    }
 
-                std::memcpy(dst[i].data(), &image.GetRawData()[(y * image.GetWidth() + x) * channels], bytesInRow);
+    struct CubemapFaceBasis
+    {
+        Vector3 Center;
+        Vector3 Right;
+        Vector3 Down;
+    };
+
+    // face directions follow OpenGL cubemap layout, in the same order as faces returned by CreateCubemap
+    static const std::array<CubemapFaceBasis, 6> CubemapFaces = {
+        CubemapFaceBasis{ MakeVector3( 1.0f,  0.0f,  0.0f), MakeVector3( 0.0f, 0.0f, -1.0f), MakeVector3(0.0f, -1.0f,  0.0f) },
+        CubemapFaceBasis{ MakeVector3(-1.0f,  0.0f,  0.0f), MakeVector3( 0.0f, 0.0f,  1.0f), MakeVector3(0.0f, -1.0f,  0.0f) },
+        CubemapFaceBasis{ MakeVector3( 0.0f,  1.0f,  0.0f), MakeVector3( 1.0f, 0.0f,  0.0f), MakeVector3(0.0f,  0.0f,  1.0f) },
+        CubemapFaceBasis{ MakeVector3( 0.0f, -1.0f,  0.0f), MakeVector3( 1.0f, 0.0f,  0.0f), MakeVector3(0.0f,  0.0f, -1.0f) },
+        CubemapFaceBasis{ MakeVector3( 0.0f,  0.0f,  1.0f), MakeVector3( 1.0f, 0.0f,  0.0f), MakeVector3(0.0f, -1.0f,  0.0f) },
+        CubemapFaceBasis{ MakeVector3( 0.0f,  0.0f, -1.0f), MakeVector3(-1.0f, 0.0f,  0.0f), MakeVector3(0.0f, -1.0f,  0.0f) },
+    };
+
+    struct BilinearSample
+    {
+        size_t Offsets[4]; // top-left, top-right, bottom-left, bottom-right texel offsets in pixels
+        float FractionX;
+        float FractionY;
+    };
+
+    static BilinearSample GetEquirectangularSample(const Vector3& direction, size_t width, size_t height)
+    {
+        constexpr float InvTwoPi = 0.5f / 3.14159265358979f;
+        constexpr float InvPi = 1.0f / 3.14159265358979f;
+
+        // longitude wraps around horizontally, latitude is clamped at poles. First image row is +Y direction
+        float u = std::atan2(direction.z, direction.x) * InvTwoPi + 0.5f;
+        float v = 0.5f - std::atan2(direction.y, std::sqrt(direction.x * direction.x + direction.z * direction.z)) * InvPi;
+        float x = u * (float)width - 0.5f;
+        float y = v * (float)height - 0.5f;
+        float floorX = std::floor(x);
+        float floorY = std::floor(y);
+
+        auto x0 = (int64_t)floorX % (int64_t)width;
+        if (x0 < 0) x0 += (int64_t)width;
+        size_t x1 = ((size_t)x0 + 1) % width;
+        size_t y0 = (size_t)Clamp(floorY, 0.0f, float(height - 1));
+        size_t y1 = Min(y0 + 1, height - 1);
+
+        BilinearSample sample;
+        sample.Offsets[0] = y0 * width + (size_t)x0;
+        sample.Offsets[1] = y0 * width + x1;
+        sample.Offsets[2] = y1 * width + (size_t)x0;
+        sample.Offsets[3] = y1 * width + x1;
+        sample.FractionX = x - floorX;
+        sample.FractionY = floorY < 0.0f ? 0.0f : y - floorY;
+        return sample;
+    }
+
+    template<typename T>
+    static void BlendBilinear(const T* source, T* destination, const BilinearSample& sample, size_t channels)
+    {
+        #if defined(MXENGINE_IMAGE_SSE2)
+        if (channels == 4) //-V112
+        {
+            auto load = [source](size_t offset)
+            {
+                if constexpr (std::is_same_v<T, float>)
+                {
+                    return _mm_loadu_ps(source + offset * 4);
+                }
+                else
+                {
+                    int32_t packed;
+                    std::memcpy(&packed, source + offset * 4, sizeof(packed));
+                    __m128i zero = _mm_setzero_si128();
+                    __m128i words = _mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero);
+                    return _mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero));
+                }
+            };
+            __m128 tx = _mm_set1_ps(sample.FractionX);
+            __m128 ty = _mm_set1_ps(sample.FractionY);
+            __m128 t00 = load(sample.Offsets[0]), t10 = load(sample.Offsets[1]);
+            __m128 t01 = load(sample.Offsets[2]), t11 = load(sample.Offsets[3]);
+            __m128 top = _mm_add_ps(t00, _mm_mul_ps(_mm_sub_ps(t10, t00), tx));
+            __m128 bottom = _mm_add_ps(t01, _mm_mul_ps(_mm_sub_ps(t11, t01), tx));
+            __m128 result = _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), ty));
+
+            if constexpr (std::is_same_v<T, float>)
+            {
+                _mm_storeu_ps(destination, result);
             }
-        };
+            else
+            {
+                __m128i words = _mm_packs_epi32(_mm_cvtps_epi32(result), _mm_setzero_si128());
+                int32_t packed = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+                std::memcpy(destination, &packed, sizeof(packed));
+            }
+            return;
+        }
+        #endif
+
+        for (size_t c = 0; c < channels; c++)
+        {
+            float t00 = (float)source[sample.Offsets[0] * channels + c];
+            float t10 = (float)source[sample.Offsets[1] * channels + c];
+            float t01 = (float)source[sample.Offsets[2] * channels + c];
+            float t11 = (float)source[sample.Offsets[3] * channels + c];
+            float top = t00 + (t10 - t00) * sample.FractionX;
+            float bottom = t01 + (t11 - t01) * sample.FractionX;
+            float result = top + (bottom - top) * sample.FractionY;
+
+            if constexpr (std::is_same_v<T, float>)
+                destination[c] = result;
+            else
+                destination[c] = (T)Clamp(std::nearbyint(result), 0.0f, 255.0f);
+        }
+    }
+
+    template<typename T>
+    static void SampleEquirectangularFaces(const ImageData& image, ImageLoader::ImageArray& result, size_t faceSize)
+    {
+        const T* source = (const T*)image.GetRawData();
+        size_t channels = image.GetChannelCount();
+        float invFaceSize = 2.0f / (float)faceSize;
+
+        // rows of all six faces are distributed between threads together
+        ThreadPool::ParallelFor(6 * faceSize, 16, [&](size_t begin, size_t end)
+        {
+            for (size_t index = begin; index < end; index++)
+            {
+                size_t face = index / faceSize;
+                size_t y = index % faceSize;
+                const auto& basis = CubemapFaces[face];
+                T* destination = (T*)result[face][y].data();
+
+                float t = ((float)y + 0.5f) * invFaceSize - 1.0f;
+                Vector3 rowDirection = basis.Center + basis.Down * t;
+                for (size_t x = 0; x < faceSize; x++)
+                {
+                    float s = ((float)x + 0.5f) * invFaceSize - 1.0f;
+                    auto sample = GetEquirectangularSample(rowDirection + basis.Right * s, image.GetWidth(), image.GetHeight());
+                    BlendBilinear(source, destination + x * channels, sample, channels);
+                }
+            }
+        });
+    }
+
+    ImageLoader::ImageArray ImageLoader::CreateCubemapFromEquirectangular(const ImageData& image, size_t faceSize)
+    {
+        MAKE_SCOPE_PROFILER("ImageLoader::CreateCubemapFromEquirectangular");
+        if (image.IsHalfFloat())
+            return ImageLoader::CreateCubemapFromEquirectangular(ImageConverter::ConvertToFloat(image), faceSize);
+
+        ImageArray result;
+        if (image.GetWidth() == 0 || image.GetHeight() == 0)
+        {
+            MXLOG_WARNING("MxEngine::ImageLoader", "cannot create cubemap from empty image");
+            return result;
+        }
+
+        if (faceSize == 0) faceSize = Max(image.GetWidth() / 4, size_t(1)); //-V112
+        for (auto& arr : result)
+        {
+            arr.resize(faceSize, faceSize * image.GetPixelSize());
+        }
+
+        if (image.IsFloatingPoint())
+            SampleEquirectangularFaces<float>(image, result, faceSize);
+        else
+            SampleEquirectangularFaces<uint8_t>(image, result, faceSize);
 
-        copySide(result[0], 2, 1);
-        copySide(result[1], 0, 1);
-        copySide(result[2], 1, 0);
-        copySide(result[3], 1, 2);
-        copySide(result[4], 1, 1);
-        copySide(result[5], 3, 1);
         return result;
     }
 }
\ No newline at end of file
@@ -42,7 +42,8 @@ namespace MxEngine
     {
     public:
         /*!
-        loads image from disk. As OpenGL treats images differently as expected, all images are flipped automatically
+        loads image from disk. As OpenGL treats images differently as expected, all images are flipped automatically.
+        Radiance HDR images are loaded as 32-bit floating point, use ImageConverter::ConvertToHalfFloat to reduce their size
         \param filepath path to an image on disk
         \param flipImage should the image be vertically flipped. As MxEngine uses OpenGL, usually you want to do this
         \returns Image object if image file exists or nullptr data and width = height = channels = 0 if not
@@ -66,8 +67,16 @@ namespace MxEngine
         XXXX
          X
         \param image image from which cubemap will be created
-        \returns 6 2d arrays of raw image data (can be passed as individual images to OpenGL)
+        \returns 6 2d arrays of raw image data in format of source image (can be passed as individual images to OpenGL)
         */
         static ImageArray CreateCubemap(const ImageData& image);
+        /*!
+        creates cubemap projections from equirectangular (latitude-longitude) panorama using bilinear filtering.
+        First row of the image is treated as +Y direction, so image should be loaded with flipImage = false
+        \param image panorama from which cubemap will be created. Half-float images produce 32-bit floating point faces
+        \param faceSize size of each face in pixels. If 0, quarter of image width is used
+        \returns 6 2d arrays of raw image data in the same order as CreateCubemap returns
+        */
+        static ImageArray CreateCubemapFromEquirectangular(const ImageData& image, size_t faceSize = 0);
     };
 }
\ No newline at end of file
@@ -63,8 +63,10 @@ namespace MxEngine
             imageByteData = ImageConverter::ConvertImageJPG(image);
             break;
         case ImageType::HDR:
-            // TODO: support HDR images
-            MXLOG_WARNING("MxEngine::ImageManager", "HDR texture format is not supported through ImageManager, use ImageConverter::ConvertImageHDR");
+            imageByteData = ImageConverter::ConvertImageHDR(image);
+            break;
+        case ImageType::RAW:
+            imageByteData = ImageConverter::ConvertImageRAW(image);
             break;
         }
         file.WriteBytes(imageByteData.data(), imageByteData.size());
@@ -240,7 +242,7 @@ namespace MxEngine
             MX_ASSERT(images[i - 1].GetWidth()    == images[i].GetWidth());
             MX_ASSERT(images[i - 1].GetHeight()   == images[i].GetHeight());
             MX_ASSERT(images[i - 1].GetPixelSize() == images[i].GetPixelSize());
-            MX_ASSERT(images[i - 1].IsFloatingPoint() == images[i].IsFloatingPoint());
+            MX_ASSERT(images[i - 1].GetFormat() == images[i].GetFormat());
         }
         #endif
         MX_ASSERT(images.size() > 1);
@@ -248,7 +250,8 @@ namespace MxEngine
         size_t width = images[0].GetWidth();
         size_t height = images[0].GetHeight();
         size_t pixelSize = images[0].GetPixelSize();
-        bool isFloatingPoint = images[0].IsFloatingPoint();
+        size_t channels = images[0].GetChannelCount();
+        ImageFormat format = images[0].GetFormat();
 
         auto result = (uint8_t*)std::malloc(width * height * pixelSize * images.size());
         MX_ASSERT(result != nullptr);
@@ -270,7 +273,7 @@ namespace MxEngine
                 }
             }
         }
-        return ImageData(result, width * imagesPerRaw, height * imagesPerColumn, pixelSize, isFloatingPoint);
+        return ImageData(result, width * imagesPerRaw, height * imagesPerColumn, channels, format);
     }
 
     ImageData ImageManager::CombineImages(Array2D<ImageData>& images)
@@ -42,6 +42,7 @@ namespace MxEngine
         TGA,
         JPG,
         HDR,
+        RAW,
     };
 
     class ImageManager
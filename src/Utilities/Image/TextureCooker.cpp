@@ -0,0 +1,535 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "TextureCooker.h"
+#include "ImageLoader.h"
+#include "ImageConverter.h"
+#include "Utilities/FileSystem/MappedFile.h"
+#include "Utilities/FileSystem/VirtualFileSystem.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+#include "Core/Macro/Macro.h"
+
+#define STB_DXT_IMPLEMENTATION
+#include <stb_dxt.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace MxEngine
+{
+    struct CookedTextureHeader
+    {
+        std::array<char, 4> Magic;
+        uint32_t Width;
+        uint32_t Height;
+        uint32_t MipCount;
+        uint8_t Usage;
+        uint8_t Compression;
+        uint8_t Channels;
+        uint8_t Padding;
+    };
+
+    constexpr std::array<char, 4> CookedTextureMagic = { 'M', 'X', 'T', 'X' };
+    constexpr size_t MaxMipCount = 32;
+
+    struct SRGBTables
+    {
+        std::array<float, 256> ToLinear;
+        std::array<uint8_t, 4096> ToSRGB;
+    };
+
+    static const SRGBTables& GetSRGBTables()
+    {
+        static const SRGBTables tables = []()
+        {
+            SRGBTables result;
+            for (size_t i = 0; i < result.ToLinear.size(); i++)
+            {
+                float c = float(i) / 255.0f;
+                result.ToLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            for (size_t i = 0; i < result.ToSRGB.size(); i++)
+            {
+                float c = float(i) / float(result.ToSRGB.size() - 1);
+                float s = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+                result.ToSRGB[i] = (uint8_t)std::min(s * 255.0f + 0.5f, 255.0f);
+            }
+            return result;
+        }();
+        return tables;
+    }
+
+    static ImageData DownsampleImage(const ImageData& source, bool isSRGB)
+    {
+        size_t sourceWidth = source.GetWidth();
+        size_t sourceHeight = source.GetHeight();
+        size_t width = std::max(sourceWidth / 2, size_t(1));
+        size_t height = std::max(sourceHeight / 2, size_t(1));
+        size_t channels = source.GetChannelCount();
+
+        auto data = (uint8_t*)std::malloc(width * height * source.GetPixelSize());
+        ImageData result(data, width, height, channels, source.GetFormat());
+
+        // only color channels are gamma-encoded, alpha and single channel images are linear
+        size_t srgbChannels = (isSRGB && channels >= 3) ? 3 : 0;
+        const auto& tables = GetSRGBTables();
+
+        for (size_t y = 0; y < height; y++)
+        {
+            size_t y0 = std::min(2 * y, sourceHeight - 1);
+            size_t y1 = std::min(2 * y + 1, sourceHeight - 1);
+            for (size_t x = 0; x < width; x++)
+            {
+                size_t x0 = std::min(2 * x, sourceWidth - 1);
+                size_t x1 = std::min(2 * x + 1, sourceWidth - 1);
+                std::array<size_t, 4> samples = {
+                    (y0 * sourceWidth + x0) * channels,
+                    (y0 * sourceWidth + x1) * channels,
+                    (y1 * sourceWidth + x0) * channels,
+                    (y1 * sourceWidth + x1) * channels,
+                };
+                size_t target = (y * width + x) * channels;
+
+                for (size_t c = 0; c < channels; c++)
+                {
+                    if (source.IsFloatingPoint())
+                    {
+                        auto src = (const float*)source.GetRawData();
+                        auto dst = (float*)result.GetRawData();
+                        dst[target + c] = 0.25f * (src[samples[0] + c] + src[samples[1] + c] + src[samples[2] + c] + src[samples[3] + c]);
+                    }
+                    else if (c < srgbChannels)
+                    {
+                        auto src = source.GetRawData();
+                        float linear = 0.25f * (tables.ToLinear[src[samples[0] + c]] + tables.ToLinear[src[samples[1] + c]] +
+                                                tables.ToLinear[src[samples[2] + c]] + tables.ToLinear[src[samples[3] + c]]);
+                        result.GetRawData()[target + c] = tables.ToSRGB[size_t(linear * float(tables.ToSRGB.size() - 1) + 0.5f)];
+                    }
+                    else
+                    {
+                        auto src = source.GetRawData();
+                        size_t sum = (size_t)src[samples[0] + c] + src[samples[1] + c] + src[samples[2] + c] + src[samples[3] + c];
+                        result.GetRawData()[target + c] = uint8_t((sum + 2) / 4);
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    static std::array<uint8_t, 4> FetchPixel(const ImageData& image, size_t x, size_t y)
+    {
+        x = std::min(x, image.GetWidth() - 1);
+        y = std::min(y, image.GetHeight() - 1);
+        auto pixel = image.GetRawData() + (y * image.GetWidth() + x) * image.GetChannelCount();
+        switch (image.GetChannelCount())
+        {
+        case 1:
+            return { pixel[0], pixel[0], pixel[0], 255 };
+        case 2:
+            return { pixel[0], pixel[1], 0, 255 };
+        case 3:
+            return { pixel[0], pixel[1], pixel[2], 255 };
+        default:
+            return { pixel[0], pixel[1], pixel[2], pixel[3] };
+        }
+    }
+
+    static size_t GetBlockSize(TextureCompression compression)
+    {
+        switch (compression)
+        {
+        case TextureCompression::BC1:
+        case TextureCompression::BC4:
+            return 8;
+        case TextureCompression::BC3:
+        case TextureCompression::BC5:
+            return 16;
+        default:
+            return 0;
+        }
+    }
+
+    static size_t GetCompressedChannelCount(TextureCompression compression, size_t imageChannels)
+    {
+        switch (compression)
+        {
+        case TextureCompression::BC1:
+            return 3;
+        case TextureCompression::BC3:
+            return 4;
+        case TextureCompression::BC4:
+            return 1;
+        case TextureCompression::BC5:
+            return 2;
+        default:
+            return imageChannels;
+        }
+    }
+
+    static void CompressBlock(const ImageData& image, size_t blockX, size_t blockY, TextureCompression compression, uint8_t* destination)
+    {
+        std::array<uint8_t, 16 * 4> rgba;
+        std::array<uint8_t, 16 * 2> rg;
+        std::array<uint8_t, 16> r;
+        for (size_t i = 0; i < 16; i++)
+        {
+            auto pixel = FetchPixel(image, blockX * 4 + i % 4, blockY * 4 + i / 4);
+            std::memcpy(&rgba[i * 4], pixel.data(), 4);
+            rg[i * 2 + 0] = pixel[0];
+            rg[i * 2 + 1] = pixel[1];
+            r[i] = pixel[0];
+        }
+
+        switch (compression)
+        {
+        case TextureCompression::BC1:
+            stb_compress_dxt_block(destination, rgba.data(), 0, STB_DXT_HIGHQUAL);
+            break;
+        case TextureCompression::BC3:
+            stb_compress_dxt_block(destination, rgba.data(), 1, STB_DXT_HIGHQUAL);
+            break;
+        case TextureCompression::BC4:
+            stb_compress_bc4_block(destination, r.data());
+            break;
+        case TextureCompression::BC5:
+            stb_compress_bc5_block(destination, rg.data());
+            break;
+        default:
+            MX_ASSERT(false); // compression format is not block-based
+            break;
+        }
+    }
+
+    MxVector<ImageData> TextureCooker::GenerateMipmaps(const ImageData& image, bool isSRGB)
+    {
+        MAKE_SCOPE_PROFILER("TextureCooker::GenerateMipmaps");
+        MxVector<ImageData> mips;
+        if (image.GetRawData() == nullptr) return mips;
+
+        if (image.IsHalfFloat())
+        {
+            // half floats are filtered at full precision and converted back level by level
+            mips = TextureCooker::GenerateMipmaps(ImageConverter::ConvertToFloat(image), isSRGB);
+            for (auto& mip : mips)
+                mip = ImageConverter::ConvertToHalfFloat(mip);
+            return mips;
+        }
+
+        while (true)
+        {
+            const ImageData& previous = mips.empty() ? image : mips.back();
+            if (previous.GetWidth() <= 1 && previous.GetHeight() <= 1) break;
+
+            auto next = DownsampleImage(previous, isSRGB);
+            mips.push_back(std::move(next));
+        }
+        return mips;
+    }
+
+    size_t TextureCooker::GetUsedChannelCount(const ImageData& image)
+    {
+        size_t channels = image.GetChannelCount();
+        if (image.GetFormat() != ImageFormat::BYTE || channels < 2) return channels;
+
+        // images are usually decoded as RGBA, even if source file stores a single channel
+        bool isGrayscale = channels >= 3;
+        bool isBlueUnused = channels >= 3;
+        bool isOpaque = true;
+        size_t pixelCount = image.GetWidth() * image.GetHeight();
+        auto data = image.GetRawData();
+        for (size_t i = 0; i < pixelCount && (isGrayscale || isBlueUnused || isOpaque); i++)
+        {
+            auto pixel = data + i * channels;
+            if (channels >= 3)
+            {
+                isGrayscale &= pixel[0] == pixel[1] && pixel[0] == pixel[2];
+                isBlueUnused &= pixel[2] == 0;
+            }
+            if (channels == 4)
+                isOpaque &= pixel[3] == 255;
+        }
+
+        if (!isOpaque) return 4;
+        if (isGrayscale) return 1;
+        if (isBlueUnused) return 2;
+        return std::min(channels, size_t(3));
+    }
+
+    TextureCompression TextureCooker::SelectCompression(const ImageData& image, TextureUsage usage)
+    {
+        if (image.GetFormat() != ImageFormat::BYTE) return TextureCompression::NONE;
+
+        switch (usage)
+        {
+        case TextureUsage::NORMAL:
+            return TextureCompression::BC5;
+        case TextureUsage::MASK:
+        {
+            // only channels which carry data are stored, so single channel masks decoded as RGBA take 8 times less space
+            switch (TextureCooker::GetUsedChannelCount(image))
+            {
+            case 1:
+                return TextureCompression::BC4;
+            case 2:
+                return TextureCompression::BC5;
+            case 3:
+                return TextureCompression::BC1;
+            default:
+                return TextureCompression::BC3;
+            }
+        }
+        default:
+            return TextureCooker::GetUsedChannelCount(image) == 4 ? TextureCompression::BC3 : TextureCompression::BC1;
+        }
+    }
+
+    CookedTexture::MipData TextureCooker::CompressImage(const ImageData& image, TextureCompression compression)
+    {
+        MAKE_SCOPE_PROFILER("TextureCooker::CompressImage");
+        CookedTexture::MipData result;
+
+        if (compression == TextureCompression::NONE)
+        {
+            result.resize(image.GetTotalByteSize());
+            if (!result.empty()) std::memcpy(result.data(), image.GetRawData(), result.size());
+            return result;
+        }
+
+        MX_ASSERT(image.GetFormat() == ImageFormat::BYTE);
+        size_t blocksX = (image.GetWidth() + 3) / 4;
+        size_t blocksY = (image.GetHeight() + 3) / 4;
+        size_t blockSize = GetBlockSize(compression);
+        result.resize(blocksX * blocksY * blockSize);
+
+        // block rows are independent, so large images are encoded in parallel
+        size_t rowsPerTask = std::max(size_t(256) / std::max(blocksX, size_t(1)), size_t(1));
+        ThreadPool::ParallelFor(blocksY, rowsPerTask, [&](size_t begin, size_t end)
+        {
+            for (size_t blockY = begin; blockY < end; blockY++)
+            {
+                for (size_t blockX = 0; blockX < blocksX; blockX++)
+                {
+                    CompressBlock(image, blockX, blockY, compression, result.data() + (blockY * blocksX + blockX) * blockSize);
+                }
+            }
+        });
+        return result;
+    }
+
+    CookedTexture TextureCooker::Cook(const ImageData& image, TextureUsage usage)
+    {
+        MAKE_SCOPE_PROFILER("TextureCooker::Cook");
+        MAKE_SCOPE_TIMER("MxEngine::TextureCooker", "TextureCooker::Cook()");
+
+        CookedTexture texture;
+        texture.Usage = usage;
+        texture.Compression = TextureCooker::SelectCompression(image, usage);
+        texture.Width = image.GetWidth();
+        texture.Height = image.GetHeight();
+        texture.Channels = GetCompressedChannelCount(texture.Compression, image.GetChannelCount());
+        if (image.GetRawData() == nullptr) return texture;
+
+        // BC4 stores only first channel, so mips of single channel masks decoded as RGBA are generated for that channel only
+        ImageData singleChannel;
+        if (texture.Compression == TextureCompression::BC4 && image.GetChannelCount() != 1)
+            singleChannel = ImageConverter::ExtractChannel(image, 0);
+        const ImageData& source = singleChannel.GetRawData() != nullptr ? singleChannel : image;
+
+        auto mips = TextureCooker::GenerateMipmaps(source, usage == TextureUsage::COLOR);
+        texture.Mips.reserve(mips.size() + 1);
+        texture.Mips.push_back(TextureCooker::CompressImage(source, texture.Compression));
+        for (const auto& mip : mips)
+        {
+            texture.Mips.push_back(TextureCooker::CompressImage(mip, texture.Compression));
+        }
+        return texture;
+    }
+
+    FilePath TextureCooker::GetCookedPath(const FilePath& texturePath)
+    {
+        FilePath cookedPath = texturePath;
+        cookedPath += CookedTextureExtension;
+        return cookedPath;
+    }
+
+    static bool ReadUpToDateCache(const FilePath& texturePath, const FilePath& cookedPath, TextureUsage usage, CookedTexture& texture)
+    {
+        // source image may be absent if only cooked textures are shipped. Packed files have no timestamps,
+        // so packed cache is considered outdated only if source image exists as loose file
+        bool isCacheUpToDate = VirtualFileSystem::Exists(cookedPath);
+        if (isCacheUpToDate && File::IsFile(texturePath))
+            isCacheUpToDate = File::IsFile(cookedPath) && File::LastModifiedTime(cookedPath) >= File::LastModifiedTime(texturePath);
+        return isCacheUpToDate && TextureCooker::ReadCooked(cookedPath, texture) && texture.Usage == usage;
+    }
+
+    CookedTexture TextureCooker::LoadCooked(const FilePath& texturePath, TextureUsage usage)
+    {
+        auto cookedPath = TextureCooker::GetCookedPath(texturePath);
+        CookedTexture texture;
+        if (ReadUpToDateCache(texturePath, cookedPath, usage, texture))
+            return texture;
+
+        MXLOG_INFO("MxEngine::TextureCooker", "cooking texture: " + ToMxString(texturePath));
+        auto image = ImageLoader::LoadImage(texturePath);
+        if (image.GetRawData() == nullptr)
+        {
+            MXLOG_WARNING("MxEngine::TextureCooker", "cannot load texture: " + ToMxString(texturePath));
+            return CookedTexture{ };
+        }
+
+        texture = TextureCooker::Cook(image, usage);
+        TextureCooker::SaveCooked(cookedPath, texture);
+        return texture;
+    }
+
+    CookedTexture TextureCooker::LoadCooked(const FilePath& texturePath, const ImageData& image, TextureUsage usage)
+    {
+        auto cookedPath = TextureCooker::GetCookedPath(texturePath);
+        CookedTexture texture;
+        if (ReadUpToDateCache(texturePath, cookedPath, usage, texture))
+            return texture;
+
+        MXLOG_INFO("MxEngine::TextureCooker", "cooking texture from memory: " + ToMxString(texturePath));
+        texture = TextureCooker::Cook(image, usage);
+        TextureCooker::SaveCooked(cookedPath, texture);
+        return texture;
+    }
+
+    std::future<CookedTexture> TextureCooker::LoadCookedAsync(const FilePath& texturePath, TextureUsage usage)
+    {
+        return ThreadPool::SubmitBackground([texturePath, usage]() { return TextureCooker::LoadCooked(texturePath, usage); });
+    }
+
+    bool TextureCooker::SaveCooked(const FilePath& path, const CookedTexture& texture)
+    {
+        MAKE_SCOPE_PROFILER("TextureCooker::SaveCooked");
+
+        CookedTextureHeader header;
+        header.Magic = CookedTextureMagic;
+        header.Width = (uint32_t)texture.Width;
+        header.Height = (uint32_t)texture.Height;
+        header.MipCount = (uint32_t)texture.Mips.size();
+        header.Usage = (uint8_t)texture.Usage;
+        header.Compression = (uint8_t)texture.Compression;
+        header.Channels = (uint8_t)texture.Channels;
+        header.Padding = 0;
+
+        // same texture may be cooked by several threads, so cache is written to temporary file and then replaced
+        auto temporaryPath = path;
+        temporaryPath += ToFilePath(MxFormat(".{}.tmp", std::hash<std::thread::id>{ }(std::this_thread::get_id())));
+        {
+            File file(temporaryPath, File::WRITE | File::BINARY);
+            if (!file.IsOpen())
+            {
+                MXLOG_WARNING("MxEngine::TextureCooker", "cannot write cooked texture: " + ToMxString(path));
+                return false;
+            }
+
+            file.WriteBytes((const uint8_t*)&header, sizeof(CookedTextureHeader));
+            for (const auto& mip : texture.Mips)
+            {
+                uint64_t byteSize = (uint64_t)mip.size();
+                file.WriteBytes((const uint8_t*)&byteSize, sizeof(byteSize));
+                file.WriteBytes(mip.data(), mip.size());
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error)
+        {
+            MXLOG_WARNING("MxEngine::TextureCooker", "cannot write cooked texture: " + ToMxString(path) + ": " + ToMxString(error.message()));
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+        return true;
+    }
+
+    bool TextureCooker::ReadCooked(const FilePath& path, CookedTexture& texture)
+    {
+        MAKE_SCOPE_PROFILER("TextureCooker::ReadCooked");
+
+        // mips are copied directly from mapped file, no intermediate stream buffers are involved
+        MappedFile file(path);
+        if (!file.IsOpen()) return false;
+
+        CookedTextureHeader header;
+        auto headerBytes = file.GetBytes(0, sizeof(CookedTextureHeader));
+        if (headerBytes.data() != nullptr)
+            std::memcpy(&header, headerBytes.data(), sizeof(CookedTextureHeader));
+
+        if (headerBytes.data() == nullptr || header.Magic != CookedTextureMagic || header.MipCount > MaxMipCount)
+        {
+            MXLOG_WARNING("MxEngine::TextureCooker", "invalid cooked texture file: " + ToMxString(path));
+            return false;
+        }
+
+        texture.Usage = (TextureUsage)header.Usage;
+        texture.Compression = (TextureCompression)header.Compression;
+        texture.Width = (size_t)header.Width;
+        texture.Height = (size_t)header.Height;
+        texture.Channels = (size_t)header.Channels;
+        texture.Mips.resize(header.MipCount);
+
+        size_t offset = sizeof(CookedTextureHeader);
+        for (auto& mip : texture.Mips)
+        {
+            uint64_t byteSize = 0;
+            auto sizeBytes = file.GetBytes(offset, sizeof(byteSize));
+            if (sizeBytes.data() == nullptr)
+            {
+                MXLOG_WARNING("MxEngine::TextureCooker", "cooked texture file is truncated: " + ToMxString(path));
+                return false;
+            }
+            std::memcpy(&byteSize, sizeBytes.data(), sizeof(byteSize));
+            offset += sizeof(byteSize);
+
+            if (byteSize > (uint64_t)header.Width * header.Height * 4 * sizeof(float))
+            {
+                MXLOG_WARNING("MxEngine::TextureCooker", "invalid cooked texture file: " + ToMxString(path));
+                return false;
+            }
+
+            auto mipBytes = file.GetBytes(offset, (size_t)byteSize);
+            if (mipBytes.data() == nullptr)
+            {
+                MXLOG_WARNING("MxEngine::TextureCooker", "cooked texture file is truncated: " + ToMxString(path));
+                return false;
+            }
+            mip.assign(mipBytes.begin(), mipBytes.end());
+            offset += (size_t)byteSize;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,163 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include <future>
+
+#include "Utilities/STL/MxVector.h"
+#include "Utilities/FileSystem/File.h"
+#include "Image.h"
+
+namespace MxEngine
+{
+    enum class TextureCompression : uint8_t
+    {
+        NONE,
+        BC1,
+        BC3,
+        BC4,
+        BC5,
+    };
+
+    enum class TextureUsage : uint8_t
+    {
+        COLOR,  // sRGB color data, compressed to BC1 or BC3 if alpha is used
+        NORMAL, // tangent-space normals, only XY are stored in BC5
+        MASK,   // data such as roughness, metallic or ambient occlusion, compressed to BC4 or BC5 depending on channels used
+    };
+
+    /*!
+    cooked texture is a full mip chain of block-compressed image data, ready to be uploaded to GPU
+    */
+    struct CookedTexture
+    {
+        using MipData = MxVector<uint8_t>;
+
+        TextureUsage Usage = TextureUsage::COLOR;
+        TextureCompression Compression = TextureCompression::NONE;
+        size_t Width = 0;
+        size_t Height = 0;
+        size_t Channels = 0;
+        /*!
+        mip levels starting from the largest one. Uncompressed levels are stored as raw pixels of Channels bytes each
+        */
+        MxVector<MipData> Mips;
+    };
+
+    /*!
+    texture cooker converts images into GPU-friendly representation: generates mip chain and compresses each level into blocks.
+    Results are cached on disk next to source image, so expensive encoding is done only once per texture
+    */
+    class TextureCooker
+    {
+    public:
+        static constexpr const char* CookedTextureExtension = ".mxtexture";
+
+        /*!
+        generates mip chain down to 1x1 level using box filter. Color images are filtered in linear space
+        \param image source image (mip 0)
+        \param isSRGB should 8-bit RGB channels be treated as sRGB encoded
+        \returns mip levels starting from mip 1
+        */
+        static MxVector<ImageData> GenerateMipmaps(const ImageData& image, bool isSRGB);
+        /*!
+        counts channels which carry data. Grayscale images stored as RGB(A) use one channel, images with zero blue channel use two.
+        Alpha is counted only if some pixel is not fully opaque
+        \param image 8-bit image to analyze
+        \returns number of used channels from 1 to 4, or channel count of image if it is not 8-bit
+        */
+        static size_t GetUsedChannelCount(const ImageData& image);
+        /*!
+        chooses block compression format for image. Masks are compressed by number of used channels: BC4 for one, BC5 for two,
+        BC1 or BC3 for three or four
+        \param image image to compress
+        \param usage how image is sampled in shaders
+        \returns compression format, NONE if image cannot be compressed (i.e. floating point images)
+        */
+        static TextureCompression SelectCompression(const ImageData& image, TextureUsage usage);
+        /*!
+        encodes image into 4x4 blocks. Edge blocks of images which sizes are not multiple of 4 are padded by clamping
+        \param image 8-bit image to compress
+        \param compression block format
+        \returns compressed blocks in row-major order. BC4 encodes first channel of image, BC5 encodes first two channels
+        */
+        static CookedTexture::MipData CompressImage(const ImageData& image, TextureCompression compression);
+        /*!
+        generates mip chain and compresses all its levels
+        \param image source image
+        \param usage how image is sampled in shaders
+        \returns cooked texture
+        */
+        static CookedTexture Cook(const ImageData& image, TextureUsage usage);
+
+        /*!
+        returns path to cooked version of texture
+        \param texturePath path to source image
+        */
+        static FilePath GetCookedPath(const FilePath& texturePath);
+        /*!
+        loads cooked texture from cache. If cache is missing or outdated, image is loaded, cooked and cache is updated
+        \param texturePath path to source image
+        \param usage how image is sampled in shaders
+        \returns cooked texture, or texture without mips if source image cannot be loaded
+        */
+        static CookedTexture LoadCooked(const FilePath& texturePath, TextureUsage usage);
+        /*!
+        loads cooked texture from cache. If cache is missing or outdated, already decoded image is cooked and cache is updated.
+        Used for textures which ObjectLoader hands over in memory (see ObjectInfo::textures), so source file is never read
+        \param texturePath path to source image, used to locate cache
+        \param image decoded source image
+        \param usage how image is sampled in shaders
+        \returns cooked texture
+        */
+        static CookedTexture LoadCooked(const FilePath& texturePath, const ImageData& image, TextureUsage usage);
+        /*!
+        schedules LoadCooked as background task on the thread pool (see ThreadPool::SubmitBackground)
+        \param texturePath path to source image
+        \param usage how image is sampled in shaders
+        \returns future which becomes ready when texture is cooked
+        */
+        static std::future<CookedTexture> LoadCookedAsync(const FilePath& texturePath, TextureUsage usage);
+        /*!
+        writes cooked texture into file
+        \param path path to cooked file
+        \param texture texture to save
+        \returns true on success, false otherwise
+        */
+        static bool SaveCooked(const FilePath& path, const CookedTexture& texture);
+        /*!
+        reads cooked texture from file
+        \param path path to cooked file
+        \param texture texture to read into
+        \returns true on success, false if file is missing or invalid
+        */
+        static bool ReadCooked(const FilePath& path, CookedTexture& texture);
+    };
+}
@@ -36,6 +36,13 @@ namespace MxEngine
         return JsonFile::parse(file.ReadAllText().c_str());
     }
 
+    JsonFile LoadJson(const MappedFile& file)
+    {
+        // parsed directly from file contents, without copying them into string
+        auto text = (const char*)file.GetData();
+        return JsonFile::parse(text, text + file.GetSize());
+    }
+
     void SaveJson(File& file, const JsonFile& json)
     {
         file << std::setw(2) << json;
@@ -1,6 +1,7 @@
 
 #include <nlohmann/json.hpp>
 #include "Utilities/FileSystem/File.h"
+#include "Utilities/FileSystem/MappedFile.h"
 #include "Utilities/Math/Math.h"
 
 namespace MxEngine
@@ -9,6 +10,8 @@ namespace MxEngine
 
     JsonFile LoadJson(File& file);
 
+    JsonFile LoadJson(const MappedFile& file);
+
     void SaveJson(File& file, const JsonFile& json);
 }
 
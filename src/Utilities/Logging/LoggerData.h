@@ -1,6 +1,7 @@
 #pragma once
 
 #include <fstream>
+#include <mutex>
 
 #include "LogSettings.h"
 #include "Platform.h"
@@ -10,6 +11,8 @@ namespace MxEngine
     struct LoggerData
     {
         std::ofstream LogFile;
+        // guards console and file output, as messages may be logged from worker threads
+        std::mutex Mutex;
 
         VerbosityLevel Verbosity = VerbosityLevel::ALL;
         bool AbortOnFatal = true;
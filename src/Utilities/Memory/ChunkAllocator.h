@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <cstdlib>
 
 namespace MxEngine
 {
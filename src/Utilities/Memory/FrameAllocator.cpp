@@ -0,0 +1,186 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "FrameAllocator.h"
+#include "ChunkAllocator.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+
+#include <algorithm>
+
+namespace MxEngine
+{
+    void FrameArena::Release()
+    {
+        for (uint8_t* chunk : this->overflowChunks)
+        {
+            ChunkAllocator::Free(chunk);
+        }
+        this->overflowChunks.clear();
+        this->overflowBytes = 0;
+
+        if (this->allocator.GetBase() != nullptr)
+            ChunkAllocator::Free(this->allocator.GetBase());
+        this->allocator.Init(nullptr, 0);
+    }
+
+    FrameArena::~FrameArena()
+    {
+        this->Release();
+    }
+
+    void FrameArena::Init(size_t bytes)
+    {
+        this->Release();
+        size_t chunkCount = (bytes + ChunkAllocator::ChunkSize - 1) / ChunkAllocator::ChunkSize;
+        if (chunkCount == 0) return;
+
+        uint8_t* data = ChunkAllocator::RawAlloc(chunkCount);
+        MX_ASSERT(data != nullptr);
+        this->allocator.Init(data, chunkCount * ChunkAllocator::ChunkSize);
+    }
+
+    bool FrameArena::Reset()
+    {
+        size_t usedBytes = this->GetUsedBytes();
+        this->highWaterMark = std::max(this->highWaterMark, usedBytes);
+
+        bool isGrown = !this->overflowChunks.empty();
+        if (isGrown)
+        {
+            // arena is grown with some reserve, so it is not reallocated each time usage increases slightly
+            this->Init(usedBytes + usedBytes / 2);
+        }
+        this->allocator.Reset();
+        return isGrown;
+    }
+
+    uint8_t* FrameArena::RawAlloc(size_t bytes, size_t align)
+    {
+        uint8_t* ptr = this->allocator.TryRawAlloc(bytes, align);
+        if (ptr != nullptr) return ptr;
+
+        // arena is exhausted, so memory is taken from heap until the next reset
+        size_t paddedBytes = bytes + align - 1;
+        uint8_t* chunk = ChunkAllocator::RawAlloc((paddedBytes + ChunkAllocator::ChunkSize - 1) / ChunkAllocator::ChunkSize);
+        MX_ASSERT(chunk != nullptr);
+        this->overflowChunks.push_back(chunk);
+        this->overflowBytes += paddedBytes;
+
+        uintptr_t mask = align - 1;
+        return reinterpret_cast<uint8_t*>((reinterpret_cast<uintptr_t>(chunk) + mask) & ~mask);
+    }
+
+    size_t FrameArena::GetUsedBytes() const
+    {
+        return this->allocator.GetUsedBytes() + this->overflowBytes;
+    }
+
+    size_t FrameArena::GetCapacity() const
+    {
+        return this->allocator.GetSize();
+    }
+
+    size_t FrameArena::GetHighWaterMark() const
+    {
+        return std::max(this->highWaterMark, this->GetUsedBytes());
+    }
+
+    void FrameAllocator::Init(size_t bytesPerFrame)
+    {
+        impl = MxEngine::Alloc<FrameAllocatorImpl>();
+        for (auto& arena : impl->arenas)
+        {
+            arena.Init(bytesPerFrame);
+        }
+    }
+
+    void FrameAllocator::Destroy()
+    {
+        if (impl == nullptr) return;
+        Free(impl);
+        impl = nullptr;
+    }
+
+    void FrameAllocator::OnFrameBegin()
+    {
+        std::lock_guard<std::mutex> lock(impl->mutex);
+        impl->lastFrameUsedBytes = impl->arenas[impl->currentArena].GetUsedBytes();
+        impl->currentArena = (impl->currentArena + 1) % impl->arenas.size();
+
+        auto& arena = impl->arenas[impl->currentArena];
+        if (arena.Reset())
+        {
+            MXLOG_DEBUG("MxEngine::FrameAllocator", MxFormat("frame arena was exhausted and has grown to {0} bytes", arena.GetCapacity()));
+        }
+    }
+
+    uint8_t* FrameAllocator::RawAlloc(size_t bytes, size_t align)
+    {
+        std::lock_guard<std::mutex> lock(impl->mutex);
+        return impl->arenas[impl->currentArena].RawAlloc(bytes, align);
+    }
+
+    size_t FrameAllocator::GetUsedBytes()
+    {
+        std::lock_guard<std::mutex> lock(impl->mutex);
+        return impl->arenas[impl->currentArena].GetUsedBytes();
+    }
+
+    size_t FrameAllocator::GetLastFrameUsedBytes()
+    {
+        return impl->lastFrameUsedBytes;
+    }
+
+    size_t FrameAllocator::GetHighWaterMark()
+    {
+        std::lock_guard<std::mutex> lock(impl->mutex);
+        size_t result = 0;
+        for (const auto& arena : impl->arenas)
+        {
+            result = std::max(result, arena.GetHighWaterMark());
+        }
+        return result;
+    }
+
+    size_t FrameAllocator::GetCapacity()
+    {
+        return impl->arenas[impl->currentArena].GetCapacity();
+    }
+
+    FrameAllocatorImpl* FrameAllocator::GetImpl()
+    {
+        return impl;
+    }
+
+    void FrameAllocator::Clone(FrameAllocatorImpl* other)
+    {
+        impl = other;
+    }
+}
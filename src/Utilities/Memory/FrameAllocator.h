@@ -0,0 +1,168 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <cstddef>
+
+#include "Utilities/Memory/LinearAllocator.h"
+#include "Utilities/Memory/Memory.h"
+#include "Utilities/STL/MxVector.h"
+
+namespace MxEngine
+{
+    /*!
+    growable linear arena built on top of LinearAllocator. Allocations which do not fit into arena memory chunk are served
+    by separate heap chunks, which are released on Reset(). On reset arena memory chunk grows to fit all bytes used since the previous reset,
+    so after a few frames all allocations are served by a single bump of a pointer
+    */
+    class FrameArena
+    {
+        LinearAllocator allocator;
+        MxVector<uint8_t*> overflowChunks;
+        size_t overflowBytes = 0;
+        size_t highWaterMark = 0;
+
+        void Release();
+    public:
+        FrameArena() = default;
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+        ~FrameArena();
+
+        void Init(size_t bytes);
+        /*!
+        marks all memory of arena as free. Destructors of allocated objects are NOT called
+        \returns true if arena memory chunk was grown because previous allocations did not fit into it
+        */
+        bool Reset();
+        [[nodiscard]] uint8_t* RawAlloc(size_t bytes, size_t align);
+        size_t GetUsedBytes() const;
+        size_t GetCapacity() const;
+        size_t GetHighWaterMark() const;
+    };
+
+    /*!
+    EASTL-compatible allocator which takes memory from the current frame arena of FrameAllocator.
+    Deallocation is no-op, as arena memory is freed all at once
+    */
+    class FrameAllocatorAdapter
+    {
+    public:
+        FrameAllocatorAdapter(const char* name = nullptr) { }
+        FrameAllocatorAdapter(const FrameAllocatorAdapter& other, const char* name) { }
+
+        void* allocate(size_t bytes, int flags = 0);
+        void* allocate(size_t bytes, size_t alignment, size_t offset, int flags = 0);
+        void deallocate(void* ptr, size_t bytes) { }
+
+        const char* get_name() const { return "MxEngine::FrameAllocator"; }
+        void set_name(const char* name) { }
+
+        bool operator==(const FrameAllocatorAdapter& other) const { return true; }
+        bool operator!=(const FrameAllocatorAdapter& other) const { return false; }
+    };
+
+    /*!
+    vector which stores its elements in frame arena. Its memory stays valid until the end of the next frame,
+    so such vectors must be recycled (see FrameAllocator::Recycle) at least once per frame
+    */
+    template<typename T>
+    using FrameVector = MxVector<T, FrameAllocatorAdapter>;
+
+    struct FrameAllocatorImpl
+    {
+        // arenas are double-buffered: memory allocated during frame N is valid until the beginning of frame N + 2
+        std::array<FrameArena, 2> arenas;
+        std::mutex mutex;
+        size_t currentArena = 0;
+        size_t lastFrameUsedBytes = 0;
+    };
+
+    /*!
+    frame allocator provides memory for transient per-frame data (render lists, collision pairs, debug geometry).
+    All allocations are freed at once when the frame after the next one begins
+    */
+    class FrameAllocator
+    {
+        inline static FrameAllocatorImpl* impl = nullptr;
+    public:
+        constexpr static size_t DefaultArenaSize = 4 * MB;
+
+        static void Init(size_t bytesPerFrame = DefaultArenaSize);
+        static void Destroy();
+        /*!
+        swaps frame arenas and resets the one which was used during the previous-to-last frame
+        */
+        static void OnFrameBegin();
+        [[nodiscard]] static uint8_t* RawAlloc(size_t bytes, size_t align = alignof(std::max_align_t));
+        static size_t GetUsedBytes();
+        static size_t GetLastFrameUsedBytes();
+        static size_t GetHighWaterMark();
+        static size_t GetCapacity();
+
+        /*!
+        constructs object of type T in frame memory. Object destructor is never called
+        \param args arguments for object construction
+        \returns pointer to object, valid until the end of the next frame
+        */
+        template<typename T, typename... Args>
+        [[nodiscard]] static T* Alloc(Args&&... args)
+        {
+            return new(FrameAllocator::RawAlloc(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        /*!
+        destroys all elements of frame vector and detaches it from arena memory, so vector can be safely used after arena reset
+        \param vec vector to recycle
+        */
+        template<typename T>
+        static void Recycle(FrameVector<T>& vec)
+        {
+            vec.clear();
+            vec.reset_lose_memory();
+        }
+
+        static FrameAllocatorImpl* GetImpl();
+        static void Clone(FrameAllocatorImpl* other);
+    };
+
+    inline void* FrameAllocatorAdapter::allocate(size_t bytes, int flags)
+    {
+        return this->allocate(bytes, alignof(std::max_align_t), 0, flags);
+    }
+
+    inline void* FrameAllocatorAdapter::allocate(size_t bytes, size_t alignment, size_t offset, int flags)
+    {
+        MX_ASSERT(offset == 0);
+        return FrameAllocator::RawAlloc(bytes, alignment);
+    }
+}
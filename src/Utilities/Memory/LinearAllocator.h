@@ -123,6 +123,61 @@ namespace MxEngine
             return this->base;
         }
 
+        /*!
+        total memory chunk size getter
+        \returns size of memory chunk in bytes
+        */
+        size_t GetSize() const
+        {
+            return this->size;
+        }
+
+        /*!
+        used memory getter
+        \returns number of bytes allocated from memory chunk (including alignment padding)
+        */
+        size_t GetUsedBytes() const
+        {
+            return static_cast<size_t>(this->top - this->base);
+        }
+
+        /*!
+        checks if pointer belongs to memory chunk of allocator
+        \param ptr pointer to check
+        \returns true if pointer lies inside memory chunk, false otherwise
+        */
+        bool Contains(const void* ptr) const
+        {
+            auto address = reinterpret_cast<uintptr_t>(ptr);
+            return address >= reinterpret_cast<uintptr_t>(this->base) && address < reinterpret_cast<uintptr_t>(this->base + this->size);
+        }
+
+        /*!
+        marks whole memory chunk as free. Destructors of allocated objects are NOT called
+        */
+        void Reset()
+        {
+            this->top = this->base;
+        }
+
+        /*!
+        returns pointer to raw allocated memory or nullptr if memory chunk has not enough space left
+        \param bytes minimal requested block size
+        \param align minimal alignment of pointer (defaults to 1)
+        \returns pointer to memory or nullptr
+        */
+        [[nodiscard]] DataPointer TryRawAlloc(size_t bytes, size_t align = 1)
+        {
+            if (this->base == nullptr) return nullptr;
+
+            uintptr_t aligned = AlignAddress(reinterpret_cast<uintptr_t>(this->top), align);
+            if (aligned + bytes > reinterpret_cast<uintptr_t>(this->base + this->size))
+                return nullptr;
+
+            this->top = reinterpret_cast<DataPointer>(aligned + bytes);
+            return reinterpret_cast<DataPointer>(aligned);
+        }
+
         /*!
         returns pointer to raw allocated memory
         \param bytes minimal requested block size
@@ -4,6 +4,8 @@
 #include <cstdint>
 #include <ostream>
 #include <memory>
+#include <limits>
+#include <cstring>
 
 #include "Core/Macro/Macro.h"
 
@@ -91,6 +93,7 @@ namespace MxEngine
         {
             MX_ASSERT(data != nullptr);
             MX_ASSERT(bytes >= sizeof(Block));
+            MX_ASSERT(reinterpret_cast<uintptr_t>(data) % alignof(Block) == 0);
 
             this->storage = reinterpret_cast<Block*>(data);
             this->free = 0;
@@ -122,6 +125,7 @@ namespace MxEngine
             size_t newCount = newBytes / sizeof(Block); // calc new number of blocks
             MX_ASSERT(newData != nullptr);
             MX_ASSERT(this->count <= newCount);
+            MX_ASSERT(reinterpret_cast<uintptr_t>(newData) % alignof(Block) == 0);
             
             memcpy(newData, this->storage, this->count * sizeof(Block)); // copy old blocks to new memory chunk
 
@@ -137,6 +141,8 @@ namespace MxEngine
             // }
 
             this->storage = (Block*)newData;
+            if (newCount == this->count) return; // no new blocks to chain
+
             Block* last = this->storage + newCount - 1; // calculate last block to chain new ones
             size_t offset = this->count + 1;
             for(Block* begin = this->storage + this->count; begin != last; begin++, offset++)
@@ -204,9 +210,10 @@ namespace MxEngine
         */
         void Free(T* object)
         {
-            object->~T();
             Block* block = reinterpret_cast<Block*>(object);
             MX_ASSERT(block >= this->storage && block < this->storage + this->count);
+            MX_ASSERT(!block->IsFree()); // double free
+            object->~T();
             block->next = this->free;
             this->free = static_cast<size_t>(block - this->storage);
         }
@@ -146,16 +146,15 @@ namespace MxEngine
         header becomes the first block, pointing to the second, the second points to initial value of header->next
         \param header note to split into two
         \param bytes minimal required bytes in block of header node
-        \param align required align for node block (clamped to be at least sizeof(pointer)
         */
-        void Split(Header* header, size_t bytes, size_t align)
+        void Split(Header* header, size_t bytes)
         {
-            if (header->GetSize() < bytes + 2 * sizeof(Header))
+            // headers are always pointer-aligned, as the last bit of next pointer stores node state
+            uintptr_t nextAddress = AlignAddress((uintptr_t)header->GetData() + bytes, sizeof(Header));
+            if (nextAddress + 2 * sizeof(Header) > (uintptr_t)header->GetNext())
                 return; // not enough space to create new block
 
-            align = (align < sizeof(uintptr_t)) ? sizeof(uintptr_t) : align;
-
-            Header* next = (Header*)AlignPointer(header->GetData() + bytes, align);
+            Header* next = (Header*)nextAddress;
             next->next = (uintptr_t)header->GetNext();
             next->MakeFree();
             header->next = (uintptr_t)next;
@@ -193,6 +192,8 @@ namespace MxEngine
         */
         void Init(DataPointer data, size_t bytes)
         {
+            MX_ASSERT(((uintptr_t)data & (sizeof(Header) - 1)) == 0);
+            bytes &= ~(sizeof(Header) - 1);
             MX_ASSERT(bytes > sizeof(Header));
             first = (Header*)data;
             last = (Header*)(data + bytes);
@@ -237,12 +238,23 @@ namespace MxEngine
                 {
                     while (this->Collapse(current));
                     uint8_t* data = current->GetData();
-                    size_t available = current->GetSize();
-                    if (available >= bytes)
+                    uint8_t* aligned = AlignPointer(data, align);
+                    // if node data is not aligned, new node is placed right before aligned block, so padding must fit its header
+                    if (aligned != data)
+                        aligned = AlignPointer(data + sizeof(Header), align);
+
+                    if ((uintptr_t)aligned + bytes <= (uintptr_t)current->GetNext())
                     {
-                        this->Split(current, bytes, align);
+                        if (aligned != data)
+                        {
+                            Header* header = (Header*)(aligned - sizeof(Header));
+                            header->next = current->next; // current node is free, so its state bit is already cleared
+                            current->next = (uintptr_t)header;
+                            current = header;
+                        }
+                        this->Split(current, bytes);
                         current->MakeBusy();
-                        return data;
+                        return aligned;
                     }
                 }
                 current = current->GetNext();
@@ -0,0 +1,78 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "ScratchStack.h"
+
+#include <algorithm>
+
+namespace MxEngine
+{
+    struct ScratchStackStorage
+    {
+        UniqueRef<uint8_t[]> memory;
+        StackAllocator allocator;
+
+        StackAllocator& GetAllocator()
+        {
+            // memory is allocated lazily, so threads which never use scratch stack do not pay for it
+            if (this->memory == nullptr)
+            {
+                this->memory = MakeUnique<uint8_t[]>(ScratchStack::StackSize);
+                this->allocator.Init(this->memory.get(), ScratchStack::StackSize);
+            }
+            return this->allocator;
+        }
+    };
+
+    thread_local static ScratchStackStorage scratchStorage;
+
+    uint8_t* ScratchStack::RawAlloc(size_t bytes, size_t align)
+    {
+        // empty allocations still take one byte, so each returned pointer is unambiguously inside or outside of the stack
+        bytes = std::max(bytes, size_t(1));
+        uint8_t* ptr = scratchStorage.GetAllocator().TryRawAlloc(bytes, align);
+        if (ptr != nullptr) return ptr;
+
+        return static_cast<uint8_t*>(::operator new(bytes, std::align_val_t{ align }));
+    }
+
+    void ScratchStack::RawFree(uint8_t* ptr, size_t align)
+    {
+        auto& allocator = scratchStorage.GetAllocator();
+        if (allocator.Contains(ptr))
+            allocator.RawFree(ptr);
+        else
+            ::operator delete(ptr, std::align_val_t{ align });
+    }
+
+    size_t ScratchStack::GetUsedBytes()
+    {
+        return scratchStorage.GetAllocator().GetUsedBytes();
+    }
+}
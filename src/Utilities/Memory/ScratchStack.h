@@ -0,0 +1,96 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include <new>
+
+#include "Utilities/Memory/StackAllocator.h"
+#include "Utilities/Memory/Memory.h"
+
+namespace MxEngine
+{
+    /*!
+    scratch stack is a per-thread StackAllocator for short-living temporary buffers. Allocations must be freed in reverse order,
+    which is naturally satisfied by ScratchArray objects created on the call stack. If stack memory is exhausted, heap is used instead
+    */
+    class ScratchStack
+    {
+    public:
+        constexpr static size_t StackSize = 256 * KB;
+
+        [[nodiscard]] static uint8_t* RawAlloc(size_t bytes, size_t align);
+        /*!
+        frees memory allocated by RawAlloc
+        \param ptr pointer to free. Must be the last allocated one on calling thread
+        \param align alignment which was passed to RawAlloc
+        */
+        static void RawFree(uint8_t* ptr, size_t align);
+        static size_t GetUsedBytes();
+    };
+
+    /*!
+    fixed-size array of default-constructed objects which lives in the scratch stack of the calling thread.
+    Must be destroyed on the same thread where it was created
+    */
+    template<typename T>
+    class ScratchArray
+    {
+        T* _data = nullptr;
+        size_t _size = 0;
+    public:
+        explicit ScratchArray(size_t count)
+            : _data(reinterpret_cast<T*>(ScratchStack::RawAlloc(count * sizeof(T), alignof(T)))), _size(count)
+        {
+            for (size_t i = 0; i < this->_size; i++)
+                new(this->_data + i) T();
+        }
+
+        ScratchArray(const ScratchArray&) = delete;
+        ScratchArray& operator=(const ScratchArray&) = delete;
+
+        ~ScratchArray()
+        {
+            for (size_t i = this->_size; i > 0; i--)
+                this->_data[i - 1].~T();
+            ScratchStack::RawFree(reinterpret_cast<uint8_t*>(this->_data), alignof(T));
+        }
+
+        size_t size() const { return this->_size; }
+        bool empty() const { return this->_size == 0; }
+        T* data() { return this->_data; }
+        const T* data() const { return this->_data; }
+        T& operator[](size_t idx) { MX_ASSERT(idx < this->_size); return this->_data[idx]; }
+        const T& operator[](size_t idx) const { MX_ASSERT(idx < this->_size); return this->_data[idx]; }
+        T* begin() { return this->_data; }
+        T* end() { return this->_data + this->_size; }
+        const T* begin() const { return this->_data; }
+        const T* end() const { return this->_data + this->_size; }
+    };
+}
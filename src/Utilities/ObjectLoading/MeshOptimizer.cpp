@@ -0,0 +1,507 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "MeshOptimizer.h"
+#include "Utilities/Profiler/Profiler.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+#include "Core/Macro/Macro.h"
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace MxEngine
+{
+    constexpr uint32_t InvalidMeshIndex = std::numeric_limits<uint32_t>::max();
+
+    struct TriangleAdjacency
+    {
+        MxVector<uint32_t> Offsets;
+        MxVector<uint32_t> Counts;
+        MxVector<uint32_t> Triangles;
+    };
+
+    static TriangleAdjacency BuildTriangleAdjacency(const MeshData::IndexData& indicies, size_t vertexCount)
+    {
+        TriangleAdjacency adjacency;
+        adjacency.Offsets.resize(vertexCount + 1, 0);
+        adjacency.Counts.resize(vertexCount, 0);
+        adjacency.Triangles.resize(indicies.size());
+
+        for (uint32_t index : indicies)
+        {
+            MX_ASSERT(index < vertexCount);
+            adjacency.Counts[index]++;
+        }
+
+        for (size_t i = 0; i < vertexCount; i++)
+            adjacency.Offsets[i + 1] = adjacency.Offsets[i] + adjacency.Counts[i];
+
+        MxVector<uint32_t> fill(adjacency.Offsets.begin(), adjacency.Offsets.end() - 1);
+        for (size_t i = 0; i < indicies.size(); i++)
+        {
+            adjacency.Triangles[fill[indicies[i]]++] = uint32_t(i / 3);
+        }
+        return adjacency;
+    }
+
+    namespace ForsythParameters
+    {
+        constexpr size_t CacheSize = 32;
+        constexpr uint32_t MaxValence = 32;
+        constexpr float CacheDecayPower = 1.5f;
+        constexpr float LastTriangleScore = 0.75f;
+        constexpr float ValenceBoostScale = 2.0f;
+        constexpr float ValenceBoostPower = 0.5f;
+    }
+
+    struct ForsythScoreTable
+    {
+        float CacheScores[ForsythParameters::CacheSize];
+        float ValenceScores[ForsythParameters::MaxValence + 1];
+
+        ForsythScoreTable()
+        {
+            using namespace ForsythParameters;
+            for (size_t i = 0; i < CacheSize; i++)
+            {
+                if (i < 3)
+                    this->CacheScores[i] = LastTriangleScore;
+                else
+                    this->CacheScores[i] = std::pow(1.0f - float(i - 3) / float(CacheSize - 3), CacheDecayPower);
+            }
+            this->ValenceScores[0] = 0.0f;
+            for (uint32_t i = 1; i <= MaxValence; i++)
+                this->ValenceScores[i] = ValenceBoostScale * std::pow(float(i), -ValenceBoostPower);
+        }
+
+        float GetVertexScore(int32_t cachePosition, uint32_t liveTriangles) const
+        {
+            // vertex without live triangles can no longer affect the order
+            if (liveTriangles == 0) return -1.0f;
+
+            float score = cachePosition >= 0 ? this->CacheScores[cachePosition] : 0.0f;
+            return score + this->ValenceScores[Min(liveTriangles, ForsythParameters::MaxValence)];
+        }
+    };
+
+    void MeshOptimizer::OptimizeVertexCache(MeshData::IndexData& indicies, size_t vertexCount)
+    {
+        MAKE_SCOPE_PROFILER("MeshOptimizer::OptimizeVertexCache()");
+        using ForsythParameters::CacheSize;
+        static const ForsythScoreTable scoreTable;
+
+        const size_t triangleCount = indicies.size() / 3;
+        if (triangleCount == 0) return;
+
+        auto adjacency = BuildTriangleAdjacency(indicies, vertexCount);
+
+        MxVector<int32_t> cachePositions(vertexCount, -1);
+        MxVector<float> vertexScores(vertexCount);
+        for (size_t i = 0; i < vertexCount; i++)
+            vertexScores[i] = scoreTable.GetVertexScore(-1, adjacency.Counts[i]);
+
+        MxVector<float> triangleScores(triangleCount);
+        for (size_t i = 0; i < triangleCount; i++)
+        {
+            triangleScores[i] = vertexScores[indicies[3 * i + 0]] + vertexScores[indicies[3 * i + 1]] + vertexScores[indicies[3 * i + 2]];
+        }
+
+        MxVector<uint8_t> isEmitted(triangleCount, 0);
+        MeshData::IndexData result;
+        result.reserve(triangleCount * 3);
+
+        uint32_t cache[CacheSize + 3];
+        uint32_t newCache[CacheSize + 3];
+        size_t cacheCount = 0;
+        size_t cursor = 0;
+
+        uint32_t bestTriangle = uint32_t(std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin());
+        for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+        {
+            if (bestTriangle == InvalidMeshIndex)
+            {
+                // no live triangle in cache, continue from the first one not yet emitted
+                while (isEmitted[cursor]) cursor++;
+                bestTriangle = uint32_t(cursor);
+            }
+
+            const uint32_t triangle[3] = { indicies[3 * bestTriangle + 0], indicies[3 * bestTriangle + 1], indicies[3 * bestTriangle + 2] };
+            result.insert(result.end(), triangle, triangle + 3);
+            isEmitted[bestTriangle] = 1;
+
+            size_t newCacheCount = 0;
+            for (uint32_t vertex : triangle)
+            {
+                // remove emitted triangle from vertex live list
+                uint32_t* triangles = adjacency.Triangles.data() + adjacency.Offsets[vertex];
+                uint32_t& liveCount = adjacency.Counts[vertex];
+                for (uint32_t i = 0; i < liveCount; i++)
+                {
+                    if (triangles[i] == bestTriangle)
+                    {
+                        std::swap(triangles[i], triangles[liveCount - 1]);
+                        liveCount--;
+                        break;
+                    }
+                }
+
+                if (std::find(newCache, newCache + newCacheCount, vertex) == newCache + newCacheCount)
+                    newCache[newCacheCount++] = vertex;
+            }
+
+            for (size_t i = 0; i < cacheCount; i++)
+            {
+                uint32_t vertex = cache[i];
+                if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+                    newCache[newCacheCount++] = vertex;
+            }
+
+            // update scores of all touched vertecies, including ones pushed out of cache
+            for (size_t i = 0; i < newCacheCount; i++)
+            {
+                uint32_t vertex = newCache[i];
+                int32_t position = i < CacheSize ? int32_t(i) : -1;
+                cachePositions[vertex] = position;
+
+                float score = scoreTable.GetVertexScore(position, adjacency.Counts[vertex]);
+                float delta = score - vertexScores[vertex];
+                vertexScores[vertex] = score;
+
+                const uint32_t* triangles = adjacency.Triangles.data() + adjacency.Offsets[vertex];
+                for (uint32_t j = 0; j < adjacency.Counts[vertex]; j++)
+                    triangleScores[triangles[j]] += delta;
+            }
+
+            bestTriangle = InvalidMeshIndex;
+            float bestScore = -1.0f;
+            cacheCount = Min(newCacheCount, CacheSize);
+            for (size_t i = 0; i < cacheCount; i++)
+            {
+                uint32_t vertex = newCache[i];
+                cache[i] = vertex;
+
+                const uint32_t* triangles = adjacency.Triangles.data() + adjacency.Offsets[vertex];
+                for (uint32_t j = 0; j < adjacency.Counts[vertex]; j++)
+                {
+                    if (triangleScores[triangles[j]] > bestScore)
+                    {
+                        bestScore = triangleScores[triangles[j]];
+                        bestTriangle = triangles[j];
+                    }
+                }
+            }
+        }
+
+        indicies = std::move(result);
+    }
+
+    static uint32_t GetNextTipsifyVertex(const MxVector<uint32_t>& candidates, const MxVector<uint32_t>& liveCounts, const MxVector<uint32_t>& cacheTimestamps,
+        MxVector<uint32_t>& deadEnd, size_t& cursor, uint32_t timestamp, size_t cacheSize)
+    {
+        uint32_t bestVertex = InvalidMeshIndex;
+        int64_t bestPriority = -1;
+        for (uint32_t vertex : candidates)
+        {
+            if (liveCounts[vertex] == 0) continue;
+
+            // prefer vertecies which are still in cache after all their triangles are emitted
+            int64_t priority = 0;
+            int64_t age = int64_t(timestamp) - int64_t(cacheTimestamps[vertex]);
+            if (age + 2 * int64_t(liveCounts[vertex]) <= int64_t(cacheSize))
+                priority = age;
+
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                bestVertex = vertex;
+            }
+        }
+        if (bestVertex != InvalidMeshIndex) return bestVertex;
+
+        // dead-end: try recently emitted vertecies first, then fallback to linear scan
+        while (!deadEnd.empty())
+        {
+            uint32_t vertex = deadEnd.back();
+            deadEnd.pop_back();
+            if (liveCounts[vertex] > 0) return vertex;
+        }
+        while (cursor < liveCounts.size())
+        {
+            if (liveCounts[cursor] > 0) return uint32_t(cursor);
+            cursor++;
+        }
+        return InvalidMeshIndex;
+    }
+
+    void MeshOptimizer::OptimizeVertexCacheTipsify(MeshData::IndexData& indicies, size_t vertexCount, size_t cacheSize)
+    {
+        MAKE_SCOPE_PROFILER("MeshOptimizer::OptimizeVertexCacheTipsify()");
+
+        const size_t triangleCount = indicies.size() / 3;
+        if (triangleCount == 0) return;
+
+        auto adjacency = BuildTriangleAdjacency(indicies, vertexCount);
+        MxVector<uint32_t>& liveCounts = adjacency.Counts;
+        MxVector<uint32_t> cacheTimestamps(vertexCount, 0);
+        MxVector<uint8_t> isEmitted(triangleCount, 0);
+        MxVector<uint32_t> deadEnd;
+        MxVector<uint32_t> candidates;
+        deadEnd.reserve(triangleCount * 3);
+
+        MeshData::IndexData result;
+        result.reserve(triangleCount * 3);
+
+        uint32_t timestamp = uint32_t(cacheSize + 1);
+        size_t cursor = 0;
+        uint32_t fanningVertex = GetNextTipsifyVertex(candidates, liveCounts, cacheTimestamps, deadEnd, cursor, timestamp, cacheSize);
+
+        while (fanningVertex != InvalidMeshIndex)
+        {
+            candidates.clear();
+            const uint32_t offset = adjacency.Offsets[fanningVertex];
+            const uint32_t count = adjacency.Offsets[fanningVertex + 1] - offset;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                uint32_t triangle = adjacency.Triangles[offset + i];
+                if (isEmitted[triangle]) continue;
+
+                for (size_t j = 0; j < 3; j++)
+                {
+                    uint32_t vertex = indicies[3 * triangle + j];
+                    result.push_back(vertex);
+                    deadEnd.push_back(vertex);
+                    candidates.push_back(vertex);
+                    liveCounts[vertex]--;
+
+                    if (timestamp - cacheTimestamps[vertex] > cacheSize)
+                        cacheTimestamps[vertex] = timestamp++;
+                }
+                isEmitted[triangle] = 1;
+            }
+
+            fanningVertex = GetNextTipsifyVertex(candidates, liveCounts, cacheTimestamps, deadEnd, cursor, timestamp, cacheSize);
+        }
+
+        indicies = std::move(result);
+    }
+
+    void MeshOptimizer::OptimizeOverdraw(MeshData::IndexData& indicies, const MeshData::VertexData& vertecies, float threshold, size_t cacheSize)
+    {
+        MAKE_SCOPE_PROFILER("MeshOptimizer::OptimizeOverdraw()");
+
+        const size_t triangleCount = indicies.size() / 3;
+        if (triangleCount < 2) return;
+
+        // split index buffer into clusters, cutting each one as soon as its own ACMR is close enough to the whole mesh ACMR
+        const float targetACMR = MeshOptimizer::AnalyzeVertexCache(indicies, vertecies.size(), cacheSize).ACMR * threshold;
+        MxVector<uint32_t> cacheTimestamps(vertecies.size(), 0);
+        MxVector<uint32_t> clusterOffsets;
+        clusterOffsets.push_back(0);
+
+        uint32_t timestamp = uint32_t(cacheSize + 1);
+        size_t clusterStart = 0;
+        size_t clusterMisses = 0;
+        for (size_t i = 0; i < triangleCount; i++)
+        {
+            for (size_t j = 0; j < 3; j++)
+            {
+                uint32_t vertex = indicies[3 * i + j];
+                if (timestamp - cacheTimestamps[vertex] > cacheSize)
+                {
+                    cacheTimestamps[vertex] = timestamp++;
+                    clusterMisses++;
+                }
+            }
+
+            size_t clusterSize = i - clusterStart + 1;
+            if (i + 1 < triangleCount && clusterSize >= cacheSize && float(clusterMisses) <= targetACMR * float(clusterSize))
+            {
+                clusterOffsets.push_back(uint32_t(i + 1));
+                clusterStart = i + 1;
+                clusterMisses = 0;
+                // next cluster may be rendered in any order, so it starts with a cold cache
+                timestamp += uint32_t(cacheSize + 1);
+            }
+        }
+        clusterOffsets.push_back(uint32_t(triangleCount));
+
+        const size_t clusterCount = clusterOffsets.size() - 1;
+        if (clusterCount < 2) return;
+
+        struct ClusterInfo
+        {
+            Vector3 Centroid;
+            Vector3 Normal;
+            float Area;
+        };
+        MxVector<ClusterInfo> clusters(clusterCount);
+
+        Vector3 meshCentroid = MakeVector3(0.0f);
+        float meshArea = 0.0f;
+        for (size_t i = 0; i < clusterCount; i++)
+        {
+            auto& cluster = clusters[i];
+            cluster.Centroid = MakeVector3(0.0f);
+            cluster.Normal = MakeVector3(0.0f);
+            cluster.Area = 0.0f;
+
+            for (size_t t = clusterOffsets[i]; t < clusterOffsets[i + 1]; t++)
+            {
+                const Vector3& p0 = vertecies[indicies[3 * t + 0]].Position;
+                const Vector3& p1 = vertecies[indicies[3 * t + 1]].Position;
+                const Vector3& p2 = vertecies[indicies[3 * t + 2]].Position;
+
+                Vector3 normal = Cross(p1 - p0, p2 - p0);
+                float area = Length(normal);
+                cluster.Centroid += (p0 + p1 + p2) * (area / 3.0f);
+                cluster.Normal += normal;
+                cluster.Area += area;
+            }
+
+            meshCentroid += cluster.Centroid;
+            meshArea += cluster.Area;
+            if (cluster.Area > 0.0f) cluster.Centroid /= cluster.Area;
+        }
+        if (meshArea > 0.0f) meshCentroid /= meshArea;
+
+        // clusters facing away from mesh center are likely to occlude the rest, so they are drawn first
+        MxVector<float> sortKeys(clusterCount);
+        for (size_t i = 0; i < clusterCount; i++)
+        {
+            float normalLength = Length(clusters[i].Normal);
+            Vector3 normal = normalLength > 0.0f ? clusters[i].Normal / normalLength : MakeVector3(0.0f);
+            sortKeys[i] = Dot(clusters[i].Centroid - meshCentroid, normal);
+        }
+
+        MxVector<uint32_t> order(clusterCount);
+        for (size_t i = 0; i < clusterCount; i++)
+            order[i] = uint32_t(i);
+        std::stable_sort(order.begin(), order.end(), [&sortKeys](uint32_t c1, uint32_t c2) { return sortKeys[c1] > sortKeys[c2]; });
+
+        MeshData::IndexData result;
+        result.reserve(indicies.size());
+        for (uint32_t cluster : order)
+        {
+            result.insert(result.end(), indicies.begin() + 3 * clusterOffsets[cluster], indicies.begin() + 3 * clusterOffsets[cluster + 1]);
+        }
+        // keep trailing indicies of incomplete triangle, if any
+        result.insert(result.end(), indicies.begin() + 3 * triangleCount, indicies.end());
+        indicies = std::move(result);
+    }
+
+    void MeshOptimizer::OptimizeVertexFetch(MeshData::VertexData& vertecies, MeshData::IndexData& indicies)
+    {
+        MAKE_SCOPE_PROFILER("MeshOptimizer::OptimizeVertexFetch()");
+
+        MxVector<uint32_t> remap(vertecies.size(), InvalidMeshIndex);
+        uint32_t nextVertex = 0;
+        for (uint32_t& index : indicies)
+        {
+            MX_ASSERT(index < vertecies.size());
+            if (remap[index] == InvalidMeshIndex)
+                remap[index] = nextVertex++;
+            index = remap[index];
+        }
+
+        // vertex count is preserved, so unreferenced vertecies are kept at the end of buffer
+        for (uint32_t& index : remap)
+        {
+            if (index == InvalidMeshIndex)
+                index = nextVertex++;
+        }
+
+        MeshData::VertexData result(vertecies.size());
+        for (size_t i = 0; i < vertecies.size(); i++)
+            result[remap[i]] = vertecies[i];
+        vertecies = std::move(result);
+    }
+
+    VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(const MeshData::IndexData& indicies, size_t vertexCount, size_t cacheSize)
+    {
+        VertexCacheStatistics statistics;
+        const size_t triangleCount = indicies.size() / 3;
+        if (triangleCount == 0) return statistics;
+
+        MxVector<uint32_t> cacheTimestamps(vertexCount, 0);
+        uint32_t timestamp = uint32_t(cacheSize + 1);
+        size_t referencedCount = 0;
+        for (size_t i = 0; i < triangleCount * 3; i++)
+        {
+            uint32_t vertex = indicies[i];
+            MX_ASSERT(vertex < vertexCount);
+            if (cacheTimestamps[vertex] == 0) referencedCount++;
+
+            if (timestamp - cacheTimestamps[vertex] > cacheSize)
+            {
+                cacheTimestamps[vertex] = timestamp++;
+                statistics.TransformedVertexCount++;
+            }
+        }
+
+        statistics.ACMR = float(statistics.TransformedVertexCount) / float(triangleCount);
+        statistics.ATVR = float(statistics.TransformedVertexCount) / float(referencedCount);
+        return statistics;
+    }
+
+    void MeshOptimizer::Optimize(MeshData::VertexData& vertecies, MeshData::IndexData& indicies, VertexCacheAlgorithm algorithm)
+    {
+        MAKE_SCOPE_PROFILER("MeshOptimizer::Optimize()");
+
+        if (indicies.size() < 6) return;
+        if (indicies.size() % 3 != 0)
+        {
+            MXLOG_WARNING("MxEngine::MeshOptimizer", "index buffer is not a triangle list, optimization skipped");
+            return;
+        }
+        for (uint32_t index : indicies)
+        {
+            if (index >= vertecies.size())
+            {
+                MXLOG_WARNING("MxEngine::MeshOptimizer", "index buffer references out of range vertex, optimization skipped");
+                return;
+            }
+        }
+
+        auto before = MeshOptimizer::AnalyzeVertexCache(indicies, vertecies.size());
+
+        if (algorithm == VertexCacheAlgorithm::FORSYTH)
+            MeshOptimizer::OptimizeVertexCache(indicies, vertecies.size());
+        else
+            MeshOptimizer::OptimizeVertexCacheTipsify(indicies, vertecies.size());
+
+        MeshOptimizer::OptimizeOverdraw(indicies, vertecies);
+        MeshOptimizer::OptimizeVertexFetch(vertecies, indicies);
+
+        auto after = MeshOptimizer::AnalyzeVertexCache(indicies, vertecies.size());
+        MXLOG_DEBUG("MxEngine::MeshOptimizer", MxFormat("optimized mesh of {} triangles: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+            indicies.size() / 3, before.ACMR, after.ACMR, before.ATVR, after.ATVR));
+    }
+}
@@ -0,0 +1,117 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Core/Resources/MeshData.h"
+
+namespace MxEngine
+{
+    /*!
+    statistics of post-transform vertex cache simulation over an index buffer
+    */
+    struct VertexCacheStatistics
+    {
+        /*!
+        number of vertex shader invocations (cache misses)
+        */
+        size_t TransformedVertexCount = 0;
+        /*!
+        average cache miss ratio: transformed vertecies per triangle. 0.5 is the optimum for regular grids, 3.0 is the worst case
+        */
+        float ACMR = 0.0f;
+        /*!
+        average transform to vertex ratio: transformed vertecies per referenced vertex. 1.0 is the optimum
+        */
+        float ATVR = 0.0f;
+    };
+
+    enum class VertexCacheAlgorithm : uint8_t
+    {
+        FORSYTH,
+        TIPSIFY,
+    };
+
+    /*!
+    mesh optimizer reorders triangle lists to reduce vertex shader invocations, overdraw and vertex fetch bandwidth.
+    All passes operate on CPU-side vertex and index data in-place and keep vertex count unchanged, so results can be buffered
+    directly into already reserved MeshData ranges. Index buffers are expected to be triangle lists
+    */
+    class MeshOptimizer
+    {
+    public:
+        constexpr static size_t DefaultCacheSize = 16;
+        constexpr static float DefaultOverdrawThreshold = 1.05f;
+
+        /*!
+        reorders triangles using Forsyth's linear-speed vertex cache optimization (LRU cache model)
+        \param indicies triangle list to reorder
+        \param vertexCount number of vertecies referenced by index buffer
+        */
+        static void OptimizeVertexCache(MeshData::IndexData& indicies, size_t vertexCount);
+        /*!
+        reorders triangles using Tipsify algorithm (FIFO cache model). Faster than Forsyth and better suited for following overdraw pass
+        \param indicies triangle list to reorder
+        \param vertexCount number of vertecies referenced by index buffer
+        \param cacheSize size of simulated FIFO cache
+        */
+        static void OptimizeVertexCacheTipsify(MeshData::IndexData& indicies, size_t vertexCount, size_t cacheSize = DefaultCacheSize);
+        /*!
+        splits cache-optimized triangle list into clusters and sorts them front-to-back from the outside of the mesh, so
+        early depth test rejects more fragments from any view direction. Should be applied after vertex cache optimization
+        \param indicies cache-optimized triangle list to reorder
+        \param vertecies vertecies referenced by index buffer
+        \param threshold maximum allowed ACMR degradation of each cluster relative to the whole mesh
+        \param cacheSize size of simulated FIFO cache
+        */
+        static void OptimizeOverdraw(MeshData::IndexData& indicies, const MeshData::VertexData& vertecies,
+            float threshold = DefaultOverdrawThreshold, size_t cacheSize = DefaultCacheSize);
+        /*!
+        reorders vertecies in order of first use by index buffer and remaps indicies accordingly. Unreferenced vertecies are moved to the end
+        \param vertecies vertex buffer to reorder
+        \param indicies index buffer to remap
+        */
+        static void OptimizeVertexFetch(MeshData::VertexData& vertecies, MeshData::IndexData& indicies);
+        /*!
+        simulates FIFO post-transform vertex cache over index buffer
+        \param indicies triangle list to analyze
+        \param vertexCount number of vertecies referenced by index buffer
+        \param cacheSize size of simulated FIFO cache
+        \returns cache statistics of index buffer
+        */
+        static VertexCacheStatistics AnalyzeVertexCache(const MeshData::IndexData& indicies, size_t vertexCount, size_t cacheSize = DefaultCacheSize);
+        /*!
+        applies vertex cache, overdraw and vertex fetch optimizations in order
+        \param vertecies vertex buffer to reorder
+        \param indicies index buffer to reorder
+        \param algorithm vertex cache optimization algorithm
+        */
+        static void Optimize(MeshData::VertexData& vertecies, MeshData::IndexData& indicies, VertexCacheAlgorithm algorithm = VertexCacheAlgorithm::TIPSIFY);
+    };
+}
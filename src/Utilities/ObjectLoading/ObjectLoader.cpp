@@ -27,20 +27,31 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ObjectLoader.h"
+#include "MeshOptimizer.h"
 #include "Utilities/Logging/Logger.h"
 #include "Utilities/Profiler/Profiler.h"
 #include "Core/Macro/Macro.h"
 #include "Utilities/FileSystem/File.h"
+#include "Utilities/FileSystem/MappedFile.h"
+#include "Utilities/FileSystem/VirtualFileSystem.h"
 #include "Utilities/Format/Format.h"
 #include "Utilities/Random/Random.h"
 #include "Utilities/Json/Json.h"
 #include "Utilities/Image/ImageLoader.h"
 #include "Utilities/Image/ImageManager.h"
+#include "Utilities/Image/ImageConverter.h"
+#include "Utilities/Image/TextureCooker.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/STL/MxHashSet.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 #include <assimp/pbrmaterial.h>
+#include <assimp/IOSystem.hpp>
+#include <assimp/IOStream.hpp>
+
+#include <cstring>
 
 namespace MxEngine
 {
@@ -51,49 +62,181 @@ namespace MxEngine
     const char* const AOTexName = "ao";
     const char* const RoughnessTexName = "roughness";
     const char* const MetallicTexName = "metallic";
-    constexpr ImageType PreferredFormat = ImageType::PNG;
-    const char* const PreferredExtension = ".png";
+    // extracted textures are saved without encoding, as they are only read back by the engine
+    constexpr ImageType PreferredFormat = ImageType::RAW;
+    const char* const PreferredExtension = ImageConverter::RawImageExtension;
+
+    /*!
+    textures decoded while loading single object. Embedded textures with the same content are decoded and saved only once
+    */
+    struct EmbeddedTextureCache
+    {
+        MxHashMap<uint64_t, FilePath> PathsByContent;
+        MxHashMap<StringId, ImageData>& Images;
+    };
+
+    /*!
+    read-only assimp stream over mapped file contents
+    */
+    class MappedFileIOStream : public Assimp::IOStream
+    {
+        MappedFile file;
+        size_t position = 0;
+    public:
+        explicit MappedFileIOStream(MappedFile&& file)
+            : file(std::move(file)) { }
+
+        size_t Read(void* buffer, size_t size, size_t count) override
+        {
+            if (size == 0) return 0;
+            count = Min(count, (this->file.GetSize() - this->position) / size);
+            std::memcpy(buffer, this->file.GetData() + this->position, count * size);
+            this->position += count * size;
+            return count;
+        }
+
+        size_t Write(const void* buffer, size_t size, size_t count) override
+        {
+            return 0;
+        }
+
+        aiReturn Seek(size_t offset, aiOrigin origin) override
+        {
+            size_t base = 0;
+            if (origin == aiOrigin_CUR) base = this->position;
+            if (origin == aiOrigin_END) base = this->file.GetSize();
+            // negative offsets relative to end or current position are passed wrapped around
+            size_t target = base + offset;
+            if (target > this->file.GetSize()) return aiReturn_FAILURE;
+            this->position = target;
+            return aiReturn_SUCCESS;
+        }
+
+        size_t Tell() const override
+        {
+            return this->position;
+        }
 
-    static void SaveRoughnessMetallicTexture(const ImageData& image, const FilePath& roughnessPath, const FilePath& metallicPath)
+        size_t FileSize() const override
+        {
+            return this->file.GetSize();
+        }
+
+        void Flush() override { }
+    };
+
+    /*!
+    assimp io system which resolves object files and all files they reference (materials, buffers, images) through virtual file system,
+    so objects can be loaded both from project directory and from mounted packs
+    */
+    class VirtualFileIOSystem : public Assimp::IOSystem
     {
-        if (File::Exists(roughnessPath) || File::Exists(metallicPath))
-            return; // avoid rewriting existing textures
+    public:
+        bool Exists(const char* path) const override
+        {
+            return VirtualFileSystem::IsFile(ToFilePath(path));
+        }
 
-        auto roughnessData = (uint8_t*)std::malloc(image.GetTotalByteSize());
-        auto metallicData = (uint8_t*)std::malloc(image.GetTotalByteSize());
-        ImageData roughness(roughnessData, image.GetWidth(), image.GetHeight(), 1, image.IsFloatingPoint());
-        ImageData metallic(metallicData, image.GetWidth(), image.GetHeight(), 1, image.IsFloatingPoint());
+        char getOsSeparator() const override
+        {
+            return '/';
+        }
 
-        for (size_t x = 0; x < image.GetWidth(); x++)
+        Assimp::IOStream* Open(const char* path, const char* mode) override
         {
-            for (size_t y = 0; y < image.GetHeight(); y++)
-            {
-                if (image.IsFloatingPoint())
-                {
-                    auto pixel = image.GetPixelFloat(x, y);
-                    // G channel
-                    roughness.SetPixelFloat(x, y, pixel[1], 0.0f, 0.0f, 0.0f);
-                    // B channel
-                    metallic.SetPixelFloat(x, y, pixel[2], 0.0f, 0.0f, 0.0f);
-                }
-                else
-                {
-                    auto pixel = image.GetPixelByte(x, y);
-                    // G channel
-                    roughness.SetPixelByte(x, y, pixel[1], 0, 0, 0);
-                    // B channel
-                    metallic.SetPixelByte(x, y, pixel[2], 0, 0, 0);
-                }
-            }
+            // importer never writes files
+            if (std::strchr(mode, 'w') != nullptr || std::strchr(mode, 'a') != nullptr) return nullptr;
+
+            MappedFile file(ToFilePath(path));
+            if (!file.IsOpen()) return nullptr;
+            return new MappedFileIOStream(std::move(file));
+        }
+
+        void Close(Assimp::IOStream* stream) override
+        {
+            delete stream;
+        }
+    };
+
+    static size_t GetEmbeddedTextureByteSize(const aiTexture* data)
+    {
+        if (data->mHeight == 0) // compressed data (jpg)
+            return (size_t)data->mWidth;
+        else
+            return (size_t)data->mWidth * (size_t)data->mHeight * sizeof(aiTexel);
+    }
+
+    static uint64_t HashEmbeddedTexture(const aiTexture* data)
+    {
+        // FNV-1a over 8-byte words, embedded textures may take dozens of megabytes
+        auto bytes = (const uint8_t*)data->pcData;
+        auto byteSize = GetEmbeddedTextureByteSize(data);
+        uint64_t hash = 14695981039346656037ull;
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= byteSize; i += sizeof(uint64_t))
+        {
+            uint64_t word;
+            std::memcpy(&word, bytes + i, sizeof(uint64_t));
+            hash = (hash ^ word) * 1099511628211ull;
+            hash ^= hash >> 32;
+        }
+        for (; i < byteSize; i++)
+        {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
         }
-        ImageManager::SaveImage(roughnessPath, roughness, PreferredFormat);
-        ImageManager::SaveImage(metallicPath, metallic, PreferredFormat);
+        return hash ^ (uint64_t)byteSize;
     }
 
-    FilePath GetActualTexturePath(const FilePath& lookupDirectory, const MxString& name, const aiScene* scene, const aiMaterial* material, aiTextureType type)
+    static ImageData DecodeEmbeddedTexture(const aiTexture* data)
+    {
+        return ImageLoader::LoadImageFromMemory((const uint8_t*)data->pcData, GetEmbeddedTextureByteSize(data));
+    }
+
+    static FilePath GetTemporaryPath(const FilePath& path)
+    {
+        auto temporaryPath = path;
+        temporaryPath += ToFilePath(MxFormat(".{}.tmp", std::hash<std::thread::id>{ }(std::this_thread::get_id())));
+        return temporaryPath;
+    }
+
+    static void ReplaceWithTemporary(const FilePath& temporaryPath, const FilePath& path)
+    {
+        std::error_code error;
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error)
+        {
+            MXLOG_ERROR("MxEngine::ObjectLoader", "cannot write file " + ToMxString(path) + ": " + ToMxString(error.message()));
+            std::filesystem::remove(temporaryPath, error);
+        }
+    }
+
+    static void PublishImage(const FilePath& path, const ImageData& image)
+    {
+        // textures extracted from an object are shared by all objects in the same directory, which may be loaded concurrently.
+        // Image is written to a temporary file first, so other loaders never observe partially written texture
+        auto temporaryPath = GetTemporaryPath(path);
+        ImageManager::SaveImage(temporaryPath, image, PreferredFormat);
+        ReplaceWithTemporary(temporaryPath, path);
+    }
+
+    static void SaveRoughnessMetallicTexture(const ImageData& image, const FilePath& roughnessPath, const FilePath& metallicPath, EmbeddedTextureCache& cache)
+    {
+        if (VirtualFileSystem::Exists(roughnessPath) && VirtualFileSystem::Exists(metallicPath))
+            return; // avoid rewriting existing textures
+
+        // roughness is stored in G channel, metallic in B channel
+        auto roughness = ImageConverter::ExtractChannel(image, 1);
+        auto metallic = ImageConverter::ExtractChannel(image, 2);
+        PublishImage(roughnessPath, roughness);
+        PublishImage(metallicPath, metallic);
+        cache.Images.emplace(MakeStringId(roughnessPath.string()), std::move(roughness));
+        cache.Images.emplace(MakeStringId(metallicPath.string()), std::move(metallic));
+    }
+
+    FilePath GetActualTexturePath(const FilePath& lookupDirectory, const MxString& name, const aiScene* scene, const aiMaterial* material, aiTextureType type, EmbeddedTextureCache& cache)
     {
         auto path = lookupDirectory / ToFilePath(name + PreferredExtension);
-        if (File::Exists(path)) return path; // check if texture already on disk
+        if (VirtualFileSystem::Exists(path)) return path; // check if texture already on disk or in pack
 
         if (material->GetTextureCount(type) > 0)
         {
@@ -107,25 +250,28 @@ namespace MxEngine
                 const aiTexture* data = scene->GetEmbeddedTexture(filepath);
                 if (data == nullptr) return lookupDirectory / filepath;
 
-                // if texture data is embedded, we need to create a file from it
-                ImageData image;
-                if (data->mHeight == 0.0f) // compressed data (jpg)
-                    image = ImageLoader::LoadImageFromMemory((const uint8_t*)data->pcData, data->mWidth);
-                else
-                    image = ImageLoader::LoadImageFromMemory((const uint8_t*)data->pcData, data->mWidth * data->mHeight * sizeof(aiTexel));
+                // same texture may be referenced by several materials, in this case it is already decoded and stored in cache
+                auto contentHash = HashEmbeddedTexture(data);
+                auto it = cache.PathsByContent.find(contentHash);
+                if (it != cache.PathsByContent.end()) return it->second;
 
-                ImageManager::SaveImage(path, image, PreferredFormat);
+                // if texture data is embedded, we need to create a file from it
+                // decoded image is also kept in memory, so texture pipeline does not read and decode it again
+                ImageData image = DecodeEmbeddedTexture(data);
+                PublishImage(path, image);
+                cache.PathsByContent.emplace(contentHash, path);
+                cache.Images.emplace(MakeStringId(path.string()), std::move(image));
                 return path;
             }
         }
         return FilePath();
     }
 
-    void SplitRoughnessMetallicTexture(const FilePath& lookupDirectory, const MxString& roughness, const MxString& metallic, const aiScene* scene, const aiMaterial* material, aiTextureType metallicRoughnessType)
+    void SplitRoughnessMetallicTexture(const FilePath& lookupDirectory, const MxString& roughness, const MxString& metallic, const aiScene* scene, const aiMaterial* material, aiTextureType metallicRoughnessType, EmbeddedTextureCache& cache)
     {
         auto roughnessPath = lookupDirectory / ToFilePath(roughness + PreferredExtension);
         auto metallicPath = lookupDirectory / ToFilePath(metallic + PreferredExtension);
-        if (File::Exists(metallicPath) && File::Exists(roughnessPath)) return;
+        if (VirtualFileSystem::Exists(metallicPath) && VirtualFileSystem::Exists(roughnessPath)) return;
 
         if (material->GetTextureCount(metallicRoughnessType) > 0)
         {
@@ -140,18 +286,13 @@ namespace MxEngine
                 if (data != nullptr)
                 {
                     // if texture data is embedded, we need to create a file from it
-                    ImageData image;
-                    if (data->mHeight == 0.0f) // compressed data (jpg)
-                        image = ImageLoader::LoadImageFromMemory((const uint8_t*)data->pcData, data->mWidth);
-                    else
-                        image = ImageLoader::LoadImageFromMemory((const uint8_t*)data->pcData, data->mWidth * data->mHeight * sizeof(aiTexel));
-
-                    SaveRoughnessMetallicTexture(image, roughnessPath, metallicPath);
+                    ImageData image = DecodeEmbeddedTexture(data);
+                    SaveRoughnessMetallicTexture(image, roughnessPath, metallicPath, cache);
                 }
                 else
                 {
                     ImageData image = ImageLoader::LoadImage(lookupDirectory / filepath);
-                    SaveRoughnessMetallicTexture(image, roughnessPath, metallicPath);
+                    SaveRoughnessMetallicTexture(image, roughnessPath, metallicPath, cache);
                 }
             }
         }
@@ -162,7 +303,7 @@ namespace MxEngine
         auto directory = filepath.parent_path();
         ObjectInfo object;
 
-        if (!File::Exists(filepath) || !File::IsFile(filepath))
+        if (!VirtualFileSystem::IsFile(filepath))
         {
             MXLOG_ERROR("Assimp::Importer", "file does not exist: " + ToMxString(filepath));
             return object;
@@ -172,10 +313,13 @@ namespace MxEngine
         MAKE_SCOPE_TIMER("MxEngine::ObjectLoader", "ObjectLoader::LoadObject");
         MXLOG_INFO("Assimp::Importer", "loading object from file: " + ToMxString(filepath));
 
-        static Assimp::Importer importer; // TODO: not thread safe
+        // importer owns the loaded scene, so each thread uses its own instance
+        thread_local static Assimp::Importer importer;
+        // importer owns io handler. Files are read from mapped memory instead of assimp own buffered streams
+        if (importer.IsDefaultIOHandler()) importer.SetIOHandler(new VirtualFileIOSystem());
         const aiScene* scene = importer.ReadFile(filepath.string().c_str(), 
             aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_JoinIdenticalVertices |
-            aiProcess_OptimizeMeshes | aiProcess_ImproveCacheLocality | aiProcess_GenUVCoords | aiProcess_CalcTangentSpace);
+            aiProcess_OptimizeMeshes | aiProcess_GenUVCoords | aiProcess_CalcTangentSpace);
         if (scene == nullptr)
         {
             MXLOG_ERROR("Assimp::Importer", importer.GetErrorString());
@@ -184,6 +328,7 @@ namespace MxEngine
 
         object.meshes.resize((size_t)scene->mNumMeshes);
         object.materials.resize((size_t)scene->mNumMaterials);
+        EmbeddedTextureCache textureCache{ { }, object.textures };
 
         for (size_t i = 0; i < object.materials.size(); i++)
         {
@@ -239,18 +384,18 @@ namespace MxEngine
             }
 
             // process first to make sure metallic / roughness will present when checking for existing textures in GetActualTexturePath
-            SplitRoughnessMetallicTexture(directory, MxFormat("{}_{}", RoughnessTexName, i), MxFormat("{}_{}", MetallicTexName, i), scene, material, aiTextureType_UNKNOWN);
+            SplitRoughnessMetallicTexture(directory, MxFormat("{}_{}", RoughnessTexName, i), MxFormat("{}_{}", MetallicTexName, i), scene, material, aiTextureType_UNKNOWN, textureCache);
 
-            materialInfo.AlbedoMap           = GetActualTexturePath(directory, MxFormat("{}_{}", AlbedoTexName,    i), scene, material, aiTextureType_DIFFUSE);
-            materialInfo.EmissiveMap         = GetActualTexturePath(directory, MxFormat("{}_{}", EmissiveTexName,  i), scene, material, aiTextureType_EMISSIVE);
-            materialInfo.HeightMap           = GetActualTexturePath(directory, MxFormat("{}_{}", HeightTexName,    i), scene, material, aiTextureType_HEIGHT);
-            materialInfo.NormalMap           = GetActualTexturePath(directory, MxFormat("{}_{}", NormalTexName,    i), scene, material, aiTextureType_NORMALS);
-            materialInfo.AmbientOcclusionMap = GetActualTexturePath(directory, MxFormat("{}_{}", AOTexName,        i), scene, material, aiTextureType_AMBIENT_OCCLUSION);
-            materialInfo.RoughnessMap        = GetActualTexturePath(directory, MxFormat("{}_{}", RoughnessTexName, i), scene, material, aiTextureType_DIFFUSE_ROUGHNESS);
-            materialInfo.MetallicMap         = GetActualTexturePath(directory, MxFormat("{}_{}", MetallicTexName,  i), scene, material, aiTextureType_METALNESS);
+            materialInfo.AlbedoMap           = GetActualTexturePath(directory, MxFormat("{}_{}", AlbedoTexName,    i), scene, material, aiTextureType_DIFFUSE, textureCache);
+            materialInfo.EmissiveMap         = GetActualTexturePath(directory, MxFormat("{}_{}", EmissiveTexName,  i), scene, material, aiTextureType_EMISSIVE, textureCache);
+            materialInfo.HeightMap           = GetActualTexturePath(directory, MxFormat("{}_{}", HeightTexName,    i), scene, material, aiTextureType_HEIGHT, textureCache);
+            materialInfo.NormalMap           = GetActualTexturePath(directory, MxFormat("{}_{}", NormalTexName,    i), scene, material, aiTextureType_NORMALS, textureCache);
+            materialInfo.AmbientOcclusionMap = GetActualTexturePath(directory, MxFormat("{}_{}", AOTexName,        i), scene, material, aiTextureType_AMBIENT_OCCLUSION, textureCache);
+            materialInfo.RoughnessMap        = GetActualTexturePath(directory, MxFormat("{}_{}", RoughnessTexName, i), scene, material, aiTextureType_DIFFUSE_ROUGHNESS, textureCache);
+            materialInfo.MetallicMap         = GetActualTexturePath(directory, MxFormat("{}_{}", MetallicTexName,  i), scene, material, aiTextureType_METALNESS, textureCache);
 
             // if aiTextureType_AMBIENT_OCCLUSION failed to load, try aiTextureType_LIGHTMAP as alternative, as it also can store ambient occlusion
-            if(materialInfo.AmbientOcclusionMap.empty()) materialInfo.AmbientOcclusionMap = GetActualTexturePath(directory, MxFormat("{}_{}", AOTexName, i), scene, material, aiTextureType_LIGHTMAP);
+            if(materialInfo.AmbientOcclusionMap.empty()) materialInfo.AmbientOcclusionMap = GetActualTexturePath(directory, MxFormat("{}_{}", AOTexName, i), scene, material, aiTextureType_LIGHTMAP, textureCache);
 
             // if emmision texture provided, set emmision to some non-zero value
             if (!materialInfo.EmissiveMap.empty() && materialInfo.Emission == 0.0f) materialInfo.Emission = 1.0f;
@@ -322,6 +467,8 @@ namespace MxEngine
             if (meshInfo.name.empty())
                 meshInfo.name = UUIDGenerator::Get();
             meshInfo.useTexture = true;
+            MeshOptimizer::Optimize(vertex, meshInfo.indicies);
+            meshInfo.meshlets = MeshletBuilder::Build(vertex, meshInfo.indicies);
             meshInfo.vertecies = std::move(vertex);
         }
         importer.FreeScene();
@@ -329,11 +476,22 @@ namespace MxEngine
         return object;
     }
 
+    MxVector<std::future<ObjectInfo>> ObjectLoader::LoadMany(ArrayView<FilePath> paths)
+    {
+        MxVector<std::future<ObjectInfo>> result;
+        result.reserve(paths.size());
+        for (const auto& path : paths)
+        {
+            result.push_back(ThreadPool::Submit([path]() { return ObjectLoader::Load(path); }));
+        }
+        return result;
+    }
+
     MaterialLibrary ObjectLoader::LoadMaterials(const FilePath& path)
     {
         MaterialLibrary materials;
 
-        File file(path);
+        MappedFile file(path);
         if (!file.IsOpen())
         {
             MXLOG_ERROR("MxEngine::ObjectLoader", "cannot open file: " + ToMxString(path));
@@ -376,7 +534,6 @@ namespace MxEngine
     void ObjectLoader::DumpMaterials(const MaterialLibrary& materials, const FilePath& path)
     {
         JsonFile json;
-        File file(path, File::WRITE);
         MXLOG_INFO("MxEngine::ObjectLoader", "dumping materials to file: " + ToMxString(path));
 
         #define DUMP(index, name) json[index][#name] = materials[index].name
@@ -404,6 +561,64 @@ namespace MxEngine
             DUMP(i, Name);
         }
 
-        SaveJson(file, json);
+        // the same material library may be dumped by several loaders at once, so file is replaced atomically
+        auto temporaryPath = GetTemporaryPath(path);
+        {
+            File file(temporaryPath, File::WRITE);
+            SaveJson(file, json);
+        }
+        ReplaceWithTemporary(temporaryPath, path);
+    }
+
+    static size_t GetUncompressedByteSize(const CookedTexture& texture)
+    {
+        size_t byteSize = 0;
+        for (size_t mip = 0; mip < texture.Mips.size(); mip++)
+        {
+            size_t width = Max(texture.Width >> mip, (size_t)1);
+            size_t height = Max(texture.Height >> mip, (size_t)1);
+            byteSize += width * height * 4;
+        }
+        return byteSize;
+    }
+
+    TextureCookingInfo ObjectLoader::CookTextures(const MaterialLibrary& materials, const MxHashMap<StringId, ImageData>& decodedImages)
+    {
+        MAKE_SCOPE_PROFILER("ObjectLoader::CookTextures");
+        MAKE_SCOPE_TIMER("MxEngine::ObjectLoader", "ObjectLoader::CookTextures()");
+
+        TextureCookingInfo info;
+        MxHashSet<StringId> cookedTextures;
+        auto cook = [&info, &cookedTextures, &decodedImages](const FilePath& path, TextureUsage usage)
+        {
+            if (path.empty()) return;
+            auto id = MakeStringId(path.string());
+            if (!cookedTextures.insert(id).second) return;
+
+            auto it = decodedImages.find(id);
+            auto texture = it != decodedImages.end() ? TextureCooker::LoadCooked(path, it->second, usage) : TextureCooker::LoadCooked(path, usage);
+            if (texture.Mips.empty()) return;
+
+            info.TextureCount++;
+            info.UncompressedByteSize += GetUncompressedByteSize(texture);
+            for (const auto& mip : texture.Mips)
+                info.CookedByteSize += mip.size();
+        };
+
+        // usages follow the way material textures are sampled by renderer
+        for (const auto& material : materials)
+        {
+            cook(material.AlbedoMap, TextureUsage::COLOR);
+            cook(material.NormalMap, TextureUsage::NORMAL);
+            cook(material.EmissiveMap, TextureUsage::MASK);
+            cook(material.HeightMap, TextureUsage::MASK);
+            cook(material.AmbientOcclusionMap, TextureUsage::MASK);
+            cook(material.MetallicMap, TextureUsage::MASK);
+            cook(material.RoughnessMap, TextureUsage::MASK);
+        }
+
+        MXLOG_INFO("MxEngine::ObjectLoader", MxFormat("cooked {} textures: {} KB instead of {} KB uncompressed",
+            info.TextureCount, info.CookedByteSize / 1024, info.UncompressedByteSize / 1024));
+        return info;
     }
-}
\ No newline at end of file
+}
@@ -29,14 +29,18 @@
 #pragma once
 
 #include <sstream>
+#include <future>
 
 #include "Utilities/Math/Math.h"
 #include "Core/BoundingObjects/AABB.h"
 #include "Utilities/STL/MxHashMap.h"
 #include "Utilities/STL/MxString.h"
 #include "Utilities/STL/MxVector.h"
+#include "Utilities/String/String.h"
+#include "Utilities/Image/Image.h"
 #include "Core/Resources/MeshData.h"
 #include "Utilities/FileSystem/File.h"
+#include "Utilities/Array/ArrayView.h"
 
 namespace MxEngine
 {
@@ -131,6 +135,10 @@ namespace MxEngine
         */
         MxVector<uint32_t> indicies;        
         /*!
+        clusters of mesh triangles used for culling. Index ranges are relative to indicies buffer
+        */
+        MxVector<Meshlet> meshlets;
+        /*!
         mesh material pointer (to external table passed with MeshInfo inside ObjectInfo)
         */
         MaterialInfo* material = nullptr;
@@ -160,6 +168,31 @@ namespace MxEngine
         list of all object meshes. For more info see MeshInfo documentation
         */
         MxVector<MeshInfo> meshes;
+        /*!
+        textures decoded while loading object (embedded ones and split metallic / roughness maps), keyed by StringId of their path in MaterialInfo.
+        Texture pipeline takes them directly instead of reading saved copies back from disk. Textures extracted by previous loads are not
+        decoded again, so they are absent here and are read from their raw files
+        */
+        MxHashMap<StringId, ImageData> textures;
+    };
+
+    /*!
+    statistics of textures cooked for object materials, see ObjectLoader::CookTextures
+    */
+    struct TextureCookingInfo
+    {
+        /*!
+        number of distinct textures cooked or taken from cache
+        */
+        size_t TextureCount = 0;
+        /*!
+        GPU memory which textures with full mip chains would take if uploaded as RGBA8
+        */
+        size_t UncompressedByteSize = 0;
+        /*!
+        GPU memory which cooked textures take
+        */
+        size_t CookedByteSize = 0;
     };
 
     /*!
@@ -173,10 +206,23 @@ namespace MxEngine
         loads object from disk by its file path
         \param path absoulute or relative to executable folder path to a file to load
         \returns ObjectInfo instance
-        \warning this function is not thread safe
         */
         static ObjectInfo Load(const FilePath& path);
+        /*
+        loads several objects in parallel using engine thread pool
+        \param paths absoulute or relative to executable folder paths to files to load
+        \returns futures of ObjectInfo instances, in the same order as paths
+        */
+        static MxVector<std::future<ObjectInfo>> LoadMany(ArrayView<FilePath> paths);
         static MaterialLibrary LoadMaterials(const FilePath& path);
         static void DumpMaterials(const MaterialLibrary& materials, const FilePath& path);
+        /*!
+        cooks all textures referenced by materials, so they are ready to be uploaded to GPU (see TextureCooker).
+        Textures shared by several materials are cooked once, images decoded by Load are taken from memory
+        \param materials materials which textures should be cooked
+        \param decodedImages images decoded while loading object (see ObjectInfo::textures)
+        \returns statistics of cooked textures
+        */
+        static TextureCookingInfo CookTextures(const MaterialLibrary& materials, const MxHashMap<StringId, ImageData>& decodedImages);
     };
 }
\ No newline at end of file
@@ -29,6 +29,7 @@
 #include "ShaderPreprocessor.h"
 #include "Utilities/STL/MxVector.h"
 #include "Utilities/Logging/Logger.h"
+#include "Utilities/FileSystem/VirtualFileSystem.h"
 #include <regex>
 
 namespace MxEngine
@@ -68,7 +69,7 @@ namespace MxEngine
         for (const auto& [path, include] : paths)
         {
             auto filepath = lookupPath / path.c_str();
-            if (!File::Exists(filepath))
+            if (!VirtualFileSystem::Exists(filepath))
             {
                 MXLOG_ERROR("ShaderPreprocessor::LoadIncludes", "included file was not found: " + path);
                 return *this;
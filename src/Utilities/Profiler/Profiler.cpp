@@ -29,6 +29,8 @@
 #include "Profiler.h"
 #include "Utilities/STL/MxString.h"
 
+#include <thread>
+
 namespace MxEngine
 {
     void ProfileSession::WriteJsonHeader()
@@ -66,6 +68,9 @@ namespace MxEngine
     {
         if (!this->IsValid()) return;
 
+        size_t threadId = std::hash<std::thread::id>{ }(std::this_thread::get_id());
+        std::lock_guard<std::mutex> lock(this->mutex);
+
         if (this->GetEntryCount() > 0)
         {
             output << ",\n";
@@ -74,7 +79,7 @@ namespace MxEngine
 
         output << "    {";
         output << "\"pid\": 0, ";
-        output << "\"tid\": 0, ";
+        output << "\"tid\": " << std::to_string(threadId) << ", ";
         output << "\"ts\": " << std::to_string(uint64_t((double)begin * 1000000)) << ", ";
         output << "\"dur\": " << std::to_string(uint64_t((double)delta * 1000000)) << ", ";
         output << "\"ph\": \"X\", ";
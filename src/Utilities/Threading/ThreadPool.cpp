@@ -0,0 +1,187 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "ThreadPool.h"
+#include "Utilities/Logging/Logger.h"
+#include "Utilities/Format/Format.h"
+
+namespace MxEngine
+{
+    thread_local static bool isWorkerThread = false;
+
+    void ThreadPool::WorkerLoop(ThreadPoolImpl* pool)
+    {
+        isWorkerThread = true;
+        while (true)
+        {
+            ThreadPoolImpl::Task task;
+            bool isBackground = false;
+            {
+                std::unique_lock<std::mutex> lock(pool->mutex);
+                auto hasBackgroundTask = [pool]()
+                {
+                    return !pool->backgroundTasks.empty() && pool->runningBackgroundCount < pool->maxBackgroundCount;
+                };
+                pool->condition.wait(lock, [pool, &hasBackgroundTask]() { return pool->isStopped || !pool->tasks.empty() || hasBackgroundTask(); });
+
+                // regular tasks always go first, background ones are executed only when there is nothing else to do
+                if (!pool->tasks.empty())
+                {
+                    task = std::move(pool->tasks.front());
+                    pool->tasks.pop_front();
+                }
+                else if (hasBackgroundTask())
+                {
+                    task = std::move(pool->backgroundTasks.front());
+                    pool->backgroundTasks.pop_front();
+                    pool->runningBackgroundCount++;
+                    isBackground = true;
+                }
+                else return; // pool is stopped and all runnable tasks are done
+            }
+            task();
+
+            if (isBackground)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(pool->mutex);
+                    pool->runningBackgroundCount--;
+                }
+                // slot for background task is free, some other worker may be waiting for it
+                pool->condition.notify_one();
+            }
+        }
+    }
+
+    void ThreadPool::Enqueue(ThreadPoolImpl::Task task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(impl->mutex);
+            impl->tasks.push_back(std::move(task));
+        }
+        impl->condition.notify_one();
+    }
+
+    void ThreadPool::EnqueueBackground(ThreadPoolImpl::Task task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(impl->mutex);
+            impl->backgroundTasks.push_back(std::move(task));
+        }
+        impl->condition.notify_one();
+    }
+
+    bool ThreadPool::ExecuteWaitedTask()
+    {
+        if (ThreadPool::ExecutePendingTask()) return true;
+        if (!impl->workers.empty()) return false;
+
+        // without workers nobody else would execute background tasks, so waiting thread has to
+        ThreadPoolImpl::Task task;
+        {
+            std::lock_guard<std::mutex> lock(impl->mutex);
+            if (impl->backgroundTasks.empty()) return false;
+
+            task = std::move(impl->backgroundTasks.front());
+            impl->backgroundTasks.pop_front();
+        }
+        task();
+        return true;
+    }
+
+    bool ThreadPool::ExecutePendingTask()
+    {
+        ThreadPoolImpl::Task task;
+        {
+            std::lock_guard<std::mutex> lock(impl->mutex);
+            if (impl->tasks.empty()) return false;
+
+            task = std::move(impl->tasks.front());
+            impl->tasks.pop_front();
+        }
+        task();
+        return true;
+    }
+
+    void ThreadPool::Init()
+    {
+        // main thread also participates in task execution, so one hardware thread is left for it
+        ThreadPool::Init(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    }
+
+    void ThreadPool::Init(size_t workerCount)
+    {
+        impl = Alloc<ThreadPoolImpl>();
+        // one worker is always left for regular tasks, unless there is only one
+        impl->maxBackgroundCount = std::max(workerCount, size_t(2)) - 1;
+
+        impl->workers.reserve(workerCount);
+        for (size_t i = 0; i < workerCount; i++)
+        {
+            impl->workers.emplace_back(&ThreadPool::WorkerLoop, impl);
+        }
+        MXLOG_INFO("MxEngine::ThreadPool", MxFormat("created {0} worker threads", workerCount));
+    }
+
+    void ThreadPool::Destroy()
+    {
+        if (impl == nullptr) return;
+        {
+            std::lock_guard<std::mutex> lock(impl->mutex);
+            impl->isStopped = true;
+        }
+        impl->condition.notify_all();
+        for (auto& worker : impl->workers)
+        {
+            worker.join();
+        }
+        Free(impl);
+        impl = nullptr;
+    }
+
+    size_t ThreadPool::GetWorkerCount()
+    {
+        return impl->workers.size();
+    }
+
+    bool ThreadPool::IsWorkerThread()
+    {
+        return isWorkerThread;
+    }
+
+    ThreadPoolImpl* ThreadPool::GetImpl()
+    {
+        return impl;
+    }
+
+    void ThreadPool::Clone(ThreadPoolImpl* other)
+    {
+        impl = other;
+    }
+}
@@ -0,0 +1,176 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <deque>
+#include <algorithm>
+
+#include "Utilities/STL/MxVector.h"
+#include "Utilities/STL/MxFunction.h"
+#include "Utilities/Memory/Memory.h"
+#include "Utilities/Memory/ScratchStack.h"
+
+namespace MxEngine
+{
+    struct ThreadPoolImpl
+    {
+        using Task = MxFunction<void()>;
+
+        MxVector<std::thread> workers;
+        std::deque<Task> tasks;
+        std::deque<Task> backgroundTasks;
+        std::mutex mutex;
+        std::condition_variable condition;
+        size_t runningBackgroundCount = 0;
+        size_t maxBackgroundCount = 0;
+        bool isStopped = false;
+    };
+
+    /*!
+    thread pool is a global set of worker threads which execute engine tasks in background.
+    Tasks are executed in FIFO order. Thread which waits for submitted tasks (see ParallelFor and Wait) helps executing pending ones,
+    so it is safe to submit new tasks from inside of other task without deadlocking the pool.
+    Long-running background tasks (see SubmitBackground) are kept in separate queue: they are executed only by workers, never by waiting thread,
+    run after all regular tasks and never occupy all workers at once, so per-frame work is not stalled by asset loading
+    */
+    class ThreadPool
+    {
+        inline static ThreadPoolImpl* impl = nullptr;
+
+        static void WorkerLoop(ThreadPoolImpl* pool);
+        static void Enqueue(ThreadPoolImpl::Task task);
+        static void EnqueueBackground(ThreadPoolImpl::Task task);
+        static bool ExecuteWaitedTask();
+    public:
+        static void Init();
+        /*!
+        creates thread pool with fixed number of worker threads. With zero workers all tasks are executed by waiting thread
+        \param workerCount number of worker threads to create
+        */
+        static void Init(size_t workerCount);
+        static void Destroy();
+        static size_t GetWorkerCount();
+        static bool IsWorkerThread();
+        /*!
+        pops and executes one pending task on the calling thread. Background tasks are never executed by this function
+        \returns true if task was executed, false if queue was empty
+        */
+        static bool ExecutePendingTask();
+
+        /*!
+        waits until future is ready, executing pending tasks on the calling thread meanwhile
+        \param future future returned by Submit
+        \returns result of the task. If task thrown exception, it is rethrown here
+        */
+        template<typename T>
+        static T Wait(std::future<T>& future)
+        {
+            while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                if (!ThreadPool::ExecuteWaitedTask())
+                    std::this_thread::yield();
+            }
+            return future.get();
+        }
+
+        /*!
+        schedules task for execution on one of the worker threads
+        \param func callable object without arguments
+        \returns future which becomes ready when task is executed
+        */
+        template<typename F>
+        static auto Submit(F&& func) -> std::future<decltype(func())>
+        {
+            using ResultType = decltype(func());
+            auto task = MakeRef<std::packaged_task<ResultType()>>(std::forward<F>(func));
+            auto future = task->get_future();
+            ThreadPool::Enqueue([task = std::move(task)]() { (*task)(); });
+            return future;
+        }
+
+        /*!
+        schedules long-running low priority task (i.e. asset loading) for execution on one of the worker threads.
+        Unlike Submit, task is not picked up by threads waiting in ParallelFor or Wait, so it cannot stall them
+        \param func callable object without arguments
+        \returns future which becomes ready when task is executed. Result should be polled, not waited for, as waiting does not speed task up
+        */
+        template<typename F>
+        static auto SubmitBackground(F&& func) -> std::future<decltype(func())>
+        {
+            using ResultType = decltype(func());
+            auto task = MakeRef<std::packaged_task<ResultType()>>(std::forward<F>(func));
+            auto future = task->get_future();
+            ThreadPool::EnqueueBackground([task = std::move(task)]() { (*task)(); });
+            return future;
+        }
+
+        /*!
+        splits range [0, count) into chunks of at least grainSize elements and processes them in parallel.
+        Calling thread also processes chunks and returns only when all of them are done
+        \param count number of elements to process
+        \param grainSize minimal number of elements in a single chunk
+        \param func callable object with signature `void(size_t begin, size_t end)`
+        */
+        template<typename F>
+        static void ParallelFor(size_t count, size_t grainSize, F&& func)
+        {
+            if (count == 0) return;
+
+            grainSize = std::max(grainSize, size_t(1));
+            size_t maxChunks = ThreadPool::GetWorkerCount() + 1;
+            size_t chunkCount = std::min((count + grainSize - 1) / grainSize, maxChunks);
+            if (chunkCount <= 1)
+            {
+                func(size_t(0), count);
+                return;
+            }
+
+            size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+            ScratchArray<std::future<void>> chunks((count - 1) / chunkSize);
+            for (size_t i = 0; i < chunks.size(); i++)
+            {
+                size_t begin = (i + 1) * chunkSize;
+                size_t end = std::min(begin + chunkSize, count);
+                chunks[i] = ThreadPool::Submit([&func, begin, end]() { func(begin, end); });
+            }
+            func(size_t(0), chunkSize);
+
+            for (auto& chunk : chunks)
+                ThreadPool::Wait(chunk);
+        }
+
+        static ThreadPoolImpl* GetImpl();
+        static void Clone(ThreadPoolImpl* other);
+    };
+}
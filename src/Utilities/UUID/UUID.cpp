@@ -53,6 +53,7 @@ namespace MxEngine
     UUID UUIDGenerator::Get()
     {
         UUID uuid;
+        std::lock_guard<std::mutex> lock(storage->mutex);
         uuid.GetImpl() = storage->GetGeneratorImpl()();
         return uuid;
     }
@@ -31,6 +31,7 @@
 #include <utility>
 #include <ostream>
 #include <random>
+#include <mutex>
 
 #include "Utilities/STL/MxString.h"
 #include "Utilities/Random/Random.h"
@@ -69,6 +70,7 @@ namespace MxEngine
     {
         using type = uuids::basic_uuid_random_generator<Random::Generator>;
         std::aligned_storage_t<24> generator;
+        std::mutex mutex;
         type& GetGeneratorImpl();
     };
 
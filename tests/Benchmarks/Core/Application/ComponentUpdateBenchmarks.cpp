@@ -0,0 +1,160 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/BenchmarkFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Core/Application/ComponentUpdateScheduler.h"
+#include "Core/Runtime/Reflection.h"
+#include "Utilities/ECS/Component.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/UUID/UUID.h"
+
+#include <cmath>
+#include <tuple>
+
+// every component type does a bit of independent math, similar to simple gameplay or animation components
+#define MX_DEFINE_BENCHMARK_COMPONENT(class_name)\
+    class class_name\
+    {\
+        MAKE_COMPONENT(class_name);\
+    public:\
+        class_name() = default;\
+        float Phase = 0.0f;\
+        float Value = 0.0f;\
+        void OnUpdate(TimeStep dt)\
+        {\
+            this->Phase += dt;\
+            this->Value = std::sin(this->Phase) * 0.5f + this->Value * 0.5f;\
+        }\
+    }
+
+#define MX_REFLECT_BENCHMARK_COMPONENT(class_name)\
+    rttr::registration::class_<class_name>(#class_name)\
+        (\
+            rttr::metadata(UpdateInfo::READS, ComponentTypes<>()),\
+            rttr::metadata(UpdateInfo::PARALLEL, true)\
+        )
+
+namespace MxEngine
+{
+    MX_DEFINE_BENCHMARK_COMPONENT(BenchmarkComponent0);
+    MX_DEFINE_BENCHMARK_COMPONENT(BenchmarkComponent1);
+    MX_DEFINE_BENCHMARK_COMPONENT(BenchmarkComponent2);
+    MX_DEFINE_BENCHMARK_COMPONENT(BenchmarkComponent3);
+    MX_DEFINE_BENCHMARK_COMPONENT(BenchmarkComponent4);
+    MX_DEFINE_BENCHMARK_COMPONENT(BenchmarkComponent5);
+    MX_DEFINE_BENCHMARK_COMPONENT(BenchmarkComponent6);
+    MX_DEFINE_BENCHMARK_COMPONENT(BenchmarkComponent7);
+    MX_DEFINE_BENCHMARK_COMPONENT(BenchmarkComponent8);
+    MX_DEFINE_BENCHMARK_COMPONENT(BenchmarkComponent9);
+
+    MXENGINE_REFLECT_TYPE
+    {
+        MX_REFLECT_BENCHMARK_COMPONENT(BenchmarkComponent0);
+        MX_REFLECT_BENCHMARK_COMPONENT(BenchmarkComponent1);
+        MX_REFLECT_BENCHMARK_COMPONENT(BenchmarkComponent2);
+        MX_REFLECT_BENCHMARK_COMPONENT(BenchmarkComponent3);
+        MX_REFLECT_BENCHMARK_COMPONENT(BenchmarkComponent4);
+        MX_REFLECT_BENCHMARK_COMPONENT(BenchmarkComponent5);
+        MX_REFLECT_BENCHMARK_COMPONENT(BenchmarkComponent6);
+        MX_REFLECT_BENCHMARK_COMPONENT(BenchmarkComponent7);
+        MX_REFLECT_BENCHMARK_COMPONENT(BenchmarkComponent8);
+        MX_REFLECT_BENCHMARK_COMPONENT(BenchmarkComponent9);
+    }
+}
+
+using namespace MxEngine;
+using namespace MxEngine::Benchmarks;
+using MxEngine::Tests::ModuleScope;
+
+using SchedulerModules = ModuleScope<UUIDGenerator, ThreadPool, ComponentFactory>;
+
+template<typename... Components>
+struct BenchmarkScene
+{
+    std::tuple<MxVector<typename Components::Handle>...> handles;
+
+    explicit BenchmarkScene(size_t componentsPerType)
+    {
+        (..., BenchmarkScene::Populate<Components>(componentsPerType));
+    }
+
+    template<typename T>
+    void Populate(size_t count)
+    {
+        auto& list = std::get<MxVector<typename T::Handle>>(this->handles);
+        for (size_t i = 0; i < count; i++)
+            list.push_back(ComponentFactory::CreateComponent<T>());
+    }
+
+    // matches engine behaviour before update scheduling: views are updated one after another on the main thread
+    static void UpdateSerial(TimeStep dt)
+    {
+        (..., BenchmarkScene::UpdateView<Components>(dt));
+    }
+
+    template<typename T>
+    static void UpdateView(TimeStep dt)
+    {
+        for (auto& component : ComponentFactory::GetView<T>())
+            component.OnUpdate(dt);
+    }
+
+    static void Register(ComponentUpdateScheduler& scheduler)
+    {
+        (..., scheduler.RegisterUpdate<Components>(rttr::type::get<Components>()));
+    }
+};
+
+using TenComponentScene = BenchmarkScene<
+    BenchmarkComponent0, BenchmarkComponent1, BenchmarkComponent2, BenchmarkComponent3, BenchmarkComponent4,
+    BenchmarkComponent5, BenchmarkComponent6, BenchmarkComponent7, BenchmarkComponent8, BenchmarkComponent9
+>;
+
+MX_BENCHMARK(ComponentUpdateSerial, 10000, 100000)
+{
+    SchedulerModules modules;
+    TenComponentScene scene(state.GetArgument());
+
+    state.Run([]() { TenComponentScene::UpdateSerial(0.016f); });
+    state.SetItemsPerIteration(state.GetArgument() * 10);
+}
+
+MX_BENCHMARK(ComponentUpdateScheduled, 10000, 100000)
+{
+    SchedulerModules modules;
+    TenComponentScene scene(state.GetArgument());
+    ComponentUpdateScheduler scheduler;
+    TenComponentScene::Register(scheduler);
+
+    state.Run([&scheduler]() { scheduler.Invoke(0.016f); });
+    state.SetItemsPerIteration(state.GetArgument() * 10);
+    state.AddCounter("stages", (double)scheduler.GetStageCount());
+    state.AddCounter("workers", (double)ThreadPool::GetWorkerCount());
+}
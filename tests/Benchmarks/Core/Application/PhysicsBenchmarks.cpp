@@ -0,0 +1,178 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Framework/BenchmarkFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Core/Application/Physics.h"
+#include "Core/Components/Physics/RigidBody.h"
+#include "Core/Components/Physics/SphereCollider.h"
+#include "Core/MxObject/MxObject.h"
+#include "Platform/Modules/PhysicsModule.h"
+#include "Platform/PhysicsAPI.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/UUID/UUID.h"
+
+#include <random>
+
+using namespace MxEngine;
+using namespace MxEngine::Benchmarks;
+using MxEngine::Tests::ModuleScope;
+
+// objects are destroyed first, so their rigid bodies are removed from the world before physics module is destroyed
+using PhysicsModules = ModuleScope<UUIDGenerator, ThreadPool, PhysicsModule, ComponentFactory,
+    Factory<SphereShape>, Factory<NativeRigidBody>, Factory<MxObject>>;
+
+namespace
+{
+    constexpr size_t WorldGridSize = 100; // 10k bodies
+    constexpr float WorldSpacing = 2.0f;
+    constexpr float WorldExtent = WorldGridSize * WorldSpacing;
+    constexpr float BodyRadius = 0.5f;
+    constexpr float MaxRayLength = 20.0f;
+
+    /*!
+    creates grid of static spheres with random heights and synchronizes them with physics world, as first frame of application does
+    */
+    void CreateStaticWorld()
+    {
+        std::mt19937 random(42);
+        std::uniform_real_distribution<float> height(0.0f, 4.0f);
+
+        for (size_t x = 0; x < WorldGridSize; x++)
+        {
+            for (size_t z = 0; z < WorldGridSize; z++)
+            {
+                auto object = MxObject::Create();
+                object->LocalTransform.SetPosition(MakeVector3(x * WorldSpacing, height(random), z * WorldSpacing));
+                auto collider = object->AddComponent<SphereCollider>();
+                collider->SetBoundingSphere(BoundingSphere(MakeVector3(0.0f), BodyRadius));
+                auto rigidBody = object->AddComponent<RigidBody>();
+                rigidBody->MakeStatic();
+            }
+        }
+        RigidBody::SyncObjectStates();
+    }
+
+    /*!
+    generates gameplay-like rays: each starts above the world and points downwards in random direction, length is limited like weapon or sensor range
+    */
+    MxVector<Ray> GenerateRays(size_t count)
+    {
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> position(0.0f, WorldExtent);
+        std::uniform_real_distribution<float> offset(-MaxRayLength, MaxRayLength);
+
+        MxVector<Ray> rays(count);
+        for (auto& ray : rays)
+        {
+            ray.From = MakeVector3(position(random), 8.0f, position(random));
+            ray.To = ray.From + MakeVector3(offset(random), -10.0f, offset(random));
+        }
+        return rays;
+    }
+
+    MxVector<BoundingSphere> GenerateSpheres(size_t count)
+    {
+        std::mt19937 random(2);
+        std::uniform_real_distribution<float> position(0.0f, WorldExtent);
+        std::uniform_real_distribution<float> height(0.0f, 4.0f);
+
+        MxVector<BoundingSphere> spheres(count);
+        for (auto& sphere : spheres)
+            sphere = BoundingSphere(MakeVector3(position(random), height(random), position(random)), 2.0f);
+        return spheres;
+    }
+}
+
+MX_BENCHMARK(RayCastSingle, 10000)
+{
+    PhysicsModules modules;
+    CreateStaticWorld();
+    auto rays = GenerateRays(state.GetArgument());
+
+    size_t hitCount = 0;
+    state.Run([&]()
+    {
+        hitCount = 0;
+        for (const auto& ray : rays)
+        {
+            float fraction = 1.0f;
+            auto object = Physics::RayCast(ray.From, ray.To, fraction);
+            hitCount += object.IsValid() ? 1 : 0;
+        }
+        DoNotOptimize(hitCount);
+    });
+    state.SetItemsPerIteration(rays.size());
+    state.AddCounter("bodies", double(WorldGridSize * WorldGridSize));
+    state.AddCounter("hit rays %", 100.0 * hitCount / rays.size());
+}
+
+MX_BENCHMARK(RayCastBatch, 10000)
+{
+    PhysicsModules modules;
+    CreateStaticWorld();
+    auto rays = GenerateRays(state.GetArgument());
+    MxVector<RayHit> hits(rays.size());
+
+    state.Run([&]()
+    {
+        Physics::RayCastBatch(rays, hits);
+        DoNotOptimize(hits.data());
+    });
+
+    size_t hitCount = 0;
+    for (const auto& hit : hits)
+        hitCount += hit.Object.IsValid() ? 1 : 0;
+
+    state.SetItemsPerIteration(rays.size());
+    state.AddCounter("bodies", double(WorldGridSize * WorldGridSize));
+    state.AddCounter("hit rays %", 100.0 * hitCount / rays.size());
+    state.AddCounter("threads", double(ThreadPool::GetWorkerCount() + 1));
+}
+
+MX_BENCHMARK(OverlapSphereBatch, 10000)
+{
+    PhysicsModules modules;
+    CreateStaticWorld();
+    auto spheres = GenerateSpheres(state.GetArgument());
+    MxVector<MxVector<MxObject::Handle>> overlaps(spheres.size());
+
+    state.Run([&]()
+    {
+        Physics::OverlapSphereBatch(spheres, overlaps);
+        DoNotOptimize(overlaps.data());
+    });
+
+    size_t overlapCount = 0;
+    for (const auto& objects : overlaps)
+        overlapCount += objects.size();
+
+    state.SetItemsPerIteration(spheres.size());
+    state.AddCounter("bodies", double(WorldGridSize * WorldGridSize));
+    state.AddCounter("overlaps/query", double(overlapCount) / spheres.size());
+}
@@ -0,0 +1,62 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/BenchmarkFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Core/Application/TimerScheduler.h"
+
+using namespace MxEngine;
+using namespace MxEngine::Benchmarks;
+using MxEngine::Tests::ModuleScope;
+
+MX_BENCHMARK(TimerSchedulerFrame, 10000, 100000)
+{
+    ModuleScope<TimerScheduler> modules;
+    constexpr float FrameTime = 1.0f / 60.0f;
+    // each timer fires once in 100 frames, and timers are spread evenly between frames, so 1% of them fire per frame
+    constexpr size_t FramesPerPeriod = 100;
+    const size_t timerCount = state.GetArgument();
+
+    size_t fireCount = 0;
+    auto callback = [&fireCount]() { fireCount++; };
+    for (size_t frame = 0; frame < FramesPerPeriod; frame++)
+    {
+        for (size_t i = 0; i < timerCount / FramesPerPeriod; i++)
+            TimerScheduler::Schedule(callback, TimerMode::UPDATE_EACH_DELTA, FramesPerPeriod * FrameTime);
+        TimerScheduler::OnUpdate(FrameTime);
+    }
+
+    size_t frameCount = 0;
+    fireCount = 0;
+    state.Run([&frameCount]() { TimerScheduler::OnUpdate(FrameTime); frameCount++; });
+
+    state.SetItemsPerIteration(timerCount);
+    state.AddCounter("pending", (double)TimerScheduler::GetScheduledCount());
+    state.AddCounter("fired/frame", (double)fireCount / (double)frameCount);
+}
@@ -0,0 +1,126 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Framework/BenchmarkFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Core/Components/Physics/RigidBody.h"
+#include "Core/Components/Physics/SphereCollider.h"
+#include "Core/MxObject/MxObject.h"
+#include "Platform/Bullet3/Bullet3Utils.h"
+#include "Platform/Modules/PhysicsModule.h"
+#include "Platform/PhysicsAPI.h"
+#include "Utilities/Memory/FrameAllocator.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/UUID/UUID.h"
+
+#include <cmath>
+
+using namespace MxEngine;
+using namespace MxEngine::Benchmarks;
+using MxEngine::Tests::ModuleScope;
+
+// objects are destroyed first, so their rigid bodies are removed from the world before physics module is destroyed
+using PhysicsModules = ModuleScope<UUIDGenerator, ThreadPool, FrameAllocator, PhysicsModule, ComponentFactory,
+    Factory<SphereShape>, Factory<NativeRigidBody>, Factory<MxObject>>;
+
+namespace
+{
+    constexpr size_t AwakeBodyPeriod = 20; // every 20th body is awake, 5% total
+    constexpr float BodySpacing = 2.0f;
+
+    /*!
+    creates separated dynamic spheres. Most of them are put to sleep, the rest never deactivate, like bodies which were recently hit
+    */
+    void CreateMostlySleepingWorld(size_t bodyCount)
+    {
+        size_t gridSize = (size_t)std::ceil(std::sqrt((float)bodyCount));
+        for (size_t i = 0; i < bodyCount; i++)
+        {
+            auto object = MxObject::Create();
+            object->LocalTransform.SetPosition(MakeVector3((i % gridSize) * BodySpacing, 0.0f, (i / gridSize) * BodySpacing));
+            auto collider = object->AddComponent<SphereCollider>();
+            collider->SetBoundingSphere(BoundingSphere(MakeVector3(0.0f), 0.5f));
+            auto rigidBody = object->AddComponent<RigidBody>();
+            rigidBody->MakeDynamic();
+            rigidBody->SetGravity(MakeVector3(0.0f));
+        }
+
+        // first synchronization teleports bodies to their objects and wakes them up, so activation state is set after it
+        RigidBody::SyncObjectStates();
+        size_t index = 0;
+        for (auto& rigidBody : ComponentFactory::GetView<RigidBody>())
+        {
+            bool isAwake = index++ % AwakeBodyPeriod == 0;
+            rigidBody.SetActivationState(isAwake ? ActivationState::DISABLE_DEACTIVATION : ActivationState::ISLAND_SLEEPING);
+        }
+    }
+
+    /*!
+    reference per-component synchronization: every body re-tests its collider and copies its transform from physics world, even if it sleeps
+    */
+    void SyncPerComponent()
+    {
+        for (auto& rigidBody : ComponentFactory::GetView<RigidBody>())
+        {
+            rigidBody.SyncObjectState();
+            if (rigidBody.IsKinematic()) continue;
+
+            auto& self = MxObject::GetByComponent(rigidBody);
+            FromBulletTransform(self.LocalTransform, rigidBody.GetNativeHandle()->GetNativeHandle()->getWorldTransform());
+            self.LocalTransform.SetChangedFlag(false);
+        }
+    }
+
+    // simulation step is excluded, only synchronization of objects around it is measured
+    void SyncBulk()
+    {
+        FrameAllocator::OnFrameBegin();
+        RigidBody::SyncObjectStates();
+        RigidBody::FetchActiveTransforms();
+    }
+}
+
+MX_BENCHMARK(RigidBodySyncPerComponent, 50000)
+{
+    PhysicsModules modules;
+    CreateMostlySleepingWorld(state.GetArgument());
+
+    state.Run([]() { SyncPerComponent(); });
+    state.SetItemsPerIteration(state.GetArgument());
+    state.AddCounter("awake %", 100.0 / AwakeBodyPeriod);
+}
+
+MX_BENCHMARK(RigidBodySyncBulk, 50000)
+{
+    PhysicsModules modules;
+    CreateMostlySleepingWorld(state.GetArgument());
+
+    state.Run([]() { SyncBulk(); });
+    state.SetItemsPerIteration(state.GetArgument());
+    state.AddCounter("awake %", 100.0 / AwakeBodyPeriod);
+}
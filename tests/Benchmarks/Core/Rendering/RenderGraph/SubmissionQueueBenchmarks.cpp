@@ -0,0 +1,147 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/BenchmarkFramework.h"
+#include "Framework/FakeStagingDevice.h"
+#include "Core/Rendering/RenderGraph/SubmissionQueue.h"
+
+#include <vector>
+#include <cstring>
+
+using namespace MxEngine;
+using namespace MxEngine::Benchmarks;
+using MxEngine::Tests::FakeQueueScope;
+using MxEngine::Tests::RunFrame;
+using VulkanAbstractionLayer::Buffer;
+
+namespace
+{
+    constexpr size_t ReadbackSize = 16 * KB;
+
+    struct ReadbackSource
+    {
+        Buffer Storage;
+        std::vector<uint8_t> Result;
+
+        ReadbackSource(FakeQueueScope& queue, size_t readbackCount)
+            : Result(ReadbackSize * readbackCount)
+        {
+            queue.Device->AddBuffer(this->Storage, ReadbackSize * readbackCount, 0x5A);
+        }
+    };
+}
+
+/*!
+readbacks issued by tool in one frame, each of them waits for GPU before the next one is recorded
+*/
+MX_BENCHMARK(ReadbackSync, 1, 16, 64)
+{
+    size_t readbackCount = state.GetArgument();
+    FakeQueueScope queue(64 * MB);
+    ReadbackSource source(queue, readbackCount);
+
+    state.Run([&]()
+    {
+        for (size_t i = 0; i < readbackCount; i++)
+            SubmissionQueue::CopyFromBuffer(source.Result.data() + i * ReadbackSize, ReadbackSize, source.Storage, i * ReadbackSize);
+        RunFrame();
+        DoNotOptimize(source.Result.back());
+    });
+
+    state.SetItemsPerIteration(readbackCount);
+    state.SetBytesPerIteration(readbackCount * ReadbackSize);
+    state.AddCounter("flushes/frame", (double)SubmissionQueue::GetStats().FlushCount / state.GetIterations());
+    state.AddCounter("latency frames", 0.0);
+}
+
+/*!
+the same readbacks recorded into frame command buffer. Iteration lasts until all of them are completed, latency is measured in frames
+*/
+MX_BENCHMARK(ReadbackAsync, 1, 16, 64)
+{
+    size_t readbackCount = state.GetArgument();
+    FakeQueueScope queue(64 * MB);
+    ReadbackSource source(queue, readbackCount);
+
+    size_t latencyFrames = 0;
+    state.Run([&]()
+    {
+        size_t completed = 0;
+        for (size_t i = 0; i < readbackCount; i++)
+        {
+            SubmissionQueue::CopyFromBufferAsync(ReadbackSize, source.Storage, i * ReadbackSize, [&source, &completed, i](const uint8_t* data, size_t byteSize)
+            {
+                std::memcpy(source.Result.data() + i * ReadbackSize, data, byteSize);
+                completed++;
+            });
+        }
+
+        latencyFrames = 0;
+        while (completed != readbackCount)
+        {
+            RunFrame();
+            latencyFrames++;
+        }
+        DoNotOptimize(source.Result.back());
+    });
+
+    state.SetItemsPerIteration(readbackCount);
+    state.SetBytesPerIteration(readbackCount * ReadbackSize);
+    state.AddCounter("flushes/frame", (double)SubmissionQueue::GetStats().FlushCount / state.GetIterations());
+    state.AddCounter("latency frames", (double)latencyFrames);
+}
+
+/*!
+async readbacks completed by explicit flush, as tools do when they need data in the same frame
+*/
+MX_BENCHMARK(ReadbackAsyncFlushed, 1, 16, 64)
+{
+    size_t readbackCount = state.GetArgument();
+    FakeQueueScope queue(64 * MB);
+    ReadbackSource source(queue, readbackCount);
+
+    state.Run([&]()
+    {
+        for (size_t i = 0; i < readbackCount; i++)
+        {
+            SubmissionQueue::CopyFromBufferAsync(ReadbackSize, source.Storage, i * ReadbackSize, [&source, i](const uint8_t* data, size_t byteSize)
+            {
+                std::memcpy(source.Result.data() + i * ReadbackSize, data, byteSize);
+            });
+        }
+        SubmissionQueue::FlushQueue();
+        RunFrame();
+        DoNotOptimize(source.Result.back());
+    });
+
+    state.SetItemsPerIteration(readbackCount);
+    state.SetBytesPerIteration(readbackCount * ReadbackSize);
+    state.AddCounter("flushes/frame", (double)SubmissionQueue::GetStats().FlushCount / state.GetIterations());
+    state.AddCounter("latency frames", 0.0);
+}
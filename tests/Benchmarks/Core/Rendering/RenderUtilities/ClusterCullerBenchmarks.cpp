@@ -0,0 +1,174 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/BenchmarkFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Core/Rendering/RenderUtilities/ClusterCuller.h"
+#include "Utilities/ObjectLoading/MeshOptimizer.h"
+
+#include <cmath>
+
+using namespace MxEngine;
+using namespace MxEngine::Benchmarks;
+using MxEngine::Tests::ModuleScope;
+
+namespace
+{
+    constexpr size_t SceneGridSize = 8;
+    constexpr float SceneSpacing = 6.0f;
+    constexpr size_t CameraDirections = 16;
+
+    struct SceneMesh
+    {
+        MxVector<Vertex> Vertecies;
+        MxVector<uint32_t> Indicies;
+        MxVector<Meshlet> Meshlets;
+    };
+
+    struct SceneObject
+    {
+        Matrix4x4 Model;
+        size_t IndexOffset;
+        AABB Box;
+    };
+
+    /*!
+    generates outward-facing uv-sphere of radius 1 with 4 * stacks^2 triangles, processed as importer does: optimized and split into meshlets
+    */
+    SceneMesh GenerateSphere(size_t stacks)
+    {
+        constexpr float Pi = 3.14159265358979f;
+        size_t slices = 2 * stacks;
+
+        SceneMesh mesh;
+        for (size_t stack = 0; stack <= stacks; stack++)
+        {
+            float phi = Pi * (float)stack / (float)stacks;
+            for (size_t slice = 0; slice <= slices; slice++)
+            {
+                float theta = 2.0f * Pi * (float)slice / (float)slices;
+                Vertex vertex;
+                vertex.Position = MakeVector3(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta));
+                mesh.Vertecies.push_back(vertex);
+            }
+        }
+        for (size_t stack = 0; stack < stacks; stack++)
+        {
+            for (size_t slice = 0; slice < slices; slice++)
+            {
+                uint32_t i0 = uint32_t(stack * (slices + 1) + slice);
+                uint32_t i2 = i0 + uint32_t(slices + 1);
+                uint32_t quad[6] = { i0, i0 + 1, i2, i0 + 1, i2 + 1, i2 };
+                mesh.Indicies.insert(mesh.Indicies.end(), std::begin(quad), std::end(quad));
+            }
+        }
+
+        MeshOptimizer::Optimize(mesh.Vertecies, mesh.Indicies);
+        mesh.Meshlets = MeshletBuilder::Build(mesh.Vertecies, mesh.Indicies);
+        return mesh;
+    }
+
+    /*!
+    Sponza-scale scene: 64 objects of 4096 triangles each (262K triangles total) placed on a grid around the camera
+    */
+    MxVector<SceneObject> GenerateScene(const SceneMesh& mesh)
+    {
+        MxVector<SceneObject> objects;
+        AABB meshBox = AABB{ MakeVector3(-1.0f), MakeVector3(1.0f) };
+        for (size_t y = 0; y < SceneGridSize; y++)
+        {
+            for (size_t x = 0; x < SceneGridSize; x++)
+            {
+                float offset = 0.5f * SceneSpacing * float(SceneGridSize - 1);
+                auto position = MakeVector3((float)x * SceneSpacing - offset, 0.0f, (float)y * SceneSpacing - offset);
+                auto model = Scale(Translate(Matrix4x4(1.0f), position), 2.0f);
+                objects.push_back(SceneObject{ model, objects.size() * mesh.Indicies.size(), meshBox * model });
+            }
+        }
+        return objects;
+    }
+
+    FrustrumCuller MakeCameraCuller(const Vector3& position, size_t direction)
+    {
+        float angle = 6.2831853f * (float)direction / (float)CameraDirections;
+        auto target = position + MakeVector3(std::cos(angle), -0.1f, std::sin(angle));
+        auto projection = MakePerspectiveMatrix(1.2f, 16.0f / 9.0f, 0.1f, 1000.0f);
+        return FrustrumCuller(projection * MakeViewMatrix(position, target, MakeVector3(0.0f, 1.0f, 0.0f)));
+    }
+}
+
+/*!
+culls meshlets of all scene objects from a camera rotating inside the scene. Argument enables normal cone culling.
+Drawn triangles are compared with per-submesh AABB culling which RenderController used before
+*/
+MX_BENCHMARK(ClusterCulling, 0, 1)
+{
+    ModuleScope<FrameAllocator> modules;
+    auto mesh = GenerateSphere(32);
+    auto objects = GenerateScene(mesh);
+    auto cameraPosition = MakeVector3(1.0f, 1.5f, 2.0f);
+    bool useConeCulling = state.GetArgument() != 0;
+
+    MxVector<FrustrumCuller> cullers;
+    for (size_t i = 0; i < CameraDirections; i++)
+        cullers.push_back(MakeCameraCuller(cameraPosition, i));
+
+    FrameVector<IndexRange> ranges;
+    size_t direction = 0;
+    size_t testedMeshlets = 0, culledMeshlets = 0;
+    size_t drawnIndicies = 0, submeshDrawnIndicies = 0;
+    size_t rangeCount = 0;
+    state.Run([&]()
+    {
+        const auto& culler = cullers[direction++ % CameraDirections];
+        ranges.clear();
+        for (const auto& object : objects)
+        {
+            if (!culler.IsAABBVisible(object.Box.Min, object.Box.Max)) continue;
+            testedMeshlets += mesh.Meshlets.size();
+            culledMeshlets += ClusterCuller::Cull(mesh.Meshlets, object.IndexOffset, object.Model, culler, cameraPosition, useConeCulling, ranges);
+            submeshDrawnIndicies += mesh.Indicies.size();
+        }
+        for (const auto& range : ranges)
+            drawnIndicies += range.IndexCount;
+        rangeCount += ranges.size();
+        DoNotOptimize(ranges.data());
+    });
+
+    // first call of Run is a warmup and is not counted in iterations
+    double frames = double(state.GetIterations() + 1);
+    size_t sceneIndicies = objects.size() * mesh.Indicies.size();
+    state.SetItemsPerIteration(objects.size() * mesh.Meshlets.size());
+    state.AddCounter("meshlets", double(objects.size() * mesh.Meshlets.size()));
+    // meshlets of submeshes culled by AABB are not tested
+    state.AddCounter("culled meshlets %", 100.0 * culledMeshlets / double(testedMeshlets));
+    state.AddCounter("drawn triangles %", 100.0 * drawnIndicies / frames / double(sceneIndicies));
+    state.AddCounter("submesh culling drawn %", 100.0 * submeshDrawnIndicies / frames / double(sceneIndicies));
+    state.AddCounter("draws/frame", rangeCount / frames);
+}
@@ -0,0 +1,158 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/BenchmarkFramework.h"
+#include "Core/Resources/BufferAllocator.h"
+
+#include <random>
+#include <algorithm>
+#include <limits>
+
+using namespace MxEngine;
+using namespace MxEngine::Benchmarks;
+
+namespace
+{
+    constexpr size_t MaxAllocationSize = 64 * 1024;
+
+    bool IsSorted(const MxVector<BufferAllocationInfo>& layout)
+    {
+        return std::is_sorted(layout.begin(), layout.end(), [](const auto& a1, const auto& a2) { return a1.Offset < a2.Offset; });
+    }
+
+    /*!
+    places allocation into the first hole which fits it, as free list allocator does, or at the end of the heap
+    */
+    void AllocateFirstFit(MxVector<BufferAllocationInfo>& layout, size_t size)
+    {
+        size_t usedEnd = 0;
+        auto it = layout.begin();
+        for (; it != layout.end(); it++)
+        {
+            if (usedEnd + size <= it->Offset) break;
+            usedEnd = it->Offset + it->Size;
+        }
+        layout.insert(it, BufferAllocationInfo{ usedEnd, size, 1, true });
+    }
+
+    void ApplyPlan(MxVector<BufferAllocationInfo>& layout, const MxVector<BufferMove>& plan)
+    {
+        for (const auto& move : plan)
+            layout[move.Allocation].Offset = move.To;
+        std::sort(layout.begin(), layout.end(), [](const auto& a1, const auto& a2) { return a1.Offset < a2.Offset; });
+    }
+
+    MxVector<BufferAllocationInfo> GenerateFragmentedLayout(size_t allocationCount, std::mt19937& random)
+    {
+        std::uniform_int_distribution<size_t> size(256, MaxAllocationSize);
+        std::uniform_int_distribution<size_t> gap(0, 3);
+
+        MxVector<BufferAllocationInfo> layout;
+        size_t offset = 0;
+        for (size_t i = 0; i < allocationCount; i++)
+        {
+            if (gap(random) == 0) offset += size(random);
+            layout.push_back(BufferAllocationInfo{ offset, size(random), 1, true });
+            offset += layout.back().Size;
+        }
+        return layout;
+    }
+}
+
+MX_BENCHMARK(DefragmentationPlan, 1000, 10000, 100000)
+{
+    std::mt19937 random(7);
+    auto layout = GenerateFragmentedLayout(state.GetArgument(), random);
+    constexpr size_t Budget = 4 * 1024 * 1024;
+
+    size_t moveCount = 0;
+    state.Run([&]()
+    {
+        auto plan = BufferAllocator::PlanDefragmentation(layout, Budget);
+        moveCount = plan.size();
+        DoNotOptimize(plan.data());
+    });
+
+    state.SetItemsPerIteration(layout.size());
+    state.AddCounter("moves", (double)moveCount);
+    state.AddCounter("fragmentation %", 100.0 * BufferAllocator::ComputeFragmentation(layout).Ratio);
+}
+
+/*!
+fragmentation report: heap with 4096 live allocations churns 2% of them each frame, while defragmentation runs with given per-frame budget in KiB
+*/
+MX_BENCHMARK(DefragmentationChurn, 0, 256, 4096, 65536)
+{
+    constexpr size_t LiveAllocations = 4096;
+    constexpr size_t FreedPerFrame = LiveAllocations / 50;
+    constexpr size_t Frames = 300;
+    size_t budget = state.GetArgument() * 1024;
+
+    float finalRatio = 0.0f;
+    float peakRatio = 0.0f;
+    size_t peakUsedBytes = 0;
+    size_t movedBytes = 0;
+
+    state.SetMaxIterations(3);
+    state.Run([&]()
+    {
+        std::mt19937 random(11);
+        std::uniform_int_distribution<size_t> size(256, MaxAllocationSize);
+        auto layout = GenerateFragmentedLayout(0, random);
+        for (size_t i = 0; i < LiveAllocations; i++)
+            AllocateFirstFit(layout, size(random));
+
+        finalRatio = peakRatio = 0.0f;
+        peakUsedBytes = movedBytes = 0;
+        for (size_t frame = 0; frame < Frames; frame++)
+        {
+            for (size_t i = 0; i < FreedPerFrame; i++)
+                layout.erase(layout.begin() + std::uniform_int_distribution<size_t>(0, layout.size() - 1)(random));
+            for (size_t i = 0; i < FreedPerFrame; i++)
+                AllocateFirstFit(layout, size(random));
+
+            auto plan = BufferAllocator::PlanDefragmentation(layout, budget);
+            for (const auto& move : plan)
+                movedBytes += move.Size;
+            ApplyPlan(layout, plan);
+
+            auto fragmentation = BufferAllocator::ComputeFragmentation(layout);
+            finalRatio = fragmentation.Ratio;
+            peakRatio = std::max(peakRatio, fragmentation.Ratio);
+            peakUsedBytes = std::max(peakUsedBytes, fragmentation.UsedBytes);
+        }
+        DoNotOptimize(IsSorted(layout));
+    });
+
+    state.SetItemsPerIteration(Frames);
+    state.AddCounter("final fragmentation %", 100.0 * finalRatio);
+    state.AddCounter("peak fragmentation %", 100.0 * peakRatio);
+    state.AddCounter("peak used MiB", peakUsedBytes / (1024.0 * 1024.0));
+    state.AddCounter("moved KiB/frame", movedBytes / 1024.0 / Frames);
+}
@@ -0,0 +1,213 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/BenchmarkFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Core/Resources/MeshData.h"
+#include "Utilities/Threading/ThreadPool.h"
+
+#include <random>
+#include <array>
+
+using namespace MxEngine;
+using namespace MxEngine::Benchmarks;
+using MxEngine::Tests::ModuleScope;
+
+namespace
+{
+    using MeshModules = ModuleScope<ThreadPool>;
+
+    // 2 * 707 * 707 = 999698 triangles
+    constexpr size_t GridSize = 708;
+
+    struct BenchmarkMesh
+    {
+        MeshData::VertexData Vertecies;
+        MeshData::IndexData Indicies;
+
+        size_t GetTriangleCount() const { return Indicies.size() / 3; }
+    };
+
+    /*!
+    generates uneven grid with random texture coordinates. If shuffled is set, triangle order is randomized, so every chunk references vertecies from the whole mesh
+    */
+    BenchmarkMesh GenerateGrid(size_t size, bool shuffled)
+    {
+        std::mt19937 random(13);
+        std::uniform_real_distribution<float> height(-0.5f, 0.5f);
+        std::uniform_real_distribution<float> uv(0.0f, 1.0f);
+
+        BenchmarkMesh mesh;
+        mesh.Vertecies.resize(size * size);
+        for (size_t y = 0; y < size; y++)
+        {
+            for (size_t x = 0; x < size; x++)
+            {
+                auto& vertex = mesh.Vertecies[y * size + x];
+                vertex.Position = MakeVector3((float)x, height(random), (float)y);
+                vertex.TexCoord = MakeVector2(uv(random), uv(random));
+            }
+        }
+        for (size_t y = 0; y + 1 < size; y++)
+        {
+            for (size_t x = 0; x + 1 < size; x++)
+            {
+                uint32_t i = uint32_t(y * size + x);
+                uint32_t quad[6] = { i, i + (uint32_t)size, i + 1, i + 1, i + (uint32_t)size, i + (uint32_t)size + 1 };
+                mesh.Indicies.insert(mesh.Indicies.end(), std::begin(quad), std::end(quad));
+            }
+        }
+
+        if (shuffled)
+        {
+            for (size_t i = mesh.GetTriangleCount(); i > 1; i--)
+            {
+                size_t j = std::uniform_int_distribution<size_t>(0, i - 1)(random);
+                for (size_t k = 0; k < 3; k++)
+                    std::swap(mesh.Indicies[3 * (i - 1) + k], mesh.Indicies[3 * j + k]);
+            }
+        }
+        return mesh;
+    }
+
+    /*!
+    serial implementation of RegenerateNormals which MeshData used before accumulation was parallelized, kept as a baseline
+    */
+    void SerialRegenerateNormals(MeshData::VertexData& vertecies, const MeshData::IndexData& indicies)
+    {
+        for (auto& vertex : vertecies)
+        {
+            vertex.Normal = MakeVector3(0.0f);
+            vertex.Tangent = MakeVector3(0.0f);
+            vertex.Bitangent = MakeVector3(0.0f);
+        }
+
+        for (size_t i = 0; i < indicies.size() / 3; i++)
+        {
+            std::array triangle = {
+                vertecies[indicies[3 * i + 0]],
+                vertecies[indicies[3 * i + 1]],
+                vertecies[indicies[3 * i + 2]],
+            };
+
+            auto normal = ComputeNormal(triangle[0].Position, triangle[1].Position, triangle[2].Position);
+            auto tanbitan = ComputeTangentSpace(
+                triangle[0].Position, triangle[1].Position, triangle[2].Position,
+                triangle[0].TexCoord, triangle[1].TexCoord, triangle[2].TexCoord
+            );
+
+            for (auto& vertex : triangle)
+            {
+                vertex.Normal += normal;
+                vertex.Tangent += tanbitan[0];
+                vertex.Bitangent += tanbitan[1];
+            }
+
+            for (size_t j = 0; j < triangle.size(); j++)
+                vertecies[indicies[3 * i + j]] = triangle[j];
+        }
+
+        for (auto& vertex : vertecies)
+        {
+            vertex.Normal = Normalize(vertex.Normal);
+            vertex.Tangent = Normalize(vertex.Tangent);
+            vertex.Bitangent = Normalize(vertex.Bitangent);
+        }
+    }
+}
+
+/*!
+argument selects triangle order: 0 - grid order, 1 - shuffled
+*/
+MX_BENCHMARK(RegenerateNormalsSerial, 0, 1)
+{
+    auto mesh = GenerateGrid(GridSize, state.GetArgument() != 0);
+
+    state.SetMaxIterations(10);
+    state.Run([&]()
+    {
+        SerialRegenerateNormals(mesh.Vertecies, mesh.Indicies);
+        DoNotOptimize(mesh.Vertecies.data());
+    });
+
+    state.SetItemsPerIteration(mesh.GetTriangleCount());
+    state.SetBytesPerIteration(mesh.Vertecies.size() * sizeof(Vertex) + mesh.Indicies.size() * sizeof(uint32_t));
+}
+
+MX_BENCHMARK(RegenerateNormals, 0, 1)
+{
+    MeshModules modules;
+    auto mesh = GenerateGrid(GridSize, state.GetArgument() != 0);
+
+    state.SetMaxIterations(10);
+    state.Run([&]()
+    {
+        MeshData::RegenerateNormals(mesh.Vertecies, mesh.Indicies);
+        DoNotOptimize(mesh.Vertecies.data());
+    });
+
+    state.SetItemsPerIteration(mesh.GetTriangleCount());
+    state.SetBytesPerIteration(mesh.Vertecies.size() * sizeof(Vertex) + mesh.Indicies.size() * sizeof(uint32_t));
+    state.AddCounter("workers", (double)ThreadPool::GetWorkerCount());
+}
+
+MX_BENCHMARK(RegenerateTangentSpace, 0, 1)
+{
+    MeshModules modules;
+    auto mesh = GenerateGrid(GridSize, state.GetArgument() != 0);
+
+    state.SetMaxIterations(10);
+    state.Run([&]()
+    {
+        MeshData::RegenerateTangentSpace(mesh.Vertecies, mesh.Indicies);
+        DoNotOptimize(mesh.Vertecies.data());
+    });
+
+    state.SetItemsPerIteration(mesh.GetTriangleCount());
+    state.SetBytesPerIteration(mesh.Vertecies.size() * sizeof(Vertex) + mesh.Indicies.size() * sizeof(uint32_t));
+}
+
+/*!
+bounding box and sphere of a mesh with 1M triangles. Vertecies are shared by triangles, so only positions of the vertex buffer are read
+*/
+MX_BENCHMARK(BoundingGeometry)
+{
+    MeshModules modules;
+    auto mesh = GenerateGrid(GridSize, false);
+
+    state.Run([&]()
+    {
+        auto box = MeshData::ComputeBoundingBox(mesh.Vertecies);
+        auto sphere = MeshData::ComputeBoundingSphere(mesh.Vertecies, box.GetCenter());
+        DoNotOptimize(sphere.Radius);
+    });
+
+    state.SetItemsPerIteration(mesh.Vertecies.size());
+    state.SetBytesPerIteration(mesh.Vertecies.size() * sizeof(Vertex));
+}
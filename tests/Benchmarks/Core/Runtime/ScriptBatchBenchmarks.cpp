@@ -0,0 +1,90 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/BenchmarkFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Core/Runtime/RuntimeCompiler.h"
+#include "Core/Components/Scripting/Script.h"
+#include "Core/MxObject/MxObject.h"
+#include "Utilities/FileSystem/FileManager.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/UUID/UUID.h"
+
+using namespace MxEngine;
+using namespace MxEngine::Benchmarks;
+using MxEngine::Tests::ModuleScope;
+
+// scripts are registered from Benchmarks/Core/Runtime/Scripts, which must be inside working directory.
+// Objects are destroyed before runtime compiler, as script components notify it on destruction
+using ScriptModules = ModuleScope<UUIDGenerator, ThreadPool, FileManager, RuntimeCompiler, ComponentFactory, Factory<MxObject>>;
+
+static void CreateScriptedObjects(size_t count, const char* scriptName)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        auto object = MxObject::Create();
+        object->AddComponent<Script>(scriptName);
+    }
+}
+
+// matches per-frame script update of the application: all Script components are updated, then batched scripts are invoked
+static void UpdateScripts(float dt)
+{
+    for (auto& script : ComponentFactory::GetView<Script>())
+        script.OnUpdate(dt);
+    RuntimeCompiler::InvokeScriptBatches(dt);
+}
+
+MX_BENCHMARK(ScriptUpdatePerObject, 5000, 50000)
+{
+    ScriptModules modules;
+    CreateScriptedObjects(state.GetArgument(), "BenchmarkPerObjectScript");
+
+    state.Run([]() { UpdateScripts(0.016f); });
+    state.SetItemsPerIteration(state.GetArgument());
+}
+
+MX_BENCHMARK(ScriptUpdateBatched, 5000, 50000)
+{
+    ScriptModules modules;
+    CreateScriptedObjects(state.GetArgument(), "BenchmarkBatchedScript");
+
+    state.Run([]() { UpdateScripts(0.016f); });
+    state.SetItemsPerIteration(state.GetArgument());
+}
+
+MX_BENCHMARK(ScriptBatchRebuild, 50000)
+{
+    ScriptModules modules;
+    CreateScriptedObjects(state.GetArgument(), "BenchmarkBatchedScript");
+
+    // grouping is refreshed only when scripts are added, removed or recompiled, this measures such frame
+    state.Run([]() { RuntimeCompiler::InvalidateScriptBatches(); }, []() { UpdateScripts(0.016f); });
+    state.SetItemsPerIteration(state.GetArgument());
+}
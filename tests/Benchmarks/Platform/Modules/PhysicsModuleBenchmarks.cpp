@@ -0,0 +1,132 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Framework/BenchmarkFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Core/Components/Physics/BoxCollider.h"
+#include "Core/Components/Physics/RigidBody.h"
+#include "Core/MxObject/MxObject.h"
+#include "Platform/Modules/PhysicsModule.h"
+#include "Platform/PhysicsAPI.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/UUID/UUID.h"
+
+#include <cmath>
+
+using namespace MxEngine;
+using namespace MxEngine::Benchmarks;
+using MxEngine::Tests::ModuleScope;
+
+// objects are destroyed first, so their rigid bodies are removed from the world before physics module is destroyed
+using PhysicsModules = ModuleScope<UUIDGenerator, ThreadPool, PhysicsModule, ComponentFactory,
+    Factory<BoxShape>, Factory<NativeRigidBody>, Factory<MxObject>>;
+
+namespace
+{
+    constexpr size_t StackHeight = 10;
+    constexpr float StackSpacing = 2.0f;
+    constexpr float TimeStep = 1.0f / 60.0f;
+    constexpr size_t SettleSteps = 10;
+
+    MxObject::Handle CreateBox(const Vector3& position, const Vector3& halfSize)
+    {
+        auto object = MxObject::Create();
+        object->LocalTransform.SetPosition(position);
+        auto collider = object->AddComponent<BoxCollider>();
+        collider->SetBoundingBox(BoundingBox(MakeVector3(0.0f), halfSize));
+        object->AddComponent<RigidBody>();
+        return object;
+    }
+
+    /*!
+    headless version of PhysicsSample scene: columns of unit cubes standing on static ground. Deactivation is disabled,
+    so every step simulates all bodies instead of letting resting stacks fall asleep
+    */
+    void CreateStackedWorld(size_t bodyCount)
+    {
+        size_t stackCount = (bodyCount + StackHeight - 1) / StackHeight;
+        size_t gridSize = (size_t)std::ceil(std::sqrt((float)stackCount));
+        float extent = gridSize * StackSpacing;
+
+        auto ground = CreateBox(MakeVector3(0.5f * extent, -0.5f, 0.5f * extent), MakeVector3(0.5f * extent + StackSpacing, 0.5f, 0.5f * extent + StackSpacing));
+        ground->GetComponent<RigidBody>()->MakeStatic();
+
+        for (size_t i = 0; i < bodyCount; i++)
+        {
+            size_t stack = i / StackHeight;
+            size_t level = i % StackHeight;
+            float x = (stack % gridSize) * StackSpacing;
+            float z = (stack / gridSize) * StackSpacing;
+
+            auto box = CreateBox(MakeVector3(x, 0.5f + (float)level, z), MakeVector3(0.5f));
+            auto rigidBody = box->GetComponent<RigidBody>();
+            rigidBody->MakeDynamic();
+            rigidBody->SetActivationState(ActivationState::DISABLE_DEACTIVATION);
+        }
+        RigidBody::SyncObjectStates();
+    }
+
+    /*!
+    argument selects physics threads: 0 uses single-threaded world, any other value uses multithreaded world limited to that many threads
+    */
+    void BenchmarkStackedStep(BenchmarkState& state, size_t bodyCount)
+    {
+        PhysicsModules modules;
+        size_t threadCount = state.GetArgument();
+        if (threadCount == 0)
+        {
+            PhysicsModule::SetWorldType(PhysicsWorldType::SINGLE_THREADED);
+        }
+        else
+        {
+            PhysicsModule::SetWorldType(PhysicsWorldType::MULTI_THREADED);
+            PhysicsModule::SetThreadCount(threadCount);
+        }
+        CreateStackedWorld(bodyCount);
+
+        // first steps create contact manifolds for resting boxes, which is not representative for a regular frame
+        for (size_t i = 0; i < SettleSteps; i++)
+            PhysicsModule::PerformSimulationStep(TimeStep);
+
+        state.SetMaxIterations(100);
+        state.Run([]() { PhysicsModule::PerformSimulationStep(TimeStep); });
+        state.SetItemsPerIteration(bodyCount);
+        state.AddCounter("bodies", (double)bodyCount);
+        state.AddCounter("threads", threadCount == 0 ? 1.0 : (double)PhysicsModule::GetThreadCount());
+    }
+}
+
+MX_BENCHMARK(PhysicsStepStacked5k, 0, 1, 2, 4, 8)
+{
+    BenchmarkStackedStep(state, 5000);
+}
+
+MX_BENCHMARK(PhysicsStepStacked20k, 0, 1, 2, 4, 8)
+{
+    BenchmarkStackedStep(state, 20000);
+}
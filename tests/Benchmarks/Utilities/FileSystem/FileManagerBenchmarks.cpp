@@ -0,0 +1,160 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/BenchmarkFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Utilities/FileSystem/FileManager.h"
+#include "Utilities/FileSystem/VirtualFileSystem.h"
+#include "Utilities/Threading/ThreadPool.h"
+
+#include <fstream>
+#include <filesystem>
+#include <string>
+
+using namespace MxEngine;
+using namespace MxEngine::Benchmarks;
+using MxEngine::Tests::ModuleScope;
+
+namespace
+{
+    using FileIndexModules = ModuleScope<ThreadPool, VirtualFileSystem, FileManager>;
+
+    constexpr size_t TopLevelDirectoryCount = 16;
+    constexpr size_t SubdirectoryCount = 16;
+
+    /*!
+    project tree with given number of empty files, spread over two levels of directories. Generated once per file count
+    */
+    struct ProjectTree
+    {
+        FilePath Root;
+        size_t FileCount = 0;
+
+        explicit ProjectTree(size_t fileCount)
+            : FileCount(fileCount)
+        {
+            this->Root = std::filesystem::temp_directory_path() / "MxEngineBenchmarks" / ("FileIndex" + std::to_string(fileCount));
+            std::error_code error;
+            std::filesystem::remove_all(this->Root, error);
+
+            size_t leafCount = TopLevelDirectoryCount * SubdirectoryCount;
+            for (size_t i = 0; i < fileCount; i++)
+            {
+                size_t leaf = i % leafCount;
+                auto directory = this->Root / ("dir" + std::to_string(leaf / SubdirectoryCount)) / ("sub" + std::to_string(leaf % SubdirectoryCount));
+                if (i < leafCount) std::filesystem::create_directories(directory);
+                std::ofstream(directory / ("asset" + std::to_string(i) + ".bin"));
+            }
+        }
+
+        ~ProjectTree()
+        {
+            std::error_code error;
+            std::filesystem::remove_all(this->Root, error);
+        }
+
+        void RemoveIndexCache() const
+        {
+            std::error_code error;
+            std::filesystem::remove(this->Root / ".mxfiletable", error);
+        }
+    };
+
+    const ProjectTree& GetProjectTree(size_t fileCount)
+    {
+        // trees are kept until exit, so all benchmarks with the same file count index the same directory
+        static MxHashMap<size_t, UniqueRef<ProjectTree>> trees;
+        auto& tree = trees[fileCount];
+        if (tree == nullptr) tree = MakeUnique<ProjectTree>(fileCount);
+        return *tree;
+    }
+
+    void ResetFileTable()
+    {
+        FileManager::GetImpl()->filetable.clear();
+    }
+}
+
+MX_BENCHMARK(FileIndexRecursiveWalk, 2000, 20000, 100000)
+{
+    // reference implementation which listed whole project with recursive iterator before directory index was cached
+    const auto& tree = GetProjectTree(state.GetArgument());
+    size_t indexedCount = 0;
+    state.SetMaxIterations(20);
+
+    state.Run([&tree, &indexedCount]()
+    {
+        MxVector<FilePath> files;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(tree.Root, std::filesystem::directory_options::skip_permission_denied))
+        {
+            if (entry.is_regular_file())
+                files.push_back(FileManager::GetProximatePath(entry.path(), tree.Root));
+        }
+        indexedCount = files.size();
+    });
+
+    state.SetItemsPerIteration(tree.FileCount);
+    state.AddCounter("files", (double)indexedCount);
+}
+
+MX_BENCHMARK(FileIndexCold, 2000, 20000, 100000)
+{
+    // no index cache on disk: every directory is listed, then cache is written
+    FileIndexModules modules;
+    const auto& tree = GetProjectTree(state.GetArgument());
+    state.SetMaxIterations(20);
+
+    state.Run([&tree]() { tree.RemoveIndexCache(); ResetFileTable(); }, [&tree]()
+    {
+        FileManager::InitializeRootDirectory(tree.Root);
+    });
+
+    state.SetItemsPerIteration(tree.FileCount);
+    state.AddCounter("files", (double)FileManager::GetImpl()->filetable.size());
+    state.AddCounter("workers", (double)ThreadPool::GetWorkerCount());
+}
+
+MX_BENCHMARK(FileIndexWarm, 2000, 20000, 100000)
+{
+    // index cache is up to date: each directory costs one stat, files are taken from the cache
+    FileIndexModules modules;
+    const auto& tree = GetProjectTree(state.GetArgument());
+    tree.RemoveIndexCache();
+    FileManager::InitializeRootDirectory(tree.Root);
+    state.SetMaxIterations(20);
+
+    state.Run([]() { ResetFileTable(); }, [&tree]()
+    {
+        FileManager::InitializeRootDirectory(tree.Root);
+    });
+
+    state.SetItemsPerIteration(tree.FileCount);
+    state.AddCounter("files", (double)FileManager::GetImpl()->filetable.size());
+    state.AddCounter("workers", (double)ThreadPool::GetWorkerCount());
+}
@@ -0,0 +1,348 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/BenchmarkFramework.h"
+#include "Utilities/FileSystem/MappedFile.h"
+#include "Utilities/Image/ImageLoader.h"
+#include "Utilities/Image/ImageConverter.h"
+#include "Utilities/Json/Json.h"
+#include "Utilities/STL/MxHashMap.h"
+#include "Utilities/Memory/Memory.h"
+
+#include <fstream>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#if defined(MXENGINE_LINUX)
+#include <malloc.h>
+#endif
+
+using namespace MxEngine;
+using namespace MxEngine::Benchmarks;
+
+namespace
+{
+    constexpr size_t MiB = 1024 * 1024;
+    constexpr size_t PageSize = 4096;
+
+    /*!
+    binary file of given size in MiB filled with random bytes, kept until exit. All reads hit OS page cache after first iteration
+    */
+    struct BenchmarkFile
+    {
+        FilePath Path;
+        size_t ByteSize = 0;
+
+        explicit BenchmarkFile(size_t sizeInMiB)
+            : ByteSize(sizeInMiB * MiB)
+        {
+            auto directory = std::filesystem::temp_directory_path() / "MxEngineBenchmarks" / "MappedFile";
+            std::filesystem::create_directories(directory);
+            this->Path = directory / ("file" + std::to_string(sizeInMiB) + ".bin");
+
+            std::mt19937 random(1);
+            MxVector<uint32_t> chunk(MiB / sizeof(uint32_t));
+            std::ofstream file(this->Path, std::ios::binary);
+            for (size_t i = 0; i < sizeInMiB; i++)
+            {
+                for (auto& value : chunk)
+                    value = random();
+                file.write((const char*)chunk.data(), MiB);
+            }
+        }
+
+        ~BenchmarkFile()
+        {
+            std::error_code error;
+            std::filesystem::remove(this->Path, error);
+        }
+    };
+
+    const BenchmarkFile& GetBenchmarkFile(size_t sizeInMiB)
+    {
+        static MxHashMap<size_t, UniqueRef<BenchmarkFile>> files;
+        auto& file = files[sizeInMiB];
+        if (file == nullptr) file = MakeUnique<BenchmarkFile>(sizeInMiB);
+        return *file;
+    }
+
+    // reads one byte of each page, so every variant brings whole file into memory
+    size_t TouchPages(const uint8_t* data, size_t byteSize)
+    {
+        size_t checksum = 0;
+        for (size_t offset = 0; offset < byteSize; offset += PageSize)
+            checksum += data[offset];
+        return checksum;
+    }
+
+    void SetFileCounters(BenchmarkState& state, const BenchmarkFile& file)
+    {
+        state.SetItemsPerIteration(1);
+        state.SetBytesPerIteration(file.ByteSize);
+    }
+
+    /*!
+    ~500 MiB of assets as they are stored in a project: raw 2048x2048 RGBA images and large scene json files, kept until exit
+    */
+    struct AssetSet
+    {
+        static constexpr size_t ImageCount = 30;
+        static constexpr size_t ImageSize = 2048;
+        static constexpr size_t SceneCount = 10;
+        static constexpr size_t SceneObjectCount = 10000;
+
+        FilePath Root;
+        MxVector<FilePath> Images;
+        MxVector<FilePath> Scenes;
+        size_t ByteSize = 0;
+
+        AssetSet()
+        {
+            this->Root = std::filesystem::temp_directory_path() / "MxEngineBenchmarks" / "AssetSet";
+            std::filesystem::remove_all(this->Root);
+            std::filesystem::create_directories(this->Root);
+
+            std::mt19937 random(2);
+            MxVector<uint32_t> pixels(ImageSize * ImageSize);
+            for (size_t i = 0; i < ImageCount; i++)
+            {
+                RawImageHeader header;
+                header.Magic = RawImageMagic;
+                header.Width = (uint32_t)ImageSize;
+                header.Height = (uint32_t)ImageSize;
+                header.Channels = 4;
+                header.Format = ImageFormat::BYTE;
+                std::memset(header.Padding, 0, sizeof(header.Padding));
+                for (auto& pixel : pixels)
+                    pixel = random();
+
+                auto path = this->Root / ("image" + std::to_string(i) + ImageConverter::RawImageExtension);
+                std::ofstream file(path, std::ios::binary);
+                file.write((const char*)&header, sizeof(header));
+                file.write((const char*)pixels.data(), pixels.size() * sizeof(uint32_t));
+                this->Images.push_back(path);
+            }
+
+            std::uniform_real_distribution<float> coordinate(-100.0f, 100.0f);
+            for (size_t i = 0; i < SceneCount; i++)
+            {
+                auto path = this->Root / ("scene" + std::to_string(i) + ".json");
+                std::ofstream file(path);
+                file << "{ \"objects\": [";
+                for (size_t object = 0; object < SceneObjectCount; object++)
+                {
+                    file << (object == 0 ? "" : ",") << "{ \"name\": \"object" << object << "\", \"transform\": { \"position\": [";
+                    file << coordinate(random) << ", " << coordinate(random) << ", " << coordinate(random) << "], \"rotation\": [";
+                    file << coordinate(random) << ", " << coordinate(random) << ", " << coordinate(random) << "], \"scale\": [1, 1, 1] },";
+                    file << " \"material\": \"materials/material" << object % 64 << ".json\", \"visible\": true }";
+                }
+                file << "] }";
+                this->Scenes.push_back(path);
+            }
+
+            for (const auto& entry : std::filesystem::directory_iterator(this->Root))
+                this->ByteSize += (size_t)entry.file_size();
+        }
+
+        ~AssetSet()
+        {
+            std::error_code error;
+            std::filesystem::remove_all(this->Root, error);
+        }
+    };
+
+    const AssetSet& GetAssetSet()
+    {
+        static AssetSet assets;
+        return assets;
+    }
+
+    MxVector<uint8_t> ReadFileToBuffer(const FilePath& path)
+    {
+        File file(path, File::READ | File::BINARY);
+        MxVector<uint8_t> buffer((size_t)std::filesystem::file_size(path));
+        file.ReadBytes(buffer.data(), buffer.size());
+        return buffer;
+    }
+
+    /*!
+    tracks peak resident memory of the process between Reset and GetPeakBytes. Supported only on Linux,
+    where peak is reset through /proc/self/clear_refs. Returns 0 on other platforms
+    */
+    class PeakMemoryTracker
+    {
+        size_t baseline = 0;
+
+        static size_t ReadStatusBytes(const char* field)
+        {
+            #if defined(MXENGINE_LINUX)
+            std::ifstream status("/proc/self/status");
+            std::string name;
+            size_t kilobytes = 0;
+            while (status >> name)
+            {
+                if (name == field && status >> kilobytes) return kilobytes * 1024;
+                status.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            }
+            #endif
+            return 0;
+        }
+    public:
+        void Reset()
+        {
+            #if defined(MXENGINE_LINUX)
+            ::malloc_trim(0); // memory freed by previous iterations stays resident in heap otherwise and hides new allocations
+            std::ofstream("/proc/self/clear_refs") << "5"; // resets VmHWM to current resident size
+            #endif
+            this->baseline = ReadStatusBytes("VmRSS:");
+        }
+
+        size_t GetPeakBytes() const
+        {
+            size_t peak = ReadStatusBytes("VmHWM:");
+            return peak > this->baseline ? peak - this->baseline : 0;
+        }
+    };
+}
+
+MX_BENCHMARK(FileReadStdio, 1, 16, 128)
+{
+    // the way stb_image and other loaders read files before they were given mapped memory: whole file is copied into heap buffer
+    const auto& file = GetBenchmarkFile(state.GetArgument());
+    state.SetMaxIterations(50);
+
+    state.Run([&file]()
+    {
+        MxVector<uint8_t> buffer(file.ByteSize);
+        FILE* handle = std::fopen(file.Path.string().c_str(), "rb");
+        size_t readSize = std::fread(buffer.data(), 1, buffer.size(), handle);
+        std::fclose(handle);
+        DoNotOptimize(TouchPages(buffer.data(), readSize));
+    });
+
+    SetFileCounters(state, file);
+}
+
+MX_BENCHMARK(FileReadAllText, 1, 16, 128)
+{
+    const auto& file = GetBenchmarkFile(state.GetArgument());
+    state.SetMaxIterations(50);
+
+    state.Run([&file]()
+    {
+        auto contents = File::ReadAllText(file.Path);
+        DoNotOptimize(TouchPages((const uint8_t*)contents.data(), contents.size()));
+    });
+
+    SetFileCounters(state, file);
+}
+
+MX_BENCHMARK(MappedFileReadAll, 1, 16, 128)
+{
+    const auto& file = GetBenchmarkFile(state.GetArgument());
+    state.SetMaxIterations(50);
+
+    state.Run([&file]()
+    {
+        MappedFile mapped(file.Path);
+        DoNotOptimize(TouchPages(mapped.GetData(), mapped.GetSize()));
+    });
+
+    SetFileCounters(state, file);
+    state.AddCounter("mapped", (double)MappedFile(file.Path).IsMapped());
+}
+
+MX_BENCHMARK(MappedFileReadHeader, 1, 16, 128)
+{
+    // loaders which inspect only header (i.e. raw image or cooked texture validation) do not pay for the rest of the file
+    const auto& file = GetBenchmarkFile(state.GetArgument());
+    state.SetMaxIterations(50);
+
+    state.Run([&file]()
+    {
+        MappedFile mapped(file.Path);
+        auto header = mapped.GetBytes(0, 64);
+        DoNotOptimize(header[0]);
+    });
+
+    state.SetItemsPerIteration(1);
+}
+
+MX_BENCHMARK(AssetSetLoad, 0, 1)
+{
+    // whole asset set is loaded and kept alive as during scene load. 0: loaders read mapped files, 1: files are first copied into heap buffers
+    const auto& assets = GetAssetSet();
+    bool buffered = state.GetArgument() == 1;
+    PeakMemoryTracker memory;
+    size_t peakBytes = 0;
+    state.SetMaxIterations(3);
+
+    state.Run([&assets, &memory, &peakBytes, buffered]()
+    {
+        memory.Reset();
+        MxVector<ImageData> images;
+        MxVector<JsonFile> scenes;
+        for (const auto& path : assets.Images)
+        {
+            if (buffered)
+            {
+                auto bytes = ReadFileToBuffer(path);
+                images.push_back(ImageLoader::LoadImageFromMemory(bytes.data(), bytes.size()));
+            }
+            else
+            {
+                images.push_back(ImageLoader::LoadImage(path));
+            }
+        }
+        for (const auto& path : assets.Scenes)
+        {
+            if (buffered)
+            {
+                File file(path);
+                scenes.push_back(LoadJson(file));
+            }
+            else
+            {
+                scenes.push_back(LoadJson(MappedFile(path)));
+            }
+        }
+        peakBytes = Max(peakBytes, memory.GetPeakBytes());
+        DoNotOptimize(images.back().GetRawData());
+        DoNotOptimize(scenes.back().size());
+    });
+
+    state.SetItemsPerIteration(AssetSet::ImageCount + AssetSet::SceneCount);
+    state.SetBytesPerIteration(assets.ByteSize);
+    state.AddCounter("assetMiB", (double)assets.ByteSize / MiB);
+    state.AddCounter("peakMiB", (double)peakBytes / MiB);
+}
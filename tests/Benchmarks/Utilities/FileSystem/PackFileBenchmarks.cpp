@@ -0,0 +1,200 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/BenchmarkFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Utilities/FileSystem/VirtualFileSystem.h"
+#include "Utilities/FileSystem/MappedFile.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/STL/MxHashMap.h"
+
+#include <fstream>
+#include <filesystem>
+#include <random>
+#include <string>
+
+using namespace MxEngine;
+using namespace MxEngine::Benchmarks;
+using MxEngine::Tests::ModuleScope;
+
+namespace
+{
+    using PackModules = ModuleScope<ThreadPool, VirtualFileSystem>;
+
+    constexpr size_t AssetByteSize = 8 * 1024;
+    constexpr size_t DirectoryCount = 64;
+
+    /*!
+    project with given number of small assets, stored both as loose files and as two packs: with deflated and with uncompressed entries
+    */
+    struct PackedProject
+    {
+        FilePath Root;
+        FilePath CompressedPackPath;
+        FilePath UncompressedPackPath;
+        MxVector<FilePath> Assets;
+
+        explicit PackedProject(size_t assetCount)
+        {
+            this->Root = std::filesystem::temp_directory_path() / "MxEngineBenchmarks" / ("PackFile" + std::to_string(assetCount));
+            std::error_code error;
+            std::filesystem::remove_all(this->Root, error);
+
+            // text-like data with small alphabet, so deflate actually shrinks entries
+            std::mt19937 random(1);
+            std::string contents(AssetByteSize, ' ');
+            PackFileWriter compressedWriter, uncompressedWriter;
+            for (size_t i = 0; i < assetCount; i++)
+            {
+                auto directory = this->Root / "project" / ("dir" + std::to_string(i % DirectoryCount));
+                if (i < DirectoryCount) std::filesystem::create_directories(directory);
+                auto path = directory / ("asset" + std::to_string(i) + ".json");
+                for (auto& c : contents)
+                    c = (char)('a' + random() % 12);
+                std::ofstream(path, std::ios::binary) << contents;
+
+                auto packedPath = ToFilePath(VirtualFileSystem::GetPackedPath(path));
+                compressedWriter.AddFile(packedPath, path, true);
+                uncompressedWriter.AddFile(packedPath, path, false);
+                this->Assets.push_back(path);
+            }
+
+            this->CompressedPackPath = this->Root / "compressed.mxpack";
+            this->UncompressedPackPath = this->Root / "uncompressed.mxpack";
+            compressedWriter.Write(this->CompressedPackPath);
+            uncompressedWriter.Write(this->UncompressedPackPath);
+        }
+
+        ~PackedProject()
+        {
+            std::error_code error;
+            std::filesystem::remove_all(this->Root, error);
+        }
+
+        size_t ReadAllAssets() const
+        {
+            size_t checksum = 0;
+            for (const auto& path : this->Assets)
+            {
+                MappedFile file(path);
+                for (size_t offset = 0; offset < file.GetSize(); offset += 64)
+                    checksum += file.GetData()[offset];
+            }
+            return checksum;
+        }
+    };
+
+    const PackedProject& GetPackedProject(size_t assetCount)
+    {
+        static MxHashMap<size_t, UniqueRef<PackedProject>> projects;
+        auto& project = projects[assetCount];
+        if (project == nullptr)
+        {
+            PackModules modules; // pack writer compresses files on thread pool
+            project = MakeUnique<PackedProject>(assetCount);
+        }
+        return *project;
+    }
+
+    void SetAssetCounters(BenchmarkState& state, const PackedProject& project)
+    {
+        state.SetItemsPerIteration(project.Assets.size());
+        state.SetBytesPerIteration(project.Assets.size() * AssetByteSize);
+    }
+}
+
+MX_BENCHMARK(AssetReadLoose, 1000, 10000)
+{
+    // development setup: no packs are mounted, every asset is opened and mapped separately
+    PackModules modules;
+    const auto& project = GetPackedProject(state.GetArgument());
+    state.SetMaxIterations(20);
+
+    state.Run([&project]() { DoNotOptimize(project.ReadAllAssets()); });
+
+    SetAssetCounters(state, project);
+}
+
+MX_BENCHMARK(AssetReadPacked, 1000, 10000)
+{
+    // shipping setup: assets are referenced directly from single pack mapping, disk is not queried
+    PackModules modules;
+    const auto& project = GetPackedProject(state.GetArgument());
+    VirtualFileSystem::SetPreferLooseFiles(false);
+    VirtualFileSystem::Mount(project.UncompressedPackPath);
+    state.SetMaxIterations(20);
+
+    state.Run([&project]() { DoNotOptimize(project.ReadAllAssets()); });
+
+    SetAssetCounters(state, project);
+}
+
+MX_BENCHMARK(AssetReadPackedCompressed, 1000, 10000)
+{
+    PackModules modules;
+    const auto& project = GetPackedProject(state.GetArgument());
+    VirtualFileSystem::SetPreferLooseFiles(false);
+    VirtualFileSystem::Mount(project.CompressedPackPath);
+    state.SetMaxIterations(20);
+
+    state.Run([&project]() { DoNotOptimize(project.ReadAllAssets()); });
+
+    SetAssetCounters(state, project);
+    auto packSize = std::filesystem::file_size(project.CompressedPackPath);
+    state.AddCounter("ratio", (double)packSize / (double)(project.Assets.size() * AssetByteSize));
+}
+
+MX_BENCHMARK(AssetReadPackedWithLooseOverrides, 1000, 10000)
+{
+    // development setup with mounted pack: each read checks disk first, so loose files are found and read instead
+    PackModules modules;
+    const auto& project = GetPackedProject(state.GetArgument());
+    VirtualFileSystem::SetPreferLooseFiles(true);
+    VirtualFileSystem::Mount(project.UncompressedPackPath);
+    state.SetMaxIterations(20);
+
+    state.Run([&project]() { DoNotOptimize(project.ReadAllAssets()); });
+
+    SetAssetCounters(state, project);
+}
+
+MX_BENCHMARK(PackMount, 1000, 10000)
+{
+    PackModules modules;
+    const auto& project = GetPackedProject(state.GetArgument());
+    state.SetMaxIterations(50);
+
+    state.Run([&project]()
+    {
+        VirtualFileSystem::UnmountAll();
+        VirtualFileSystem::Mount(project.UncompressedPackPath);
+    });
+
+    state.SetItemsPerIteration(project.Assets.size());
+}
@@ -0,0 +1,202 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/BenchmarkFramework.h"
+#include "Utilities/Image/ImageConverter.h"
+#include "Utilities/Image/ImageLoader.h"
+#include "Utilities/Image/Image.h"
+
+#include <random>
+#include <cstdlib>
+#include <cmath>
+
+using namespace MxEngine;
+using namespace MxEngine::Benchmarks;
+
+namespace
+{
+    ImageData MakeMetallicRoughnessImage(size_t size)
+    {
+        std::mt19937 random(1);
+        size_t byteSize = size * size * 4;
+        auto data = (uint8_t*)std::malloc(byteSize);
+        for (size_t i = 0; i < byteSize; i++)
+            data[i] = (uint8_t)random();
+        return ImageData(data, size, size, 4, false);
+    }
+
+    /*!
+    generates equirectangular RGBA radiance map with 2:1 aspect ratio, components span several orders of magnitude like real HDR skies
+    */
+    ImageData MakeEquirectangularImage(size_t width)
+    {
+        std::mt19937 random(2);
+        std::uniform_real_distribution<float> exponent(-6.0f, 12.0f);
+        size_t height = width / 2;
+        size_t elementCount = width * height * 4;
+        auto data = (float*)std::malloc(elementCount * sizeof(float));
+        for (size_t i = 0; i < elementCount; i++)
+            data[i] = (i % 4 == 3) ? 1.0f : std::exp2(exponent(random));
+        return ImageData((uint8_t*)data, width, height, 4, ImageFormat::FLOAT);
+    }
+}
+
+MX_BENCHMARK(ChannelSplitPerPixel, 2048, 4096, 8192)
+{
+    // reference implementation which ObjectLoader used before bulk channel extraction
+    auto image = MakeMetallicRoughnessImage(state.GetArgument());
+    size_t width = image.GetWidth(), height = image.GetHeight();
+    state.SetMaxIterations(20);
+
+    state.Run([&image, width, height]()
+    {
+        ImageData roughness((uint8_t*)std::malloc(image.GetTotalByteSize()), width, height, 1, false);
+        ImageData metallic((uint8_t*)std::malloc(image.GetTotalByteSize()), width, height, 1, false);
+        for (size_t x = 0; x < width; x++)
+        {
+            for (size_t y = 0; y < height; y++)
+            {
+                auto pixel = image.GetPixelByte(x, y);
+                roughness.SetPixelByte(x, y, pixel[1], 0, 0, 0);
+                metallic.SetPixelByte(x, y, pixel[2], 0, 0, 0);
+            }
+        }
+        DoNotOptimize(roughness.GetRawData()[0]);
+        DoNotOptimize(metallic.GetRawData()[0]);
+    });
+
+    state.SetItemsPerIteration(width * height);
+    state.SetBytesPerIteration(image.GetTotalByteSize());
+}
+
+MX_BENCHMARK(ChannelSplitExtractChannel, 2048, 4096, 8192)
+{
+    auto image = MakeMetallicRoughnessImage(state.GetArgument());
+    state.SetMaxIterations(20);
+
+    state.Run([&image]()
+    {
+        // roughness is stored in G channel, metallic in B channel
+        auto roughness = ImageConverter::ExtractChannel(image, 1);
+        auto metallic = ImageConverter::ExtractChannel(image, 2);
+        DoNotOptimize(roughness.GetRawData()[0]);
+        DoNotOptimize(metallic.GetRawData()[0]);
+    });
+
+    state.SetItemsPerIteration(image.GetWidth() * image.GetHeight());
+    state.SetBytesPerIteration(image.GetTotalByteSize());
+}
+
+MX_BENCHMARK(EquirectFloatToHalfScalar, 2048, 4096)
+{
+    auto image = MakeEquirectangularImage(state.GetArgument());
+    size_t elementCount = image.GetWidth() * image.GetHeight() * image.GetChannelCount();
+    auto source = (const float*)image.GetRawData();
+    MxVector<uint16_t> destination(elementCount);
+    state.SetMaxIterations(20);
+
+    state.Run([source, &destination, elementCount]()
+    {
+        for (size_t i = 0; i < elementCount; i++)
+            destination[i] = ImageConverter::FloatToHalf(source[i]);
+        DoNotOptimize(destination[0]);
+    });
+
+    state.SetItemsPerIteration(elementCount);
+    state.SetBytesPerIteration(image.GetTotalByteSize());
+}
+
+MX_BENCHMARK(EquirectFloatToHalfBulk, 2048, 4096)
+{
+    auto image = MakeEquirectangularImage(state.GetArgument());
+    size_t elementCount = image.GetWidth() * image.GetHeight() * image.GetChannelCount();
+    state.SetMaxIterations(20);
+
+    state.Run([&image]()
+    {
+        auto half = ImageConverter::ConvertToHalfFloat(image);
+        DoNotOptimize(half.GetRawData()[0]);
+    });
+
+    state.SetItemsPerIteration(elementCount);
+    state.SetBytesPerIteration(image.GetTotalByteSize());
+}
+
+MX_BENCHMARK(EquirectLoadHDR, 2048, 4096)
+{
+    // decoding of .hdr file as it is done for environment maps which were not cooked
+    auto image = MakeEquirectangularImage(state.GetArgument());
+    auto hdr = ImageConverter::ConvertImageHDR(image);
+    state.SetMaxIterations(10);
+
+    state.Run([&hdr]()
+    {
+        auto loaded = ImageLoader::LoadImageFromMemory(hdr.data(), hdr.size());
+        DoNotOptimize(loaded.GetRawData());
+    });
+
+    state.SetItemsPerIteration(image.GetWidth() * image.GetHeight());
+    state.SetBytesPerIteration(hdr.size());
+    state.AddCounter("file MB", double(hdr.size()) / double(1 << 20));
+}
+
+MX_BENCHMARK(EquirectLoadHDRAsHalf, 2048, 4096)
+{
+    auto image = MakeEquirectangularImage(state.GetArgument());
+    auto hdr = ImageConverter::ConvertImageHDR(image);
+    state.SetMaxIterations(10);
+
+    state.Run([&hdr]()
+    {
+        auto loaded = ImageLoader::LoadImageFromMemory(hdr.data(), hdr.size());
+        auto half = ImageConverter::ConvertToHalfFloat(loaded);
+        DoNotOptimize(half.GetRawData());
+    });
+
+    state.SetItemsPerIteration(image.GetWidth() * image.GetHeight());
+    state.SetBytesPerIteration(hdr.size());
+}
+
+MX_BENCHMARK(EquirectLoadRawHalf, 2048, 4096)
+{
+    // cooked environment maps are stored as raw half float images and need no decoding
+    auto image = MakeEquirectangularImage(state.GetArgument());
+    auto raw = ImageConverter::ConvertImageRAW(ImageConverter::ConvertToHalfFloat(image));
+    state.SetMaxIterations(10);
+
+    state.Run([&raw]()
+    {
+        auto loaded = ImageLoader::LoadImageFromMemory(raw.data(), raw.size());
+        DoNotOptimize(loaded.GetRawData());
+    });
+
+    state.SetItemsPerIteration(image.GetWidth() * image.GetHeight());
+    state.SetBytesPerIteration(raw.size());
+    state.AddCounter("file MB", double(raw.size()) / double(1 << 20));
+}
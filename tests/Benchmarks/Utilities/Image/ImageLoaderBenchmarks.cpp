@@ -0,0 +1,139 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/BenchmarkFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Utilities/Image/ImageLoader.h"
+#include "Utilities/Threading/ThreadPool.h"
+
+#include <random>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+using namespace MxEngine;
+using namespace MxEngine::Benchmarks;
+using MxEngine::Tests::ModuleScope;
+
+namespace
+{
+    ImageData MakeBenchmarkImage(size_t width, size_t height, ImageFormat format)
+    {
+        std::mt19937 random(5);
+        size_t elementCount = width * height * 4;
+        if (format == ImageFormat::FLOAT)
+        {
+            std::uniform_real_distribution<float> radiance(0.0f, 16.0f);
+            auto data = (float*)std::malloc(elementCount * sizeof(float));
+            for (size_t i = 0; i < elementCount; i++)
+                data[i] = radiance(random);
+            return ImageData((uint8_t*)data, width, height, 4, format);
+        }
+        auto data = (uint8_t*)std::malloc(elementCount);
+        for (size_t i = 0; i < elementCount; i++)
+            data[i] = (uint8_t)random();
+        return ImageData(data, width, height, 4, format);
+    }
+
+    void RunEquirectangularBenchmark(BenchmarkState& state, ImageFormat format)
+    {
+        ModuleScope<ThreadPool> modules;
+        // 2:1 panorama, faces are quarter of its width as CreateCubemapFromEquirectangular selects by default
+        auto image = MakeBenchmarkImage(state.GetArgument(), state.GetArgument() / 2, format);
+        size_t faceSize = image.GetWidth() / 4;
+        state.SetMaxIterations(10);
+
+        state.Run([&image]()
+        {
+            auto faces = ImageLoader::CreateCubemapFromEquirectangular(image);
+            DoNotOptimize(faces[0].data()[0]);
+        });
+
+        state.SetItemsPerIteration(6 * faceSize * faceSize);
+        state.SetBytesPerIteration(image.GetTotalByteSize());
+        state.AddCounter("workers", (double)ThreadPool::GetWorkerCount());
+    }
+}
+
+MX_BENCHMARK(CubemapFromCrossPerFace, 2048, 4096)
+{
+    // reference implementation which copied faces one by one before rows were split between threads
+    auto image = MakeBenchmarkImage(state.GetArgument(), state.GetArgument() / 4 * 3, ImageFormat::BYTE);
+    size_t faceSize = image.GetWidth() / 4;
+    size_t pixelSize = image.GetPixelSize();
+    state.SetMaxIterations(20);
+
+    state.Run([&image, faceSize, pixelSize]()
+    {
+        constexpr size_t CrossCells[6][2] = { { 2, 1 }, { 0, 1 }, { 1, 0 }, { 1, 2 }, { 1, 1 }, { 3, 1 } };
+        ImageLoader::ImageArray faces;
+        for (size_t face = 0; face < faces.size(); face++)
+        {
+            faces[face].resize(faceSize, faceSize * pixelSize);
+            for (size_t i = 0; i < faceSize; i++)
+            {
+                size_t y = i + CrossCells[face][1] * faceSize;
+                size_t x = CrossCells[face][0] * faceSize;
+                std::memcpy(faces[face][i].data(), image.GetRawData() + (y * image.GetWidth() + x) * pixelSize, faceSize * pixelSize);
+            }
+        }
+        DoNotOptimize(faces[0].data()[0]);
+    });
+
+    state.SetItemsPerIteration(6 * faceSize * faceSize);
+    state.SetBytesPerIteration(6 * faceSize * faceSize * pixelSize);
+}
+
+MX_BENCHMARK(CubemapFromCross, 2048, 4096)
+{
+    ModuleScope<ThreadPool> modules;
+    auto image = MakeBenchmarkImage(state.GetArgument(), state.GetArgument() / 4 * 3, ImageFormat::BYTE);
+    size_t faceSize = image.GetWidth() / 4;
+    state.SetMaxIterations(20);
+
+    state.Run([&image]()
+    {
+        auto faces = ImageLoader::CreateCubemap(image);
+        DoNotOptimize(faces[0].data()[0]);
+    });
+
+    state.SetItemsPerIteration(6 * faceSize * faceSize);
+    state.SetBytesPerIteration(6 * faceSize * faceSize * image.GetPixelSize());
+    state.AddCounter("workers", (double)ThreadPool::GetWorkerCount());
+}
+
+MX_BENCHMARK(CubemapFromEquirectangularBytes, 2048, 4096)
+{
+    RunEquirectangularBenchmark(state, ImageFormat::BYTE);
+}
+
+MX_BENCHMARK(CubemapFromEquirectangularFloats, 2048, 4096)
+{
+    RunEquirectangularBenchmark(state, ImageFormat::FLOAT);
+}
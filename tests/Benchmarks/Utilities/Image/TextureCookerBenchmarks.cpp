@@ -0,0 +1,155 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/BenchmarkFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Utilities/Image/TextureCooker.h"
+#include "Utilities/Threading/ThreadPool.h"
+
+#include <random>
+#include <cmath>
+#include <cstdlib>
+
+using namespace MxEngine;
+using namespace MxEngine::Benchmarks;
+using MxEngine::Tests::ModuleScope;
+
+namespace
+{
+    ImageData MakeBenchmarkImage(size_t size, size_t channels)
+    {
+        // smooth gradients with noise, so encoders do not hit trivial single-color blocks
+        std::mt19937 random(3);
+        std::uniform_int_distribution<int> noise(-8, 8);
+        auto data = (uint8_t*)std::malloc(size * size * channels);
+        for (size_t y = 0; y < size; y++)
+        {
+            for (size_t x = 0; x < size; x++)
+            {
+                float u = float(x) / float(size), v = float(y) / float(size);
+                float values[4] = { 0.5f + 0.4f * std::sin(u * 40.0f), u, v, 0.5f + 0.5f * std::cos((u + v) * 20.0f) };
+                for (size_t c = 0; c < channels; c++)
+                {
+                    int value = int(values[c] * 255.0f) + noise(random);
+                    data[(y * size + x) * channels + c] = (uint8_t)std::min(std::max(value, 0), 255);
+                }
+            }
+        }
+        return ImageData(data, size, size, channels, false);
+    }
+
+    void RunEncodeBenchmark(BenchmarkState& state, TextureCompression compression, size_t channels)
+    {
+        ModuleScope<ThreadPool> modules;
+        auto image = MakeBenchmarkImage(state.GetArgument(), channels);
+        size_t compressedSize = 0;
+        state.SetMaxIterations(20);
+
+        state.Run([&image, &compressedSize, compression]()
+        {
+            auto blocks = TextureCooker::CompressImage(image, compression);
+            compressedSize = blocks.size();
+            DoNotOptimize(blocks.data()[0]);
+        });
+
+        state.SetItemsPerIteration(image.GetWidth() * image.GetHeight());
+        state.SetBytesPerIteration(image.GetTotalByteSize());
+        state.AddCounter("workers", (double)ThreadPool::GetWorkerCount());
+        state.AddCounter("ratio", (double)image.GetTotalByteSize() / (double)compressedSize);
+    }
+}
+
+MX_BENCHMARK(TextureEncodeBC1, 1024, 2048, 4096)
+{
+    RunEncodeBenchmark(state, TextureCompression::BC1, 3);
+}
+
+MX_BENCHMARK(TextureEncodeBC3, 1024, 2048, 4096)
+{
+    RunEncodeBenchmark(state, TextureCompression::BC3, 4);
+}
+
+MX_BENCHMARK(TextureEncodeBC4, 1024, 2048, 4096)
+{
+    RunEncodeBenchmark(state, TextureCompression::BC4, 1);
+}
+
+MX_BENCHMARK(TextureEncodeBC5, 1024, 2048, 4096)
+{
+    RunEncodeBenchmark(state, TextureCompression::BC5, 3);
+}
+
+MX_BENCHMARK(TextureCookColor, 1024, 2048)
+{
+    // full pipeline: sRGB mip chain generation and compression of every level
+    ModuleScope<ThreadPool> modules;
+    auto image = MakeBenchmarkImage(state.GetArgument(), 4);
+    size_t cookedSize = 0;
+    state.SetMaxIterations(10);
+
+    state.Run([&image, &cookedSize]()
+    {
+        auto texture = TextureCooker::Cook(image, TextureUsage::COLOR);
+        cookedSize = 0;
+        for (const auto& mip : texture.Mips)
+            cookedSize += mip.size();
+    });
+
+    state.SetItemsPerIteration(image.GetWidth() * image.GetHeight());
+    state.SetBytesPerIteration(image.GetTotalByteSize());
+    state.AddCounter("cooked KB", (double)cookedSize / 1024.0);
+}
+
+MX_BENCHMARK(TextureCookMask, 1024, 2048)
+{
+    // grayscale mask decoded as RGBA, as roughness and metallic maps are loaded from files. Only one channel is cooked into BC4
+    ModuleScope<ThreadPool> modules;
+    auto image = MakeBenchmarkImage(state.GetArgument(), 4);
+    auto data = image.GetRawData();
+    for (size_t i = 0; i < image.GetWidth() * image.GetHeight(); i++)
+    {
+        data[i * 4 + 1] = data[i * 4 + 2] = data[i * 4 + 0];
+        data[i * 4 + 3] = 255;
+    }
+    size_t cookedSize = 0;
+    state.SetMaxIterations(10);
+
+    state.Run([&image, &cookedSize]()
+    {
+        auto texture = TextureCooker::Cook(image, TextureUsage::MASK);
+        cookedSize = 0;
+        for (const auto& mip : texture.Mips)
+            cookedSize += mip.size();
+    });
+
+    state.SetItemsPerIteration(image.GetWidth() * image.GetHeight());
+    state.SetBytesPerIteration(image.GetTotalByteSize());
+    state.AddCounter("cooked KB", (double)cookedSize / 1024.0);
+    state.AddCounter("ratio", (double)image.GetTotalByteSize() / (double)cookedSize);
+}
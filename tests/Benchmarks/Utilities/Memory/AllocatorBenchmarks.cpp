@@ -0,0 +1,277 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/BenchmarkFramework.h"
+#include "Utilities/Memory/PoolAllocator.h"
+#include "Utilities/Memory/RandomAllocator.h"
+#include "Utilities/Memory/LinearAllocator.h"
+#include "Utilities/Memory/StackAllocator.h"
+#include "Utilities/Memory/ChunkAllocator.h"
+#include "FreeListAllocator.h"
+
+#include <vector>
+#include <random>
+#include <memory>
+#include <cstdlib>
+#include <cstddef>
+#include <type_traits>
+
+using namespace MxEngine;
+using namespace MxEngine::Benchmarks;
+
+namespace
+{
+    /*!
+    size distributions of allocation requests, passed as benchmark argument
+    */
+    enum class SizeDistribution : size_t
+    {
+        FIXED_64,        // every request is 64 bytes (component-like objects)
+        UNIFORM_16_1024, // uniform in [16, 1024]
+        MIXED,           // 95% in [16, 256], 5% in [4KB, 64KB] (small objects with occasional buffers)
+    };
+
+    constexpr size_t LiveAllocations = 1024;
+    constexpr size_t OperationsPerIteration = 4096;
+    constexpr size_t ChunkSize = 128 * 1024 * 1024;
+
+    /*!
+    pregenerated trace: initial live set and sequence of (slot to free, size to allocate into it) replacements
+    */
+    struct AllocationTrace
+    {
+        std::vector<size_t> InitialSizes;
+        std::vector<size_t> Slots;
+        std::vector<size_t> Sizes;
+        size_t TotalBytes = 0;
+    };
+
+    size_t GenerateSize(SizeDistribution distribution, std::mt19937& random)
+    {
+        switch (distribution)
+        {
+        case SizeDistribution::FIXED_64:
+            return 64;
+        case SizeDistribution::UNIFORM_16_1024:
+            return std::uniform_int_distribution<size_t>(16, 1024)(random);
+        case SizeDistribution::MIXED:
+            if (std::uniform_int_distribution<size_t>(0, 99)(random) < 5)
+                return std::uniform_int_distribution<size_t>(4 * 1024, 64 * 1024)(random);
+            return std::uniform_int_distribution<size_t>(16, 256)(random);
+        }
+        return 0;
+    }
+
+    AllocationTrace GenerateTrace(SizeDistribution distribution)
+    {
+        AllocationTrace trace;
+        std::mt19937 random(42);
+        std::uniform_int_distribution<size_t> slot(0, LiveAllocations - 1);
+        for (size_t i = 0; i < LiveAllocations; i++)
+            trace.InitialSizes.push_back(GenerateSize(distribution, random));
+        for (size_t i = 0; i < OperationsPerIteration; i++)
+        {
+            trace.Slots.push_back(slot(random));
+            trace.Sizes.push_back(GenerateSize(distribution, random));
+            trace.TotalBytes += trace.Sizes.back();
+        }
+        return trace;
+    }
+
+    template<typename AllocFunc, typename FreeFunc>
+    void RunTrace(BenchmarkState& state, AllocFunc&& alloc, FreeFunc&& free)
+    {
+        auto trace = GenerateTrace((SizeDistribution)state.GetArgument());
+
+        using Handle = decltype(alloc(size_t(0)));
+        std::vector<Handle> live;
+        for (size_t size : trace.InitialSizes)
+            live.push_back(alloc(size));
+
+        state.Run([&]()
+        {
+            for (size_t i = 0; i < OperationsPerIteration; i++)
+            {
+                Handle& handle = live[trace.Slots[i]];
+                free(handle);
+                handle = alloc(trace.Sizes[i]);
+            }
+            DoNotOptimize(live.back());
+        });
+
+        for (Handle& handle : live)
+            free(handle);
+
+        state.SetItemsPerIteration(OperationsPerIteration);
+        state.SetBytesPerIteration(trace.TotalBytes);
+    }
+
+    /*!
+    frame-style pattern for allocators without random free: all requests of the trace are allocated, then released at once by release(live)
+    */
+    template<typename AllocFunc, typename ReleaseFunc>
+    void RunFrameTrace(BenchmarkState& state, AllocFunc&& alloc, ReleaseFunc&& release)
+    {
+        auto trace = GenerateTrace((SizeDistribution)state.GetArgument());
+
+        std::vector<uint8_t*> live;
+        live.reserve(OperationsPerIteration);
+
+        state.Run([&]()
+        {
+            live.clear();
+            for (size_t i = 0; i < OperationsPerIteration; i++)
+                live.push_back(alloc(trace.Sizes[i]));
+            DoNotOptimize(live.back());
+            release(live);
+        });
+
+        state.SetItemsPerIteration(OperationsPerIteration);
+        state.SetBytesPerIteration(trace.TotalBytes);
+    }
+}
+
+MX_BENCHMARK(AllocatorMalloc, 0, 1, 2)
+{
+    RunTrace(state,
+        [](size_t size)
+        {
+            auto* ptr = (uint8_t*)std::malloc(size);
+            ptr[0] = 1;
+            return ptr;
+        },
+        [](uint8_t* ptr) { std::free(ptr); });
+}
+
+MX_BENCHMARK(AllocatorRandomAllocator, 0, 1, 2)
+{
+    auto chunk = std::make_unique<uint64_t[]>(ChunkSize / sizeof(uint64_t));
+    RandomAllocator allocator((uint8_t*)chunk.get(), ChunkSize);
+
+    RunTrace(state,
+        [&allocator](size_t size)
+        {
+            uint8_t* ptr = allocator.RawAlloc(size, alignof(std::max_align_t));
+            ptr[0] = 1;
+            return ptr;
+        },
+        [&allocator](uint8_t* ptr) { allocator.RawFree(ptr); });
+}
+
+MX_BENCHMARK(AllocatorFreeListAllocator, 0, 1, 2)
+{
+    // FreeListAllocator manages offsets in GPU buffers, so it never touches allocated memory itself
+    Allocators::FreeListAllocator allocator;
+    allocator.Init(ChunkSize, [](size_t) { });
+
+    RunTrace(state,
+        [&allocator](size_t size) { return allocator.Allocate(size); },
+        [&allocator](size_t offset) { allocator.Deallocate(offset); });
+}
+
+MX_BENCHMARK(AllocatorPoolAllocator)
+{
+    // pool allocator serves only fixed-size requests, so it is measured with the FIXED_64 trace only
+    using Object = std::aligned_storage_t<64, 16>;
+    using Block = PoolAllocator<Object>::Block;
+    auto chunk = std::make_unique<std::aligned_storage_t<sizeof(Block), alignof(Block)>[]>(LiveAllocations);
+    PoolAllocator<Object> allocator((uint8_t*)chunk.get(), LiveAllocations * sizeof(Block));
+
+    RunTrace(state,
+        [&allocator](size_t)
+        {
+            Object* ptr = allocator.Alloc();
+            ((uint8_t*)ptr)[0] = 1;
+            return ptr;
+        },
+        [&allocator](Object* ptr) { allocator.Free(ptr); });
+}
+
+MX_BENCHMARK(AllocatorChunkAllocator, 0, 1, 2)
+{
+    // chunk allocator rounds every request up to whole chunks
+    RunTrace(state,
+        [](size_t size)
+        {
+            uint8_t* ptr = ChunkAllocator::RawAlloc((size + ChunkAllocator::ChunkSize - 1) / ChunkAllocator::ChunkSize);
+            ptr[0] = 1;
+            return ptr;
+        },
+        [](uint8_t* ptr) { ChunkAllocator::Free(ptr); });
+}
+
+MX_BENCHMARK(AllocatorMallocFrame, 0, 1, 2)
+{
+    RunFrameTrace(state,
+        [](size_t size)
+        {
+            auto* ptr = (uint8_t*)std::malloc(size);
+            ptr[0] = 1;
+            return ptr;
+        },
+        [](std::vector<uint8_t*>& live)
+        {
+            for (uint8_t* ptr : live)
+                std::free(ptr);
+        });
+}
+
+MX_BENCHMARK(AllocatorLinearAllocator, 0, 1, 2)
+{
+    auto chunk = std::make_unique<uint64_t[]>(ChunkSize / sizeof(uint64_t));
+    LinearAllocator allocator((uint8_t*)chunk.get(), ChunkSize);
+
+    RunFrameTrace(state,
+        [&allocator](size_t size)
+        {
+            uint8_t* ptr = allocator.RawAlloc(size, alignof(std::max_align_t));
+            ptr[0] = 1;
+            return ptr;
+        },
+        [&allocator](std::vector<uint8_t*>&) { allocator.Reset(); });
+}
+
+MX_BENCHMARK(AllocatorStackAllocator, 0, 1, 2)
+{
+    auto chunk = std::make_unique<uint64_t[]>(ChunkSize / sizeof(uint64_t));
+    StackAllocator allocator((uint8_t*)chunk.get(), ChunkSize);
+
+    RunFrameTrace(state,
+        [&allocator](size_t size)
+        {
+            uint8_t* ptr = allocator.RawAlloc(size, alignof(std::max_align_t));
+            ptr[0] = 1;
+            return ptr;
+        },
+        [&allocator](std::vector<uint8_t*>& live)
+        {
+            for (auto it = live.rbegin(); it != live.rend(); it++)
+                allocator.RawFree(*it);
+        });
+}
@@ -0,0 +1,166 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/BenchmarkFramework.h"
+#include "Utilities/ObjectLoading/MeshOptimizer.h"
+
+#include <random>
+#include <cmath>
+
+using namespace MxEngine;
+using namespace MxEngine::Benchmarks;
+
+namespace
+{
+    struct BenchmarkMesh
+    {
+        MeshData::VertexData Vertecies;
+        MeshData::IndexData Indicies;
+
+        size_t GetTriangleCount() const { return Indicies.size() / 3; }
+    };
+
+    /*!
+    generates uv-sphere with 4 * stacks^2 triangles in random order, which is the worst case for post-transform cache
+    */
+    BenchmarkMesh GenerateShuffledSphere(size_t stacks)
+    {
+        constexpr float Pi = 3.14159265358979f;
+        size_t slices = 2 * stacks;
+
+        BenchmarkMesh mesh;
+        for (size_t stack = 0; stack <= stacks; stack++)
+        {
+            float phi = Pi * (float)stack / (float)stacks;
+            for (size_t slice = 0; slice <= slices; slice++)
+            {
+                float theta = 2.0f * Pi * (float)slice / (float)slices;
+                Vertex vertex;
+                vertex.Position = MakeVector3(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta));
+                vertex.TexCoord = MakeVector2((float)slice / (float)slices, (float)stack / (float)stacks);
+                mesh.Vertecies.push_back(vertex);
+            }
+        }
+        for (size_t stack = 0; stack < stacks; stack++)
+        {
+            for (size_t slice = 0; slice < slices; slice++)
+            {
+                uint32_t i0 = uint32_t(stack * (slices + 1) + slice);
+                uint32_t i2 = i0 + uint32_t(slices + 1);
+                uint32_t quad[6] = { i0, i0 + 1, i2, i0 + 1, i2 + 1, i2 };
+                mesh.Indicies.insert(mesh.Indicies.end(), std::begin(quad), std::end(quad));
+            }
+        }
+
+        std::mt19937 random(17);
+        for (size_t i = mesh.GetTriangleCount(); i > 1; i--)
+        {
+            size_t j = std::uniform_int_distribution<size_t>(0, i - 1)(random);
+            for (size_t k = 0; k < 3; k++)
+                std::swap(mesh.Indicies[3 * (i - 1) + k], mesh.Indicies[3 * j + k]);
+        }
+        return mesh;
+    }
+
+    /*!
+    runs optimization pass over a fresh copy of source mesh each iteration and reports ACMR and ATVR before and after it
+    */
+    template<typename Pass>
+    void BenchmarkPass(BenchmarkState& state, const BenchmarkMesh& source, Pass&& pass)
+    {
+        BenchmarkMesh mesh;
+        state.SetMaxIterations(20);
+        state.Run([&]() { mesh = source; }, [&]()
+        {
+            pass(mesh);
+            DoNotOptimize(mesh.Indicies.data());
+        });
+
+        auto before = MeshOptimizer::AnalyzeVertexCache(source.Indicies, source.Vertecies.size());
+        auto after = MeshOptimizer::AnalyzeVertexCache(mesh.Indicies, mesh.Vertecies.size());
+        state.SetItemsPerIteration(source.GetTriangleCount());
+        state.AddCounter("ACMR before", before.ACMR);
+        state.AddCounter("ACMR after", after.ACMR);
+        state.AddCounter("ATVR after", after.ATVR);
+    }
+}
+
+// arguments are sphere stacks: 10K, 100K and 1M triangles
+MX_BENCHMARK(VertexCacheForsyth, 50, 158, 500)
+{
+    auto source = GenerateShuffledSphere(state.GetArgument());
+    BenchmarkPass(state, source, [](BenchmarkMesh& mesh)
+    {
+        MeshOptimizer::OptimizeVertexCache(mesh.Indicies, mesh.Vertecies.size());
+    });
+}
+
+MX_BENCHMARK(VertexCacheTipsify, 50, 158, 500)
+{
+    auto source = GenerateShuffledSphere(state.GetArgument());
+    BenchmarkPass(state, source, [](BenchmarkMesh& mesh)
+    {
+        MeshOptimizer::OptimizeVertexCacheTipsify(mesh.Indicies, mesh.Vertecies.size());
+    });
+}
+
+/*!
+overdraw pass alone, source mesh is already cache-optimized by Tipsify
+*/
+MX_BENCHMARK(OverdrawOrdering, 50, 158, 500)
+{
+    auto source = GenerateShuffledSphere(state.GetArgument());
+    MeshOptimizer::OptimizeVertexCacheTipsify(source.Indicies, source.Vertecies.size());
+    BenchmarkPass(state, source, [](BenchmarkMesh& mesh)
+    {
+        MeshOptimizer::OptimizeOverdraw(mesh.Indicies, mesh.Vertecies);
+    });
+}
+
+MX_BENCHMARK(VertexFetchRemap, 50, 158, 500)
+{
+    auto source = GenerateShuffledSphere(state.GetArgument());
+    BenchmarkPass(state, source, [](BenchmarkMesh& mesh)
+    {
+        MeshOptimizer::OptimizeVertexFetch(mesh.Vertecies, mesh.Indicies);
+    });
+}
+
+/*!
+full pipeline as run by importer and primitives: argument selects vertex cache algorithm, 0 - Forsyth, 1 - Tipsify
+*/
+MX_BENCHMARK(MeshOptimize, 0, 1)
+{
+    auto source = GenerateShuffledSphere(158);
+    auto algorithm = state.GetArgument() == 0 ? VertexCacheAlgorithm::FORSYTH : VertexCacheAlgorithm::TIPSIFY;
+    BenchmarkPass(state, source, [algorithm](BenchmarkMesh& mesh)
+    {
+        MeshOptimizer::Optimize(mesh.Vertecies, mesh.Indicies, algorithm);
+    });
+}
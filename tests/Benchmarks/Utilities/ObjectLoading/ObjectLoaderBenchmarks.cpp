@@ -0,0 +1,443 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/BenchmarkFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Utilities/ObjectLoading/ObjectLoader.h"
+#include "Utilities/Image/ImageConverter.h"
+#include "Utilities/Image/TextureCooker.h"
+#include "Utilities/Threading/ThreadPool.h"
+
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+using namespace MxEngine;
+using namespace MxEngine::Benchmarks;
+using MxEngine::Tests::ModuleScope;
+
+namespace
+{
+    constexpr size_t SceneModelCount = 20;
+
+    /*!
+    writes uv-sphere with given tesselation as OBJ file with positions, normals and texture coordinates
+    \returns number of triangles written
+    */
+    size_t WriteSphereObj(const FilePath& path, size_t stacks, size_t slices)
+    {
+        constexpr float Pi = 3.14159265358979f;
+        std::ofstream file(path);
+        for (size_t stack = 0; stack <= stacks; stack++)
+        {
+            float phi = Pi * (float)stack / (float)stacks;
+            for (size_t slice = 0; slice <= slices; slice++)
+            {
+                float theta = 2.0f * Pi * (float)slice / (float)slices;
+                float x = std::sin(phi) * std::cos(theta);
+                float y = std::cos(phi);
+                float z = std::sin(phi) * std::sin(theta);
+                file << "v " << x << ' ' << y << ' ' << z << '\n';
+                file << "vn " << x << ' ' << y << ' ' << z << '\n';
+                file << "vt " << (float)slice / (float)slices << ' ' << (float)stack / (float)stacks << '\n';
+            }
+        }
+        size_t triangleCount = 0;
+        for (size_t stack = 0; stack < stacks; stack++)
+        {
+            for (size_t slice = 0; slice < slices; slice++)
+            {
+                // OBJ indices are 1-based
+                size_t i0 = stack * (slices + 1) + slice + 1;
+                size_t i1 = i0 + 1;
+                size_t i2 = i0 + slices + 1;
+                size_t i3 = i2 + 1;
+                file << "f " << i0 << '/' << i0 << '/' << i0 << ' ' << i2 << '/' << i2 << '/' << i2 << ' ' << i1 << '/' << i1 << '/' << i1 << '\n';
+                file << "f " << i1 << '/' << i1 << '/' << i1 << ' ' << i2 << '/' << i2 << '/' << i2 << ' ' << i3 << '/' << i3 << '/' << i3 << '\n';
+                triangleCount += 2;
+            }
+        }
+        return triangleCount;
+    }
+
+    /*!
+    scene of distinct models, generated once per benchmark run in temporary directory
+    */
+    struct BenchmarkScene
+    {
+        MxVector<FilePath> Paths;
+        size_t TriangleCount = 0;
+
+        BenchmarkScene()
+        {
+            auto directory = std::filesystem::temp_directory_path() / "MxEngineBenchmarks" / "ObjectLoader";
+            std::filesystem::create_directories(directory);
+            for (size_t i = 0; i < SceneModelCount; i++)
+            {
+                auto path = directory / ("sphere_" + std::to_string(i) + ".obj");
+                this->TriangleCount += WriteSphereObj(path, 64 + 8 * i, 128 + 8 * i);
+                this->Paths.push_back(path);
+            }
+        }
+
+        ~BenchmarkScene()
+        {
+            std::error_code error;
+            std::filesystem::remove_all(std::filesystem::temp_directory_path() / "MxEngineBenchmarks" / "ObjectLoader", error);
+        }
+    };
+
+    const BenchmarkScene& GetBenchmarkScene()
+    {
+        static BenchmarkScene scene;
+        return scene;
+    }
+
+    constexpr size_t EmbeddedMaterialCount = 10;
+    constexpr size_t EmbeddedTextureSize = 512;
+
+    void AppendBytes(std::string& buffer, const void* data, size_t byteSize)
+    {
+        buffer.append((const char*)data, byteSize);
+        buffer.resize((buffer.size() + 3) & ~size_t(3), '\0'); // glTF requires 4-byte aligned buffer views
+    }
+
+    /*!
+    encodes distinct texture as PNG. Pattern is smooth, so its compression ratio is close to real textures
+    */
+    ImageConverter::RawImageData MakeEmbeddedTexture(size_t index)
+    {
+        const size_t size = EmbeddedTextureSize;
+        auto data = (uint8_t*)std::malloc(size * size * 4);
+        for (size_t y = 0; y < size; y++)
+        {
+            for (size_t x = 0; x < size; x++)
+            {
+                uint8_t* pixel = data + (y * size + x) * 4;
+                pixel[0] = uint8_t(x + index * 8);
+                pixel[1] = uint8_t(y + index * 16);
+                pixel[2] = uint8_t((x ^ y) + index);
+                pixel[3] = 255;
+            }
+        }
+        ImageData image(data, size, size, 4, ImageFormat::BYTE);
+        return ImageConverter::ConvertImagePNG(image);
+    }
+
+    /*!
+    writes binary glTF with a quad per material. Every material references its own base color, normal and metallic-roughness texture,
+    all of them embedded into the BIN chunk
+    \returns size of written file in bytes
+    */
+    size_t WriteTexturedGlb(const FilePath& path)
+    {
+        const float positions[] = { -1.0f, -1.0f, 0.0f, 1.0f, -1.0f, 0.0f, 1.0f, 1.0f, 0.0f, -1.0f, 1.0f, 0.0f };
+        const float normals[] = { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f };
+        const float texcoords[] = { 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f };
+        const uint16_t indices[] = { 0, 1, 2, 0, 2, 3 };
+
+        std::string binary;
+        std::string bufferViews;
+        auto addBufferView = [&binary, &bufferViews](const void* data, size_t byteSize)
+        {
+            if (!bufferViews.empty()) bufferViews += ',';
+            bufferViews += "{\"buffer\":0,\"byteOffset\":" + std::to_string(binary.size()) + ",\"byteLength\":" + std::to_string(byteSize) + "}";
+            AppendBytes(binary, data, byteSize);
+        };
+        addBufferView(positions, sizeof(positions));
+        addBufferView(normals, sizeof(normals));
+        addBufferView(texcoords, sizeof(texcoords));
+        addBufferView(indices, sizeof(indices));
+
+        std::string primitives, materials, textures, images;
+        for (size_t i = 0; i < EmbeddedMaterialCount * 3; i++)
+        {
+            auto png = MakeEmbeddedTexture(i);
+            std::string separator = i == 0 ? "" : ",";
+            textures += separator + "{\"source\":" + std::to_string(i) + "}";
+            images += separator + "{\"bufferView\":" + std::to_string(4 + i) + ",\"mimeType\":\"image/png\"}";
+            addBufferView(png.data(), png.size());
+        }
+        for (size_t i = 0; i < EmbeddedMaterialCount; i++)
+        {
+            std::string separator = i == 0 ? "" : ",";
+            primitives += separator + "{\"attributes\":{\"POSITION\":0,\"NORMAL\":1,\"TEXCOORD_0\":2},\"indices\":3,\"material\":" + std::to_string(i) + "}";
+            materials += separator + "{\"pbrMetallicRoughness\":{\"baseColorTexture\":{\"index\":" + std::to_string(3 * i) +
+                "},\"metallicRoughnessTexture\":{\"index\":" + std::to_string(3 * i + 2) + "}},\"normalTexture\":{\"index\":" + std::to_string(3 * i + 1) + "}}";
+        }
+
+        std::string json = "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],\"nodes\":[{\"mesh\":0}],"
+            "\"meshes\":[{\"primitives\":[" + primitives + "]}],\"materials\":[" + materials + "],\"textures\":[" + textures + "],\"images\":[" + images + "],"
+            "\"accessors\":["
+            "{\"bufferView\":0,\"componentType\":5126,\"count\":4,\"type\":\"VEC3\",\"min\":[-1,-1,0],\"max\":[1,1,0]},"
+            "{\"bufferView\":1,\"componentType\":5126,\"count\":4,\"type\":\"VEC3\"},"
+            "{\"bufferView\":2,\"componentType\":5126,\"count\":4,\"type\":\"VEC2\"},"
+            "{\"bufferView\":3,\"componentType\":5123,\"count\":6,\"type\":\"SCALAR\"}],"
+            "\"bufferViews\":[" + bufferViews + "],\"buffers\":[{\"byteLength\":" + std::to_string(binary.size()) + "}]}";
+        json.resize((json.size() + 3) & ~size_t(3), ' ');
+
+        // GLB header and chunk headers, see glTF 2.0 specification
+        const uint32_t header[] = { 0x46546C67, 2, uint32_t(12 + 8 + json.size() + 8 + binary.size()) };
+        const uint32_t jsonChunk[] = { uint32_t(json.size()), 0x4E4F534A };
+        const uint32_t binaryChunk[] = { uint32_t(binary.size()), 0x004E4942 };
+
+        std::ofstream file(path, std::ios::binary);
+        file.write((const char*)header, sizeof(header));
+        file.write((const char*)jsonChunk, sizeof(jsonChunk));
+        file.write(json.data(), json.size());
+        file.write((const char*)binaryChunk, sizeof(binaryChunk));
+        file.write(binary.data(), binary.size());
+        return (size_t)header[2];
+    }
+
+    /*!
+    GLB with embedded textures in its own directory, as extracted textures are shared by all objects in the same directory
+    */
+    struct EmbeddedTextureScene
+    {
+        FilePath Directory;
+        FilePath Path;
+        size_t ByteSize = 0;
+
+        EmbeddedTextureScene()
+        {
+            this->Directory = std::filesystem::temp_directory_path() / "MxEngineBenchmarks" / "ObjectLoaderEmbedded";
+            std::filesystem::create_directories(this->Directory);
+            this->Path = this->Directory / "textured.glb";
+            this->ByteSize = WriteTexturedGlb(this->Path);
+        }
+
+        ~EmbeddedTextureScene()
+        {
+            std::error_code error;
+            std::filesystem::remove_all(this->Directory, error);
+        }
+
+        /*!
+        removes files produced by previous imports and cooking with given extension
+        \returns total byte size of removed files
+        */
+        size_t RemoveFiles(const char* extension) const
+        {
+            size_t byteSize = 0;
+            std::error_code error;
+            for (const auto& entry : std::filesystem::directory_iterator(this->Directory))
+            {
+                if (entry.path().extension() != extension) continue;
+                byteSize += (size_t)entry.file_size();
+                std::filesystem::remove(entry.path(), error);
+            }
+            return byteSize;
+        }
+    };
+
+    const EmbeddedTextureScene& GetEmbeddedTextureScene()
+    {
+        static EmbeddedTextureScene scene;
+        return scene;
+    }
+
+    /*!
+    Sponza materials with textures copied to temporary directory, so cooked caches are not written into samples
+    */
+    struct SponzaScene
+    {
+        FilePath Directory;
+        MaterialLibrary Materials;
+
+        SponzaScene()
+        {
+            // benchmarks are run from tests directory, material library stores paths relative to sample directory
+            const FilePath sampleDirectory = FilePath("..") / "samples" / "Sponza" / "Resources" / "Sponza" / "glTF";
+            this->Directory = std::filesystem::temp_directory_path() / "MxEngineBenchmarks" / "Sponza";
+            std::filesystem::create_directories(this->Directory);
+            this->Materials = ObjectLoader::LoadMaterials(sampleDirectory / "Sponza.gltf.mx_matlib");
+
+            auto relocate = [this, &sampleDirectory](FilePath& path)
+            {
+                if (path.empty()) return;
+                // library was dumped on Windows, so separators are converted manually
+                auto name = path.string();
+                name = name.substr(name.find_last_of("\\/") + 1);
+                path = this->Directory / name;
+
+                std::error_code error;
+                if (!std::filesystem::exists(path))
+                    std::filesystem::copy_file(sampleDirectory / name, path, error);
+            };
+            for (auto& material : this->Materials)
+            {
+                for (FilePath* path : { &material.AlbedoMap, &material.EmissiveMap, &material.HeightMap, &material.NormalMap,
+                                        &material.AmbientOcclusionMap, &material.MetallicMap, &material.RoughnessMap })
+                    relocate(*path);
+            }
+        }
+
+        ~SponzaScene()
+        {
+            std::error_code error;
+            std::filesystem::remove_all(this->Directory, error);
+        }
+    };
+}
+
+MX_BENCHMARK(ObjectLoaderLoadMany, 1, 2, 4, 8)
+{
+    const auto& scene = GetBenchmarkScene();
+    auto paths = scene.Paths;
+    const size_t threadCount = state.GetArgument();
+    size_t meshCount = 0;
+    // each iteration imports the whole scene, so a few iterations are enough
+    state.SetMaxIterations(10);
+
+    if (threadCount == 1)
+    {
+        // single-threaded baseline: models are imported one after another on the calling thread
+        state.Run([&paths, &meshCount]()
+        {
+            meshCount = 0;
+            for (const auto& path : paths)
+                meshCount += ObjectLoader::Load(path).meshes.size();
+        });
+    }
+    else
+    {
+        // calling thread executes pending loads while waiting, so it counts as one of the threads
+        ThreadPool::Init(threadCount - 1);
+        state.Run([&paths, &meshCount]()
+        {
+            meshCount = 0;
+            auto futures = ObjectLoader::LoadMany(paths);
+            for (auto& future : futures)
+                meshCount += ThreadPool::Wait(future).meshes.size();
+        });
+        ThreadPool::Destroy();
+    }
+
+    state.SetItemsPerIteration(paths.size());
+    state.AddCounter("meshes", (double)meshCount);
+    state.AddCounter("triangles", (double)scene.TriangleCount);
+}
+
+MX_BENCHMARK(ObjectLoaderLoadEmbeddedTextures, 0, 1)
+{
+    // 0: cold import, embedded textures are decoded and extracted to disk. 1: textures extracted by previous import are reused
+    ModuleScope<ThreadPool> modules;
+    const auto& scene = GetEmbeddedTextureScene();
+    const bool extractTextures = state.GetArgument() == 0;
+    size_t decodedCount = 0;
+    size_t bytesWritten = 0;
+    state.SetMaxIterations(10);
+
+    ObjectLoader::Load(scene.Path); // warm up importer and make sure extracted textures exist
+    state.Run([&scene, extractTextures, &bytesWritten]()
+    {
+        if (extractTextures) bytesWritten = scene.RemoveFiles(ImageConverter::RawImageExtension);
+    },
+    [&scene, &decodedCount]()
+    {
+        decodedCount = ObjectLoader::Load(scene.Path).textures.size();
+    });
+
+    state.SetBytesPerIteration(scene.ByteSize);
+    state.AddCounter("embedded textures", (double)(EmbeddedMaterialCount * 3));
+    state.AddCounter("textures decoded", (double)decodedCount);
+    state.AddCounter("MB written to disk", (double)bytesWritten / (1024.0 * 1024.0));
+}
+
+MX_BENCHMARK(ObjectLoaderCookEmbeddedTextures, 0, 1)
+{
+    // 0: decoded images are handed to texture cooker in memory. 1: extracted textures are read back from disk and decoded again
+    ModuleScope<ThreadPool> modules;
+    const auto& scene = GetEmbeddedTextureScene();
+    const bool useDecodedImages = state.GetArgument() == 0;
+    size_t cookedFromMemory = 0;
+    state.SetMaxIterations(5);
+
+    state.Run([&scene]()
+    {
+        scene.RemoveFiles(ImageConverter::RawImageExtension);
+        scene.RemoveFiles(TextureCooker::CookedTextureExtension);
+    },
+    [&scene, useDecodedImages, &cookedFromMemory]()
+    {
+        auto object = ObjectLoader::Load(scene.Path);
+        MxHashMap<StringId, ImageData> noDecodedImages;
+        ObjectLoader::CookTextures(object.materials, useDecodedImages ? object.textures : noDecodedImages);
+        cookedFromMemory = useDecodedImages ? object.textures.size() : 0;
+    });
+
+    // besides object file itself, every texture which was not handed in memory is read back from its extracted copy
+    size_t bytesRead = scene.ByteSize;
+    if (!useDecodedImages)
+    {
+        for (const auto& entry : std::filesystem::directory_iterator(scene.Directory))
+        {
+            if (entry.path().extension() == ImageConverter::RawImageExtension)
+                bytesRead += (size_t)entry.file_size();
+        }
+    }
+
+    state.AddCounter("textures cooked from memory", (double)cookedFromMemory);
+    state.AddCounter("MB read from disk", (double)bytesRead / (1024.0 * 1024.0));
+}
+
+MX_BENCHMARK(ObjectLoaderCookSponzaTextures)
+{
+    // reports GPU memory saved by cooking Sponza textures compared to uploading them as RGBA8
+    ModuleScope<ThreadPool> modules;
+    SponzaScene scene;
+    TextureCookingInfo info;
+    state.SetMaxIterations(3);
+
+    state.Run([&scene]()
+    {
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(scene.Directory))
+        {
+            if (entry.path().extension() == TextureCooker::CookedTextureExtension)
+                std::filesystem::remove(entry.path(), error);
+        }
+    },
+    [&scene, &info]()
+    {
+        info = ObjectLoader::CookTextures(scene.Materials, MxHashMap<StringId, ImageData>{ });
+    });
+
+    constexpr double Megabyte = 1024.0 * 1024.0;
+    state.SetItemsPerIteration(info.TextureCount);
+    state.AddCounter("materials", (double)scene.Materials.size());
+    state.AddCounter("textures", (double)info.TextureCount);
+    state.AddCounter("RGBA8 MB", (double)info.UncompressedByteSize / Megabyte);
+    state.AddCounter("cooked MB", (double)info.CookedByteSize / Megabyte);
+    state.AddCounter("saved MB", (double)(info.UncompressedByteSize - info.CookedByteSize) / Megabyte);
+}
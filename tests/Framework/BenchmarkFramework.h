@@ -0,0 +1,167 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <initializer_list>
+#include <algorithm>
+
+namespace MxEngine::Benchmarks
+{
+    struct BenchmarkCounter
+    {
+        std::string Name;
+        double Value;
+    };
+
+    /*!
+    state of a single benchmark run. Benchmark function prepares its data, calls Run with measured code and optionally reports
+    processed items, bytes and custom counters (memory, quality metrics etc.), which are printed by benchmark runner
+    */
+    class BenchmarkState
+    {
+        size_t argument = 0;
+        size_t iterations = 0;
+        double totalSeconds = 0.0;
+        double minSeconds = 0.0;
+        double minTime = 0.5;
+        size_t maxIterations = 1000;
+        size_t itemsPerIteration = 0;
+        size_t bytesPerIteration = 0;
+        std::vector<BenchmarkCounter> counters;
+
+        template<typename F>
+        void Measure(F& func)
+        {
+            auto start = std::chrono::steady_clock::now();
+            func();
+            auto end = std::chrono::steady_clock::now();
+            double seconds = std::chrono::duration<double>(end - start).count();
+
+            this->minSeconds = this->iterations == 0 ? seconds : std::min(this->minSeconds, seconds);
+            this->totalSeconds += seconds;
+            this->iterations++;
+        }
+
+        bool IsFinished() const
+        {
+            return this->iterations >= this->maxIterations || (this->iterations > 0 && this->totalSeconds >= this->minTime);
+        }
+    public:
+        BenchmarkState(size_t argument, double minTime) : argument(argument), minTime(minTime) { }
+
+        /*!
+        invokes function repeatedly and measures each invocation. The first invocation is a warm-up and is not measured
+        */
+        template<typename F>
+        void Run(F&& func)
+        {
+            func();
+            while (!this->IsFinished())
+                this->Measure(func);
+        }
+
+        /*!
+        same as Run, but setup function is invoked before each measured invocation and its time is not measured
+        */
+        template<typename S, typename F>
+        void Run(S&& setup, F&& func)
+        {
+            setup();
+            func();
+            while (!this->IsFinished())
+            {
+                setup();
+                this->Measure(func);
+            }
+        }
+
+        size_t GetArgument() const { return this->argument; }
+        size_t GetIterations() const { return this->iterations; }
+        double GetMeanSeconds() const { return this->iterations == 0 ? 0.0 : this->totalSeconds / this->iterations; }
+        double GetMinSeconds() const { return this->minSeconds; }
+        size_t GetItemsPerIteration() const { return this->itemsPerIteration; }
+        size_t GetBytesPerIteration() const { return this->bytesPerIteration; }
+        const std::vector<BenchmarkCounter>& GetCounters() const { return this->counters; }
+
+        void SetItemsPerIteration(size_t items) { this->itemsPerIteration = items; }
+        void SetBytesPerIteration(size_t bytes) { this->bytesPerIteration = bytes; }
+        void SetMaxIterations(size_t count) { this->maxIterations = std::max(count, size_t(1)); }
+        void AddCounter(const std::string& name, double value) { this->counters.push_back(BenchmarkCounter{ name, value }); }
+    };
+
+    using BenchmarkFunction = void(*)(BenchmarkState&);
+
+    struct BenchmarkCase
+    {
+        const char* Name;
+        BenchmarkFunction Function;
+        std::vector<size_t> Arguments;
+    };
+
+    inline std::vector<BenchmarkCase>& GetBenchmarkRegistry()
+    {
+        static std::vector<BenchmarkCase> registry;
+        return registry;
+    }
+
+    struct BenchmarkRegistrar
+    {
+        BenchmarkRegistrar(const char* name, BenchmarkFunction function, std::initializer_list<size_t> arguments)
+        {
+            GetBenchmarkRegistry().push_back(BenchmarkCase{ name, function, arguments });
+        }
+    };
+
+    /*!
+    prevents compiler from optimizing away computation which result is not used
+    */
+    template<typename T>
+    inline void DoNotOptimize(const T& value)
+    {
+        #if defined(_MSC_VER)
+        static volatile const void* sink;
+        sink = &value;
+        #else
+        asm volatile("" : : "r,m"(value) : "memory");
+        #endif
+    }
+}
+
+/*!
+defines benchmark function and registers it in the benchmark runner. Benchmark is run once for each argument passed after its name,
+argument can be retrieved with BenchmarkState::GetArgument. If no arguments are passed, benchmark is run once with zero argument
+*/
+#define MX_BENCHMARK(name, ...)\
+    static void MxBenchmark_##name(::MxEngine::Benchmarks::BenchmarkState&);\
+    static ::MxEngine::Benchmarks::BenchmarkRegistrar MxBenchmarkRegistrar_##name(#name, &MxBenchmark_##name, { __VA_ARGS__ });\
+    static void MxBenchmark_##name(::MxEngine::Benchmarks::BenchmarkState& state)
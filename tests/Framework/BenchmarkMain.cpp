@@ -0,0 +1,99 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/BenchmarkFramework.h"
+#include "Utilities/Logging/Logger.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <cstdlib>
+
+using namespace MxEngine;
+using namespace MxEngine::Benchmarks;
+
+static void PrintResult(const char* name, const BenchmarkState& state)
+{
+    std::printf("%-48s %8zu %14.3f %14.3f", name, state.GetIterations(), state.GetMeanSeconds() * 1e6, state.GetMinSeconds() * 1e6);
+    double seconds = state.GetMeanSeconds();
+    if (state.GetItemsPerIteration() != 0 && seconds > 0.0)
+        std::printf("  items/s=%.3e", state.GetItemsPerIteration() / seconds);
+    if (state.GetBytesPerIteration() != 0 && seconds > 0.0)
+        std::printf("  MB/s=%.2f", state.GetBytesPerIteration() / seconds / (1024.0 * 1024.0));
+    for (const auto& counter : state.GetCounters())
+        std::printf("  %s=%.4g", counter.Name.c_str(), counter.Value);
+    std::printf("\n");
+}
+
+/*!
+runs all registered benchmarks which name contains filter string
+usage: MxEngineBenchmarks [filter] [--min-time=seconds]
+*/
+int main(int argc, char** argv)
+{
+    const char* filter = nullptr;
+    double minTime = 0.5;
+    for (int i = 1; i < argc; i++)
+    {
+        constexpr const char* MinTimeOption = "--min-time=";
+        if (std::strncmp(argv[i], MinTimeOption, std::strlen(MinTimeOption)) == 0)
+            minTime = std::atof(argv[i] + std::strlen(MinTimeOption));
+        else
+            filter = argv[i];
+    }
+
+    #if defined(MXENGINE_TESTS_SOURCE_DIRECTORY)
+    // test data and scripts are looked up relative to tests source directory
+    std::filesystem::current_path(MXENGINE_TESTS_SOURCE_DIRECTORY);
+    #endif
+
+    Logger::Init();
+    Logger::SetLogLevel(VerbosityLevel::ONLY_ERRORS);
+
+    std::printf("%-48s %8s %14s %14s\n", "benchmark", "runs", "mean (us)", "min (us)");
+    for (const auto& benchmark : GetBenchmarkRegistry())
+    {
+        if (filter != nullptr && std::strstr(benchmark.Name, filter) == nullptr)
+            continue;
+
+        auto arguments = benchmark.Arguments;
+        if (arguments.empty()) arguments.push_back(0);
+
+        for (size_t argument : arguments)
+        {
+            BenchmarkState state(argument, minTime);
+            benchmark.Function(state);
+
+            std::string name = benchmark.Name;
+            if (!benchmark.Arguments.empty()) name += "/" + std::to_string(argument);
+            PrintResult(name.c_str(), state);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,212 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Core/Rendering/RenderGraph/SubmissionQueue.h"
+
+#include <vector>
+#include <map>
+#include <cstring>
+
+namespace MxEngine::Tests
+{
+    using VulkanAbstractionLayer::Buffer;
+
+    /*!
+    staging device without GPU. Buffers are emulated in CPU memory and commands are executed in the order they are recorded.
+    Device also counts transfers which access range written by previous transfer without barrier in between
+    */
+    class FakeStagingDevice : public StagingDevice
+    {
+        struct Write
+        {
+            const Buffer* Target;
+            size_t Offset;
+            size_t Size;
+        };
+
+        std::vector<Write> immediateWrites;
+        std::vector<Write> frameWrites;
+
+        void Access(SubmissionTarget target, const Buffer* buffer, size_t offset, size_t size, bool isWrite)
+        {
+            auto& writes = target == SubmissionTarget::FRAME ? this->frameWrites : this->immediateWrites;
+            for (const auto& write : writes)
+            {
+                if (write.Target == buffer && write.Offset < offset + size && offset < write.Offset + write.Size)
+                    this->HazardCount++;
+            }
+            if (isWrite) writes.push_back(Write{ buffer, offset, size });
+        }
+    public:
+        enum class CommandType
+        {
+            UPLOAD,
+            READBACK,
+            COPY,
+            FRAME_BARRIER,
+            FRAME_TRANSFER_BARRIER,
+            IMMEDIATE_BARRIER,
+            SUBMIT,
+        };
+
+        struct Command
+        {
+            CommandType Type;
+            const Buffer* Source;
+            const Buffer* Destination;
+            size_t Size;
+        };
+
+        std::vector<uint8_t> Staging;
+        std::map<const Buffer*, std::vector<uint8_t>> Memory;
+        std::vector<Command> Commands;
+        size_t HazardCount = 0;
+        size_t FramesInFlight = 3;
+
+        void AddBuffer(const Buffer& buffer, size_t byteSize, uint8_t fill = 0)
+        {
+            this->Memory[&buffer].assign(byteSize, fill);
+        }
+
+        size_t CountCommands(CommandType type) const
+        {
+            size_t count = 0;
+            for (const auto& command : this->Commands)
+                count += command.Type == type;
+            return count;
+        }
+
+        bool IsReferenced(const Buffer& buffer) const
+        {
+            for (const auto& command : this->Commands)
+            {
+                if (command.Source == &buffer || command.Destination == &buffer) return true;
+            }
+            return false;
+        }
+
+        virtual uint8_t* CreateStagingMemory(size_t byteSize) override
+        {
+            this->Staging.resize(byteSize);
+            return this->Staging.data();
+        }
+
+        virtual size_t GetFramesInFlight() const override
+        {
+            return this->FramesInFlight;
+        }
+
+        virtual void RecordUpload(SubmissionTarget target, size_t stageOffset, const Buffer& buffer, size_t offset, size_t byteSize) override
+        {
+            this->Access(target, &buffer, offset, byteSize, true);
+            std::memcpy(this->Memory[&buffer].data() + offset, this->Staging.data() + stageOffset, byteSize);
+            this->Commands.push_back(Command{ CommandType::UPLOAD, nullptr, &buffer, byteSize });
+        }
+
+        virtual void RecordReadback(SubmissionTarget target, const Buffer& buffer, size_t offset, size_t stageOffset, size_t byteSize) override
+        {
+            this->Access(target, &buffer, offset, byteSize, false);
+            std::memcpy(this->Staging.data() + stageOffset, this->Memory[&buffer].data() + offset, byteSize);
+            this->Commands.push_back(Command{ CommandType::READBACK, &buffer, nullptr, byteSize });
+        }
+
+        virtual void RecordCopy(SubmissionTarget target, const Buffer& source, size_t sourceOffset, const Buffer& destination, size_t destinationOffset, size_t byteSize) override
+        {
+            this->Access(target, &source, sourceOffset, byteSize, false);
+            this->Access(target, &destination, destinationOffset, byteSize, true);
+            std::memmove(this->Memory[&destination].data() + destinationOffset, this->Memory[&source].data() + sourceOffset, byteSize);
+            this->Commands.push_back(Command{ CommandType::COPY, &source, &destination, byteSize });
+        }
+
+        virtual void RecordFrameBarrier() override
+        {
+            this->frameWrites.clear();
+            this->Commands.push_back(Command{ CommandType::FRAME_BARRIER, nullptr, nullptr, 0 });
+        }
+
+        virtual void RecordFrameTransferBarrier() override
+        {
+            this->frameWrites.clear();
+            this->Commands.push_back(Command{ CommandType::FRAME_TRANSFER_BARRIER, nullptr, nullptr, 0 });
+        }
+
+        virtual void RecordImmediateBarrier() override
+        {
+            this->immediateWrites.clear();
+            this->Commands.push_back(Command{ CommandType::IMMEDIATE_BARRIER, nullptr, nullptr, 0 });
+        }
+
+        virtual void BeginImmediate() override { }
+
+        virtual void EndImmediate() override { }
+
+        virtual void SubmitImmediate() override
+        {
+            // immediate submission waits for GPU, so all transfers are visible after it
+            this->immediateWrites.clear();
+            this->frameWrites.clear();
+            this->Commands.push_back(Command{ CommandType::SUBMIT, nullptr, nullptr, 0 });
+        }
+    };
+
+    /*!
+    submission queue which records commands into fake device for the lifetime of the scope
+    */
+    struct FakeQueueScope
+    {
+        FakeStagingDevice* Device = nullptr;
+
+        explicit FakeQueueScope(size_t stagingCapacity = 64 * KB, size_t framesInFlight = 3)
+        {
+            SubmissionQueue::Init();
+            SubmissionQueue::GetImpl()->StagingCapacity = stagingCapacity;
+            auto device = MakeUnique<FakeStagingDevice>();
+            device->FramesInFlight = framesInFlight;
+            this->Device = device.get();
+            SubmissionQueue::StartQueue(std::move(device));
+        }
+
+        ~FakeQueueScope()
+        {
+            SubmissionQueue::EndQueue();
+            SubmissionQueue::Destroy();
+        }
+    };
+
+    /*!
+    emulates one frame of the main loop: frame uploads are recorded, and frame command buffer is submitted
+    */
+    inline void RunFrame()
+    {
+        SubmissionQueue::SubmitFrameUploads();
+        SubmissionQueue::OnFrameSubmitted();
+    }
+}
@@ -0,0 +1,69 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include <type_traits>
+
+namespace MxEngine::Tests
+{
+    template<typename T, typename = void>
+    struct HasDestroyMethod : std::false_type { };
+
+    template<typename T>
+    struct HasDestroyMethod<T, std::void_t<decltype(T::Destroy())>> : std::true_type { };
+
+    /*!
+    initializes static engine modules for the lifetime of the scope, so tests can use parts of the engine without application context.
+    Modules are initialized in the order they are listed and destroyed in reverse order, if they provide Destroy method
+    */
+    template<typename... Modules>
+    class ModuleScope
+    {
+        template<typename Module, typename... Rest>
+        static void DestroyReversed()
+        {
+            if constexpr (sizeof...(Rest) > 0) DestroyReversed<Rest...>();
+            if constexpr (HasDestroyMethod<Module>::value) Module::Destroy();
+        }
+    public:
+        ModuleScope()
+        {
+            (..., Modules::Init());
+        }
+
+        ~ModuleScope()
+        {
+            DestroyReversed<Modules...>();
+        }
+
+        ModuleScope(const ModuleScope&) = delete;
+        ModuleScope& operator=(const ModuleScope&) = delete;
+    };
+}
@@ -0,0 +1,164 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "Core/Macro/Macro.h"
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <atomic>
+#include <mutex>
+#include <cstdio>
+#include <cmath>
+#include <type_traits>
+
+namespace MxEngine::Tests
+{
+    using TestFunction = void(*)();
+
+    struct TestCase
+    {
+        const char* Suite;
+        const char* Name;
+        TestFunction Function;
+    };
+
+    // thrown by MX_REQUIRE to stop current test, caught by test runner
+    struct TestAbort { };
+
+    inline std::vector<TestCase>& GetTestRegistry()
+    {
+        static std::vector<TestCase> registry;
+        return registry;
+    }
+
+    inline std::atomic<size_t>& GetFailedCheckCount()
+    {
+        static std::atomic<size_t> count{ 0 };
+        return count;
+    }
+
+    struct TestRegistrar
+    {
+        TestRegistrar(const char* suite, const char* name, TestFunction function)
+        {
+            GetTestRegistry().push_back(TestCase{ suite, name, function });
+        }
+    };
+
+    /*!
+    reports failed check. Checks may fail on worker threads, so output is synchronized
+    */
+    inline void ReportFailure(const char* file, int line, const std::string& message)
+    {
+        static std::mutex outputMutex;
+        std::lock_guard<std::mutex> lock(outputMutex);
+        std::printf("%s(%d): check failed: %s\n", file, line, message.c_str());
+        GetFailedCheckCount()++;
+    }
+
+    template<typename T>
+    std::string ToTestString(const T& value)
+    {
+        if constexpr (std::is_enum_v<T>)
+        {
+            return std::to_string((std::underlying_type_t<T>)value);
+        }
+        else if constexpr (std::is_pointer_v<T> || std::is_arithmetic_v<T>)
+        {
+            std::ostringstream stream;
+            stream << value;
+            return stream.str();
+        }
+        else
+        {
+            return "<value>";
+        }
+    }
+
+    template<typename T, typename U>
+    std::string FormatComparison(const char* expression, const T& left, const U& right)
+    {
+        return std::string(expression) + " (" + ToTestString(left) + " vs " + ToTestString(right) + ")";
+    }
+}
+
+/*!
+defines test function and registers it in the test runner. Tests are grouped by suite, each suite is run as a separate ctest test
+*/
+#define MX_TEST(suite, name)\
+    static void MxTest_##suite##_##name();\
+    static ::MxEngine::Tests::TestRegistrar MxTestRegistrar_##suite##_##name(#suite, #name, &MxTest_##suite##_##name);\
+    static void MxTest_##suite##_##name()
+
+#define MX_CHECK(expression)\
+    do { if (!(expression)) ::MxEngine::Tests::ReportFailure(__FILE__, __LINE__, #expression); } while(0)
+
+#define MX_REQUIRE(expression)\
+    do { if (!(expression)) { ::MxEngine::Tests::ReportFailure(__FILE__, __LINE__, #expression); throw ::MxEngine::Tests::TestAbort{ }; } } while(0)
+
+#define MX_CHECK_EQ(left, right)\
+    do {\
+        const auto& mxLeft = (left); const auto& mxRight = (right);\
+        if (!(mxLeft == mxRight)) ::MxEngine::Tests::ReportFailure(__FILE__, __LINE__, ::MxEngine::Tests::FormatComparison(#left " == " #right, mxLeft, mxRight));\
+    } while(0)
+
+#define MX_CHECK_NEAR(left, right, epsilon)\
+    do {\
+        const double mxLeft = (double)(left); const double mxRight = (double)(right);\
+        if (!(std::abs(mxLeft - mxRight) <= (double)(epsilon))) ::MxEngine::Tests::ReportFailure(__FILE__, __LINE__, ::MxEngine::Tests::FormatComparison(#left " ~= " #right, mxLeft, mxRight));\
+    } while(0)
+
+#define MX_CHECK_GE(left, right)\
+    do {\
+        const auto& mxLeft = (left); const auto& mxRight = (right);\
+        if (!(mxLeft >= mxRight)) ::MxEngine::Tests::ReportFailure(__FILE__, __LINE__, ::MxEngine::Tests::FormatComparison(#left " >= " #right, mxLeft, mxRight));\
+    } while(0)
+
+#define MX_CHECK_LE(left, right)\
+    do {\
+        const auto& mxLeft = (left); const auto& mxRight = (right);\
+        if (!(mxLeft <= mxRight)) ::MxEngine::Tests::ReportFailure(__FILE__, __LINE__, ::MxEngine::Tests::FormatComparison(#left " <= " #right, mxLeft, mxRight));\
+    } while(0)
+
+/*!
+checks that expression fails MX_ASSERT. Asserts are compiled out in non-debug builds, so the check (and the expression) is skipped there
+*/
+#if defined(MXENGINE_DEBUG)
+#define MX_CHECK_ASSERTS(expression)\
+    do {\
+        bool mxAsserted = false;\
+        try { (void)(expression); } catch (const ::MxEngine::assert_exception&) { mxAsserted = true; }\
+        if (!mxAsserted) ::MxEngine::Tests::ReportFailure(__FILE__, __LINE__, "expected assert: " #expression);\
+    } while(0)
+#else
+#define MX_CHECK_ASSERTS(expression) do { } while(0)
+#endif
@@ -0,0 +1,87 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Utilities/Logging/Logger.h"
+
+#include <cstring>
+#include <filesystem>
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+/*!
+runs all registered tests, or only tests of suite passed as first argument
+\returns number of failed tests
+*/
+int main(int argc, char** argv)
+{
+    const char* suiteFilter = argc > 1 ? argv[1] : nullptr;
+
+    #if defined(MXENGINE_TESTS_SOURCE_DIRECTORY)
+    // test data and scripts are looked up relative to tests source directory
+    std::filesystem::current_path(MXENGINE_TESTS_SOURCE_DIRECTORY);
+    #endif
+
+    Logger::Init();
+    Logger::SetLogLevel(VerbosityLevel::ONLY_ERRORS);
+
+    size_t runCount = 0;
+    size_t failedCount = 0;
+    for (const auto& test : GetTestRegistry())
+    {
+        if (suiteFilter != nullptr && std::strcmp(suiteFilter, test.Suite) != 0)
+            continue;
+
+        std::printf("[ RUN  ] %s.%s\n", test.Suite, test.Name);
+        size_t failedChecksBefore = GetFailedCheckCount();
+        try
+        {
+            test.Function();
+        }
+        catch (const TestAbort&) { }
+        catch (const std::exception& e)
+        {
+            ReportFailure(__FILE__, __LINE__, std::string("unhandled exception: ") + e.what());
+        }
+
+        bool isPassed = GetFailedCheckCount() == failedChecksBefore;
+        std::printf("[ %s ] %s.%s\n", isPassed ? "OK  " : "FAIL", test.Suite, test.Name);
+        runCount++;
+        failedCount += isPassed ? 0 : 1;
+    }
+
+    if (runCount == 0)
+    {
+        std::printf("no tests matched filter '%s'\n", suiteFilter != nullptr ? suiteFilter : "");
+        return 1;
+    }
+    std::printf("%zu tests run, %zu failed\n", runCount, failedCount);
+    return (int)failedCount;
+}
@@ -0,0 +1,269 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Core/Application/ComponentUpdateScheduler.h"
+#include "Core/Runtime/Reflection.h"
+#include "Utilities/ECS/Component.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/UUID/UUID.h"
+
+#include <atomic>
+#include <thread>
+
+namespace MxEngine
+{
+    static std::atomic<size_t> SchedulerTestSequence{ 0 };
+
+    class SchedulerTestPosition
+    {
+        MAKE_COMPONENT(SchedulerTestPosition);
+    public:
+        SchedulerTestPosition() = default;
+
+        size_t UpdateCount = 0;
+        size_t UpdateSequence = 0;
+
+        void OnUpdate(TimeStep dt)
+        {
+            this->UpdateCount++;
+            this->UpdateSequence = SchedulerTestSequence++;
+        }
+    };
+
+    class SchedulerTestVelocity
+    {
+        MAKE_COMPONENT(SchedulerTestVelocity);
+    public:
+        SchedulerTestVelocity() = default;
+
+        size_t UpdateSequence = 0;
+
+        void OnUpdate(TimeStep dt)
+        {
+            this->UpdateSequence = SchedulerTestSequence++;
+        }
+    };
+
+    class SchedulerTestHealth
+    {
+        MAKE_COMPONENT(SchedulerTestHealth);
+    public:
+        SchedulerTestHealth() = default;
+
+        size_t UpdateCount = 0;
+
+        void OnUpdate(TimeStep dt)
+        {
+            this->UpdateCount++;
+        }
+    };
+
+    class SchedulerTestMainThread
+    {
+        MAKE_COMPONENT(SchedulerTestMainThread);
+    public:
+        SchedulerTestMainThread() = default;
+
+        std::thread::id UpdateThread;
+
+        void OnUpdate(TimeStep dt)
+        {
+            this->UpdateThread = std::this_thread::get_id();
+        }
+    };
+
+    class SchedulerTestUndeclared
+    {
+        MAKE_COMPONENT(SchedulerTestUndeclared);
+    public:
+        SchedulerTestUndeclared() = default;
+
+        void OnUpdate(TimeStep dt) { }
+    };
+
+    MXENGINE_REFLECT_TYPE
+    {
+        rttr::registration::class_<SchedulerTestPosition>("SchedulerTestPosition")
+            (
+                rttr::metadata(UpdateInfo::READS, ComponentTypes<>()),
+                rttr::metadata(UpdateInfo::PARALLEL, true)
+            );
+
+        rttr::registration::class_<SchedulerTestVelocity>("SchedulerTestVelocity")
+            (
+                rttr::metadata(UpdateInfo::WRITES, ComponentTypes<SchedulerTestPosition>())
+            );
+
+        rttr::registration::class_<SchedulerTestHealth>("SchedulerTestHealth")
+            (
+                rttr::metadata(UpdateInfo::READS, ComponentTypes<>()),
+                rttr::metadata(UpdateInfo::PARALLEL, true)
+            );
+
+        rttr::registration::class_<SchedulerTestMainThread>("SchedulerTestMainThread")
+            (
+                rttr::metadata(UpdateInfo::READS, ComponentTypes<>()),
+                rttr::metadata(UpdateInfo::PARALLEL, true),
+                rttr::metadata(UpdateInfo::MAIN_THREAD, true)
+            );
+
+        rttr::registration::class_<SchedulerTestUndeclared>("SchedulerTestUndeclared");
+    }
+}
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+using SchedulerModules = ModuleScope<UUIDGenerator, ThreadPool, ComponentFactory>;
+
+template<typename T>
+static void RegisterTestUpdate(ComponentUpdateScheduler& scheduler)
+{
+    scheduler.RegisterUpdate<T>(rttr::type::get<T>());
+}
+
+MX_TEST(ComponentUpdateScheduler, IndependentUpdatesShareStage)
+{
+    SchedulerModules modules;
+    ComponentUpdateScheduler scheduler;
+    RegisterTestUpdate<SchedulerTestPosition>(scheduler);
+    RegisterTestUpdate<SchedulerTestHealth>(scheduler);
+
+    MX_CHECK_EQ(scheduler.GetStageCount(), size_t(1));
+}
+
+MX_TEST(ComponentUpdateScheduler, WriterIsOrderedAfterReader)
+{
+    SchedulerModules modules;
+    ComponentUpdateScheduler scheduler;
+    RegisterTestUpdate<SchedulerTestPosition>(scheduler);
+    RegisterTestUpdate<SchedulerTestHealth>(scheduler);
+    RegisterTestUpdate<SchedulerTestVelocity>(scheduler);
+
+    // velocity writes positions, so it waits for position update, while health is independent of both
+    MX_CHECK_EQ(scheduler.GetStageCount(), size_t(2));
+}
+
+MX_TEST(ComponentUpdateScheduler, UndeclaredUpdateIsBarrier)
+{
+    SchedulerModules modules;
+    ComponentUpdateScheduler scheduler;
+    RegisterTestUpdate<SchedulerTestHealth>(scheduler);
+    RegisterTestUpdate<SchedulerTestUndeclared>(scheduler);
+    RegisterTestUpdate<SchedulerTestPosition>(scheduler);
+
+    MX_CHECK_EQ(scheduler.GetStageCount(), size_t(3));
+}
+
+MX_TEST(ComponentUpdateScheduler, ConflictingUpdatesKeepRegistrationOrder)
+{
+    SchedulerModules modules;
+    auto velocity = ComponentFactory::CreateComponent<SchedulerTestVelocity>();
+    auto position = ComponentFactory::CreateComponent<SchedulerTestPosition>();
+
+    ComponentUpdateScheduler scheduler;
+    RegisterTestUpdate<SchedulerTestVelocity>(scheduler);
+    RegisterTestUpdate<SchedulerTestPosition>(scheduler);
+
+    for (size_t frame = 0; frame < 16; frame++)
+    {
+        scheduler.Invoke(0.016f);
+        MX_CHECK(velocity->UpdateSequence < position->UpdateSequence);
+    }
+}
+
+MX_TEST(ComponentUpdateScheduler, ParallelUpdateVisitsEachComponentOnce)
+{
+    SchedulerModules modules;
+    constexpr size_t ComponentCount = ComponentUpdateScheduler::ParallelGrainSize * 10 + 17;
+    constexpr size_t FrameCount = 3;
+
+    MxVector<SchedulerTestHealth::Handle> healths;
+    MxVector<SchedulerTestPosition::Handle> positions;
+    for (size_t i = 0; i < ComponentCount; i++)
+    {
+        healths.push_back(ComponentFactory::CreateComponent<SchedulerTestHealth>());
+        positions.push_back(ComponentFactory::CreateComponent<SchedulerTestPosition>());
+    }
+    // leave holes in pools, so that ranges contain unallocated slots
+    for (size_t i = 0; i < ComponentCount; i += 7)
+        healths[i] = SchedulerTestHealth::Handle{ };
+
+    ComponentUpdateScheduler scheduler;
+    RegisterTestUpdate<SchedulerTestHealth>(scheduler);
+    RegisterTestUpdate<SchedulerTestPosition>(scheduler);
+    for (size_t frame = 0; frame < FrameCount; frame++)
+        scheduler.Invoke(0.016f);
+
+    for (auto& health : healths)
+    {
+        if (health.IsValid()) MX_CHECK_EQ(health->UpdateCount, FrameCount);
+    }
+    for (auto& position : positions)
+    {
+        MX_CHECK_EQ(position->UpdateCount, FrameCount);
+    }
+}
+
+MX_TEST(ComponentUpdateScheduler, MainThreadUpdateStaysOnCallingThread)
+{
+    SchedulerModules modules;
+    MxVector<SchedulerTestHealth::Handle> healths;
+    for (size_t i = 0; i < ComponentUpdateScheduler::ParallelGrainSize * 4; i++)
+        healths.push_back(ComponentFactory::CreateComponent<SchedulerTestHealth>());
+    auto mainThread = ComponentFactory::CreateComponent<SchedulerTestMainThread>();
+
+    // main thread update is registered last, so it is not the first update of its stage
+    ComponentUpdateScheduler scheduler;
+    RegisterTestUpdate<SchedulerTestHealth>(scheduler);
+    RegisterTestUpdate<SchedulerTestPosition>(scheduler);
+    RegisterTestUpdate<SchedulerTestMainThread>(scheduler);
+    MX_CHECK_EQ(scheduler.GetStageCount(), size_t(1));
+
+    for (size_t frame = 0; frame < 16; frame++)
+    {
+        scheduler.Invoke(0.016f);
+        MX_CHECK(mainThread->UpdateThread == std::this_thread::get_id());
+    }
+}
+
+MX_TEST(ComponentUpdateScheduler, AccessSetReportsDeclaredComponents)
+{
+    ComponentAccessSet access;
+    access.Self = STRING_ID("SchedulerTestVelocity");
+    access.Writes.push_back(STRING_ID("SchedulerTestPosition"));
+    access.IsDeclared = true;
+
+    MX_CHECK(access.IsWriting(STRING_ID("SchedulerTestVelocity")));
+    MX_CHECK(access.IsWriting(STRING_ID("SchedulerTestPosition")));
+    MX_CHECK(!access.IsReading(STRING_ID("SchedulerTestPosition")));
+    MX_CHECK(!access.IsAccessing(STRING_ID("SchedulerTestHealth")));
+}
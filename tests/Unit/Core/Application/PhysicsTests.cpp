@@ -0,0 +1,254 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Framework/TestFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Core/Application/Physics.h"
+#include "Core/Components/Physics/RigidBody.h"
+#include "Core/Components/Physics/BoxCollider.h"
+#include "Core/Components/Physics/SphereCollider.h"
+#include "Core/MxObject/MxObject.h"
+#include "Platform/Modules/PhysicsModule.h"
+#include "Platform/PhysicsAPI.h"
+#include "Platform/Bullet3/Bullet3Utils.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/UUID/UUID.h"
+
+#include <random>
+#include <array>
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+namespace
+{
+    // objects are destroyed first, so their rigid bodies are removed from the world before physics module is destroyed
+    using PhysicsModules = ModuleScope<UUIDGenerator, ThreadPool, PhysicsModule, ComponentFactory,
+        Factory<SphereShape>, Factory<BoxShape>, Factory<NativeRigidBody>, Factory<MxObject>>;
+
+    constexpr float Epsilon = 1e-5f;
+    constexpr float WorldExtent = 40.0f;
+
+    /*!
+    creates static body with given collision group, so queries with different masks see different subsets of the world
+    */
+    MxObject::Handle CreateStaticBody(const Vector3& position, const Quaternion& rotation, uint32_t group)
+    {
+        auto object = MxObject::Create();
+        object->LocalTransform.SetPosition(position);
+        object->LocalTransform.SetRotation(rotation);
+        auto rigidBody = object->AddComponent<RigidBody>();
+        rigidBody->MakeStatic();
+        rigidBody->SetCollisionFilter(CollisionMask::STATIC, group);
+        return object;
+    }
+
+    /*!
+    fills world with randomly placed and rotated spheres and boxes. Each body gets random non-empty subset of collision groups
+    */
+    void CreateRandomWorld(size_t bodyCount)
+    {
+        std::mt19937 random(7);
+        std::uniform_real_distribution<float> position(0.0f, WorldExtent);
+        std::uniform_real_distribution<float> size(0.3f, 2.0f);
+        std::uniform_real_distribution<float> angle(0.0f, 6.28318530718f);
+        std::uniform_real_distribution<float> axis(-1.0f, 1.0f);
+        std::uniform_int_distribution<uint32_t> group(1, 15);
+
+        for (size_t i = 0; i < bodyCount; i++)
+        {
+            auto rotationAxis = Normalize(MakeVector3(axis(random), axis(random), axis(random)) + MakeVector3(0.0f, 0.01f, 0.0f));
+            auto object = CreateStaticBody(MakeVector3(position(random), position(random), position(random)),
+                MakeQuaternion(angle(random), rotationAxis), group(random));
+
+            if (i % 2 == 0)
+            {
+                auto collider = object->AddComponent<SphereCollider>();
+                collider->SetBoundingSphere(BoundingSphere(MakeVector3(0.0f), size(random)));
+            }
+            else
+            {
+                auto collider = object->AddComponent<BoxCollider>();
+                collider->SetBoundingBox(BoundingBox(MakeVector3(0.0f), MakeVector3(size(random), size(random), size(random))));
+            }
+        }
+        RigidBody::SyncObjectStates();
+    }
+
+    MxVector<Ray> GenerateRandomRays(size_t count)
+    {
+        std::mt19937 random(11);
+        std::uniform_real_distribution<float> position(-5.0f, WorldExtent + 5.0f);
+
+        MxVector<Ray> rays(count);
+        for (auto& ray : rays)
+        {
+            ray.From = MakeVector3(position(random), position(random), position(random));
+            ray.To = MakeVector3(position(random), position(random), position(random));
+        }
+        return rays;
+    }
+
+    bool IsOverlapping(const BoundingBox& box, const MxObject::Handle& object)
+    {
+        std::array boxes = { box };
+        std::array<MxVector<MxObject::Handle>, 1> overlaps;
+        Physics::OverlapBoxBatch(boxes, overlaps, CollisionMask::RAYCAST_ONLY);
+        return overlaps[0].size() == 1 && overlaps[0][0] == object;
+    }
+}
+
+MX_TEST(Physics, RayCastBatchMatchesRayCastWithMasks)
+{
+    PhysicsModules modules;
+    CreateRandomWorld(400);
+    auto rays = GenerateRandomRays(2000);
+    MxVector<RayHit> hits(rays.size());
+
+    std::array masks = {
+        CollisionMask::RAYCAST_ONLY,
+        CollisionMask::STATIC,
+        CollisionMask::Mask(CollisionMask::DYNAMIC | CollisionMask::KINEMATIC),
+        CollisionMask::Mask(CollisionGroup::ALL),
+    };
+
+    for (auto mask : masks)
+    {
+        Physics::RayCastBatch(rays, hits, mask);
+
+        size_t hitCount = 0;
+        for (size_t i = 0; i < rays.size(); i++)
+        {
+            float fraction = 1.0f;
+            auto object = Physics::RayCast(rays[i].From, rays[i].To, fraction, mask);
+
+            MX_CHECK(hits[i].Object == object);
+            MX_CHECK_NEAR(hits[i].Fraction, fraction, Epsilon);
+            if (!object.IsValid()) continue;
+
+            // normal is compared with reference ray, which is cast by bullet itself through the whole world
+            btCollisionWorld::ClosestRayResultCallback reference(ToBulletVector3(rays[i].From), ToBulletVector3(rays[i].To));
+            reference.m_collisionFilterGroup = CollisionGroup::ALL;
+            reference.m_collisionFilterMask = mask;
+            PhysicsModule::GetImpl()->World->rayTest(reference.m_rayFromWorld, reference.m_rayToWorld, reference);
+
+            auto normal = FromBulletVector3(reference.m_hitNormalWorld);
+            MX_CHECK_NEAR(hits[i].Normal.x, normal.x, Epsilon);
+            MX_CHECK_NEAR(hits[i].Normal.y, normal.y, Epsilon);
+            MX_CHECK_NEAR(hits[i].Normal.z, normal.z, Epsilon);
+            hitCount++;
+        }
+        // random world must be dense enough for the comparison to check hits, not only misses
+        MX_CHECK_GE(hitCount, rays.size() / 10);
+    }
+}
+
+MX_TEST(Physics, RayCastBatchReportsMissedRays)
+{
+    PhysicsModules modules;
+    CreateRandomWorld(50);
+
+    std::array rays = { Ray{ MakeVector3(-10.0f), MakeVector3(-20.0f) } };
+    std::array<RayHit, 1> hits;
+    Physics::RayCastBatch(rays, hits, CollisionMask::Mask(CollisionGroup::ALL));
+
+    MX_CHECK(!hits[0].Object.IsValid());
+    MX_CHECK_EQ(hits[0].Fraction, 1.0f);
+    MX_CHECK(hits[0].Position == rays[0].To);
+    MX_CHECK(hits[0].Normal == MakeVector3(0.0f));
+}
+
+MX_TEST(Physics, OverlapBoxRespectsAsymmetricBounds)
+{
+    PhysicsModules modules;
+    auto object = CreateStaticBody(MakeVector3(0.0f), Quaternion{ 1.0f, 0.0f, 0.0f, 0.0f }, CollisionGroup::ALL);
+    object->AddComponent<BoxCollider>()->SetBoundingBox(BoundingBox(MakeVector3(0.0f), MakeVector3(1.0f)));
+    RigidBody::SyncObjectStates();
+
+    // box spans x in [0.4, 1.4], while box of same size centered at its center would not reach the body
+    BoundingBox shifted;
+    shifted.Center = MakeVector3(10.0f, 0.0f, 0.0f);
+    shifted.Min = MakeVector3(-9.6f, -0.5f, -0.5f);
+    shifted.Max = MakeVector3(-8.6f, 0.5f, 0.5f);
+    MX_CHECK(IsOverlapping(shifted, object));
+
+    // box spans x in [1.5, 2.5] and must not overlap, although its center offset points towards the body
+    BoundingBox separated = shifted;
+    separated.Min = MakeVector3(-8.5f, -0.5f, -0.5f);
+    separated.Max = MakeVector3(-7.5f, 0.5f, 0.5f);
+    MX_CHECK(!IsOverlapping(separated, object));
+}
+
+MX_TEST(Physics, OverlapBoxRotatesBoundsAroundCenter)
+{
+    PhysicsModules modules;
+    auto object = CreateStaticBody(MakeVector3(0.0f), Quaternion{ 1.0f, 0.0f, 0.0f, 0.0f }, CollisionGroup::ALL);
+    object->AddComponent<BoxCollider>()->SetBoundingBox(BoundingBox(MakeVector3(0.0f), MakeVector3(1.0f)));
+    RigidBody::SyncObjectStates();
+
+    // long thin box lies along x axis beside the body and only reaches it when rotated to lie along z axis
+    BoundingBox rod(MakeVector3(0.0f, 0.0f, 2.5f), MakeVector3(3.0f, 0.2f, 0.2f));
+    MX_CHECK(!IsOverlapping(rod, object));
+    rod.Rotation = MakeQuaternion(Radians(90.0f), MakeVector3(0.0f, 1.0f, 0.0f));
+    MX_CHECK(IsOverlapping(rod, object));
+
+    // local offset of (3, 0, 0) is rotated to (0, 0, -3), moving box to z in [-1, 3]. Unrotated offset or ignored offset both miss the body
+    BoundingBox offsetRod;
+    offsetRod.Center = MakeVector3(0.0f, 0.0f, 4.0f);
+    offsetRod.Min = MakeVector3(1.0f, -0.2f, -0.2f);
+    offsetRod.Max = MakeVector3(5.0f, 0.2f, 0.2f);
+    offsetRod.Rotation = MakeQuaternion(Radians(90.0f), MakeVector3(0.0f, 1.0f, 0.0f));
+    MX_CHECK(IsOverlapping(offsetRod, object));
+
+    offsetRod.Rotation = MakeQuaternion(Radians(-90.0f), MakeVector3(0.0f, 1.0f, 0.0f));
+    MX_CHECK(!IsOverlapping(offsetRod, object));
+}
+
+MX_TEST(Physics, OverlapQueriesFilterByMask)
+{
+    PhysicsModules modules;
+    auto raycastable = CreateStaticBody(MakeVector3(0.0f), Quaternion{ 1.0f, 0.0f, 0.0f, 0.0f }, CollisionGroup::RAYCAST_ONLY);
+    raycastable->AddComponent<SphereCollider>()->SetBoundingSphere(BoundingSphere(MakeVector3(0.0f), 1.0f));
+    auto dynamic = CreateStaticBody(MakeVector3(1.0f, 0.0f, 0.0f), Quaternion{ 1.0f, 0.0f, 0.0f, 0.0f }, CollisionMask::DYNAMIC);
+    dynamic->AddComponent<SphereCollider>()->SetBoundingSphere(BoundingSphere(MakeVector3(0.0f), 1.0f));
+    RigidBody::SyncObjectStates();
+
+    std::array spheres = { BoundingSphere(MakeVector3(0.5f, 0.0f, 0.0f), 1.0f) };
+    std::array<MxVector<MxObject::Handle>, 1> overlaps;
+
+    Physics::OverlapSphereBatch(spheres, overlaps, CollisionMask::RAYCAST_ONLY);
+    MX_REQUIRE(overlaps[0].size() == 1);
+    MX_CHECK(overlaps[0][0] == raycastable);
+
+    Physics::OverlapSphereBatch(spheres, overlaps, CollisionMask::DYNAMIC);
+    MX_REQUIRE(overlaps[0].size() == 1);
+    MX_CHECK(overlaps[0][0] == dynamic);
+
+    Physics::OverlapSphereBatch(spheres, overlaps, CollisionMask::Mask(CollisionGroup::ALL));
+    MX_CHECK_EQ(overlaps[0].size(), size_t(2));
+}
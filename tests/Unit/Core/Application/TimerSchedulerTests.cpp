@@ -0,0 +1,157 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Core/Application/TimerScheduler.h"
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+using TimerModules = ModuleScope<TimerScheduler>;
+
+MX_TEST(TimerScheduler, DelayedTimerFiresOnce)
+{
+    TimerModules modules;
+    size_t fireCount = 0;
+    auto handle = TimerScheduler::Schedule([&fireCount]() { fireCount++; }, TimerMode::UPDATE_AFTER_DELTA, 0.05f);
+
+    TimerScheduler::OnUpdate(0.02f);
+    MX_CHECK_EQ(fireCount, size_t(0));
+    MX_CHECK_NEAR(TimerScheduler::GetTimeLeft(handle), 0.03f, 1e-5f);
+
+    TimerScheduler::OnUpdate(0.04f);
+    MX_CHECK_EQ(fireCount, size_t(1));
+    MX_CHECK(!TimerScheduler::IsScheduled(handle));
+
+    TimerScheduler::OnUpdate(1.0f);
+    MX_CHECK_EQ(fireCount, size_t(1));
+    MX_CHECK_EQ(TimerScheduler::GetScheduledCount(), size_t(0));
+}
+
+MX_TEST(TimerScheduler, RepeatingTimerFiresEachPeriod)
+{
+    TimerModules modules;
+    size_t fireCount = 0;
+    auto handle = TimerScheduler::Schedule([&fireCount]() { fireCount++; }, TimerMode::UPDATE_EACH_DELTA, 0.1f);
+
+    for (size_t frame = 0; frame < 100; frame++)
+        TimerScheduler::OnUpdate(0.01f);
+
+    // period is counted from the frame in which timer fired, so frame rounding may delay some of invocations
+    MX_CHECK_GE(fireCount, size_t(9));
+    MX_CHECK_LE(fireCount, size_t(10));
+    MX_CHECK(TimerScheduler::IsScheduled(handle));
+}
+
+MX_TEST(TimerScheduler, CancelledTimerDoesNotFire)
+{
+    TimerModules modules;
+    size_t fireCount = 0;
+    auto delayed = TimerScheduler::Schedule([&fireCount]() { fireCount++; }, TimerMode::UPDATE_AFTER_DELTA, 0.01f);
+    auto perFrame = TimerScheduler::Schedule([&fireCount]() { fireCount++; }, TimerMode::UPDATE_EACH_FRAME, 0.0f);
+    TimerScheduler::Cancel(delayed);
+    TimerScheduler::Cancel(perFrame);
+
+    TimerScheduler::OnUpdate(0.1f);
+    MX_CHECK_EQ(fireCount, size_t(0));
+    MX_CHECK_EQ(TimerScheduler::GetScheduledCount(), size_t(0));
+
+    // released slot is reused, but old handle must stay invalid
+    auto reused = TimerScheduler::Schedule([]() { }, TimerMode::UPDATE_EACH_FRAME, 0.0f);
+    MX_CHECK(TimerScheduler::IsScheduled(reused));
+    MX_CHECK(!TimerScheduler::IsScheduled(delayed));
+    MX_CHECK(!TimerScheduler::IsScheduled(perFrame));
+}
+
+MX_TEST(TimerScheduler, TimerScheduledFromCallbackFiresNextFrame)
+{
+    TimerModules modules;
+    size_t innerFireCount = 0;
+    TimerScheduler::Schedule([&innerFireCount]()
+    {
+        TimerScheduler::Schedule([&innerFireCount]() { innerFireCount++; }, TimerMode::UPDATE_AFTER_DELTA, 0.0f);
+    }, TimerMode::UPDATE_AFTER_DELTA, 0.0f);
+
+    TimerScheduler::OnUpdate(0.01f);
+    MX_CHECK_EQ(innerFireCount, size_t(0));
+    TimerScheduler::OnUpdate(0.01f);
+    MX_CHECK_EQ(innerFireCount, size_t(1));
+}
+
+MX_TEST(TimerScheduler, TimerCanCancelItself)
+{
+    TimerModules modules;
+    size_t fireCount = 0;
+    TimerHandle handle;
+    handle = TimerScheduler::Schedule([&fireCount, &handle]()
+    {
+        fireCount++;
+        TimerScheduler::Cancel(handle);
+    }, TimerMode::UPDATE_EACH_FRAME, 0.0f);
+
+    TimerScheduler::OnUpdate(0.01f);
+    TimerScheduler::OnUpdate(0.01f);
+    MX_CHECK_EQ(fireCount, size_t(1));
+    MX_CHECK(!TimerScheduler::IsScheduled(handle));
+}
+
+MX_TEST(TimerScheduler, RepeatForSecondsStopsAfterDuration)
+{
+    TimerModules modules;
+    size_t fireCount = 0;
+    auto handle = TimerScheduler::Schedule([&fireCount]() { fireCount++; }, TimerMode::UPDATE_FOR_N_SECONDS, 0.1f);
+
+    for (size_t frame = 0; frame < 20; frame++)
+        TimerScheduler::OnUpdate(0.01f);
+
+    MX_CHECK_GE(fireCount, size_t(9));
+    MX_CHECK_LE(fireCount, size_t(10));
+    MX_CHECK(!TimerScheduler::IsScheduled(handle));
+}
+
+MX_TEST(TimerScheduler, DeadlinesKeepPrecisionInLongSessions)
+{
+    TimerModules modules;
+    // after a week of uptime float clock has resolution of 1/16 seconds, so small frame deltas would be lost
+    constexpr float Week = 7.0f * 24.0f * 60.0f * 60.0f;
+    TimerScheduler::OnUpdate(Week);
+
+    size_t fireCount = 0;
+    auto handle = TimerScheduler::Schedule([&fireCount]() { fireCount++; }, TimerMode::UPDATE_AFTER_DELTA, 0.005f);
+    MX_CHECK_NEAR(TimerScheduler::GetTimeLeft(handle), 0.005f, 1e-6f);
+
+    TimerScheduler::OnUpdate(0.002f);
+    MX_CHECK_EQ(fireCount, size_t(0));
+    MX_CHECK_NEAR(TimerScheduler::GetTimeLeft(handle), 0.003f, 1e-6f);
+
+    TimerScheduler::OnUpdate(0.002f);
+    TimerScheduler::OnUpdate(0.002f);
+    MX_CHECK_EQ(fireCount, size_t(1));
+}
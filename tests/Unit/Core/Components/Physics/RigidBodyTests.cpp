@@ -0,0 +1,187 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Framework/TestFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Core/Components/Physics/RigidBody.h"
+#include "Core/Components/Physics/SphereCollider.h"
+#include "Core/MxObject/MxObject.h"
+#include "Platform/Bullet3/Bullet3Utils.h"
+#include "Platform/Modules/PhysicsModule.h"
+#include "Platform/PhysicsAPI.h"
+#include "Utilities/Memory/FrameAllocator.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/UUID/UUID.h"
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+namespace
+{
+    // objects are destroyed first, so their rigid bodies are removed from the world before physics module is destroyed
+    using PhysicsModules = ModuleScope<UUIDGenerator, ThreadPool, FrameAllocator, PhysicsModule, ComponentFactory,
+        Factory<SphereShape>, Factory<NativeRigidBody>, Factory<MxObject>>;
+
+    constexpr float TimeStep = 1.0f / 60.0f;
+    constexpr float Epsilon = 1e-5f;
+
+    MxObject::Handle CreateSphere(const Vector3& position)
+    {
+        auto object = MxObject::Create();
+        object->LocalTransform.SetPosition(position);
+        auto collider = object->AddComponent<SphereCollider>();
+        collider->SetBoundingSphere(BoundingSphere(MakeVector3(0.0f), 0.5f));
+        object->AddComponent<RigidBody>();
+        return object;
+    }
+
+    btRigidBody* GetNativeBody(MxObject::Handle& object)
+    {
+        return object->GetComponent<RigidBody>()->GetNativeHandle()->GetNativeHandle();
+    }
+
+    void CheckPosition(const btVector3& position, const Vector3& expected)
+    {
+        MX_CHECK_NEAR(position.x(), expected.x, Epsilon);
+        MX_CHECK_NEAR(position.y(), expected.y, Epsilon);
+        MX_CHECK_NEAR(position.z(), expected.z, Epsilon);
+    }
+
+    void SimulateFrame()
+    {
+        FrameAllocator::OnFrameBegin();
+        RigidBody::SyncObjectStates();
+        PhysicsModule::PerformSimulationStep(TimeStep);
+        RigidBody::FetchActiveTransforms();
+    }
+}
+
+MX_TEST(RigidBody, FetchedTransformIsNotPushedBack)
+{
+    PhysicsModules modules;
+    auto object = CreateSphere(MakeVector3(0.0f, 10.0f, 0.0f));
+    object->GetComponent<RigidBody>()->MakeDynamic();
+
+    for (size_t i = 0; i < 10; i++)
+        SimulateFrame();
+
+    MX_CHECK(object->LocalTransform.GetPosition().y < 10.0f);
+    MX_CHECK(!object->LocalTransform.HasChanged());
+
+    // body is moved behind object's back, so any push of object transform would be visible
+    auto body = GetNativeBody(object);
+    btTransform marker = body->getWorldTransform();
+    marker.setOrigin(btVector3(100.0f, 0.0f, 0.0f));
+    body->setWorldTransform(marker);
+
+    RigidBody::SyncObjectStates();
+    CheckPosition(body->getWorldTransform().getOrigin(), MakeVector3(100.0f, 0.0f, 0.0f));
+}
+
+MX_TEST(RigidBody, SetterPushesTransformOnce)
+{
+    PhysicsModules modules;
+    auto object = CreateSphere(MakeVector3(0.0f));
+    object->GetComponent<RigidBody>()->MakeDynamic();
+    SimulateFrame();
+
+    auto position = MakeVector3(5.0f, 20.0f, 5.0f);
+    object->LocalTransform.SetPosition(position);
+    MX_CHECK(object->LocalTransform.HasChanged());
+
+    RigidBody::SyncObjectStates();
+    auto body = GetNativeBody(object);
+    CheckPosition(body->getWorldTransform().getOrigin(), position);
+    MX_CHECK(!object->LocalTransform.HasChanged());
+    MX_CHECK(body->isActive());
+
+    // flag is reset by the push, so unchanged transform is not pushed again
+    btTransform marker = body->getWorldTransform();
+    marker.setOrigin(btVector3(100.0f, 0.0f, 0.0f));
+    body->setWorldTransform(marker);
+    RigidBody::SyncObjectStates();
+    CheckPosition(body->getWorldTransform().getOrigin(), MakeVector3(100.0f, 0.0f, 0.0f));
+}
+
+MX_TEST(RigidBody, KinematicBodyIsDrivenByMotionState)
+{
+    PhysicsModules modules;
+    auto object = CreateSphere(MakeVector3(0.0f));
+    object->GetComponent<RigidBody>()->MakeKinematic();
+    SimulateFrame();
+
+    auto position = MakeVector3(3.0f, 1.0f, -2.0f);
+    object->LocalTransform.SetPosition(position);
+    RigidBody::SyncObjectStates();
+
+    // kinematic body is not teleported, bullet reads its motion state during the step
+    auto body = GetNativeBody(object);
+    btTransform motionStateTransform;
+    body->getMotionState()->getWorldTransform(motionStateTransform);
+    CheckPosition(motionStateTransform.getOrigin(), position);
+    CheckPosition(body->getWorldTransform().getOrigin(), MakeVector3(0.0f));
+
+    PhysicsModule::PerformSimulationStep(TimeStep);
+    RigidBody::FetchActiveTransforms();
+    CheckPosition(body->getWorldTransform().getOrigin(), position);
+    MX_CHECK(object->LocalTransform.GetPosition() == position);
+    MX_CHECK(!object->LocalTransform.HasChanged());
+}
+
+MX_TEST(RigidBody, ColliderChangeUpdatesBodyShape)
+{
+    PhysicsModules modules;
+    auto object = CreateSphere(MakeVector3(0.0f));
+    SimulateFrame();
+
+    auto collider = object->GetComponent<SphereCollider>();
+    auto body = GetNativeBody(object);
+    MX_CHECK(body->getCollisionShape() == collider->GetNativeHandle()->GetNativeHandle());
+
+    // shape is replaced without touching transform, so only collider marks the body
+    collider->SetBoundingSphere(BoundingSphere(MakeVector3(0.0f), 2.0f));
+    MX_CHECK(!object->LocalTransform.HasChanged());
+    RigidBody::SyncObjectStates();
+    MX_CHECK(body->getCollisionShape() == collider->GetNativeHandle()->GetNativeHandle());
+
+    object->RemoveComponent<SphereCollider>();
+    RigidBody::SyncObjectStates();
+    MX_CHECK(body->getCollisionShape() == nullptr);
+}
+
+MX_TEST(RigidBody, ColliderAddedAfterBodyIsAttached)
+{
+    PhysicsModules modules;
+    auto object = MxObject::Create();
+    object->AddComponent<RigidBody>();
+    SimulateFrame();
+
+    auto collider = object->AddComponent<SphereCollider>();
+    RigidBody::SyncObjectStates();
+    MX_CHECK(GetNativeBody(object)->getCollisionShape() == collider->GetNativeHandle()->GetNativeHandle());
+}
@@ -0,0 +1,506 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Framework/FakeStagingDevice.h"
+#include "Core/Rendering/RenderGraph/SubmissionQueue.h"
+#include "Core/Resources/Vertex.h"
+
+#include <vector>
+#include <cstring>
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+namespace
+{
+    std::vector<uint8_t> MakePattern(size_t size, uint8_t seed)
+    {
+        std::vector<uint8_t> bytes(size);
+        for (size_t i = 0; i < size; i++)
+            bytes[i] = (uint8_t)(i * 7 + seed);
+        return bytes;
+    }
+
+    size_t GetStagingUsedBytes()
+    {
+        return SubmissionQueue::GetImpl()->Ring.GetUsedBytes();
+    }
+
+    std::vector<Vertex> MakeVertecies(size_t count)
+    {
+        std::vector<Vertex> vertecies(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            float value = (float)i;
+            vertecies[i].Position = MakeVector3(value, value + 0.5f, -value);
+            vertecies[i].Normal = MakeVector3(0.0f, 1.0f, value);
+        }
+        return vertecies;
+    }
+
+    std::vector<uint32_t> MakeIndicies(size_t count)
+    {
+        std::vector<uint32_t> indicies(count);
+        for (size_t i = 0; i < count; i++)
+            indicies[i] = (uint32_t)(count - i);
+        return indicies;
+    }
+
+    template<typename T>
+    bool IsDataEqual(const std::vector<T>& data1, const std::vector<T>& data2)
+    {
+        return data1.size() == data2.size() && std::memcmp(data1.data(), data2.data(), data1.size() * sizeof(T)) == 0;
+    }
+
+    /*!
+    mesh storage in fake device: vertecies and indicies are placed at non-zero offsets of separate buffers, as mesh data does
+    */
+    struct MeshStorage
+    {
+        static constexpr size_t VertexOffset = 16;
+        static constexpr size_t IndexOffset = 48;
+
+        Buffer VBO, IBO;
+        std::vector<Vertex> Vertecies;
+        std::vector<uint32_t> Indicies;
+
+        MeshStorage(FakeStagingDevice& device, size_t vertexCount, size_t indexCount)
+            : Vertecies(MakeVertecies(vertexCount)), Indicies(MakeIndicies(indexCount))
+        {
+            device.AddBuffer(this->VBO, (VertexOffset + vertexCount) * sizeof(Vertex));
+            device.AddBuffer(this->IBO, (IndexOffset + indexCount) * sizeof(uint32_t));
+            SubmissionQueue::CopyToBuffer((const uint8_t*)this->Vertecies.data(), this->Vertecies.size() * sizeof(Vertex), this->VBO, VertexOffset * sizeof(Vertex));
+            SubmissionQueue::CopyToBuffer((const uint8_t*)this->Indicies.data(), this->Indicies.size() * sizeof(uint32_t), this->IBO, IndexOffset * sizeof(uint32_t));
+        }
+
+        template<typename T>
+        void ReadAsync(const Buffer& buffer, size_t offset, std::vector<T>& result, bool& isCompleted) const
+        {
+            SubmissionQueue::CopyFromBufferAsync(result.size() * sizeof(T), buffer, offset * sizeof(T), [&result, &isCompleted](const uint8_t* data, size_t byteSize)
+            {
+                std::memcpy(result.data(), data, byteSize);
+                isCompleted = true;
+            });
+        }
+    };
+
+    bool IsRangeEqual(const std::vector<uint8_t>& memory, size_t offset, const std::vector<uint8_t>& expected)
+    {
+        return offset + expected.size() <= memory.size() && std::memcmp(memory.data() + offset, expected.data(), expected.size()) == 0;
+    }
+}
+
+MX_TEST(SubmissionQueue, RelocationIsRecordedBeforePendingUploads)
+{
+    FakeQueueScope queue;
+    auto& device = *queue.Device;
+    Buffer oldBuffer, newBuffer;
+    device.AddBuffer(oldBuffer, 256, 0xAB);
+    device.AddBuffer(newBuffer, 512);
+
+    // upload was issued before storage was replaced, so it must end up in the new storage on top of relocated data
+    auto data = MakePattern(64, 1);
+    SubmissionQueue::CopyToBuffer(data.data(), data.size(), oldBuffer, 32);
+    MX_CHECK_EQ(SubmissionQueue::RelocateBuffer(oldBuffer, newBuffer, 256), (size_t)256);
+    SubmissionQueue::FlushQueue();
+
+    MX_REQUIRE(device.Commands.size() == 5);
+    MX_CHECK(device.Commands[0].Type == FakeStagingDevice::CommandType::IMMEDIATE_BARRIER);
+    MX_CHECK(device.Commands[1].Type == FakeStagingDevice::CommandType::COPY);
+    MX_CHECK(device.Commands[2].Type == FakeStagingDevice::CommandType::IMMEDIATE_BARRIER);
+    MX_CHECK(device.Commands[3].Type == FakeStagingDevice::CommandType::UPLOAD);
+    MX_CHECK(device.Commands[3].Destination == &newBuffer);
+    MX_CHECK(device.Commands[4].Type == FakeStagingDevice::CommandType::SUBMIT);
+    MX_CHECK_EQ(device.HazardCount, (size_t)0);
+
+    const auto& memory = device.Memory[&newBuffer];
+    MX_CHECK(IsRangeEqual(memory, 0, std::vector<uint8_t>(32, 0xAB)));
+    MX_CHECK(IsRangeEqual(memory, 32, data));
+    MX_CHECK(IsRangeEqual(memory, 96, std::vector<uint8_t>(160, 0xAB)));
+}
+
+MX_TEST(SubmissionQueue, ChainedRelocationsAreMergedIntoOneCopy)
+{
+    FakeQueueScope queue;
+    auto& device = *queue.Device;
+    Buffer original, intermediate, final;
+    device.AddBuffer(original, 128, 0x11);
+    device.AddBuffer(intermediate, 256);
+    device.AddBuffer(final, 512);
+
+    // storage grows twice inside one load batch, with uploads to each of the new storages
+    auto first = MakePattern(100, 2);
+    auto second = MakePattern(200, 3);
+    MX_CHECK_EQ(SubmissionQueue::RelocateBuffer(original, intermediate, 128), (size_t)128);
+    SubmissionQueue::CopyToBuffer(first.data(), first.size(), intermediate, 128);
+    MX_CHECK_EQ(SubmissionQueue::RelocateBuffer(intermediate, final, 256), (size_t)0);
+    SubmissionQueue::CopyToBuffer(second.data(), second.size(), final, 228);
+    SubmissionQueue::FlushQueue();
+
+    MX_CHECK_EQ(device.CountCommands(FakeStagingDevice::CommandType::COPY), (size_t)1);
+    MX_CHECK(device.Commands[1].Source == &original);
+    MX_CHECK(device.Commands[1].Destination == &final);
+    MX_CHECK_EQ(device.Commands[1].Size, (size_t)128);
+    MX_CHECK(!device.IsReferenced(intermediate));
+    MX_CHECK_EQ(device.HazardCount, (size_t)0);
+
+    const auto& memory = device.Memory[&final];
+    MX_CHECK(IsRangeEqual(memory, 0, std::vector<uint8_t>(128, 0x11)));
+    MX_CHECK(IsRangeEqual(memory, 128, first));
+    MX_CHECK(IsRangeEqual(memory, 228, second));
+}
+
+MX_TEST(SubmissionQueue, RelocationAfterFlushCopiesSubmittedStorage)
+{
+    FakeQueueScope queue;
+    auto& device = *queue.Device;
+    Buffer original, intermediate, final;
+    device.AddBuffer(original, 64, 0x22);
+    device.AddBuffer(intermediate, 128);
+    device.AddBuffer(final, 256);
+
+    auto data = MakePattern(64, 4);
+    SubmissionQueue::RelocateBuffer(original, intermediate, 64);
+    SubmissionQueue::FlushQueue();
+    SubmissionQueue::CopyToBuffer(data.data(), data.size(), intermediate, 64);
+    SubmissionQueue::RecordPendingUploads();
+    // upload is recorded but not submitted yet, relocation must wait for it
+    MX_CHECK_EQ(SubmissionQueue::RelocateBuffer(intermediate, final, 128), (size_t)128);
+    SubmissionQueue::FlushQueue();
+
+    MX_CHECK_EQ(device.CountCommands(FakeStagingDevice::CommandType::COPY), (size_t)2);
+    MX_CHECK_EQ(device.HazardCount, (size_t)0);
+    const auto& memory = device.Memory[&final];
+    MX_CHECK(IsRangeEqual(memory, 0, std::vector<uint8_t>(64, 0x22)));
+    MX_CHECK(IsRangeEqual(memory, 64, data));
+}
+
+MX_TEST(SubmissionQueue, FrameUploadsWaitForPendingRelocations)
+{
+    FakeQueueScope queue;
+    auto& device = *queue.Device;
+    Buffer oldBuffer, newBuffer;
+    device.AddBuffer(oldBuffer, 64, 0x33);
+    device.AddBuffer(newBuffer, 128);
+
+    auto data = MakePattern(16, 5);
+    SubmissionQueue::RelocateBuffer(oldBuffer, newBuffer, 64);
+    SubmissionQueue::CopyToBuffer(data.data(), data.size(), newBuffer, 8, UploadPriority::NORMAL);
+    SubmissionQueue::SubmitFrameUploads();
+
+    MX_CHECK_EQ(device.CountCommands(FakeStagingDevice::CommandType::SUBMIT), (size_t)1);
+    MX_CHECK_EQ(device.HazardCount, (size_t)0);
+    MX_CHECK(IsRangeEqual(device.Memory[&newBuffer], 0, std::vector<uint8_t>(8, 0x33)));
+    MX_CHECK(IsRangeEqual(device.Memory[&newBuffer], 8, data));
+}
+
+MX_TEST(SubmissionQueue, MovedRangeIsCopiedWithFrameUploads)
+{
+    FakeQueueScope queue;
+    auto& device = *queue.Device;
+    Buffer buffer;
+    device.Memory[&buffer] = MakePattern(256, 6);
+    auto original = device.Memory[&buffer];
+
+    // upload to the moved range was issued before the move, so it must land at the new place on top of copied data
+    auto data = MakePattern(16, 7);
+    SubmissionQueue::CopyToBuffer(data.data(), data.size(), buffer, 32, UploadPriority::NORMAL);
+    SubmissionQueue::MoveBufferRange(buffer, 0, 128, 64);
+    RunFrame();
+
+    MX_CHECK_EQ(device.CountCommands(FakeStagingDevice::CommandType::SUBMIT), (size_t)0);
+    MX_REQUIRE(device.Commands.size() == 5);
+    MX_CHECK(device.Commands[0].Type == FakeStagingDevice::CommandType::FRAME_TRANSFER_BARRIER);
+    MX_CHECK(device.Commands[1].Type == FakeStagingDevice::CommandType::COPY);
+    MX_CHECK(device.Commands[2].Type == FakeStagingDevice::CommandType::FRAME_BARRIER);
+    MX_CHECK(device.Commands[3].Type == FakeStagingDevice::CommandType::UPLOAD);
+    MX_CHECK(device.Commands[4].Type == FakeStagingDevice::CommandType::FRAME_BARRIER);
+    MX_CHECK_EQ(device.HazardCount, (size_t)0);
+
+    const auto& memory = device.Memory[&buffer];
+    MX_CHECK(IsRangeEqual(memory, 128, std::vector<uint8_t>(original.begin(), original.begin() + 32)));
+    MX_CHECK(IsRangeEqual(memory, 160, data));
+    MX_CHECK(IsRangeEqual(memory, 176, std::vector<uint8_t>(original.begin() + 48, original.begin() + 64)));
+
+    // moves are recorded only once
+    RunFrame();
+    MX_CHECK_EQ(device.CountCommands(FakeStagingDevice::CommandType::COPY), (size_t)1);
+}
+
+MX_TEST(SubmissionQueue, FlushRecordsPendingMoves)
+{
+    FakeQueueScope queue;
+    auto& device = *queue.Device;
+    Buffer buffer;
+    device.Memory[&buffer] = MakePattern(128, 8);
+    auto original = device.Memory[&buffer];
+
+    SubmissionQueue::MoveBufferRange(buffer, 64, 0, 32);
+    SubmissionQueue::FlushQueue();
+    RunFrame();
+
+    MX_CHECK_EQ(device.CountCommands(FakeStagingDevice::CommandType::COPY), (size_t)1);
+    MX_CHECK(device.Commands[1].Type == FakeStagingDevice::CommandType::COPY);
+    MX_CHECK(device.Commands[3].Type == FakeStagingDevice::CommandType::SUBMIT);
+    MX_CHECK(IsRangeEqual(device.Memory[&buffer], 0, std::vector<uint8_t>(original.begin() + 64, original.begin() + 96)));
+}
+
+MX_TEST(SubmissionQueue, MoveIntoFreedRangeWaitsForPreviousMove)
+{
+    FakeQueueScope queue;
+    auto& device = *queue.Device;
+    Buffer buffer;
+    device.Memory[&buffer] = MakePattern(256, 9);
+    auto original = device.Memory[&buffer];
+
+    // second move writes range which first move reads, as two defragmentation passes in one frame may do
+    SubmissionQueue::MoveBufferRange(buffer, 64, 0, 32);
+    SubmissionQueue::MoveBufferRange(buffer, 128, 64, 32);
+    SubmissionQueue::MoveBufferRange(buffer, 192, 160, 32);
+    RunFrame();
+
+    MX_CHECK_EQ(device.CountCommands(FakeStagingDevice::CommandType::COPY), (size_t)3);
+    MX_CHECK_EQ(device.CountCommands(FakeStagingDevice::CommandType::FRAME_TRANSFER_BARRIER), (size_t)2);
+    MX_CHECK(device.Commands[2].Type == FakeStagingDevice::CommandType::FRAME_TRANSFER_BARRIER);
+    MX_CHECK(device.Commands[4].Type == FakeStagingDevice::CommandType::COPY);
+    MX_CHECK_EQ(device.HazardCount, (size_t)0);
+
+    const auto& memory = device.Memory[&buffer];
+    MX_CHECK(IsRangeEqual(memory, 0, std::vector<uint8_t>(original.begin() + 64, original.begin() + 96)));
+    MX_CHECK(IsRangeEqual(memory, 64, std::vector<uint8_t>(original.begin() + 128, original.begin() + 160)));
+    MX_CHECK(IsRangeEqual(memory, 160, std::vector<uint8_t>(original.begin() + 192, original.begin() + 224)));
+}
+
+MX_TEST(SubmissionQueue, PendingMovesFollowRelocatedBuffer)
+{
+    FakeQueueScope queue;
+    auto& device = *queue.Device;
+    Buffer oldBuffer, newBuffer;
+    device.Memory[&oldBuffer] = MakePattern(128, 10);
+    device.AddBuffer(newBuffer, 256);
+    auto original = device.Memory[&oldBuffer];
+
+    SubmissionQueue::MoveBufferRange(oldBuffer, 96, 0, 32);
+    SubmissionQueue::RelocateBuffer(oldBuffer, newBuffer, 128);
+    RunFrame();
+
+    MX_CHECK_EQ(device.CountCommands(FakeStagingDevice::CommandType::COPY), (size_t)2);
+    MX_CHECK_EQ(device.HazardCount, (size_t)0);
+    MX_CHECK(IsRangeEqual(device.Memory[&oldBuffer], 0, original));
+    MX_CHECK(IsRangeEqual(device.Memory[&newBuffer], 0, std::vector<uint8_t>(original.begin() + 96, original.end())));
+    MX_CHECK(IsRangeEqual(device.Memory[&newBuffer], 32, std::vector<uint8_t>(original.begin() + 32, original.end())));
+}
+
+MX_TEST(SubmissionQueue, FramesInFlightAreTakenFromDevice)
+{
+    {
+        FakeQueueScope queue(64 * KB, 2);
+        MX_CHECK_EQ(SubmissionQueue::GetFramesInFlight(), (size_t)2);
+    }
+    {
+        FakeQueueScope queue(64 * KB, 0);
+        MX_CHECK_EQ(SubmissionQueue::GetFramesInFlight(), (size_t)1);
+    }
+}
+
+MX_TEST(SubmissionQueue, FrameStagingIsRetiredAfterFramesInFlight)
+{
+    for (size_t framesInFlight = 1; framesInFlight <= 4; framesInFlight++)
+    {
+        FakeQueueScope queue(64 * KB, framesInFlight);
+        Buffer buffer;
+        queue.Device->AddBuffer(buffer, 256);
+
+        auto data = MakePattern(256, 6);
+        SubmissionQueue::CopyToBuffer(data.data(), data.size(), buffer, 0);
+        RunFrame();
+        MX_CHECK(IsRangeEqual(queue.Device->Memory[&buffer], 0, data));
+
+        // staging memory of the upload may still be read by GPU until its virtual frame is reused
+        for (size_t frame = 1; frame < framesInFlight; frame++)
+        {
+            RunFrame();
+            MX_CHECK(GetStagingUsedBytes() != 0);
+        }
+        RunFrame();
+        MX_CHECK_EQ(GetStagingUsedBytes(), (size_t)0);
+    }
+}
+
+MX_TEST(SubmissionQueue, FlushDoesNotRetireFrameWhichIsNotSubmitted)
+{
+    FakeQueueScope queue;
+    Buffer buffer;
+    queue.Device->AddBuffer(buffer, 256);
+
+    auto data = MakePattern(128, 7);
+    SubmissionQueue::CopyToBuffer(data.data(), data.size(), buffer, 0);
+    SubmissionQueue::SubmitFrameUploads();
+
+    // frame command buffer is still recorded, so flush cannot wait for it
+    SubmissionQueue::FlushQueue();
+    MX_CHECK(GetStagingUsedBytes() != 0);
+
+    SubmissionQueue::OnFrameSubmitted();
+    SubmissionQueue::FlushQueue();
+    MX_CHECK_EQ(GetStagingUsedBytes(), (size_t)0);
+}
+
+MX_TEST(SubmissionQueue, FrameReadbackCompletesAfterFrameIsSubmitted)
+{
+    FakeQueueScope queue;
+    Buffer buffer;
+    auto data = MakePattern(64, 8);
+    queue.Device->AddBuffer(buffer, 64);
+    std::memcpy(queue.Device->Memory[&buffer].data(), data.data(), data.size());
+
+    std::vector<uint8_t> result;
+    SubmissionQueue::CopyFromBufferAsync(data.size(), buffer, 0, [&result](const uint8_t* bytes, size_t byteSize)
+    {
+        result.assign(bytes, bytes + byteSize);
+    });
+    SubmissionQueue::SubmitFrameUploads();
+    SubmissionQueue::FlushQueue();
+    MX_CHECK(result.empty());
+
+    SubmissionQueue::OnFrameSubmitted();
+    SubmissionQueue::FlushQueue();
+    MX_CHECK(result == data);
+}
+
+MX_TEST(SubmissionQueue, SteadyFrameUploadsDoNotStall)
+{
+    // each frame uploads a quarter of staging memory, which fits into staging ring with three frames in flight
+    FakeQueueScope queue(64 * KB, 3);
+    Buffer buffer;
+    queue.Device->AddBuffer(buffer, 16 * KB);
+
+    auto data = MakePattern(16 * KB - 64, 9);
+    for (size_t frame = 0; frame < 100; frame++)
+    {
+        SubmissionQueue::CopyToBuffer(data.data(), data.size(), buffer, 0, UploadPriority::NORMAL);
+        RunFrame();
+    }
+    MX_CHECK_EQ(SubmissionQueue::GetStats().StallCount, (size_t)0);
+    MX_CHECK_EQ(SubmissionQueue::GetStats().FlushCount, (size_t)0);
+    MX_CHECK(IsRangeEqual(queue.Device->Memory[&buffer], 0, data));
+}
+
+MX_TEST(SubmissionQueue, UploadsBeyondFramesInFlightStall)
+{
+    // three frames of half of staging memory each do not fit into staging ring, so recording has to wait for GPU
+    FakeQueueScope queue(64 * KB, 3);
+    Buffer buffer;
+    queue.Device->AddBuffer(buffer, 32 * KB);
+
+    auto data = MakePattern(16 * KB, 10);
+    for (size_t frame = 0; frame < 10; frame++)
+    {
+        SubmissionQueue::CopyToBuffer(data.data(), data.size(), buffer, 0);
+        SubmissionQueue::CopyToBuffer(data.data(), data.size(), buffer, 16 * KB);
+        RunFrame();
+    }
+    MX_CHECK(SubmissionQueue::GetStats().StallCount != 0);
+    MX_CHECK_EQ(queue.Device->HazardCount, (size_t)0);
+}
+
+MX_TEST(SubmissionQueue, MeshDataRoundTripSync)
+{
+    FakeQueueScope queue;
+    MeshStorage mesh(*queue.Device, 1000, 3000);
+
+    std::vector<Vertex> vertecies(mesh.Vertecies.size());
+    std::vector<uint32_t> indicies(mesh.Indicies.size());
+    SubmissionQueue::CopyFromBuffer((uint8_t*)vertecies.data(), vertecies.size() * sizeof(Vertex), mesh.VBO, MeshStorage::VertexOffset * sizeof(Vertex));
+    SubmissionQueue::CopyFromBuffer((uint8_t*)indicies.data(), indicies.size() * sizeof(uint32_t), mesh.IBO, MeshStorage::IndexOffset * sizeof(uint32_t));
+
+    MX_CHECK(IsDataEqual(vertecies, mesh.Vertecies));
+    MX_CHECK(IsDataEqual(indicies, mesh.Indicies));
+    MX_CHECK_EQ(queue.Device->HazardCount, (size_t)0);
+    MX_CHECK_EQ(GetStagingUsedBytes(), (size_t)0);
+}
+
+MX_TEST(SubmissionQueue, MeshDataRoundTripAsyncCompletesAfterFramesInFlight)
+{
+    for (size_t framesInFlight = 1; framesInFlight <= 3; framesInFlight++)
+    {
+        FakeQueueScope queue(64 * KB, framesInFlight);
+        MeshStorage mesh(*queue.Device, 100, 300);
+
+        std::vector<Vertex> vertecies(mesh.Vertecies.size());
+        std::vector<uint32_t> indicies(mesh.Indicies.size());
+        bool isVerteciesRead = false, isIndiciesRead = false;
+        mesh.ReadAsync(mesh.VBO, MeshStorage::VertexOffset, vertecies, isVerteciesRead);
+        mesh.ReadAsync(mesh.IBO, MeshStorage::IndexOffset, indicies, isIndiciesRead);
+
+        // readbacks are recorded into the first frame and complete once its virtual frame is reused
+        size_t frames = 0;
+        while (!isVerteciesRead && frames < 10)
+        {
+            RunFrame();
+            frames++;
+        }
+        MX_CHECK_EQ(frames, framesInFlight + 1);
+        MX_CHECK(isIndiciesRead);
+        MX_CHECK(IsDataEqual(vertecies, mesh.Vertecies));
+        MX_CHECK(IsDataEqual(indicies, mesh.Indicies));
+        MX_CHECK_EQ(SubmissionQueue::GetStats().FlushCount, (size_t)0);
+        MX_CHECK_EQ(queue.Device->HazardCount, (size_t)0);
+    }
+}
+
+MX_TEST(SubmissionQueue, MeshDataRoundTripAsyncCompletesOnFlush)
+{
+    FakeQueueScope queue;
+    MeshStorage mesh(*queue.Device, 100, 300);
+
+    std::vector<uint32_t> indicies(mesh.Indicies.size());
+    bool isCompleted = false;
+    mesh.ReadAsync(mesh.IBO, MeshStorage::IndexOffset, indicies, isCompleted);
+    SubmissionQueue::FlushQueue();
+
+    MX_CHECK(isCompleted);
+    MX_CHECK(IsDataEqual(indicies, mesh.Indicies));
+    MX_CHECK_EQ(GetStagingUsedBytes(), (size_t)0);
+}
+
+MX_TEST(SubmissionQueue, LargeAsyncReadbackIsCompletedImmediately)
+{
+    // readback larger than staging chunk is split and read synchronously
+    FakeQueueScope queue(64 * KB);
+    MeshStorage mesh(*queue.Device, 2000, 0);
+
+    std::vector<Vertex> vertecies(mesh.Vertecies.size());
+    bool isCompleted = false;
+    mesh.ReadAsync(mesh.VBO, MeshStorage::VertexOffset, vertecies, isCompleted);
+
+    MX_CHECK(isCompleted);
+    MX_CHECK(IsDataEqual(vertecies, mesh.Vertecies));
+}
@@ -0,0 +1,267 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Core/Rendering/RenderUtilities/ClusterCuller.h"
+
+#include <random>
+#include <cmath>
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+namespace
+{
+    struct TestMesh
+    {
+        MxVector<Vertex> Vertecies;
+        MxVector<uint32_t> Indicies;
+        MxVector<Meshlet> Meshlets;
+    };
+
+    struct TestCamera
+    {
+        Vector3 Position;
+        Matrix4x4 ViewProjection;
+        FrustrumCuller Culler;
+    };
+
+    /*!
+    generates outward-facing uv-sphere of radius 1 split into meshlets. Triangles are emitted row by row, so rows should be
+    long enough for each meshlet to cover a narrow strip of sphere, otherwise their normal cones are too wide to be culled
+    */
+    TestMesh GenerateSphere(size_t stacks, size_t slices)
+    {
+        constexpr float Pi = 3.14159265358979f;
+        TestMesh mesh;
+        for (size_t stack = 0; stack <= stacks; stack++)
+        {
+            float phi = Pi * (float)stack / (float)stacks;
+            for (size_t slice = 0; slice <= slices; slice++)
+            {
+                float theta = 2.0f * Pi * (float)slice / (float)slices;
+                Vertex vertex;
+                vertex.Position = MakeVector3(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta));
+                mesh.Vertecies.push_back(vertex);
+            }
+        }
+        for (size_t stack = 0; stack < stacks; stack++)
+        {
+            for (size_t slice = 0; slice < slices; slice++)
+            {
+                uint32_t i0 = uint32_t(stack * (slices + 1) + slice);
+                uint32_t i2 = i0 + uint32_t(slices + 1);
+                uint32_t quad[6] = { i0, i0 + 1, i2, i0 + 1, i2 + 1, i2 };
+                mesh.Indicies.insert(mesh.Indicies.end(), std::begin(quad), std::end(quad));
+            }
+        }
+        mesh.Meshlets = MeshletBuilder::Build(mesh.Vertecies, mesh.Indicies);
+        return mesh;
+    }
+
+    TestCamera MakeCamera(const Vector3& position, const Vector3& target, float fov = 1.2f)
+    {
+        TestCamera camera;
+        camera.Position = position;
+        camera.ViewProjection = MakePerspectiveMatrix(fov, 16.0f / 9.0f, 0.1f, 100.0f) * MakeViewMatrix(position, target, MakeVector3(0.0f, 1.0f, 0.0f));
+        camera.Culler = FrustrumCuller(camera.ViewProjection);
+        return camera;
+    }
+
+    size_t Cull(const TestMesh& mesh, size_t baseIndexOffset, const Matrix4x4& model, const TestCamera& camera, bool useConeCulling, FrameVector<IndexRange>& ranges)
+    {
+        return ClusterCuller::Cull(mesh.Meshlets, baseIndexOffset, model, camera.Culler, camera.Position, useConeCulling, ranges);
+    }
+
+    bool IsIndexDrawn(const FrameVector<IndexRange>& ranges, size_t index)
+    {
+        for (const auto& range : ranges)
+        {
+            if (index >= range.IndexOffset && index < range.IndexOffset + range.IndexCount)
+                return true;
+        }
+        return false;
+    }
+
+    /*!
+    checks that no triangle which has a vertex inside camera frustrum and faces the camera is culled
+    \returns number of such triangles
+    */
+    size_t CheckConservative(const TestMesh& mesh, const Matrix4x4& model, const TestCamera& camera, const FrameVector<IndexRange>& ranges)
+    {
+        size_t visibleCount = 0;
+        for (size_t i = 0; i < mesh.Indicies.size(); i += 3)
+        {
+            Vector3 world[3];
+            bool isInside = false;
+            for (size_t j = 0; j < 3; j++)
+            {
+                Vector4 position = model * Vector4(mesh.Vertecies[mesh.Indicies[i + j]].Position, 1.0f);
+                Vector4 clip = camera.ViewProjection * position;
+                world[j] = Vector3(position);
+                isInside |= std::abs(clip.x) <= clip.w && std::abs(clip.y) <= clip.w && std::abs(clip.z) <= clip.w;
+            }
+            // triangle winding in world space already accounts for mirroring transforms
+            bool isFrontFacing = Dot(Cross(world[1] - world[0], world[2] - world[0]), camera.Position - world[0]) > 0.0f;
+            if (!isInside || !isFrontFacing) continue;
+
+            visibleCount++;
+            MX_REQUIRE(IsIndexDrawn(ranges, i));
+        }
+        return visibleCount;
+    }
+
+    size_t CountDrawnIndicies(const FrameVector<IndexRange>& ranges)
+    {
+        size_t count = 0;
+        for (const auto& range : ranges)
+            count += range.IndexCount;
+        return count;
+    }
+}
+
+MX_TEST(ClusterCuller, FullyVisibleMeshIsMergedIntoOneRange)
+{
+    ModuleScope<FrameAllocator> modules;
+    auto mesh = GenerateSphere(20, 40);
+    auto camera = MakeCamera(MakeVector3(0.0f, 0.0f, 10.0f), MakeVector3(0.0f));
+
+    FrameVector<IndexRange> ranges;
+    size_t culledCount = Cull(mesh, 300, Matrix4x4(1.0f), camera, false, ranges);
+
+    MX_CHECK_EQ(culledCount, (size_t)0);
+    MX_REQUIRE(ranges.size() == 1);
+    MX_CHECK_EQ(ranges[0].IndexOffset, (size_t)300);
+    MX_CHECK_EQ(ranges[0].IndexCount, mesh.Indicies.size());
+}
+
+MX_TEST(ClusterCuller, MeshOutsideFrustrumIsCulled)
+{
+    ModuleScope<FrameAllocator> modules;
+    auto mesh = GenerateSphere(20, 40);
+    auto camera = MakeCamera(MakeVector3(0.0f, 0.0f, 10.0f), MakeVector3(0.0f, 0.0f, 20.0f));
+
+    FrameVector<IndexRange> ranges;
+    size_t culledCount = Cull(mesh, 0, Matrix4x4(1.0f), camera, true, ranges);
+
+    MX_CHECK_EQ(culledCount, mesh.Meshlets.size());
+    MX_CHECK(ranges.empty());
+}
+
+MX_TEST(ClusterCuller, RangesAreAppendedAfterExistingOnes)
+{
+    ModuleScope<FrameAllocator> modules;
+    auto mesh = GenerateSphere(20, 40);
+    auto camera = MakeCamera(MakeVector3(0.0f, 0.0f, 10.0f), MakeVector3(0.0f));
+
+    // range of previous render unit must not be extended even if it ends right where this mesh begins
+    FrameVector<IndexRange> ranges;
+    ranges.push_back(IndexRange{ 0, 300 });
+    Cull(mesh, 300, Matrix4x4(1.0f), camera, false, ranges);
+
+    MX_REQUIRE(ranges.size() == 2);
+    MX_CHECK_EQ(ranges[0].IndexCount, (size_t)300);
+    MX_CHECK_EQ(ranges[1].IndexOffset, (size_t)300);
+}
+
+MX_TEST(ClusterCuller, ConeCullingRemovesBackFaces)
+{
+    ModuleScope<FrameAllocator> modules;
+    auto mesh = GenerateSphere(32, 256);
+    auto camera = MakeCamera(MakeVector3(0.0f, 0.0f, 4.0f), MakeVector3(0.0f));
+
+    FrameVector<IndexRange> frustrumOnly;
+    FrameVector<IndexRange> withCones;
+    Cull(mesh, 0, Matrix4x4(1.0f), camera, false, frustrumOnly);
+    size_t culledCount = Cull(mesh, 0, Matrix4x4(1.0f), camera, true, withCones);
+
+    MX_CHECK_EQ(CountDrawnIndicies(frustrumOnly), mesh.Indicies.size());
+    // camera sees less than a half of the sphere, so a good part of meshlets must be rejected
+    MX_CHECK_GE(culledCount, mesh.Meshlets.size() / 4);
+    MX_CHECK_GE(CheckConservative(mesh, Matrix4x4(1.0f), camera, withCones), (size_t)1);
+}
+
+MX_TEST(ClusterCuller, CullingIsConservative)
+{
+    ModuleScope<FrameAllocator> modules;
+    auto mesh = GenerateSphere(32, 256);
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> offset(-3.0f, 3.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.28f);
+    std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+
+    for (size_t i = 0; i < 50; i++)
+    {
+        auto model = Translate(Matrix4x4(1.0f), MakeVector3(offset(random), offset(random), offset(random)));
+        model = Rotate(model, angle(random), MakeVector3(offset(random), offset(random), offset(random) + 10.0f));
+        model = Scale(model, scale(random));
+
+        auto position = MakeVector3(offset(random), offset(random), offset(random)) * 3.0f;
+        auto camera = MakeCamera(position, MakeVector3(offset(random), offset(random), offset(random)), 0.8f);
+
+        FrameVector<IndexRange> ranges;
+        Cull(mesh, 0, model, camera, true, ranges);
+        CheckConservative(mesh, model, camera, ranges);
+    }
+}
+
+MX_TEST(ClusterCuller, NonUniformScaleDisablesConeCulling)
+{
+    ModuleScope<FrameAllocator> modules;
+    auto mesh = GenerateSphere(32, 256);
+    auto camera = MakeCamera(MakeVector3(0.0f, 0.0f, 8.0f), MakeVector3(0.0f));
+    auto model = Scale(Matrix4x4(1.0f), MakeVector3(1.0f, 3.0f, 0.5f));
+
+    FrameVector<IndexRange> ranges;
+    size_t culledCount = Cull(mesh, 0, model, camera, true, ranges);
+
+    MX_CHECK_EQ(culledCount, (size_t)0);
+    CheckConservative(mesh, model, camera, ranges);
+}
+
+MX_TEST(ClusterCuller, MirroredTransformKeepsFrontFaces)
+{
+    ModuleScope<FrameAllocator> modules;
+    auto mesh = GenerateSphere(32, 256);
+    auto camera = MakeCamera(MakeVector3(0.0f, 0.0f, 4.0f), MakeVector3(0.0f));
+    auto model = Scale(Matrix4x4(1.0f), MakeVector3(-1.0f, 1.0f, 1.0f));
+
+    FrameVector<IndexRange> ranges;
+    size_t culledCount = Cull(mesh, 0, model, camera, true, ranges);
+
+    // mirrored sphere faces inwards, so only meshlets of the half near to camera can be culled
+    MX_CHECK_GE(culledCount, mesh.Meshlets.size() / 8);
+    for (const auto& meshlet : mesh.Meshlets)
+    {
+        if (!IsIndexDrawn(ranges, meshlet.IndexOffset))
+            MX_CHECK(meshlet.Bounds.Center.z > 0.0f);
+    }
+    MX_CHECK_GE(CheckConservative(mesh, model, camera, ranges), (size_t)1);
+}
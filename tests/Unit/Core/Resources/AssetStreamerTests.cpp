@@ -0,0 +1,219 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Core/Resources/AssetStreamer.h"
+
+#include <random>
+#include <limits>
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+namespace
+{
+    constexpr size_t MiB = 1024 * 1024;
+
+    void AddEntry(AssetStreamerImpl& streamer, StreamingState state, float priority, size_t byteSize = 0, size_t lastUsedFrame = 0)
+    {
+        auto& entry = streamer.meshes.emplace_back();
+        entry.State = state;
+        entry.Priority = priority;
+        entry.BasePriority = priority;
+        entry.VertexByteSize = byteSize / 2;
+        entry.IndexByteSize = byteSize - byteSize / 2;
+        entry.LastUsedFrame = lastUsedFrame;
+    }
+
+    size_t GetLoadCount(const MxVector<StreamingAction>& actions)
+    {
+        size_t count = 0;
+        for (const auto& action : actions)
+            count += action.UploadByteSize == 0;
+        return count;
+    }
+
+    size_t GetUploadedBytes(const MxVector<StreamingAction>& actions)
+    {
+        size_t bytes = 0;
+        for (const auto& action : actions)
+            bytes += action.UploadByteSize;
+        return bytes;
+    }
+}
+
+MX_TEST(AssetStreamer, UploadsNeverExceedFrameBudget)
+{
+    AssetStreamerImpl streamer;
+    streamer.uploadBudget = 8 * MiB;
+    AddEntry(streamer, StreamingState::UPLOADING, 1.0f, 5 * MiB);
+    AddEntry(streamer, StreamingState::UPLOADING, 3.0f, 5 * MiB);
+    AddEntry(streamer, StreamingState::UPLOADING, 2.0f, 5 * MiB);
+
+    const auto& actions = AssetStreamer::PlanRequests(streamer, 0, 4);
+    MX_REQUIRE(actions.size() == 2);
+    // highest priority mesh is uploaded completely, the next one receives rest of the budget
+    MX_CHECK_EQ(actions[0].EntryIndex, (size_t)1);
+    MX_CHECK_EQ(actions[0].UploadByteSize, 5 * MiB);
+    MX_CHECK_EQ(actions[1].EntryIndex, (size_t)2);
+    MX_CHECK_EQ(actions[1].UploadByteSize, 3 * MiB);
+    MX_CHECK_EQ(GetUploadedBytes(actions), streamer.uploadBudget);
+}
+
+MX_TEST(AssetStreamer, PartialUploadContinuesFromUploadedBytes)
+{
+    AssetStreamerImpl streamer;
+    streamer.uploadBudget = 8 * MiB;
+    AddEntry(streamer, StreamingState::UPLOADING, 1.0f, 10 * MiB);
+    streamer.meshes[0].UploadedBytes = 7 * MiB;
+
+    const auto& actions = AssetStreamer::PlanRequests(streamer, 0, 4);
+    MX_REQUIRE(actions.size() == 1);
+    MX_CHECK_EQ(actions[0].UploadByteSize, 3 * MiB);
+}
+
+MX_TEST(AssetStreamer, LoadsInFlightAreLimited)
+{
+    AssetStreamerImpl streamer;
+    for (size_t i = 0; i < 6; i++)
+        AddEntry(streamer, StreamingState::QUEUED, float(i));
+
+    // one mesh is already loading, so only two more loads may start, both of highest priority
+    const auto& actions = AssetStreamer::PlanRequests(streamer, 1, 3);
+    MX_REQUIRE(actions.size() == 2);
+    MX_CHECK_EQ(GetLoadCount(actions), (size_t)2);
+    MX_CHECK_EQ(actions[0].EntryIndex, (size_t)5);
+    MX_CHECK_EQ(actions[1].EntryIndex, (size_t)4);
+
+    MX_CHECK(AssetStreamer::PlanRequests(streamer, 3, 3).empty());
+}
+
+MX_TEST(AssetStreamer, OnlyUsedEvictedMeshesAreReloaded)
+{
+    AssetStreamerImpl streamer;
+    streamer.frameIndex = 10;
+    AddEntry(streamer, StreamingState::EVICTED, 1.0f, MiB, 2);
+    AddEntry(streamer, StreamingState::EVICTED, 1.0f, MiB, 9);
+    AddEntry(streamer, StreamingState::RESIDENT, 5.0f, MiB, 10);
+    AddEntry(streamer, StreamingState::LOADING, 5.0f, MiB, 10);
+    AddEntry(streamer, StreamingState::FAILED, 5.0f, MiB, 10);
+
+    const auto& actions = AssetStreamer::PlanRequests(streamer, 0, 4);
+    MX_REQUIRE(actions.size() == 1);
+    MX_CHECK_EQ(actions[0].EntryIndex, (size_t)1);
+    MX_CHECK_EQ(actions[0].UploadByteSize, (size_t)0);
+}
+
+MX_TEST(AssetStreamer, EvictionSelectsLeastRecentlyUsedMesh)
+{
+    AssetStreamerImpl streamer;
+    streamer.frameIndex = 20;
+    AddEntry(streamer, StreamingState::RESIDENT, 0.0f, MiB, 15);
+    AddEntry(streamer, StreamingState::RESIDENT, 0.0f, MiB, 19); // used in previous frame
+    AddEntry(streamer, StreamingState::UPLOADING, 0.0f, MiB, 1);
+    AddEntry(streamer, StreamingState::RESIDENT, 0.0f, MiB, 7);
+    AddEntry(streamer, StreamingState::RESIDENT, 0.0f, MiB, 20);
+    MX_CHECK_EQ(AssetStreamer::SelectEvictionVictim(streamer), (size_t)3);
+
+    streamer.meshes[3].State = StreamingState::EVICTED;
+    MX_CHECK_EQ(AssetStreamer::SelectEvictionVictim(streamer), (size_t)0);
+
+    streamer.meshes[0].LastUsedFrame = 20;
+    MX_CHECK_EQ(AssetStreamer::SelectEvictionVictim(streamer), streamer.meshes.size());
+}
+
+MX_TEST(AssetStreamer, SimulatedStreamingStaysWithinBudgets)
+{
+    // streams random scene frame by frame, loads complete one frame after they were started
+    AssetStreamerImpl streamer;
+    streamer.uploadBudget = 4 * MiB;
+    const size_t maxLoadingCount = 3;
+    std::mt19937 random(7);
+    std::uniform_int_distribution<size_t> sizes(64 * 1024, 12 * MiB);
+    std::uniform_real_distribution<float> priorities(0.0f, 10.0f);
+
+    size_t totalBytes = 0;
+    MxVector<size_t> meshSizes;
+    for (size_t i = 0; i < 50; i++)
+    {
+        AddEntry(streamer, StreamingState::QUEUED, priorities(random));
+        meshSizes.push_back(sizes(random));
+        totalBytes += meshSizes.back();
+    }
+
+    size_t maxFrameUpload = 0;
+    size_t maxLoadingSeen = 0;
+    size_t frameCount = 0;
+    bool prioritiesRespected = true;
+    for (; frameCount < 1000; frameCount++)
+    {
+        streamer.frameIndex++;
+        size_t loadingCount = 0;
+        for (size_t i = 0; i < streamer.meshes.size(); i++)
+        {
+            auto& entry = streamer.meshes[i];
+            if (entry.State != StreamingState::LOADING) continue;
+            entry.State = StreamingState::UPLOADING;
+            entry.VertexByteSize = meshSizes[i] / 2;
+            entry.IndexByteSize = meshSizes[i] - meshSizes[i] / 2;
+        }
+
+        const auto& actions = AssetStreamer::PlanRequests(streamer, loadingCount, maxLoadingCount);
+        float lastUploadPriority = std::numeric_limits<float>::max();
+        for (const auto& action : actions)
+        {
+            auto& entry = streamer.meshes[action.EntryIndex];
+            if (action.UploadByteSize == 0)
+            {
+                entry.State = StreamingState::LOADING;
+                continue;
+            }
+            prioritiesRespected &= entry.Priority <= lastUploadPriority;
+            lastUploadPriority = entry.Priority;
+            entry.UploadedBytes += action.UploadByteSize;
+            if (entry.UploadedBytes == entry.VertexByteSize + entry.IndexByteSize)
+                entry.State = StreamingState::RESIDENT;
+        }
+        maxFrameUpload = std::max(maxFrameUpload, GetUploadedBytes(actions));
+        maxLoadingSeen = std::max(maxLoadingSeen, GetLoadCount(actions));
+
+        bool allResident = true;
+        for (const auto& entry : streamer.meshes)
+            allResident &= entry.State == StreamingState::RESIDENT;
+        if (allResident) break;
+    }
+
+    MX_CHECK_LE(maxFrameUpload, streamer.uploadBudget);
+    MX_CHECK_LE(maxLoadingSeen, maxLoadingCount);
+    MX_CHECK(prioritiesRespected);
+    // budget is used completely while there is enough loaded data, so streaming takes close to minimal number of frames.
+    // First frame only starts loading and the last one may be partially used
+    size_t minFrameCount = (totalBytes + streamer.uploadBudget - 1) / streamer.uploadBudget;
+    MX_CHECK_LE(frameCount + 1, minFrameCount + 2);
+}
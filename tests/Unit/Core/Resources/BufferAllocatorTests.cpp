@@ -0,0 +1,276 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Core/Resources/BufferAllocator.h"
+
+#include <random>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+namespace
+{
+    /*!
+    replays sequence of equal allocations against growth policy, as free list allocator does when it runs out of space
+    \returns number of times storage had to be relocated
+    */
+    size_t CountRelocations(size_t initialSize, size_t allocationSize, size_t allocationCount, float growthFactor)
+    {
+        size_t capacity = initialSize;
+        size_t used = 0;
+        size_t relocations = 0;
+        for (size_t i = 0; i < allocationCount; i++)
+        {
+            used += allocationSize;
+            if (used > capacity)
+            {
+                capacity = BufferAllocator::GetGrowthCapacity(capacity, used, growthFactor);
+                relocations++;
+            }
+        }
+        return relocations;
+    }
+
+    /*!
+    generates heap layout with random sizes, holes and alignments
+    \param movableChance probability of allocation being movable
+    */
+    MxVector<BufferAllocationInfo> GenerateLayout(std::mt19937& random, size_t allocationCount, float movableChance)
+    {
+        constexpr size_t Alignments[] = { 1, 4, 16, 32, 256 };
+        std::uniform_int_distribution<size_t> size(1, 64 * 1024);
+        std::uniform_int_distribution<size_t> gap(0, 3);
+        std::uniform_int_distribution<size_t> alignment(0, std::size(Alignments) - 1);
+        std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+
+        MxVector<BufferAllocationInfo> layout;
+        size_t offset = 0;
+        for (size_t i = 0; i < allocationCount; i++)
+        {
+            BufferAllocationInfo allocation;
+            allocation.Alignment = Alignments[alignment(random)];
+            // most allocations are packed, others leave hole of freed allocation behind
+            if (gap(random) == 0) offset += size(random);
+            allocation.Offset = (offset + allocation.Alignment - 1) / allocation.Alignment * allocation.Alignment;
+            allocation.Size = size(random);
+            allocation.IsMovable = chance(random) < movableChance;
+            offset = allocation.Offset + allocation.Size;
+            layout.push_back(allocation);
+        }
+        return layout;
+    }
+
+    bool Overlaps(size_t offset1, size_t size1, size_t offset2, size_t size2)
+    {
+        return offset1 < offset2 + size2 && offset2 < offset1 + size1;
+    }
+
+    /*!
+    checks that plan can be executed while sources are still alive
+    \returns number of violated invariants
+    */
+    size_t ValidatePlan(const MxVector<BufferAllocationInfo>& layout, const MxVector<BufferMove>& plan, size_t byteBudget)
+    {
+        size_t errors = 0;
+        size_t movedBytes = 0;
+        MxVector<bool> isMoved(layout.size(), false);
+        for (size_t i = 0; i < plan.size(); i++)
+        {
+            const auto& move = plan[i];
+            const auto& allocation = layout[move.Allocation];
+            errors += !allocation.IsMovable;
+            errors += isMoved[move.Allocation];
+            errors += move.From != allocation.Offset || move.Size != allocation.Size;
+            errors += move.To >= move.From;
+            errors += move.To % allocation.Alignment != 0;
+            for (const auto& other : layout)
+                errors += Overlaps(move.To, move.Size, other.Offset, other.Size);
+            for (size_t j = 0; j < i; j++)
+                errors += Overlaps(move.To, move.Size, plan[j].To, plan[j].Size);
+
+            isMoved[move.Allocation] = true;
+            movedBytes += move.Size;
+        }
+        errors += movedBytes > byteBudget;
+        return errors;
+    }
+
+    MxVector<BufferAllocationInfo> ApplyPlan(MxVector<BufferAllocationInfo> layout, const MxVector<BufferMove>& plan)
+    {
+        for (const auto& move : plan)
+            layout[move.Allocation].Offset = move.To;
+        std::sort(layout.begin(), layout.end(), [](const auto& a1, const auto& a2) { return a1.Offset < a2.Offset; });
+        return layout;
+    }
+}
+
+MX_TEST(BufferAllocator, GrowthCapacityIsGeometric)
+{
+    MX_CHECK_EQ(BufferAllocator::GetGrowthCapacity(0, 100, 2.0f), (size_t)100);
+    MX_CHECK_EQ(BufferAllocator::GetGrowthCapacity(1000, 1001, 2.0f), (size_t)2000);
+    MX_CHECK_EQ(BufferAllocator::GetGrowthCapacity(1000, 1001, 1.5f), (size_t)1500);
+    // requested size which exceeds grown storage is used as is
+    MX_CHECK_EQ(BufferAllocator::GetGrowthCapacity(1000, 5000, 2.0f), (size_t)5000);
+}
+
+MX_TEST(BufferAllocator, GrowthFactorOfOneGrowsExactly)
+{
+    MX_CHECK_EQ(BufferAllocator::GetGrowthCapacity(1000, 1001, 1.0f), (size_t)1001);
+    // factors below one would shrink storage, so they are treated as one
+    MX_CHECK_EQ(BufferAllocator::GetGrowthCapacity(1000, 1001, 0.5f), (size_t)1001);
+    MX_CHECK_EQ(BufferAllocator::GetGrowthCapacity(1000, 1001, 0.0f), (size_t)1001);
+}
+
+MX_TEST(BufferAllocator, SequentialAllocationsRelocateLogarithmically)
+{
+    constexpr size_t InitialSize = 16 * 1024;
+    constexpr size_t AllocationSize = 1024;
+    constexpr size_t AllocationCount = 10000;
+
+    // 10 MB of allocations with doubling storage: log2(10 MB / 16 KB) relocations
+    MX_CHECK_LE(CountRelocations(InitialSize, AllocationSize, AllocationCount, 2.0f), (size_t)10);
+    MX_CHECK_LE(CountRelocations(InitialSize, AllocationSize, AllocationCount, 1.5f), (size_t)17);
+    MX_CHECK_EQ(CountRelocations(InitialSize, AllocationSize, AllocationCount, 1.0f), AllocationCount - InitialSize / AllocationSize);
+}
+
+MX_TEST(BufferAllocator, FragmentationOfPackedLayoutIsZero)
+{
+    MxVector<BufferAllocationInfo> layout = {
+        { 0, 100, 1, true },
+        { 100, 300, 1, true },
+    };
+    auto fragmentation = BufferAllocator::ComputeFragmentation(layout);
+    MX_CHECK_EQ(fragmentation.LiveBytes, (size_t)400);
+    MX_CHECK_EQ(fragmentation.UsedBytes, (size_t)400);
+    MX_CHECK_NEAR(fragmentation.Ratio, 0.0f, 1e-6f);
+    MX_CHECK(BufferAllocator::PlanDefragmentation(layout, 1024 * 1024).empty());
+}
+
+MX_TEST(BufferAllocator, PlanMovesTopAllocationIntoLowestHole)
+{
+    MxVector<BufferAllocationInfo> layout = {
+        { 0, 1000, 1, false },
+        { 8000, 1000, 1, false },
+        { 20000, 1000, 1, true },
+    };
+    MX_CHECK_NEAR(BufferAllocator::ComputeFragmentation(layout).Ratio, 1.0f - 3000.0f / 21000.0f, 1e-6f);
+
+    auto plan = BufferAllocator::PlanDefragmentation(layout, 1024 * 1024);
+    MX_REQUIRE(plan.size() == 1);
+    MX_CHECK_EQ(plan[0].Allocation, (size_t)2);
+    MX_CHECK_EQ(plan[0].From, (size_t)20000);
+    MX_CHECK_EQ(plan[0].To, (size_t)1000);
+    MX_CHECK_EQ(ValidatePlan(layout, plan, 1024 * 1024), (size_t)0);
+
+    auto defragmented = ApplyPlan(layout, plan);
+    MX_CHECK_NEAR(BufferAllocator::ComputeFragmentation(defragmented).Ratio, 1.0f - 3000.0f / 9000.0f, 1e-6f);
+}
+
+MX_TEST(BufferAllocator, PlanNeverMovesPinnedAllocations)
+{
+    MxVector<BufferAllocationInfo> layout = {
+        { 0, 1000, 1, false },
+        { 50000, 1000, 1, false },
+        { 60000, 1000, 1, false },
+    };
+    MX_CHECK(BufferAllocator::PlanDefragmentation(layout, 1024 * 1024).empty());
+}
+
+MX_TEST(BufferAllocator, PlanSkipsAllocationsOverBudget)
+{
+    // top allocation does not fit into budget, but one below it still does
+    MxVector<BufferAllocationInfo> layout = {
+        { 0, 1000, 1, false },
+        { 40000, 1000, 1, true },
+        { 41000, 8000, 1, true },
+    };
+    auto plan = BufferAllocator::PlanDefragmentation(layout, 4000);
+    MX_REQUIRE(plan.size() == 1);
+    MX_CHECK_EQ(plan[0].Allocation, (size_t)1);
+    MX_CHECK_EQ(plan[0].To, (size_t)1000);
+    MX_CHECK_EQ(ValidatePlan(layout, plan, 4000), (size_t)0);
+}
+
+MX_TEST(BufferAllocator, PlanRespectsAlignment)
+{
+    MxVector<BufferAllocationInfo> layout = {
+        { 0, 1001, 1, false },
+        { 20000, 1000, 256, true },
+    };
+    auto plan = BufferAllocator::PlanDefragmentation(layout, 1024 * 1024);
+    MX_REQUIRE(plan.size() == 1);
+    MX_CHECK_EQ(plan[0].To, (size_t)1024);
+}
+
+MX_TEST(BufferAllocator, RandomizedPlansAreValid)
+{
+    constexpr size_t Budgets[] = { 0, 4 * 1024, 256 * 1024, 4 * 1024 * 1024, std::numeric_limits<size_t>::max() };
+    for (uint32_t seed = 0; seed < 200; seed++)
+    {
+        std::mt19937 random(seed);
+        auto layout = GenerateLayout(random, 1 + seed % 64, (seed % 5) / 4.0f);
+        for (size_t budget : Budgets)
+        {
+            auto plan = BufferAllocator::PlanDefragmentation(layout, budget);
+            MX_CHECK_EQ(ValidatePlan(layout, plan, budget), (size_t)0);
+
+            auto defragmented = ApplyPlan(layout, plan);
+            auto before = BufferAllocator::ComputeFragmentation(layout);
+            auto after = BufferAllocator::ComputeFragmentation(defragmented);
+            MX_CHECK_EQ(after.LiveBytes, before.LiveBytes);
+            MX_CHECK_LE(after.UsedBytes, before.UsedBytes);
+        }
+    }
+}
+
+MX_TEST(BufferAllocator, RepeatedPlansConverge)
+{
+    // defragmentation runs each frame with small budget, and should keep compacting heap until nothing can be moved
+    for (uint32_t seed = 0; seed < 50; seed++)
+    {
+        std::mt19937 random(seed);
+        auto layout = GenerateLayout(random, 256, 1.0f);
+        auto initial = BufferAllocator::ComputeFragmentation(layout);
+
+        size_t frames = 0;
+        for (; frames < 1000; frames++)
+        {
+            auto plan = BufferAllocator::PlanDefragmentation(layout, 256 * 1024);
+            if (plan.empty()) break;
+            MX_CHECK_EQ(ValidatePlan(layout, plan, 256 * 1024), (size_t)0);
+            layout = ApplyPlan(std::move(layout), plan);
+        }
+        MX_CHECK(frames < 1000);
+        MX_CHECK_LE(BufferAllocator::ComputeFragmentation(layout).Ratio, initial.Ratio);
+    }
+}
@@ -0,0 +1,359 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Core/Resources/MeshData.h"
+#include "Utilities/Threading/ThreadPool.h"
+
+#include <random>
+#include <array>
+#include <cmath>
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+namespace
+{
+    using MeshModules = ModuleScope<ThreadPool>;
+    constexpr float Epsilon = 1e-4f;
+
+    /*!
+    serial implementation of RegenerateNormals which MeshData used before accumulation was parallelized
+    */
+    void ReferenceRegenerateNormals(MeshData::VertexData& vertecies, const MeshData::IndexData& indicies)
+    {
+        for (auto& vertex : vertecies)
+        {
+            vertex.Normal = MakeVector3(0.0f);
+            vertex.Tangent = MakeVector3(0.0f);
+            vertex.Bitangent = MakeVector3(0.0f);
+        }
+
+        for (size_t i = 0; i < indicies.size() / 3; i++)
+        {
+            std::array triangle = {
+                vertecies[indicies[3 * i + 0]],
+                vertecies[indicies[3 * i + 1]],
+                vertecies[indicies[3 * i + 2]],
+            };
+
+            auto normal = ComputeNormal(triangle[0].Position, triangle[1].Position, triangle[2].Position);
+            auto tanbitan = ComputeTangentSpace(
+                triangle[0].Position, triangle[1].Position, triangle[2].Position,
+                triangle[0].TexCoord, triangle[1].TexCoord, triangle[2].TexCoord
+            );
+
+            for (auto& vertex : triangle)
+            {
+                vertex.Normal += normal;
+                vertex.Tangent += tanbitan[0];
+                vertex.Bitangent += tanbitan[1];
+            }
+
+            for (size_t j = 0; j < triangle.size(); j++)
+                vertecies[indicies[3 * i + j]] = triangle[j];
+        }
+
+        for (auto& vertex : vertecies)
+        {
+            vertex.Normal = Normalize(vertex.Normal);
+            vertex.Tangent = Normalize(vertex.Tangent);
+            vertex.Bitangent = Normalize(vertex.Bitangent);
+        }
+    }
+
+    /*!
+    serial implementation of RegenerateTangentSpace which MeshData used before accumulation was parallelized
+    */
+    void ReferenceRegenerateTangentSpace(MeshData::VertexData& vertecies, const MeshData::IndexData& indicies)
+    {
+        for (auto& vertex : vertecies)
+        {
+            vertex.Tangent = MakeVector3(0.0f);
+            vertex.Bitangent = MakeVector3(0.0f);
+        }
+
+        for (size_t i = 0; i < indicies.size() / 3; i++)
+        {
+            std::array triangle = {
+                vertecies[indicies[3 * i + 0]],
+                vertecies[indicies[3 * i + 1]],
+                vertecies[indicies[3 * i + 2]],
+            };
+
+            auto tanbitan = ComputeTangentSpace(
+                triangle[0].Position, triangle[1].Position, triangle[2].Position,
+                triangle[0].TexCoord, triangle[1].TexCoord, triangle[2].TexCoord
+            );
+
+            for (auto& vertex : triangle)
+            {
+                vertex.Tangent += tanbitan[0];
+                vertex.Bitangent += tanbitan[1];
+            }
+
+            for (size_t j = 0; j < triangle.size(); j++)
+                vertecies[indicies[3 * i + j]] = triangle[j];
+        }
+
+        for (auto& vertex : vertecies)
+        {
+            vertex.Tangent = Normalize(vertex.Tangent);
+            vertex.Bitangent = Normalize(vertex.Bitangent);
+        }
+    }
+
+    AABB ReferenceBoundingBox(const MeshData::VertexData& vertecies)
+    {
+        AABB result{ MakeVector3(0.0f), MakeVector3(0.0f) };
+        if (vertecies.empty()) return result;
+
+        result = AABB{ vertecies[0].Position, vertecies[0].Position };
+        for (const auto& vertex : vertecies)
+        {
+            result.Min = VectorMin(result.Min, vertex.Position);
+            result.Max = VectorMax(result.Max, vertex.Position);
+        }
+        return result;
+    }
+
+    float ReferenceBoundingRadius(const MeshData::VertexData& vertecies, const Vector3& center)
+    {
+        float maxRadius = 0.0f;
+        for (const auto& vertex : vertecies)
+            maxRadius = Max(maxRadius, Length2(vertex.Position - center));
+        return std::sqrt(maxRadius);
+    }
+
+    struct TestMesh
+    {
+        MeshData::VertexData Vertecies;
+        MeshData::IndexData Indicies;
+    };
+
+    /*!
+    generates uneven grid with random texture coordinates. Each row of quads references two rows of vertecies,
+    so triangles of neighbour chunks share vertecies on chunk borders
+    */
+    TestMesh GenerateGrid(size_t size, std::mt19937& random)
+    {
+        std::uniform_real_distribution<float> height(-0.5f, 0.5f);
+        std::uniform_real_distribution<float> uv(0.0f, 1.0f);
+
+        TestMesh mesh;
+        mesh.Vertecies.resize(size * size);
+        for (size_t y = 0; y < size; y++)
+        {
+            for (size_t x = 0; x < size; x++)
+            {
+                auto& vertex = mesh.Vertecies[y * size + x];
+                vertex.Position = MakeVector3((float)x, height(random), (float)y);
+                vertex.TexCoord = MakeVector2(uv(random), uv(random));
+            }
+        }
+        for (size_t y = 0; y + 1 < size; y++)
+        {
+            for (size_t x = 0; x + 1 < size; x++)
+            {
+                uint32_t i = uint32_t(y * size + x);
+                uint32_t quad[6] = { i, i + (uint32_t)size, i + 1, i + 1, i + (uint32_t)size, i + (uint32_t)size + 1 };
+                mesh.Indicies.insert(mesh.Indicies.end(), std::begin(quad), std::end(quad));
+            }
+        }
+        return mesh;
+    }
+
+    void ShuffleTriangles(TestMesh& mesh, std::mt19937& random)
+    {
+        size_t triangleCount = mesh.Indicies.size() / 3;
+        for (size_t i = triangleCount; i > 1; i--)
+        {
+            size_t j = std::uniform_int_distribution<size_t>(0, i - 1)(random);
+            for (size_t k = 0; k < 3; k++)
+                std::swap(mesh.Indicies[3 * (i - 1) + k], mesh.Indicies[3 * j + k]);
+        }
+    }
+
+    /*!
+    appends triangles with repeated vertecies. They are attached to separate vertecies, which get undefined vectors in both implementations
+    */
+    void AppendDegenerateTriangles(TestMesh& mesh, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            uint32_t first = (uint32_t)mesh.Vertecies.size();
+            Vertex vertex;
+            vertex.Position = MakeVector3((float)i, 0.0f, -1.0f);
+            vertex.TexCoord = MakeVector2(0.5f, (float)i);
+            mesh.Vertecies.push_back(vertex);
+            vertex.Position.x += 1.0f;
+            vertex.TexCoord.x += 0.25f;
+            mesh.Vertecies.push_back(vertex);
+
+            uint32_t triangles[6] = { first, first, first + 1, first + 1, first + 1, first + 1 };
+            mesh.Indicies.insert(mesh.Indicies.end(), std::begin(triangles), std::end(triangles));
+        }
+    }
+
+    /*!
+    \returns number of components which differ by more than epsilon, or which are NaN in only one of vectors
+    */
+    size_t CountMismatches(const Vector3& v1, const Vector3& v2)
+    {
+        size_t mismatches = 0;
+        for (size_t i = 0; i < 3; i++)
+        {
+            bool isNaN1 = std::isnan(v1[i]), isNaN2 = std::isnan(v2[i]);
+            if (isNaN1 != isNaN2) mismatches++;
+            else if (!isNaN1 && std::abs(v1[i] - v2[i]) > Epsilon) mismatches++;
+        }
+        return mismatches;
+    }
+
+    size_t CountMismatches(const MeshData::VertexData& vertecies1, const MeshData::VertexData& vertecies2)
+    {
+        size_t mismatches = 0;
+        for (size_t i = 0; i < vertecies1.size(); i++)
+        {
+            mismatches += CountMismatches(vertecies1[i].Normal, vertecies2[i].Normal);
+            mismatches += CountMismatches(vertecies1[i].Tangent, vertecies2[i].Tangent);
+            mismatches += CountMismatches(vertecies1[i].Bitangent, vertecies2[i].Bitangent);
+        }
+        return mismatches;
+    }
+
+    void CheckNormalsEquivalence(const TestMesh& mesh)
+    {
+        auto expected = mesh.Vertecies;
+        auto actual = mesh.Vertecies;
+        ReferenceRegenerateNormals(expected, mesh.Indicies);
+        MeshData::RegenerateNormals(actual, mesh.Indicies);
+        MX_CHECK_EQ(CountMismatches(expected, actual), (size_t)0);
+    }
+
+    void CheckTangentSpaceEquivalence(const TestMesh& mesh)
+    {
+        auto expected = mesh.Vertecies;
+        auto actual = mesh.Vertecies;
+        ReferenceRegenerateTangentSpace(expected, mesh.Indicies);
+        MeshData::RegenerateTangentSpace(actual, mesh.Indicies);
+        MX_CHECK_EQ(CountMismatches(expected, actual), (size_t)0);
+    }
+}
+
+MX_TEST(MeshData, RegenerateNormalsMatchesSerialOnSmallMesh)
+{
+    MeshModules modules;
+    std::mt19937 random(1);
+    auto mesh = GenerateGrid(8, random);
+    CheckNormalsEquivalence(mesh);
+    CheckTangentSpaceEquivalence(mesh);
+}
+
+MX_TEST(MeshData, RegenerateNormalsMatchesSerialAcrossChunks)
+{
+    // 2 * 199 * 199 triangles are split into several chunks, which share vertecies on their borders
+    MeshModules modules;
+    std::mt19937 random(2);
+    auto mesh = GenerateGrid(200, random);
+    CheckNormalsEquivalence(mesh);
+    CheckTangentSpaceEquivalence(mesh);
+}
+
+MX_TEST(MeshData, RegenerateNormalsMatchesSerialWithShuffledTriangles)
+{
+    // every chunk references vertecies from the whole mesh, so all accumulators overlap
+    MeshModules modules;
+    std::mt19937 random(3);
+    auto mesh = GenerateGrid(150, random);
+    ShuffleTriangles(mesh, random);
+    CheckNormalsEquivalence(mesh);
+    CheckTangentSpaceEquivalence(mesh);
+}
+
+MX_TEST(MeshData, RegenerateNormalsMatchesSerialWithDegenerateTriangles)
+{
+    MeshModules modules;
+    std::mt19937 random(4);
+    auto mesh = GenerateGrid(120, random);
+    AppendDegenerateTriangles(mesh, 100);
+    ShuffleTriangles(mesh, random);
+    CheckNormalsEquivalence(mesh);
+    CheckTangentSpaceEquivalence(mesh);
+}
+
+MX_TEST(MeshData, RegenerateNormalsKeepsUnusedVertecies)
+{
+    // vertecies which are not referenced by any triangle get undefined vectors in both implementations
+    MeshModules modules;
+    std::mt19937 random(5);
+    auto mesh = GenerateGrid(64, random);
+    mesh.Vertecies.resize(mesh.Vertecies.size() + 10);
+    CheckNormalsEquivalence(mesh);
+    CheckTangentSpaceEquivalence(mesh);
+}
+
+MX_TEST(MeshData, RegenerateTangentSpaceKeepsNormals)
+{
+    MeshModules modules;
+    std::mt19937 random(6);
+    auto mesh = GenerateGrid(32, random);
+    for (auto& vertex : mesh.Vertecies)
+        vertex.Normal = MakeVector3(0.0f, 1.0f, 0.0f);
+
+    MeshData::RegenerateTangentSpace(mesh.Vertecies, mesh.Indicies);
+    size_t changedNormals = 0;
+    for (const auto& vertex : mesh.Vertecies)
+        changedNormals += vertex.Normal != MakeVector3(0.0f, 1.0f, 0.0f);
+    MX_CHECK_EQ(changedNormals, (size_t)0);
+}
+
+MX_TEST(MeshData, BoundingGeometryMatchesSerial)
+{
+    MeshModules modules;
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> coordinate(-100.0f, 100.0f);
+    constexpr size_t VertexCounts[] = { 0, 1, 3, 16 * 1024 - 1, 16 * 1024 + 1, 100000 };
+    for (size_t vertexCount : VertexCounts)
+    {
+        MeshData::VertexData vertecies(vertexCount);
+        for (auto& vertex : vertecies)
+            vertex.Position = MakeVector3(coordinate(random), coordinate(random), coordinate(random));
+
+        auto expectedBox = ReferenceBoundingBox(vertecies);
+        auto box = MeshData::ComputeBoundingBox(vertecies);
+        MX_CHECK(box.Min == expectedBox.Min);
+        MX_CHECK(box.Max == expectedBox.Max);
+
+        auto sphere = MeshData::ComputeBoundingSphere(vertecies, box.GetCenter());
+        MX_CHECK(sphere.Center == expectedBox.GetCenter());
+        MX_CHECK_NEAR(sphere.Radius, ReferenceBoundingRadius(vertecies, expectedBox.GetCenter()), Epsilon);
+    }
+}
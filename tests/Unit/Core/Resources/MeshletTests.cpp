@@ -0,0 +1,257 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Core/Resources/Meshlet.h"
+
+#include <random>
+#include <cmath>
+
+using namespace MxEngine;
+
+namespace
+{
+    struct TestMesh
+    {
+        MxVector<Vertex> Vertecies;
+        MxVector<uint32_t> Indicies;
+    };
+
+    /*!
+    generates outward-facing uv-sphere. Triangles are emitted row by row
+    */
+    TestMesh GenerateSphere(size_t stacks, size_t slices)
+    {
+        constexpr float Pi = 3.14159265358979f;
+        TestMesh mesh;
+        for (size_t stack = 0; stack <= stacks; stack++)
+        {
+            float phi = Pi * (float)stack / (float)stacks;
+            for (size_t slice = 0; slice <= slices; slice++)
+            {
+                float theta = 2.0f * Pi * (float)slice / (float)slices;
+                Vertex vertex;
+                vertex.Position = MakeVector3(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta));
+                mesh.Vertecies.push_back(vertex);
+            }
+        }
+        for (size_t stack = 0; stack < stacks; stack++)
+        {
+            for (size_t slice = 0; slice < slices; slice++)
+            {
+                uint32_t i0 = uint32_t(stack * (slices + 1) + slice);
+                uint32_t i2 = i0 + uint32_t(slices + 1);
+                uint32_t quad[6] = { i0, i0 + 1, i2, i0 + 1, i2 + 1, i2 };
+                mesh.Indicies.insert(mesh.Indicies.end(), std::begin(quad), std::end(quad));
+            }
+        }
+        return mesh;
+    }
+
+    /*!
+    generates flat grid in XZ plane facing +Y
+    */
+    TestMesh GenerateGrid(size_t size)
+    {
+        TestMesh mesh;
+        for (size_t y = 0; y < size; y++)
+        {
+            for (size_t x = 0; x < size; x++)
+            {
+                Vertex vertex;
+                vertex.Position = MakeVector3((float)x, 0.0f, (float)y);
+                mesh.Vertecies.push_back(vertex);
+            }
+        }
+        for (size_t y = 0; y + 1 < size; y++)
+        {
+            for (size_t x = 0; x + 1 < size; x++)
+            {
+                uint32_t i = uint32_t(y * size + x);
+                uint32_t quad[6] = { i, i + (uint32_t)size, i + 1, i + 1, i + (uint32_t)size, i + (uint32_t)size + 1 };
+                mesh.Indicies.insert(mesh.Indicies.end(), std::begin(quad), std::end(quad));
+            }
+        }
+        return mesh;
+    }
+
+    void ShuffleTriangles(MxVector<uint32_t>& indicies, std::mt19937& random)
+    {
+        size_t triangleCount = indicies.size() / 3;
+        for (size_t i = triangleCount; i > 1; i--)
+        {
+            size_t j = std::uniform_int_distribution<size_t>(0, i - 1)(random);
+            for (size_t k = 0; k < 3; k++)
+                std::swap(indicies[3 * (i - 1) + k], indicies[3 * j + k]);
+        }
+    }
+
+    size_t CountUniqueVertecies(const Meshlet& meshlet, const MxVector<uint32_t>& indicies)
+    {
+        MxVector<uint32_t> unique;
+        unique.assign(indicies.begin() + meshlet.IndexOffset, indicies.begin() + meshlet.IndexOffset + meshlet.IndexCount);
+        std::sort(unique.begin(), unique.end());
+        return size_t(std::unique(unique.begin(), unique.end()) - unique.begin());
+    }
+
+    /*!
+    checks that meshlets cover the whole index buffer in order, without gaps or overlaps, and respect vertex and triangle limits
+    */
+    void CheckCoverage(const MxVector<Meshlet>& meshlets, const MxVector<uint32_t>& indicies)
+    {
+        MX_REQUIRE(!meshlets.empty());
+        size_t nextIndex = 0;
+        for (const auto& meshlet : meshlets)
+        {
+            MX_REQUIRE(meshlet.IndexOffset == nextIndex);
+            MX_CHECK(meshlet.IndexCount > 0);
+            MX_CHECK_EQ(meshlet.IndexCount % 3, 0u);
+            MX_CHECK_LE((size_t)meshlet.IndexCount, 3 * MeshletBuilder::MaxTriangles);
+            MX_CHECK_LE((size_t)meshlet.VertexCount, MeshletBuilder::MaxVertecies);
+            MX_CHECK_EQ((size_t)meshlet.VertexCount, CountUniqueVertecies(meshlet, indicies));
+            nextIndex += meshlet.IndexCount;
+        }
+        MX_CHECK_EQ(nextIndex, indicies.size());
+    }
+
+    void CheckBounds(const MxVector<Meshlet>& meshlets, const TestMesh& mesh)
+    {
+        for (const auto& meshlet : meshlets)
+        {
+            for (size_t i = meshlet.IndexOffset; i < meshlet.IndexOffset + meshlet.IndexCount; i++)
+            {
+                const auto& position = mesh.Vertecies[mesh.Indicies[i]].Position;
+                MX_REQUIRE(Length(position - meshlet.Bounds.Center) <= meshlet.Bounds.Radius * 1.0001f + 1e-5f);
+            }
+        }
+    }
+
+    /*!
+    checks that every non-degenerate triangle normal lies inside meshlet normal cone
+    */
+    void CheckCones(const MxVector<Meshlet>& meshlets, const TestMesh& mesh)
+    {
+        for (const auto& meshlet : meshlets)
+        {
+            if (meshlet.ConeCutoff >= 1.0f) continue;
+            MX_REQUIRE(std::abs(Length(meshlet.ConeAxis) - 1.0f) < 1e-4f);
+
+            float minDot = std::sqrt(1.0f - meshlet.ConeCutoff * meshlet.ConeCutoff);
+            for (size_t i = meshlet.IndexOffset; i < meshlet.IndexOffset + meshlet.IndexCount; i += 3)
+            {
+                const auto& p0 = mesh.Vertecies[mesh.Indicies[i + 0]].Position;
+                const auto& p1 = mesh.Vertecies[mesh.Indicies[i + 1]].Position;
+                const auto& p2 = mesh.Vertecies[mesh.Indicies[i + 2]].Position;
+                Vector3 normal = Cross(p1 - p0, p2 - p0);
+                if (Length(normal) == 0.0f) continue;
+                MX_REQUIRE(Dot(Normalize(normal), meshlet.ConeAxis) >= minDot - 1e-4f);
+            }
+        }
+    }
+}
+
+MX_TEST(Meshlet, BuildReturnsNothingForEmptyMesh)
+{
+    TestMesh mesh = GenerateGrid(4);
+    mesh.Indicies.clear();
+    MX_CHECK(MeshletBuilder::Build(mesh.Vertecies, mesh.Indicies).empty());
+}
+
+MX_TEST(Meshlet, BuildCoversSmallMeshWithOneMeshlet)
+{
+    auto mesh = GenerateGrid(5);
+    auto meshlets = MeshletBuilder::Build(mesh.Vertecies, mesh.Indicies);
+    MX_REQUIRE(meshlets.size() == 1);
+    CheckCoverage(meshlets, mesh.Indicies);
+    MX_CHECK_EQ(meshlets[0].VertexCount, 25u);
+}
+
+MX_TEST(Meshlet, BuildCoversGridWithTriangleLimit)
+{
+    // grid rows share most vertecies, so meshlets are limited by triangle count
+    auto mesh = GenerateGrid(64);
+    auto meshlets = MeshletBuilder::Build(mesh.Vertecies, mesh.Indicies);
+    CheckCoverage(meshlets, mesh.Indicies);
+    CheckBounds(meshlets, mesh);
+    CheckCones(meshlets, mesh);
+
+    size_t triangleCount = mesh.Indicies.size() / 3;
+    MX_CHECK_GE(meshlets.size(), (triangleCount + MeshletBuilder::MaxTriangles - 1) / MeshletBuilder::MaxTriangles);
+}
+
+MX_TEST(Meshlet, BuildCoversShuffledMeshWithVertexLimit)
+{
+    // random triangles share almost no vertecies, so each meshlet is cut at vertex limit
+    std::mt19937 random(1);
+    auto mesh = GenerateSphere(40, 80);
+    ShuffleTriangles(mesh.Indicies, random);
+    auto meshlets = MeshletBuilder::Build(mesh.Vertecies, mesh.Indicies);
+    CheckCoverage(meshlets, mesh.Indicies);
+    CheckBounds(meshlets, mesh);
+    CheckCones(meshlets, mesh);
+
+    size_t fullMeshlets = 0;
+    for (const auto& meshlet : meshlets)
+        fullMeshlets += meshlet.VertexCount > MeshletBuilder::MaxVertecies - 3;
+    MX_CHECK_EQ(fullMeshlets, meshlets.size() - 1);
+}
+
+MX_TEST(Meshlet, BuildCountsRepeatedVerteciesOnce)
+{
+    // degenerate triangles reference the same vertex several times, which must not exceed the limit prematurely
+    TestMesh mesh = GenerateGrid(2);
+    for (uint32_t i = 0; i < 200; i++)
+    {
+        uint32_t degenerate[3] = { i % 4, i % 4, (i + 1) % 4 };
+        mesh.Indicies.insert(mesh.Indicies.end(), std::begin(degenerate), std::end(degenerate));
+    }
+    auto meshlets = MeshletBuilder::Build(mesh.Vertecies, mesh.Indicies);
+    CheckCoverage(meshlets, mesh.Indicies);
+    for (const auto& meshlet : meshlets)
+        MX_CHECK_LE(meshlet.VertexCount, 4u);
+}
+
+MX_TEST(Meshlet, FlatMeshletHasNarrowCone)
+{
+    auto mesh = GenerateGrid(6);
+    auto meshlets = MeshletBuilder::Build(mesh.Vertecies, mesh.Indicies);
+    MX_REQUIRE(meshlets.size() == 1);
+    MX_CHECK_NEAR(meshlets[0].ConeCutoff, 0.0f, 1e-3f);
+    MX_CHECK_NEAR(meshlets[0].ConeAxis.y, 1.0f, 1e-5f);
+}
+
+MX_TEST(Meshlet, SpreadMeshletHasNoCone)
+{
+    // whole sphere fits into one meshlet, its normals point in all directions
+    auto mesh = GenerateSphere(4, 8);
+    auto meshlets = MeshletBuilder::Build(mesh.Vertecies, mesh.Indicies);
+    MX_REQUIRE(meshlets.size() == 1);
+    MX_CHECK_EQ(meshlets[0].ConeCutoff, 1.0f);
+    CheckBounds(meshlets, mesh);
+}
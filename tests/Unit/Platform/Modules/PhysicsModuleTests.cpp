@@ -0,0 +1,159 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Framework/TestFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Core/Components/Physics/BoxCollider.h"
+#include "Core/Components/Physics/RigidBody.h"
+#include "Core/MxObject/MxObject.h"
+#include "Platform/Modules/PhysicsModule.h"
+#include "Platform/PhysicsAPI.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/UUID/UUID.h"
+
+#include <btBulletDynamicsCommon.h>
+#include <array>
+#include <cstring>
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+namespace
+{
+    // objects are destroyed first, so their rigid bodies are removed from the world before physics module is destroyed
+    using PhysicsModules = ModuleScope<UUIDGenerator, ThreadPool, PhysicsModule, ComponentFactory,
+        Factory<BoxShape>, Factory<NativeRigidBody>, Factory<MxObject>>;
+
+    constexpr size_t StackCount = 36;
+    constexpr size_t StackHeight = 8;
+    constexpr float StackSpacing = 3.0f;
+    constexpr float TimeStep = 1.0f / 60.0f;
+    constexpr size_t StepCount = 120;
+
+    MxObject::Handle CreateBox(const Vector3& position, const Vector3& halfSize)
+    {
+        auto object = MxObject::Create();
+        object->LocalTransform.SetPosition(position);
+        auto collider = object->AddComponent<BoxCollider>();
+        collider->SetBoundingBox(BoundingBox(MakeVector3(0.0f), halfSize));
+        object->AddComponent<RigidBody>();
+        return object;
+    }
+
+    /*!
+    creates leaning columns of unit cubes on static ground. Each level is shifted sideways, so columns collapse and bodies keep
+    colliding with each other during the whole simulation, spreading contacts over many islands
+    */
+    void CreateLeaningStacks()
+    {
+        float extent = 6.0f * StackSpacing;
+        auto ground = CreateBox(MakeVector3(0.5f * extent, -0.5f, 0.5f * extent), MakeVector3(extent, 0.5f, extent));
+        ground->GetComponent<RigidBody>()->MakeStatic();
+
+        for (size_t stack = 0; stack < StackCount; stack++)
+        {
+            float lean = (stack % 2 == 0 ? 0.15f : -0.15f) * (1.0f + 0.1f * float(stack % 5));
+            for (size_t level = 0; level < StackHeight; level++)
+            {
+                float x = (stack % 6) * StackSpacing + lean * float(level);
+                float z = (stack / 6) * StackSpacing;
+
+                auto box = CreateBox(MakeVector3(x, 0.5f + (float)level, z), MakeVector3(0.5f));
+                auto rigidBody = box->GetComponent<RigidBody>();
+                rigidBody->MakeDynamic();
+                rigidBody->SetActivationState(ActivationState::DISABLE_DEACTIVATION);
+            }
+        }
+        RigidBody::SyncObjectStates();
+    }
+
+    // rotation rows and origin of rigid body. Padding components of bullet vectors are skipped, as they are not always initialized
+    using TransformData = std::array<btScalar, 12>;
+
+    TransformData ToTransformData(const btTransform& transform)
+    {
+        TransformData result;
+        for (int i = 0; i < 3; i++)
+        {
+            for (int j = 0; j < 3; j++)
+                result[3 * i + j] = transform.getBasis()[i][j];
+            result[9 + i] = transform.getOrigin()[i];
+        }
+        return result;
+    }
+
+    bool IsBitwiseEqual(const TransformData& t1, const TransformData& t2)
+    {
+        return std::memcmp(t1.data(), t2.data(), sizeof(TransformData)) == 0;
+    }
+
+    /*!
+    simulates scene in deterministic multithreaded world and returns world transforms of all bodies in world order
+    */
+    MxVector<TransformData> SimulateLeaningStacks(size_t threadCount)
+    {
+        PhysicsModules modules;
+        PhysicsModule::SetWorldType(PhysicsWorldType::MULTI_THREADED);
+        PhysicsModule::SetDeterministic(true);
+        PhysicsModule::SetThreadCount(threadCount);
+        CreateLeaningStacks();
+
+        for (size_t i = 0; i < StepCount; i++)
+            PhysicsModule::PerformSimulationStep(TimeStep);
+
+        const auto& objects = PhysicsModule::GetImpl()->World->getCollisionObjectArray();
+        MxVector<TransformData> transforms;
+        for (int i = 0; i < objects.size(); i++)
+            transforms.push_back(ToTransformData(objects[i]->getWorldTransform()));
+        return transforms;
+    }
+}
+
+MX_TEST(PhysicsModule, DeterministicStepDoesNotDependOnThreadCount)
+{
+    auto reference = SimulateLeaningStacks(1);
+    MX_REQUIRE(reference.size() == StackCount * StackHeight + 1);
+
+    // columns must actually collapse, otherwise resting boxes would match trivially
+    size_t fallenCount = 0;
+    for (const auto& transform : reference)
+        fallenCount += transform[4] < 0.99f ? 1 : 0; // basis[1][1] is cosine of tilt around x and z axes
+    MX_CHECK_GE(fallenCount, StackCount);
+
+    std::array threadCounts = { size_t(2), size_t(4) };
+    for (size_t threadCount : threadCounts)
+    {
+        auto transforms = SimulateLeaningStacks(threadCount);
+        MX_REQUIRE(transforms.size() == reference.size());
+
+        size_t mismatchCount = 0;
+        for (size_t i = 0; i < transforms.size(); i++)
+            mismatchCount += IsBitwiseEqual(transforms[i], reference[i]) ? 0 : 1;
+        MX_CHECK_EQ(mismatchCount, size_t(0));
+    }
+}
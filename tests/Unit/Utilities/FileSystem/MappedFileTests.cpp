@@ -0,0 +1,233 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Utilities/FileSystem/MappedFile.h"
+
+#include <vector>
+#include <random>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <limits>
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+namespace
+{
+    /*!
+    temporary directory with files for a single test, removed when test ends
+    */
+    struct MappedFileDirectory
+    {
+        FilePath Root;
+
+        explicit MappedFileDirectory(const char* name)
+        {
+            this->Root = std::filesystem::temp_directory_path() / "MxEngineTests" / name;
+            std::filesystem::remove_all(this->Root);
+            std::filesystem::create_directories(this->Root);
+        }
+
+        ~MappedFileDirectory()
+        {
+            std::error_code error;
+            std::filesystem::remove_all(this->Root, error);
+        }
+
+        FilePath WriteFile(const char* name, const std::vector<uint8_t>& bytes) const
+        {
+            auto path = this->Root / name;
+            std::ofstream file(path, std::ios::binary);
+            file.write((const char*)bytes.data(), (std::streamsize)bytes.size());
+            return path;
+        }
+    };
+
+    std::vector<uint8_t> MakeRandomBytes(size_t size, uint32_t seed)
+    {
+        std::mt19937 random(seed);
+        std::vector<uint8_t> bytes(size);
+        for (auto& byte : bytes)
+            byte = (uint8_t)random();
+        return bytes;
+    }
+
+    bool HasContents(const MappedFile& file, const std::vector<uint8_t>& bytes)
+    {
+        return file.IsOpen() && file.GetSize() == bytes.size() &&
+            (bytes.empty() || std::memcmp(file.GetData(), bytes.data(), bytes.size()) == 0);
+    }
+}
+
+MX_TEST(MappedFile, OpenReadsWholeFile)
+{
+    MappedFileDirectory directory("MappedFileOpen");
+    auto bytes = MakeRandomBytes(3 * 4096 + 17, 1); // not a multiple of page size
+    auto path = directory.WriteFile("file.bin", bytes);
+
+    MappedFile file(path);
+    MX_CHECK(HasContents(file, bytes));
+    MX_CHECK(file.GetPath() == path);
+    #if defined(MXENGINE_LINUX)
+    MX_CHECK(file.IsMapped());
+    #endif
+
+    file.Close();
+    MX_CHECK(!file.IsOpen());
+    MX_CHECK(!file.IsMapped());
+    MX_CHECK(file.GetData() == nullptr);
+    MX_CHECK_EQ(file.GetSize(), size_t(0));
+}
+
+MX_TEST(MappedFile, MissingAndEmptyFiles)
+{
+    MappedFileDirectory directory("MappedFileMissing");
+    MappedFile missing(directory.Root / "missing.bin");
+    MX_CHECK(!missing.IsOpen());
+    MX_CHECK(missing.GetBytes().empty());
+    MX_CHECK(!missing.OpenBuffered(directory.Root / "missing.bin"));
+    MX_CHECK(!missing.IsOpen());
+
+    // empty file cannot be mapped, but it is still opened successfully
+    auto emptyPath = directory.WriteFile("empty.bin", { });
+    MappedFile empty(emptyPath);
+    MX_CHECK(empty.IsOpen());
+    MX_CHECK(!empty.IsMapped());
+    MX_CHECK_EQ(empty.GetSize(), size_t(0));
+    MX_CHECK(empty.OpenBuffered(emptyPath));
+    MX_CHECK_EQ(empty.GetSize(), size_t(0));
+}
+
+MX_TEST(MappedFile, GetBytesIsBoundsChecked)
+{
+    MappedFileDirectory directory("MappedFileBounds");
+    auto bytes = MakeRandomBytes(1000, 2);
+    MappedFile file(directory.WriteFile("file.bin", bytes));
+    MX_REQUIRE(file.IsOpen());
+    constexpr size_t MaxSize = std::numeric_limits<size_t>::max();
+
+    auto whole = file.GetBytes();
+    MX_CHECK(whole.data() == file.GetData());
+    MX_CHECK_EQ(whole.size(), bytes.size());
+
+    auto middle = file.GetBytes(100, 200);
+    MX_CHECK(middle.data() == file.GetData() + 100);
+    MX_CHECK_EQ(middle.size(), size_t(200));
+    MX_CHECK(std::memcmp(middle.data(), bytes.data() + 100, 200) == 0);
+
+    auto last = file.GetBytes(999, 1);
+    MX_CHECK_EQ(last.size(), size_t(1));
+    MX_CHECK_EQ(last[0], bytes[999]);
+    MX_CHECK_EQ(file.GetBytes(0, 1000).size(), size_t(1000));
+    MX_CHECK_EQ(file.GetBytes(1000, 0).size(), size_t(0));
+
+    // ranges which end past the file are rejected as a whole, not truncated
+    MX_CHECK(file.GetBytes(0, 1001).empty());
+    MX_CHECK(file.GetBytes(999, 2).empty());
+    MX_CHECK(file.GetBytes(1000, 1).empty());
+    MX_CHECK(file.GetBytes(1001, 0).empty());
+    MX_CHECK(file.GetBytes(1001, 0).data() == nullptr);
+    // offset + byteSize overflows
+    MX_CHECK(file.GetBytes(1, MaxSize).empty());
+    MX_CHECK(file.GetBytes(MaxSize, 2).empty());
+}
+
+MX_TEST(MappedFile, BufferedFallbackMatchesMapping)
+{
+    MappedFileDirectory directory("MappedFileBuffered");
+    auto bytes = MakeRandomBytes(64 * 1024 + 5, 3);
+    auto path = directory.WriteFile("file.bin", bytes);
+
+    MappedFile buffered;
+    MX_REQUIRE(buffered.OpenBuffered(path));
+    MX_CHECK(!buffered.IsMapped());
+    MX_CHECK(HasContents(buffered, bytes));
+    MX_CHECK(buffered.GetPath() == path);
+
+    MappedFile mapped(path);
+    MX_CHECK_EQ(mapped.GetSize(), buffered.GetSize());
+    MX_CHECK(std::memcmp(mapped.GetData(), buffered.GetData(), bytes.size()) == 0);
+    MX_CHECK(buffered.GetBytes(bytes.size() - 5, 6).empty());
+    MX_CHECK(std::memcmp(buffered.GetBytes(bytes.size() - 5, 5).data(), bytes.data() + bytes.size() - 5, 5) == 0);
+
+    // reopening switches back to mapping and drops the buffer
+    MX_REQUIRE(buffered.Open(path));
+    MX_CHECK(HasContents(buffered, bytes));
+    #if defined(MXENGINE_LINUX)
+    MX_CHECK(buffered.IsMapped());
+    #endif
+}
+
+MX_TEST(MappedFile, MoveTransfersOwnership)
+{
+    MappedFileDirectory directory("MappedFileMove");
+    auto firstBytes = MakeRandomBytes(10000, 4);
+    auto secondBytes = MakeRandomBytes(20000, 5);
+    auto firstPath = directory.WriteFile("first.bin", firstBytes);
+    auto secondPath = directory.WriteFile("second.bin", secondBytes);
+
+    // buffered contents must follow moved buffer, not point into the moved-from object
+    MappedFile buffered;
+    MX_REQUIRE(buffered.OpenBuffered(firstPath));
+    MappedFile movedBuffered(std::move(buffered));
+    MX_CHECK(!buffered.IsOpen());
+    MX_CHECK(buffered.GetData() == nullptr);
+    MX_CHECK_EQ(buffered.GetSize(), size_t(0));
+    buffered.Close(); // closing moved-from object does not affect new owner
+    MX_CHECK(HasContents(movedBuffered, firstBytes));
+    MX_CHECK(!movedBuffered.IsMapped());
+    MX_CHECK(movedBuffered.GetPath() == firstPath);
+
+    MappedFile mapped(secondPath);
+    auto mappedData = mapped.GetData();
+    MappedFile movedMapped(std::move(mapped));
+    MX_CHECK(movedMapped.GetData() == mappedData);
+    MX_CHECK(!mapped.IsOpen());
+    MX_CHECK(!mapped.IsMapped());
+    MX_CHECK(HasContents(movedMapped, secondBytes));
+
+    // move assignment closes the file previously owned by destination
+    movedBuffered = std::move(movedMapped);
+    MX_CHECK(HasContents(movedBuffered, secondBytes));
+    MX_CHECK(movedBuffered.GetPath() == secondPath);
+    MX_CHECK(!movedMapped.IsOpen());
+    #if defined(MXENGINE_LINUX)
+    MX_CHECK(movedBuffered.IsMapped());
+    #endif
+
+    // moved-from object can be reused
+    MX_CHECK(movedMapped.Open(firstPath));
+    MX_CHECK(HasContents(movedMapped, firstBytes));
+    {
+        MappedFile temporary(std::move(movedMapped));
+    }
+    MX_CHECK(HasContents(movedBuffered, secondBytes));
+}
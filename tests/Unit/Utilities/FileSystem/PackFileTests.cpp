@@ -0,0 +1,258 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Utilities/FileSystem/PackFile.h"
+#include "Utilities/Threading/ThreadPool.h"
+
+#include <vector>
+#include <random>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+namespace
+{
+    /*!
+    temporary directory with loose files and pack built from them, removed when test ends
+    */
+    struct PackDirectory
+    {
+        FilePath Root;
+        FilePath PackPath;
+
+        explicit PackDirectory(const char* name)
+        {
+            this->Root = std::filesystem::temp_directory_path() / "MxEngineTests" / name;
+            std::filesystem::remove_all(this->Root);
+            std::filesystem::create_directories(this->Root);
+            this->PackPath = this->Root / ToFilePath(MxString("files") + PackFile::PackFileExtension);
+        }
+
+        ~PackDirectory()
+        {
+            std::error_code error;
+            std::filesystem::remove_all(this->Root, error);
+        }
+
+        FilePath WriteFile(const char* relativePath, const std::vector<uint8_t>& bytes) const
+        {
+            auto path = this->Root / "loose" / relativePath;
+            std::filesystem::create_directories(path.parent_path());
+            std::ofstream file(path, std::ios::binary);
+            file.write((const char*)bytes.data(), (std::streamsize)bytes.size());
+            return path;
+        }
+    };
+
+    std::vector<uint8_t> MakeRandomBytes(size_t size, uint32_t seed)
+    {
+        std::mt19937 random(seed);
+        std::vector<uint8_t> bytes(size);
+        for (auto& byte : bytes)
+            byte = (uint8_t)random();
+        return bytes;
+    }
+
+    std::vector<uint8_t> MakeCompressibleBytes(size_t size)
+    {
+        std::vector<uint8_t> bytes(size);
+        for (size_t i = 0; i < size; i++)
+            bytes[i] = (uint8_t)(i / 64 % 7);
+        return bytes;
+    }
+
+    bool HasContents(const PackFile& pack, const char* path, const std::vector<uint8_t>& expected)
+    {
+        MxString packedPath = path;
+        auto entry = pack.FindEntry(MakeStringId(packedPath), packedPath);
+        if (entry == nullptr) return false;
+
+        MxVector<uint8_t> storage;
+        auto data = pack.ReadEntry(*entry, storage);
+        return data.data() != nullptr && data.size() == expected.size() &&
+            (expected.empty() || std::memcmp(data.data(), expected.data(), expected.size()) == 0);
+    }
+}
+
+MX_TEST(PackFile, NormalizePathUsesForwardSlashesAndLexicalForm)
+{
+    MX_CHECK(PackFileWriter::NormalizePath("textures/./wood/../stone.png") == "textures/stone.png");
+    MX_CHECK(PackFileWriter::NormalizePath("shaders/") == "shaders");
+    MX_CHECK(PackFileWriter::NormalizePath("a/b/c.txt") == "a/b/c.txt");
+}
+
+MX_TEST(PackFile, WrittenEntriesReadBackExactly)
+{
+    ModuleScope<ThreadPool> modules;
+    PackDirectory directory("PackFileRoundTrip");
+    auto random = MakeRandomBytes(100000, 1);
+    auto compressible = MakeCompressibleBytes(300000);
+    auto small = MakeRandomBytes(3, 2);
+
+    PackFileWriter writer;
+    writer.AddFile("data/random.bin", directory.WriteFile("random.bin", random));
+    writer.AddFile("data/compressible.bin", directory.WriteFile("compressible.bin", compressible));
+    writer.AddFile("data/raw.bin", directory.WriteFile("raw.bin", compressible), false);
+    writer.AddFile("small.bin", directory.WriteFile("small.bin", small));
+    writer.AddFile("empty.bin", directory.WriteFile("empty.bin", { }));
+    MX_REQUIRE(writer.Write(directory.PackPath));
+
+    PackFile pack;
+    MX_REQUIRE(pack.Open(directory.PackPath));
+    MX_CHECK_EQ(pack.GetEntryCount(), (size_t)5);
+    MX_CHECK(HasContents(pack, "data/random.bin", random));
+    MX_CHECK(HasContents(pack, "data/compressible.bin", compressible));
+    MX_CHECK(HasContents(pack, "data/raw.bin", compressible));
+    MX_CHECK(HasContents(pack, "small.bin", small));
+    MX_CHECK(HasContents(pack, "empty.bin", { }));
+}
+
+MX_TEST(PackFile, OnlyCompressibleEntriesAreDeflated)
+{
+    ModuleScope<ThreadPool> modules;
+    PackDirectory directory("PackFileCompression");
+    PackFileWriter writer;
+    writer.AddFile("random.bin", directory.WriteFile("random.bin", MakeRandomBytes(65536, 3)));
+    writer.AddFile("compressible.bin", directory.WriteFile("compressible.bin", MakeCompressibleBytes(65536)));
+    writer.AddFile("uncompressed.bin", directory.WriteFile("uncompressed.bin", MakeCompressibleBytes(65536)), false);
+    MX_REQUIRE(writer.Write(directory.PackPath));
+
+    PackFile pack;
+    MX_REQUIRE(pack.Open(directory.PackPath));
+    for (const auto& entry : pack.GetEntries())
+    {
+        auto path = pack.GetEntryPath(entry);
+        auto expected = path == "compressible.bin" ? PackCompression::DEFLATE : PackCompression::NONE;
+        MX_CHECK(entry.Compression == expected);
+        if (entry.Compression == PackCompression::NONE) MX_CHECK_EQ(entry.StoredSize, entry.Size);
+        if (entry.Compression == PackCompression::DEFLATE) MX_CHECK_LE(entry.StoredSize, entry.Size / 16);
+    }
+}
+
+MX_TEST(PackFile, EntriesAreSortedAndAligned)
+{
+    ModuleScope<ThreadPool> modules;
+    PackDirectory directory("PackFileLayout");
+    PackFileWriter writer;
+    writer.SetAlignment(256);
+    for (size_t i = 0; i < 64; i++)
+    {
+        auto name = "file" + std::to_string(i) + ".bin";
+        writer.AddFile(ToFilePath(MxString(name.c_str())), directory.WriteFile(name.c_str(), MakeRandomBytes(i * 37 + 1, (uint32_t)i)));
+    }
+    MX_REQUIRE(writer.Write(directory.PackPath));
+
+    PackFile pack;
+    MX_REQUIRE(pack.Open(directory.PackPath));
+    auto entries = pack.GetEntries();
+    MX_REQUIRE(entries.size() == 64);
+    size_t unsorted = 0, misaligned = 0, missing = 0;
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        unsorted += i > 0 && !(entries[i - 1].Id < entries[i].Id);
+        misaligned += entries[i].Offset % 256 != 0;
+        missing += pack.FindEntry(entries[i].Id, pack.GetEntryPath(entries[i])) != &entries[i];
+    }
+    MX_CHECK_EQ(unsorted, (size_t)0);
+    MX_CHECK_EQ(misaligned, (size_t)0);
+    MX_CHECK_EQ(missing, (size_t)0);
+}
+
+MX_TEST(PackFile, FindEntryRejectsUnknownPaths)
+{
+    ModuleScope<ThreadPool> modules;
+    PackDirectory directory("PackFileLookup");
+    PackFileWriter writer;
+    writer.AddFile("textures/albedo.png", directory.WriteFile("albedo.png", MakeRandomBytes(16, 4)));
+    MX_REQUIRE(writer.Write(directory.PackPath));
+
+    PackFile pack;
+    MX_REQUIRE(pack.Open(directory.PackPath));
+    MxString missing = "textures/normal.png";
+    MX_CHECK(pack.FindEntry(MakeStringId(missing), missing) == nullptr);
+    // entry with the same hash but different path must not be returned
+    MxString existing = "textures/albedo.png";
+    MX_CHECK(pack.FindEntry(MakeStringId(existing), missing) == nullptr);
+    MX_CHECK(pack.FindEntry(MakeStringId(existing), existing) != nullptr);
+}
+
+MX_TEST(PackFile, OpenRejectsInvalidFiles)
+{
+    ModuleScope<ThreadPool> modules;
+    PackDirectory directory("PackFileInvalid");
+    PackFileWriter writer;
+    writer.AddFile("file.bin", directory.WriteFile("file.bin", MakeRandomBytes(4096, 5)));
+    MX_REQUIRE(writer.Write(directory.PackPath));
+
+    PackFile pack;
+    MX_CHECK(!pack.Open(directory.Root / "missing.mxpack"));
+    MX_CHECK(!pack.Open(directory.WriteFile("notapack.mxpack", MakeRandomBytes(256, 6))));
+
+    // truncated pack loses its table of contents
+    auto truncatedPath = directory.Root / "truncated.mxpack";
+    std::filesystem::copy_file(directory.PackPath, truncatedPath);
+    std::filesystem::resize_file(truncatedPath, std::filesystem::file_size(truncatedPath) / 2);
+    MX_CHECK(!pack.Open(truncatedPath));
+    MX_CHECK(!pack.IsOpen());
+    MX_CHECK_EQ(pack.GetEntryCount(), (size_t)0);
+}
+
+MX_TEST(PackFile, WriterRejectsMissingSourceFiles)
+{
+    ModuleScope<ThreadPool> modules;
+    PackDirectory directory("PackFileMissingSource");
+    PackFileWriter writer;
+    writer.AddFile("missing.bin", directory.Root / "missing.bin");
+    MX_CHECK(!writer.Write(directory.PackPath));
+}
+
+MX_TEST(PackFile, AddDirectoryUsesPathsRelativeToRoot)
+{
+    ModuleScope<ThreadPool> modules;
+    PackDirectory directory("PackFileDirectory");
+    auto first = MakeRandomBytes(100, 7);
+    auto second = MakeCompressibleBytes(10000);
+    directory.WriteFile("models/cube.obj", first);
+    directory.WriteFile("models/materials/cube.json", second);
+
+    PackFileWriter writer;
+    writer.AddDirectory(directory.Root / "loose" / "models", directory.Root / "loose");
+    MX_CHECK_EQ(writer.GetFileCount(), (size_t)2);
+    MX_REQUIRE(writer.Write(directory.PackPath));
+
+    PackFile pack;
+    MX_REQUIRE(pack.Open(directory.PackPath));
+    MX_CHECK(HasContents(pack, "models/cube.obj", first));
+    MX_CHECK(HasContents(pack, "models/materials/cube.json", second));
+}
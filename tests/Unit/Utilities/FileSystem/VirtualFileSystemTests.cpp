@@ -0,0 +1,180 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Utilities/FileSystem/VirtualFileSystem.h"
+#include "Utilities/FileSystem/MappedFile.h"
+#include "Utilities/Threading/ThreadPool.h"
+
+#include <fstream>
+#include <filesystem>
+#include <string>
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+namespace
+{
+    using PackModules = ModuleScope<ThreadPool, VirtualFileSystem>;
+
+    /*!
+    project files which are referenced by absolute paths, as engine does. Packs store them under paths relative to working directory
+    */
+    struct ProjectFiles
+    {
+        FilePath Root;
+
+        explicit ProjectFiles(const char* name)
+        {
+            this->Root = std::filesystem::temp_directory_path() / "MxEngineTests" / name;
+            std::filesystem::remove_all(this->Root);
+            std::filesystem::create_directories(this->Root / "sources");
+        }
+
+        ~ProjectFiles()
+        {
+            std::error_code error;
+            std::filesystem::remove_all(this->Root, error);
+        }
+
+        FilePath GetPath(const char* name) const
+        {
+            return this->Root / "project" / name;
+        }
+
+        void WriteLoose(const char* name, const std::string& contents) const
+        {
+            auto path = this->GetPath(name);
+            std::filesystem::create_directories(path.parent_path());
+            std::ofstream(path, std::ios::binary) << contents;
+        }
+
+        /*!
+        builds pack in which project file has given contents, without creating it on disk
+        */
+        FilePath BuildPack(const char* packName, const char* name, const std::string& contents) const
+        {
+            auto sourcePath = this->Root / "sources" / (std::string(packName) + "." + name);
+            std::ofstream(sourcePath, std::ios::binary) << contents;
+
+            PackFileWriter writer;
+            writer.AddFile(ToFilePath(VirtualFileSystem::GetPackedPath(this->GetPath(name))), sourcePath);
+            auto packPath = this->Root / (std::string(packName) + PackFile::PackFileExtension);
+            writer.Write(packPath);
+            return packPath;
+        }
+    };
+
+    std::string ReadMapped(const FilePath& path)
+    {
+        MappedFile file(path);
+        if (!file.IsOpen()) return "<not found>";
+        return std::string((const char*)file.GetData(), file.GetSize());
+    }
+
+    std::string ReadText(const FilePath& path)
+    {
+        auto text = File::ReadAllText(path);
+        return std::string(text.data(), text.size());
+    }
+}
+
+MX_TEST(VirtualFileSystem, PackedFilesAreReadWithoutLooseCopies)
+{
+    PackModules modules;
+    ProjectFiles files("VirtualFileSystemPacked");
+    auto compressible = std::string(10000, 'a');
+    MX_REQUIRE(VirtualFileSystem::Mount(files.BuildPack("first", "shader.glsl", compressible)));
+    MX_CHECK(VirtualFileSystem::HasMountedPacks());
+
+    auto path = files.GetPath("shader.glsl");
+    MX_CHECK(!File::Exists(path));
+    MX_CHECK(VirtualFileSystem::IsPacked(path));
+    MX_CHECK(VirtualFileSystem::Exists(path));
+    MX_CHECK(VirtualFileSystem::IsFile(path));
+    MX_CHECK(ReadMapped(path) == compressible);
+    MX_CHECK(ReadText(path) == compressible);
+
+    auto missing = files.GetPath("missing.glsl");
+    MX_CHECK(!VirtualFileSystem::Exists(missing));
+    MX_CHECK(!VirtualFileSystem::IsFile(missing));
+    MX_CHECK(ReadMapped(missing) == "<not found>");
+}
+
+MX_TEST(VirtualFileSystem, LooseFilesOverridePacksOnlyIfPreferred)
+{
+    PackModules modules;
+    ProjectFiles files("VirtualFileSystemOverride");
+    MX_REQUIRE(VirtualFileSystem::Mount(files.BuildPack("pack", "config.json", "packed")));
+    files.WriteLoose("config.json", "loose");
+    auto path = files.GetPath("config.json");
+
+    VirtualFileSystem::SetPreferLooseFiles(true);
+    MX_CHECK(!VirtualFileSystem::IsPacked(path));
+    MX_CHECK(ReadMapped(path) == "loose");
+    MX_CHECK(ReadText(path) == "loose");
+
+    VirtualFileSystem::SetPreferLooseFiles(false);
+    MX_CHECK(VirtualFileSystem::IsPacked(path));
+    MX_CHECK(ReadMapped(path) == "packed");
+    MX_CHECK(ReadText(path) == "packed");
+}
+
+MX_TEST(VirtualFileSystem, LaterMountedPacksOverrideEarlierOnes)
+{
+    PackModules modules;
+    ProjectFiles files("VirtualFileSystemPriority");
+    MX_REQUIRE(VirtualFileSystem::Mount(files.BuildPack("base", "level.json", "base")));
+    MX_REQUIRE(VirtualFileSystem::Mount(files.BuildPack("patch", "level.json", "patch")));
+    MX_CHECK_EQ(VirtualFileSystem::GetMountedPacks().size(), (size_t)2);
+    MX_CHECK(ReadMapped(files.GetPath("level.json")) == "patch");
+
+    VirtualFileSystem::UnmountAll();
+    MX_CHECK(!VirtualFileSystem::HasMountedPacks());
+    MX_CHECK(!VirtualFileSystem::Exists(files.GetPath("level.json")));
+}
+
+MX_TEST(VirtualFileSystem, MountFailsForInvalidPacks)
+{
+    PackModules modules;
+    ProjectFiles files("VirtualFileSystemInvalid");
+    files.WriteLoose("broken.mxpack", "not a pack file");
+    MX_CHECK(!VirtualFileSystem::Mount(files.GetPath("missing.mxpack")));
+    MX_CHECK(!VirtualFileSystem::Mount(files.GetPath("broken.mxpack")));
+    MX_CHECK(!VirtualFileSystem::HasMountedPacks());
+}
+
+MX_TEST(VirtualFileSystem, DirectoriesAreNotFiles)
+{
+    PackModules modules;
+    ProjectFiles files("VirtualFileSystemDirectories");
+    MX_CHECK(VirtualFileSystem::Exists(files.Root));
+    MX_CHECK(!VirtualFileSystem::IsFile(files.Root));
+}
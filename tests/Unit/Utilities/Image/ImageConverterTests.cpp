@@ -0,0 +1,469 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Utilities/Image/ImageConverter.h"
+#include "Utilities/Image/ImageLoader.h"
+#include "Utilities/Image/Image.h"
+
+#include <vector>
+#include <random>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <limits>
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+namespace
+{
+    std::vector<uint8_t> GenerateBytes(size_t count, uint32_t seed)
+    {
+        std::mt19937 random(seed);
+        std::vector<uint8_t> bytes(count);
+        for (auto& byte : bytes)
+            byte = (uint8_t)random();
+        return bytes;
+    }
+
+    std::vector<float> GenerateFloats(size_t count, uint32_t seed)
+    {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+        std::vector<float> floats(count);
+        for (auto& value : floats)
+            value = distribution(random);
+        return floats;
+    }
+
+    bool IsHalfNaN(uint16_t value)
+    {
+        return (value & 0x7C00) == 0x7C00 && (value & 0x03FF) != 0;
+    }
+
+    uint32_t GetFloatBits(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    // covers every finite half value, both infinities, NaNs, ties and values outside of half range
+    std::vector<float> GenerateHalfConversionInputs()
+    {
+        std::vector<float> inputs;
+        for (uint32_t half = 0; half <= 0xFFFF; half++)
+        {
+            inputs.push_back(ImageConverter::HalfToFloat((uint16_t)half));
+            if ((half & 0x7C00) != 0x7C00 && (half & 0x7FFF) != 0x7BFF)
+            {
+                // exact midpoint between two adjacent halfs must be rounded to the even one
+                float next = ImageConverter::HalfToFloat(uint16_t(half + 1));
+                inputs.push_back(0.5f * (inputs.back() + next));
+            }
+        }
+
+        std::mt19937 random(17);
+        std::uniform_int_distribution<uint32_t> bits;
+        for (size_t i = 0; i < 100000; i++)
+        {
+            uint32_t value = bits(random);
+            float input;
+            std::memcpy(&input, &value, sizeof(input));
+            inputs.push_back(input);
+        }
+        for (float value : { 65504.0f, 65519.0f, 65520.0f, 1e10f, 1e-10f, 5.96e-8f, 2.98e-8f, 2.99e-8f })
+        {
+            inputs.push_back(value);
+            inputs.push_back(-value);
+        }
+        return inputs;
+    }
+
+    std::vector<float> GenerateRadiance(size_t pixelCount, size_t channelCount, uint32_t seed)
+    {
+        // HDR environment maps span several orders of magnitude, so components are log-distributed
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> exponent(-8.0f, 14.0f);
+        std::vector<float> radiance(pixelCount * channelCount);
+        for (auto& value : radiance)
+            value = std::exp2(exponent(random));
+        return radiance;
+    }
+
+    ImageData MakeByteImage(size_t width, size_t height, size_t channels, uint32_t seed)
+    {
+        auto bytes = GenerateBytes(width * height * channels, seed);
+        auto data = (uint8_t*)std::malloc(bytes.size());
+        std::copy(bytes.begin(), bytes.end(), data);
+        return ImageData(data, width, height, channels, false);
+    }
+}
+
+MX_TEST(ImageConverter, ExtractChannelBytesMatchesScalar)
+{
+    // pixel counts around SIMD block size check both vectorized body and scalar tail
+    for (size_t channelCount = 1; channelCount <= 4; channelCount++)
+    {
+        for (size_t pixelCount : { 0, 1, 15, 16, 17, 31, 33, 64, 1000 })
+        {
+            auto source = GenerateBytes(pixelCount * channelCount, uint32_t(pixelCount * 7 + channelCount));
+            for (size_t channel = 0; channel < channelCount; channel++)
+            {
+                std::vector<uint8_t> destination(pixelCount + 1, 0xCD);
+                ImageConverter::ExtractChannel(source.data(), destination.data(), pixelCount, channelCount, channel);
+
+                size_t mismatches = 0;
+                for (size_t i = 0; i < pixelCount; i++)
+                    mismatches += destination[i] != source[i * channelCount + channel];
+                MX_CHECK_EQ(mismatches, (size_t)0);
+                MX_CHECK_EQ(destination[pixelCount], (uint8_t)0xCD);
+            }
+        }
+    }
+}
+
+MX_TEST(ImageConverter, ExtractChannelFloatsMatchesScalar)
+{
+    for (size_t channelCount = 1; channelCount <= 4; channelCount++)
+    {
+        for (size_t pixelCount : { 0, 1, 3, 4, 5, 7, 8, 9, 250 })
+        {
+            auto source = GenerateFloats(pixelCount * channelCount, uint32_t(pixelCount * 11 + channelCount));
+            for (size_t channel = 0; channel < channelCount; channel++)
+            {
+                std::vector<float> destination(pixelCount + 1, -1.0f);
+                ImageConverter::ExtractChannel(source.data(), destination.data(), pixelCount, channelCount, channel);
+
+                size_t mismatches = 0;
+                for (size_t i = 0; i < pixelCount; i++)
+                    mismatches += destination[i] != source[i * channelCount + channel];
+                MX_CHECK_EQ(mismatches, (size_t)0);
+                MX_CHECK_EQ(destination[pixelCount], -1.0f);
+            }
+        }
+    }
+}
+
+MX_TEST(ImageConverter, SwizzleChannelsMatchesScalar)
+{
+    const std::array<uint8_t, 4> orders[] = {
+        { 0, 1, 2, 3 }, { 2, 1, 0, 3 }, { 3, 2, 1, 0 }, { 1, 1, 1, 1 }, { 0, 0, 3, 2 },
+    };
+    for (const auto& order : orders)
+    {
+        for (size_t pixelCount : { 1, 3, 4, 5, 17, 100 })
+        {
+            auto source = GenerateBytes(pixelCount * 4, uint32_t(pixelCount));
+            std::vector<uint8_t> destination(pixelCount * 4);
+            ImageConverter::SwizzleChannels(source.data(), destination.data(), pixelCount, order);
+
+            size_t mismatches = 0;
+            for (size_t i = 0; i < pixelCount; i++)
+            {
+                for (size_t c = 0; c < 4; c++)
+                    mismatches += destination[i * 4 + c] != source[i * 4 + order[c]];
+            }
+            MX_CHECK_EQ(mismatches, (size_t)0);
+        }
+    }
+}
+
+MX_TEST(ImageConverter, ExtractChannelSplitsMetallicRoughnessImage)
+{
+    // metallic-roughness textures store roughness in G channel and metallic in B channel
+    auto image = MakeByteImage(37, 19, 4, 5);
+    auto roughness = ImageConverter::ExtractChannel(image, 1);
+    auto metallic = ImageConverter::ExtractChannel(image, 2);
+
+    MX_REQUIRE(roughness.GetRawData() != nullptr && metallic.GetRawData() != nullptr);
+    MX_CHECK_EQ(roughness.GetWidth(), image.GetWidth());
+    MX_CHECK_EQ(roughness.GetHeight(), image.GetHeight());
+    MX_CHECK_EQ(roughness.GetChannelCount(), (size_t)1);
+    MX_CHECK_EQ(metallic.GetChannelCount(), (size_t)1);
+
+    size_t mismatches = 0;
+    for (size_t y = 0; y < image.GetHeight(); y++)
+    {
+        for (size_t x = 0; x < image.GetWidth(); x++)
+        {
+            auto pixel = image.GetPixelByte(x, y);
+            mismatches += roughness.GetPixelByte(x, y)[0] != pixel[1];
+            mismatches += metallic.GetPixelByte(x, y)[0] != pixel[2];
+        }
+    }
+    MX_CHECK_EQ(mismatches, (size_t)0);
+}
+
+MX_TEST(ImageConverter, ExtractChannelRejectsMissingChannel)
+{
+    auto image = MakeByteImage(4, 4, 2, 1);
+    auto result = ImageConverter::ExtractChannel(image, 2);
+    MX_CHECK(result.GetRawData() == nullptr);
+}
+
+MX_TEST(ImageConverter, HalfRoundTripIsExactForEveryHalf)
+{
+    size_t mismatches = 0;
+    for (uint32_t half = 0; half <= 0xFFFF; half++)
+    {
+        uint16_t result = ImageConverter::FloatToHalf(ImageConverter::HalfToFloat((uint16_t)half));
+        if (IsHalfNaN((uint16_t)half))
+            mismatches += !IsHalfNaN(result) || (result & 0x8000) != (half & 0x8000);
+        else
+            mismatches += result != half;
+    }
+    MX_CHECK_EQ(mismatches, (size_t)0);
+}
+
+MX_TEST(ImageConverter, HalfToFloatDecodesSpecialValues)
+{
+    MX_CHECK_EQ(GetFloatBits(ImageConverter::HalfToFloat(0x0000)), GetFloatBits(0.0f));
+    MX_CHECK_EQ(GetFloatBits(ImageConverter::HalfToFloat(0x8000)), GetFloatBits(-0.0f));
+    MX_CHECK_EQ(ImageConverter::HalfToFloat(0x3C00), 1.0f);
+    MX_CHECK_EQ(ImageConverter::HalfToFloat(0xC000), -2.0f);
+    MX_CHECK_EQ(ImageConverter::HalfToFloat(0x7BFF), 65504.0f);
+    MX_CHECK_EQ(ImageConverter::HalfToFloat(0x0400), std::ldexp(1.0f, -14));
+    MX_CHECK_EQ(ImageConverter::HalfToFloat(0x0001), std::ldexp(1.0f, -24));
+    MX_CHECK_EQ(ImageConverter::HalfToFloat(0x03FF), std::ldexp(1023.0f, -24));
+    MX_CHECK_EQ(ImageConverter::HalfToFloat(0x7C00), std::numeric_limits<float>::infinity());
+    MX_CHECK_EQ(ImageConverter::HalfToFloat(0xFC00), -std::numeric_limits<float>::infinity());
+    MX_CHECK(std::isnan(ImageConverter::HalfToFloat(0x7E00)));
+    MX_CHECK(std::isnan(ImageConverter::HalfToFloat(0x7C01)));
+}
+
+MX_TEST(ImageConverter, FloatToHalfRoundsAndSaturates)
+{
+    MX_CHECK_EQ(ImageConverter::FloatToHalf(0.0f), (uint16_t)0x0000);
+    MX_CHECK_EQ(ImageConverter::FloatToHalf(-0.0f), (uint16_t)0x8000);
+    MX_CHECK_EQ(ImageConverter::FloatToHalf(65504.0f), (uint16_t)0x7BFF);
+    MX_CHECK_EQ(ImageConverter::FloatToHalf(65519.0f), (uint16_t)0x7BFF);
+    MX_CHECK_EQ(ImageConverter::FloatToHalf(65520.0f), (uint16_t)0x7C00);
+    MX_CHECK_EQ(ImageConverter::FloatToHalf(-1e10f), (uint16_t)0xFC00);
+    MX_CHECK_EQ(ImageConverter::FloatToHalf(std::numeric_limits<float>::infinity()), (uint16_t)0x7C00);
+    MX_CHECK(IsHalfNaN(ImageConverter::FloatToHalf(std::numeric_limits<float>::quiet_NaN())));
+    // smallest subnormal is 2^-24, half of it is a tie which rounds to even zero
+    MX_CHECK_EQ(ImageConverter::FloatToHalf(std::ldexp(1.0f, -24)), (uint16_t)0x0001);
+    MX_CHECK_EQ(ImageConverter::FloatToHalf(std::ldexp(1.0f, -25)), (uint16_t)0x0000);
+    MX_CHECK_EQ(ImageConverter::FloatToHalf(std::ldexp(1.5f, -25)), (uint16_t)0x0001);
+    MX_CHECK_EQ(ImageConverter::FloatToHalf(std::ldexp(1.0f, -30)), (uint16_t)0x0000);
+    // 1 + 2^-11 lies exactly between 1 and next half, 1 + 3 * 2^-11 lies between two odd and even halfs
+    MX_CHECK_EQ(ImageConverter::FloatToHalf(1.0f + std::ldexp(1.0f, -11)), (uint16_t)0x3C00);
+    MX_CHECK_EQ(ImageConverter::FloatToHalf(1.0f + std::ldexp(3.0f, -11)), (uint16_t)0x3C02);
+}
+
+MX_TEST(ImageConverter, FloatToHalfRelativeErrorIsBounded)
+{
+    std::mt19937 random(3);
+    std::uniform_real_distribution<float> exponent(-14.0f, 15.9f);
+    float maxError = 0.0f;
+    for (size_t i = 0; i < 200000; i++)
+    {
+        float value = std::exp2(exponent(random));
+        float result = ImageConverter::HalfToFloat(ImageConverter::FloatToHalf(value));
+        maxError = std::max(maxError, std::abs(result - value) / value);
+    }
+    // 10 explicit mantissa bits with round-to-nearest give at most half ulp of error
+    MX_CHECK_LE(maxError, std::ldexp(1.0f, -11));
+}
+
+MX_TEST(ImageConverter, ConvertFloatToHalfMatchesScalar)
+{
+    auto inputs = GenerateHalfConversionInputs();
+    // counts around SIMD block sizes check both vectorized body and scalar tail
+    for (size_t count : { 1, 3, 4, 5, 7, 8, 9, 15, 16, 17 })
+    {
+        std::vector<uint16_t> destination(count + 1, 0xCDCD);
+        ImageConverter::ConvertFloatToHalf(inputs.data() + 100, destination.data(), count);
+        size_t mismatches = 0;
+        for (size_t i = 0; i < count; i++)
+            mismatches += destination[i] != ImageConverter::FloatToHalf(inputs[100 + i]);
+        MX_CHECK_EQ(mismatches, (size_t)0);
+        MX_CHECK_EQ(destination[count], (uint16_t)0xCDCD);
+    }
+
+    std::vector<uint16_t> destination(inputs.size());
+    ImageConverter::ConvertFloatToHalf(inputs.data(), destination.data(), inputs.size());
+    size_t mismatches = 0;
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        uint16_t expected = ImageConverter::FloatToHalf(inputs[i]);
+        // hardware conversion may keep NaN payload, so only NaN class and sign are compared
+        if (IsHalfNaN(expected))
+            mismatches += !IsHalfNaN(destination[i]) || (destination[i] & 0x8000) != (expected & 0x8000);
+        else
+            mismatches += destination[i] != expected;
+    }
+    MX_CHECK_EQ(mismatches, (size_t)0);
+}
+
+MX_TEST(ImageConverter, ConvertHalfToFloatMatchesScalar)
+{
+    std::vector<uint16_t> source(0x10000);
+    for (size_t i = 0; i < source.size(); i++)
+        source[i] = (uint16_t)i;
+
+    std::vector<float> destination(source.size() + 1, -1.0f);
+    ImageConverter::ConvertHalfToFloat(source.data(), destination.data(), source.size() - 3);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < source.size() - 3; i++)
+    {
+        float expected = ImageConverter::HalfToFloat(source[i]);
+        if (std::isnan(expected))
+            mismatches += !std::isnan(destination[i]);
+        else
+            mismatches += GetFloatBits(destination[i]) != GetFloatBits(expected);
+    }
+    MX_CHECK_EQ(mismatches, (size_t)0);
+    MX_CHECK_EQ(destination[source.size() - 3], -1.0f);
+}
+
+MX_TEST(ImageConverter, RGBERoundTripPreservesSharedExponentPrecision)
+{
+    for (size_t channelCount : { 3, 4 })
+    {
+        const size_t pixelCount = 10000;
+        auto source = GenerateRadiance(pixelCount, channelCount, uint32_t(channelCount));
+        std::vector<uint8_t> rgbe(pixelCount * 4);
+        std::vector<float> result(pixelCount * channelCount);
+        ImageConverter::ConvertFloatToRGBE(source.data(), rgbe.data(), pixelCount, channelCount);
+        ImageConverter::ConvertRGBEToFloat(rgbe.data(), result.data(), pixelCount, channelCount);
+
+        float maxError = 0.0f;
+        size_t alphaMismatches = 0;
+        for (size_t i = 0; i < pixelCount; i++)
+        {
+            const float* expected = source.data() + i * channelCount;
+            const float* actual = result.data() + i * channelCount;
+            // 8-bit mantissa of the largest component bounds error of every component sharing its exponent
+            float maxComponent = std::max(expected[0], std::max(expected[1], expected[2]));
+            for (size_t c = 0; c < 3; c++)
+                maxError = std::max(maxError, std::abs(actual[c] - expected[c]) / maxComponent);
+            if (channelCount == 4) alphaMismatches += actual[3] != 1.0f;
+        }
+        MX_CHECK_LE(maxError, 1.0f / 128.0f);
+        MX_CHECK_EQ(alphaMismatches, (size_t)0);
+    }
+}
+
+MX_TEST(ImageConverter, RGBEEncodesBlackAndNegativeAsZero)
+{
+    const float source[] = { 0.0f, 0.0f, 0.0f, -1.0f, -2.0f, -3.0f, 4.0f, -1.0f, 0.0f };
+    uint8_t rgbe[3 * 4];
+    float result[3 * 3];
+    ImageConverter::ConvertFloatToRGBE(source, rgbe, 3, 3);
+    ImageConverter::ConvertRGBEToFloat(rgbe, result, 3, 3);
+
+    for (size_t i = 0; i < 6; i++)
+        MX_CHECK_EQ(result[i], 0.0f);
+    MX_CHECK_EQ(result[6], 4.0f);
+    MX_CHECK_EQ(result[7], 0.0f);
+    MX_CHECK_EQ(result[8], 0.0f);
+}
+
+MX_TEST(ImageConverter, ImageHalfFloatRoundTrip)
+{
+    const size_t width = 33, height = 17, channels = 4;
+    auto radiance = GenerateRadiance(width * height * channels, 1, 9);
+    auto data = (uint8_t*)std::malloc(radiance.size() * sizeof(float));
+    std::memcpy(data, radiance.data(), radiance.size() * sizeof(float));
+    ImageData image(data, width, height, channels, ImageFormat::FLOAT);
+
+    auto half = ImageConverter::ConvertToHalfFloat(image);
+    MX_REQUIRE(half.GetRawData() != nullptr);
+    MX_CHECK(half.IsHalfFloat());
+    MX_CHECK_EQ(half.GetTotalByteSize(), image.GetTotalByteSize() / 2);
+
+    auto restored = ImageConverter::ConvertToFloat(half);
+    MX_REQUIRE(restored.GetRawData() != nullptr);
+    MX_CHECK(restored.IsFloatingPoint());
+    MX_CHECK_EQ(restored.GetWidth(), width);
+    MX_CHECK_EQ(restored.GetHeight(), height);
+
+    size_t mismatches = 0;
+    auto restoredData = (const float*)restored.GetRawData();
+    for (size_t i = 0; i < radiance.size(); i++)
+        mismatches += restoredData[i] != ImageConverter::HalfToFloat(ImageConverter::FloatToHalf(radiance[i]));
+    MX_CHECK_EQ(mismatches, (size_t)0);
+
+    // conversions only accept images of matching source format
+    MX_CHECK(ImageConverter::ConvertToHalfFloat(half).GetRawData() == nullptr);
+    MX_CHECK(ImageConverter::ConvertToFloat(image).GetRawData() == nullptr);
+    MX_CHECK(ImageConverter::ConvertToHalfFloat(MakeByteImage(4, 4, 4, 1)).GetRawData() == nullptr);
+}
+
+MX_TEST(ImageConverter, RawImageRoundTripIsExact)
+{
+    const size_t width = 16, height = 9, channels = 3;
+    auto radiance = GenerateRadiance(width * height * channels, 1, 21);
+    auto data = (uint8_t*)std::malloc(radiance.size() * sizeof(float));
+    std::memcpy(data, radiance.data(), radiance.size() * sizeof(float));
+    auto half = ImageConverter::ConvertToHalfFloat(ImageData(data, width, height, channels, ImageFormat::FLOAT));
+
+    auto raw = ImageConverter::ConvertImageRAW(half);
+    auto loaded = ImageLoader::LoadImageFromMemory(raw.data(), raw.size(), true);
+    MX_REQUIRE(loaded.GetRawData() != nullptr);
+    MX_CHECK(loaded.IsHalfFloat());
+    MX_CHECK_EQ(loaded.GetWidth(), width);
+    MX_CHECK_EQ(loaded.GetHeight(), height);
+    MX_CHECK_EQ(loaded.GetChannelCount(), channels);
+    MX_CHECK(std::memcmp(loaded.GetRawData(), half.GetRawData(), half.GetTotalByteSize()) == 0);
+}
+
+MX_TEST(ImageConverter, HDRImageRoundTripPreservesRadiance)
+{
+    const size_t width = 64, height = 32, channels = 4;
+    auto radiance = GenerateRadiance(width * height * channels, 1, 33);
+    auto data = (uint8_t*)std::malloc(radiance.size() * sizeof(float));
+    std::memcpy(data, radiance.data(), radiance.size() * sizeof(float));
+    ImageData image(data, width, height, channels, ImageFormat::FLOAT);
+
+    auto hdr = ImageConverter::ConvertImageHDR(image);
+    MX_REQUIRE(!hdr.empty());
+    auto loaded = ImageLoader::LoadImageFromMemory(hdr.data(), hdr.size(), true);
+    MX_REQUIRE(loaded.GetRawData() != nullptr);
+    MX_CHECK(loaded.IsFloatingPoint());
+    MX_CHECK_EQ(loaded.GetWidth(), width);
+    MX_CHECK_EQ(loaded.GetHeight(), height);
+    MX_REQUIRE(loaded.GetChannelCount() == channels);
+
+    // .hdr files store RGBE pixels, so precision is bounded by the largest component of each pixel
+    float maxError = 0.0f;
+    auto loadedData = (const float*)loaded.GetRawData();
+    for (size_t i = 0; i < width * height; i++)
+    {
+        const float* expected = radiance.data() + i * channels;
+        const float* actual = loadedData + i * channels;
+        float maxComponent = std::max(expected[0], std::max(expected[1], expected[2]));
+        for (size_t c = 0; c < 3; c++)
+            maxError = std::max(maxError, std::abs(actual[c] - expected[c]) / maxComponent);
+    }
+    MX_CHECK_LE(maxError, 1.0f / 128.0f);
+}
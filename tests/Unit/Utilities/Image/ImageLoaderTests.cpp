@@ -0,0 +1,335 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Utilities/Image/ImageLoader.h"
+#include "Utilities/Image/ImageConverter.h"
+#include "Utilities/Image/ImageManager.h"
+#include "Utilities/FileSystem/File.h"
+#include "Utilities/Threading/ThreadPool.h"
+
+#include <vector>
+#include <random>
+#include <filesystem>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+namespace
+{
+    // position of each face in the cross in face-sized cells, in the order CreateCubemap returns faces
+    constexpr size_t CrossCells[6][2] = { { 2, 1 }, { 0, 1 }, { 1, 0 }, { 1, 2 }, { 1, 1 }, { 3, 1 } };
+
+    template<typename T>
+    ImageData MakeImage(size_t width, size_t height, size_t channels, uint32_t seed)
+    {
+        std::mt19937 random(seed);
+        size_t elementCount = width * height * channels;
+        auto data = (T*)std::malloc(elementCount * sizeof(T));
+        for (size_t i = 0; i < elementCount; i++)
+        {
+            if constexpr (std::is_same_v<T, float>)
+                data[i] = float(random() % 100000) * 0.01f;
+            else
+                data[i] = (T)random();
+        }
+        auto format = std::is_same_v<T, float> ? ImageFormat::FLOAT : ImageFormat::BYTE;
+        return ImageData((uint8_t*)data, width, height, channels, format);
+    }
+
+    bool IsSameImage(const ImageData& expected, const ImageData& actual)
+    {
+        return expected.GetWidth() == actual.GetWidth() && expected.GetHeight() == actual.GetHeight() &&
+            expected.GetChannelCount() == actual.GetChannelCount() && expected.GetFormat() == actual.GetFormat() &&
+            std::memcmp(expected.GetRawData(), actual.GetRawData(), expected.GetTotalByteSize()) == 0;
+    }
+
+    /*!
+    copies face of the cross pixel by pixel, as cubemap slicing was done before row spans were introduced
+    */
+    size_t CountCrossFaceMismatches(const ImageData& image, const Array2D<unsigned char>& face, size_t faceIndex, size_t faceSize)
+    {
+        size_t pixelSize = image.GetPixelSize();
+        size_t originX = CrossCells[faceIndex][0] * faceSize;
+        size_t originY = CrossCells[faceIndex][1] * faceSize;
+        size_t mismatches = 0;
+        for (size_t y = 0; y < faceSize; y++)
+        {
+            for (size_t x = 0; x < faceSize; x++)
+            {
+                const uint8_t* expected = image.GetRawData() + ((originY + y) * image.GetWidth() + originX + x) * pixelSize;
+                const uint8_t* actual = face.data() + y * faceSize * pixelSize + x * pixelSize;
+                mismatches += std::memcmp(expected, actual, pixelSize) != 0;
+            }
+        }
+        return mismatches;
+    }
+
+    /*!
+    generates panorama where every texel stores color of cubemap face its direction belongs to
+    */
+    template<typename T>
+    ImageData MakeFaceColoredPanorama(size_t width, size_t channels)
+    {
+        constexpr float Pi = 3.14159265358979f;
+        size_t height = width / 2;
+        auto data = (T*)std::malloc(width * height * channels * sizeof(T));
+        for (size_t y = 0; y < height; y++)
+        {
+            float latitude = (0.5f - ((float)y + 0.5f) / (float)height) * Pi;
+            for (size_t x = 0; x < width; x++)
+            {
+                float longitude = (((float)x + 0.5f) / (float)width - 0.5f) * 2.0f * Pi;
+                float direction[3] = { std::cos(latitude) * std::cos(longitude), std::sin(latitude), std::cos(latitude) * std::sin(longitude) };
+
+                size_t axis = 0;
+                for (size_t i = 1; i < 3; i++)
+                    if (std::abs(direction[i]) > std::abs(direction[axis])) axis = i;
+                size_t face = axis * 2 + (direction[axis] < 0.0f ? 1 : 0);
+
+                for (size_t c = 0; c < channels; c++)
+                    data[(y * width + x) * channels + c] = T(face * 40 + c * 7 + 1);
+            }
+        }
+        auto format = std::is_same_v<T, float> ? ImageFormat::FLOAT : ImageFormat::BYTE;
+        return ImageData((uint8_t*)data, width, height, channels, format);
+    }
+}
+
+MX_TEST(ImageLoader, CreateCubemapMatchesPerPixelCopy)
+{
+    ModuleScope<ThreadPool> modules;
+    for (size_t faceSize : { 1, 7, 64, 200 })
+    {
+        for (size_t channels : { 1, 3, 4 })
+        {
+            auto image = MakeImage<uint8_t>(faceSize * 4, faceSize * 3, channels, uint32_t(faceSize + channels));
+            auto faces = ImageLoader::CreateCubemap(image);
+            for (size_t face = 0; face < faces.size(); face++)
+            {
+                MX_REQUIRE(faces[face].width() == faceSize);
+                MX_REQUIRE(faces[face].height() == faceSize * image.GetPixelSize());
+                MX_CHECK_EQ(CountCrossFaceMismatches(image, faces[face], face, faceSize), (size_t)0);
+            }
+        }
+
+        auto image = MakeImage<float>(faceSize * 4, faceSize * 3, 4, uint32_t(faceSize));
+        auto faces = ImageLoader::CreateCubemap(image);
+        for (size_t face = 0; face < faces.size(); face++)
+            MX_CHECK_EQ(CountCrossFaceMismatches(image, faces[face], face, faceSize), (size_t)0);
+    }
+}
+
+MX_TEST(ImageLoader, CreateCubemapReducesNonSquareCross)
+{
+    ModuleScope<ThreadPool> modules;
+    // 10x8 cells are not square, faces are reduced to the largest power of two which fits
+    auto image = MakeImage<uint8_t>(40, 24, 4, 3);
+    auto faces = ImageLoader::CreateCubemap(image);
+    for (size_t face = 0; face < faces.size(); face++)
+    {
+        MX_REQUIRE(faces[face].width() == 8);
+        MX_CHECK_EQ(CountCrossFaceMismatches(image, faces[face], face, 8), (size_t)0);
+    }
+}
+
+MX_TEST(ImageLoader, EquirectangularConstantImageIsExact)
+{
+    ModuleScope<ThreadPool> modules;
+    for (size_t channels : { 1, 3, 4 })
+    {
+        const size_t width = 64, height = 32;
+        auto bytes = (uint8_t*)std::malloc(width * height * channels);
+        auto floats = (float*)std::malloc(width * height * channels * sizeof(float));
+        for (size_t i = 0; i < width * height * channels; i++)
+        {
+            bytes[i] = uint8_t(200 + i % channels);
+            floats[i] = 3.25f + float(i % channels);
+        }
+        ImageData byteImage(bytes, width, height, channels, ImageFormat::BYTE);
+        ImageData floatImage((uint8_t*)floats, width, height, channels, ImageFormat::FLOAT);
+
+        auto byteFaces = ImageLoader::CreateCubemapFromEquirectangular(byteImage, 17);
+        auto floatFaces = ImageLoader::CreateCubemapFromEquirectangular(floatImage, 17);
+        size_t mismatches = 0;
+        for (size_t face = 0; face < 6; face++)
+        {
+            MX_REQUIRE(byteFaces[face].size() == 17 * 17 * channels);
+            MX_REQUIRE(floatFaces[face].size() == 17 * 17 * channels * sizeof(float));
+            auto facePixels = (const float*)floatFaces[face].data();
+            for (size_t i = 0; i < 17 * 17 * channels; i++)
+            {
+                mismatches += byteFaces[face].data()[i] != uint8_t(200 + i % channels);
+                mismatches += facePixels[i] != 3.25f + float(i % channels);
+            }
+        }
+        MX_CHECK_EQ(mismatches, (size_t)0);
+    }
+}
+
+MX_TEST(ImageLoader, EquirectangularFacesFollowCubemapLayout)
+{
+    ModuleScope<ThreadPool> modules;
+    // face order of panorama colors is +X, -X, +Y, -Y, +Z, -Z, same as CreateCubemap returns
+    const size_t faceSize = 32, margin = 4;
+    auto byteImage = MakeFaceColoredPanorama<uint8_t>(1024, 4);
+    auto floatImage = MakeFaceColoredPanorama<float>(1024, 3);
+    auto byteFaces = ImageLoader::CreateCubemapFromEquirectangular(byteImage, faceSize);
+    auto floatFaces = ImageLoader::CreateCubemapFromEquirectangular(floatImage, faceSize);
+
+    for (size_t face = 0; face < 6; face++)
+    {
+        // texels close to face edges may blend colors of neighbour faces, all others must be exact
+        size_t mismatches = 0;
+        for (size_t y = margin; y < faceSize - margin; y++)
+        {
+            for (size_t x = margin; x < faceSize - margin; x++)
+            {
+                const uint8_t* bytePixel = byteFaces[face].data() + (y * faceSize + x) * 4;
+                const float* floatPixel = (const float*)floatFaces[face].data() + (y * faceSize + x) * 3;
+                for (size_t c = 0; c < 4; c++)
+                    mismatches += bytePixel[c] != uint8_t(face * 40 + c * 7 + 1);
+                for (size_t c = 0; c < 3; c++)
+                    mismatches += floatPixel[c] != float(face * 40 + c * 7 + 1);
+            }
+        }
+        MX_CHECK_EQ(mismatches, (size_t)0);
+    }
+}
+
+MX_TEST(ImageLoader, EquirectangularChannelsAreFilteredIndependently)
+{
+    ModuleScope<ThreadPool> modules;
+    // 4-channel images are blended with SIMD, single channel ones by scalar code: both must give identical texels
+    const size_t width = 96, height = 48, faceSize = 23;
+    auto byteImage = MakeImage<uint8_t>(width, height, 4, 11);
+    auto floatImage = MakeImage<float>(width, height, 4, 12);
+    auto byteFaces = ImageLoader::CreateCubemapFromEquirectangular(byteImage, faceSize);
+    auto floatFaces = ImageLoader::CreateCubemapFromEquirectangular(floatImage, faceSize);
+
+    for (size_t channel = 0; channel < 4; channel++)
+    {
+        auto byteChannel = ImageConverter::ExtractChannel(byteImage, channel);
+        auto floatChannel = ImageConverter::ExtractChannel(floatImage, channel);
+        auto byteChannelFaces = ImageLoader::CreateCubemapFromEquirectangular(byteChannel, faceSize);
+        auto floatChannelFaces = ImageLoader::CreateCubemapFromEquirectangular(floatChannel, faceSize);
+
+        size_t mismatches = 0;
+        for (size_t face = 0; face < 6; face++)
+        {
+            auto floatPixels = (const float*)floatFaces[face].data();
+            auto floatChannelPixels = (const float*)floatChannelFaces[face].data();
+            for (size_t i = 0; i < faceSize * faceSize; i++)
+            {
+                mismatches += byteFaces[face].data()[i * 4 + channel] != byteChannelFaces[face].data()[i];
+                mismatches += floatPixels[i * 4 + channel] != floatChannelPixels[i];
+            }
+        }
+        MX_CHECK_EQ(mismatches, (size_t)0);
+    }
+}
+
+MX_TEST(ImageLoader, EquirectangularHalfFloatProducesFloatFaces)
+{
+    ModuleScope<ThreadPool> modules;
+    auto floatImage = MakeImage<float>(64, 32, 4, 5);
+    auto halfImage = ImageConverter::ConvertToHalfFloat(floatImage);
+    auto expected = ImageLoader::CreateCubemapFromEquirectangular(ImageConverter::ConvertToFloat(halfImage), 16);
+    auto actual = ImageLoader::CreateCubemapFromEquirectangular(halfImage, 16);
+
+    for (size_t face = 0; face < 6; face++)
+    {
+        MX_REQUIRE(actual[face].size() == expected[face].size());
+        MX_CHECK(std::memcmp(actual[face].data(), expected[face].data(), expected[face].size()) == 0);
+    }
+}
+
+MX_TEST(ImageLoader, EquirectangularDefaultFaceSizeAndEmptyImage)
+{
+    ModuleScope<ThreadPool> modules;
+    auto faces = ImageLoader::CreateCubemapFromEquirectangular(MakeImage<uint8_t>(128, 64, 4, 1));
+    MX_CHECK_EQ(faces[0].width(), (size_t)32);
+    MX_CHECK_EQ(faces[0].height(), (size_t)32 * 4);
+
+    auto empty = ImageLoader::CreateCubemapFromEquirectangular(ImageData());
+    for (const auto& face : empty)
+        MX_CHECK_EQ(face.size(), (size_t)0);
+}
+
+MX_TEST(ImageLoader, RawImageFileRoundTripIsExact)
+{
+    // ObjectLoader extracts textures into .mximage files, which must load back without any loss
+    auto directory = std::filesystem::temp_directory_path() / "MxEngineTests" / "RawImageFile";
+    std::filesystem::create_directories(directory);
+    auto path = directory / "image.mximage";
+
+    MxVector<ImageData> images;
+    for (size_t channels : { 1, 2, 3, 4 })
+        images.push_back(MakeImage<uint8_t>(37, 21, channels, uint32_t(channels)));
+    images.push_back(MakeImage<float>(16, 9, 3, 7));
+    images.push_back(ImageConverter::ConvertToHalfFloat(MakeImage<float>(16, 9, 4, 8)));
+
+    for (const auto& image : images)
+    {
+        ImageManager::SaveImage(path, image, ImageType::RAW);
+        MX_CHECK(IsSameImage(image, ImageLoader::LoadImage(path)));
+
+        // images are stored already flipped, so loading without flip returns rows in reversed order
+        auto unflipped = ImageLoader::LoadImage(path, false);
+        ImageManager::FlipImage(unflipped);
+        MX_CHECK(IsSameImage(image, unflipped));
+    }
+
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+}
+
+MX_TEST(ImageLoader, RawImageFileRejectsTruncatedData)
+{
+    auto directory = std::filesystem::temp_directory_path() / "MxEngineTests" / "RawImageTruncated";
+    std::filesystem::create_directories(directory);
+    auto path = directory / "image.mximage";
+
+    auto bytes = ImageConverter::ConvertImageRAW(MakeImage<uint8_t>(32, 32, 4, 11));
+    for (size_t byteSize : { (size_t)0, sizeof(RawImageHeader) - 1, sizeof(RawImageHeader), bytes.size() - 1 })
+    {
+        {
+            File file(path, File::WRITE | File::BINARY);
+            file.WriteBytes(bytes.data(), byteSize);
+        }
+        MX_CHECK(ImageLoader::LoadImage(path).GetRawData() == nullptr);
+    }
+
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+}
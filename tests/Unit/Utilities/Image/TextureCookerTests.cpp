@@ -0,0 +1,413 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Utilities/Image/TextureCooker.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/FileSystem/VirtualFileSystem.h"
+
+#include <vector>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <algorithm>
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+namespace
+{
+    /*!
+    reference block decoders, used to measure quality of encoded textures
+    */
+    void DecodeBC4Block(const uint8_t* block, uint8_t* values, size_t stride)
+    {
+        std::array<int, 8> palette;
+        int a0 = block[0], a1 = block[1];
+        palette[0] = a0;
+        palette[1] = a1;
+        if (a0 > a1)
+        {
+            for (int i = 1; i < 7; i++)
+                palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+        }
+        else
+        {
+            for (int i = 1; i < 5; i++)
+                palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+
+        uint64_t bits = 0;
+        for (size_t i = 0; i < 6; i++)
+            bits |= (uint64_t)block[2 + i] << (8 * i);
+        for (size_t i = 0; i < 16; i++)
+            values[i * stride] = (uint8_t)palette[(bits >> (3 * i)) & 7];
+    }
+
+    void DecodeBC1Block(const uint8_t* block, uint8_t* rgba, bool isBC3)
+    {
+        uint16_t c0 = uint16_t(block[0] | block[1] << 8);
+        uint16_t c1 = uint16_t(block[2] | block[3] << 8);
+        std::array<std::array<int, 4>, 4> palette;
+        auto expand = [](uint16_t c) -> std::array<int, 4>
+        {
+            int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+            return { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255 };
+        };
+        palette[0] = expand(c0);
+        palette[1] = expand(c1);
+        for (size_t c = 0; c < 3; c++)
+        {
+            if (c0 > c1 || isBC3)
+            {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            else
+            {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                palette[3][c] = 0;
+            }
+        }
+        palette[2][3] = 255;
+        palette[3][3] = (c0 > c1 || isBC3) ? 255 : 0;
+
+        uint32_t bits = uint32_t(block[4]) | uint32_t(block[5]) << 8 | uint32_t(block[6]) << 16 | uint32_t(block[7]) << 24;
+        for (size_t i = 0; i < 16; i++)
+        {
+            const auto& color = palette[(bits >> (2 * i)) & 3];
+            for (size_t c = 0; c < 4; c++)
+                rgba[i * 4 + c] = (uint8_t)color[c];
+        }
+    }
+
+    /*!
+    decodes single plane of compressed blocks into interleaved pixels with given channel count
+    */
+    std::vector<uint8_t> DecodePlane(const uint8_t* blocks, TextureCompression compression, size_t width, size_t height, size_t channels)
+    {
+        size_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+        size_t blockSize = (compression == TextureCompression::BC1 || compression == TextureCompression::BC4) ? 8 : 16;
+        std::vector<uint8_t> pixels(width * height * channels);
+        for (size_t blockY = 0; blockY < blocksY; blockY++)
+        {
+            for (size_t blockX = 0; blockX < blocksX; blockX++)
+            {
+                const uint8_t* block = blocks + (blockY * blocksX + blockX) * blockSize;
+                std::array<uint8_t, 16 * 4> decoded{ };
+                switch (compression)
+                {
+                case TextureCompression::BC1:
+                    DecodeBC1Block(block, decoded.data(), false);
+                    break;
+                case TextureCompression::BC3:
+                    DecodeBC1Block(block + 8, decoded.data(), true);
+                    DecodeBC4Block(block, decoded.data() + 3, 4);
+                    break;
+                case TextureCompression::BC4:
+                    DecodeBC4Block(block, decoded.data(), 4);
+                    break;
+                case TextureCompression::BC5:
+                    DecodeBC4Block(block, decoded.data() + 0, 4);
+                    DecodeBC4Block(block + 8, decoded.data() + 1, 4);
+                    break;
+                default:
+                    break;
+                }
+                for (size_t i = 0; i < 16; i++)
+                {
+                    size_t x = blockX * 4 + i % 4, y = blockY * 4 + i / 4;
+                    if (x >= width || y >= height) continue;
+                    for (size_t c = 0; c < channels; c++)
+                        pixels[(y * width + x) * channels + c] = decoded[i * 4 + c];
+                }
+            }
+        }
+        return pixels;
+    }
+
+    /*!
+    computes PSNR in dB of single channel between two interleaved images
+    */
+    double ComputePSNR(const uint8_t* reference, size_t referenceChannels, const uint8_t* decoded, size_t decodedChannels, size_t pixelCount, size_t channel, size_t decodedChannel)
+    {
+        double squaredError = 0.0;
+        for (size_t i = 0; i < pixelCount; i++)
+        {
+            double difference = double(reference[i * referenceChannels + channel]) - double(decoded[i * decodedChannels + decodedChannel]);
+            squaredError += difference * difference;
+        }
+        double meanSquaredError = squaredError / double(pixelCount);
+        if (meanSquaredError == 0.0) return 100.0;
+        return 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+    }
+
+    /*!
+    creates smooth image with different content in each channel, similar to photos and material masks
+    */
+    ImageData MakeTestImage(size_t width, size_t height, size_t channels)
+    {
+        auto data = (uint8_t*)std::malloc(width * height * channels);
+        for (size_t y = 0; y < height; y++)
+        {
+            for (size_t x = 0; x < width; x++)
+            {
+                float u = float(x) / float(width), v = float(y) / float(height);
+                std::array<float, 4> values = {
+                    0.5f + 0.4f * std::sin(u * 9.0f) * std::cos(v * 7.0f),
+                    u,
+                    v,
+                    0.5f + 0.5f * std::cos((u + v) * 5.0f),
+                };
+                for (size_t c = 0; c < channels; c++)
+                    data[(y * width + x) * channels + c] = (uint8_t)(values[c] * 255.0f + 0.5f);
+            }
+        }
+        return ImageData(data, width, height, channels, false);
+    }
+
+    /*!
+    creates RGBA image where only first channels carry data, as masks are decoded from files. Unused color channels repeat first one
+    for grayscale masks and are zero otherwise, alpha is opaque
+    */
+    ImageData MakeRGBAMask(size_t width, size_t height, size_t usedChannels)
+    {
+        auto source = MakeTestImage(width, height, usedChannels);
+        auto data = (uint8_t*)std::malloc(width * height * 4);
+        for (size_t i = 0; i < width * height; i++)
+        {
+            const uint8_t* pixel = source.GetRawData() + i * usedChannels;
+            for (size_t c = 0; c < 3; c++)
+                data[i * 4 + c] = c < usedChannels ? pixel[c] : (usedChannels == 1 ? pixel[0] : 0);
+            data[i * 4 + 3] = 255;
+        }
+        return ImageData(data, width, height, 4, false);
+    }
+
+    constexpr double MinColorPSNR = 30.0;
+    constexpr double MinSingleChannelPSNR = 38.0;
+}
+
+MX_TEST(TextureCooker, BC1ColorQuality)
+{
+    ModuleScope<ThreadPool> modules;
+    auto image = MakeTestImage(64, 64, 3);
+    MX_CHECK(TextureCooker::SelectCompression(image, TextureUsage::COLOR) == TextureCompression::BC1);
+
+    auto blocks = TextureCooker::CompressImage(image, TextureCompression::BC1);
+    MX_REQUIRE(blocks.size() == 16 * 16 * 8);
+    auto decoded = DecodePlane(blocks.data(), TextureCompression::BC1, 64, 64, 4);
+    for (size_t c = 0; c < 3; c++)
+        MX_CHECK_GE(ComputePSNR(image.GetRawData(), 3, decoded.data(), 4, 64 * 64, c, c), MinColorPSNR);
+}
+
+MX_TEST(TextureCooker, BC3AlphaQuality)
+{
+    ModuleScope<ThreadPool> modules;
+    auto image = MakeTestImage(64, 64, 4);
+    MX_CHECK(TextureCooker::SelectCompression(image, TextureUsage::COLOR) == TextureCompression::BC3);
+
+    auto blocks = TextureCooker::CompressImage(image, TextureCompression::BC3);
+    MX_REQUIRE(blocks.size() == 16 * 16 * 16);
+    auto decoded = DecodePlane(blocks.data(), TextureCompression::BC3, 64, 64, 4);
+    for (size_t c = 0; c < 3; c++)
+        MX_CHECK_GE(ComputePSNR(image.GetRawData(), 4, decoded.data(), 4, 64 * 64, c, c), MinColorPSNR);
+    MX_CHECK_GE(ComputePSNR(image.GetRawData(), 4, decoded.data(), 4, 64 * 64, 3, 3), MinSingleChannelPSNR);
+}
+
+MX_TEST(TextureCooker, BC5NormalQuality)
+{
+    ModuleScope<ThreadPool> modules;
+    auto image = MakeTestImage(64, 64, 3);
+    MX_CHECK(TextureCooker::SelectCompression(image, TextureUsage::NORMAL) == TextureCompression::BC5);
+
+    auto blocks = TextureCooker::CompressImage(image, TextureCompression::BC5);
+    MX_REQUIRE(blocks.size() == 16 * 16 * 16);
+    auto decoded = DecodePlane(blocks.data(), TextureCompression::BC5, 64, 64, 2);
+    MX_CHECK_GE(ComputePSNR(image.GetRawData(), 3, decoded.data(), 2, 64 * 64, 0, 0), MinSingleChannelPSNR);
+    MX_CHECK_GE(ComputePSNR(image.GetRawData(), 3, decoded.data(), 2, 64 * 64, 1, 1), MinSingleChannelPSNR);
+}
+
+MX_TEST(TextureCooker, MaskCompressionFollowsUsedChannels)
+{
+    ModuleScope<ThreadPool> modules;
+    // masks are usually decoded as RGBA, even if only one or two channels carry data
+    const TextureCompression expected[] = { TextureCompression::BC4, TextureCompression::BC5, TextureCompression::BC1, TextureCompression::BC3 };
+    for (size_t channels = 1; channels <= 4; channels++)
+    {
+        auto image = MakeTestImage(64, 64, channels);
+        MX_CHECK_EQ(TextureCooker::GetUsedChannelCount(image), channels);
+        MX_CHECK(TextureCooker::SelectCompression(image, TextureUsage::MASK) == expected[channels - 1]);
+    }
+    for (size_t usedChannels = 1; usedChannels <= 2; usedChannels++)
+    {
+        auto image = MakeRGBAMask(64, 64, usedChannels);
+        MX_CHECK_EQ(TextureCooker::GetUsedChannelCount(image), usedChannels);
+        MX_CHECK(TextureCooker::SelectCompression(image, TextureUsage::MASK) == expected[usedChannels - 1]);
+    }
+    // floating point images are not analyzed
+    auto floats = (float*)std::malloc(4 * 4 * 4 * sizeof(float));
+    std::fill(floats, floats + 4 * 4 * 4, 1.0f);
+    MX_CHECK_EQ(TextureCooker::GetUsedChannelCount(ImageData((uint8_t*)floats, 4, 4, 4, ImageFormat::FLOAT)), (size_t)4);
+}
+
+MX_TEST(TextureCooker, BC4MaskQuality)
+{
+    ModuleScope<ThreadPool> modules;
+    auto image = MakeRGBAMask(64, 64, 1);
+    auto texture = TextureCooker::Cook(image, TextureUsage::MASK);
+    MX_CHECK(texture.Compression == TextureCompression::BC4);
+    MX_CHECK_EQ(texture.Channels, (size_t)1);
+    MX_REQUIRE(texture.Mips.size() == 7);
+    // single BC4 plane takes 8 times less space than RGBA8 source
+    MX_REQUIRE(texture.Mips[0].size() == 16 * 16 * 8);
+    MX_CHECK_EQ(texture.Mips.back().size(), (size_t)8);
+
+    auto decoded = DecodePlane(texture.Mips[0].data(), TextureCompression::BC4, 64, 64, 1);
+    MX_CHECK_GE(ComputePSNR(image.GetRawData(), 4, decoded.data(), 1, 64 * 64, 0, 0), MinSingleChannelPSNR);
+}
+
+MX_TEST(TextureCooker, BC5MaskQuality)
+{
+    ModuleScope<ThreadPool> modules;
+    auto image = MakeRGBAMask(64, 64, 2);
+    auto texture = TextureCooker::Cook(image, TextureUsage::MASK);
+    MX_CHECK(texture.Compression == TextureCompression::BC5);
+    MX_CHECK_EQ(texture.Channels, (size_t)2);
+    MX_REQUIRE(texture.Mips[0].size() == 16 * 16 * 16);
+
+    auto decoded = DecodePlane(texture.Mips[0].data(), TextureCompression::BC5, 64, 64, 2);
+    for (size_t c = 0; c < 2; c++)
+        MX_CHECK_GE(ComputePSNR(image.GetRawData(), 4, decoded.data(), 2, 64 * 64, c, c), MinSingleChannelPSNR);
+}
+
+MX_TEST(TextureCooker, EdgeBlocksArePaddedByClamping)
+{
+    ModuleScope<ThreadPool> modules;
+    // second channel is a horizontal gradient, which stays smooth even on such a small image
+    auto image = MakeTestImage(13, 7, 2);
+    auto blocks = TextureCooker::CompressImage(image, TextureCompression::BC5);
+    MX_REQUIRE(blocks.size() == 4 * 2 * 16);
+
+    auto decoded = DecodePlane(blocks.data(), TextureCompression::BC5, 13, 7, 2);
+    MX_CHECK_GE(ComputePSNR(image.GetRawData(), 2, decoded.data(), 2, 13 * 7, 1, 1), MinSingleChannelPSNR);
+}
+
+MX_TEST(TextureCooker, MipChainIsGammaCorrect)
+{
+    // 2x1 image of black and white pixels averages to linear 0.5, which is 188 in sRGB
+    auto data = (uint8_t*)std::malloc(2 * 4);
+    const uint8_t pixels[] = { 0, 0, 0, 0, 255, 255, 255, 255 };
+    std::memcpy(data, pixels, sizeof(pixels));
+    ImageData image(data, 2, 1, 4, false);
+
+    auto colorMips = TextureCooker::GenerateMipmaps(image, true);
+    MX_REQUIRE(colorMips.size() == 1);
+    MX_CHECK_EQ(colorMips[0].GetWidth(), (size_t)1);
+    MX_CHECK_NEAR(colorMips[0].GetRawData()[0], 188, 1);
+    // alpha is linear
+    MX_CHECK_NEAR(colorMips[0].GetRawData()[3], 128, 1);
+
+    auto maskMips = TextureCooker::GenerateMipmaps(image, false);
+    MX_REQUIRE(maskMips.size() == 1);
+    MX_CHECK_NEAR(maskMips[0].GetRawData()[0], 128, 1);
+
+    auto chain = TextureCooker::GenerateMipmaps(MakeTestImage(64, 16, 1), false);
+    MX_REQUIRE(chain.size() == 6);
+    MX_CHECK_EQ(chain[1].GetWidth(), (size_t)16);
+    MX_CHECK_EQ(chain[1].GetHeight(), (size_t)4);
+    MX_CHECK_EQ(chain.back().GetWidth(), (size_t)1);
+    MX_CHECK_EQ(chain.back().GetHeight(), (size_t)1);
+}
+
+MX_TEST(TextureCooker, CookedTextureRoundTrip)
+{
+    ModuleScope<ThreadPool> modules;
+    auto image = MakeTestImage(32, 32, 2);
+    auto texture = TextureCooker::Cook(image, TextureUsage::MASK);
+    MX_CHECK(texture.Compression == TextureCompression::BC5);
+    MX_REQUIRE(texture.Mips.size() == 6);
+    MX_CHECK_EQ(texture.Mips[0].size(), (size_t)8 * 8 * 16);
+
+    auto path = std::filesystem::temp_directory_path() / "MxEngineTextureCookerTest.mxtexture";
+    MX_REQUIRE(TextureCooker::SaveCooked(path, texture));
+    CookedTexture loaded;
+    MX_CHECK(TextureCooker::ReadCooked(path, loaded));
+    std::filesystem::remove(path);
+
+    MX_CHECK(loaded.Usage == texture.Usage);
+    MX_CHECK(loaded.Compression == texture.Compression);
+    MX_CHECK_EQ(loaded.Width, texture.Width);
+    MX_CHECK_EQ(loaded.Channels, texture.Channels);
+    MX_REQUIRE(loaded.Mips.size() == texture.Mips.size());
+    for (size_t i = 0; i < loaded.Mips.size(); i++)
+    {
+        MX_CHECK_EQ(loaded.Mips[i].size(), texture.Mips[i].size());
+        MX_CHECK(std::memcmp(loaded.Mips[i].data(), texture.Mips[i].data(), loaded.Mips[i].size()) == 0);
+    }
+}
+
+MX_TEST(TextureCooker, LoadCookedReadsPackedCacheWithoutSource)
+{
+    ModuleScope<ThreadPool, VirtualFileSystem> modules;
+    auto directory = std::filesystem::temp_directory_path() / "MxEngineTests" / "TextureCookerPacked";
+    std::filesystem::create_directories(directory);
+    // only cooked texture is shipped, source image is neither on disk nor in pack
+    auto texturePath = directory / "albedo.png";
+    auto cookedPath = TextureCooker::GetCookedPath(texturePath);
+    auto texture = TextureCooker::Cook(MakeTestImage(16, 16, 4), TextureUsage::COLOR);
+    MX_REQUIRE(TextureCooker::SaveCooked(cookedPath, texture));
+
+    PackFileWriter writer;
+    writer.AddFile(ToFilePath(VirtualFileSystem::GetPackedPath(cookedPath)), cookedPath);
+    auto packPath = directory / "textures.mxpack";
+    MX_REQUIRE(writer.Write(packPath));
+    std::filesystem::remove(cookedPath);
+    MX_REQUIRE(VirtualFileSystem::Mount(packPath));
+
+    auto loaded = TextureCooker::LoadCooked(texturePath, TextureUsage::COLOR);
+    bool isRecooked = File::Exists(cookedPath);
+    VirtualFileSystem::UnmountAll();
+    std::filesystem::remove_all(directory);
+
+    MX_CHECK(!isRecooked); // packed cache is up to date, so nothing is written to disk
+    MX_CHECK(loaded.Compression == texture.Compression);
+    MX_CHECK_EQ(loaded.Width, texture.Width);
+    MX_REQUIRE(loaded.Mips.size() == texture.Mips.size());
+    for (size_t i = 0; i < loaded.Mips.size(); i++)
+    {
+        MX_CHECK_EQ(loaded.Mips[i].size(), texture.Mips[i].size());
+        MX_CHECK(std::memcmp(loaded.Mips[i].data(), texture.Mips[i].data(), loaded.Mips[i].size()) == 0);
+    }
+}
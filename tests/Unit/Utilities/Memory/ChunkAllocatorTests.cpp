@@ -0,0 +1,91 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Framework/TestFramework.h"
+#include "Utilities/Memory/ChunkAllocator.h"
+#include "Utilities/Memory/LinearAllocator.h"
+
+#include <cstddef>
+#include <cstring>
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+MX_TEST(ChunkAllocator, RawAllocReturnsAlignedWritableChunks)
+{
+    const size_t chunkCounts[] = { 1, 2, 7, 64 };
+    for (size_t chunkCount : chunkCounts)
+    {
+        uint8_t* chunk = ChunkAllocator::RawAlloc(chunkCount);
+        MX_REQUIRE(chunk != nullptr);
+        MX_CHECK(reinterpret_cast<uintptr_t>(chunk) % alignof(std::max_align_t) == 0);
+
+        // whole range belongs to the allocation, so first and last byte of each chunk can be written
+        size_t bytes = chunkCount * ChunkAllocator::ChunkSize;
+        std::memset(chunk, 0xAB, bytes);
+        MX_CHECK_EQ(chunk[0], (uint8_t)0xAB);
+        MX_CHECK_EQ(chunk[bytes - 1], (uint8_t)0xAB);
+        ChunkAllocator::Free(chunk);
+    }
+}
+
+MX_TEST(ChunkAllocator, ChunksAreIndependent)
+{
+    uint8_t* first = ChunkAllocator::RawAlloc(2);
+    uint8_t* second = ChunkAllocator::RawAlloc(2);
+    MX_REQUIRE(first != nullptr && second != nullptr);
+
+    size_t bytes = 2 * ChunkAllocator::ChunkSize;
+    MX_CHECK(first + bytes <= second || second + bytes <= first);
+
+    std::memset(first, 1, bytes);
+    std::memset(second, 2, bytes);
+    MX_CHECK_EQ(first[bytes - 1], (uint8_t)1);
+    MX_CHECK_EQ(second[0], (uint8_t)2);
+
+    ChunkAllocator::Free(first);
+    ChunkAllocator::Free(second);
+}
+
+MX_TEST(ChunkAllocator, BacksLinearAllocator)
+{
+    // frame allocator arenas are built the same way: whole chunks handed to a linear allocator
+    constexpr size_t ChunkCount = 4;
+    uint8_t* chunk = ChunkAllocator::RawAlloc(ChunkCount);
+    MX_REQUIRE(chunk != nullptr);
+
+    LinearAllocator allocator(chunk, ChunkCount * ChunkAllocator::ChunkSize);
+    for (size_t i = 0; i < ChunkCount; i++)
+    {
+        uint8_t* ptr = allocator.TryRawAlloc(ChunkAllocator::ChunkSize);
+        MX_CHECK(ptr == chunk + i * ChunkAllocator::ChunkSize);
+    }
+    MX_CHECK(allocator.TryRawAlloc(1) == nullptr);
+
+    ChunkAllocator::Free(chunk);
+}
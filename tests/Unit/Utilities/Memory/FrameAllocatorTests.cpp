@@ -0,0 +1,140 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Framework/ModuleScope.h"
+#include "Utilities/Memory/FrameAllocator.h"
+
+#include <cstring>
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+static bool IsAligned(const void* ptr, size_t alignment)
+{
+    return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+MX_TEST(FrameAllocator, ArenaIsResetAfterTwoFrames)
+{
+    ModuleScope<FrameAllocator> modules;
+
+    uint8_t* first = FrameAllocator::RawAlloc(1000);
+    MX_CHECK(first != nullptr);
+    MX_CHECK_GE(FrameAllocator::GetUsedBytes(), size_t(1000));
+
+    // next frame uses the second arena, which is empty
+    FrameAllocator::OnFrameBegin();
+    MX_CHECK_EQ(FrameAllocator::GetUsedBytes(), size_t(0));
+    MX_CHECK_GE(FrameAllocator::GetLastFrameUsedBytes(), size_t(1000));
+    (void)FrameAllocator::RawAlloc(200);
+
+    // the frame after it reuses the first arena, which must be reset
+    FrameAllocator::OnFrameBegin();
+    MX_CHECK_EQ(FrameAllocator::GetUsedBytes(), size_t(0));
+    uint8_t* reused = FrameAllocator::RawAlloc(1000);
+    MX_CHECK(reused == first);
+}
+
+MX_TEST(FrameAllocator, MemoryStaysValidDuringNextFrame)
+{
+    ModuleScope<FrameAllocator> modules;
+    constexpr size_t Size = 4096;
+
+    uint8_t* previous = FrameAllocator::RawAlloc(Size);
+    std::memset(previous, 0xAB, Size);
+
+    FrameAllocator::OnFrameBegin();
+    uint8_t* current = FrameAllocator::RawAlloc(Size);
+    std::memset(current, 0xCD, Size);
+
+    bool isPreserved = true;
+    for (size_t i = 0; i < Size; i++)
+        isPreserved &= previous[i] == 0xAB;
+    MX_CHECK(isPreserved);
+}
+
+MX_TEST(FrameAllocator, AllocationsAreAligned)
+{
+    ModuleScope<FrameAllocator> modules;
+    for (size_t alignment = 1; alignment <= 256; alignment *= 2)
+    {
+        (void)FrameAllocator::RawAlloc(3, 1);
+        MX_CHECK(IsAligned(FrameAllocator::RawAlloc(17, alignment), alignment));
+    }
+    MX_CHECK(IsAligned(FrameAllocator::RawAlloc(1), alignof(std::max_align_t)));
+}
+
+MX_TEST(FrameAllocator, ArenaGrowsAfterOverflow)
+{
+    constexpr size_t InitialSize = 16 * KB;
+    FrameAllocator::Init(InitialSize);
+
+    // allocations which do not fit into arena are served from heap until reset
+    MxVector<uint8_t*> allocations;
+    for (size_t i = 0; i < 64; i++)
+    {
+        uint8_t* ptr = FrameAllocator::RawAlloc(1 * KB, 64);
+        MX_REQUIRE(ptr != nullptr);
+        MX_CHECK(IsAligned(ptr, 64));
+        std::memset(ptr, (int)i, 1 * KB);
+        allocations.push_back(ptr);
+    }
+    for (size_t i = 0; i < allocations.size(); i++)
+        MX_CHECK_EQ(allocations[i][KB - 1], (uint8_t)i);
+
+    size_t usedBytes = FrameAllocator::GetUsedBytes();
+    MX_CHECK_GE(usedBytes, size_t(64 * KB));
+    MX_CHECK_GE(FrameAllocator::GetHighWaterMark(), usedBytes);
+
+    FrameAllocator::OnFrameBegin();
+    FrameAllocator::OnFrameBegin();
+    MX_CHECK_GE(FrameAllocator::GetCapacity(), usedBytes);
+    MX_CHECK_EQ(FrameAllocator::GetUsedBytes(), size_t(0));
+    MX_CHECK_GE(FrameAllocator::GetHighWaterMark(), usedBytes);
+
+    FrameAllocator::Destroy();
+}
+
+MX_TEST(FrameAllocator, RecycledFrameVectorSurvivesReset)
+{
+    ModuleScope<FrameAllocator> modules;
+    FrameVector<int> values;
+    for (size_t frame = 0; frame < 8; frame++)
+    {
+        FrameAllocator::OnFrameBegin();
+        for (int i = 0; i < 1000; i++)
+            values.push_back(i);
+
+        MX_CHECK_EQ(values.size(), size_t(1000));
+        MX_CHECK_EQ(values.back(), 999);
+        FrameAllocator::Recycle(values);
+        MX_CHECK(values.empty());
+    }
+}
@@ -0,0 +1,90 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Utilities/Memory/LinearAllocator.h"
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+namespace
+{
+    bool IsAligned(const void* ptr, size_t alignment)
+    {
+        return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+    }
+}
+
+MX_TEST(LinearAllocator, AllocHonorsAlignmentWithoutExtraPadding)
+{
+    alignas(256) static uint8_t storage[4096];
+    LinearAllocator allocator(storage, sizeof(storage));
+
+    const size_t alignments[] = { 1, 2, 4, 8, 16, 32, 64, 128, 256 };
+    for (size_t alignment : alignments)
+    {
+        uint8_t* ptr = allocator.RawAlloc(3, alignment);
+        MX_CHECK(IsAligned(ptr, alignment));
+        MX_CHECK(allocator.Contains(ptr));
+    }
+
+    // already aligned top is not moved
+    allocator.Reset();
+    MX_CHECK(allocator.RawAlloc(16, 16) == storage);
+    MX_CHECK(allocator.RawAlloc(16, 16) == storage + 16);
+    MX_CHECK_EQ(allocator.GetUsedBytes(), (size_t)32);
+}
+
+MX_TEST(LinearAllocator, ResetReusesWholeChunk)
+{
+    alignas(16) static uint8_t storage[256];
+    LinearAllocator allocator(storage, sizeof(storage));
+
+    uint8_t* first = allocator.RawAlloc(100);
+    MX_CHECK(allocator.RawAlloc(100) == first + 100);
+    allocator.Reset();
+    MX_CHECK_EQ(allocator.GetUsedBytes(), (size_t)0);
+    MX_CHECK(allocator.RawAlloc(256) == first);
+}
+
+MX_TEST(LinearAllocator, ExhaustionReturnsNullOrAsserts)
+{
+    alignas(16) static uint8_t storage[256];
+    LinearAllocator allocator(storage, sizeof(storage));
+
+    MX_CHECK(allocator.TryRawAlloc(257) == nullptr);
+    MX_CHECK(allocator.TryRawAlloc(200) != nullptr);
+    MX_CHECK(allocator.TryRawAlloc(64) == nullptr);
+    MX_CHECK_EQ(allocator.GetUsedBytes(), (size_t)200);
+    MX_CHECK_ASSERTS(allocator.RawAlloc(64));
+
+    LinearAllocator empty;
+    MX_CHECK(empty.TryRawAlloc(1) == nullptr);
+    MX_CHECK_ASSERTS(empty.RawAlloc(1));
+}
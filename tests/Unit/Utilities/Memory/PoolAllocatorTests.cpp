@@ -0,0 +1,270 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Utilities/Memory/PoolAllocator.h"
+
+#include <vector>
+#include <set>
+#include <memory>
+#include <type_traits>
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+namespace
+{
+    struct alignas(32) AlignedValue
+    {
+        int Value;
+
+        AlignedValue(int value) : Value(value) { }
+    };
+
+    struct CountedValue
+    {
+        int* Destroyed;
+
+        CountedValue(int* destroyed) : Destroyed(destroyed) { }
+        ~CountedValue() { (*this->Destroyed)++; }
+    };
+
+    /*!
+    raw storage for pool blocks. Blocks are not constructed or destroyed by storage itself, as pool allocator manages objects in them
+    */
+    template<typename T>
+    struct PoolStorage
+    {
+        using Block = typename PoolAllocator<T>::Block;
+        using BlockStorage = std::aligned_storage_t<sizeof(Block), alignof(Block)>;
+
+        std::unique_ptr<BlockStorage[]> Blocks;
+        size_t Count;
+
+        PoolStorage(size_t count) : Blocks(std::make_unique<BlockStorage[]>(count)), Count(count) { }
+
+        uint8_t* Data() { return reinterpret_cast<uint8_t*>(this->Blocks.get()); }
+        size_t Bytes() const { return this->Count * sizeof(Block); }
+        Block& GetBlock(size_t index) { return *reinterpret_cast<Block*>(this->Data() + index * sizeof(Block)); }
+
+        bool Contains(const void* ptr) const
+        {
+            auto address = reinterpret_cast<uintptr_t>(ptr);
+            auto begin = reinterpret_cast<uintptr_t>(this->Blocks.get());
+            return address >= begin && address < begin + this->Bytes();
+        }
+    };
+
+    struct TrivialValue
+    {
+        int Value;
+
+        TrivialValue() = default;
+        TrivialValue(int value) : Value(value) { }
+    };
+}
+
+MX_TEST(PoolAllocator, AllocReturnsAlignedObjects)
+{
+    PoolStorage<AlignedValue> storage(16);
+    PoolAllocator<AlignedValue> pool(storage.Data(), storage.Bytes());
+
+    std::vector<AlignedValue*> objects;
+    for (int i = 0; i < 16; i++)
+    {
+        objects.push_back(pool.Alloc(i));
+        MX_CHECK_EQ(reinterpret_cast<uintptr_t>(objects.back()) % alignof(AlignedValue), (uintptr_t)0);
+    }
+    for (int i = 0; i < 16; i++)
+    {
+        MX_CHECK_EQ(objects[i]->Value, i);
+        pool.Free(objects[i]);
+    }
+}
+
+MX_TEST(PoolAllocator, FreedBlocksAreReused)
+{
+    PoolStorage<TrivialValue> storage(8);
+    PoolAllocator<TrivialValue> pool(storage.Data(), storage.Bytes());
+
+    TrivialValue* first = pool.Alloc(1);
+    TrivialValue* second = pool.Alloc(2);
+    TrivialValue* third = pool.Alloc(3);
+
+    pool.Free(second);
+    MX_CHECK(pool.Alloc(4) == second);
+
+    pool.Free(first);
+    pool.Free(third);
+    // free list is LIFO: last freed block is returned first
+    MX_CHECK(pool.Alloc(5) == third);
+    MX_CHECK(pool.Alloc(6) == first);
+    MX_CHECK_EQ(second->Value, 4);
+}
+
+MX_TEST(PoolAllocator, BusyBitIsStoredInNextOffset)
+{
+    using Block = PoolAllocator<TrivialValue>::Block;
+    PoolStorage<TrivialValue> storage(4);
+    PoolAllocator<TrivialValue> pool(storage.Data(), storage.Bytes());
+
+    for (size_t i = 0; i < storage.Count; i++)
+        MX_CHECK(storage.GetBlock(i).IsFree());
+
+    TrivialValue* object = pool.Alloc(42);
+    Block* block = reinterpret_cast<Block*>(object);
+    MX_CHECK(!block->IsFree());
+    MX_CHECK((block->next & Block::LastBit) != 0);
+
+    pool.Free(object);
+    MX_CHECK(block->IsFree());
+    MX_CHECK((block->next & Block::LastBit) == 0);
+}
+
+MX_TEST(PoolAllocator, ExhaustionAsserts)
+{
+    PoolStorage<TrivialValue> storage(4);
+    PoolAllocator<TrivialValue> pool(storage.Data(), storage.Bytes());
+
+    std::set<TrivialValue*> objects;
+    for (int i = 0; i < 4; i++)
+        objects.insert(pool.Alloc(i));
+    MX_CHECK_EQ(objects.size(), (size_t)4);
+
+    MX_CHECK_ASSERTS(pool.Alloc(4));
+
+    pool.Free(*objects.begin());
+    MX_CHECK(pool.Alloc(5) == *objects.begin());
+}
+
+MX_TEST(PoolAllocator, DoubleFreeAsserts)
+{
+    PoolStorage<TrivialValue> storage(4);
+    PoolAllocator<TrivialValue> pool(storage.Data(), storage.Bytes());
+
+    TrivialValue* object = pool.Alloc(1);
+    TrivialValue* other = pool.Alloc(2);
+    pool.Free(object);
+    MX_CHECK_ASSERTS(pool.Free(object));
+
+    // failed free must not corrupt free list
+    MX_CHECK(pool.Alloc(3) == object);
+    MX_CHECK_EQ(other->Value, 2);
+}
+
+MX_TEST(PoolAllocator, FreeOfForeignPointerAsserts)
+{
+    PoolStorage<TrivialValue> storage(4);
+    PoolAllocator<TrivialValue> pool(storage.Data(), storage.Bytes());
+
+    TrivialValue foreign(0);
+    MX_CHECK_ASSERTS(pool.Free(&foreign));
+}
+
+MX_TEST(PoolAllocator, TransferToSameSizeKeepsFreeList)
+{
+    PoolStorage<TrivialValue> oldStorage(4);
+    PoolStorage<TrivialValue> newStorage(4);
+    PoolAllocator<TrivialValue> pool(oldStorage.Data(), oldStorage.Bytes());
+
+    TrivialValue* first = pool.Alloc(1);
+    TrivialValue* second = pool.Alloc(2);
+    pool.Free(first);
+    size_t secondIndex = static_cast<size_t>(reinterpret_cast<uint8_t*>(second) - oldStorage.Data()) / sizeof(PoolAllocator<TrivialValue>::Block);
+
+    // transfer with the same block count used to chain blocks past the end of the new chunk
+    pool.Transfer(newStorage.Data(), newStorage.Bytes());
+    MX_CHECK_EQ(newStorage.GetBlock(secondIndex).data.Value, 2);
+
+    std::set<TrivialValue*> objects;
+    for (int i = 0; i < 3; i++)
+    {
+        TrivialValue* object = pool.Alloc(10 + i);
+        MX_CHECK(newStorage.Contains(object));
+        objects.insert(object);
+    }
+    MX_CHECK_EQ(objects.size(), (size_t)3);
+    MX_CHECK(objects.count(&newStorage.GetBlock(secondIndex).data) == 0);
+    MX_CHECK_ASSERTS(pool.Alloc(0));
+}
+
+MX_TEST(PoolAllocator, TransferToLargerChunkChainsNewBlocks)
+{
+    PoolStorage<TrivialValue> oldStorage(4);
+    PoolStorage<TrivialValue> newStorage(10);
+    PoolAllocator<TrivialValue> pool(oldStorage.Data(), oldStorage.Bytes());
+
+    TrivialValue* objects[4];
+    for (int i = 0; i < 4; i++)
+        objects[i] = pool.Alloc(i);
+    pool.Free(objects[1]);
+
+    pool.Transfer(newStorage.Data(), newStorage.Bytes());
+    MX_CHECK_EQ(newStorage.GetBlock(0).data.Value, 0);
+    MX_CHECK_EQ(newStorage.GetBlock(2).data.Value, 2);
+    MX_CHECK_EQ(newStorage.GetBlock(3).data.Value, 3);
+
+    // 6 new blocks plus the one freed before transfer
+    std::set<TrivialValue*> allocated;
+    for (int i = 0; i < 7; i++)
+    {
+        TrivialValue* object = pool.Alloc(100 + i);
+        MX_CHECK(newStorage.Contains(object));
+        allocated.insert(object);
+    }
+    MX_CHECK_EQ(allocated.size(), (size_t)7);
+    MX_CHECK(allocated.count(&newStorage.GetBlock(1).data) == 1);
+    MX_CHECK_ASSERTS(pool.Alloc(0));
+}
+
+MX_TEST(PoolAllocator, TransferToSmallerChunkAsserts)
+{
+    PoolStorage<TrivialValue> oldStorage(4);
+    PoolStorage<TrivialValue> newStorage(2);
+    PoolAllocator<TrivialValue> pool(oldStorage.Data(), oldStorage.Bytes());
+
+    MX_CHECK_ASSERTS(pool.Transfer(newStorage.Data(), newStorage.Bytes()));
+}
+
+MX_TEST(PoolAllocator, DestructorDestroysOnlyLiveObjects)
+{
+    int destroyed = 0;
+    {
+        PoolStorage<CountedValue> storage(8);
+        PoolAllocator<CountedValue> pool(storage.Data(), storage.Bytes());
+
+        CountedValue* objects[5];
+        for (int i = 0; i < 5; i++)
+            objects[i] = pool.Alloc(&destroyed);
+        pool.Free(objects[0]);
+        pool.Free(objects[3]);
+        MX_CHECK_EQ(destroyed, 2);
+    }
+    MX_CHECK_EQ(destroyed, 5);
+}
@@ -0,0 +1,224 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Utilities/Memory/RandomAllocator.h"
+
+#include <vector>
+#include <random>
+#include <memory>
+#include <algorithm>
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+namespace
+{
+    struct RandomStorage
+    {
+        std::unique_ptr<uint64_t[]> Words;
+        size_t Size;
+
+        RandomStorage(size_t bytes) : Words(std::make_unique<uint64_t[]>(bytes / sizeof(uint64_t))), Size(bytes) { }
+
+        uint8_t* Data() { return reinterpret_cast<uint8_t*>(this->Words.get()); }
+    };
+
+    struct Allocation
+    {
+        uint8_t* Pointer;
+        size_t Size;
+        uint8_t Pattern;
+    };
+
+    void Fill(const Allocation& allocation)
+    {
+        for (size_t i = 0; i < allocation.Size; i++)
+            allocation.Pointer[i] = allocation.Pattern;
+    }
+
+    bool IsIntact(const Allocation& allocation)
+    {
+        for (size_t i = 0; i < allocation.Size; i++)
+        {
+            if (allocation.Pointer[i] != allocation.Pattern) return false;
+        }
+        return true;
+    }
+
+    bool IsAligned(const void* ptr, size_t alignment)
+    {
+        return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+    }
+}
+
+MX_TEST(RandomAllocator, AllocHonorsAlignment)
+{
+    RandomStorage storage(64 * 1024);
+    RandomAllocator allocator(storage.Data(), storage.Size);
+
+    // allocations larger than header alignment used to be returned only pointer-aligned
+    const size_t alignments[] = { 1, 2, 4, 8, 16, 32, 64, 128, 256 };
+    std::vector<Allocation> allocations;
+    uint8_t pattern = 1;
+    for (size_t round = 0; round < 4; round++)
+    {
+        for (size_t alignment : alignments)
+        {
+            size_t size = 3 + round * 17 + alignment / 2;
+            uint8_t* ptr = allocator.RawAlloc(size, alignment);
+            MX_REQUIRE(ptr != nullptr);
+            MX_CHECK(IsAligned(ptr, alignment));
+            allocations.push_back(Allocation{ ptr, size, pattern++ });
+            Fill(allocations.back());
+        }
+    }
+    for (const Allocation& allocation : allocations)
+        MX_CHECK(IsIntact(allocation));
+}
+
+MX_TEST(RandomAllocator, SplitDoesNotOverwriteAllocatedBytes)
+{
+    RandomStorage storage(4 * 1024);
+    RandomAllocator allocator(storage.Data(), storage.Size);
+
+    // odd sizes leave unaligned tail after the block, new node header must be placed after it, not inside
+    std::vector<Allocation> allocations;
+    uint8_t pattern = 1;
+    for (size_t size = 1; ; size = size % 29 + 1)
+    {
+        uint8_t* ptr = allocator.RawAlloc(size);
+        if (ptr == nullptr) break;
+        allocations.push_back(Allocation{ ptr, size, pattern++ });
+        Fill(allocations.back());
+    }
+    MX_CHECK_GE(allocations.size(), (size_t)64);
+
+    for (const Allocation& allocation : allocations)
+        MX_CHECK(IsIntact(allocation));
+    for (size_t i = 0; i + 1 < allocations.size(); i++)
+        MX_CHECK(allocations[i].Pointer + allocations[i].Size <= allocations[i + 1].Pointer);
+}
+
+MX_TEST(RandomAllocator, FreedMemoryIsReused)
+{
+    RandomStorage storage(1024);
+    RandomAllocator allocator(storage.Data(), storage.Size);
+
+    uint8_t* first = allocator.RawAlloc(64);
+    uint8_t* second = allocator.RawAlloc(64);
+    MX_REQUIRE(first != nullptr && second != nullptr);
+
+    allocator.RawFree(first);
+    MX_CHECK(allocator.RawAlloc(64) == first);
+    allocator.RawFree(second);
+    MX_CHECK(allocator.RawAlloc(64) == second);
+}
+
+MX_TEST(RandomAllocator, FreedNeighboursAreCollapsed)
+{
+    constexpr size_t StorageSize = 4096;
+    RandomStorage storage(StorageSize);
+    RandomAllocator allocator(storage.Data(), storage.Size);
+
+    std::vector<uint8_t*> blocks;
+    while (uint8_t* ptr = allocator.RawAlloc(40))
+        blocks.push_back(ptr);
+    MX_CHECK(allocator.RawAlloc(StorageSize / 2) == nullptr);
+
+    std::mt19937 random(7);
+    std::shuffle(blocks.begin(), blocks.end(), random);
+    for (uint8_t* block : blocks)
+        allocator.RawFree(block);
+
+    // all nodes are free again, so they must merge into a single block spanning whole chunk except the first header
+    uint8_t* whole = allocator.RawAlloc(StorageSize - sizeof(uintptr_t));
+    MX_CHECK(whole == storage.Data() + sizeof(uintptr_t));
+}
+
+MX_TEST(RandomAllocator, ExhaustionReturnsNull)
+{
+    RandomStorage storage(256);
+    RandomAllocator allocator(storage.Data(), storage.Size);
+
+    MX_CHECK(allocator.RawAlloc(256) == nullptr);
+    uint8_t* ptr = allocator.RawAlloc(200);
+    MX_CHECK(ptr != nullptr);
+    // 40 bytes are left after the split, but they cannot fit 64-aligned block together with padding node
+    MX_CHECK(allocator.RawAlloc(64) == nullptr);
+    MX_CHECK(allocator.RawAlloc(40, 64) == nullptr);
+    allocator.RawFree(ptr);
+    MX_CHECK(allocator.RawAlloc(64) != nullptr);
+}
+
+MX_TEST(RandomAllocator, ObjectsAreConstructedAndDestroyed)
+{
+    struct Counted
+    {
+        int* Destroyed;
+        double Value;
+
+        Counted(int* destroyed, double value) : Destroyed(destroyed), Value(value) { }
+        ~Counted() { (*this->Destroyed)++; }
+    };
+
+    RandomStorage storage(1024);
+    RandomAllocator allocator(storage.Data(), storage.Size);
+
+    int destroyed = 0;
+    {
+        auto object = allocator.StackAlloc<Counted>(&destroyed, 2.5);
+        MX_CHECK(IsAligned(object.get(), alignof(Counted)));
+        MX_CHECK_EQ(object->Value, 2.5);
+    }
+    MX_CHECK_EQ(destroyed, 1);
+}
+
+MX_TEST(RandomAllocator, InitRequiresPointerAlignedChunk)
+{
+    RandomStorage storage(256);
+    RandomAllocator allocator;
+    MX_CHECK_ASSERTS(allocator.Init(storage.Data() + 1, storage.Size - 1));
+    MX_CHECK_ASSERTS(allocator.Init(storage.Data(), sizeof(uintptr_t)));
+
+    // unaligned size is rounded down, so the end of list is still pointer-aligned
+    allocator.Init(storage.Data(), storage.Size - 3);
+    constexpr size_t UsableBytes = 256 - sizeof(uintptr_t) - sizeof(uintptr_t);
+    MX_CHECK(allocator.RawAlloc(UsableBytes + 1) == nullptr);
+    MX_CHECK(allocator.RawAlloc(UsableBytes) != nullptr);
+}
+
+MX_TEST(RandomAllocator, FreeOfForeignPointerAsserts)
+{
+    RandomStorage storage(256);
+    RandomAllocator allocator(storage.Data(), storage.Size);
+
+    uint64_t foreign = 0;
+    MX_CHECK_ASSERTS(allocator.RawFree(reinterpret_cast<uint8_t*>(&foreign)));
+}
@@ -0,0 +1,112 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Utilities/Memory/ScratchStack.h"
+
+#include <thread>
+#include <cstddef>
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+static bool IsAligned(const void* ptr, size_t alignment)
+{
+    return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+MX_TEST(ScratchStack, ArraysAreReleasedOnScopeExit)
+{
+    size_t usedBefore = ScratchStack::GetUsedBytes();
+    {
+        ScratchArray<int> outer(100);
+        MX_CHECK_GE(ScratchStack::GetUsedBytes(), usedBefore + 100 * sizeof(int));
+        {
+            ScratchArray<double> inner(50);
+            MX_CHECK(IsAligned(inner.data(), alignof(double)));
+            MX_CHECK_GE(ScratchStack::GetUsedBytes(), usedBefore + 100 * sizeof(int) + 50 * sizeof(double));
+        }
+        MX_CHECK_LE(ScratchStack::GetUsedBytes(), usedBefore + 100 * sizeof(int) + alignof(std::max_align_t));
+    }
+    MX_CHECK_EQ(ScratchStack::GetUsedBytes(), usedBefore);
+}
+
+MX_TEST(ScratchStack, ElementsAreConstructedAndDestroyed)
+{
+    static int aliveCount = 0;
+    struct Counted
+    {
+        int Value = 42;
+        Counted() { aliveCount++; }
+        ~Counted() { aliveCount--; }
+    };
+
+    {
+        ScratchArray<Counted> array(10);
+        MX_CHECK_EQ(aliveCount, 10);
+        for (const auto& element : array)
+            MX_CHECK_EQ(element.Value, 42);
+    }
+    MX_CHECK_EQ(aliveCount, 0);
+}
+
+MX_TEST(ScratchStack, LargeArraysFallBackToHeap)
+{
+    size_t usedBefore = ScratchStack::GetUsedBytes();
+    {
+        ScratchArray<uint8_t> large(ScratchStack::StackSize * 2);
+        large[large.size() - 1] = 1;
+        MX_CHECK_EQ(ScratchStack::GetUsedBytes(), usedBefore);
+
+        // stack is still usable while heap fallback is alive
+        ScratchArray<int> small(16);
+        MX_CHECK_GE(ScratchStack::GetUsedBytes(), usedBefore + 16 * sizeof(int));
+    }
+    MX_CHECK_EQ(ScratchStack::GetUsedBytes(), usedBefore);
+}
+
+MX_TEST(ScratchStack, StacksAreThreadLocal)
+{
+    ScratchArray<int> mainThreadArray(1000);
+    size_t mainThreadUsed = ScratchStack::GetUsedBytes();
+
+    size_t workerUsedBefore = 1;
+    size_t workerUsedInside = 0;
+    std::thread worker([&]()
+    {
+        workerUsedBefore = ScratchStack::GetUsedBytes();
+        ScratchArray<int> workerArray(10);
+        workerUsedInside = ScratchStack::GetUsedBytes();
+    });
+    worker.join();
+
+    MX_CHECK_EQ(workerUsedBefore, size_t(0));
+    MX_CHECK_GE(workerUsedInside, 10 * sizeof(int));
+    MX_CHECK_EQ(ScratchStack::GetUsedBytes(), mainThreadUsed);
+}
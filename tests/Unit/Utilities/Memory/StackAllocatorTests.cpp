@@ -0,0 +1,131 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Utilities/Memory/StackAllocator.h"
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+namespace
+{
+    bool IsAligned(const void* ptr, size_t alignment)
+    {
+        return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+    }
+}
+
+MX_TEST(StackAllocator, AllocHonorsAlignment)
+{
+    alignas(256) static uint8_t storage[4096];
+    StackAllocator allocator(storage, sizeof(storage));
+
+    const size_t alignments[] = { 1, 2, 4, 8, 16, 32, 64, 128 };
+    for (size_t alignment : alignments)
+    {
+        uint8_t* ptr = allocator.RawAlloc(3, alignment);
+        MX_CHECK(IsAligned(ptr, alignment));
+        MX_CHECK(allocator.Contains(ptr));
+    }
+}
+
+MX_TEST(StackAllocator, FreeRestoresTopInReverseOrder)
+{
+    alignas(16) static uint8_t storage[1024];
+    StackAllocator allocator(storage, sizeof(storage));
+
+    uint8_t* first = allocator.RawAlloc(10, 4);
+    size_t afterFirst = allocator.GetUsedBytes();
+    uint8_t* second = allocator.RawAlloc(100, 64);
+    uint8_t* third = allocator.RawAlloc(1);
+    MX_CHECK(first < second && second < third);
+
+    allocator.RawFree(third);
+    allocator.RawFree(second);
+    MX_CHECK_EQ(allocator.GetUsedBytes(), afterFirst);
+    // freed space is reused by the next allocation
+    MX_CHECK(allocator.RawAlloc(100, 64) == second);
+    allocator.RawFree(second);
+    allocator.RawFree(first);
+    MX_CHECK_EQ(allocator.GetUsedBytes(), (size_t)0);
+}
+
+MX_TEST(StackAllocator, ExhaustionReturnsNullOrAsserts)
+{
+    alignas(16) static uint8_t storage[256];
+    StackAllocator allocator(storage, sizeof(storage));
+
+    MX_CHECK(allocator.TryRawAlloc(256) == nullptr);
+    uint8_t* ptr = allocator.TryRawAlloc(200);
+    MX_CHECK(ptr != nullptr);
+    MX_CHECK(allocator.TryRawAlloc(64) == nullptr);
+    MX_CHECK_ASSERTS(allocator.RawAlloc(64));
+
+    allocator.Init(storage, sizeof(storage));
+    MX_CHECK(allocator.TryRawAlloc(64) != nullptr);
+}
+
+MX_TEST(StackAllocator, AlignmentAboveShiftRangeAsserts)
+{
+    alignas(512) static uint8_t storage[2048];
+    StackAllocator allocator(storage, sizeof(storage));
+
+    // alignment shift is stored in a single byte before the block
+    MX_CHECK_ASSERTS(allocator.RawAlloc(8, 256));
+    MX_CHECK_ASSERTS(allocator.TryRawAlloc(8, 256));
+    MX_CHECK_ASSERTS(allocator.RawAlloc(8, 24));
+}
+
+MX_TEST(StackAllocator, ObjectsAreDestroyedInReverseOrder)
+{
+    struct Tracked
+    {
+        int Id;
+        int* Order;
+        int* Position;
+
+        Tracked(int id, int* order, int* position) : Id(id), Order(order), Position(position) { }
+        ~Tracked() { this->Order[(*this->Position)++] = this->Id; }
+    };
+
+    alignas(16) static uint8_t storage[1024];
+    StackAllocator allocator(storage, sizeof(storage));
+
+    int order[3] = { };
+    int position = 0;
+    {
+        auto first = allocator.StackAlloc<Tracked>(1, order, &position);
+        auto second = allocator.StackAlloc<Tracked>(2, order, &position);
+        auto third = allocator.StackAlloc<Tracked>(3, order, &position);
+    }
+    MX_CHECK_EQ(order[0], 3);
+    MX_CHECK_EQ(order[1], 2);
+    MX_CHECK_EQ(order[2], 1);
+    MX_CHECK_EQ(allocator.GetUsedBytes(), (size_t)0);
+}
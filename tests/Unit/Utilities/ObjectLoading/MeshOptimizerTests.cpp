@@ -0,0 +1,344 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Utilities/ObjectLoading/MeshOptimizer.h"
+
+#include <random>
+#include <array>
+#include <cmath>
+
+using namespace MxEngine;
+
+namespace
+{
+    struct TestMesh
+    {
+        MeshData::VertexData Vertecies;
+        MeshData::IndexData Indicies;
+    };
+
+    /*!
+    generates outward-facing uv-sphere with given radius. Triangles are emitted row by row
+    */
+    void AppendSphere(TestMesh& mesh, size_t stacks, size_t slices, float radius)
+    {
+        constexpr float Pi = 3.14159265358979f;
+        uint32_t first = (uint32_t)mesh.Vertecies.size();
+        for (size_t stack = 0; stack <= stacks; stack++)
+        {
+            float phi = Pi * (float)stack / (float)stacks;
+            for (size_t slice = 0; slice <= slices; slice++)
+            {
+                float theta = 2.0f * Pi * (float)slice / (float)slices;
+                Vertex vertex;
+                vertex.Position = MakeVector3(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta)) * radius;
+                vertex.TexCoord = MakeVector2((float)slice / (float)slices, (float)stack / (float)stacks);
+                mesh.Vertecies.push_back(vertex);
+            }
+        }
+        for (size_t stack = 0; stack < stacks; stack++)
+        {
+            for (size_t slice = 0; slice < slices; slice++)
+            {
+                uint32_t i0 = first + uint32_t(stack * (slices + 1) + slice);
+                uint32_t i2 = i0 + uint32_t(slices + 1);
+                uint32_t quad[6] = { i0, i0 + 1, i2, i0 + 1, i2 + 1, i2 };
+                mesh.Indicies.insert(mesh.Indicies.end(), std::begin(quad), std::end(quad));
+            }
+        }
+    }
+
+    TestMesh GenerateSphere(size_t stacks, size_t slices)
+    {
+        TestMesh mesh;
+        AppendSphere(mesh, stacks, slices, 1.0f);
+        return mesh;
+    }
+
+    void ShuffleTriangles(MeshData::IndexData& indicies, std::mt19937& random)
+    {
+        size_t triangleCount = indicies.size() / 3;
+        for (size_t i = triangleCount; i > 1; i--)
+        {
+            size_t j = std::uniform_int_distribution<size_t>(0, i - 1)(random);
+            for (size_t k = 0; k < 3; k++)
+                std::swap(indicies[3 * (i - 1) + k], indicies[3 * j + k]);
+        }
+    }
+
+    using Triangle = std::array<uint32_t, 3>;
+    using TrianglePositions = std::array<float, 9>;
+
+    MxVector<Triangle> GetSortedTriangles(const MeshData::IndexData& indicies)
+    {
+        MxVector<Triangle> triangles(indicies.size() / 3);
+        for (size_t i = 0; i < triangles.size(); i++)
+            triangles[i] = { indicies[3 * i + 0], indicies[3 * i + 1], indicies[3 * i + 2] };
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    /*!
+    \returns triangles as vertex positions, so meshes can be compared after vertex remapping. Winding order is preserved
+    */
+    MxVector<TrianglePositions> GetSortedTrianglePositions(const TestMesh& mesh)
+    {
+        MxVector<TrianglePositions> triangles(mesh.Indicies.size() / 3);
+        for (size_t i = 0; i < triangles.size(); i++)
+        {
+            for (size_t j = 0; j < 3; j++)
+            {
+                const auto& position = mesh.Vertecies[mesh.Indicies[3 * i + j]].Position;
+                triangles[i][3 * j + 0] = position.x;
+                triangles[i][3 * j + 1] = position.y;
+                triangles[i][3 * j + 2] = position.z;
+            }
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    float GetACMR(const TestMesh& mesh)
+    {
+        return MeshOptimizer::AnalyzeVertexCache(mesh.Indicies, mesh.Vertecies.size()).ACMR;
+    }
+}
+
+MX_TEST(MeshOptimizer, AnalyzeVertexCacheCountsMisses)
+{
+    MeshData::IndexData empty;
+    auto statistics = MeshOptimizer::AnalyzeVertexCache(empty, 0);
+    MX_CHECK_EQ(statistics.TransformedVertexCount, (size_t)0);
+    MX_CHECK_EQ(statistics.ACMR, 0.0f);
+
+    MeshData::IndexData single = { 0, 1, 2 };
+    statistics = MeshOptimizer::AnalyzeVertexCache(single, 3);
+    MX_CHECK_EQ(statistics.TransformedVertexCount, (size_t)3);
+    MX_CHECK_NEAR(statistics.ACMR, 3.0f, 1e-6f);
+    MX_CHECK_NEAR(statistics.ATVR, 1.0f, 1e-6f);
+
+    // second triangle reuses two cached vertecies
+    MeshData::IndexData pair = { 0, 1, 2, 2, 1, 3 };
+    statistics = MeshOptimizer::AnalyzeVertexCache(pair, 4);
+    MX_CHECK_EQ(statistics.TransformedVertexCount, (size_t)4);
+    MX_CHECK_NEAR(statistics.ACMR, 2.0f, 1e-6f);
+    MX_CHECK_NEAR(statistics.ATVR, 1.0f, 1e-6f);
+}
+
+MX_TEST(MeshOptimizer, AnalyzeVertexCacheEvictsInFifoOrder)
+{
+    // with 3 entries, second triangle evicts the first one completely
+    MeshData::IndexData indicies = { 0, 1, 2, 3, 4, 5, 0, 1, 2 };
+    auto statistics = MeshOptimizer::AnalyzeVertexCache(indicies, 6, 3);
+    MX_CHECK_EQ(statistics.TransformedVertexCount, (size_t)9);
+    MX_CHECK_NEAR(statistics.ATVR, 1.5f, 1e-6f);
+
+    // FIFO cache does not refresh position on hit, so vertex 0 is evicted by vertex 4 even if it was used recently
+    indicies = { 0, 1, 2, 0, 3, 4, 0, 1, 2 };
+    statistics = MeshOptimizer::AnalyzeVertexCache(indicies, 5, 3);
+    MX_CHECK_EQ(statistics.TransformedVertexCount, (size_t)8);
+
+    statistics = MeshOptimizer::AnalyzeVertexCache(indicies, 5, 16);
+    MX_CHECK_EQ(statistics.TransformedVertexCount, (size_t)5);
+    MX_CHECK_NEAR(statistics.ATVR, 1.0f, 1e-6f);
+}
+
+MX_TEST(MeshOptimizer, ForsythKeepsTrianglesAndReducesACMR)
+{
+    std::mt19937 random(1);
+    auto mesh = GenerateSphere(40, 80);
+    ShuffleTriangles(mesh.Indicies, random);
+    auto expected = GetSortedTriangles(mesh.Indicies);
+    float before = GetACMR(mesh);
+
+    MeshOptimizer::OptimizeVertexCache(mesh.Indicies, mesh.Vertecies.size());
+
+    MX_CHECK(GetSortedTriangles(mesh.Indicies) == expected);
+    float after = GetACMR(mesh);
+    MX_CHECK_GE(before, 2.5f);
+    MX_CHECK_LE(after, 0.8f);
+}
+
+MX_TEST(MeshOptimizer, TipsifyKeepsTrianglesAndReducesACMR)
+{
+    std::mt19937 random(2);
+    auto mesh = GenerateSphere(40, 80);
+    ShuffleTriangles(mesh.Indicies, random);
+    auto expected = GetSortedTriangles(mesh.Indicies);
+
+    MeshOptimizer::OptimizeVertexCacheTipsify(mesh.Indicies, mesh.Vertecies.size());
+
+    MX_CHECK(GetSortedTriangles(mesh.Indicies) == expected);
+    MX_CHECK_LE(GetACMR(mesh), 0.8f);
+}
+
+MX_TEST(MeshOptimizer, VertexCacheImprovesRowOrderedMesh)
+{
+    // rows of 160 triangles do not fit into cache, so primitives order transforms each vertex twice
+    auto mesh = GenerateSphere(40, 80);
+    auto tipsified = mesh;
+    float before = GetACMR(mesh);
+
+    MeshOptimizer::OptimizeVertexCache(mesh.Indicies, mesh.Vertecies.size());
+    MeshOptimizer::OptimizeVertexCacheTipsify(tipsified.Indicies, tipsified.Vertecies.size());
+
+    MX_CHECK(GetACMR(mesh) < before);
+    MX_CHECK(GetACMR(tipsified) < before);
+}
+
+MX_TEST(MeshOptimizer, VertexCacheHandlesEdgeCases)
+{
+    MeshData::IndexData empty;
+    MeshOptimizer::OptimizeVertexCache(empty, 0);
+    MeshOptimizer::OptimizeVertexCacheTipsify(empty, 0);
+    MX_CHECK(empty.empty());
+
+    // degenerate and duplicate triangles must be emitted exactly once each
+    MeshData::IndexData indicies = { 0, 0, 1, 0, 1, 2, 0, 1, 2, 3, 3, 3, 2, 1, 3 };
+    auto expected = GetSortedTriangles(indicies);
+    auto tipsified = indicies;
+    MeshOptimizer::OptimizeVertexCache(indicies, 4);
+    MeshOptimizer::OptimizeVertexCacheTipsify(tipsified, 4);
+    MX_CHECK(GetSortedTriangles(indicies) == expected);
+    MX_CHECK(GetSortedTriangles(tipsified) == expected);
+}
+
+MX_TEST(MeshOptimizer, OverdrawKeepsTrianglesAndCacheEfficiency)
+{
+    std::mt19937 random(3);
+    auto mesh = GenerateSphere(40, 80);
+    ShuffleTriangles(mesh.Indicies, random);
+    MeshOptimizer::OptimizeVertexCacheTipsify(mesh.Indicies, mesh.Vertecies.size());
+    auto expected = GetSortedTriangles(mesh.Indicies);
+    float before = GetACMR(mesh);
+
+    MeshOptimizer::OptimizeOverdraw(mesh.Indicies, mesh.Vertecies);
+
+    MX_CHECK(GetSortedTriangles(mesh.Indicies) == expected);
+    // each cluster starts with a cold cache, so some degradation is allowed
+    MX_CHECK_LE(GetACMR(mesh), before * MeshOptimizer::DefaultOverdrawThreshold * 1.1f);
+}
+
+MX_TEST(MeshOptimizer, OverdrawDrawsOuterSurfaceFirst)
+{
+    // inner sphere is fully occluded by the outer one from any view direction, so it should be drawn last
+    TestMesh mesh;
+    AppendSphere(mesh, 20, 40, 0.5f);
+    size_t innerVertexCount = mesh.Vertecies.size();
+    AppendSphere(mesh, 20, 40, 1.0f);
+    MeshOptimizer::OptimizeVertexCacheTipsify(mesh.Indicies, mesh.Vertecies.size());
+
+    MeshOptimizer::OptimizeOverdraw(mesh.Indicies, mesh.Vertecies);
+
+    size_t triangleCount = mesh.Indicies.size() / 3;
+    size_t outerPositionSum = 0, innerPositionSum = 0, outerCount = 0;
+    for (size_t i = 0; i < triangleCount; i++)
+    {
+        if (mesh.Indicies[3 * i] >= innerVertexCount)
+        {
+            outerPositionSum += i;
+            outerCount++;
+        }
+        else
+        {
+            innerPositionSum += i;
+        }
+    }
+    MX_REQUIRE(outerCount == triangleCount / 2);
+    MX_CHECK(outerPositionSum / outerCount < innerPositionSum / (triangleCount - outerCount));
+}
+
+MX_TEST(MeshOptimizer, VertexFetchOrdersVerteciesByFirstUse)
+{
+    std::mt19937 random(4);
+    auto mesh = GenerateSphere(10, 20);
+    ShuffleTriangles(mesh.Indicies, random);
+    // vertecies which are not referenced by any triangle
+    Vertex unused;
+    unused.Position = MakeVector3(5.0f);
+    mesh.Vertecies.insert(mesh.Vertecies.begin(), unused);
+    for (auto& index : mesh.Indicies)
+        index++;
+    mesh.Vertecies.push_back(unused);
+
+    auto expected = GetSortedTrianglePositions(mesh);
+    size_t vertexCount = mesh.Vertecies.size();
+
+    MeshOptimizer::OptimizeVertexFetch(mesh.Vertecies, mesh.Indicies);
+
+    MX_REQUIRE(mesh.Vertecies.size() == vertexCount);
+    MX_CHECK(GetSortedTrianglePositions(mesh) == expected);
+
+    uint32_t nextIndex = 0;
+    for (uint32_t index : mesh.Indicies)
+    {
+        MX_REQUIRE(index <= nextIndex);
+        if (index == nextIndex) nextIndex++;
+    }
+    MX_CHECK_EQ((size_t)nextIndex, vertexCount - 2);
+    MX_CHECK(mesh.Vertecies[vertexCount - 2].Position == unused.Position);
+    MX_CHECK(mesh.Vertecies[vertexCount - 1].Position == unused.Position);
+}
+
+MX_TEST(MeshOptimizer, OptimizeKeepsGeometryAndReducesACMR)
+{
+    std::mt19937 random(5);
+    for (auto algorithm : { VertexCacheAlgorithm::FORSYTH, VertexCacheAlgorithm::TIPSIFY })
+    {
+        auto mesh = GenerateSphere(30, 60);
+        ShuffleTriangles(mesh.Indicies, random);
+        auto expected = GetSortedTrianglePositions(mesh);
+        size_t vertexCount = mesh.Vertecies.size();
+        float before = GetACMR(mesh);
+
+        MeshOptimizer::Optimize(mesh.Vertecies, mesh.Indicies, algorithm);
+
+        MX_REQUIRE(mesh.Vertecies.size() == vertexCount);
+        MX_CHECK(GetSortedTrianglePositions(mesh) == expected);
+        MX_CHECK(GetACMR(mesh) < before * 0.4f);
+    }
+}
+
+MX_TEST(MeshOptimizer, OptimizeSkipsInvalidIndexBuffers)
+{
+    auto mesh = GenerateSphere(4, 8);
+    auto original = mesh;
+
+    mesh.Indicies.push_back(0);
+    MeshOptimizer::Optimize(mesh.Vertecies, mesh.Indicies);
+    MX_CHECK_EQ(mesh.Indicies.size(), original.Indicies.size() + 1);
+    MX_CHECK(std::equal(original.Indicies.begin(), original.Indicies.end(), mesh.Indicies.begin()));
+
+    mesh = original;
+    mesh.Indicies.back() = (uint32_t)mesh.Vertecies.size();
+    auto invalid = mesh.Indicies;
+    MeshOptimizer::Optimize(mesh.Vertecies, mesh.Indicies);
+    MX_CHECK(mesh.Indicies == invalid);
+}
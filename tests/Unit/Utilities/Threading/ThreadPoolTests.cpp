@@ -0,0 +1,188 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Framework/TestFramework.h"
+#include "Utilities/Threading/ThreadPool.h"
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+using namespace MxEngine;
+using namespace MxEngine::Tests;
+
+namespace
+{
+    /*!
+    blocks background tasks until released, so tests can observe how pool schedules other work meanwhile
+    */
+    struct TaskGate
+    {
+        std::atomic<bool> isOpen{ false };
+        std::atomic<size_t> runningCount{ 0 };
+        std::atomic<size_t> maxRunningCount{ 0 };
+
+        void Enter()
+        {
+            size_t running = ++this->runningCount;
+            size_t expected = this->maxRunningCount.load();
+            while (expected < running && !this->maxRunningCount.compare_exchange_weak(expected, running));
+
+            while (!this->isOpen.load())
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            --this->runningCount;
+        }
+    };
+
+    template<typename T>
+    bool IsReadyWithin(std::future<T>& future, std::chrono::seconds timeout)
+    {
+        // std::future::wait_for does not help executing tasks, so only worker threads can make future ready
+        return future.wait_for(timeout) == std::future_status::ready;
+    }
+}
+
+MX_TEST(ThreadPool, SubmitAndParallelForExecuteAllWork)
+{
+    ThreadPool::Init(3);
+    auto future = ThreadPool::Submit([]() { return 42; });
+    MX_CHECK_EQ(ThreadPool::Wait(future), 42);
+
+    std::vector<std::atomic<int>> visited(1000);
+    ThreadPool::ParallelFor(visited.size(), 10, [&visited](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+            visited[i]++;
+    });
+    size_t mismatches = 0;
+    for (auto& value : visited)
+        mismatches += value.load() != 1;
+    MX_CHECK_EQ(mismatches, (size_t)0);
+    ThreadPool::Destroy();
+}
+
+MX_TEST(ThreadPool, WaitingThreadNeverExecutesBackgroundTasks)
+{
+    ThreadPool::Init(1);
+    TaskGate gate;
+    auto mainThread = std::this_thread::get_id();
+    std::atomic<size_t> backgroundOnMainThread{ 0 };
+
+    // the only worker is occupied by first task, others stay in background queue while main thread is waiting
+    MxVector<std::future<void>> loads;
+    loads.push_back(ThreadPool::SubmitBackground([&gate]() { gate.Enter(); }));
+    for (size_t i = 0; i < 4; i++)
+    {
+        loads.push_back(ThreadPool::SubmitBackground([&backgroundOnMainThread, mainThread]()
+        {
+            backgroundOnMainThread += std::this_thread::get_id() == mainThread;
+        }));
+    }
+    while (gate.runningCount.load() == 0) std::this_thread::yield();
+
+    std::atomic<size_t> processed{ 0 };
+    ThreadPool::ParallelFor(64, 1, [&processed](size_t begin, size_t end) { processed += end - begin; });
+    auto frameTask = ThreadPool::Submit([]() { return 1; });
+    MX_CHECK_EQ(ThreadPool::Wait(frameTask), 1);
+    MX_CHECK_EQ(processed.load(), (size_t)64);
+    MX_CHECK(!ThreadPool::ExecutePendingTask());
+
+    gate.isOpen = true;
+    for (auto& load : loads)
+        ThreadPool::Wait(load);
+    MX_CHECK_EQ(backgroundOnMainThread.load(), (size_t)0);
+    ThreadPool::Destroy();
+}
+
+MX_TEST(ThreadPool, BackgroundTasksLeaveWorkerForRegularTasks)
+{
+    ThreadPool::Init(3);
+    TaskGate gate;
+    MxVector<std::future<void>> loads;
+    for (size_t i = 0; i < 6; i++)
+        loads.push_back(ThreadPool::SubmitBackground([&gate]() { gate.Enter(); }));
+    while (gate.runningCount.load() < 2) std::this_thread::yield();
+
+    // regular task must be picked up by free worker even though background tasks are still blocked
+    auto frameTask = ThreadPool::Submit([]() { return std::this_thread::get_id(); });
+    MX_REQUIRE(IsReadyWithin(frameTask, std::chrono::seconds(10)));
+    MX_CHECK(frameTask.get() != std::this_thread::get_id());
+
+    gate.isOpen = true;
+    for (auto& load : loads)
+        ThreadPool::Wait(load);
+    MX_CHECK_EQ(gate.maxRunningCount.load(), (size_t)2);
+    ThreadPool::Destroy();
+}
+
+MX_TEST(ThreadPool, BackgroundTasksRunAfterRegularOnes)
+{
+    ThreadPool::Init(1);
+    TaskGate gate;
+    auto blocker = ThreadPool::Submit([&gate]() { gate.Enter(); });
+    while (gate.runningCount.load() == 0) std::this_thread::yield();
+
+    std::atomic<size_t> sequence{ 0 };
+    size_t backgroundOrder = 0, regularOrder = 0;
+    auto load = ThreadPool::SubmitBackground([&sequence, &backgroundOrder]() { backgroundOrder = sequence++; });
+    auto task = ThreadPool::Submit([&sequence, &regularOrder]() { regularOrder = sequence++; });
+
+    gate.isOpen = true;
+    MX_REQUIRE(IsReadyWithin(load, std::chrono::seconds(10)));
+    MX_REQUIRE(IsReadyWithin(task, std::chrono::seconds(10)));
+    MX_CHECK_LE(regularOrder, backgroundOrder);
+    ThreadPool::Wait(blocker);
+    ThreadPool::Destroy();
+}
+
+MX_TEST(ThreadPool, WaitExecutesBackgroundTasksWithoutWorkers)
+{
+    ThreadPool::Init(0);
+    auto load = ThreadPool::SubmitBackground([]() { return std::this_thread::get_id(); });
+    MX_CHECK(ThreadPool::Wait(load) == std::this_thread::get_id());
+    ThreadPool::Destroy();
+}
+
+MX_TEST(ThreadPool, DestroyFinishesPendingBackgroundTasks)
+{
+    ThreadPool::Init(2);
+    std::atomic<size_t> executed{ 0 };
+    MxVector<std::future<void>> loads;
+    for (size_t i = 0; i < 16; i++)
+    {
+        loads.push_back(ThreadPool::SubmitBackground([&executed]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            executed++;
+        }));
+    }
+    ThreadPool::Destroy();
+    MX_CHECK_EQ(executed.load(), (size_t)16);
+}
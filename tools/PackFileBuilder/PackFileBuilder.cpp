@@ -0,0 +1,79 @@
+// Copyright(c) 2019 - 2020, #Momo
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met :
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+// list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and /or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED.IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "Utilities/FileSystem/PackFile.h"
+#include "Utilities/Threading/ThreadPool.h"
+#include "Utilities/Logging/Logger.h"
+
+#include <iostream>
+#include <cstring>
+
+/*
+    packs project directories into single .mxpack file, which can be listed in "pack-files" of engine_config.json
+    usage: PackFileBuilder <output.mxpack> <root directory> [directories relative to root...] [--no-compress] [--alignment N]
+*/
+int main(int argc, char** argv)
+{
+    using namespace MxEngine;
+
+    if (argc < 3)
+    {
+        std::cout << "usage: PackFileBuilder <output" << PackFile::PackFileExtension
+            << "> <root directory> [directories relative to root...] [--no-compress] [--alignment N]\n";
+        return 1;
+    }
+
+    Logger::Init();
+    ThreadPool::Init();
+
+    FilePath outputPath = argv[1];
+    FilePath rootDirectory = std::filesystem::absolute(argv[2]).lexically_normal();
+    MxVector<FilePath> directories;
+    bool compress = true;
+    PackFileWriter writer;
+
+    for (int i = 3; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--no-compress") == 0)
+            compress = false;
+        else if (std::strcmp(argv[i], "--alignment") == 0 && i + 1 < argc)
+            writer.SetAlignment((uint32_t)std::strtoul(argv[++i], nullptr, 10));
+        else
+            directories.push_back(rootDirectory / argv[i]);
+    }
+    if (directories.empty())
+        directories.push_back(rootDirectory);
+
+    for (const auto& directory : directories)
+        writer.AddDirectory(directory, rootDirectory, compress);
+
+    bool isWritten = writer.Write(outputPath);
+    ThreadPool::Destroy();
+    return isWritten ? 0 : 1;
+}